@@ -0,0 +1,63 @@
+/**
+  ******************************************************************************
+  * @file    host_ittia_db.h
+  * @brief   Host (Linux) stand-in for the part of ITTIA DB Lite used by the
+  *          METEO firmware, and what the host tools read back from it.
+  *
+  *          ITTIA DB Lite is only shipped as a Cortex-M33 library. On the
+  *          host, host_ittia_db.c implements in memory the calls of
+  *          meteo_example.c, meteo_streams.c, meteo_database.c and
+  *          meteo_series.c, with the declarations of $DB/inc unchanged:
+  *          - stream environment, graph, row input with a compound key,
+  *            registered output (the real-time view) and table output;
+  *          - index storage: db_open_index_storage with the compare
+  *            functions of the schema, db_connect / db_disconnect,
+  *            db_close_storage; db_open_index, db_index_get (first entry
+  *            not below a key) and db_index_remove;
+  *          - IoT storage (meteo_series.c): db_open_iot_file_storage, float32
+  *            time series, put, remove before, the retention in bytes, the
+  *            query over several series oldest to newest, db_file_info.
+  *          A table output writes each processed row to an index of the
+  *          connected storage, the fields packed in order at their natural
+  *          width (SINT32 4 bytes, TIMESTAMP and FLOAT64 8, ...). The key is
+  *          the key fields of the input, which must come first; with
+  *          DB_MATERIALIZE_APPEND the timestamp field, next, is part of it,
+  *          so every event is a row of its own. The first table name used
+  *          on a storage is index 0, the next index 1.
+  *          A series point is a timestamp and a float32, stored as is: the
+  *          series bytes of db_file_info are HOST_DB_POINT_BYTES (12) a
+  *          point, not what the library's compression would take. Past the
+  *          retention's max bytes, whole timestamps go, oldest first, down
+  *          to its retain bytes.
+  *
+  *          All calls take one ThreadX mutex: the firmware threads share
+  *          the environment and the storages as on the target.
+  ******************************************************************************
+  */
+
+#ifndef HOST_ITTIA_DB_H
+#define HOST_ITTIA_DB_H
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#include <stdint.h>
+
+#include <ittia/db/db_index_storage.h>
+#include <ittia/db/db_iot_storage.h>
+#include <ittia/db/db_stream.h>
+
+/* Exported functions --------------------------------------------------------*/
+
+/* Rows processed into the stream registered as name, 0 if there is none */
+uint32_t host_ittia_db_stream_rows(db_stream_environment_t stream_env, const char *name);
+
+/* Entries in an index of the storage of a connection, -1 if there is none */
+int32_t host_ittia_db_index_rows(db_t database, int index_id);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* HOST_ITTIA_DB_H */
@@ -0,0 +1,52 @@
+/**
+  ******************************************************************************
+  * @file    lx_stm32_ospi_driver.h
+  * @brief   Host (Linux) stand-in for the LevelX OSPI glue used by
+  *          meteo_ospi.c.
+  *
+  *          Same geometry as the MX25LM51245G on the STM32H573I-DK. Only the
+  *          METEO regions at the top of the flash are emulated, by
+  *          host_ospi.c, as NOR: erase sets a 64 KB block to 0xFF, a write
+  *          can only clear bits. Transfers complete before they return, so
+  *          the completion macros have nothing to wait for.
+  *
+  *          Put Core/Host/Inc in front of ITTIA_DB_Lite/Target.
+  ******************************************************************************
+  */
+
+#ifndef LX_STM32_OSPI_DRIVER_H
+#define LX_STM32_OSPI_DRIVER_H
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#include "tx_api.h"
+
+/* Exported constants --------------------------------------------------------*/
+#define LX_STM32_OSPI_INSTANCE                    0
+#define LX_STM32_OSPI_DEFAULT_TIMEOUT             10 * TX_TIMER_TICKS_PER_SECOND
+
+#define LX_STM32_OSPI_SECTOR_SIZE                 0x10000UL        /* 64 KB */
+#define LX_STM32_OSPI_FLASH_SIZE                  0x4000000UL      /* 64 MB */
+#define LX_STM32_OSPI_PAGE_SIZE                   0x100UL
+
+/* Environment: file holding the emulated region, kept between runs */
+#define LX_STM32_OSPI_HOST_FILE_ENV               "METEO_HOST_OSPI"
+
+/* Exported macros -----------------------------------------------------------*/
+#define LX_STM32_OSPI_READ_CPLT_NOTIFY(__status__)    do { (__status__) = 0; } while (0)
+#define LX_STM32_OSPI_WRITE_CPLT_NOTIFY(__status__)   do { (__status__) = 0; } while (0)
+
+/* Exported functions --------------------------------------------------------*/
+INT lx_stm32_ospi_get_status(UINT instance);
+INT lx_stm32_ospi_get_info(UINT instance, ULONG *block_size, ULONG *total_blocks);
+INT lx_stm32_ospi_read(UINT instance, ULONG *address, ULONG *buffer, ULONG words);
+INT lx_stm32_ospi_write(UINT instance, ULONG *address, ULONG *buffer, ULONG words);
+INT lx_stm32_ospi_erase(UINT instance, ULONG block, ULONG erase_count, UINT full_chip_erase);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* LX_STM32_OSPI_DRIVER_H */
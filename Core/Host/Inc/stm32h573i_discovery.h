@@ -0,0 +1,86 @@
+/**
+  ******************************************************************************
+  * @file    stm32h573i_discovery.h
+  * @brief   Host (Linux) stand-in for the STM32H573I-DK BSP: the COM1 virtual
+  *          COM port and the USER push-button. See stm32h5xx_hal.h.
+  ******************************************************************************
+  */
+
+#ifndef STM32H573I_DK_H
+#define STM32H573I_DK_H
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#include "stm32h5xx_hal.h"
+
+/* Exported types ------------------------------------------------------------*/
+typedef enum
+{
+  COM1 = 0U,
+  COM_NBR
+} COM_TypeDef;
+
+typedef enum
+{
+  COM_STOPBITS_1     = 0U,
+  COM_STOPBITS_2     = 1U
+} COM_StopBitsTypeDef;
+
+typedef enum
+{
+  COM_PARITY_NONE    = 0U,
+  COM_PARITY_EVEN    = 1U,
+  COM_PARITY_ODD     = 2U
+} COM_ParityTypeDef;
+
+typedef enum
+{
+  COM_HWCONTROL_NONE = 0U
+} COM_HwFlowCtlTypeDef;
+
+typedef enum
+{
+  COM_WORDLENGTH_7B  = 0U,
+  COM_WORDLENGTH_8B  = 1U,
+  COM_WORDLENGTH_9B  = 2U
+} COM_WordLengthTypeDef;
+
+typedef struct
+{
+  uint32_t              BaudRate;
+  COM_WordLengthTypeDef WordLength;
+  COM_StopBitsTypeDef   StopBits;
+  COM_ParityTypeDef     Parity;
+  COM_HwFlowCtlTypeDef  HwFlowCtl;
+} COM_InitTypeDef;
+
+typedef enum
+{
+  BUTTON_USER = 0U,
+  BUTTON_NBR
+} Button_TypeDef;
+
+typedef enum
+{
+  BUTTON_MODE_GPIO = 0U,
+  BUTTON_MODE_EXTI = 1U
+} ButtonMode_TypeDef;
+
+/* Exported constants --------------------------------------------------------*/
+#define BSP_ERROR_NONE                  0
+#define BSP_ERROR_WRONG_PARAM           -2
+
+/* Exported variables --------------------------------------------------------*/
+extern UART_HandleTypeDef hcom_uart[COM_NBR];
+
+/* Exported functions --------------------------------------------------------*/
+int32_t BSP_COM_Init(COM_TypeDef COM, COM_InitTypeDef *COM_Init);
+int32_t BSP_PB_Init(Button_TypeDef Button, ButtonMode_TypeDef ButtonMode);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* STM32H573I_DK_H */
@@ -0,0 +1,276 @@
+/**
+  ******************************************************************************
+  * @file    stm32h5xx_hal.h
+  * @brief   Host (Linux) stand-in for the STM32H5xx HAL.
+  *
+  *          Only what the METEO firmware sources use is provided. Clock, cache,
+  *          OCTOSPI, DMA and NVIC calls are accepted and ignored; the UARTs are
+  *          emulated by host_hal_uart.c:
+  *            - USART3 (METEO sensor) is fed from a file or pipe by an emulated
+  *              RX interrupt that calls HAL_UART_RxCpltCallback()
+  *            - COM1 (VCP console) polls stdin, output goes to stdout;
+  *              HAL_UART_Transmit_DMA() completes by an emulated interrupt
+  *          HAL_GetTick() is derived from the ThreadX clock, so it follows the
+  *          TX_LINUX_SPEEDUP time scale of the Linux ThreadX port.
+  *
+  *          Put Core/Host/Inc in front of the Drivers include paths.
+  ******************************************************************************
+  */
+
+#ifndef STM32H5xx_HAL_H
+#define STM32H5xx_HAL_H
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#include <stdint.h>
+#include <stddef.h>
+
+/* Exported types ------------------------------------------------------------*/
+typedef enum
+{
+  HAL_OK       = 0x00U,
+  HAL_ERROR    = 0x01U,
+  HAL_BUSY     = 0x02U,
+  HAL_TIMEOUT  = 0x03U
+} HAL_StatusTypeDef;
+
+typedef enum
+{
+  RESET = 0U,
+  SET = !RESET
+} FlagStatus, ITStatus;
+
+typedef enum
+{
+  DISABLE = 0U,
+  ENABLE = !DISABLE
+} FunctionalState;
+
+typedef int IRQn_Type;
+
+/* Register block of a USART, only the status register is modelled */
+typedef struct
+{
+  volatile uint32_t ISR;
+  volatile uint32_t ICR;
+} USART_TypeDef;
+
+typedef struct
+{
+  uint32_t BaudRate;
+  uint32_t WordLength;
+  uint32_t StopBits;
+  uint32_t Parity;
+  uint32_t Mode;
+  uint32_t HwFlowCtl;
+  uint32_t OverSampling;
+} UART_InitTypeDef;
+
+typedef struct __UART_HandleTypeDef
+{
+  USART_TypeDef          *Instance;
+  UART_InitTypeDef       Init;
+  uint8_t                *pRxBuffPtr;
+  uint16_t               RxXferSize;
+  volatile uint16_t      RxXferCount;
+  volatile uint32_t      ErrorCode;
+} UART_HandleTypeDef;
+
+typedef struct
+{
+  void *Instance;
+} TIM_HandleTypeDef, ETH_HandleTypeDef, DCACHE_HandleTypeDef, DMA_HandleTypeDef;
+
+/* OCTOSPI (XSPI API) */
+typedef struct
+{
+  uint32_t FifoThresholdByte;
+  uint32_t MemoryMode;
+  uint32_t MemoryType;
+  uint32_t MemorySize;
+  uint32_t ChipSelectHighTimeCycle;
+  uint32_t FreeRunningClock;
+  uint32_t ClockMode;
+  uint32_t WrapSize;
+  uint32_t ClockPrescaler;
+  uint32_t SampleShifting;
+  uint32_t DelayHoldQuarterCycle;
+  uint32_t ChipSelectBoundary;
+  uint32_t DelayBlockBypass;
+  uint32_t MaxTran;
+  uint32_t Refresh;
+} XSPI_InitTypeDef;
+
+typedef struct
+{
+  void              *Instance;
+  XSPI_InitTypeDef  Init;
+} XSPI_HandleTypeDef;
+
+typedef struct
+{
+  uint32_t Units;
+  uint32_t PhaseSel;
+} HAL_XSPI_DLYB_CfgTypeDef;
+
+/* RCC */
+typedef struct
+{
+  uint32_t PLLState;
+  uint32_t PLLSource;
+  uint32_t PLLM;
+  uint32_t PLLN;
+  uint32_t PLLP;
+  uint32_t PLLQ;
+  uint32_t PLLR;
+  uint32_t PLLRGE;
+  uint32_t PLLVCOSEL;
+  uint32_t PLLFRACN;
+} RCC_PLLInitTypeDef;
+
+typedef struct
+{
+  uint32_t OscillatorType;
+  uint32_t HSEState;
+  uint32_t LSEState;
+  uint32_t HSIState;
+  uint32_t HSIDiv;
+  uint32_t HSICalibrationValue;
+  uint32_t LSIState;
+  uint32_t CSIState;
+  uint32_t CSICalibrationValue;
+  uint32_t HSI48State;
+  RCC_PLLInitTypeDef PLL;
+} RCC_OscInitTypeDef;
+
+typedef struct
+{
+  uint32_t ClockType;
+  uint32_t SYSCLKSource;
+  uint32_t AHBCLKDivider;
+  uint32_t APB1CLKDivider;
+  uint32_t APB2CLKDivider;
+  uint32_t APB3CLKDivider;
+} RCC_ClkInitTypeDef;
+
+/* Exported constants --------------------------------------------------------*/
+#define HAL_MAX_DELAY                   0xFFFFFFFFU
+
+/* Peripheral instances: distinct addresses so that Instance comparisons work */
+extern USART_TypeDef host_usart_instances[4];
+#define USART1                          (&host_usart_instances[1])
+#define USART3                          (&host_usart_instances[3])
+#define OCTOSPI1                        ((void *)0x47001400U)
+#define TIM6                            ((void *)0x40001000U)
+#define GPDMA1                          ((void *)0x40020000U)
+
+/* UART status flags, bit positions as in the USART ISR register */
+#define UART_FLAG_PE                    (1UL << 0)
+#define UART_FLAG_FE                    (1UL << 1)
+#define UART_FLAG_NE                    (1UL << 2)
+#define UART_FLAG_ORE                   (1UL << 3)
+#define UART_FLAG_IDLE                  (1UL << 4)
+#define UART_FLAG_RXNE                  (1UL << 5)
+#define UART_FLAG_RTOF                  (1UL << 11)
+#define UART_CLEAR_PEF                  UART_FLAG_PE
+#define UART_CLEAR_FEF                  UART_FLAG_FE
+#define UART_CLEAR_NEF                  UART_FLAG_NE
+#define UART_CLEAR_OREF                 UART_FLAG_ORE
+#define UART_CLEAR_IDLEF                UART_FLAG_IDLE
+#define UART_CLEAR_RTOF                 UART_FLAG_RTOF
+
+#define HAL_UART_ERROR_NONE             0x00000000U
+#define HAL_UART_ERROR_ORE              0x00000008U
+#define HAL_UART_ERROR_DMA              0x00000010U
+
+/* Accepted and ignored configuration values */
+#define PWR_REGULATOR_VOLTAGE_SCALE0    0U
+#define PWR_FLAG_VOSRDY                 0U
+#define RCC_OSCILLATORTYPE_HSE          0U
+#define RCC_HSE_BYPASS_DIGITAL          0U
+#define RCC_PLL_ON                      0U
+#define RCC_PLL1_SOURCE_HSE             0U
+#define RCC_PLL1_VCIRANGE_2             0U
+#define RCC_PLL1_VCORANGE_WIDE          0U
+#define RCC_CLOCKTYPE_HCLK              0U
+#define RCC_CLOCKTYPE_SYSCLK            0U
+#define RCC_CLOCKTYPE_PCLK1             0U
+#define RCC_CLOCKTYPE_PCLK2             0U
+#define RCC_CLOCKTYPE_PCLK3             0U
+#define RCC_SYSCLKSOURCE_PLLCLK         0U
+#define RCC_SYSCLK_DIV1                 0U
+#define RCC_HCLK_DIV1                   0U
+#define FLASH_LATENCY_5                 0U
+#define FLASH_PROGRAMMING_DELAY_2       0U
+#define HAL_XSPI_SINGLE_MEM             0U
+#define HAL_XSPI_MEMTYPE_MACRONIX       0U
+#define HAL_XSPI_SIZE_512MB             0U
+#define HAL_XSPI_FREERUNCLK_DISABLE     0U
+#define HAL_XSPI_CLOCK_MODE_0           0U
+#define HAL_XSPI_WRAP_NOT_SUPPORTED     0U
+#define HAL_XSPI_SAMPLE_SHIFT_NONE      0U
+#define HAL_XSPI_DHQC_ENABLE            0U
+#define HAL_XSPI_BONDARYOF_NONE         0U
+#define HAL_XSPI_DELAY_BLOCK_ON         0U
+#define EXTI13_IRQn                     24
+#define EXTI14_IRQn                     25
+#define GPDMA1_Channel0_IRQn            27
+#define GPDMA1_Channel1_IRQn            28
+#define GPDMA1_Channel2_IRQn            29
+#define TIM6_IRQn                       49
+#define USART1_IRQn                     58
+#define USART3_IRQn                     60
+#define OCTOSPI1_IRQn                   78
+#define ETH_IRQn                        106
+#define GPIO_PIN_13                     ((uint16_t)0x2000)
+
+/* Exported macros -----------------------------------------------------------*/
+#define READ_REG(REG)                   ((REG))
+#define WRITE_REG(REG, VAL)             ((REG) = (VAL))
+#define UNUSED(X)                       (void)(X)
+
+#define __HAL_UART_GET_FLAG(__HANDLE__, __FLAG__)   \
+  (((__HANDLE__)->Instance->ISR & (__FLAG__)) == (__FLAG__))
+#define __HAL_UART_CLEAR_FLAG(__HANDLE__, __FLAG__) \
+  ((__HANDLE__)->Instance->ISR &= ~(uint32_t)(__FLAG__))
+
+#define __HAL_PWR_VOLTAGESCALING_CONFIG(__REGULATOR__)  ((void)(__REGULATOR__))
+#define __HAL_PWR_GET_FLAG(__FLAG__)                    (1U)
+#define __HAL_FLASH_SET_PROGRAM_DELAY(__DELAY__)        ((void)(__DELAY__))
+
+#define __HAL_RCC_GPDMA1_CLK_ENABLE()                   ((void)0)
+
+#define __disable_irq()                 ((void)0)
+#define __enable_irq()                  ((void)0)
+
+/* Exported functions --------------------------------------------------------*/
+HAL_StatusTypeDef HAL_Init(void);
+void HAL_IncTick(void);
+uint32_t HAL_GetTick(void);
+void HAL_Delay(uint32_t Delay);
+
+HAL_StatusTypeDef HAL_RCC_OscConfig(RCC_OscInitTypeDef *RCC_OscInitStruct);
+HAL_StatusTypeDef HAL_RCC_ClockConfig(RCC_ClkInitTypeDef *RCC_ClkInitStruct, uint32_t FLatency);
+
+void HAL_NVIC_SetPriority(IRQn_Type IRQn, uint32_t PreemptPriority, uint32_t SubPriority);
+void HAL_NVIC_EnableIRQ(IRQn_Type IRQn);
+
+HAL_StatusTypeDef HAL_XSPI_Init(XSPI_HandleTypeDef *hxspi);
+HAL_StatusTypeDef HAL_XSPI_DLYB_SetConfig(XSPI_HandleTypeDef *hxspi, HAL_XSPI_DLYB_CfgTypeDef *pdlyb_cfg);
+
+HAL_StatusTypeDef HAL_UART_Init(UART_HandleTypeDef *huart);
+HAL_StatusTypeDef HAL_UART_Transmit(UART_HandleTypeDef *huart, const uint8_t *pData, uint16_t Size, uint32_t Timeout);
+HAL_StatusTypeDef HAL_UART_Receive(UART_HandleTypeDef *huart, uint8_t *pData, uint16_t Size, uint32_t Timeout);
+HAL_StatusTypeDef HAL_UART_Receive_IT(UART_HandleTypeDef *huart, uint8_t *pData, uint16_t Size);
+HAL_StatusTypeDef HAL_UART_Transmit_DMA(UART_HandleTypeDef *huart, const uint8_t *pData, uint16_t Size);
+void HAL_UART_TxCpltCallback(UART_HandleTypeDef *huart);
+void HAL_UART_RxCpltCallback(UART_HandleTypeDef *huart);
+void HAL_UART_ErrorCallback(UART_HandleTypeDef *huart);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* STM32H5xx_HAL_H */
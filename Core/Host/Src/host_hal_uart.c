@@ -0,0 +1,566 @@
+/**
+  ******************************************************************************
+  * @file    host_hal_uart.c
+  * @brief   Host (Linux) emulation of the HAL and BSP services used by the
+  *          METEO firmware.
+  *
+  *          - USART3 (METEO sensor): bytes are read from the file or FIFO named
+  *            by METEO_HOST_UART3 and delivered one at a time from an emulated
+  *            RX interrupt, i.e. HAL_UART_RxCpltCallback() runs between
+  *            _tx_thread_context_save() and _tx_thread_context_restore() just
+  *            like the real USART3_IRQHandler. A byte arriving while reception
+  *            is not armed raises ORE and HAL_UART_ErrorCallback().
+  *          - Bytes are at least one character time (10 bits at the
+  *            configured baud rate) apart. Lines are paced
+  *            METEO_HOST_UART3_LINE_TICKS ThreadX ticks apart (default one
+  *            second, 0 = back to back at the line rate).
+  *          - COM1 (VCP console): output to stdout. stdin (raw mode on a
+  *            terminal) is read by HAL_UART_Receive(), or once
+  *            HAL_UART_Receive_IT() is armed on it, delivered from an
+  *            emulated USART1 RX interrupt like USART3.
+  *          - COM1 TX DMA: a pthread writes each HAL_UART_Transmit_DMA() block
+  *            to stdout in the time the line takes, then raises the emulated
+  *            USART1 TX complete interrupt. printf() reaches it as on the
+  *            target: once meteo_console_init() has run, stdout is a stream
+  *            over meteo_console_write(), like _write() in syscalls.c.
+  *
+  *          Clock, GPIO, cache, Ethernet and OCTOSPI initialisation is accepted
+  *          and ignored.
+  ******************************************************************************
+  */
+
+/* Includes ------------------------------------------------------------------*/
+#define _GNU_SOURCE                 /* fopencookie() */
+#include <errno.h>
+#include <poll.h>
+#include <pthread.h>
+#include <stdio.h>
+#include <stdio_ext.h>
+#include <stdlib.h>
+#include <termios.h>
+#include <time.h>
+#include <unistd.h>
+
+#include "main.h"
+#include "usart.h"
+#include "gpio.h"
+#include "icache.h"
+#include "dcache.h"
+#include "eth.h"
+#include "stm32h573i_discovery.h"
+#include "tx_api.h"
+#include "tx_timer.h"
+#include "meteo_console.h"
+
+/* Private defines -----------------------------------------------------------*/
+#define HOST_UART3_ENV              "METEO_HOST_UART3"
+#define HOST_UART3_LINE_TICKS_ENV   "METEO_HOST_UART3_LINE_TICKS"
+
+/* Host wake-up period while waiting for the firmware, in microseconds */
+#define HOST_UART_POLL_US           100U
+
+/* Private variables ---------------------------------------------------------*/
+USART_TypeDef host_usart_instances[4];
+
+UART_HandleTypeDef hcom_uart[COM_NBR];
+UART_HandleTypeDef huart3;
+DCACHE_HandleTypeDef hdcache1;
+ETH_HandleTypeDef heth;
+
+static pthread_t host_uart3_thread;
+static int host_uart3_started;
+static pthread_t host_console_thread;
+static int host_console_started;
+
+static struct termios host_console_saved;
+static int host_console_raw;
+
+/* COM1 TX DMA: block in flight (size 0 = idle) */
+static pthread_t host_com1_tx_thread;
+static int host_com1_tx_started;
+static pthread_mutex_t host_com1_tx_lock = PTHREAD_MUTEX_INITIALIZER;
+static pthread_cond_t host_com1_tx_cond = PTHREAD_COND_INITIALIZER;
+static const uint8_t *host_com1_tx_data;
+static uint16_t host_com1_tx_size;
+
+/* Private function prototypes -----------------------------------------------*/
+static void *host_uart3_feeder(void *arg);
+static void *host_console_feeder(void *arg);
+static void *host_com1_tx_dma(void *arg);
+static ssize_t host_stdout_write(void *cookie, const char *buf, size_t size);
+static void host_console_restore(void);
+void host_uart3_input_begin(void);
+void host_uart3_input_end(void);
+ULONG host_time_get(void);
+
+/* HAL core ------------------------------------------------------------------*/
+HAL_StatusTypeDef HAL_Init(void)
+{
+  cookie_io_functions_t io = { NULL, host_stdout_write, NULL, NULL };
+  FILE *console = fopencookie(NULL, "w", io);
+
+  /* printf() goes through host_stdout_write(), the _write() of the host */
+  if (console != NULL)
+  {
+    stdout = console;
+  }
+
+  /* No stream lock, as newlib-nano on the target: a ThreadX thread waiting
+     in meteo_console_write() would otherwise stall every other printf()
+     caller in a pthread lock the ThreadX scheduler cannot see */
+  __fsetlocking(stdout, FSETLOCKING_BYCALLER);
+
+  /* stdout is the VCP: do not hold back partial lines */
+  setvbuf(stdout, NULL, _IONBF, 0);
+  return HAL_OK;
+}
+
+void HAL_IncTick(void)
+{
+  /* HAL_GetTick() follows the ThreadX clock */
+}
+
+uint32_t HAL_GetTick(void)
+{
+  return (uint32_t)(((uint64_t)host_time_get() * 1000U) / TX_TIMER_TICKS_PER_SECOND);
+}
+
+/* tx_time_get() for the feeder pthreads: they are neither ThreadX threads nor
+   in an emulated interrupt, so they must not enter the kernel (or its trace) */
+ULONG host_time_get(void)
+{
+  return _tx_timer_system_clock;
+}
+
+void HAL_Delay(uint32_t Delay)
+{
+  ULONG ticks = (ULONG)(((uint64_t)Delay * TX_TIMER_TICKS_PER_SECOND + 999U) / 1000U);
+
+  if (tx_thread_identify() != TX_NULL)
+  {
+    tx_thread_sleep(ticks);
+  }
+  else
+  {
+    usleep(Delay * 1000U);
+  }
+}
+
+HAL_StatusTypeDef HAL_RCC_OscConfig(RCC_OscInitTypeDef *RCC_OscInitStruct)
+{
+  UNUSED(RCC_OscInitStruct);
+  return HAL_OK;
+}
+
+HAL_StatusTypeDef HAL_RCC_ClockConfig(RCC_ClkInitTypeDef *RCC_ClkInitStruct, uint32_t FLatency)
+{
+  UNUSED(RCC_ClkInitStruct);
+  UNUSED(FLatency);
+  return HAL_OK;
+}
+
+void HAL_NVIC_SetPriority(IRQn_Type IRQn, uint32_t PreemptPriority, uint32_t SubPriority)
+{
+  UNUSED(IRQn);
+  UNUSED(PreemptPriority);
+  UNUSED(SubPriority);
+}
+
+void HAL_NVIC_EnableIRQ(IRQn_Type IRQn)
+{
+  UNUSED(IRQn);
+}
+
+HAL_StatusTypeDef HAL_XSPI_Init(XSPI_HandleTypeDef *hxspi)
+{
+  UNUSED(hxspi);
+  return HAL_OK;
+}
+
+HAL_StatusTypeDef HAL_XSPI_DLYB_SetConfig(XSPI_HandleTypeDef *hxspi, HAL_XSPI_DLYB_CfgTypeDef *pdlyb_cfg)
+{
+  UNUSED(hxspi);
+  UNUSED(pdlyb_cfg);
+  return HAL_OK;
+}
+
+/* CubeMX peripheral initialisation ------------------------------------------*/
+void MX_GPIO_Init(void)
+{
+}
+
+void MX_ICACHE_Init(void)
+{
+}
+
+void MX_DCACHE1_Init(void)
+{
+}
+
+void MX_ETH_Init(void)
+{
+}
+
+void MX_USART3_UART_Init(void)
+{
+  huart3.Instance = USART3;
+  huart3.Init.BaudRate = 38400;
+  if (HAL_UART_Init(&huart3) != HAL_OK)
+  {
+    Error_Handler();
+  }
+}
+
+/* UART ----------------------------------------------------------------------*/
+HAL_StatusTypeDef HAL_UART_Init(UART_HandleTypeDef *huart)
+{
+  if (huart == NULL)
+  {
+    return HAL_ERROR;
+  }
+  huart->pRxBuffPtr = NULL;
+  huart->RxXferSize = 0U;
+  huart->RxXferCount = 0U;
+  huart->ErrorCode = HAL_UART_ERROR_NONE;
+  huart->Instance->ISR = 0U;
+  return HAL_OK;
+}
+
+HAL_StatusTypeDef HAL_UART_Transmit(UART_HandleTypeDef *huart, const uint8_t *pData, uint16_t Size, uint32_t Timeout)
+{
+  UNUSED(huart);
+  UNUSED(Timeout);
+
+  if (write(STDOUT_FILENO, pData, Size) != (ssize_t)Size)
+  {
+    return HAL_ERROR;
+  }
+  return HAL_OK;
+}
+
+/**
+  * @brief  Blocking receive. Only the console (COM1) is connected to a host
+  *         stream; Timeout is in milliseconds as on the target, 0 polls.
+  */
+HAL_StatusTypeDef HAL_UART_Receive(UART_HandleTypeDef *huart, uint8_t *pData, uint16_t Size, uint32_t Timeout)
+{
+  struct pollfd pfd;
+  uint16_t count = 0U;
+
+  if (huart->Instance != USART1)
+  {
+    return HAL_ERROR;
+  }
+
+  pfd.fd = STDIN_FILENO;
+  pfd.events = POLLIN;
+
+  while (count < Size)
+  {
+    int wait_ms = (Timeout == HAL_MAX_DELAY) ? -1 : (int)Timeout;
+    int ready = poll(&pfd, 1, wait_ms);
+
+    if (ready < 0 && errno == EINTR)
+    {
+      continue;
+    }
+    if (ready <= 0 || (pfd.revents & POLLIN) == 0)
+    {
+      return HAL_TIMEOUT;
+    }
+    if (read(STDIN_FILENO, &pData[count], 1U) != 1)
+    {
+      return HAL_ERROR;
+    }
+    count++;
+  }
+  return HAL_OK;
+}
+
+/**
+  * @brief  Arm interrupt reception. The USART3 and console feeders are started
+  *         on the first call, so no byte is delivered before the firmware is
+  *         listening.
+  */
+HAL_StatusTypeDef HAL_UART_Receive_IT(UART_HandleTypeDef *huart, uint8_t *pData, uint16_t Size)
+{
+  if (pData == NULL || Size == 0U)
+  {
+    return HAL_ERROR;
+  }
+
+  huart->pRxBuffPtr = pData;
+  huart->RxXferSize = Size;
+  huart->RxXferCount = Size;
+
+  if (huart->Instance == USART3 && !host_uart3_started)
+  {
+    const char *path = getenv(HOST_UART3_ENV);
+
+    host_uart3_started = 1;
+    if (path == NULL || path[0] == '\0')
+    {
+      printf("[HOST] %s not set - USART3 is idle\r\n", HOST_UART3_ENV);
+    }
+    else if (pthread_create(&host_uart3_thread, NULL, host_uart3_feeder, huart) != 0)
+    {
+      printf("[HOST] Cannot start USART3 feeder\r\n");
+      return HAL_ERROR;
+    }
+  }
+  else if (huart->Instance == USART1 && !host_console_started)
+  {
+    host_console_started = 1;
+    if (pthread_create(&host_console_thread, NULL, host_console_feeder, huart) != 0)
+    {
+      printf("[HOST] Cannot start console feeder\r\n");
+      return HAL_ERROR;
+    }
+  }
+  return HAL_OK;
+}
+
+/**
+  * @brief  Start a COM1 transmission by "DMA": host_com1_tx_dma() sends it.
+  *         HAL_BUSY while the previous block is still going out.
+  */
+HAL_StatusTypeDef HAL_UART_Transmit_DMA(UART_HandleTypeDef *huart, const uint8_t *pData, uint16_t Size)
+{
+  HAL_StatusTypeDef status = HAL_OK;
+
+  if (huart->Instance != USART1 || pData == NULL || Size == 0U)
+  {
+    return HAL_ERROR;
+  }
+
+  pthread_mutex_lock(&host_com1_tx_lock);
+  if (host_com1_tx_size != 0U)
+  {
+    status = HAL_BUSY;
+  }
+  else if (!host_com1_tx_started &&
+           pthread_create(&host_com1_tx_thread, NULL, host_com1_tx_dma, huart) != 0)
+  {
+    status = HAL_ERROR;
+  }
+  else
+  {
+    host_com1_tx_started = 1;
+    host_com1_tx_data = pData;
+    host_com1_tx_size = Size;
+    pthread_cond_signal(&host_com1_tx_cond);
+  }
+  pthread_mutex_unlock(&host_com1_tx_lock);
+  return status;
+}
+
+/* Deliver one received byte from an emulated UART RX interrupt */
+static void host_uart_irq(UART_HandleTypeDef *huart, uint8_t byte)
+{
+  _tx_thread_context_save();
+
+  if (huart->RxXferCount == 0U)
+  {
+    /* Nobody listening: the byte is lost, as in a real overrun */
+    huart->Instance->ISR |= UART_FLAG_ORE;
+    huart->ErrorCode |= HAL_UART_ERROR_ORE;
+    HAL_UART_ErrorCallback(huart);
+  }
+  else
+  {
+    huart->pRxBuffPtr[huart->RxXferSize - huart->RxXferCount] = byte;
+    huart->RxXferCount--;
+    if (huart->RxXferCount == 0U)
+    {
+      HAL_UART_RxCpltCallback(huart);
+    }
+  }
+
+  _tx_thread_context_restore();
+}
+
+static void *host_uart3_feeder(void *arg)
+{
+  UART_HandleTypeDef *huart = (UART_HandleTypeDef *)arg;
+  const char *path = getenv(HOST_UART3_ENV);
+  const char *pace = getenv(HOST_UART3_LINE_TICKS_ENV);
+  ULONG line_ticks = TX_TIMER_TICKS_PER_SECOND;
+  ULONG next_line;
+  unsigned long bytes = 0UL;
+  useconds_t byte_us = HOST_UART_POLL_US;
+  FILE *in;
+  int c;
+
+  if (pace != NULL && pace[0] != '\0')
+  {
+    line_ticks = (ULONG)strtoul(pace, NULL, 0);
+  }
+
+  if (huart->Init.BaudRate != 0U)
+  {
+    byte_us = (useconds_t)(10000000UL / huart->Init.BaudRate);
+  }
+
+  /* This pthread is the USART3 interrupt: profile its time under that IRQ */
+  _tx_linux_isr_id = 16U + USART3_IRQn;
+
+  in = fopen(path, "rb");
+  if (in == NULL)
+  {
+    printf("[HOST] Cannot open %s for USART3\r\n", path);
+    return NULL;
+  }
+
+  host_uart3_input_begin();
+  next_line = host_time_get();
+  while ((c = fgetc(in)) != EOF)
+  {
+    /* One character time on the line */
+    usleep(byte_us);
+
+    host_uart_irq(huart, (uint8_t)c);
+    bytes++;
+
+    if (c == '\n' && line_ticks != 0U)
+    {
+      next_line += line_ticks;
+      while ((LONG)(host_time_get() - next_line) < 0)
+      {
+        usleep(HOST_UART_POLL_US);
+      }
+    }
+  }
+
+  fclose(in);
+  printf("[HOST] USART3 input finished after %lu bytes\r\n", bytes);
+  host_uart3_input_end();
+  return NULL;
+}
+
+static void *host_console_feeder(void *arg)
+{
+  UART_HandleTypeDef *huart = (UART_HandleTypeDef *)arg;
+  uint8_t key;
+
+  /* This pthread is the USART1 (COM1) interrupt */
+  _tx_linux_isr_id = 16U + USART1_IRQn;
+
+  while (read(STDIN_FILENO, &key, 1U) == 1)
+  {
+    /* Keys are not lost while the firmware re-arms reception */
+    while (huart->RxXferCount == 0U)
+    {
+      usleep(HOST_UART_POLL_US);
+    }
+    host_uart_irq(huart, key);
+  }
+  return NULL;
+}
+
+static void *host_com1_tx_dma(void *arg)
+{
+  UART_HandleTypeDef *huart = (UART_HandleTypeDef *)arg;
+  useconds_t byte_us = (huart->Init.BaudRate != 0U) ? (useconds_t)(10000000UL / huart->Init.BaudRate) : 0U;
+  const uint8_t *data;
+  size_t size;
+  ssize_t written;
+
+  /* This pthread is the USART1 TX complete interrupt */
+  _tx_linux_isr_id = 16U + USART1_IRQn;
+
+  while (1)
+  {
+    pthread_mutex_lock(&host_com1_tx_lock);
+    while (host_com1_tx_size == 0U)
+    {
+      pthread_cond_wait(&host_com1_tx_cond, &host_com1_tx_lock);
+    }
+    data = host_com1_tx_data;
+    size = host_com1_tx_size;
+    pthread_mutex_unlock(&host_com1_tx_lock);
+
+    /* The block is on the line for one character time per byte */
+    usleep(byte_us * (useconds_t)size);
+    while (size > 0U && (written = write(STDOUT_FILENO, data, size)) > 0)
+    {
+      data += written;
+      size -= (size_t)written;
+    }
+
+    /* Idle again before the callback, which may start the next block */
+    pthread_mutex_lock(&host_com1_tx_lock);
+    host_com1_tx_size = 0U;
+    pthread_mutex_unlock(&host_com1_tx_lock);
+
+    _tx_thread_context_save();
+    HAL_UART_TxCpltCallback(huart);
+    _tx_thread_context_restore();
+  }
+  return NULL;
+}
+
+/**
+  * @brief  stdout writer. ThreadX threads use meteo_console_write(); the
+  *         feeder and timer pthreads (emulated interrupts, _tx_linux_isr_id
+  *         set) must not wait in the kernel and use the ISR variant.
+  */
+static ssize_t host_stdout_write(void *cookie, const char *buf, size_t size)
+{
+  UNUSED(cookie);
+
+  if (!meteo_console_active())
+  {
+    return write(STDOUT_FILENO, buf, size);
+  }
+  if (_tx_linux_isr_id != 0U)
+  {
+    (void)meteo_console_write_isr(buf, (int)size);
+  }
+  else
+  {
+    (void)meteo_console_write(buf, (int)size);
+  }
+  return (ssize_t)size;
+}
+
+/* BSP -----------------------------------------------------------------------*/
+int32_t BSP_COM_Init(COM_TypeDef COM, COM_InitTypeDef *COM_Init)
+{
+  struct termios raw;
+
+  if (COM >= COM_NBR || COM_Init == NULL)
+  {
+    return BSP_ERROR_WRONG_PARAM;
+  }
+
+  hcom_uart[COM].Instance = USART1;
+  hcom_uart[COM].Init.BaudRate = COM_Init->BaudRate;
+  (void)HAL_UART_Init(&hcom_uart[COM]);
+
+  /* Console keys are single-key commands: no line editing, no echo */
+  if (!host_console_raw && isatty(STDIN_FILENO) &&
+      tcgetattr(STDIN_FILENO, &host_console_saved) == 0)
+  {
+    raw = host_console_saved;
+    raw.c_lflag &= ~(tcflag_t)(ICANON | ECHO);
+    raw.c_cc[VMIN] = 1;
+    raw.c_cc[VTIME] = 0;
+    if (tcsetattr(STDIN_FILENO, TCSANOW, &raw) == 0)
+    {
+      host_console_raw = 1;
+      atexit(host_console_restore);
+    }
+  }
+  return BSP_ERROR_NONE;
+}
+
+int32_t BSP_PB_Init(Button_TypeDef Button, ButtonMode_TypeDef ButtonMode)
+{
+  UNUSED(ButtonMode);
+  return (Button < BUTTON_NBR) ? BSP_ERROR_NONE : BSP_ERROR_WRONG_PARAM;
+}
+
+static void host_console_restore(void)
+{
+  (void)tcsetattr(STDIN_FILENO, TCSANOW, &host_console_saved);
+}
@@ -0,0 +1,1595 @@
+/**
+  ******************************************************************************
+  * @file    host_ittia_db.c
+  * @brief   Host (Linux) stand-in for ITTIA DB Lite streams, index storage
+  *          and IoT time series, see host_ittia_db.h.
+  *
+  *          Only what the firmware calls is there. Rows are kept in memory,
+  *          an index as an array of entries sorted with the compare
+  *          function given to db_open_index_storage, a time series as
+  *          arrays of timestamps and values sorted by time, and the calls
+  *          check their arguments and return the dbstatus_t codes of the
+  *          library. Nothing is persisted: a storage lives until
+  *          db_close_storage.
+  ******************************************************************************
+  */
+
+/* Includes ------------------------------------------------------------------*/
+#include <stdlib.h>
+#include <string.h>
+
+#include "host_ittia_db.h"
+#include "tx_api.h"
+
+/* Private defines -----------------------------------------------------------*/
+#define HOST_DB_MAX_FIELDS      16
+#define HOST_DB_MAX_KEYS        4
+#define HOST_DB_MAX_OUTPUTS     4U
+#define HOST_DB_MAX_STORAGES    4U
+#define HOST_DB_MAX_INDEXES     4U
+#define HOST_DB_NAME_SIZE       48U
+#define HOST_DB_MAX_SERIES      8U
+
+/* Series data of a point: its timestamp and a float32, no compression */
+#define HOST_DB_POINT_BYTES     ((int64_t)(sizeof(int64_t) + sizeof(float32_t)))
+
+/* Key fields compared by put: the compare functions of a schema stop at
+   their last key field */
+#define HOST_DB_WHOLE_KEY       ((size_t)HOST_DB_MAX_KEYS)
+
+/* Private types -------------------------------------------------------------*/
+typedef enum
+{
+  HOST_DB_NODE_INPUT,
+  HOST_DB_NODE_VIEW,
+  HOST_DB_NODE_TABLE
+} host_db_node_kind_t;
+
+typedef union
+{
+  int64_t i;
+  double f;
+} host_db_value_t;
+
+typedef struct
+{
+  size_t key_size;
+  size_t size;
+  uint8_t data[];
+} host_db_entry_t;
+
+typedef struct
+{
+  host_db_entry_t **entries;
+  size_t count;
+  size_t capacity;
+  char table[HOST_DB_NAME_SIZE];
+} host_db_index_t;
+
+typedef struct
+{
+  char name[HOST_DB_NAME_SIZE];
+  db_timestamp_usec_t *usec;
+  float32_t *value;
+  size_t count;
+  size_t capacity;
+} host_db_series_t;
+
+typedef struct
+{
+  char name[HOST_DB_NAME_SIZE];
+  int open;
+  uint32_t connections;
+  db_index_compare_keys_t compare[HOST_DB_MAX_INDEXES];
+  size_t index_count;
+  host_db_index_t index[HOST_DB_MAX_INDEXES];
+
+  /* IoT storage: the series, their retention, the file size so far */
+  int iot;
+  int32_t page_size;
+  host_db_series_t series[HOST_DB_MAX_SERIES];
+  size_t series_count;
+  int64_t retain_bytes;
+  int64_t max_bytes;
+  int64_t file_bytes;
+} host_db_storage_t;
+
+struct db_t_s
+{
+  host_db_storage_t *storage;
+};
+
+/* db_index_get hands out a copy: a remove may free the entry */
+struct db_index_t_s
+{
+  host_db_storage_t *storage;
+  int index_id;
+  uint8_t *row;
+  size_t row_capacity;
+};
+
+struct db_time_series_t_s
+{
+  host_db_storage_t *storage;
+  size_t series;
+};
+
+/* The next timestamp is looked up again on each fetch: puts and removes
+   may come in between from other connections */
+struct db_time_series_query_t_s
+{
+  host_db_storage_t *storage;
+  size_t series[HOST_DB_MAX_SERIES];
+  db_len_t count;
+  db_timestamp_usec_t next;       /* Lowest timestamp not fetched yet */
+  db_timestamp_usec_t end;        /* Exclusive */
+  db_timestamp_usec_t at;         /* Timestamp being fetched, from field */
+  db_len_t field;                 /* > 0: the list was full at this field */
+};
+
+struct db_stream_environment_s
+{
+  struct db_stream_node_s *views;
+};
+
+struct db_stream_graph_s
+{
+  struct db_stream_node_s *nodes;
+  size_t bytes;
+  size_t peak;
+};
+
+struct db_stream_node_s
+{
+  host_db_node_kind_t kind;
+  struct db_stream_graph_s *graph;
+  struct db_stream_node_s *graph_next;
+
+  /* Input: the schema and the row being set; output: the last row */
+  db_fielddef_t fields[HOST_DB_MAX_FIELDS];
+  db_len_t field_count;
+  db_fieldno_t timestamp_field;
+  db_fieldno_t keys[HOST_DB_MAX_KEYS];
+  db_len_t key_count;
+  host_db_value_t values[HOST_DB_MAX_FIELDS];
+  uint32_t set_mask;
+  struct db_stream_node_s *outputs[HOST_DB_MAX_OUTPUTS];
+  uint32_t output_count;
+
+  /* Registered output */
+  char name[HOST_DB_NAME_SIZE];
+  struct db_stream_environment_s *env;
+  struct db_stream_node_s *env_next;
+  uint32_t rows;
+
+  /* Table output */
+  db_t database;
+  int index_id;
+  size_t key_size;
+};
+
+/* Private variables ---------------------------------------------------------*/
+static TX_MUTEX host_db_mutex;
+static int host_db_mutex_created;
+static host_db_storage_t host_db_storages[HOST_DB_MAX_STORAGES];
+
+/* Private functions ---------------------------------------------------------*/
+
+/* Created by the first call, at set-up. The ThreadX initialisation is no
+   thread and nothing else runs then: no lock. */
+static void host_db_lock(void)
+{
+  if (tx_thread_identify() == TX_NULL)
+  {
+    return;
+  }
+  if (!host_db_mutex_created)
+  {
+    (void)tx_mutex_create(&host_db_mutex, "ITTIA host", TX_INHERIT);
+    host_db_mutex_created = 1;
+  }
+  (void)tx_mutex_get(&host_db_mutex, TX_WAIT_FOREVER);
+}
+
+static void host_db_unlock(void)
+{
+  if (tx_thread_identify() != TX_NULL)
+  {
+    (void)tx_mutex_put(&host_db_mutex);
+  }
+}
+
+static size_t host_db_field_width(db_coltype_t type)
+{
+  if (type == DB_COLTYPE_SINT8 || type == DB_COLTYPE_UINT8)
+  {
+    return 1U;
+  }
+  if (type == DB_COLTYPE_SINT16 || type == DB_COLTYPE_UINT16)
+  {
+    return 2U;
+  }
+  if (type == DB_COLTYPE_SINT32 || type == DB_COLTYPE_UINT32 || type == DB_COLTYPE_FLOAT32)
+  {
+    return 4U;
+  }
+  if (type == DB_COLTYPE_SINT64 || type == DB_COLTYPE_UINT64 || type == DB_COLTYPE_FLOAT64 ||
+      type == DB_COLTYPE_TIMESTAMP)
+  {
+    return 8U;
+  }
+  return 0U;
+}
+
+static int host_db_is_float(db_coltype_t type)
+{
+  return type == DB_COLTYPE_FLOAT32 || type == DB_COLTYPE_FLOAT64;
+}
+
+static void *host_db_graph_alloc(struct db_stream_graph_s *graph, size_t size)
+{
+  struct db_stream_node_s *node = calloc(1U, size);
+
+  if (node != NULL)
+  {
+    node->graph = graph;
+    node->graph_next = graph->nodes;
+    graph->nodes = node;
+    graph->bytes += size;
+    if (graph->bytes > graph->peak)
+    {
+      graph->peak = graph->bytes;
+    }
+  }
+  return node;
+}
+
+/* Field of a node by number, or NULL */
+static db_fielddef_t *host_db_field(db_stream_node_t node, db_fieldno_t field)
+{
+  if (node == NULL || field < 0 || field >= node->field_count)
+  {
+    return NULL;
+  }
+  return &node->fields[field];
+}
+
+static dbstatus_t host_db_set(db_stream_node_t node, db_fieldno_t field, host_db_value_t value, int is_float)
+{
+  dbstatus_t status = DB_NOERROR;
+  db_fielddef_t *def;
+
+  host_db_lock();
+  def = host_db_field(node, field);
+  if (def == NULL || node->kind != HOST_DB_NODE_INPUT)
+  {
+    status = DB_EINVAL;
+  }
+  else if (host_db_is_float(def->field_type) != is_float)
+  {
+    status = DB_EFIELDTYPE;
+  }
+  else
+  {
+    node->values[field] = value;
+    node->set_mask |= 1UL << field;
+  }
+  host_db_unlock();
+  return status;
+}
+
+static host_db_value_t host_db_get(db_stream_node_t node, db_fieldno_t field)
+{
+  host_db_value_t value = { 0 };
+
+  host_db_lock();
+  if (host_db_field(node, field) != NULL)
+  {
+    value = node->values[field];
+  }
+  host_db_unlock();
+  return value;
+}
+
+static host_db_storage_t *host_db_find_storage(const char *name)
+{
+  uint32_t i;
+
+  for (i = 0; i < HOST_DB_MAX_STORAGES; i++)
+  {
+    if (host_db_storages[i].open && strcmp(host_db_storages[i].name, name) == 0)
+    {
+      return &host_db_storages[i];
+    }
+  }
+  return NULL;
+}
+
+/* A free slot named name, cleared (lock held) */
+static dbstatus_t host_db_new_storage(const char *name, host_db_storage_t **storage)
+{
+  uint32_t i;
+
+  if (host_db_find_storage(name) != NULL)
+  {
+    return DB_EEXIST;
+  }
+  for (i = 0; i < HOST_DB_MAX_STORAGES; i++)
+  {
+    if (!host_db_storages[i].open)
+    {
+      *storage = &host_db_storages[i];
+      memset(*storage, 0, sizeof(**storage));
+      strcpy((*storage)->name, name);
+      return DB_NOERROR;
+    }
+  }
+  return DB_ENOMEM;
+}
+
+/* First entry not below key (compared on key_fields), as in db_index_get */
+static size_t host_db_lower_bound(host_db_storage_t *storage, int index_id, const void *key,
+                                  size_t key_fields)
+{
+  host_db_index_t *index = &storage->index[index_id];
+  size_t lo = 0U;
+  size_t hi = index->count;
+
+  while (lo < hi)
+  {
+    size_t mid = lo + (hi - lo) / 2U;
+
+    if (storage->compare[index_id](key, index->entries[mid]->data, key_fields, 0U) > BTREE_KEY_EQ)
+    {
+      lo = mid + 1U;
+    }
+    else
+    {
+      hi = mid;
+    }
+  }
+  return lo;
+}
+
+/* Insert, or overwrite the entry with the same key */
+static dbstatus_t host_db_index_put(host_db_storage_t *storage, int index_id, const void *data,
+                                   size_t key_size, size_t size)
+{
+  host_db_index_t *index = &storage->index[index_id];
+  host_db_entry_t *entry;
+  size_t at = host_db_lower_bound(storage, index_id, data, HOST_DB_WHOLE_KEY);
+  int same = at < index->count &&
+             storage->compare[index_id](data, index->entries[at]->data, HOST_DB_WHOLE_KEY, 0U) == BTREE_KEY_EQ;
+
+  entry = malloc(sizeof(*entry) + size);
+  if (entry == NULL)
+  {
+    return DB_ENOMEM;
+  }
+  entry->key_size = key_size;
+  entry->size = size;
+  memcpy(entry->data, data, size);
+
+  if (same)
+  {
+    free(index->entries[at]);
+    index->entries[at] = entry;
+    return DB_NOERROR;
+  }
+
+  if (index->count == index->capacity)
+  {
+    size_t capacity = (index->capacity != 0U) ? index->capacity * 2U : 64U;
+    host_db_entry_t **entries = realloc(index->entries, capacity * sizeof(*entries));
+
+    if (entries == NULL)
+    {
+      free(entry);
+      return DB_ENOMEM;
+    }
+    index->entries = entries;
+    index->capacity = capacity;
+  }
+  memmove(&index->entries[at + 1U], &index->entries[at], (index->count - at) * sizeof(*index->entries));
+  index->entries[at] = entry;
+  index->count++;
+  return DB_NOERROR;
+}
+
+/* Row of an input packed as a table entry */
+static size_t host_db_pack(db_stream_node_t input, uint8_t *row)
+{
+  size_t offset = 0U;
+  db_len_t i;
+
+  for (i = 0; i < input->field_count; i++)
+  {
+    db_coltype_t type = input->fields[i].field_type;
+    size_t width = host_db_field_width(type);
+
+    if (type == DB_COLTYPE_FLOAT32)
+    {
+      float value = (float)input->values[i].f;
+
+      memcpy(&row[offset], &value, width);
+    }
+    else if (type == DB_COLTYPE_FLOAT64)
+    {
+      memcpy(&row[offset], &input->values[i].f, width);
+    }
+    else
+    {
+      /* Little-endian: the low bytes of the value */
+      memcpy(&row[offset], &input->values[i].i, width);
+    }
+    offset += width;
+  }
+  return offset;
+}
+
+static dbstatus_t host_db_output(db_stream_node_t input, db_stream_node_t output)
+{
+  uint8_t row[HOST_DB_MAX_FIELDS * 8];
+  size_t size;
+
+  if (output->kind == HOST_DB_NODE_VIEW)
+  {
+    memcpy(output->values, input->values, sizeof(output->values));
+    output->rows++;
+    return DB_NOERROR;
+  }
+
+  if (output->database == NULL || output->database->storage == NULL)
+  {
+    return DB_EINVAL;
+  }
+  size = host_db_pack(input, row);
+  output->rows++;
+  return host_db_index_put(output->database->storage, output->index_id, row, output->key_size, size);
+}
+
+/* First point of a series not before usec */
+static size_t host_db_series_lower_bound(const host_db_series_t *series, db_timestamp_usec_t usec)
+{
+  size_t lo = 0U;
+  size_t hi = series->count;
+
+  while (lo < hi)
+  {
+    size_t mid = lo + (hi - lo) / 2U;
+
+    if (series->usec[mid] < usec)
+    {
+      lo = mid + 1U;
+    }
+    else
+    {
+      hi = mid;
+    }
+  }
+  return lo;
+}
+
+/* Series by name, series_count if there is none */
+static size_t host_db_find_series(const host_db_storage_t *storage, const char *name)
+{
+  size_t n;
+
+  for (n = 0; n < storage->series_count; n++)
+  {
+    if (strcmp(storage->series[n].name, name) == 0)
+    {
+      break;
+    }
+  }
+  return n;
+}
+
+/* Oldest timestamp from from, before end, in the series of list (NULL: the
+   first count of the storage), and the points at it. 0 if there is none. */
+static int host_db_series_next(host_db_storage_t *storage, const size_t *list, size_t count,
+                               db_timestamp_usec_t from, db_timestamp_usec_t end,
+                               db_timestamp_usec_t *usec, size_t *points)
+{
+  host_db_series_t *series;
+  size_t found = 0U;
+  size_t at;
+  size_t n;
+
+  for (n = 0; n < count; n++)
+  {
+    series = &storage->series[(list != NULL) ? list[n] : n];
+    at = host_db_series_lower_bound(series, from);
+    if (at == series->count || series->usec[at] >= end || (found != 0U && series->usec[at] > *usec))
+    {
+      continue;
+    }
+    found = (found != 0U && series->usec[at] == *usec) ? found + 1U : 1U;
+    *usec = series->usec[at];
+  }
+  if (points != NULL)
+  {
+    *points = found;
+  }
+  return found != 0U;
+}
+
+static int64_t host_db_series_bytes(const host_db_storage_t *storage)
+{
+  int64_t bytes = 0;
+  size_t n;
+
+  for (n = 0; n < storage->series_count; n++)
+  {
+    bytes += (int64_t)storage->series[n].count * HOST_DB_POINT_BYTES;
+  }
+  return bytes;
+}
+
+/* Pages in use: each series fills its own */
+static int64_t host_db_series_used_bytes(const host_db_storage_t *storage)
+{
+  int64_t used = 0;
+  int64_t bytes;
+  size_t n;
+
+  for (n = 0; n < storage->series_count; n++)
+  {
+    bytes = (int64_t)storage->series[n].count * HOST_DB_POINT_BYTES;
+    used += (bytes + storage->page_size - 1) / storage->page_size * storage->page_size;
+  }
+  return used;
+}
+
+/* Insert, or overwrite the point at the same timestamp */
+static dbstatus_t host_db_series_put(host_db_series_t *series, db_timestamp_usec_t usec, float32_t value)
+{
+  size_t at = (series->count == 0U || usec > series->usec[series->count - 1U])
+              ? series->count : host_db_series_lower_bound(series, usec);
+
+  if (at < series->count && series->usec[at] == usec)
+  {
+    series->value[at] = value;
+    return DB_NOERROR;
+  }
+
+  if (series->count == series->capacity)
+  {
+    size_t capacity = (series->capacity != 0U) ? series->capacity * 2U : 1024U;
+    db_timestamp_usec_t *times = realloc(series->usec, capacity * sizeof(*times));
+    float32_t *values;
+
+    if (times == NULL)
+    {
+      return DB_ENOMEM;
+    }
+    series->usec = times;
+    values = realloc(series->value, capacity * sizeof(*values));
+    if (values == NULL)
+    {
+      return DB_ENOMEM;
+    }
+    series->value = values;
+    series->capacity = capacity;
+  }
+  memmove(&series->usec[at + 1U], &series->usec[at], (series->count - at) * sizeof(*series->usec));
+  memmove(&series->value[at + 1U], &series->value[at], (series->count - at) * sizeof(*series->value));
+  series->usec[at] = usec;
+  series->value[at] = value;
+  series->count++;
+  return DB_NOERROR;
+}
+
+/* Points before usec out of every series, the distinct timestamps counted */
+static int32_t host_db_series_remove_before(host_db_storage_t *storage, db_timestamp_usec_t usec)
+{
+  host_db_series_t *series;
+  db_timestamp_usec_t from = INT64_MIN;
+  db_timestamp_usec_t at;
+  int32_t removed = 0;
+  size_t count;
+  size_t n;
+
+  while (host_db_series_next(storage, NULL, storage->series_count, from, usec, &at, NULL))
+  {
+    removed++;
+    from = at + 1;
+  }
+  for (n = 0; n < storage->series_count; n++)
+  {
+    series = &storage->series[n];
+    count = host_db_series_lower_bound(series, usec);
+    memmove(series->usec, &series->usec[count], (series->count - count) * sizeof(*series->usec));
+    memmove(series->value, &series->value[count], (series->count - count) * sizeof(*series->value));
+    series->count -= count;
+  }
+  return removed;
+}
+
+/* Past max_bytes, the oldest data goes down to retain_bytes: whole
+   timestamps here, pages in the library. The file keeps its size. */
+static void host_db_series_retain(host_db_storage_t *storage)
+{
+  int64_t bytes = host_db_series_bytes(storage);
+  int64_t used;
+  db_timestamp_usec_t from = INT64_MIN;
+  db_timestamp_usec_t at;
+  size_t points;
+
+  if (storage->max_bytes != 0 && bytes > storage->max_bytes)
+  {
+    while (bytes > storage->retain_bytes &&
+           host_db_series_next(storage, NULL, storage->series_count, from, INT64_MAX, &at, &points))
+    {
+      bytes -= (int64_t)points * HOST_DB_POINT_BYTES;
+      from = at + 1;
+    }
+    (void)host_db_series_remove_before(storage, from);
+  }
+
+  used = host_db_series_used_bytes(storage) + storage->page_size;
+  storage->file_bytes = (used > storage->file_bytes) ? used : storage->file_bytes;
+}
+
+/* Exported functions: streams -----------------------------------------------*/
+
+dbstatus_t db_stream_create_environment(db_stream_environment_t *stream_env)
+{
+  if (stream_env == NULL)
+  {
+    return DB_EINVAL;
+  }
+  *stream_env = calloc(1U, sizeof(**stream_env));
+  return (*stream_env != NULL) ? DB_NOERROR : DB_ENOMEM;
+}
+
+void db_stream_free_environment(db_stream_environment_t stream_env)
+{
+  struct db_stream_node_s *node;
+
+  if (stream_env == NULL)
+  {
+    return;
+  }
+  host_db_lock();
+  for (node = stream_env->views; node != NULL; node = node->env_next)
+  {
+    node->env = NULL;
+  }
+  host_db_unlock();
+  free(stream_env);
+}
+
+/* The graph memory is taken from the heap: mem and size are not used */
+dbstatus_t db_stream_create_graph(db_stream_graph_t *graph, void *mem, size_t size)
+{
+  (void)mem;
+  (void)size;
+
+  if (graph == NULL)
+  {
+    return DB_EINVAL;
+  }
+  *graph = calloc(1U, sizeof(**graph));
+  return (*graph != NULL) ? DB_NOERROR : DB_ENOMEM;
+}
+
+void db_stream_free_graph(db_stream_graph_t graph, size_t *peak_memory_size)
+{
+  struct db_stream_node_s *node;
+  struct db_stream_node_s *next;
+  struct db_stream_node_s **link;
+
+  if (graph == NULL)
+  {
+    return;
+  }
+
+  host_db_lock();
+  for (node = graph->nodes; node != NULL; node = next)
+  {
+    next = node->graph_next;
+    if (node->env != NULL)
+    {
+      for (link = &node->env->views; *link != NULL; link = &(*link)->env_next)
+      {
+        if (*link == node)
+        {
+          *link = node->env_next;
+          break;
+        }
+      }
+    }
+    free(node);
+  }
+  host_db_unlock();
+
+  if (peak_memory_size != NULL)
+  {
+    *peak_memory_size = graph->peak;
+  }
+  free(graph);
+}
+
+dbstatus_t db_stream_create_row_input_compound_key(db_stream_node_t *output, db_stream_graph_t graph,
+                                                   const db_fielddef_t *field_list, const db_len_t field_count,
+                                                   db_fieldno_t timestamp_field,
+                                                   const db_fieldno_t *key_field_list,
+                                                   const db_len_t key_field_count)
+{
+  struct db_stream_node_s *node;
+  db_len_t i;
+
+  if (output == NULL || graph == NULL || field_list == NULL ||
+      field_count <= 0 || field_count > HOST_DB_MAX_FIELDS ||
+      key_field_count < 0 || key_field_count > HOST_DB_MAX_KEYS ||
+      timestamp_field < 0 || timestamp_field >= field_count)
+  {
+    return DB_EINVAL;
+  }
+  for (i = 0; i < field_count; i++)
+  {
+    if (field_list[i].fieldno != (db_fieldno_t)i || host_db_field_width(field_list[i].field_type) == 0U)
+    {
+      return DB_EFIELD;
+    }
+  }
+  for (i = 0; i < key_field_count; i++)
+  {
+    if (key_field_list[i] < 0 || key_field_list[i] >= field_count)
+    {
+      return DB_EFIELD;
+    }
+  }
+
+  host_db_lock();
+  node = host_db_graph_alloc(graph, sizeof(*node));
+  if (node != NULL)
+  {
+    node->kind = HOST_DB_NODE_INPUT;
+    memcpy(node->fields, field_list, (size_t)field_count * sizeof(*field_list));
+    node->field_count = field_count;
+    node->timestamp_field = timestamp_field;
+    memcpy(node->keys, key_field_list, (size_t)key_field_count * sizeof(*key_field_list));
+    node->key_count = key_field_count;
+  }
+  host_db_unlock();
+
+  *output = node;
+  return (node != NULL) ? DB_NOERROR : DB_ENOMEM;
+}
+
+dbstatus_t db_stream_create_row_input(db_stream_node_t *output, db_stream_graph_t graph,
+                                      const db_fielddef_t *field_list, const db_len_t field_count,
+                                      db_fieldno_t timestamp_field, db_fieldno_t key_field)
+{
+  return db_stream_create_row_input_compound_key(output, graph, field_list, field_count,
+                                                 timestamp_field, &key_field, 1);
+}
+
+/* Output node of input, in the graph of input */
+static dbstatus_t host_db_add_output(db_stream_node_t *node, db_stream_node_t input, host_db_node_kind_t kind)
+{
+  struct db_stream_node_s *output;
+
+  if (node == NULL || input == NULL || input->kind != HOST_DB_NODE_INPUT)
+  {
+    return DB_EINVAL;
+  }
+  if (input->output_count == HOST_DB_MAX_OUTPUTS)
+  {
+    return DB_ENOMEM;
+  }
+
+  output = host_db_graph_alloc(input->graph, sizeof(*output));
+  if (output == NULL)
+  {
+    return DB_ENOMEM;
+  }
+  output->kind = kind;
+  memcpy(output->fields, input->fields, sizeof(output->fields));
+  output->field_count = input->field_count;
+  output->timestamp_field = input->timestamp_field;
+  memcpy(output->keys, input->keys, sizeof(output->keys));
+  output->key_count = input->key_count;
+  input->outputs[input->output_count++] = output;
+  *node = output;
+  return DB_NOERROR;
+}
+
+dbstatus_t db_stream_register_output(db_stream_node_t *node, db_stream_node_t input,
+                                     db_stream_environment_t stream_env, const char *stream_name)
+{
+  struct db_stream_node_s *view;
+  dbstatus_t status;
+
+  if (stream_env == NULL || stream_name == NULL || strlen(stream_name) >= HOST_DB_NAME_SIZE)
+  {
+    return DB_EINVAL;
+  }
+
+  host_db_lock();
+  for (view = stream_env->views; view != NULL; view = view->env_next)
+  {
+    if (strcmp(view->name, stream_name) == 0)
+    {
+      host_db_unlock();
+      return DB_EEXIST;
+    }
+  }
+  status = host_db_add_output(node, input, HOST_DB_NODE_VIEW);
+  if (DB_SUCCESS(status))
+  {
+    view = *node;
+    strcpy(view->name, stream_name);
+    view->env = stream_env;
+    view->env_next = stream_env->views;
+    stream_env->views = view;
+  }
+  host_db_unlock();
+  return status;
+}
+
+dbstatus_t db_stream_create_table_output(db_stream_node_t *output, db_stream_node_t input, db_t database,
+                                         const char *table_name, uint32_t flags,
+                                         db_table_output_policy_t *policy, int32_t buffer_row_count)
+{
+  db_materialization_policy_t materialize = (policy != NULL) ? policy->materialization_policy
+                                                             : DB_MATERIALIZE_REFRESH;
+  host_db_storage_t *storage;
+  struct db_stream_node_s *node;
+  db_len_t key_fields;
+  size_t key_size = 0U;
+  dbstatus_t status;
+  size_t index_id;
+  db_len_t i;
+
+  (void)flags;
+  (void)buffer_row_count;
+
+  if (input == NULL || database == NULL || table_name == NULL || strlen(table_name) >= HOST_DB_NAME_SIZE)
+  {
+    return DB_EINVAL;
+  }
+  if (materialize == DB_MATERIALIZE_TIME_SERIES)
+  {
+    return DB_ENOTIMPL;
+  }
+
+  /* The key fields, then the timestamp for a history: a prefix of the row */
+  key_fields = input->key_count;
+  for (i = 0; i < key_fields; i++)
+  {
+    if (input->keys[i] != (db_fieldno_t)i)
+    {
+      return DB_ENOTIMPL;
+    }
+  }
+  if (materialize == DB_MATERIALIZE_APPEND)
+  {
+    if (input->timestamp_field != (db_fieldno_t)key_fields)
+    {
+      return DB_ENOTIMPL;
+    }
+    key_fields++;
+  }
+  for (i = 0; i < key_fields; i++)
+  {
+    key_size += host_db_field_width(input->fields[i].field_type);
+  }
+
+  host_db_lock();
+  storage = database->storage;
+  for (index_id = 0; index_id < storage->index_count; index_id++)
+  {
+    if (storage->index[index_id].table[0] == '\0' || strcmp(storage->index[index_id].table, table_name) == 0)
+    {
+      break;
+    }
+  }
+  if (index_id == storage->index_count)
+  {
+    host_db_unlock();
+    return DB_ENOTFOUND;
+  }
+  strcpy(storage->index[index_id].table, table_name);
+
+  status = host_db_add_output(output, input, HOST_DB_NODE_TABLE);
+  if (DB_SUCCESS(status))
+  {
+    node = *output;
+    node->database = database;
+    node->index_id = (int)index_id;
+    node->key_size = key_size;
+  }
+  host_db_unlock();
+  return status;
+}
+
+dbstatus_t db_stream_set_sint32(db_stream_node_t stream, db_fieldno_t field, int32_t value)
+{
+  host_db_value_t v = { .i = value };
+
+  return host_db_set(stream, field, v, 0);
+}
+
+dbstatus_t db_stream_set_timestamp_usec(db_stream_node_t stream, db_fieldno_t field, db_timestamp_usec_t value)
+{
+  host_db_value_t v = { .i = value };
+
+  return host_db_set(stream, field, v, 0);
+}
+
+dbstatus_t db_stream_set_float32(db_stream_node_t stream, db_fieldno_t field, db_float32_t value)
+{
+  host_db_value_t v = { .f = value };
+
+  return host_db_set(stream, field, v, 1);
+}
+
+dbstatus_t db_stream_set_float64(db_stream_node_t stream, db_fieldno_t field, db_float64_t value)
+{
+  host_db_value_t v = { .f = value };
+
+  return host_db_set(stream, field, v, 1);
+}
+
+dbstatus_t db_stream_set_null(db_stream_node_t stream, db_fieldno_t field)
+{
+  dbstatus_t status = DB_NOERROR;
+
+  host_db_lock();
+  if (host_db_field(stream, field) == NULL || stream->kind != HOST_DB_NODE_INPUT)
+  {
+    status = DB_EINVAL;
+  }
+  else
+  {
+    stream->set_mask &= ~(1UL << field);
+  }
+  host_db_unlock();
+  return status;
+}
+
+/* The row set on an input goes to its outputs; the input is cleared */
+dbstatus_t db_stream_process(db_stream_node_t stream)
+{
+  dbstatus_t status = DB_NOERROR;
+  uint32_t i;
+  db_len_t f;
+
+  if (stream == NULL || stream->kind != HOST_DB_NODE_INPUT)
+  {
+    return DB_EINVAL;
+  }
+
+  host_db_lock();
+  for (f = 0; f < stream->field_count; f++)
+  {
+    if ((stream->fields[f].field_flags & DB_NOT_NULL) != 0U && (stream->set_mask & (1UL << f)) == 0U)
+    {
+      status = DB_ENULLFIELD;
+    }
+  }
+  for (i = 0; i < stream->output_count && DB_SUCCESS(status); i++)
+  {
+    status = host_db_output(stream, stream->outputs[i]);
+  }
+  stream->set_mask = 0U;
+  host_db_unlock();
+  return status;
+}
+
+int32_t db_stream_get_sint32(db_stream_node_t stream, db_fieldno_t field)
+{
+  return (int32_t)host_db_get(stream, field).i;
+}
+
+db_timestamp_usec_t db_stream_get_timestamp_usec(db_stream_node_t stream, db_fieldno_t field)
+{
+  return (db_timestamp_usec_t)host_db_get(stream, field).i;
+}
+
+db_float64_t db_stream_get_float64(db_stream_node_t stream, db_fieldno_t field)
+{
+  return host_db_get(stream, field).f;
+}
+
+/* Exported functions: index storage -----------------------------------------*/
+
+/* The driver and the page cache of config are not used */
+dbstatus_t db_open_index_storage(const char *storage_name, const db_database_config_t *config,
+                                 const db_index_compare_keys_t *index_compare_func_array,
+                                 size_t index_count)
+{
+  host_db_storage_t *storage = NULL;
+  dbstatus_t status;
+
+  if (storage_name == NULL || strlen(storage_name) >= HOST_DB_NAME_SIZE ||
+      index_count > HOST_DB_MAX_INDEXES || (index_count != 0U && index_compare_func_array == NULL))
+  {
+    return DB_EINVAL;
+  }
+
+  host_db_lock();
+  status = host_db_new_storage(storage_name, &storage);
+  if (DB_SUCCESS(status))
+  {
+    memcpy(storage->compare, index_compare_func_array, index_count * sizeof(*index_compare_func_array));
+    storage->index_count = index_count;
+    storage->open = 1;
+  }
+  host_db_unlock();
+  (void)config;
+  return status;
+}
+
+dbstatus_t db_close_storage(const char *name)
+{
+  dbstatus_t status = DB_NOERROR;
+  host_db_storage_t *storage;
+  uint32_t i;
+  size_t n;
+  size_t e;
+
+  host_db_lock();
+  for (i = 0; i < HOST_DB_MAX_STORAGES; i++)
+  {
+    storage = &host_db_storages[i];
+    if (!storage->open || (name != NULL && strcmp(storage->name, name) != 0))
+    {
+      continue;
+    }
+    if (storage->connections != 0U)
+    {
+      status = DB_ELOCKED;
+      continue;
+    }
+    for (n = 0; n < storage->index_count; n++)
+    {
+      for (e = 0; e < storage->index[n].count; e++)
+      {
+        free(storage->index[n].entries[e]);
+      }
+      free(storage->index[n].entries);
+    }
+    for (n = 0; n < storage->series_count; n++)
+    {
+      free(storage->series[n].usec);
+      free(storage->series[n].value);
+    }
+    memset(storage, 0, sizeof(*storage));
+  }
+  host_db_unlock();
+  return status;
+}
+
+dbstatus_t db_connect(db_t *handle, const char *name, const char *user_name, const char *password, void *context)
+{
+  host_db_storage_t *storage;
+  db_t db = NULL;
+
+  (void)user_name;
+  (void)password;
+  (void)context;
+
+  if (handle == NULL || name == NULL)
+  {
+    return DB_EINVAL;
+  }
+
+  host_db_lock();
+  storage = host_db_find_storage(name);
+  if (storage != NULL)
+  {
+    db = calloc(1U, sizeof(*db));
+    if (db != NULL)
+    {
+      db->storage = storage;
+      storage->connections++;
+    }
+  }
+  host_db_unlock();
+
+  *handle = db;
+  return (storage == NULL) ? DB_ENOTFOUND : (db == NULL) ? DB_ENOMEM : DB_NOERROR;
+}
+
+dbstatus_t db_disconnect(db_t handle)
+{
+  if (handle == NULL)
+  {
+    return DB_EINVAL;
+  }
+  host_db_lock();
+  handle->storage->connections--;
+  host_db_unlock();
+  free(handle);
+  return DB_NOERROR;
+}
+
+dbstatus_t db_open_index(db_index_t *handle, db_t db, int index_id, db_index_buffer_t *buffer)
+{
+  db_index_t index;
+  int valid;
+
+  (void)buffer;
+
+  if (handle == NULL || db == NULL || index_id < 0)
+  {
+    return DB_EINVAL;
+  }
+  host_db_lock();
+  valid = (size_t)index_id < db->storage->index_count;
+  host_db_unlock();
+  if (!valid)
+  {
+    return DB_ENOTFOUND;
+  }
+  index = calloc(1U, sizeof(*index));
+  if (index == NULL)
+  {
+    return DB_ENOMEM;
+  }
+  index->storage = db->storage;
+  index->index_id = index_id;
+  *handle = index;
+  return DB_NOERROR;
+}
+
+dbstatus_t db_close_index(db_index_t handle)
+{
+  if (handle == NULL)
+  {
+    return DB_EINVAL;
+  }
+  free(handle->row);
+  free(handle);
+  return DB_NOERROR;
+}
+
+/* key_size is not used: the compare function reads the key fields */
+dbstatus_t db_index_get(db_index_t handle, const void *key, size_t key_size, size_t key_fields,
+                        const void **data, size_t *data_size)
+{
+  dbstatus_t status = DB_NOERROR;
+  host_db_index_t *index;
+  host_db_entry_t *entry;
+  size_t at;
+
+  (void)key_size;
+
+  if (handle == NULL || key == NULL || data == NULL || data_size == NULL)
+  {
+    return DB_EINVAL;
+  }
+
+  host_db_lock();
+  index = &handle->storage->index[handle->index_id];
+  at = host_db_lower_bound(handle->storage, handle->index_id, key, key_fields);
+  if (at == index->count)
+  {
+    status = DB_ENOTFOUND;
+  }
+  else
+  {
+    entry = index->entries[at];
+    if (entry->size > handle->row_capacity)
+    {
+      uint8_t *row = realloc(handle->row, entry->size);
+
+      if (row == NULL)
+      {
+        status = DB_ENOMEM;
+      }
+      else
+      {
+        handle->row = row;
+        handle->row_capacity = entry->size;
+      }
+    }
+    if (DB_SUCCESS(status))
+    {
+      memcpy(handle->row, entry->data, entry->size);
+      *data = handle->row;
+      *data_size = entry->size;
+    }
+  }
+  host_db_unlock();
+  return status;
+}
+
+/* The entry with the whole key of data */
+dbstatus_t db_index_remove(db_index_t handle, const void *data, size_t key_size, db_index_buffer_t *removed_value)
+{
+  dbstatus_t status = DB_NOERROR;
+  host_db_storage_t *storage;
+  host_db_index_t *index;
+  host_db_entry_t *entry;
+  size_t at;
+
+  (void)key_size;
+
+  if (handle == NULL || data == NULL)
+  {
+    return DB_EINVAL;
+  }
+
+  host_db_lock();
+  storage = handle->storage;
+  index = &storage->index[handle->index_id];
+  at = host_db_lower_bound(storage, handle->index_id, data, HOST_DB_WHOLE_KEY);
+  if (at == index->count ||
+      storage->compare[handle->index_id](data, index->entries[at]->data, HOST_DB_WHOLE_KEY, 0U) != BTREE_KEY_EQ)
+  {
+    status = DB_ENOTFOUND;
+  }
+  else
+  {
+    entry = index->entries[at];
+    if (removed_value != NULL && removed_value->row_data != NULL)
+    {
+      memcpy(removed_value->row_data, entry->data,
+             (entry->size < removed_value->buffer_size) ? entry->size : removed_value->buffer_size);
+      removed_value->data_size = entry->size;
+    }
+    free(entry);
+    memmove(&index->entries[at], &index->entries[at + 1U], (index->count - at - 1U) * sizeof(*index->entries));
+    index->count--;
+  }
+  host_db_unlock();
+  return status;
+}
+
+/* Exported functions: IoT storage -------------------------------------------*/
+
+/* A storage of time series only; flags, the page cache and auth_info are
+   not used, and it starts empty */
+dbstatus_t db_open_iot_file_storage(const char *file_name, const char *alias, uint32_t flags, int32_t page_size,
+                                    void *storage_cache_segment, size_t storage_cache_size,
+                                    db_auth_info_t *auth_info)
+{
+  const char *name = (alias != NULL) ? alias : file_name;
+  host_db_storage_t *storage = NULL;
+  dbstatus_t status;
+
+  (void)flags;
+  (void)storage_cache_segment;
+  (void)storage_cache_size;
+  (void)auth_info;
+
+  if (name == NULL || strlen(name) >= HOST_DB_NAME_SIZE || page_size <= 0)
+  {
+    return DB_EINVAL;
+  }
+
+  host_db_lock();
+  status = host_db_new_storage(name, &storage);
+  if (DB_SUCCESS(status))
+  {
+    storage->iot = 1;
+    storage->page_size = page_size;
+    storage->file_bytes = page_size;
+    storage->open = 1;
+  }
+  host_db_unlock();
+  return status;
+}
+
+/* Series data at HOST_DB_POINT_BYTES a point; the pages of an index
+   storage are not counted */
+dbstatus_t db_file_info(db_t handle, db_file_info_t *info)
+{
+  host_db_storage_t *storage;
+
+  if (handle == NULL || info == NULL)
+  {
+    return DB_EINVAL;
+  }
+  memset(info, 0, sizeof(*info));
+  host_db_lock();
+  storage = handle->storage;
+  if (storage->iot)
+  {
+    info->time_series_data_bytes = host_db_series_bytes(storage);
+    info->used_data_bytes = host_db_series_used_bytes(storage) + storage->page_size;
+    info->data_file_bytes = storage->file_bytes;
+  }
+  host_db_unlock();
+  return DB_NOERROR;
+}
+
+dbstatus_t db_set_time_series_data_retention(db_t handle, int64_t retain_data_bytes, int64_t max_data_bytes)
+{
+  dbstatus_t status = DB_NOERROR;
+  host_db_storage_t *storage;
+
+  if (handle == NULL || retain_data_bytes < 0)
+  {
+    return DB_EINVAL;
+  }
+  host_db_lock();
+  storage = handle->storage;
+  if (!storage->iot || max_data_bytes < retain_data_bytes + storage->page_size)
+  {
+    status = DB_EINVAL;
+  }
+  else
+  {
+    storage->retain_bytes = retain_data_bytes;
+    storage->max_bytes = max_data_bytes;
+    host_db_series_retain(storage);
+  }
+  host_db_unlock();
+  return status;
+}
+
+/* Created on first open; FLOAT32 only */
+dbstatus_t db_open_time_series(db_time_series_t *series_handle, db_t db_handle, const db_ansi_t *name,
+                               db_coltype_t type)
+{
+  dbstatus_t status = DB_NOERROR;
+  host_db_storage_t *storage;
+  db_time_series_t series;
+  size_t n;
+
+  if (series_handle == NULL || db_handle == NULL || name == NULL)
+  {
+    return DB_EINVAL;
+  }
+  if (strlen((const char *)name) == 0U || strlen((const char *)name) >= HOST_DB_NAME_SIZE)
+  {
+    return DB_ENAME;
+  }
+  if (type != DB_COLTYPE_FLOAT32)
+  {
+    return DB_EFIELDTYPE;
+  }
+  series = calloc(1U, sizeof(*series));
+  if (series == NULL)
+  {
+    return DB_ENOMEM;
+  }
+
+  host_db_lock();
+  storage = db_handle->storage;
+  n = host_db_find_series(storage, (const char *)name);
+  if (!storage->iot)
+  {
+    status = DB_EINVAL;
+  }
+  else if (n == storage->series_count)
+  {
+    if (n == HOST_DB_MAX_SERIES)
+    {
+      status = DB_ENOMEM;
+    }
+    else
+    {
+      strcpy(storage->series[n].name, (const char *)name);
+      storage->series_count++;
+    }
+  }
+  host_db_unlock();
+
+  if (DB_FAILED(status))
+  {
+    free(series);
+    series = NULL;
+  }
+  else
+  {
+    series->storage = storage;
+    series->series = n;
+  }
+  *series_handle = series;
+  return status;
+}
+
+dbstatus_t db_close_time_series(db_time_series_t handle)
+{
+  if (handle == NULL)
+  {
+    return DB_EINVAL;
+  }
+  free(handle);
+  return DB_NOERROR;
+}
+
+dbstatus_t db_time_series_put_float32(db_time_series_t handle, db_timestamp_usec_t usec, float32_t value)
+{
+  dbstatus_t status;
+
+  if (handle == NULL)
+  {
+    return DB_EINVAL;
+  }
+  host_db_lock();
+  status = host_db_series_put(&handle->storage->series[handle->series], usec, value);
+  if (DB_SUCCESS(status))
+  {
+    host_db_series_retain(handle->storage);
+  }
+  host_db_unlock();
+  return status;
+}
+
+dbstatus_t db_time_series_remove_before(db_t handle, db_timestamp_usec_t usec)
+{
+  dbstatus_t status;
+
+  if (handle == NULL)
+  {
+    return DB_EINVAL;
+  }
+  host_db_lock();
+  status = handle->storage->iot ? (dbstatus_t)host_db_series_remove_before(handle->storage, usec) : DB_EINVAL;
+  host_db_unlock();
+  return status;
+}
+
+/* Oldest to newest only. Every name must be a series of the storage. */
+dbstatus_t db_prepare_time_series_query(db_time_series_query_t *handle, db_t db, const char *series_name_list[],
+                                        db_len_t series_count, db_timestamp_usec_t *begin_time,
+                                        db_timestamp_usec_t *end_time, db_flags_t flags)
+{
+  dbstatus_t status = DB_NOERROR;
+  host_db_storage_t *storage;
+  db_time_series_query_t query;
+  db_len_t i;
+  size_t n;
+
+  if (handle == NULL || db == NULL || flags != DB_QUERY_OLDEST_TO_NEWEST ||
+      (series_name_list != NULL && (series_count < 0 || series_count > (db_len_t)HOST_DB_MAX_SERIES)))
+  {
+    return DB_EINVAL;
+  }
+  query = calloc(1U, sizeof(*query));
+  if (query == NULL)
+  {
+    return DB_ENOMEM;
+  }
+
+  host_db_lock();
+  storage = db->storage;
+  query->storage = storage;
+  query->next = (begin_time != NULL) ? *begin_time : INT64_MIN;
+  query->end = (end_time != NULL) ? *end_time : INT64_MAX;
+  if (!storage->iot)
+  {
+    status = DB_EINVAL;
+  }
+  else if (series_name_list == NULL)
+  {
+    for (n = 0; n < storage->series_count; n++)
+    {
+      query->series[query->count++] = n;
+    }
+  }
+  for (i = 0; series_name_list != NULL && i < series_count && DB_SUCCESS(status); i++)
+  {
+    n = host_db_find_series(storage, series_name_list[i]);
+    if (n == storage->series_count)
+    {
+      status = DB_ENOTFOUND;
+    }
+    query->series[query->count++] = n;
+  }
+  host_db_unlock();
+
+  if (DB_FAILED(status))
+  {
+    free(query);
+    query = NULL;
+  }
+  *handle = query;
+  return DB_SUCCESS(status) ? (dbstatus_t)query->count : status;
+}
+
+dbstatus_t db_close_time_series_query(db_time_series_query_t handle)
+{
+  if (handle == NULL)
+  {
+    return DB_EINVAL;
+  }
+  free(handle);
+  return DB_NOERROR;
+}
+
+const char *db_get_time_series_name(db_time_series_query_t handle, db_fieldno_t fieldno)
+{
+  if (handle == NULL || fieldno < 0 || fieldno >= handle->count)
+  {
+    return NULL;
+  }
+  return handle->storage->series[handle->series[fieldno]].name;
+}
+
+dbstatus_t db_fetch_next_timestamp_float32(db_time_series_query_t handle, db_timestamp_usec_t *timestamp,
+                                           db_fieldno_t fieldno_list[], float32_t value_list[],
+                                           db_len_t list_size)
+{
+  host_db_series_t *series;
+  db_len_t values = 0;
+  db_len_t field;
+  size_t at;
+
+  if (handle == NULL || timestamp == NULL || fieldno_list == NULL || value_list == NULL || list_size <= 0)
+  {
+    return DB_EINVAL;
+  }
+
+  host_db_lock();
+  if (handle->field == 0 &&
+      !host_db_series_next(handle->storage, handle->series, (size_t)handle->count, handle->next, handle->end,
+                           &handle->at, NULL))
+  {
+    host_db_unlock();
+    return 0;
+  }
+  for (field = handle->field; field < handle->count; field++)
+  {
+    series = &handle->storage->series[handle->series[field]];
+    at = host_db_series_lower_bound(series, handle->at);
+    if (at < series->count && series->usec[at] == handle->at)
+    {
+      if (values == list_size)
+      {
+        break;
+      }
+      fieldno_list[values] = (db_fieldno_t)field;
+      value_list[values] = series->value[at];
+      values++;
+    }
+  }
+  /* The rest of this timestamp on the next call */
+  handle->field = (field < handle->count) ? field : 0;
+  if (handle->field == 0)
+  {
+    handle->next = handle->at + 1;
+  }
+  *timestamp = handle->at;
+  host_db_unlock();
+  return (dbstatus_t)values;
+}
+
+/* Exported functions: host inspection ---------------------------------------*/
+
+uint32_t host_ittia_db_stream_rows(db_stream_environment_t stream_env, const char *name)
+{
+  struct db_stream_node_s *view;
+  uint32_t rows = 0U;
+
+  if (stream_env == NULL || name == NULL)
+  {
+    return 0U;
+  }
+  host_db_lock();
+  for (view = stream_env->views; view != NULL; view = view->env_next)
+  {
+    if (strcmp(view->name, name) == 0)
+    {
+      rows = view->rows;
+      break;
+    }
+  }
+  host_db_unlock();
+  return rows;
+}
+
+int32_t host_ittia_db_index_rows(db_t database, int index_id)
+{
+  int32_t rows = -1;
+
+  if (database == NULL || index_id < 0)
+  {
+    return -1;
+  }
+  host_db_lock();
+  if ((size_t)index_id < database->storage->index_count)
+  {
+    rows = (int32_t)database->storage->index[index_id].count;
+  }
+  host_db_unlock();
+  return rows;
+}
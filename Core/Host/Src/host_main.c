@@ -0,0 +1,505 @@
+/**
+  ******************************************************************************
+  * @file    host_main.c
+  * @brief   Entry point of the METEO firmware on a Linux host.
+  *
+  *          The firmware main.c is compiled unchanged with
+  *          -Dmain=meteo_firmware_main and runs on the Linux ThreadX port
+  *          (Middlewares/ST/threadx/ports/linux/gnu).
+  *
+  *          NetX Duo has no host port and ITTIA DB Lite is only shipped for
+  *          Cortex-M33, so the ThreadX start-up is weak here: the firmware
+  *          versions (app_threadx.c, app_azure_rtos.c, app_ittia.cpp)
+  *          replace it when they are linked. The fallback application keeps
+  *          the frame path of the target:
+  *            USART3 RX ISR -> meteo_rx_queue -> METEO thread
+  *                          -> meteo_frame_queue -> DB thread
+  *          and runs the console / simulator in a thread of its own. The DB
+  *          thread stores the readings as on the target, through
+  *          meteo_example.c and meteo_streams.c, into the meteo_readings4
+  *          stream of the in-memory ITTIA stand-in (host_ittia_db.c).
+  *
+  *          When USART3 input ends the frame path is summarised: frames
+  *          stored, ThreadX thread dispatches per frame and the rows in the
+  *          meteo_readings4 stream. With -x the
+  *          program then exits, so a run over a frames file is a
+  *          repeatable measurement of the context switch cost per frame.
+  *
+  *          The simulator load generator (-g) gives the same summary for a
+  *          deterministic multi-station stream at a fixed frame rate, fed
+  *          as USART3 bytes or, with -r, straight to the DB queue. -f runs
+  *          the fault injection profiles one after the other instead.
+  *
+  *          Stored frames also go to the frame journal and the compressed
+  *          archive, on an emulated OSPI region (host_ospi.c) that -j keeps
+  *          in a file between runs. With -e the whole archive is exported
+  *          to a file at the end of a -g or -f run, through the same
+  *          streaming export as the COM1 and TCP sinks, and timed: CSV, or
+  *          JSON / MCOL for a .json / .mcol file.
+  *
+  *          Usage: meteo_host [-u sensor_file] [-l line_ticks] [-s speedup]
+  *                            [-g rate_hz [-n frames] [-c stations] [-r]] [-f]
+  *                            [-j journal_file] [-e export_file] [-x]
+  ******************************************************************************
+  */
+
+/* Includes ------------------------------------------------------------------*/
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <unistd.h>
+
+#include "main.h"
+#include "app_threadx.h"
+#include "app_ittia.h"
+#include "meteo_thread.h"
+#include "meteo_example.h"
+#include "meteo_simulator.h"
+#include "meteo_thread_stats.h"
+#include "meteo_trace.h"
+#include "meteo_console.h"
+#include "meteo_journal.h"
+#include "meteo_archive_store.h"
+#include "meteo_export.h"
+#include "meteo_window.h"
+#include "meteo_stats.h"
+#include "meteo_filter.h"
+#include "meteo_compress.h"
+#include "meteo_retention.h"
+#include "meteo_series.h"
+#include "lx_stm32_ospi_driver.h"
+#include "host_ittia_db.h"
+#include "tx_api.h"
+#include "tx_thread.h"
+
+/* Private defines -----------------------------------------------------------*/
+/* Host wake-up period while the frame path drains, in microseconds */
+#define HOST_DRAIN_POLL_US          1000U
+
+/* Private variables ---------------------------------------------------------*/
+static TX_THREAD host_db_thread;
+static UCHAR host_db_thread_stack[2048];
+static TX_THREAD host_simulator_thread;
+static UCHAR host_simulator_thread_stack[2048];
+static TX_THREAD host_retention_thread;
+static UCHAR host_retention_thread_stack[2048];
+
+static int host_exit_when_done;
+static meteo_sim_load_config_t host_load =
+{
+  0U, METEO_SIM_LOAD_STATIONS, METEO_SIM_DEFAULT_SEED, 0U, METEO_SIM_INJECT_UART,
+  METEO_SIM_FAULT_NONE, NULL
+};
+static int host_stress;
+static uint32_t host_checks_failed;
+static const char *host_export_file;
+static volatile ULONG host_frames_stored;
+static ULONG host_mark_frames;
+static ULONG host_mark_dispatches;
+static ULONG host_mark_rejected;
+
+/* Private function prototypes -----------------------------------------------*/
+int meteo_firmware_main(void);
+static void host_db_thread_entry(ULONG thread_input);
+static void host_usage(const char *prog);
+static ULONG host_thread_dispatches(void);
+static void host_frame_path_report(void (*wait_tick)(void));
+static void host_wait_tick(void);
+static void host_thread_wait_tick(void);
+static void host_load_done(const meteo_sim_load_report_t *report);
+static int host_export_sink(void *context, const char *data, uint32_t length);
+static void host_export(void);
+void host_uart3_input_begin(void);
+void host_uart3_input_end(void);
+ULONG host_time_get(void);
+
+int main(int argc, char **argv)
+{
+  int opt;
+
+  while ((opt = getopt(argc, argv, "u:l:s:g:n:c:rfj:e:xh")) != -1)
+  {
+    switch (opt)
+    {
+      case 'u':
+        setenv("METEO_HOST_UART3", optarg, 1);
+        break;
+      case 'l':
+        setenv("METEO_HOST_UART3_LINE_TICKS", optarg, 1);
+        break;
+      case 's':
+        setenv(TX_LINUX_SPEEDUP_ENV, optarg, 1);
+        break;
+      case 'g':
+        host_load.rate_hz = (uint32_t)strtoul(optarg, NULL, 0);
+        break;
+      case 'n':
+        host_load.frames = (uint32_t)strtoul(optarg, NULL, 0);
+        break;
+      case 'c':
+        host_load.stations = (uint8_t)strtoul(optarg, NULL, 0);
+        break;
+      case 'r':
+        host_load.inject = METEO_SIM_INJECT_DB;
+        break;
+      case 'f':
+        host_stress = 1;
+        break;
+      case 'j':
+        setenv(LX_STM32_OSPI_HOST_FILE_ENV, optarg, 1);
+        break;
+      case 'e':
+        host_export_file = optarg;
+        break;
+      case 'x':
+        host_exit_when_done = 1;
+        break;
+      default:
+        host_usage(argv[0]);
+        return (opt == 'h') ? EXIT_SUCCESS : EXIT_FAILURE;
+    }
+  }
+
+  return meteo_firmware_main();
+}
+
+static void host_usage(const char *prog)
+{
+  printf("Usage: %s [-u sensor_file] [-l line_ticks] [-s speedup]\n"
+         "          [-g rate_hz [-n frames] [-c stations] [-r]] [-f]\n"
+         "          [-j journal_file] [-x]\n"
+         "  -u  file or FIFO fed to USART3 (METEO sensor frames)\n"
+         "  -l  ThreadX ticks between lines, 0 = unpaced (default %u)\n"
+         "  -s  run the ThreadX clock this many times faster (1..100000)\n"
+         "  -g  start a simulator load run at this many frames/s (1..%u)\n"
+         "  -n  frames in the load run (default: until 'L')\n"
+         "  -c  stations in the load run (1..%u, default %u)\n"
+         "  -r  load run feeds the DB queue instead of USART3 bytes\n"
+         "  -f  fault injection stress run: every profile, -n frames each (default %u)\n"
+         "  -j  keep the OSPI journal and archive in this file (default: memory)\n"
+         "  -e  after a -g or -f run, export the archive to this file (.json, .mcol: not CSV)\n"
+         "  -x  exit once the USART3 input or the load run has been processed\n",
+         prog, (unsigned)TX_TIMER_TICKS_PER_SECOND, (unsigned)METEO_SIM_RATE_MAX_HZ,
+         (unsigned)METEO_SIM_MAX_STATIONS, (unsigned)METEO_SIM_LOAD_STATIONS,
+         (unsigned)METEO_SIM_STRESS_FRAMES);
+}
+
+/* Frame path measurement ----------------------------------------------------*/
+
+/* Dispatches of all created threads so far (the idle loop is not a thread).
+   Read without locking from the feeder pthread: the thread list is complete
+   before USART3 is armed and the counters are single words. */
+static ULONG host_thread_dispatches(void)
+{
+  TX_THREAD *thread_ptr;
+  ULONG count;
+  ULONG dispatches = 0U;
+
+  thread_ptr = _tx_thread_created_ptr;
+  for (count = _tx_thread_created_count; count != 0U; count--)
+  {
+    dispatches += thread_ptr->tx_thread_run_count;
+    thread_ptr = thread_ptr->tx_thread_created_next;
+  }
+
+  return dispatches;
+}
+
+/* Called by the USART3 feeder before the first byte */
+void host_uart3_input_begin(void)
+{
+  host_mark_frames = host_frames_stored;
+  host_mark_dispatches = host_thread_dispatches();
+  host_mark_rejected = Meteo_Frame_Db_Rejected();
+}
+
+/* Called by the USART3 feeder after the last byte */
+void host_uart3_input_end(void)
+{
+  host_frame_path_report(host_wait_tick);
+}
+
+/* End of a -g load run, in the simulator thread */
+static void host_load_done(const meteo_sim_load_report_t *report)
+{
+  /* -x exits with a failure when the counts of the run do not add up */
+  host_checks_failed = report->checks_failed;
+  host_frame_path_report(host_thread_wait_tick);
+}
+
+/* Wait for the next tick from a pthread: the feeder is not a ThreadX thread */
+static void host_wait_tick(void)
+{
+  ULONG now = host_time_get();
+
+  while (host_time_get() == now)
+  {
+    usleep(HOST_DRAIN_POLL_US);
+  }
+}
+
+/* Wait for the next tick from a ThreadX thread: the others run meanwhile */
+static void host_thread_wait_tick(void)
+{
+  tx_thread_sleep(1);
+}
+
+/* Frames stored and dispatches since the mark, then exit with -x */
+static void host_frame_path_report(void (*wait_tick)(void))
+{
+  ULONG frames;
+  ULONG dispatches;
+  ULONG stable = 0U;
+  ULONG last = host_frames_stored + Meteo_Frame_Db_Rejected();
+
+  /* Let the queues drain: no new frame stored or dropped for 10 ticks */
+  while (stable < 10U)
+  {
+    wait_tick();
+    stable = (host_frames_stored + Meteo_Frame_Db_Rejected() == last) ? stable + 1U : 0U;
+    last = host_frames_stored + Meteo_Frame_Db_Rejected();
+  }
+
+  frames = host_frames_stored - host_mark_frames;
+  dispatches = host_thread_dispatches() - host_mark_dispatches;
+  printf("[HOST] %lu frames stored, %lu thread dispatches (%lu.%02lu per frame)\r\n",
+         (unsigned long)frames, (unsigned long)dispatches,
+         (unsigned long)(frames ? dispatches / frames : 0U),
+         (unsigned long)(frames ? (dispatches * 100U / frames) % 100U : 0U));
+  printf("[HOST] %lu frames dropped by the DB thread (fields do not decode)\r\n",
+         (unsigned long)(Meteo_Frame_Db_Rejected() - host_mark_rejected));
+  printf("[HOST] %lu rows in the meteo_readings4 stream\r\n",
+         (unsigned long)host_ittia_db_stream_rows(meteo_stream_env, "meteo_readings4"));
+
+  /* Exported from a ThreadX thread only: the USART3 feeder is a pthread */
+  if (host_export_file != NULL && wait_tick == host_thread_wait_tick)
+  {
+    host_export();
+  }
+
+  if (host_exit_when_done)
+  {
+    /* Console output still queued for the COM1 TX DMA */
+    while (meteo_console_pending() != 0U)
+    {
+      wait_tick();
+    }
+    exit((host_checks_failed == 0U) ? EXIT_SUCCESS : EXIT_FAILURE);
+  }
+}
+
+/* Archive export (-e) -------------------------------------------------------*/
+
+static int host_export_sink(void *context, const char *data, uint32_t length)
+{
+  return (fwrite(data, 1, length, (FILE *)context) == length) ? 0 : -1;
+}
+
+/* Seal the open chunk, then the whole archive to host_export_file */
+static void host_export(void)
+{
+  meteo_archive_query_t query = { 0, INT64_MAX, METEO_ARCHIVE_CHANNELS, 0.0f, 0.0f };
+  meteo_export_format_t format = METEO_EXPORT_CSV;
+  const char *extension = strrchr(host_export_file, '.');
+  meteo_export_stats_t stats;
+  struct timespec start;
+  struct timespec end;
+  double seconds;
+  FILE *out;
+  UINT status;
+
+  (void)meteo_archive_store_flush();
+
+  if (extension != NULL && strcmp(extension, ".json") == 0)
+  {
+    format = METEO_EXPORT_JSON;
+  }
+  else if (extension != NULL && strcmp(extension, ".mcol") == 0)
+  {
+    format = METEO_EXPORT_COLUMNS;
+  }
+
+  out = fopen(host_export_file, "wb");
+  if (out == NULL)
+  {
+    printf("[HOST] Cannot create %s\r\n", host_export_file);
+    return;
+  }
+
+  clock_gettime(CLOCK_MONOTONIC, &start);
+  status = meteo_export_run(&query, format, host_export_sink, out, &stats);
+  clock_gettime(CLOCK_MONOTONIC, &end);
+  fclose(out);
+
+  seconds = (double)(end.tv_sec - start.tv_sec) + (double)(end.tv_nsec - start.tv_nsec) / 1e9;
+  printf("[HOST] Exported %lu rows, %lu bytes in %lu chunks to %s: %.3f s, %.0f rows/s (0x%02X)\r\n",
+         (unsigned long)stats.rows, (unsigned long)stats.bytes, (unsigned long)stats.chunks,
+         host_export_file, seconds, (seconds > 0.0) ? stats.rows / seconds : 0.0, status);
+}
+
+/* Fallbacks for firmware modules that cannot be built on the host -----------*/
+__attribute__((weak)) void MX_ThreadX_Init(void)
+{
+  tx_kernel_enter();
+}
+
+__attribute__((weak)) void MX_ITTIA_Init(void)
+{
+  printf("[HOST] ITTIA DB Lite stand-in: streams in memory\r\n");
+}
+
+__attribute__((weak)) void app_ittia_mem_profile_print(int csv)
+{
+  (void)csv;
+  printf("[HOST] ITTIA DB Lite not linked - no memory profile\r\n");
+}
+
+__attribute__((weak)) void tx_application_define(void *first_unused_memory)
+{
+  UINT status;
+
+  (void)first_unused_memory;
+
+  /* As in App_ThreadX_Init(), before the objects are created */
+  meteo_trace_init();
+  meteo_console_init();
+  meteo_ospi_init();
+  meteo_journal_init();
+  meteo_archive_store_init();
+  meteo_export_init();
+  meteo_window_init();
+  meteo_stats_init();
+  meteo_filter_init();
+  meteo_compress_init();
+  meteo_retention_init();
+  meteo_series_init();
+
+  /* tx_app_thread does this first on the target: no OSPI media here */
+  if (meteo_example_init(NULL, NULL) != EXIT_SUCCESS || run_meteo_example(NULL, NULL) != EXIT_SUCCESS)
+  {
+    printf("[HOST] METEO stream not created\r\n");
+    Error_Handler();
+  }
+
+  /* Same queue geometry as App_ThreadX_Init() */
+  status = tx_queue_create(&meteo_frame_queue, "METEO Frame Queue",
+                           RX_BUFFER_SIZE / sizeof(ULONG),
+                           meteo_queue_storage, METEO_QUEUE_STORAGE_SIZE);
+  if (status == TX_SUCCESS)
+  {
+    status = tx_queue_create(&meteo_rx_queue, "METEO RX Queue",
+                             RX_BUFFER_SIZE / sizeof(ULONG),
+                             meteo_rx_queue_storage, METEO_QUEUE_STORAGE_SIZE);
+  }
+  if (status == TX_SUCCESS)
+  {
+    status = tx_thread_create(&meteo_thread, "METEO Thread", Meteo_Thread_Entry, 0,
+                              meteo_thread_stack, sizeof(meteo_thread_stack),
+                              METEO_THREAD_PRIO, METEO_THREAD_PRIO,
+                              TX_NO_TIME_SLICE, TX_AUTO_START);
+  }
+  if (status == TX_SUCCESS)
+  {
+    status = tx_thread_create(&host_db_thread, "METEO DB Thread", host_db_thread_entry, 0,
+                              host_db_thread_stack, sizeof(host_db_thread_stack),
+                              METEO_DB_THREAD_PRIO, METEO_DB_THREAD_PRIO,
+                              TX_NO_TIME_SLICE, TX_AUTO_START);
+  }
+  if (status == TX_SUCCESS)
+  {
+    /* tx_app_thread runs this on the target once the services are up */
+    status = tx_thread_create(&host_simulator_thread, "METEO Simulator",
+                              meteo_simulator_thread_entry, 0,
+                              host_simulator_thread_stack, sizeof(host_simulator_thread_stack),
+                              METEO_SIMULATOR_THREAD_PRIO, METEO_SIMULATOR_THREAD_PRIO,
+                              TX_NO_TIME_SLICE, TX_AUTO_START);
+  }
+  if (status == TX_SUCCESS)
+  {
+    status = tx_thread_create(&host_retention_thread, "METEO Retention", meteo_retention_thread_entry, 0,
+                              host_retention_thread_stack, sizeof(host_retention_thread_stack),
+                              METEO_RETENTION_PRIORITY, METEO_RETENTION_PRIORITY,
+                              TX_NO_TIME_SLICE, TX_AUTO_START);
+  }
+  if (status != TX_SUCCESS)
+  {
+    printf("[HOST] Application define failed (0x%02X)\r\n", status);
+    Error_Handler();
+  }
+
+  meteo_simulator_init();
+  meteo_thread_stats_init();
+
+  if (host_stress)
+  {
+    host_uart3_input_begin();
+    status = meteo_simulator_stress_start((host_load.rate_hz != 0U) ? host_load.rate_hz : METEO_SIM_STRESS_RATE_HZ,
+                                          (host_load.frames != 0U) ? host_load.frames : METEO_SIM_STRESS_FRAMES,
+                                          host_load_done);
+    if (status != TX_SUCCESS)
+    {
+      printf("[HOST] Stress run not started (0x%02X)\r\n", status);
+    }
+  }
+  else if (host_load.rate_hz != 0U)
+  {
+    host_load.done = host_load_done;
+    host_uart3_input_begin();
+    status = meteo_simulator_load_start(&host_load);
+    if (status != TX_SUCCESS)
+    {
+      printf("[HOST] Load run not started (0x%02X)\r\n", status);
+    }
+  }
+}
+
+/* Stand-in for meteo_db_thread_entry() in app_threadx.c */
+static void host_db_thread_entry(ULONG thread_input)
+{
+  char frame_buffer[RX_BUFFER_SIZE];
+  meteo_archive_sample_t sample;
+  meteo_archive_sample_t kept[2];
+  uint32_t rows;
+  uint32_t i;
+
+  (void)thread_input;
+
+  /* tx_app_thread opens it once the storage is up */
+  (void)meteo_journal_open();
+  (void)meteo_archive_store_open();
+#if METEO_SERIES_ENABLED
+  (void)meteo_series_open();
+#endif
+
+  while (1)
+  {
+    if (tx_queue_receive(&meteo_frame_queue, frame_buffer, TX_WAIT_FOREVER) == TX_SUCCESS)
+    {
+      if (meteo_archive_store_parse_frame(frame_buffer, &sample) == TX_SUCCESS)
+      {
+        (void)meteo_journal_append_frame(frame_buffer);
+        sample.ts_usec = meteo_archive_store_now();
+        (void)meteo_filter_apply(sample.value);
+        rows = meteo_compress_apply(&sample, kept);
+        for (i = 0; i < rows; i++)
+        {
+          ProcessMeteoSampleToStream(&kept[i]);
+        }
+#if METEO_SERIES_ENABLED
+        (void)meteo_series_add(&sample);
+#endif
+        (void)meteo_archive_store_add(&sample);
+        meteo_window_add(sample.value);
+        meteo_stats_add(&sample);
+      }
+      else
+      {
+        /* Checksum good but the fields do not decode: dropped */
+        Meteo_Frame_Db_Reject();
+        continue;
+      }
+      host_frames_stored++;
+    }
+  }
+}
@@ -0,0 +1,187 @@
+/**
+  ******************************************************************************
+  * @file    host_ospi.c
+  * @brief   Host (Linux) emulation of the OSPI NOR flash regions used by the
+  *          frame journal and the archive (meteo_ospi.h).
+  *
+  *          Only the top METEO_OSPI_RESERVED_BLOCKS blocks exist; an access
+  *          elsewhere fails. As on the MX25LM51245G an erase sets a block to
+  *          0xFF and a write ANDs the data into the flash, so a torn or
+  *          repeated write shows up as it would on the target.
+  *          With METEO_HOST_OSPI set the region is a file, mapped shared and
+  *          created erased, so the journal and archive survive a restart of the
+  *          program and a test can damage data in it; otherwise it is
+  *          anonymous memory, erased at start-up.
+  ******************************************************************************
+  */
+
+/* Includes ------------------------------------------------------------------*/
+#include <fcntl.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include "lx_stm32_ospi_driver.h"
+#include "meteo_ospi.h"
+
+/* Private defines -----------------------------------------------------------*/
+#define HOST_OSPI_BLOCKS        (LX_STM32_OSPI_FLASH_SIZE / LX_STM32_OSPI_SECTOR_SIZE)
+#define HOST_OSPI_REGION_SIZE   (METEO_OSPI_RESERVED_BLOCKS * LX_STM32_OSPI_SECTOR_SIZE)
+#define HOST_OSPI_REGION_BASE   (LX_STM32_OSPI_FLASH_SIZE - HOST_OSPI_REGION_SIZE)
+
+/* Private variables ---------------------------------------------------------*/
+static uint8_t *host_ospi_region;
+
+/* Private functions ---------------------------------------------------------*/
+
+/* Map the region on first use */
+static uint8_t *host_ospi_map(void)
+{
+  const char *path;
+  struct stat st;
+  void *region;
+  int fd;
+
+  if (host_ospi_region != NULL)
+  {
+    return host_ospi_region;
+  }
+
+  path = getenv(LX_STM32_OSPI_HOST_FILE_ENV);
+  if (path == NULL || path[0] == '\0')
+  {
+    region = mmap(NULL, HOST_OSPI_REGION_SIZE, PROT_READ | PROT_WRITE,
+                  MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+    if (region == MAP_FAILED)
+    {
+      return NULL;
+    }
+    memset(region, 0xFF, HOST_OSPI_REGION_SIZE);
+    host_ospi_region = region;
+    return host_ospi_region;
+  }
+
+  fd = open(path, O_RDWR | O_CREAT, 0644);
+  if (fd < 0 || fstat(fd, &st) != 0)
+  {
+    perror(path);
+    if (fd >= 0)
+    {
+      close(fd);
+    }
+    return NULL;
+  }
+
+  /* New file: erased flash */
+  if (st.st_size != (off_t)HOST_OSPI_REGION_SIZE)
+  {
+    uint8_t erased[LX_STM32_OSPI_SECTOR_SIZE];
+    ULONG block;
+
+    memset(erased, 0xFF, sizeof(erased));
+    for (block = 0; block < METEO_OSPI_RESERVED_BLOCKS; block++)
+    {
+      if (pwrite(fd, erased, sizeof(erased), (off_t)(block * sizeof(erased))) != (ssize_t)sizeof(erased))
+      {
+        perror(path);
+        close(fd);
+        return NULL;
+      }
+    }
+  }
+
+  region = mmap(NULL, HOST_OSPI_REGION_SIZE, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+  close(fd);
+  if (region == MAP_FAILED)
+  {
+    perror(path);
+    return NULL;
+  }
+
+  host_ospi_region = region;
+  return host_ospi_region;
+}
+
+/* Region offset of a flash range, or -1 outside the region */
+static long host_ospi_offset(ULONG *address, ULONG bytes)
+{
+  uintptr_t flash = (uintptr_t)address;
+
+  if (host_ospi_map() == NULL ||
+      flash < HOST_OSPI_REGION_BASE || flash + bytes > LX_STM32_OSPI_FLASH_SIZE)
+  {
+    return -1;
+  }
+
+  return (long)(flash - HOST_OSPI_REGION_BASE);
+}
+
+/* Exported functions --------------------------------------------------------*/
+
+INT lx_stm32_ospi_get_status(UINT instance)
+{
+  (void)instance;
+  return 0;
+}
+
+INT lx_stm32_ospi_get_info(UINT instance, ULONG *block_size, ULONG *total_blocks)
+{
+  (void)instance;
+  *block_size = LX_STM32_OSPI_SECTOR_SIZE;
+  *total_blocks = HOST_OSPI_BLOCKS;
+  return 0;
+}
+
+INT lx_stm32_ospi_read(UINT instance, ULONG *address, ULONG *buffer, ULONG words)
+{
+  long offset = host_ospi_offset(address, words * sizeof(ULONG));
+
+  (void)instance;
+  if (offset < 0)
+  {
+    return 1;
+  }
+
+  memcpy(buffer, host_ospi_region + offset, words * sizeof(ULONG));
+  return 0;
+}
+
+INT lx_stm32_ospi_write(UINT instance, ULONG *address, ULONG *buffer, ULONG words)
+{
+  long offset = host_ospi_offset(address, words * sizeof(ULONG));
+  const uint8_t *data = (const uint8_t *)buffer;
+  ULONG i;
+
+  (void)instance;
+  if (offset < 0)
+  {
+    return 1;
+  }
+
+  /* Programming only clears bits */
+  for (i = 0; i < words * sizeof(ULONG); i++)
+  {
+    host_ospi_region[offset + i] &= data[i];
+  }
+  return 0;
+}
+
+INT lx_stm32_ospi_erase(UINT instance, ULONG block, ULONG erase_count, UINT full_chip_erase)
+{
+  long offset = host_ospi_offset((ULONG *)(uintptr_t)(block * LX_STM32_OSPI_SECTOR_SIZE),
+                                 LX_STM32_OSPI_SECTOR_SIZE);
+
+  (void)instance;
+  (void)erase_count;
+  if (offset < 0 || full_chip_erase != 0U)
+  {
+    return 1;
+  }
+
+  memset(host_ospi_region + offset, 0xFF, LX_STM32_OSPI_SECTOR_SIZE);
+  return 0;
+}
@@ -0,0 +1,295 @@
+/**
+  ******************************************************************************
+  * @file    meteo_archive_bench.c
+  * @brief   Compression ratio and cost of the archive codec (meteo_archive.c)
+  *          on the Linux port of ThreadX.
+  *
+  *          Two days of readings at 1 Hz, as the DB thread would add them
+  *          (frames decoded by meteo_archive_store_parse_frame()), for:
+  *          - a steady station: slow daily temperature and pressure, light
+  *            wind, fixed voltage, readings exactly 1 s apart;
+  *          - the same with 0-3 ms of jitter on the ms tick;
+  *          - the simulator's station (meteo_sim_station.c), whose wind
+  *            speed and voltage are white noise.
+  *          Each set is encoded in 15-minute chunks, then decoded back: the
+  *          timestamps and every value must come back exactly. It prints
+  *          the bytes per sample (each column and the whole segments), the
+  *          ratio against the 40-byte meteo_readings row and the 24-byte
+  *          sample, and the ns per sample to encode and to decode.
+  *
+  *          Build: TX=Middlewares/ST/threadx
+  *                 gcc -O2 -DTX_INCLUDE_USER_DEFINE_FILE -ICore/Host/Inc -ICore/Inc
+  *                     -I$TX/ports/linux/gnu/inc -I$TX/common/inc
+  *                     -I$TX/utility/execution_profile_kit -o meteo_archive_bench
+  *                     Core/Host/Tools/meteo_archive_bench.c Core/Src/meteo_archive.c
+  *                     Core/Src/meteo_archive_store.c Core/Src/meteo_ospi.c
+  *                     Core/Src/meteo_trace.c Core/Src/meteo_sim_station.c
+  *                     Core/Host/Src/host_ospi.c
+  *                     <the ThreadX sources of the meteo_host build line in
+  *                     README.md> -lpthread -lm
+  *          Usage: meteo_archive_bench [-d days]
+  ******************************************************************************
+  */
+
+/* Includes ------------------------------------------------------------------*/
+#include <math.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <unistd.h>
+
+#include "tx_api.h"
+#include "meteo_archive.h"
+#include "meteo_archive_store.h"
+#include "meteo_console.h"
+#include "meteo_simulator.h"
+
+/* Private defines -----------------------------------------------------------*/
+#define TEST_STACK_SIZE         16384U
+#define TEST_DAY_SAMPLES        86400U
+#define TEST_MAX_DAYS           8U
+#define TEST_MAX_SAMPLES        (TEST_MAX_DAYS * TEST_DAY_SAMPLES)
+#define TEST_ARCHIVE_BYTES      (TEST_MAX_SAMPLES * 16U)
+#define TEST_ROW_BYTES          40.0        /* meteo_readings row */
+#define TEST_SAMPLE_BYTES       24.0        /* ts_usec and 4 floats, packed */
+
+/* The README figures, with some margin */
+#define TEST_STEADY_MAX_BYTES   5.0
+#define TEST_SIM_MAX_BYTES      12.0
+
+#define CHECK(cond, ...) \
+  do { if (!(cond)) { if (test_failures++ < 20) { printf("  FAILED line %d: ", __LINE__); \
+       printf(__VA_ARGS__); printf("\n"); } } } while (0)
+
+/* Private variables ---------------------------------------------------------*/
+static TX_THREAD test_thread;
+static UCHAR test_stack[TEST_STACK_SIZE];
+
+static meteo_archive_encoder_t test_encoder;
+static meteo_archive_sample_t test_samples[TEST_MAX_SAMPLES];
+static uint8_t test_archive[TEST_ARCHIVE_BYTES];
+static uint32_t test_archive_bytes;
+static uint32_t test_column_bytes[METEO_ARCHIVE_COLUMNS];
+static uint32_t test_count;
+static uint32_t test_days = 2U;
+static uint32_t test_rng = 0x2545F491UL;
+
+static int test_failures;
+
+static const char *const test_column_names[METEO_ARCHIVE_COLUMNS] =
+{
+  "time", "temp", "pressure", "wind", "dir", "voltage"
+};
+
+/* Private functions ---------------------------------------------------------*/
+
+/* meteo_archive_store.c needs it; nothing here reads the clock */
+uint32_t HAL_GetTick(void)
+{
+  return 0U;
+}
+
+/* meteo_trace.c sets it around a dump; no console here */
+meteo_console_overflow_t meteo_console_set_overflow(meteo_console_overflow_t policy)
+{
+  return policy;
+}
+
+static double test_now(void)
+{
+  struct timespec now;
+
+  clock_gettime(CLOCK_MONOTONIC, &now);
+  return (double)now.tv_sec + (double)now.tv_nsec * 1e-9;
+}
+
+static uint32_t test_random(void)
+{
+  test_rng ^= test_rng << 13;
+  test_rng ^= test_rng >> 17;
+  test_rng ^= test_rng << 5;
+  return test_rng;
+}
+
+static void test_add_frame(const char *frame, int64_t ts_usec)
+{
+  meteo_archive_sample_t *sample = &test_samples[test_count];
+
+  CHECK(meteo_archive_store_parse_frame(frame, sample) == TX_SUCCESS, "frame %s", frame);
+  sample->ts_usec = ts_usec;
+  test_count++;
+}
+
+/* A day of slow weather: temperature and pressure follow the sun, the wind
+   changes over minutes, the supply does not move */
+static void test_steady(uint32_t jitter_ms)
+{
+  char frame[64];
+  double t;
+  uint32_t n;
+
+  test_count = 0U;
+  for (n = 0U; n < test_days * TEST_DAY_SAMPLES; n++)
+  {
+    t = (double)n;
+    snprintf(frame, sizeof(frame), "UUU$%05lu.%05lu.%04lu.%05lu.%03u.ABCD*QQQ",
+             (unsigned long)lround(2000.0 + 600.0 * sin(t * 2.0 * M_PI / 86400.0)),
+             (unsigned long)lround(10132.0 + 20.0 * sin(t * 2.0 * M_PI / 172800.0)),
+             (unsigned long)lround(1800.0 + 300.0 * sin(t * 2.0 * M_PI / 7200.0)),
+             (unsigned long)lround(40.0 + 20.0 * sin(t * 2.0 * M_PI / 600.0)), 115U);
+    test_add_frame(frame, (int64_t)n * 1000000 + (int64_t)((jitter_ms > 0U) ? test_random() % (jitter_ms + 1U) : 0U) * 1000);
+  }
+}
+
+static void test_simulator(void)
+{
+  meteo_sim_station_t station;
+  char frame[64];
+  uint32_t n;
+
+  test_count = 0U;
+  meteo_sim_station_init(&station, METEO_SIM_DEFAULT_SEED);
+  for (n = 0U; n < test_days * TEST_DAY_SAMPLES; n++)
+  {
+    meteo_sim_station_frame(&station, frame, sizeof(frame));
+    test_add_frame(frame, (int64_t)n * 1000000);
+  }
+}
+
+/* Segments one after the other, as meteo_archive_dump reads them */
+static int test_sink(void *context, const uint8_t *segment, uint32_t bytes)
+{
+  meteo_archive_header_t header;
+  uint32_t column;
+
+  (void)context;
+
+  if (test_archive_bytes + bytes > TEST_ARCHIVE_BYTES ||
+      meteo_archive_header_read(segment, bytes, &header) != METEO_ARCHIVE_OK)
+  {
+    return -1;
+  }
+  for (column = 0U; column < METEO_ARCHIVE_COLUMNS; column++)
+  {
+    test_column_bytes[column] += header.column_bytes[column];
+  }
+  memcpy(&test_archive[test_archive_bytes], segment, bytes);
+  test_archive_bytes += bytes;
+  return 0;
+}
+
+static void test_run(const char *name, double max_bytes)
+{
+  meteo_archive_decoder_t decoder;
+  meteo_archive_sample_t sample;
+  uint32_t offset = 0U;
+  uint32_t decoded = 0U;
+  uint32_t differ = 0U;
+  uint32_t segments = 0U;
+  uint32_t column;
+  uint32_t n;
+  double start;
+  double encode_ns;
+  double decode_ns;
+  double per_sample;
+
+  test_archive_bytes = 0U;
+  memset(test_column_bytes, 0, sizeof(test_column_bytes));
+  meteo_archive_encoder_init(&test_encoder, METEO_ARCHIVE_CHUNK_SECONDS, METEO_ARCHIVE_TS_SCALE_US, 0U,
+                             test_sink, NULL);
+  start = test_now();
+  for (n = 0U; n < test_count; n++)
+  {
+    meteo_archive_encoder_add(&test_encoder, &test_samples[n]);
+  }
+  meteo_archive_encoder_flush(&test_encoder);
+  encode_ns = (test_now() - start) / (double)test_count * 1e9;
+  CHECK(test_encoder.sink_errors == 0U, "%s: %lu segments not stored", name,
+        (unsigned long)test_encoder.sink_errors);
+
+  start = test_now();
+  while (offset < test_archive_bytes &&
+         meteo_archive_decoder_init(&decoder, &test_archive[offset], test_archive_bytes - offset) == METEO_ARCHIVE_OK)
+  {
+    segments++;
+    while (meteo_archive_decoder_next(&decoder, &sample) == METEO_ARCHIVE_OK)
+    {
+      if (decoded >= test_count || sample.ts_usec != test_samples[decoded].ts_usec ||
+          memcmp(sample.value, test_samples[decoded].value, sizeof(sample.value)) != 0)
+      {
+        differ++;
+      }
+      decoded++;
+    }
+    offset += decoder.header.bytes;
+  }
+  decode_ns = (test_now() - start) / (double)test_count * 1e9;
+  CHECK(offset == test_archive_bytes, "%s: decoding stopped at %lu of %lu bytes", name,
+        (unsigned long)offset, (unsigned long)test_archive_bytes);
+  CHECK(decoded == test_count && differ == 0U, "%s: %lu of %lu samples back, %lu differ", name,
+        (unsigned long)decoded, (unsigned long)test_count, (unsigned long)differ);
+
+  per_sample = (double)test_archive_bytes / (double)test_count;
+  printf("%s: %lu samples, %lu segments, %lu bytes\n", name, (unsigned long)test_count,
+         (unsigned long)segments, (unsigned long)test_archive_bytes);
+  printf("  bytes/sample:");
+  for (column = 0U; column < METEO_ARCHIVE_COLUMNS; column++)
+  {
+    printf(" %s %.2f", test_column_names[column], (double)test_column_bytes[column] / (double)test_count);
+  }
+  printf(", segments %.2f\n", per_sample);
+  printf("  %.1fx smaller than the row, %.1fx than the sample; encode %.0f ns, decode %.0f ns a sample\n",
+         TEST_ROW_BYTES / per_sample, TEST_SAMPLE_BYTES / per_sample, encode_ns, decode_ns);
+  CHECK(per_sample <= max_bytes, "%s: %.2f bytes/sample, expected at most %.1f", name, per_sample, max_bytes);
+}
+
+static void test_entry(ULONG input)
+{
+  (void)input;
+
+  test_steady(0U);
+  test_run("steady", TEST_STEADY_MAX_BYTES);
+  test_steady(3U);
+  test_run("steady, 0-3 ms jitter", TEST_SIM_MAX_BYTES);
+  test_simulator();
+  test_run("simulator", TEST_SIM_MAX_BYTES);
+
+  printf("%s (%d failures)\n", test_failures ? "FAILED" : "PASSED", test_failures);
+  exit(test_failures != 0);
+}
+
+void tx_application_define(void *first_unused_memory)
+{
+  (void)first_unused_memory;
+
+  tx_thread_create(&test_thread, "test", test_entry, 0U, test_stack, TEST_STACK_SIZE,
+                   5U, 5U, TX_NO_TIME_SLICE, TX_AUTO_START);
+}
+
+int main(int argc, char *argv[])
+{
+  int opt;
+
+  while ((opt = getopt(argc, argv, "d:")) != -1)
+  {
+    switch (opt)
+    {
+      case 'd':
+        test_days = (uint32_t)atol(optarg);
+        break;
+      default:
+        fprintf(stderr, "Usage: %s [-d days]\n", argv[0]);
+        return 2;
+    }
+  }
+  if (test_days < 1U || test_days > TEST_MAX_DAYS)
+  {
+    fprintf(stderr, "days 1..%u\n", TEST_MAX_DAYS);
+    return 2;
+  }
+
+  tx_kernel_enter();
+  return 0;
+}
@@ -0,0 +1,241 @@
+/**
+  ******************************************************************************
+  * @file    meteo_archive_dump.c
+  * @brief   Decode METEO archive segments (meteo_archive.h) to CSV.
+  *
+  *          Input is a dump of the archive region of the OSPI flash, the
+  *          meteo_host -j file, or segments saved back to back. Segments are
+  *          found by their magic on 4-byte boundaries, checked (header and
+  *          CRC) and printed in seq order, so the ring of flash blocks needs
+  *          no unwrapping. Damaged segments are counted and skipped.
+  *
+  *          Build: gcc -O2 -ICore/Inc -o meteo_archive_dump
+  *                     Core/Host/Tools/meteo_archive_dump.c Core/Src/meteo_archive.c
+  *          Usage: meteo_archive_dump [-s] image > readings.csv
+  *            -s  one line per segment (header and zone map) instead of
+  *                the samples
+  *          The totals and the compression against the 40-byte
+  *          meteo_readings row go to stderr.
+  ******************************************************************************
+  */
+
+/* Includes ------------------------------------------------------------------*/
+#include <inttypes.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+
+#include "meteo_archive.h"
+
+/* Private defines -----------------------------------------------------------*/
+
+/* Size of a meteo_readings row (meteo_streams.h) */
+#define DUMP_ROW_BYTES          40U
+
+/* Private types -------------------------------------------------------------*/
+typedef struct
+{
+  uint32_t seq;
+  size_t offset;
+} segment_t;
+
+/* Private functions ---------------------------------------------------------*/
+
+static uint8_t *read_file(FILE *in, size_t *size)
+{
+  uint8_t *buffer = NULL;
+  size_t length = 0;
+  size_t capacity = 0;
+  size_t n;
+
+  do
+  {
+    if (length == capacity)
+    {
+      uint8_t *grown;
+
+      capacity = capacity != 0U ? capacity * 2U : 65536U;
+      grown = realloc(buffer, capacity);
+      if (grown == NULL)
+      {
+        free(buffer);
+        return NULL;
+      }
+      buffer = grown;
+    }
+    n = fread(buffer + length, 1, capacity - length, in);
+    length += n;
+  } while (n != 0U);
+
+  *size = length;
+  return buffer;
+}
+
+static int compare_seq(const void *a, const void *b)
+{
+  const segment_t *x = a;
+  const segment_t *y = b;
+
+  return (x->seq > y->seq) - (x->seq < y->seq);
+}
+
+static void print_segment(const meteo_archive_header_t *h)
+{
+  uint32_t i;
+
+  printf("%" PRIu32 ",%" PRIu32 ",%" PRIu32 ",%.3f,%.3f", h->seq, h->samples, h->bytes,
+         h->ts_min_usec / 1e6, h->ts_max_usec / 1e6);
+  for (i = 0; i < METEO_ARCHIVE_CHANNELS; i++)
+  {
+    printf(",%g,%g", h->range[i].min, h->range[i].max);
+  }
+  printf("\n");
+}
+
+/* Main ----------------------------------------------------------------------*/
+
+int main(int argc, char **argv)
+{
+  static const char *channels = "temperature,pressure,wind_speed,wind_direction,voltage";
+  meteo_archive_decoder_t decoder;
+  meteo_archive_sample_t sample;
+  segment_t *segments = NULL;
+  size_t count = 0;
+  size_t capacity = 0;
+  size_t offset;
+  size_t size;
+  size_t i;
+  uint8_t *image;
+  uint64_t samples = 0;
+  uint64_t bytes = 0;
+  uint32_t bad = 0;
+  uint32_t gaps = 0;
+  int summary = 0;
+  int opt;
+  int status;
+  FILE *in;
+
+  while ((opt = getopt(argc, argv, "s")) != -1)
+  {
+    switch (opt)
+    {
+      case 's':
+        summary = 1;
+        break;
+      default:
+        fprintf(stderr, "Usage: %s [-s] image > readings.csv\n", argv[0]);
+        return 2;
+    }
+  }
+
+  in = optind < argc ? fopen(argv[optind], "rb") : stdin;
+  if (in == NULL)
+  {
+    perror(argv[optind]);
+    return 1;
+  }
+  image = read_file(in, &size);
+  if (in != stdin)
+  {
+    fclose(in);
+  }
+  if (image == NULL)
+  {
+    fprintf(stderr, "Out of memory\n");
+    return 1;
+  }
+
+  /* Find the segments */
+  for (offset = 0; offset + METEO_ARCHIVE_HEADER_SIZE <= size; )
+  {
+    status = meteo_archive_decoder_init(&decoder, image + offset, (uint32_t)(size - offset));
+    if (status != METEO_ARCHIVE_OK)
+    {
+      if (status == METEO_ARCHIVE_ERROR_CRC)
+      {
+        bad++;
+      }
+      offset += 4U;
+      continue;
+    }
+    if (count == capacity)
+    {
+      segment_t *grown;
+
+      capacity = capacity != 0U ? capacity * 2U : 256U;
+      grown = realloc(segments, capacity * sizeof(*segments));
+      if (grown == NULL)
+      {
+        fprintf(stderr, "Out of memory\n");
+        return 1;
+      }
+      segments = grown;
+    }
+    segments[count].seq = decoder.header.seq;
+    segments[count].offset = offset;
+    count++;
+    offset += decoder.header.bytes;
+  }
+  qsort(segments, count, sizeof(*segments), compare_seq);
+
+  if (summary)
+  {
+    printf("seq,samples,bytes,ts_min,ts_max");
+    printf(",temperature_min,temperature_max,pressure_min,pressure_max,wind_speed_min,wind_speed_max"
+           ",wind_direction_min,wind_direction_max,voltage_min,voltage_max\n");
+  }
+  else
+  {
+    printf("ts,%s\n", channels);
+  }
+
+  for (i = 0; i < count; i++)
+  {
+    (void)meteo_archive_decoder_init(&decoder, image + segments[i].offset,
+                                     (uint32_t)(size - segments[i].offset));
+    if (i > 0U && segments[i].seq != segments[i - 1U].seq + 1U)
+    {
+      gaps++;
+    }
+    if (summary)
+    {
+      print_segment(&decoder.header);
+    }
+    else
+    {
+      while ((status = meteo_archive_decoder_next(&decoder, &sample)) == METEO_ARCHIVE_OK)
+      {
+        printf("%.3f,%.2f,%.1f,%.1f,%.1f,%.0f\n", sample.ts_usec / 1e6,
+               sample.value[METEO_ARCHIVE_TEMPERATURE], sample.value[METEO_ARCHIVE_PRESSURE],
+               sample.value[METEO_ARCHIVE_WIND_SPEED], sample.value[METEO_ARCHIVE_WIND_DIRECTION],
+               sample.value[METEO_ARCHIVE_VOLTAGE]);
+      }
+      if (status != METEO_ARCHIVE_END)
+      {
+        fprintf(stderr, "Segment %" PRIu32 ": decode error after %" PRIu32 " samples\n",
+                segments[i].seq, decoder.index);
+        bad++;
+      }
+    }
+    samples += decoder.header.samples;
+    bytes += decoder.header.bytes;
+  }
+
+  fprintf(stderr, "%zu segments (seq %" PRIu32 "..%" PRIu32 ", %u gaps), %u bad, "
+          "%" PRIu64 " samples in %" PRIu64 " bytes",
+          count, count != 0U ? segments[0].seq : 0U, count != 0U ? segments[count - 1U].seq : 0U,
+          gaps, bad, samples, bytes);
+  if (samples != 0U)
+  {
+    fprintf(stderr, ": %.2f bytes/sample, %.1fx smaller than the %u-byte row",
+            (double)bytes / (double)samples, (double)(samples * DUMP_ROW_BYTES) / (double)bytes,
+            DUMP_ROW_BYTES);
+  }
+  fprintf(stderr, "\n");
+
+  free(segments);
+  free(image);
+  return 0;
+}
@@ -0,0 +1,355 @@
+/**
+  ******************************************************************************
+  * @file    meteo_archive_store_test.c
+  * @brief   Regression checks of the archive ring (meteo_archive_store.c)
+  *          on the emulated OSPI flash of the Linux host.
+  *
+  *          - Laps: a few readings, a flush and a restart (the store opened
+  *            again, the tick back to 0), many times over: the writer goes
+  *            round the ring more than twice with the default 30000. Each
+  *            open must find the same next and oldest seq as before it.
+  *          - The flash is then walked like meteo_archive_dump: every seq
+  *            from the oldest to the newest must be on it.
+  *          - Torn header: the end of the newest segment is overwritten as
+  *            a write cut short would leave it. The open must not lose a
+  *            seq, and the next segment goes to the next block.
+  *          - Torn body: a word inside the newest segment is cleared, so
+  *            its CRC fails. Opens and writes go on; only that segment is
+  *            missing from the flash walk.
+  *          - Tick wrap: readings across the wrap of the 32-bit ms tick
+  *            (49.7 days of uptime) read back in order, a second apart.
+  *
+  *          Build: TX=Middlewares/ST/threadx
+  *                 gcc -O2 -DTX_INCLUDE_USER_DEFINE_FILE -ICore/Host/Inc -ICore/Inc
+  *                     -I$TX/ports/linux/gnu/inc -I$TX/common/inc
+  *                     -I$TX/utility/execution_profile_kit -o meteo_archive_store_test
+  *                     Core/Host/Tools/meteo_archive_store_test.c Core/Src/meteo_archive.c
+  *                     Core/Src/meteo_archive_store.c Core/Src/meteo_ospi.c
+  *                     Core/Src/meteo_trace.c Core/Host/Src/host_ospi.c
+  *                     <the ThreadX sources of the meteo_host build line in
+  *                     README.md> -lpthread
+  *          Usage: meteo_archive_store_test [-l laps] [image]
+  *            -l     restarts (default 30000)
+  *            image  flash file, created again (default meteo_archive_store_test.bin)
+  ******************************************************************************
+  */
+
+/* Includes ------------------------------------------------------------------*/
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+
+#include "tx_api.h"
+#include "lx_stm32_ospi_driver.h"
+#include "meteo_archive.h"
+#include "meteo_archive_store.h"
+#include "meteo_console.h"
+#include "meteo_ospi.h"
+
+/* Private defines -----------------------------------------------------------*/
+#define TEST_STACK_SIZE         16384U
+#define TEST_BLOCK_SIZE         65536U
+#define TEST_ARCHIVE_BYTES      (METEO_ARCHIVE_STORE_BLOCKS * TEST_BLOCK_SIZE)
+#define TEST_SEQ_MAX            (1UL << 20)
+
+#define CHECK(cond, ...) \
+  do { if (!(cond)) { test_failures++; printf("  FAILED line %d: ", __LINE__); \
+       printf(__VA_ARGS__); printf("\n"); } } while (0)
+
+/* Private variables ---------------------------------------------------------*/
+static TX_THREAD test_thread;
+static UCHAR test_stack[TEST_STACK_SIZE];
+
+static uint8_t test_image[TEST_ARCHIVE_BYTES];
+static uint8_t test_seen[TEST_SEQ_MAX];
+static ULONG test_base;
+static meteo_archive_cursor_t test_cursor;
+
+static uint32_t test_tick;
+static uint32_t test_frames;
+static uint32_t test_max_reads;
+static long test_laps = 30000L;
+static int test_failures;
+
+/* Private functions ---------------------------------------------------------*/
+
+/* The archive clock, moved by hand: one reading a second */
+uint32_t HAL_GetTick(void)
+{
+  return test_tick;
+}
+
+/* meteo_trace.c sets it around a dump; no console here */
+meteo_console_overflow_t meteo_console_set_overflow(meteo_console_overflow_t policy)
+{
+  return policy;
+}
+
+static meteo_archive_store_stats_t test_stats(void)
+{
+  meteo_archive_store_stats_t stats;
+
+  meteo_archive_store_get_stats(&stats);
+  return stats;
+}
+
+static void test_add(uint32_t count)
+{
+  char frame[64];
+
+  while (count-- > 0U)
+  {
+    snprintf(frame, sizeof(frame), "UUU$%05lu.%05lu.%04lu.%05lu.%03u.ABCD*QQQ",
+             (unsigned long)(2000U + test_frames % 37U), (unsigned long)(10132U + (test_frames / 100U) % 5U),
+             (unsigned long)((test_frames * 13U) % 3600U), (unsigned long)(test_frames % 40U), 115U);
+    test_tick += 1000U;
+    CHECK(meteo_archive_store_add_frame(frame) == TX_SUCCESS, "add of frame %lu", (unsigned long)test_frames);
+    test_frames++;
+  }
+}
+
+/* Open again, as after a reset: nothing may move */
+static void test_reopen(const char *what)
+{
+  meteo_archive_store_stats_t before = test_stats();
+  meteo_archive_store_stats_t after;
+
+  meteo_archive_store_open();
+  after = test_stats();
+  CHECK(before.next_seq == after.next_seq && before.oldest == after.oldest,
+        "%s: next %lu -> %lu, oldest %lu -> %lu", what, (unsigned long)before.next_seq,
+        (unsigned long)after.next_seq, (unsigned long)before.oldest, (unsigned long)after.oldest);
+  test_max_reads = (after.open_reads > test_max_reads) ? after.open_reads : test_max_reads;
+}
+
+static void test_read_image(void)
+{
+  ULONG offset;
+
+  for (offset = 0U; offset < TEST_ARCHIVE_BYTES; offset += TEST_BLOCK_SIZE)
+  {
+    meteo_ospi_read(test_base + offset, &test_image[offset], TEST_BLOCK_SIZE);
+  }
+}
+
+/* Offset in the ring of the end of segment seq, 0 when not found */
+static ULONG test_end_offset(uint32_t seq)
+{
+  meteo_archive_header_t header;
+  ULONG offset;
+
+  test_read_image();
+  for (offset = 0U; offset + METEO_ARCHIVE_HEADER_SIZE <= TEST_ARCHIVE_BYTES; offset += 4U)
+  {
+    if (meteo_archive_header_read(&test_image[offset], METEO_ARCHIVE_HEADER_SIZE, &header) == METEO_ARCHIVE_OK &&
+        header.seq == seq)
+    {
+      return offset + header.bytes;
+    }
+  }
+  return 0U;
+}
+
+/* Walk the ring as meteo_archive_dump does: every seq still on flash decodes */
+static void test_verify(uint32_t expected_missing)
+{
+  meteo_archive_store_stats_t stats = test_stats();
+  meteo_archive_decoder_t decoder;
+  meteo_archive_sample_t sample;
+  uint32_t segments = 0U;
+  uint32_t samples = 0U;
+  uint32_t missing = 0U;
+  uint32_t seq;
+  ULONG offset = 0U;
+
+  test_read_image();
+  memset(test_seen, 0, sizeof(test_seen));
+  while (offset + METEO_ARCHIVE_HEADER_SIZE <= TEST_ARCHIVE_BYTES)
+  {
+    if (meteo_archive_decoder_init(&decoder, &test_image[offset], TEST_ARCHIVE_BYTES - offset) != METEO_ARCHIVE_OK)
+    {
+      offset += 4U;
+      continue;
+    }
+    test_seen[decoder.header.seq % TEST_SEQ_MAX] = 1U;
+    segments++;
+    samples += decoder.header.samples;
+    while (meteo_archive_decoder_next(&decoder, &sample) == METEO_ARCHIVE_OK)
+    {
+      CHECK(sample.value[METEO_ARCHIVE_VOLTAGE] == 115.0f, "segment %lu: voltage", (unsigned long)decoder.header.seq);
+    }
+    offset += decoder.header.bytes;
+  }
+  for (seq = stats.oldest; seq != stats.next_seq; seq++)
+  {
+    missing += test_seen[seq % TEST_SEQ_MAX] ? 0U : 1U;
+  }
+  printf("  %lu segments, %lu samples on flash, seq %lu..%lu, %lu missing\n",
+         (unsigned long)segments, (unsigned long)samples, (unsigned long)stats.oldest,
+         (unsigned long)stats.next_seq, (unsigned long)missing);
+  CHECK(missing == expected_missing, "%lu segments missing, expected %lu",
+        (unsigned long)missing, (unsigned long)expected_missing);
+}
+
+static void test_laps_run(void)
+{
+  meteo_archive_store_stats_t stats;
+  long lap;
+
+  printf("laps\n");
+  meteo_archive_store_open();
+  CHECK(test_stats().next_seq == 0U, "fresh flash: next %lu", (unsigned long)test_stats().next_seq);
+  for (lap = 0; lap < test_laps; lap++)
+  {
+    test_add(20U + (uint32_t)(lap % 50));
+    meteo_archive_store_flush();
+    test_reopen("lap");
+    test_tick = 0U;
+  }
+  stats = test_stats();
+  printf("  %ld restarts: next %lu, oldest %lu, at most %lu reads to open\n",
+         test_laps, (unsigned long)stats.next_seq, (unsigned long)stats.oldest,
+         (unsigned long)test_max_reads);
+  test_verify(0U);
+}
+
+static void test_torn(void)
+{
+  ULONG junk = 0x12345678UL;
+  ULONG zero = 0U;
+  uint32_t next;
+  ULONG end;
+  ULONG end_after;
+
+  // The word after the newest segment, where the next header goes
+  printf("torn header\n");
+  next = test_stats().next_seq;
+  end = test_end_offset(next - 1U);
+  lx_stm32_ospi_write(0U, (ULONG *)(uintptr_t)(test_base + end), &junk, 1U);
+  meteo_archive_store_open();
+  CHECK(test_stats().next_seq == next, "next %lu, expected %lu", (unsigned long)test_stats().next_seq,
+        (unsigned long)next);
+  test_add(100U);
+  meteo_archive_store_flush();
+  test_reopen("after the torn header");
+  CHECK(test_stats().next_seq == next + 1U, "next %lu after one segment", (unsigned long)test_stats().next_seq);
+  end_after = test_end_offset(next);
+  printf("  torn at %lu, the next segment ends at %lu\n", (unsigned long)end, (unsigned long)end_after);
+  CHECK(end_after / TEST_BLOCK_SIZE != end / TEST_BLOCK_SIZE, "next segment in the torn block");
+
+  // A word of the body cleared: the CRC fails, the header still walks
+  printf("torn body\n");
+  next = test_stats().next_seq;
+  test_add(30U);
+  meteo_archive_store_flush();
+  end = test_end_offset(next);
+  lx_stm32_ospi_write(0U, (ULONG *)(uintptr_t)(test_base + end - 8U), &zero, 1U);
+  test_reopen("torn body");
+  test_add(30U);
+  meteo_archive_store_flush();
+  test_reopen("after the torn body");
+  test_verify(1U);
+}
+
+static void test_tick_wrap(void)
+{
+  meteo_archive_query_t query;
+  meteo_archive_sample_t samples[64];
+  int64_t last = -1;
+  uint32_t count = 0U;
+  uint32_t steps = 0U;
+  UINT n;
+  UINT i;
+
+  // 30 readings before the wrap, 30 after, in one boot
+  printf("tick wrap\n");
+  meteo_archive_store_open();
+  test_tick = 0xFFFFFFFFUL - 30U * 1000U + 1U;
+  query.from_usec = meteo_archive_store_now();
+  test_add(60U);
+  meteo_archive_store_flush();
+  query.to_usec = meteo_archive_store_now();
+  query.channel = METEO_ARCHIVE_CHANNELS;
+  query.min = 0.0f;
+  query.max = 0.0f;
+
+  meteo_archive_store_cursor_open(&test_cursor, &query);
+  do
+  {
+    meteo_archive_store_read(&test_cursor, samples, 64U, &n);
+    for (i = 0U; i < n; i++)
+    {
+      steps += (last >= 0 && samples[i].ts_usec - last == 1000000) ? 1U : 0U;
+      last = samples[i].ts_usec;
+      count++;
+    }
+  } while (n == 64U);
+  printf("  %lu readings, %lu a second after the one before\n", (unsigned long)count, (unsigned long)steps);
+  CHECK(count == 60U && steps == 59U, "%lu readings, %lu steps of 1 s", (unsigned long)count,
+        (unsigned long)steps);
+}
+
+static void test_entry(ULONG input)
+{
+  ULONG block_size;
+  ULONG total_blocks;
+
+  (void)input;
+
+  meteo_ospi_get_info(&block_size, &total_blocks);
+  CHECK(block_size == TEST_BLOCK_SIZE, "block size %lu", (unsigned long)block_size);
+  test_base = (total_blocks - METEO_OSPI_RESERVED_BLOCKS) * block_size;
+
+  test_laps_run();
+  test_torn();
+  test_tick_wrap();
+
+  printf("%s (%d failures)\n", test_failures ? "FAILED" : "PASSED", test_failures);
+  exit(test_failures != 0);
+}
+
+void tx_application_define(void *first_unused_memory)
+{
+  (void)first_unused_memory;
+
+  meteo_ospi_init();
+  meteo_archive_store_init();
+  tx_thread_create(&test_thread, "test", test_entry, 0U, test_stack, TEST_STACK_SIZE,
+                   5U, 5U, TX_NO_TIME_SLICE, TX_AUTO_START);
+}
+
+int main(int argc, char *argv[])
+{
+  const char *image = "meteo_archive_store_test.bin";
+  int opt;
+
+  while ((opt = getopt(argc, argv, "l:")) != -1)
+  {
+    switch (opt)
+    {
+      case 'l':
+        test_laps = atol(optarg);
+        break;
+      default:
+        fprintf(stderr, "Usage: %s [-l laps] [image]\n", argv[0]);
+        return 2;
+    }
+  }
+  if (optind < argc)
+  {
+    image = argv[optind];
+  }
+  if (test_laps < 1L)
+  {
+    fprintf(stderr, "laps > 0\n");
+    return 2;
+  }
+
+  // A file, so the open after a restart reads what was written
+  unlink(image);
+  setenv(LX_STM32_OSPI_HOST_FILE_ENV, image, 1);
+  tx_kernel_enter();
+  return 0;
+}
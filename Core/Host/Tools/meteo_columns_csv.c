@@ -0,0 +1,212 @@
+/**
+  ******************************************************************************
+  * @file    meteo_columns_csv.c
+  * @brief   Convert an MCOL export (meteo_columns.h) to CSV.
+  *
+  *          The file is mapped and read in place with meteo_columns_open() /
+  *          meteo_columns_next(): the arrays of a chunk are used as they
+  *          are, which is how an analysis tool would load it. Standard
+  *          input (e.g. straight from the export server) is read into
+  *          memory first. Rows are written with the export formatter, so
+  *          the CSV has the same bytes as a CSV export of the same range.
+  *
+  *          Build: gcc -O2 -ICore/Inc -o meteo_columns_csv
+  *                     Core/Host/Tools/meteo_columns_csv.c Core/Src/meteo_columns.c
+  *                     Core/Src/meteo_format.c
+  *          Usage: meteo_columns_csv [-n] export.mcol > readings.csv
+  *                 echo "mcol 86400" | nc -q 60 <board> 16537 | meteo_columns_csv > day.csv
+  *            -n  NanoEdge AI Studio signal file: no header, no timestamps
+  *          The totals go to stderr; the exit status is 1 when the stream
+  *          is damaged or stops before its end chunk.
+  ******************************************************************************
+  */
+
+/* Includes ------------------------------------------------------------------*/
+#include <fcntl.h>
+#include <inttypes.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include "meteo_columns.h"
+#include "meteo_format.h"
+
+/* Private defines -----------------------------------------------------------*/
+#define CSV_BUFFER_SIZE         65536U
+
+/* Private functions ---------------------------------------------------------*/
+
+static uint8_t *read_file(FILE *in, size_t *size)
+{
+  uint8_t *buffer = NULL;
+  size_t length = 0;
+  size_t capacity = 0;
+  size_t n;
+
+  do
+  {
+    if (length == capacity)
+    {
+      uint8_t *grown;
+
+      capacity = capacity != 0U ? capacity * 2U : 65536U;
+      grown = realloc(buffer, capacity);
+      if (grown == NULL)
+      {
+        free(buffer);
+        return NULL;
+      }
+      buffer = grown;
+    }
+    n = fread(buffer + length, 1, capacity - length, in);
+    length += n;
+  } while (n != 0U);
+
+  *size = length;
+  return buffer;
+}
+
+static void write_row(meteo_format_writer_t *writer, const meteo_columns_reader_t *reader,
+                      const meteo_columns_chunk_t *chunk, uint32_t row, int nanoedge)
+{
+  uint32_t c;
+
+  for (c = 0; c < reader->columns; c++)
+  {
+    const meteo_columns_field_t *field = &reader->field[c];
+
+    switch (field->type)
+    {
+      case METEO_COLUMNS_TIMESTAMP:
+        if (!nanoedge)
+        {
+          meteo_format_field_seconds(writer, field->name, ((const int64_t *)chunk->column[c])[row],
+                                     field->decimals);
+        }
+        break;
+      case METEO_COLUMNS_FLOAT32:
+        meteo_format_field_float(writer, field->name, ((const float *)chunk->column[c])[row],
+                                 field->decimals);
+        break;
+      default:
+        meteo_format_field_fixed(writer, field->name, ((const int32_t *)chunk->column[c])[row],
+                                 field->decimals);
+        break;
+    }
+  }
+}
+
+/* Main ----------------------------------------------------------------------*/
+
+int main(int argc, char **argv)
+{
+  static char text[CSV_BUFFER_SIZE];
+  meteo_columns_reader_t reader;
+  meteo_columns_chunk_t chunk;
+  meteo_format_writer_t writer;
+  const uint8_t *data;
+  struct stat st;
+  size_t size;
+  uint32_t row;
+  uint32_t c;
+  int nanoedge = 0;
+  int mapped = 0;
+  int opt;
+  int fd;
+  int status;
+
+  while ((opt = getopt(argc, argv, "n")) != -1)
+  {
+    switch (opt)
+    {
+      case 'n':
+        nanoedge = 1;
+        break;
+      default:
+        fprintf(stderr, "Usage: %s [-n] [export.mcol] > readings.csv\n", argv[0]);
+        return 2;
+    }
+  }
+
+  if (optind < argc)
+  {
+    fd = open(argv[optind], O_RDONLY);
+    if (fd < 0 || fstat(fd, &st) != 0)
+    {
+      perror(argv[optind]);
+      return 1;
+    }
+    size = (size_t)st.st_size;
+    data = mmap(NULL, size != 0U ? size : 1U, PROT_READ, MAP_PRIVATE, fd, 0);
+    close(fd);
+    if (data == MAP_FAILED)
+    {
+      perror(argv[optind]);
+      return 1;
+    }
+    mapped = 1;
+  }
+  else
+  {
+    data = read_file(stdin, &size);
+    if (data == NULL)
+    {
+      fprintf(stderr, "Out of memory\n");
+      return 1;
+    }
+  }
+
+  if (meteo_columns_open(&reader, data, size) != METEO_COLUMNS_OK)
+  {
+    fprintf(stderr, "Not an MCOL stream\n");
+    return 1;
+  }
+
+  meteo_format_writer_init(&writer, text, sizeof(text), METEO_FORMAT_CSV);
+  if (!nanoedge)
+  {
+    for (c = 0; c < reader.columns; c++)
+    {
+      printf("%s%s", (c != 0U) ? "," : "", reader.field[c].name);
+    }
+    printf("\n");
+  }
+
+  while ((status = meteo_columns_next(&reader, &chunk)) == METEO_COLUMNS_OK)
+  {
+    for (row = 0; row < chunk.rows; row++)
+    {
+      write_row(&writer, &reader, &chunk, row, nanoedge);
+      if (meteo_format_row_end(&writer) == 0U)
+      {
+        fwrite(text, 1, writer.length, stdout);
+        meteo_format_writer_reset(&writer);
+        write_row(&writer, &reader, &chunk, row, nanoedge);
+        (void)meteo_format_row_end(&writer);
+      }
+    }
+  }
+  fwrite(text, 1, writer.length, stdout);
+
+  fprintf(stderr, "%" PRIu32 " chunks, %" PRIu64 " rows, %zu bytes", reader.chunks, reader.rows, size);
+  if (reader.rows != 0U)
+  {
+    fprintf(stderr, " (%.1f bytes/row)", (double)size / (double)reader.rows);
+  }
+  fprintf(stderr, "%s\n", (status == METEO_COLUMNS_END) ? "" :
+          (status == METEO_COLUMNS_ERROR_TRUNCATED) ? ", stops before the end chunk" : ", damaged chunk");
+
+  if (mapped)
+  {
+    munmap((void *)data, size != 0U ? size : 1U);
+  }
+  else
+  {
+    free((void *)data);
+  }
+  return (status == METEO_COLUMNS_END) ? 0 : 1;
+}
@@ -0,0 +1,386 @@
+/**
+  ******************************************************************************
+  * @file    meteo_compress_test.c
+  * @brief   Rows kept and error of the deadband / swinging-door stage
+  *          (meteo_compress.c) on the Linux port of ThreadX.
+  *
+  *          A day of 1 Hz readings from the simulator's station
+  *          (meteo_sim_station.c) and from a diurnal station with a little
+  *          sensor noise, decoded by meteo_archive_store_parse_frame() as in
+  *          the DB thread, with the default configuration:
+  *          - meteo_compress_apply(), as the stream gets them: readings per
+  *            row. Each row channel (temperature, wind speed, direction) is
+  *            rebuilt at every reading from the rows, interpolated for a
+  *            swinging door and held for a deadband: the largest error must
+  *            be within its tolerance. No two rows more than the heartbeat
+  *            (60 s) apart.
+  *          - meteo_compress_add(), every channel alone as a series would
+  *            keep it: readings per point, error within the tolerance,
+  *            heartbeat.
+  *
+  *          Build: TX=Middlewares/ST/threadx
+  *                 gcc -O2 -DTX_INCLUDE_USER_DEFINE_FILE -ICore/Host/Inc -ICore/Inc
+  *                     -I$TX/ports/linux/gnu/inc -I$TX/common/inc
+  *                     -I$TX/utility/execution_profile_kit -o meteo_compress_test
+  *                     Core/Host/Tools/meteo_compress_test.c Core/Src/meteo_compress.c
+  *                     Core/Src/meteo_archive.c Core/Src/meteo_archive_store.c
+  *                     Core/Src/meteo_ospi.c Core/Src/meteo_trace.c
+  *                     Core/Src/meteo_sim_station.c Core/Host/Src/host_ospi.c
+  *                     <the ThreadX sources of the meteo_host build line in
+  *                     README.md> -lpthread -lm
+  *          Usage: meteo_compress_test [-d days]
+  ******************************************************************************
+  */
+
+/* Includes ------------------------------------------------------------------*/
+#include <math.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+
+#include "tx_api.h"
+#include "meteo_archive.h"
+#include "meteo_archive_store.h"
+#include "meteo_compress.h"
+#include "meteo_console.h"
+#include "meteo_simulator.h"
+
+/* Private defines -----------------------------------------------------------*/
+#define TEST_STACK_SIZE         16384U
+#define TEST_DAY_SAMPLES        86400U
+#define TEST_MAX_DAYS           4U
+#define TEST_MAX_SAMPLES        (TEST_MAX_DAYS * TEST_DAY_SAMPLES)
+
+#define CHECK(cond, ...) \
+  do { if (!(cond)) { if (test_failures++ < 20) { printf("  FAILED line %d: ", __LINE__); \
+       printf(__VA_ARGS__); printf("\n"); } } } while (0)
+
+/* Private types -------------------------------------------------------------*/
+
+/* Kept points of one channel */
+typedef struct
+{
+  uint32_t count;
+  int64_t ts_usec[TEST_MAX_SAMPLES];
+  float value[TEST_MAX_SAMPLES];
+} test_points_t;
+
+/* Private variables ---------------------------------------------------------*/
+static TX_THREAD test_thread;
+static UCHAR test_stack[TEST_STACK_SIZE];
+
+static meteo_archive_sample_t test_samples[TEST_MAX_SAMPLES];
+static test_points_t test_points;
+static uint32_t test_count;
+static uint32_t test_days = 1U;
+static uint32_t test_rng = 0x2545F491UL;
+
+static int test_failures;
+
+static const char *const test_channel_names[METEO_ARCHIVE_CHANNELS] =
+{
+  "temperature", "pressure", "wind speed", "wind direction", "voltage"
+};
+
+/* Private functions ---------------------------------------------------------*/
+
+/* meteo_archive_store.c needs it; the readings are stamped here */
+uint32_t HAL_GetTick(void)
+{
+  return 0U;
+}
+
+/* meteo_trace.c sets it around a dump; no console here */
+meteo_console_overflow_t meteo_console_set_overflow(meteo_console_overflow_t policy)
+{
+  return policy;
+}
+
+static void test_add_frame(const char *frame)
+{
+  meteo_archive_sample_t *sample = &test_samples[test_count];
+
+  CHECK(meteo_archive_store_parse_frame(frame, sample) == TX_SUCCESS, "frame %s", frame);
+  sample->ts_usec = (int64_t)test_count * 1000000;
+  test_count++;
+}
+
+static void test_simulator(void)
+{
+  meteo_sim_station_t station;
+  char frame[64];
+
+  test_count = 0U;
+  meteo_sim_station_init(&station, METEO_SIM_DEFAULT_SEED);
+  while (test_count < test_days * TEST_DAY_SAMPLES)
+  {
+    meteo_sim_station_frame(&station, frame, sizeof(frame));
+    test_add_frame(frame);
+  }
+}
+
+static uint32_t test_random(void)
+{
+  test_rng ^= test_rng << 13;
+  test_rng ^= test_rng >> 17;
+  test_rng ^= test_rng << 5;
+  return test_rng;
+}
+
+/* Temperature and pressure follow the sun, the wind changes over minutes;
+   a little sensor noise on each */
+static void test_diurnal(void)
+{
+  char frame[64];
+  double t;
+
+  test_count = 0U;
+  while (test_count < test_days * TEST_DAY_SAMPLES)
+  {
+    t = (double)test_count;
+    snprintf(frame, sizeof(frame), "UUU$%05lu.%05lu.%04lu.%05lu.%03lu.ABCD*QQQ",
+             (unsigned long)(lround(1500.0 + 600.0 * sin(t * 2.0 * M_PI / 86400.0)) + test_random() % 5U),
+             (unsigned long)lround(10132.0 + 20.0 * sin(t * 2.0 * M_PI / 86400.0)),
+             (unsigned long)(lround(1800.0 + 1700.0 * sin(t * 2.0 * M_PI / 21600.0)) + test_random() % 30U),
+             (unsigned long)(lround(40.0 + 20.0 * sin(t * 2.0 * M_PI / 600.0)) + test_random() % 6U),
+             (unsigned long)(115U + test_random() % 2U));
+    test_add_frame(frame);
+  }
+}
+
+static void test_point(int64_t ts_usec, float value)
+{
+  test_points.ts_usec[test_points.count] = ts_usec;
+  test_points.value[test_points.count] = value;
+  test_points.count++;
+}
+
+/* Largest gap between kept points, the last reading included */
+static int64_t test_largest_gap(void)
+{
+  int64_t gap = test_points.ts_usec[0] - test_samples[0].ts_usec;
+  uint32_t i;
+
+  for (i = 1U; i < test_points.count; i++)
+  {
+    if (test_points.ts_usec[i] - test_points.ts_usec[i - 1U] > gap)
+    {
+      gap = test_points.ts_usec[i] - test_points.ts_usec[i - 1U];
+    }
+  }
+  if (test_samples[test_count - 1U].ts_usec - test_points.ts_usec[test_points.count - 1U] > gap)
+  {
+    gap = test_samples[test_count - 1U].ts_usec - test_points.ts_usec[test_points.count - 1U];
+  }
+  return gap;
+}
+
+/* Largest distance of the readings of a channel from what the kept points
+   give back, up to the last point */
+static float test_max_error(uint32_t channel, const meteo_compress_config_t *config)
+{
+  float worst = 0.0f;
+  float rebuilt;
+  float error;
+  uint32_t point = 0U;
+  uint32_t n;
+  double share;
+
+  for (n = 0U; n < test_count; n++)
+  {
+    while (point + 1U < test_points.count && test_points.ts_usec[point + 1U] <= test_samples[n].ts_usec)
+    {
+      point++;
+    }
+    if (test_samples[n].ts_usec < test_points.ts_usec[point] ||
+        (point + 1U == test_points.count && test_samples[n].ts_usec > test_points.ts_usec[point]))
+    {
+      continue;
+    }
+    rebuilt = test_points.value[point];
+    if (config->mode == METEO_COMPRESS_SWINGING_DOOR && point + 1U < test_points.count)
+    {
+      share = (double)(test_samples[n].ts_usec - test_points.ts_usec[point]) /
+              (double)(test_points.ts_usec[point + 1U] - test_points.ts_usec[point]);
+      rebuilt = (float)((double)test_points.value[point] +
+                        share * (double)(test_points.value[point + 1U] - test_points.value[point]));
+    }
+    error = fabsf(test_samples[n].value[channel] - rebuilt);
+    if (config->circular && error > 180.0f)
+    {
+      error = 360.0f - error;
+    }
+    worst = fmaxf(worst, error);
+  }
+  return worst;
+}
+
+/* Within the tolerance, give or take the float rounding of the values */
+static int test_within(float error, const meteo_compress_config_t *config, uint32_t channel)
+{
+  return error <= config->tolerance * 1.0001f + fabsf(test_samples[0].value[channel]) * 1e-6f + 1e-5f;
+}
+
+static void test_reset(void)
+{
+  meteo_compress_config_t config;
+  uint32_t c;
+
+  // Setting the configuration forgets the points and the doors
+  for (c = 0U; c < METEO_ARCHIVE_CHANNELS; c++)
+  {
+    meteo_compress_get_config(c, &config);
+    meteo_compress_set_config(c, &config);
+  }
+}
+
+/* The stream: rows of every channel, kept when a row channel needs one */
+static void test_rows(const char *feed)
+{
+  static meteo_archive_sample_t rows[TEST_MAX_SAMPLES];
+  meteo_archive_sample_t kept[2];
+  meteo_compress_config_t config;
+  meteo_compress_stats_t before;
+  meteo_compress_stats_t after;
+  uint32_t count = 0U;
+  uint32_t c;
+  uint32_t i;
+  uint32_t n;
+  int64_t gap = 0;
+  float error;
+
+  test_reset();
+  meteo_compress_get_stats(&before);
+  for (n = 0U; n < test_count; n++)
+  {
+    for (i = meteo_compress_apply(&test_samples[n], kept), c = 0U; c < i; c++)
+    {
+      CHECK(count == 0U || kept[c].ts_usec > rows[count - 1U].ts_usec, "%s: row at %lld out of order", feed,
+            (long long)kept[c].ts_usec);
+      rows[count++] = kept[c];
+    }
+  }
+  meteo_compress_get_stats(&after);
+  CHECK(after.rows - before.rows == count && after.readings - before.readings == test_count,
+        "%s: stats %lu rows, %lu readings", feed, (unsigned long)(after.rows - before.rows),
+        (unsigned long)(after.readings - before.readings));
+
+  printf("%s: %lu readings, %lu rows (%lu previous readings), %.2f : 1\n", feed, (unsigned long)test_count,
+         (unsigned long)count, (unsigned long)(after.held - before.held), (double)test_count / (double)count);
+  for (c = 0U; c < METEO_ARCHIVE_CHANNELS; c++)
+  {
+    test_points.count = 0U;
+    for (i = 0U; i < count; i++)
+    {
+      test_point(rows[i].ts_usec, rows[i].value[c]);
+    }
+    meteo_compress_get_config(c, &config);
+    error = test_max_error(c, &config);
+    gap = test_largest_gap();
+    if ((METEO_COMPRESS_ROW_CHANNELS & (1UL << c)) == 0U)
+    {
+      printf("  %-15s max error %8.3f (not a row channel, carried along)\n", test_channel_names[c],
+             (double)error);
+      continue;
+    }
+    printf("  %-15s max error %8.3f, tolerance %.3f\n", test_channel_names[c], (double)error,
+           (double)config.tolerance);
+    CHECK(test_within(error, &config, c), "%s: %s error %.4f, tolerance %.3f", feed, test_channel_names[c],
+          (double)error, (double)config.tolerance);
+  }
+  printf("  largest gap between rows %.0f s\n", (double)gap * 1e-6);
+  CHECK(gap <= (int64_t)METEO_COMPRESS_HEARTBEAT_S * 1000000, "%s: %.0f s without a row", feed,
+        (double)gap * 1e-6);
+}
+
+/* Each channel alone, as a series per channel keeps it */
+static void test_alone(const char *feed)
+{
+  meteo_compress_config_t config;
+  meteo_compress_t channel;
+  int64_t points_usec[2];
+  float points[2];
+  uint32_t kept;
+  uint32_t c;
+  uint32_t i;
+  uint32_t n;
+  int64_t gap;
+  float error;
+
+  for (c = 0U; c < METEO_ARCHIVE_CHANNELS; c++)
+  {
+    meteo_compress_get_config(c, &config);
+    meteo_compress_reset(&channel);
+    test_points.count = 0U;
+    for (n = 0U; n < test_count; n++)
+    {
+      kept = meteo_compress_add(&channel, &config, test_samples[n].ts_usec, test_samples[n].value[c],
+                                points_usec, points);
+      for (i = 0U; i < kept; i++)
+      {
+        test_point(points_usec[i], points[i]);
+      }
+    }
+    error = test_max_error(c, &config);
+    gap = test_largest_gap();
+    printf("  alone %-15s %7.1f : 1, max error %8.3f, tolerance %.3f, largest gap %.0f s\n",
+           test_channel_names[c], (double)test_count / (double)test_points.count, (double)error,
+           (double)config.tolerance, (double)gap * 1e-6);
+    CHECK(test_within(error, &config, c), "%s alone: %s error %.4f, tolerance %.3f", feed,
+          test_channel_names[c], (double)error, (double)config.tolerance);
+    CHECK(gap <= (int64_t)config.heartbeat_s * 1000000, "%s alone: %s %.0f s without a point", feed,
+          test_channel_names[c], (double)gap * 1e-6);
+  }
+}
+
+static void test_entry(ULONG input)
+{
+  (void)input;
+
+  test_simulator();
+  test_rows("simulator");
+  test_alone("simulator");
+  test_diurnal();
+  test_rows("diurnal");
+  test_alone("diurnal");
+
+  printf("%s (%d failures)\n", test_failures ? "FAILED" : "PASSED", test_failures);
+  exit(test_failures != 0);
+}
+
+void tx_application_define(void *first_unused_memory)
+{
+  (void)first_unused_memory;
+
+  meteo_compress_init();
+  tx_thread_create(&test_thread, "test", test_entry, 0U, test_stack, TEST_STACK_SIZE,
+                   5U, 5U, TX_NO_TIME_SLICE, TX_AUTO_START);
+}
+
+int main(int argc, char *argv[])
+{
+  int opt;
+
+  while ((opt = getopt(argc, argv, "d:")) != -1)
+  {
+    switch (opt)
+    {
+      case 'd':
+        test_days = (uint32_t)atol(optarg);
+        break;
+      default:
+        fprintf(stderr, "Usage: %s [-d days]\n", argv[0]);
+        return 2;
+    }
+  }
+  if (test_days < 1U || test_days > TEST_MAX_DAYS)
+  {
+    fprintf(stderr, "days 1..%u\n", TEST_MAX_DAYS);
+    return 2;
+  }
+
+  tx_kernel_enter();
+  return 0;
+}
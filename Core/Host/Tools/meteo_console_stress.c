@@ -0,0 +1,479 @@
+/**
+  ******************************************************************************
+  * @file    meteo_console_stress.c
+  * @brief   Stress of the console ring (meteo_console.c) on the Linux port of
+  *          ThreadX: 4 producers against the COM1 TX DMA.
+  *
+  *          Three ThreadX threads (same priority, time sliced every tick)
+  *          write bursts of 32 numbered lines a tick with meteo_console_write(), and a pthread
+  *          emulating an interrupt writes its own with
+  *          meteo_console_write_isr() between _tx_thread_context_save() and
+  *          _tx_thread_context_restore(), so it can cut into a thread that
+  *          is half way through a reservation. The TX DMA is a pthread that
+  *          holds each block for its time on the line, appends it to a
+  *          capture buffer and calls meteo_console_tx_cplt() from an
+  *          emulated interrupt. Two phases:
+  *          - DROP: the ring fills and lines are dropped;
+  *          - BLOCK: the threads wait, only the interrupt may drop.
+  *          Checks on what the DMA sent:
+  *          - every line is whole (producer, sequence, length and a
+  *            payload derived from both), none cut or interleaved;
+  *          - the lines of each producer are in order, no line twice;
+  *          - the bytes sent are the bytes the writes accepted, and the
+  *            counters add up: written + dropped is what was offered;
+  *          - in BLOCK no thread line is missing.
+  *          It prints the lines per second, the caller time per write, the
+  *          DMA transfers and the ring peak of each phase.
+  *
+  *          Build: TX=Middlewares/ST/threadx
+  *                 gcc -O2 -DTX_INCLUDE_USER_DEFINE_FILE -DOS_LINUX -ICore/Host/Inc
+  *                     -ICore/Inc -I$TX/ports/linux/gnu/inc -I$TX/common/inc
+  *                     -I$TX/utility/execution_profile_kit -o meteo_console_stress
+  *                     Core/Host/Tools/meteo_console_stress.c Core/Src/meteo_console.c
+  *                     <the ThreadX sources of the meteo_host build line in
+  *                     README.md> -lpthread
+  *          Usage: meteo_console_stress [-n lines] [-b baud]
+  *            -n  lines per producer and phase (default 4000)
+  *            -b  emulated line rate (default 2000000)
+  ******************************************************************************
+  */
+
+/* Includes ------------------------------------------------------------------*/
+#include <pthread.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <unistd.h>
+
+#include "tx_api.h"
+#include "meteo_console.h"
+
+/* Private defines -----------------------------------------------------------*/
+#define TEST_STACK_SIZE         16384U
+#define TEST_THREADS            3U
+#define TEST_PRODUCERS          (TEST_THREADS + 1U)
+#define TEST_ISR_PRODUCER       TEST_THREADS
+#define TEST_LINE_MAX           120U
+#define TEST_CAPTURE_SIZE       (16UL * 1024UL * 1024UL)
+
+#define CHECK(cond, ...) \
+  do { if (!(cond)) { if (test_failures++ < 20) { printf("  FAILED line %d: ", __LINE__); \
+       printf(__VA_ARGS__); printf("\n"); } } } while (0)
+
+/* Private variables ---------------------------------------------------------*/
+UART_HandleTypeDef hcom_uart[COM_NBR];
+
+static TX_THREAD test_thread;
+static UCHAR test_stack[TEST_STACK_SIZE];
+static TX_THREAD test_producer[TEST_THREADS];
+static UCHAR test_producer_stack[TEST_THREADS][TEST_STACK_SIZE];
+static TX_SEMAPHORE test_done;
+
+/* The emulated TX DMA: one block in flight, appended to the capture */
+static pthread_t test_dma_thread;
+static pthread_mutex_t test_dma_lock = PTHREAD_MUTEX_INITIALIZER;
+static pthread_cond_t test_dma_cond = PTHREAD_COND_INITIALIZER;
+static const uint8_t *test_dma_data;
+static uint16_t test_dma_size;
+static unsigned long test_byte_ns;
+static char *test_capture;
+static size_t test_captured;
+
+static pthread_t test_isr_thread;
+static volatile int test_isr_run;
+
+/* Per phase */
+static unsigned long test_lines = 4000UL;
+static unsigned long test_baud = 2000000UL;
+static unsigned long test_accepted[TEST_PRODUCERS];
+static unsigned long test_accepted_bytes[TEST_PRODUCERS];
+static unsigned long test_offered_bytes[TEST_PRODUCERS];
+static unsigned long test_offered[TEST_PRODUCERS];
+static double test_write_s[TEST_PRODUCERS];
+
+static int test_failures;
+
+/* Private functions ---------------------------------------------------------*/
+
+/* meteo_console.c only reads the tick through ThreadX */
+uint32_t HAL_GetTick(void)
+{
+  return (uint32_t)tx_time_get();
+}
+
+static double test_now(void)
+{
+  struct timespec now;
+
+  clock_gettime(CLOCK_MONOTONIC, &now);
+  return (double)now.tv_sec + (double)now.tv_nsec * 1e-9;
+}
+
+static uint32_t test_random(uint32_t *state)
+{
+  uint32_t x = *state;
+
+  x ^= x << 13;
+  x ^= x >> 17;
+  x ^= x << 5;
+  *state = x;
+  return x;
+}
+
+/* Payload length and contents follow from producer and sequence */
+static uint32_t test_line_length(uint32_t producer, uint32_t seq)
+{
+  uint32_t mix = (producer + 1U) * 2654435761UL ^ seq * 40503UL;
+
+  return 16U + (mix >> 7) % (TEST_LINE_MAX - 32U);
+}
+
+static char test_payload(uint32_t producer, uint32_t seq, uint32_t at)
+{
+  return (char)('a' + (producer * 7U + seq * 3U + at) % 26U);
+}
+
+static int test_format(char *line, uint32_t producer, uint32_t seq)
+{
+  uint32_t length = test_line_length(producer, seq);
+  uint32_t i;
+  int n = snprintf(line, TEST_LINE_MAX, "P%u %08u %03u ", (unsigned)producer, (unsigned)seq,
+                   (unsigned)length);
+
+  for (i = 0U; i < length; i++)
+  {
+    line[n + (int)i] = test_payload(producer, seq, i);
+  }
+  line[n + (int)length] = '\n';
+  return n + (int)length + 1;
+}
+
+static void test_offer(uint32_t producer, uint32_t seq, int from_isr)
+{
+  char line[TEST_LINE_MAX];
+  int length = test_format(line, producer, seq);
+  double start = test_now();
+  int done = from_isr ? meteo_console_write_isr(line, length) : meteo_console_write(line, length);
+
+  test_write_s[producer] += test_now() - start;
+  test_offered[producer]++;
+  test_offered_bytes[producer] += (unsigned long)length;
+  CHECK(done == 0 || done == length, "P%u wrote %d of %d bytes", (unsigned)producer, done, length);
+  if (done == length)
+  {
+    test_accepted[producer]++;
+    test_accepted_bytes[producer] += (unsigned long)length;
+  }
+}
+
+/* HAL stand-in: start the block, the DMA pthread sends it */
+HAL_StatusTypeDef HAL_UART_Transmit_DMA(UART_HandleTypeDef *huart, const uint8_t *pData, uint16_t Size)
+{
+  HAL_StatusTypeDef status = HAL_OK;
+
+  (void)huart;
+  pthread_mutex_lock(&test_dma_lock);
+  if (test_dma_size != 0U)
+  {
+    status = HAL_BUSY;
+  }
+  else
+  {
+    test_dma_data = pData;
+    test_dma_size = Size;
+    pthread_cond_signal(&test_dma_cond);
+  }
+  pthread_mutex_unlock(&test_dma_lock);
+  return status;
+}
+
+static void *test_dma_entry(void *arg)
+{
+  struct timespec wait;
+  size_t size;
+
+  (void)arg;
+  _tx_linux_isr_id = 16U + USART1_IRQn;
+
+  while (1)
+  {
+    pthread_mutex_lock(&test_dma_lock);
+    while (test_dma_size == 0U)
+    {
+      pthread_cond_wait(&test_dma_cond, &test_dma_lock);
+    }
+    size = test_dma_size;
+    pthread_mutex_unlock(&test_dma_lock);
+
+    wait.tv_sec = 0;
+    wait.tv_nsec = (long)(test_byte_ns * size);
+    nanosleep(&wait, NULL);
+
+    if (test_captured + size <= TEST_CAPTURE_SIZE)
+    {
+      memcpy(&test_capture[test_captured], test_dma_data, size);
+    }
+    test_captured += size;
+
+    pthread_mutex_lock(&test_dma_lock);
+    test_dma_size = 0U;
+    pthread_mutex_unlock(&test_dma_lock);
+
+    _tx_thread_context_save();
+    meteo_console_tx_cplt();
+    _tx_thread_context_restore();
+  }
+  return NULL;
+}
+
+/* The fourth producer: an interrupt every 0-255 us */
+static void *test_isr_entry(void *arg)
+{
+  uint32_t seed = 0x13579BDFUL;
+  uint32_t seq = 0U;
+
+  (void)arg;
+  _tx_linux_isr_id = 16U + USART3_IRQn;
+
+  while (test_isr_run)
+  {
+    usleep(test_random(&seed) & 0xFFU);
+    _tx_thread_context_save();
+    test_offer(TEST_ISR_PRODUCER, seq++, 1);
+    _tx_thread_context_restore();
+  }
+  return NULL;
+}
+
+static void test_producer_entry(ULONG input)
+{
+  uint32_t seq;
+
+  for (seq = 0U; seq < test_lines; seq++)
+  {
+    test_offer((uint32_t)input, seq, 0);
+
+    // Bursts of 32 lines a tick: the DMA empties the ring in between
+    if ((seq & 31U) == 31U)
+    {
+      tx_thread_sleep(1U);
+    }
+  }
+  tx_semaphore_put(&test_done);
+}
+
+/* Read the capture back: whole lines, in order per producer */
+static void test_verify(const char *phase, int block)
+{
+  unsigned long lines[TEST_PRODUCERS] = { 0 };
+  unsigned long bytes[TEST_PRODUCERS] = { 0 };
+  long last[TEST_PRODUCERS];
+  size_t at = 0U;
+  unsigned producer;
+  unsigned seq;
+  unsigned length;
+  uint32_t i;
+  int n;
+  int bad = 0;
+
+  for (producer = 0U; producer < TEST_PRODUCERS; producer++)
+  {
+    last[producer] = -1L;
+  }
+
+  CHECK(test_captured <= TEST_CAPTURE_SIZE, "%s: capture overflow", phase);
+  while (at < test_captured && test_captured <= TEST_CAPTURE_SIZE && bad < 5)
+  {
+    const char *line = &test_capture[at];
+
+    if (sscanf(line, "P%u %8u %3u %n", &producer, &seq, &length, &n) != 3 ||
+        producer >= TEST_PRODUCERS || n != 16 || at + (size_t)n + length + 1U > test_captured ||
+        length != test_line_length(producer, seq) || line[n + (int)length] != '\n')
+    {
+      CHECK(0, "%s: bad line at byte %zu: %.40s", phase, at, line);
+      bad++;
+      break;
+    }
+    for (i = 0U; i < length; i++)
+    {
+      if (line[n + (int)i] != test_payload(producer, seq, i))
+      {
+        break;
+      }
+    }
+    CHECK(i == length, "%s: P%u %u payload byte %u", phase, producer, seq, (unsigned)i);
+    CHECK((long)seq > last[producer], "%s: P%u %u after %ld", phase, producer, seq, last[producer]);
+    if (block && producer != TEST_ISR_PRODUCER)
+    {
+      CHECK((long)seq == last[producer] + 1L, "%s: P%u %u after %ld", phase, producer, seq, last[producer]);
+    }
+    last[producer] = (long)seq;
+    lines[producer]++;
+    bytes[producer] += (unsigned long)n + length + 1UL;
+    at += (size_t)n + length + 1U;
+  }
+
+  for (producer = 0U; producer < TEST_PRODUCERS; producer++)
+  {
+    CHECK(lines[producer] == test_accepted[producer], "%s: P%u sent %lu lines, %lu accepted",
+          phase, producer, lines[producer], test_accepted[producer]);
+    CHECK(bytes[producer] == test_accepted_bytes[producer], "%s: P%u sent %lu bytes, %lu accepted",
+          phase, producer, bytes[producer], test_accepted_bytes[producer]);
+    if (block && producer != TEST_ISR_PRODUCER)
+    {
+      CHECK(lines[producer] == test_lines, "%s: P%u sent %lu of %lu lines",
+            phase, producer, lines[producer], test_lines);
+    }
+  }
+}
+
+static void test_phase(const char *phase, meteo_console_overflow_t policy)
+{
+  meteo_console_stats_t before;
+  meteo_console_stats_t after;
+  unsigned long offered = 0UL;
+  unsigned long accepted = 0UL;
+  unsigned long offered_lines = 0UL;
+  unsigned long accepted_lines = 0UL;
+  double write_s = 0.0;
+  double start;
+  double elapsed;
+  uint32_t producer;
+
+  memset(test_accepted, 0, sizeof(test_accepted));
+  memset(test_accepted_bytes, 0, sizeof(test_accepted_bytes));
+  memset(test_offered, 0, sizeof(test_offered));
+  memset(test_offered_bytes, 0, sizeof(test_offered_bytes));
+  memset(test_write_s, 0, sizeof(test_write_s));
+  test_captured = 0U;
+
+  (void)meteo_console_set_overflow(policy);
+  meteo_console_get_stats(&before);
+  start = test_now();
+
+  test_isr_run = 1;
+  pthread_create(&test_isr_thread, NULL, test_isr_entry, NULL);
+  for (producer = 0U; producer < TEST_THREADS; producer++)
+  {
+    tx_thread_create(&test_producer[producer], "producer", test_producer_entry, producer,
+                     test_producer_stack[producer], TEST_STACK_SIZE, 10U, 10U, 1U, TX_AUTO_START);
+  }
+  for (producer = 0U; producer < TEST_THREADS; producer++)
+  {
+    tx_semaphore_get(&test_done, TX_WAIT_FOREVER);
+  }
+  test_isr_run = 0;
+  pthread_join(test_isr_thread, NULL);
+
+  while (meteo_console_pending() != 0U)
+  {
+    tx_thread_sleep(1U);
+  }
+  elapsed = test_now() - start;
+  for (producer = 0U; producer < TEST_THREADS; producer++)
+  {
+    tx_thread_delete(&test_producer[producer]);
+  }
+
+  meteo_console_get_stats(&after);
+  for (producer = 0U; producer < TEST_PRODUCERS; producer++)
+  {
+    offered += test_offered_bytes[producer];
+    accepted += test_accepted_bytes[producer];
+    offered_lines += test_offered[producer];
+    accepted_lines += test_accepted[producer];
+    write_s += test_write_s[producer];
+  }
+
+  test_verify(phase, policy == METEO_CONSOLE_BLOCK);
+  CHECK(after.bytes_written - before.bytes_written == accepted, "%s: %lu bytes written, %lu accepted",
+        phase, (unsigned long)(after.bytes_written - before.bytes_written), accepted);
+  CHECK(after.bytes_written - before.bytes_written + after.bytes_dropped - before.bytes_dropped == offered,
+        "%s: written + dropped %lu, offered %lu", phase,
+        (unsigned long)(after.bytes_written - before.bytes_written + after.bytes_dropped - before.bytes_dropped),
+        offered);
+  CHECK(after.writes_dropped - before.writes_dropped == offered_lines - accepted_lines,
+        "%s: %lu writes dropped, %lu lines not accepted", phase,
+        (unsigned long)(after.writes_dropped - before.writes_dropped), offered_lines - accepted_lines);
+  CHECK(test_captured == accepted, "%s: %zu bytes sent, %lu accepted", phase, test_captured, accepted);
+  CHECK(after.dma_errors == before.dma_errors, "%s: %lu DMA errors", phase,
+        (unsigned long)(after.dma_errors - before.dma_errors));
+  CHECK(after.high_water <= METEO_CONSOLE_RING_SIZE, "%s: ring peak %lu", phase, (unsigned long)after.high_water);
+  if (policy == METEO_CONSOLE_DROP)
+  {
+    CHECK(accepted_lines < offered_lines, "%s: nothing dropped, the ring never filled", phase);
+  }
+  else
+  {
+    for (producer = 0U; producer < TEST_THREADS; producer++)
+    {
+      CHECK(test_accepted[producer] == test_offered[producer], "%s: P%u dropped %lu lines", phase,
+            (unsigned)producer, test_offered[producer] - test_accepted[producer]);
+    }
+  }
+
+  printf("%s: %lu of %lu lines sent (interrupt %lu of %lu), %.0f lines/s, %.0f ns per write, "
+         "%lu waits, %lu DMA transfers, ring peak %lu\n",
+         phase, accepted_lines, offered_lines, test_accepted[TEST_ISR_PRODUCER], test_offered[TEST_ISR_PRODUCER],
+         (double)accepted_lines / elapsed, write_s / (double)offered_lines * 1e9,
+         (unsigned long)(after.blocked - before.blocked),
+         (unsigned long)(after.dma_transfers - before.dma_transfers), (unsigned long)after.high_water);
+}
+
+static void test_entry(ULONG input)
+{
+  (void)input;
+
+  test_phase("DROP", METEO_CONSOLE_DROP);
+  test_phase("BLOCK", METEO_CONSOLE_BLOCK);
+
+  printf("%s (%d failures)\n", (test_failures == 0) ? "PASSED" : "FAILED", test_failures);
+  exit(test_failures != 0);
+}
+
+void tx_application_define(void *first_unused_memory)
+{
+  (void)first_unused_memory;
+
+  meteo_console_init();
+  tx_semaphore_create(&test_done, "done", 0U);
+  pthread_create(&test_dma_thread, NULL, test_dma_entry, NULL);
+  tx_thread_create(&test_thread, "test", test_entry, 0U, test_stack, TEST_STACK_SIZE,
+                   5U, 5U, TX_NO_TIME_SLICE, TX_AUTO_START);
+}
+
+int main(int argc, char *argv[])
+{
+  int opt;
+
+  while ((opt = getopt(argc, argv, "n:b:")) != -1)
+  {
+    switch (opt)
+    {
+      case 'n':
+        test_lines = strtoul(optarg, NULL, 0);
+        break;
+      case 'b':
+        test_baud = strtoul(optarg, NULL, 0);
+        break;
+      default:
+        fprintf(stderr, "Usage: %s [-n lines] [-b baud]\n", argv[0]);
+        return 2;
+    }
+  }
+  if (test_baud == 0UL)
+  {
+    test_baud = 2000000UL;
+  }
+  test_byte_ns = 10000000000UL / test_baud;
+  test_capture = malloc(TEST_CAPTURE_SIZE);
+  if (test_capture == NULL)
+  {
+    return 2;
+  }
+
+  tx_kernel_enter();
+  return 0;
+}
@@ -0,0 +1,316 @@
+/**
+  ******************************************************************************
+  * @file    meteo_filter_test.c
+  * @brief   Checks and update cost of the sliding median and the spike
+  *          filter of meteo_filter.c, on the Linux port of ThreadX.
+  *
+  *          - meteo_median_t against a brute force median (sort of the
+  *            window) for windows of 1, 2, 3, 61 and 4095, 20000 values
+  *            with many repeats, while the window fills and after.
+  *          - meteo_filter_apply() on 100000 readings with a slow
+  *            temperature swing and noise: the temperature spikes (+-15 °C,
+  *            one in 500) are flagged and replaced by a value near the
+  *            true one, the noise is not flagged.
+  *          - A lasting step is taken once it fills half the window.
+  *          Then the ns per update of the median at W = 61, 1001 and 4095,
+  *          against a sorted array (O(W) insert and remove).
+  *
+  *          Build: TX=Middlewares/ST/threadx
+  *                 gcc -O2 -DTX_INCLUDE_USER_DEFINE_FILE -ICore/Host/Inc -ICore/Inc
+  *                     -I$TX/ports/linux/gnu/inc -I$TX/common/inc
+  *                     -I$TX/utility/execution_profile_kit -o meteo_filter_test
+  *                     Core/Host/Tools/meteo_filter_test.c Core/Src/meteo_filter.c
+  *                     <the ThreadX sources of the meteo_host build line in
+  *                     README.md> -lpthread -lm
+  *          Usage: meteo_filter_test
+  ******************************************************************************
+  */
+
+/* Includes ------------------------------------------------------------------*/
+#include <math.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+#include "tx_api.h"
+#include "meteo_filter.h"
+
+/* Private defines -----------------------------------------------------------*/
+#define TEST_WINDOW_MAX         4095U
+#define TEST_STACK_SIZE         16384U
+#define TEST_BENCH_UPDATES      2000000
+
+#define CHECK(cond, ...) \
+  do { if (!(cond)) { test_failures++; printf("  FAILED line %d: ", __LINE__); \
+       printf(__VA_ARGS__); printf("\n"); } } while (0)
+
+/* Private variables ---------------------------------------------------------*/
+static TX_THREAD test_thread;
+static UCHAR test_stack[TEST_STACK_SIZE];
+
+static float test_data[TEST_WINDOW_MAX];
+static int16_t test_pos[TEST_WINDOW_MAX];
+static uint16_t test_heap[TEST_WINDOW_MAX];
+
+/* Brute force and sorted array baselines */
+static float test_ring[TEST_WINDOW_MAX];
+static float test_sorted[TEST_WINDOW_MAX];
+
+static uint32_t test_seed = 1U;
+static int test_failures;
+
+/* Private functions ---------------------------------------------------------*/
+
+static double test_now(void)
+{
+  struct timespec now;
+
+  clock_gettime(CLOCK_MONOTONIC, &now);
+  return (double)now.tv_sec + (double)now.tv_nsec * 1e-9;
+}
+
+/* xorshift32, the generator of the simulator stations */
+static uint32_t test_random(void)
+{
+  test_seed ^= test_seed << 13;
+  test_seed ^= test_seed >> 17;
+  test_seed ^= test_seed << 5;
+  return test_seed;
+}
+
+static int test_compare(const void *a, const void *b)
+{
+  float x = *(const float *)a;
+  float y = *(const float *)b;
+
+  return (x > y) - (x < y);
+}
+
+static float test_brute_median(uint32_t count)
+{
+  memcpy(test_sorted, test_ring, count * sizeof(float));
+  qsort(test_sorted, count, sizeof(float), test_compare);
+  return (count & 1U) ? test_sorted[count / 2U]
+                      : (test_sorted[count / 2U - 1U] + test_sorted[count / 2U]) * 0.5f;
+}
+
+/* Sorted array of the window: find and remove the oldest, insert the new */
+static void test_sorted_add(uint32_t window, uint32_t *count, uint32_t *index, float value)
+{
+  uint32_t n = *count;
+  uint32_t i;
+
+  if (n == window)
+  {
+    for (i = 0U; i < n && test_sorted[i] != test_ring[*index]; i++)
+    {
+    }
+    memmove(&test_sorted[i], &test_sorted[i + 1U], (n - 1U - i) * sizeof(float));
+    n--;
+  }
+  for (i = n; i > 0U && test_sorted[i - 1U] > value; i--)
+  {
+    test_sorted[i] = test_sorted[i - 1U];
+  }
+  test_sorted[i] = value;
+  test_ring[*index] = value;
+  *index = (*index + 1U) % window;
+  *count = n + 1U;
+}
+
+static void test_median(void)
+{
+  static const uint32_t windows[] = { 1U, 2U, 3U, 61U, 4095U };
+  meteo_median_t median;
+  uint32_t count;
+  uint32_t index;
+  uint32_t w;
+  int errors = 0;
+  int k;
+
+  printf("median against brute force\n");
+  for (w = 0U; w < sizeof(windows) / sizeof(windows[0]); w++)
+  {
+    meteo_median_init(&median, test_data, test_pos, test_heap, windows[w]);
+    count = 0U;
+    index = 0U;
+    for (k = 0; k < 20000; k++)
+    {
+      // One value in 7 the same, to have ties
+      float value = (k % 7 == 0) ? 50.0f : (float)(test_random() % 1000U) / 10.0f;
+
+      meteo_median_add(&median, value);
+      test_ring[index] = value;
+      index = (index + 1U) % windows[w];
+      count += (count < windows[w]) ? 1U : 0U;
+
+      // Every value for the small windows, a sample of them for the large
+      if (windows[w] < 100U || k % 97 == 0)
+      {
+        float expected = test_brute_median(count);
+        float got = meteo_median_get(&median);
+
+        if (got != expected)
+        {
+          if (errors < 5)
+          {
+            printf("  W %lu value %d: %.2f, expected %.2f\n", (unsigned long)windows[w], k,
+                   (double)got, (double)expected);
+          }
+          errors++;
+        }
+      }
+    }
+  }
+  CHECK(errors == 0, "%d medians differ", errors);
+}
+
+static void test_spikes(void)
+{
+  meteo_filter_stats_t stats[METEO_ARCHIVE_CHANNELS];
+  int injected = 0;
+  int caught = 0;
+  int false_alarms = 0;
+  int far = 0;
+  uint32_t flags;
+  float values[METEO_ARCHIVE_CHANNELS];
+  float temperature;
+  int spike;
+  int k;
+
+  printf("spike filter\n");
+  for (k = 0; k < 100000; k++)
+  {
+    temperature = 20.0f + 5.0f * sinf((float)k / 3000.0f)
+                  + (float)((int)(test_random() % 100U) - 50) / 500.0f;
+    values[METEO_ARCHIVE_TEMPERATURE] = temperature;
+    values[METEO_ARCHIVE_PRESSURE] = 1013.0f + (float)((int)(test_random() % 100U) - 50) / 200.0f;
+    values[METEO_ARCHIVE_WIND_SPEED] = 5.0f + (float)(test_random() % 100U) / 50.0f;
+    values[METEO_ARCHIVE_WIND_DIRECTION] = (float)(test_random() % 360U);
+    values[METEO_ARCHIVE_VOLTAGE] = 12.0f;
+
+    spike = (k > 100 && test_random() % 500U == 0U);
+    if (spike)
+    {
+      values[METEO_ARCHIVE_TEMPERATURE] += (test_random() & 1U) ? 15.0f : -15.0f;
+      injected++;
+    }
+
+    flags = meteo_filter_apply(values);
+    if (flags & (1UL << METEO_ARCHIVE_TEMPERATURE))
+    {
+      caught += spike ? 1 : 0;
+      false_alarms += spike ? 0 : 1;
+      far += (fabsf(values[METEO_ARCHIVE_TEMPERATURE] - temperature) > 1.0f) ? 1 : 0;
+    }
+  }
+  meteo_filter_get_stats(stats);
+  printf("  %d spikes, %d caught, %d false alarms; flagged T %lu P %lu WS %lu WD %lu V %lu\n",
+         injected, caught, false_alarms, (unsigned long)stats[0].flagged,
+         (unsigned long)stats[1].flagged, (unsigned long)stats[2].flagged,
+         (unsigned long)stats[3].flagged, (unsigned long)stats[4].flagged);
+  CHECK(caught == injected, "%d of %d spikes missed", injected - caught, injected);
+  CHECK(false_alarms == 0, "%d temperatures flagged without a spike", false_alarms);
+  CHECK(far == 0, "%d replacements more than 1 degree off", far);
+  CHECK(stats[METEO_ARCHIVE_WIND_DIRECTION].flagged == 0U, "wind direction flagged");
+}
+
+static void test_step(void)
+{
+  float values[METEO_ARCHIVE_CHANNELS];
+  uint32_t flagged = 0U;
+  uint32_t flags;
+  int taken = -1;
+  int k;
+
+  // 100 readings at 10 fill the window whatever came before
+  printf("step of +10\n");
+  for (k = 0; k < 200; k++)
+  {
+    values[METEO_ARCHIVE_TEMPERATURE] = (k < 100) ? 10.0f : 20.0f;
+    values[METEO_ARCHIVE_PRESSURE] = 1000.0f;
+    values[METEO_ARCHIVE_WIND_SPEED] = 5.0f;
+    values[METEO_ARCHIVE_WIND_DIRECTION] = 0.0f;
+    values[METEO_ARCHIVE_VOLTAGE] = 12.0f;
+    flags = meteo_filter_apply(values);
+    flagged += (k >= 100 && (flags & (1UL << METEO_ARCHIVE_TEMPERATURE))) ? 1U : 0U;
+    if (taken < 0 && k >= 100 && values[METEO_ARCHIVE_TEMPERATURE] == 20.0f)
+    {
+      taken = k - 100;
+    }
+  }
+  printf("  flagged %lu times, taken after %d readings\n", (unsigned long)flagged, taken);
+  CHECK(taken >= 0 && taken <= (int)METEO_FILTER_WINDOW / 2 + 1, "step taken after %d readings", taken);
+}
+
+static void test_bench(void)
+{
+  static const uint32_t windows[] = { 61U, 1001U, 4095U };
+  meteo_median_t median;
+  float sink = 0.0f;
+  double start;
+  double heaps;
+  uint32_t count;
+  uint32_t index;
+  uint32_t w;
+  int k;
+
+  printf("ns per update\n");
+  for (w = 0U; w < sizeof(windows) / sizeof(windows[0]); w++)
+  {
+    meteo_median_init(&median, test_data, test_pos, test_heap, windows[w]);
+    start = test_now();
+    for (k = 0; k < TEST_BENCH_UPDATES; k++)
+    {
+      meteo_median_add(&median, (float)(test_random() % 10000U));
+      sink += meteo_median_get(&median);
+    }
+    heaps = test_now() - start;
+
+    count = 0U;
+    index = 0U;
+    start = test_now();
+    for (k = 0; k < TEST_BENCH_UPDATES; k++)
+    {
+      test_sorted_add(windows[w], &count, &index, (float)(test_random() % 10000U));
+      sink += test_sorted[count / 2U];
+    }
+    printf("  W %4lu: heaps %6.1f, sorted array %7.1f\n", (unsigned long)windows[w],
+           heaps / TEST_BENCH_UPDATES * 1e9, (test_now() - start) / TEST_BENCH_UPDATES * 1e9);
+  }
+  if (sink < 0.0f)
+  {
+    printf("  (sink)\n");
+  }
+}
+
+static void test_entry(ULONG input)
+{
+  (void)input;
+
+  // The spike and step checks run one after the other on the same windows
+  meteo_filter_init();
+  test_median();
+  test_spikes();
+  test_step();
+  test_bench();
+
+  printf("%s (%d failures)\n", test_failures ? "FAILED" : "PASSED", test_failures);
+  exit(test_failures != 0);
+}
+
+void tx_application_define(void *first_unused_memory)
+{
+  (void)first_unused_memory;
+
+  tx_thread_create(&test_thread, "test", test_entry, 0U, test_stack, TEST_STACK_SIZE,
+                   10U, 10U, TX_NO_TIME_SLICE, TX_AUTO_START);
+}
+
+int main(void)
+{
+  tx_kernel_enter();
+  return 0;
+}
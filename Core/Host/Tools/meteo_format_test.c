@@ -0,0 +1,405 @@
+/**
+  ******************************************************************************
+  * @file    meteo_format_test.c
+  * @brief   Checks of the fixed-point formatting (meteo_format.c) against
+  *          snprintf and gmtime_r, and the time of both.
+  *
+  *          - meteo_format_uint/int/fixed(): every value of -200000..200000
+  *            and a million random ones with the ends of int32, at 0..6
+  *            decimals, the same text as snprintf of the integer parts.
+  *          - meteo_format_float(): readings k/10^d (d = 1..3) exactly as
+  *            printf gives them, negative ones included; exact binary
+  *            halves rounded away from zero; random floats at most one in
+  *            the last digit from printf; nan, inf and negative zero.
+  *          - meteo_format_iso8601(): random times from year 1 to 9999 as
+  *            gmtime_r gives them, at 0, 3 and 6 decimals (truncated), and
+  *            the ends of int64.
+  *          - Each function returns 0 when the text is one byte too long.
+  *          Then the ns per call, against snprintf.
+  *
+  *          Build: gcc -O2 -ICore/Inc -o meteo_format_test
+  *                     Core/Host/Tools/meteo_format_test.c Core/Src/meteo_format.c -lm
+  *          Usage: meteo_format_test
+  ******************************************************************************
+  */
+
+/* Includes ------------------------------------------------------------------*/
+#include <math.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+#include "meteo_format.h"
+
+/* Private defines -----------------------------------------------------------*/
+#define TEST_RANDOM             1000000L
+#define TEST_BENCH_CALLS        2000000L
+#define TEST_TEXT_SIZE          64U
+
+/* 0001-01-01 and 9999-12-31T23:59:59 in seconds since 1970 */
+#define TEST_YEAR1_SECONDS      (-62135596800LL)
+#define TEST_YEAR9999_SECONDS   253402300799LL
+
+#define CHECK(cond, ...) \
+  do { if (!(cond)) { if (test_failures++ < 20) { printf("  FAILED line %d: ", __LINE__); \
+       printf(__VA_ARGS__); printf("\n"); } } } while (0)
+
+/* Private variables ---------------------------------------------------------*/
+static uint32_t test_rng = 0x2545F491UL;
+static int test_failures;
+
+static const uint32_t test_pow10[METEO_FORMAT_DECIMALS_MAX + 1U] =
+{
+  1UL, 10UL, 100UL, 1000UL, 10000UL, 100000UL, 1000000UL
+};
+
+/* Private functions ---------------------------------------------------------*/
+
+static double test_now(void)
+{
+  struct timespec now;
+
+  clock_gettime(CLOCK_MONOTONIC, &now);
+  return (double)now.tv_sec + (double)now.tv_nsec * 1e-9;
+}
+
+static uint32_t test_random(void)
+{
+  test_rng ^= test_rng << 13;
+  test_rng ^= test_rng >> 17;
+  test_rng ^= test_rng << 5;
+  return test_rng;
+}
+
+static uint64_t test_random64(void)
+{
+  return ((uint64_t)test_random() << 32) | test_random();
+}
+
+/* The text at out must be expected, and one byte less must not fit */
+static int test_same(char *out, uint32_t length, const char *expected)
+{
+  out[(length < TEST_TEXT_SIZE) ? length : TEST_TEXT_SIZE - 1U] = '\0';
+  return length == strlen(expected) && strcmp(out, expected) == 0;
+}
+
+/* snprintf of the whole part and the decimals of value / 10^decimals */
+static void test_fixed_expected(char *text, int32_t value, uint32_t decimals)
+{
+  int64_t magnitude = (value < 0) ? -(int64_t)value : (int64_t)value;
+
+  if (decimals == 0U)
+  {
+    snprintf(text, TEST_TEXT_SIZE, "%ld", (long)value);
+    return;
+  }
+  snprintf(text, TEST_TEXT_SIZE, "%s%lld.%0*lld", (value < 0) ? "-" : "",
+           (long long)(magnitude / test_pow10[decimals]), (int)decimals,
+           (long long)(magnitude % test_pow10[decimals]));
+}
+
+static void test_fixed_one(int32_t value, uint32_t decimals)
+{
+  char out[TEST_TEXT_SIZE];
+  char expected[TEST_TEXT_SIZE];
+  uint32_t length;
+
+  test_fixed_expected(expected, value, decimals);
+  length = meteo_format_fixed(out, TEST_TEXT_SIZE, value, decimals);
+  CHECK(test_same(out, length, expected), "fixed(%ld, %lu): \"%s\", expected \"%s\"", (long)value,
+        (unsigned long)decimals, out, expected);
+  CHECK(meteo_format_fixed(out, (uint32_t)strlen(expected) - 1U, value, decimals) == 0U,
+        "fixed(%ld, %lu) fits one byte less", (long)value, (unsigned long)decimals);
+}
+
+static void test_integers(void)
+{
+  static const int32_t ends[] = { 0, 1, -1, 9, 10, -10, 99, 100, INT32_MAX, INT32_MIN, INT32_MIN + 1 };
+  char out[TEST_TEXT_SIZE];
+  char expected[TEST_TEXT_SIZE];
+  uint32_t decimals;
+  uint32_t value;
+  uint32_t length;
+  uint32_t i;
+  long n;
+
+  printf("uint, int, fixed\n");
+  for (decimals = 0U; decimals <= METEO_FORMAT_DECIMALS_MAX; decimals++)
+  {
+    for (n = -200000L; n <= 200000L; n++)
+    {
+      test_fixed_one((int32_t)n, decimals);
+    }
+    for (i = 0U; i < sizeof(ends) / sizeof(ends[0]); i++)
+    {
+      test_fixed_one(ends[i], decimals);
+    }
+  }
+  for (n = 0; n < TEST_RANDOM; n++)
+  {
+    // All magnitudes, not only the large ones
+    value = test_random() >> (test_random() % 32U);
+    test_fixed_one((test_random() & 1U) ? (int32_t)value : -(int32_t)(value >> 1), test_random() % 7U);
+
+    snprintf(expected, sizeof(expected), "%lu", (unsigned long)value);
+    length = meteo_format_uint(out, TEST_TEXT_SIZE, value);
+    CHECK(test_same(out, length, expected), "uint(%lu): \"%s\"", (unsigned long)value, out);
+    snprintf(expected, sizeof(expected), "%ld", (long)(int32_t)value);
+    length = meteo_format_int(out, TEST_TEXT_SIZE, (int32_t)value);
+    CHECK(test_same(out, length, expected), "int(%ld): \"%s\"", (long)(int32_t)value, out);
+  }
+  CHECK(meteo_format_fixed(out, TEST_TEXT_SIZE, 1, METEO_FORMAT_DECIMALS_MAX + 1U) == 0U, "7 decimals");
+}
+
+static void test_float_one(float value, uint32_t decimals, const char *expected)
+{
+  char out[TEST_TEXT_SIZE];
+  uint32_t length = meteo_format_float(out, TEST_TEXT_SIZE, value, decimals);
+
+  CHECK(test_same(out, length, expected), "float(%.9g, %lu): \"%s\", expected \"%s\"", (double)value,
+        (unsigned long)decimals, out, expected);
+  CHECK(meteo_format_float(out, (uint32_t)strlen(expected) - 1U, value, decimals) == 0U,
+        "float(%.9g, %lu) fits one byte less", (double)value, (unsigned long)decimals);
+}
+
+static void test_floats(void)
+{
+  char out[TEST_TEXT_SIZE];
+  char expected[TEST_TEXT_SIZE];
+  uint32_t decimals;
+  uint32_t length;
+  uint32_t off = 0U;
+  uint32_t minus_zero = 0U;
+  double step;
+  float value;
+  long n;
+
+  // What the DB thread formats: integer readings over their scale
+  printf("float\n");
+  for (decimals = 1U; decimals <= 3U; decimals++)
+  {
+    for (n = -300000L; n <= 300000L; n++)
+    {
+      value = (float)n / (float)test_pow10[decimals];
+      snprintf(expected, sizeof(expected), "%.*f", (int)decimals, (double)value);
+      test_float_one(value, decimals, expected);
+    }
+  }
+
+  // Exact halves: away from zero, where printf rounds to even
+  test_float_one(0.5f, 0U, "1");
+  test_float_one(2.5f, 0U, "3");
+  test_float_one(-2.5f, 0U, "-3");
+  test_float_one(0.125f, 2U, "0.13");
+  test_float_one(-0.125f, 2U, "-0.13");
+  test_float_one(1.0625f, 3U, "1.063");
+
+  // No negative zero, which printf writes
+  test_float_one(-0.001f, 2U, "0.00");
+  test_float_one(-0.0f, 1U, "0.0");
+  test_float_one(NAN, 2U, "nan");
+  test_float_one(INFINITY, 2U, "inf");
+  test_float_one(-INFINITY, 2U, "-inf");
+  test_float_one(2147483648.0f, 0U, "inf");
+  test_float_one(-3e9f, 1U, "-inf");
+  test_float_one(2147483520.0f, 0U, "2147483520");
+
+  // Anything else: the fraction is scaled as a float, so the last digit may
+  // be one off where it is within float rounding of a half
+  for (n = 0; n < TEST_RANDOM; n++)
+  {
+    decimals = test_random() % (METEO_FORMAT_DECIMALS_MAX + 1U);
+    value = (float)(test_random() % 2000000U) / (float)(1U + test_random() % 1000U);
+    value = (test_random() & 1U) ? -value : value;
+    length = meteo_format_float(out, TEST_TEXT_SIZE, value, decimals);
+    out[length] = '\0';
+    snprintf(expected, sizeof(expected), "%.*f", (int)decimals, (double)value);
+    if (strcmp(out, expected) == 0)
+    {
+      continue;
+    }
+    if (strcmp(expected, (decimals == 0U) ? "-0" : "-0.000000") == 0 ||
+        (expected[0] == '-' && strcmp(out, expected + 1) == 0 && strtod(out, NULL) == 0.0))
+    {
+      minus_zero++;
+      continue;
+    }
+    off++;
+    step = fabs(strtod(out, NULL) - strtod(expected, NULL)) * (double)test_pow10[decimals];
+    CHECK(step < 1.001, "float(%.9g, %lu): \"%s\", printf \"%s\"", (double)value, (unsigned long)decimals,
+          out, expected);
+  }
+  printf("  %ld random floats: %lu one off in the last digit, %lu negative zeros\n", TEST_RANDOM,
+         (unsigned long)off, (unsigned long)minus_zero);
+}
+
+/* What gmtime_r and snprintf give */
+static void test_iso8601_expected(char *text, int64_t usec, uint32_t decimals)
+{
+  int64_t seconds = usec / 1000000LL;
+  int64_t fraction = usec % 1000000LL;
+  time_t t;
+  struct tm tm;
+  int n;
+
+  if (fraction < 0)
+  {
+    seconds--;
+    fraction += 1000000LL;
+  }
+  t = (time_t)seconds;
+  gmtime_r(&t, &tm);
+  n = snprintf(text, TEST_TEXT_SIZE, "%04d-%02d-%02dT%02d:%02d:%02d", tm.tm_year + 1900, tm.tm_mon + 1,
+               tm.tm_mday, tm.tm_hour, tm.tm_min, tm.tm_sec);
+  if (decimals != 0U)
+  {
+    n += snprintf(text + n, TEST_TEXT_SIZE - (uint32_t)n, ".%0*lld", (int)decimals,
+                  (long long)(fraction / test_pow10[METEO_FORMAT_DECIMALS_MAX - decimals]));
+  }
+  snprintf(text + n, TEST_TEXT_SIZE - (uint32_t)n, "Z");
+}
+
+static void test_iso8601_one(int64_t usec, uint32_t decimals, const char *expected)
+{
+  char out[TEST_TEXT_SIZE];
+  uint32_t length = meteo_format_iso8601(out, TEST_TEXT_SIZE, usec, decimals);
+
+  CHECK(test_same(out, length, expected), "iso8601(%lld, %lu): \"%s\", expected \"%s\"", (long long)usec,
+        (unsigned long)decimals, out, expected);
+  CHECK(meteo_format_iso8601(out, (uint32_t)strlen(expected) - 1U, usec, decimals) == 0U,
+        "iso8601(%lld, %lu) fits one byte less", (long long)usec, (unsigned long)decimals);
+}
+
+static void test_iso8601(void)
+{
+  static const uint32_t decimals[] = { 0U, 3U, 6U };
+  char expected[TEST_TEXT_SIZE];
+  char out[TEST_TEXT_SIZE];
+  uint64_t span = (uint64_t)(TEST_YEAR9999_SECONDS - TEST_YEAR1_SECONDS) * 1000000ULL;
+  int64_t usec;
+  long n;
+
+  printf("iso8601\n");
+  test_iso8601_one(0, 0U, "1970-01-01T00:00:00Z");
+  test_iso8601_one(-1, 3U, "1969-12-31T23:59:59.999Z");
+  test_iso8601_one(1792398600250000LL, 3U, "2026-10-19T08:30:00.250Z");
+  test_iso8601_one(951782400000000LL, 0U, "2000-02-29T00:00:00Z");
+  test_iso8601_one(4107542400000000LL, 0U, "2100-03-01T00:00:00Z");
+  test_iso8601_one(1999999LL, 6U, "1970-01-01T00:00:01.999999Z");
+  test_iso8601_one(INT64_MAX, 6U, "+294247-01-10T04:00:54.775807Z");
+  test_iso8601_one(INT64_MIN, 6U, "-290308-12-21T19:59:05.224192Z");
+  CHECK(strlen("-290308-12-21T19:59:05.224192Z") <= METEO_FORMAT_ISO8601_MAX, "METEO_FORMAT_ISO8601_MAX");
+  CHECK(meteo_format_iso8601(out, TEST_TEXT_SIZE, 0, 2U) == 0U, "2 decimals");
+
+  for (n = 0; n < TEST_RANDOM; n++)
+  {
+    usec = TEST_YEAR1_SECONDS * 1000000LL + (int64_t)(test_random64() % span);
+    test_iso8601_expected(expected, usec, decimals[n % 3]);
+    test_iso8601_one(usec, decimals[n % 3], expected);
+  }
+  printf("  %ld random times, years 1..9999\n", TEST_RANDOM);
+}
+
+static void test_bench(void)
+{
+  meteo_format_writer_t writer;
+  char buffer[256];
+  char out[TEST_TEXT_SIZE];
+  struct tm tm;
+  time_t t;
+  double start;
+  double ns[2];
+  uint32_t sink = 0U;
+  int64_t usec;
+  float value;
+  long whole;
+  long i;
+
+  printf("ns per call     meteo_format  snprintf\n");
+  start = test_now();
+  for (i = 0; i < TEST_BENCH_CALLS; i++)
+  {
+    sink += meteo_format_fixed(out, sizeof(out), (int32_t)(i % 6000L) - 1000, 2U);
+  }
+  ns[0] = (test_now() - start) / (double)TEST_BENCH_CALLS * 1e9;
+  start = test_now();
+  for (i = 0; i < TEST_BENCH_CALLS; i++)
+  {
+    whole = (i % 6000L) - 1000L;
+    sink += (uint32_t)snprintf(out, sizeof(out), "%s%ld.%02ld", (whole < 0L) ? "-" : "", labs(whole) / 100L,
+                               labs(whole) % 100L);
+  }
+  ns[1] = (test_now() - start) / (double)TEST_BENCH_CALLS * 1e9;
+  printf("  fixed 2       %9.1f %9.1f (\"%%ld.%%02ld\")\n", ns[0], ns[1]);
+
+  start = test_now();
+  for (i = 0; i < TEST_BENCH_CALLS; i++)
+  {
+    sink += meteo_format_float(out, sizeof(out), (float)(i % 6000L) * 0.01f - 10.0f, 2U);
+  }
+  ns[0] = (test_now() - start) / (double)TEST_BENCH_CALLS * 1e9;
+  start = test_now();
+  for (i = 0; i < TEST_BENCH_CALLS; i++)
+  {
+    sink += (uint32_t)snprintf(out, sizeof(out), "%.2f", (double)((float)(i % 6000L) * 0.01f - 10.0f));
+  }
+  ns[1] = (test_now() - start) / (double)TEST_BENCH_CALLS * 1e9;
+  printf("  float %%.2f    %9.1f %9.1f\n", ns[0], ns[1]);
+
+  start = test_now();
+  for (i = 0; i < TEST_BENCH_CALLS; i++)
+  {
+    sink += meteo_format_iso8601(out, sizeof(out), 1792398600250000LL + (int64_t)i * 1000000, 3U);
+  }
+  ns[0] = (test_now() - start) / (double)TEST_BENCH_CALLS * 1e9;
+  start = test_now();
+  for (i = 0; i < TEST_BENCH_CALLS; i++)
+  {
+    usec = 1792398600250000LL + (int64_t)i * 1000000;
+    t = (time_t)(usec / 1000000);
+    gmtime_r(&t, &tm);
+    sink += (uint32_t)snprintf(out, sizeof(out), "%04d-%02d-%02dT%02d:%02d:%02d.%03dZ", tm.tm_year + 1900,
+                               tm.tm_mon + 1, tm.tm_mday, tm.tm_hour, tm.tm_min, tm.tm_sec,
+                               (int)(usec % 1000000) / 1000);
+  }
+  ns[1] = (test_now() - start) / (double)TEST_BENCH_CALLS * 1e9;
+  printf("  ISO-8601 ms   %9.1f %9.1f (gmtime_r)\n", ns[0], ns[1]);
+
+  // An export row: seconds and the five channels
+  start = test_now();
+  for (i = 0; i < TEST_BENCH_CALLS; i++)
+  {
+    value = (float)(i % 6000L) * 0.01f - 10.0f;
+    meteo_format_writer_init(&writer, buffer, sizeof(buffer), METEO_FORMAT_CSV);
+    meteo_format_field_seconds(&writer, "ts", (int64_t)i * 1000000, 3U);
+    meteo_format_field_float(&writer, "temperature", value, 2U);
+    meteo_format_field_float(&writer, "pressure", 1013.2f, 1U);
+    meteo_format_field_float(&writer, "wind_speed", 3.5f, 1U);
+    meteo_format_field_float(&writer, "wind_direction", 270.4f, 1U);
+    meteo_format_field_float(&writer, "voltage", 115.0f, 0U);
+    sink += meteo_format_row_end(&writer);
+  }
+  ns[0] = (test_now() - start) / (double)TEST_BENCH_CALLS * 1e9;
+  start = test_now();
+  for (i = 0; i < TEST_BENCH_CALLS; i++)
+  {
+    value = (float)(i % 6000L) * 0.01f - 10.0f;
+    sink += (uint32_t)snprintf(buffer, sizeof(buffer), "%.3f,%.2f,%.1f,%.1f,%.1f,%.0f\n", (double)i,
+                               (double)value, (double)1013.2f, (double)3.5f, (double)270.4f, (double)115.0f);
+  }
+  ns[1] = (test_now() - start) / (double)TEST_BENCH_CALLS * 1e9;
+  printf("  CSV row       %9.1f %9.1f (%lu)\n", ns[0], ns[1], (unsigned long)(sink % 10U));
+}
+
+int main(void)
+{
+  test_integers();
+  test_floats();
+  test_iso8601();
+  test_bench();
+
+  printf("%s (%d failures)\n", test_failures ? "FAILED" : "PASSED", test_failures);
+  return test_failures != 0;
+}
@@ -0,0 +1,468 @@
+/**
+  ******************************************************************************
+  * @file    meteo_journal_test.c
+  * @brief   Power-loss checks of the frame journal (meteo_journal.c) on the
+  *          emulated OSPI flash of the Linux host.
+  *
+  *          Restarts, each after a random number of frames (1-3000): the
+  *          journal is opened again as after a reset, and the writer goes
+  *          round the ring of 62 blocks more than twice with the default
+  *          200. Before a restart, at random, power is lost:
+  *          - in the middle of a record: the first 1-7 words of the next
+  *            record are written, not the CRC. At the start of a block
+  *            the block was erased first, and the records it held are
+  *            skipped by readers once the open has found the block unused;
+  *          - in the middle of an ack entry: the seq is written, not the
+  *            check word.
+  *          After every open:
+  *          - head and oldest are where the frames put them. A torn record
+  *            keeps its slot; one torn at the start of a block leaves the
+  *            block looking unused, and the next frame takes the slot;
+  *          - the start-up count is one more than before;
+  *          - the acknowledged position is at most 63 records behind the
+  *            last ack (METEO_JOURNAL_ACK_EVERY), never past it, and a
+  *            torn ack entry is ignored;
+  *          - a cursor from there reads every record still on flash, in
+  *            seq order, with the fields of its frame, skipping only the
+  *            torn ones (counted as bad);
+  *          - the open took at most 64 flash reads.
+  *          One round in 8 acknowledges nothing. Then power is lost in the
+  *          first record of a block on a later lap, and last the writer
+  *          goes a lap and two blocks with no reader: the frames erased
+  *          unsent must be counted as lost, and the open must find the
+  *          rest.
+  *
+  *          Build: TX=Middlewares/ST/threadx
+  *                 gcc -O2 -DTX_INCLUDE_USER_DEFINE_FILE -ICore/Host/Inc -ICore/Inc
+  *                     -I$TX/ports/linux/gnu/inc -I$TX/common/inc
+  *                     -I$TX/utility/execution_profile_kit -o meteo_journal_test
+  *                     Core/Host/Tools/meteo_journal_test.c Core/Src/meteo_journal.c
+  *                     Core/Src/meteo_ospi.c Core/Src/meteo_trace.c Core/Host/Src/host_ospi.c
+  *                     <the ThreadX sources of the meteo_host build line in
+  *                     README.md> -lpthread
+  *          Usage: meteo_journal_test [-r restarts] [image] > journal.log
+  *            -r     restarts (default 200)
+  *            image  flash file, created again (default meteo_journal_test.bin)
+  *          Each open prints a [JOURNAL] line; the results are the lines
+  *          that do not start with '['.
+  ******************************************************************************
+  */
+
+/* Includes ------------------------------------------------------------------*/
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+
+#include "tx_api.h"
+#include "lx_stm32_ospi_driver.h"
+#include "meteo_console.h"
+#include "meteo_journal.h"
+#include "meteo_ospi.h"
+
+/* Private defines -----------------------------------------------------------*/
+#define TEST_STACK_SIZE         16384U
+#define TEST_BLOCK_SIZE         65536U
+#define TEST_PER_BLOCK          (TEST_BLOCK_SIZE / sizeof(meteo_journal_record_t))
+#define TEST_DATA_BLOCKS        (METEO_JOURNAL_BLOCKS - METEO_JOURNAL_ACK_BLOCKS)
+#define TEST_SEQ_MAX            (1UL << 21)
+#define TEST_READ_BATCH         32U
+#define TEST_MAX_OPEN_READS     64U
+
+#define CHECK(cond, ...) \
+  do { if (!(cond)) { if (test_failures++ < 20) { printf("  FAILED line %d: ", __LINE__); \
+       printf(__VA_ARGS__); printf("\n"); } } } while (0)
+
+/* Private variables ---------------------------------------------------------*/
+static TX_THREAD test_thread;
+static UCHAR test_stack[TEST_STACK_SIZE];
+
+static meteo_journal_record_t test_records[TEST_READ_BATCH];
+static uint8_t test_torn[TEST_SEQ_MAX];
+static ULONG test_base;
+
+/* What the journal should hold */
+static uint32_t test_head;
+static uint32_t test_acked;
+static uint16_t test_boot;
+
+static uint32_t test_tick;
+static uint32_t test_seed = 0x1F2E3D4CUL;
+static long test_restarts = 200L;
+static uint32_t test_torn_records;
+static uint32_t test_torn_acks;
+static uint32_t test_max_reads;
+static int test_failures;
+
+/* Private functions ---------------------------------------------------------*/
+
+/* time_ms of the records, a second a frame */
+uint32_t HAL_GetTick(void)
+{
+  return test_tick;
+}
+
+/* meteo_trace.c sets it around a dump; no console here */
+meteo_console_overflow_t meteo_console_set_overflow(meteo_console_overflow_t policy)
+{
+  return policy;
+}
+
+static uint32_t test_random(void)
+{
+  test_seed ^= test_seed << 13;
+  test_seed ^= test_seed >> 17;
+  test_seed ^= test_seed << 5;
+  return test_seed;
+}
+
+static meteo_journal_stats_t test_stats(void)
+{
+  meteo_journal_stats_t stats;
+
+  meteo_journal_get_stats(&stats);
+  return stats;
+}
+
+/* Oldest seq once the block of the last record was entered */
+static uint32_t test_oldest(uint32_t head)
+{
+  uint32_t first = (head == 0U) ? 0U : ((head - 1U) / TEST_PER_BLOCK) * TEST_PER_BLOCK;
+
+  return (first > (TEST_DATA_BLOCKS - 1U) * TEST_PER_BLOCK) ?
+         first - (TEST_DATA_BLOCKS - 1U) * TEST_PER_BLOCK : 0U;
+}
+
+/* The frame fields of seq, as the record must hold them */
+static void test_fields(uint32_t seq, meteo_journal_record_t *record)
+{
+  record->temp = seq % 100000U;
+  record->pressure = (seq * 7U) % 100000U;
+  record->wind_dir = (uint16_t)(seq % 3600U);
+  record->wind_speed = (seq / 3U) % 100000U;
+  record->voltage = (uint16_t)(seq % 1000U);
+}
+
+static void test_append(uint32_t count)
+{
+  meteo_journal_record_t fields;
+  char frame[64];
+
+  while (count-- > 0U)
+  {
+    test_fields(test_head, &fields);
+    snprintf(frame, sizeof(frame), "UUU$%05lu.%05lu.%04u.%05lu.%03u.ABCD*QQQ",
+             (unsigned long)fields.temp, (unsigned long)fields.pressure, (unsigned)fields.wind_dir,
+             (unsigned long)fields.wind_speed, (unsigned)fields.voltage);
+    test_tick += 1000U;
+    CHECK(meteo_journal_append_frame(frame) == TX_SUCCESS, "append of seq %lu", (unsigned long)test_head);
+    test_torn[test_head % TEST_SEQ_MAX] = 0U;
+    test_head++;
+  }
+}
+
+/* Power lost after the first words of the next record */
+static void test_tear_record(void)
+{
+  meteo_journal_record_t record;
+  uint32_t slot = test_head % (TEST_DATA_BLOCKS * TEST_PER_BLOCK);
+  ULONG words = 1U + test_random() % 7U;
+  uint32_t i;
+  ULONG address = test_base + (slot / TEST_PER_BLOCK) * TEST_BLOCK_SIZE +
+                  (slot % TEST_PER_BLOCK) * sizeof(meteo_journal_record_t);
+
+  memset(&record, 0, sizeof(record));
+  record.seq = test_head;
+  record.time_ms = test_tick;
+  test_fields(test_head, &record);
+  record.boot = test_boot;
+
+  meteo_ospi_lock();
+  if ((slot % TEST_PER_BLOCK) == 0U)
+  {
+    // The writer erases a block on entering it; the open still counts
+    // the records that were there, readers skip them
+    meteo_ospi_erase_block(address / TEST_BLOCK_SIZE);
+    for (i = 0U; test_head >= TEST_DATA_BLOCKS * TEST_PER_BLOCK && i < TEST_PER_BLOCK; i++)
+    {
+      test_torn[(test_head - TEST_DATA_BLOCKS * TEST_PER_BLOCK + i) % TEST_SEQ_MAX] = 1U;
+    }
+  }
+  meteo_ospi_write(address, &record, words * sizeof(ULONG));
+  meteo_ospi_unlock();
+
+  test_torn[test_head % TEST_SEQ_MAX] = 1U;
+  test_torn_records++;
+
+  // At the start of a block the slot is found unused and written again
+  if ((slot % TEST_PER_BLOCK) != 0U)
+  {
+    test_head++;
+  }
+}
+
+/* Power lost between the two words of the next ack entry */
+static void test_tear_ack(void)
+{
+  ULONG entry[2];
+  ULONG ack_base = test_base + TEST_DATA_BLOCKS * TEST_BLOCK_SIZE;
+  ULONG address = 0U;
+  ULONG best = 0U;
+  ULONG block;
+  ULONG offset;
+  ULONG bogus = test_head + 1000U;
+
+  // The first erased entry after the newest valid one
+  meteo_ospi_lock();
+  for (block = 0U; block < METEO_JOURNAL_ACK_BLOCKS; block++)
+  {
+    for (offset = 0U; offset < TEST_BLOCK_SIZE; offset += sizeof(entry))
+    {
+      meteo_ospi_read(ack_base + block * TEST_BLOCK_SIZE + offset, entry, sizeof(entry));
+      if (entry[0] == 0xFFFFFFFFUL && entry[1] == 0xFFFFFFFFUL)
+      {
+        if (offset > 0U)
+        {
+          meteo_ospi_read(ack_base + block * TEST_BLOCK_SIZE + offset - sizeof(entry), entry, sizeof(entry));
+          if ((entry[0] ^ entry[1]) == 0xFFFFFFFFUL && entry[0] >= best)
+          {
+            best = entry[0];
+            address = ack_base + block * TEST_BLOCK_SIZE + offset;
+          }
+        }
+        break;
+      }
+    }
+  }
+  if (address != 0U)
+  {
+    meteo_ospi_write(address, &bogus, sizeof(bogus));
+    test_torn_acks++;
+  }
+  meteo_ospi_unlock();
+}
+
+/* Open again, as after a reset */
+static void test_reopen(void)
+{
+  meteo_journal_stats_t stats;
+  uint32_t oldest = test_oldest(test_head);
+  uint32_t acked = (test_acked > oldest) ? test_acked : oldest;
+
+  test_tick = 0U;
+  CHECK(meteo_journal_open() == TX_SUCCESS, "open");
+  stats = test_stats();
+  CHECK(stats.head == test_head && stats.oldest == oldest, "head %lu oldest %lu, expected %lu %lu",
+        (unsigned long)stats.head, (unsigned long)stats.oldest, (unsigned long)test_head,
+        (unsigned long)oldest);
+  CHECK(test_head == 0U || stats.boot == (uint16_t)(test_boot + 1U), "boot %u after %u",
+        (unsigned)stats.boot, (unsigned)test_boot);
+  CHECK(stats.acked <= acked && stats.acked + METEO_JOURNAL_ACK_EVERY > acked,
+        "acked %lu, last ack %lu", (unsigned long)stats.acked, (unsigned long)acked);
+  CHECK(stats.open_reads <= TEST_MAX_OPEN_READS, "%lu reads to open", (unsigned long)stats.open_reads);
+  test_max_reads = (stats.open_reads > test_max_reads) ? stats.open_reads : test_max_reads;
+  test_boot = stats.boot;
+  test_acked = stats.acked;
+}
+
+/* Read from the acknowledged position to the head */
+static void test_read_all(uint32_t *read_records, uint32_t *skipped)
+{
+  meteo_journal_record_t expected;
+  meteo_journal_cursor_t cursor;
+  meteo_journal_stats_t before = test_stats();
+  uint32_t next;
+  uint32_t seq;
+  uint32_t torn = 0U;
+  UINT count;
+  UINT i;
+
+  meteo_journal_cursor_init(&cursor);
+  CHECK(cursor.next == before.acked, "cursor at %lu, acked %lu", (unsigned long)cursor.next,
+        (unsigned long)before.acked);
+  next = cursor.next;
+  *read_records = 0U;
+  for (seq = cursor.next; seq < before.head; seq++)
+  {
+    torn += test_torn[seq % TEST_SEQ_MAX];
+  }
+
+  while (cursor.next < before.head)
+  {
+    CHECK(meteo_journal_read(&cursor, test_records, TEST_READ_BATCH, &count) == TX_SUCCESS, "read");
+    for (i = 0U; i < count; i++)
+    {
+      while (next < test_records[i].seq)
+      {
+        CHECK(test_torn[next % TEST_SEQ_MAX], "seq %lu missing", (unsigned long)next);
+        next++;
+      }
+      CHECK(test_records[i].seq == next, "seq %lu, expected %lu", (unsigned long)test_records[i].seq,
+            (unsigned long)next);
+      test_fields(test_records[i].seq, &expected);
+      CHECK(test_records[i].temp == expected.temp && test_records[i].pressure == expected.pressure &&
+            test_records[i].wind_dir == expected.wind_dir && test_records[i].wind_speed == expected.wind_speed &&
+            test_records[i].voltage == expected.voltage, "seq %lu: fields", (unsigned long)test_records[i].seq);
+      CHECK(!test_torn[test_records[i].seq % TEST_SEQ_MAX], "torn seq %lu read", (unsigned long)test_records[i].seq);
+      next = test_records[i].seq + 1U;
+    }
+    *read_records += count;
+  }
+
+  *skipped = test_stats().bad - before.bad;
+  CHECK(*skipped == torn, "%lu bad, %lu torn", (unsigned long)*skipped, (unsigned long)torn);
+}
+
+static void test_entry(ULONG input)
+{
+  meteo_journal_stats_t stats;
+  ULONG block_size;
+  ULONG total_blocks;
+  uint32_t read_records;
+  uint32_t skipped;
+  uint32_t total_read = 0U;
+  uint32_t total_skipped = 0U;
+  uint32_t lost;
+  uint32_t oldest;
+  uint32_t acked;
+  uint32_t lost_before;
+  long restart;
+
+  (void)input;
+
+  meteo_ospi_get_info(&block_size, &total_blocks);
+  CHECK(block_size == TEST_BLOCK_SIZE, "block size %lu", (unsigned long)block_size);
+  test_base = (total_blocks - METEO_JOURNAL_BLOCKS) * block_size;
+
+  printf("restarts\n");
+  test_reopen();
+  CHECK(test_stats().head == 0U, "fresh flash: head %lu", (unsigned long)test_stats().head);
+  for (restart = 0; restart < test_restarts; restart++)
+  {
+    lost_before = test_stats().lost;
+    oldest = test_oldest(test_head);
+    acked = (test_acked > oldest) ? test_acked : oldest;
+
+    test_append(1U + test_random() % 3000U);
+
+    // The records erased before they were acknowledged
+    oldest = test_oldest(test_head);
+    if (acked < oldest)
+    {
+      CHECK(test_stats().lost - lost_before == oldest - acked, "lost %lu, expected %lu",
+            (unsigned long)(test_stats().lost - lost_before), (unsigned long)(oldest - acked));
+    }
+
+    // One round in 8 acknowledges nothing, so the writer laps the reader
+    if ((test_random() % 8U) != 0U)
+    {
+      test_read_all(&read_records, &skipped);
+      total_read += read_records;
+      total_skipped += skipped;
+      test_acked = test_head - test_random() % 100U;
+      if (test_acked < test_stats().acked)
+      {
+        test_acked = test_stats().acked;
+      }
+      CHECK(meteo_journal_ack(test_acked) == TX_SUCCESS, "ack %lu", (unsigned long)test_acked);
+    }
+    if ((test_random() % 4U) == 0U)
+    {
+      test_tear_record();
+    }
+    if ((test_random() % 8U) == 0U)
+    {
+      test_tear_ack();
+    }
+    test_reopen();
+  }
+
+  stats = test_stats();
+  printf("  %ld restarts: head %lu (%.2f laps), oldest %lu, boot %u\n", test_restarts,
+         (unsigned long)stats.head, (double)stats.head / (double)stats.capacity,
+         (unsigned long)stats.oldest, (unsigned)stats.boot);
+  printf("  %lu records read back, %lu torn records skipped (%lu torn), %lu torn ack entries\n",
+         (unsigned long)total_read, (unsigned long)total_skipped, (unsigned long)test_torn_records,
+         (unsigned long)test_torn_acks);
+  printf("  at most %lu reads to open\n", (unsigned long)test_max_reads);
+  CHECK(stats.head > 2U * stats.capacity, "only %.2f laps", (double)stats.head / (double)stats.capacity);
+
+  // Power lost in the first record of a block, on a lap past the first
+  printf("torn at a block start\n");
+  test_append(TEST_PER_BLOCK - test_head % TEST_PER_BLOCK);
+  test_tear_record();
+  test_reopen();
+  test_read_all(&read_records, &skipped);
+  printf("  head %lu, %lu records read back, %lu skipped\n", (unsigned long)test_head,
+         (unsigned long)read_records, (unsigned long)skipped);
+  test_append(10U);
+  test_reopen();
+  test_read_all(&read_records, &skipped);
+  CHECK(meteo_journal_ack(test_head) == TX_SUCCESS, "ack %lu", (unsigned long)test_head);
+
+  // A lap and two blocks with nobody acknowledging
+  printf("no reader\n");
+  lost_before = test_stats().lost;
+  acked = test_stats().acked;
+  test_append(stats.capacity + 2U * TEST_PER_BLOCK);
+  oldest = test_oldest(test_head);
+  lost = test_stats().lost - lost_before;
+  printf("  %lu lost unacknowledged, %lu expected\n", (unsigned long)lost, (unsigned long)(oldest - acked));
+  CHECK(lost == oldest - acked, "lost %lu, expected %lu", (unsigned long)lost, (unsigned long)(oldest - acked));
+  CHECK(test_stats().acked == oldest, "acked %lu, oldest %lu", (unsigned long)test_stats().acked,
+        (unsigned long)oldest);
+  test_reopen();
+  test_read_all(&read_records, &skipped);
+  printf("  after the open %lu records read back, at most %lu reads to open\n", (unsigned long)read_records,
+         (unsigned long)test_max_reads);
+  CHECK(read_records == test_head - oldest, "%lu records read back, %lu on flash",
+        (unsigned long)read_records, (unsigned long)(test_head - oldest));
+
+  printf("%s (%d failures)\n", test_failures ? "FAILED" : "PASSED", test_failures);
+  exit(test_failures != 0);
+}
+
+void tx_application_define(void *first_unused_memory)
+{
+  (void)first_unused_memory;
+
+  meteo_ospi_init();
+  meteo_journal_init();
+  tx_thread_create(&test_thread, "test", test_entry, 0U, test_stack, TEST_STACK_SIZE,
+                   5U, 5U, TX_NO_TIME_SLICE, TX_AUTO_START);
+}
+
+int main(int argc, char *argv[])
+{
+  const char *image = "meteo_journal_test.bin";
+  int opt;
+
+  while ((opt = getopt(argc, argv, "r:")) != -1)
+  {
+    switch (opt)
+    {
+      case 'r':
+        test_restarts = atol(optarg);
+        break;
+      default:
+        fprintf(stderr, "Usage: %s [-r restarts] [image]\n", argv[0]);
+        return 2;
+    }
+  }
+  if (optind < argc)
+  {
+    image = argv[optind];
+  }
+  if (test_restarts < 1L)
+  {
+    fprintf(stderr, "restarts > 0\n");
+    return 2;
+  }
+
+  // A file, so the open after a restart reads what was written
+  unlink(image);
+  setenv(LX_STM32_OSPI_HOST_FILE_ENV, image, 1);
+  tx_kernel_enter();
+  return 0;
+}
@@ -0,0 +1,327 @@
+/**
+  ******************************************************************************
+  * @file    meteo_retention_soak.c
+  * @brief   Soak of the archive retention (meteo_retention.c) on the
+  *          emulated OSPI flash of the Linux host: months of 1 Hz readings
+  *          in seconds.
+  *
+  *          The tick is moved by hand, a second per reading, and a
+  *          retention step runs after every minute of readings. Every
+  *          few days the store is opened again with the tick back to 0,
+  *          as after a reset. The phases, one after the other on the same
+  *          flash:
+  *          - age 1 day, default byte budget, the first lap of the ring
+  *          - age 7 days, default byte budget
+  *          - no age limit, default byte budget (4 blocks spare)
+  *          - no age limit, the budget cut to 2 MB
+  *          - age 7 days, one boot of 60 days: the 32-bit ms tick wraps
+  *            after 49.7 days and archive time must go on past it
+  *          After each step: the blocks in use stay within the budget (or
+  *          come down a block a step after it was cut), and at most one
+  *          block, the one being aged out, is past the age. After a
+  *          restart the open finds the same next and oldest seq. At the
+  *          end of a phase the whole archive is read back with a cursor:
+  *          in time order, and no older than the age and a day.
+  *
+  *          Build: TX=Middlewares/ST/threadx
+  *                 DB=Middlewares/Third_Party/ITTIA_DB_Database_ITTIA_DB_Lite/ITTIA_DB_Lite
+  *                 gcc -O2 -DTX_INCLUDE_USER_DEFINE_FILE -DOS_LINUX -ICore/Host/Inc -ICore/Inc
+  *                     -I$TX/ports/linux/gnu/inc -I$TX/common/inc
+  *                     -I$TX/utility/execution_profile_kit -I$DB/inc -o meteo_retention_soak
+  *                     Core/Host/Tools/meteo_retention_soak.c Core/Src/meteo_retention.c
+  *                     Core/Src/meteo_archive.c Core/Src/meteo_archive_store.c
+  *                     Core/Src/meteo_ospi.c Core/Src/meteo_trace.c Core/Host/Src/host_ospi.c
+  *                     Core/Src/meteo_database.c Core/Host/Src/host_ittia_db.c
+  *                     <the ThreadX sources of the meteo_host build line in
+  *                     README.md> -lpthread -lm
+  *          Usage: meteo_retention_soak [image] > soak.log
+  *            image  flash file, created again (default meteo_retention_soak.bin)
+  *          Each erase prints a [RETENTION] line; the phase results are
+  *          the lines that do not start with '['.
+  ******************************************************************************
+  */
+
+/* Includes ------------------------------------------------------------------*/
+#include <math.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <time.h>
+#include <unistd.h>
+
+#include "tx_api.h"
+#include "lx_stm32_ospi_driver.h"
+#include "meteo_archive_store.h"
+#include "meteo_console.h"
+#include "meteo_retention.h"
+
+/* Private defines -----------------------------------------------------------*/
+#define SOAK_STACK_SIZE         32768U
+#define SOAK_DAY_S              86400UL
+#define SOAK_BLOCK_SIZE         65536UL
+#define SOAK_READ_BATCH         64U
+
+#define CHECK(cond, ...) \
+  do { if (!(cond)) { if (soak_failures++ < 20) { printf("  FAILED line %d: ", __LINE__); \
+       printf(__VA_ARGS__); printf("\n"); } } } while (0)
+
+/* Private variables ---------------------------------------------------------*/
+static TX_THREAD soak_thread;
+static UCHAR soak_stack[SOAK_STACK_SIZE];
+
+/* meteo_retention_thread_entry() looks at it; the soak calls the steps itself */
+TX_QUEUE meteo_frame_queue;
+
+static meteo_archive_cursor_t soak_cursor;
+static meteo_archive_sample_t soak_samples[SOAK_READ_BATCH];
+
+static uint32_t soak_tick;
+static uint32_t soak_seed = 0x2468ACE1UL;
+static uint64_t soak_seconds;
+static float soak_wind = 4.0f;
+static float soak_direction = 200.0f;
+static uint32_t soak_used_before;
+static int soak_failures;
+
+/* Private functions ---------------------------------------------------------*/
+
+/* The archive clock, moved by hand: one reading a second */
+uint32_t HAL_GetTick(void)
+{
+  return soak_tick;
+}
+
+/* meteo_trace.c sets it around a dump; no console here */
+meteo_console_overflow_t meteo_console_set_overflow(meteo_console_overflow_t policy)
+{
+  return policy;
+}
+
+static double soak_now(void)
+{
+  struct timespec now;
+
+  clock_gettime(CLOCK_MONOTONIC, &now);
+  return (double)now.tv_sec + (double)now.tv_nsec * 1e-9;
+}
+
+/* xorshift32, the generator of the simulator stations */
+static uint32_t soak_random(void)
+{
+  soak_seed ^= soak_seed << 13;
+  soak_seed ^= soak_seed >> 17;
+  soak_seed ^= soak_seed << 5;
+  return soak_seed;
+}
+
+/* A day of temperature and pressure, wind that wanders, at the scales of the frames */
+static void soak_reading(meteo_archive_sample_t *sample)
+{
+  double day = (double)(soak_seconds % SOAK_DAY_S) / (double)SOAK_DAY_S;
+
+  soak_seconds++;
+  sample->value[METEO_ARCHIVE_TEMPERATURE] =
+      roundf((float)(15.0 + 8.0 * sin(6.2832 * (day - 0.3))
+                     + (double)((int)(soak_random() % 7U) - 3) / 100.0) * 100.0f) / 100.0f;
+  sample->value[METEO_ARCHIVE_PRESSURE] = roundf((float)(1013.0 + 3.0 * sin(6.2832 * day * 2.0)) * 10.0f) / 10.0f;
+  soak_wind += 0.02f * (5.0f - soak_wind) + (float)((int)(soak_random() % 100U) - 50) / 250.0f;
+  soak_wind = (soak_wind < 0.0f) ? 0.0f : soak_wind;
+  sample->value[METEO_ARCHIVE_WIND_SPEED] = roundf(soak_wind * 10.0f) / 10.0f;
+  soak_direction = fmodf(soak_direction + (float)((int)(soak_random() % 100U) - 50) / 50.0f + 360.0f, 360.0f);
+  sample->value[METEO_ARCHIVE_WIND_DIRECTION] = roundf(soak_direction * 10.0f) / 10.0f;
+  sample->value[METEO_ARCHIVE_VOLTAGE] = (float)(114 + (int)(soak_random() % 3U));
+}
+
+static meteo_archive_store_stats_t soak_stats(void)
+{
+  meteo_archive_store_stats_t stats;
+
+  meteo_archive_store_get_stats(&stats);
+  return stats;
+}
+
+/* Blocks in use, and those all older than the cutoff */
+static void soak_check_budget(const char *phase, int64_t before_usec, ULONG budget, uint32_t *used_max)
+{
+  meteo_archive_zone_t zone;
+  uint32_t used = 0U;
+  uint32_t old = 0U;
+  uint32_t block;
+
+  for (block = 0U; block < METEO_ARCHIVE_STORE_BLOCKS; block++)
+  {
+    meteo_archive_store_get_zone(block, &zone);
+    if (zone.segments != 0U)
+    {
+      used++;
+      old += (zone.ts_max_usec < before_usec) ? 1U : 0U;
+    }
+  }
+  *used_max = (used > *used_max) ? used : *used_max;
+
+  // Over a lowered budget: down a block a step; the writer's may be one more
+  CHECK((ULONG)used * SOAK_BLOCK_SIZE <= budget + SOAK_BLOCK_SIZE || used < soak_used_before,
+        "%s: %lu blocks in use over %lu bytes", phase, (unsigned long)used, (unsigned long)budget);
+  CHECK(old <= 1U, "%s: %lu blocks past the age", phase, (unsigned long)old);
+  soak_used_before = used;
+}
+
+/* The whole archive through a cursor: count, span and order */
+static void soak_read_back(const char *phase, uint32_t age_days)
+{
+  meteo_archive_query_t query;
+  uint64_t count = 0U;
+  int64_t first = -1;
+  int64_t last = -1;
+  uint32_t backwards = 0U;
+  int64_t now;
+  UINT n;
+  UINT i;
+
+  query.from_usec = 0;
+  query.to_usec = INT64_MAX;
+  query.channel = METEO_ARCHIVE_CHANNELS;
+  query.min = 0.0f;
+  query.max = 0.0f;
+  meteo_archive_store_cursor_open(&soak_cursor, &query);
+  do
+  {
+    meteo_archive_store_read(&soak_cursor, soak_samples, SOAK_READ_BATCH, &n);
+    for (i = 0U; i < n; i++)
+    {
+      first = (first < 0) ? soak_samples[i].ts_usec : first;
+      backwards += (soak_samples[i].ts_usec <= last) ? 1U : 0U;
+      last = soak_samples[i].ts_usec;
+      count++;
+    }
+  } while (n == SOAK_READ_BATCH);
+
+  now = meteo_archive_store_now();
+  printf("  read back: %llu samples over %.2f days, %lu out of order\n", (unsigned long long)count,
+         (double)(last - first) / (SOAK_DAY_S * 1e6), (unsigned long)backwards);
+  CHECK(backwards == 0U, "%s: %lu samples out of order", phase, (unsigned long)backwards);
+  CHECK(last < now, "%s: newest sample %lld s after now", phase, (long long)((last - now) / 1000000));
+  if (age_days != 0U)
+  {
+    CHECK(now - first <= (int64_t)(age_days + 1U) * (int64_t)SOAK_DAY_S * 1000000,
+          "%s: oldest sample %lld s old", phase, (long long)((now - first) / 1000000));
+  }
+}
+
+static void soak_phase(const char *phase, uint32_t days, uint32_t age_days, ULONG budget, uint32_t restart_days)
+{
+  meteo_retention_config_t config;
+  meteo_retention_stats_t before;
+  meteo_retention_stats_t after;
+  meteo_archive_store_stats_t stats;
+  meteo_archive_store_stats_t opened;
+  meteo_archive_sample_t sample;
+  uint32_t used_max = 0U;
+  uint32_t restarts = 0U;
+  uint32_t erases = 0U;
+  uint32_t preerased = 0U;
+  uint32_t steps;
+  int64_t freed;
+  uint64_t second;
+  uint64_t restart_s = (uint64_t)restart_days * SOAK_DAY_S;
+  double start;
+  UINT status;
+
+  meteo_retention_get_config(&config);
+  config.max_age_s = age_days * (uint32_t)SOAK_DAY_S;
+  config.archive_bytes = budget;
+  meteo_retention_set_config(&config);
+  meteo_retention_get_stats(&before);
+
+  start = soak_now();
+  for (second = 0U; second < (uint64_t)days * SOAK_DAY_S; second++)
+  {
+    soak_reading(&sample);
+    soak_tick += 1000U;
+    sample.ts_usec = meteo_archive_store_now();
+    CHECK(meteo_archive_store_add(&sample) == TX_SUCCESS, "%s: add at %llu s", phase, (unsigned long long)second);
+
+    if (second % 60U == 59U)
+    {
+      status = meteo_retention_step(&freed);
+      CHECK(status == TX_SUCCESS, "%s: step 0x%02X", phase, status);
+      soak_check_budget(phase, (age_days != 0U) ? meteo_archive_store_now() - (int64_t)config.max_age_s * 1000000
+                                                : INT64_MIN, budget, &used_max);
+    }
+
+    // The counters of the store start again at each open
+    if (restart_s != 0U && second % restart_s == restart_s - 1U)
+    {
+      stats = soak_stats();
+      erases += stats.erases;
+      preerased += stats.preerased;
+      meteo_archive_store_open();
+      soak_tick = 0U;
+      opened = soak_stats();
+      restarts++;
+      CHECK(opened.next_seq == stats.next_seq && opened.oldest == stats.oldest,
+            "%s restart: next %lu -> %lu, oldest %lu -> %lu", phase, (unsigned long)stats.next_seq,
+            (unsigned long)opened.next_seq, (unsigned long)stats.oldest, (unsigned long)opened.oldest);
+    }
+  }
+  meteo_retention_get_stats(&after);
+  stats = soak_stats();
+  erases += stats.erases;
+  preerased += stats.preerased;
+  steps = after.steps - before.steps;
+
+  printf("%s: %lu days in %.1f s, age %lu days, budget %lu KB, %lu restarts\n", phase, (unsigned long)days,
+         soak_now() - start, (unsigned long)age_days, (unsigned long)(budget / 1024U), (unsigned long)restarts);
+  printf("  %lu steps freed %lu blocks (%lld KB), step %lu us max, %.1f us mean\n", (unsigned long)steps,
+         (unsigned long)(after.archive_blocks - before.archive_blocks),
+         (long long)((after.bytes - before.bytes) / 1024), (unsigned long)after.max_us,
+         (steps != 0U) ? (double)(after.total_us - before.total_us) / steps : 0.0);
+  printf("  at most %lu blocks in use, %lu erases, %lu blocks entered erased, %lu write errors\n",
+         (unsigned long)used_max, (unsigned long)erases, (unsigned long)preerased,
+         (unsigned long)stats.write_errors);
+  CHECK(stats.write_errors == 0U, "%s: %lu write errors", phase, (unsigned long)stats.write_errors);
+  soak_read_back(phase, age_days);
+}
+
+static void soak_entry(ULONG input)
+{
+  meteo_retention_config_t defaults;
+
+  (void)input;
+
+  meteo_retention_get_config(&defaults);
+  printf("defaults: age %lu days, budget %lu KB\n", (unsigned long)(defaults.max_age_s / SOAK_DAY_S),
+         (unsigned long)(defaults.archive_bytes / 1024U));
+  meteo_archive_store_open();
+
+  soak_phase("age 1 day, first lap", 5U, 1U, METEO_RETENTION_ARCHIVE_BYTES, 2U);
+  soak_phase("age 7 days", 120U, 7U, METEO_RETENTION_ARCHIVE_BYTES, 30U);
+  soak_phase("bytes, 4 spare", 150U, 0U, METEO_RETENTION_ARCHIVE_BYTES, 30U);
+  soak_phase("bytes 2 MB", 30U, 0U, 2UL * 1024UL * 1024UL, 10U);
+  soak_phase("one boot, tick wrap", 60U, 7U, METEO_RETENTION_ARCHIVE_BYTES, 0U);
+
+  printf("%s (%d failures)\n", soak_failures ? "FAILED" : "PASSED", soak_failures);
+  exit(soak_failures != 0);
+}
+
+void tx_application_define(void *first_unused_memory)
+{
+  (void)first_unused_memory;
+
+  meteo_ospi_init();
+  meteo_archive_store_init();
+  meteo_retention_init();
+  tx_thread_create(&soak_thread, "soak", soak_entry, 0U, soak_stack, SOAK_STACK_SIZE,
+                   5U, 5U, TX_NO_TIME_SLICE, TX_AUTO_START);
+}
+
+int main(int argc, char *argv[])
+{
+  const char *image = (argc > 1) ? argv[1] : "meteo_retention_soak.bin";
+
+  // A file, so the open after a restart reads what was written
+  unlink(image);
+  setenv(LX_STM32_OSPI_HOST_FILE_ENV, image, 1);
+  tx_kernel_enter();
+  return 0;
+}
@@ -0,0 +1,564 @@
+/**
+  ******************************************************************************
+  * @file    meteo_series_bench.c
+  * @brief   Ingest, bytes and range queries of the per-channel time series
+  *          (meteo_series.c) on the Linux port of ThreadX, against the
+  *          in-memory IoT storage of Core/Host/Src/host_ittia_db.c.
+  *
+  *          A day of 1 Hz readings from the simulator's station
+  *          (meteo_sim_station.c), then a day from a diurnal station with a
+  *          little sensor noise, decoded by meteo_archive_store_parse_frame()
+  *          as in the DB thread, with the default deadband / swinging door:
+  *          - ingest: ns per meteo_series_add() (all five channels), against
+  *            meteo_compress_apply() alone; points per channel, and the
+  *            series bytes of db_file_info() per reading against the rows of
+  *            the stream (40 bytes, meteo_readings4). No put may fail.
+  *          - aligned rows: each channel is read alone through its own
+  *            connection (db_prepare_time_series_query with one name). The
+  *            rows of meteo_series_read() must be exactly one per timestamp
+  *            where a channel has a point, each channel at its last point.
+  *          - range queries: last hour, last day, both days, temperature
+  *            20..21 over both days: rows, timestamps read and µs, and the
+  *            CSV export of the last hour (meteo_export_series_run) gives
+  *            the rows of the cursor.
+  *          - retention: meteo_series_set_retention() to 256 KB, then
+  *            meteo_series_trim() an hour at a time down to the last 12 h:
+  *            the series bytes and the oldest point must follow.
+  *          The series bytes are the stand-in's: 12 a point (timestamp and
+  *          float), not the engine's page format.
+  *
+  *          Build: TX=Middlewares/ST/threadx
+  *                 DB=Middlewares/Third_Party/ITTIA_DB_Database_ITTIA_DB_Lite/ITTIA_DB_Lite
+  *                 gcc -O2 -DMETEO_SERIES_ENABLED=1 -DTX_INCLUDE_USER_DEFINE_FILE -DOS_LINUX
+  *                     -ICore/Host/Inc -ICore/Inc -I$TX/ports/linux/gnu/inc
+  *                     -I$TX/common/inc -I$TX/utility/execution_profile_kit -I$DB/inc
+  *                     -o meteo_series_bench Core/Host/Tools/meteo_series_bench.c
+  *                     Core/Src/meteo_series.c Core/Src/meteo_compress.c
+  *                     Core/Src/meteo_export.c Core/Src/meteo_columns.c
+  *                     Core/Src/meteo_format.c Core/Src/meteo_archive.c
+  *                     Core/Src/meteo_archive_store.c Core/Src/meteo_ospi.c
+  *                     Core/Src/meteo_trace.c Core/Src/meteo_sim_station.c
+  *                     Core/Host/Src/host_ospi.c Core/Host/Src/host_ittia_db.c
+  *                     <the ThreadX sources of the meteo_host build line in
+  *                     README.md> -lpthread -lm
+  *          Usage: meteo_series_bench [-d days]
+  ******************************************************************************
+  */
+
+/* Includes ------------------------------------------------------------------*/
+#include <math.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <unistd.h>
+
+#include "tx_api.h"
+#include "meteo_archive.h"
+#include "meteo_archive_store.h"
+#include "meteo_compress.h"
+#include "meteo_console.h"
+#include "meteo_export.h"
+#include "meteo_series.h"
+#include "meteo_simulator.h"
+#include "host_ittia_db.h"
+
+/* Private defines -----------------------------------------------------------*/
+#define TEST_STACK_SIZE         32768U
+#define TEST_DAY_SAMPLES        86400U
+#define TEST_MAX_DAYS           2U
+#define TEST_MAX_SAMPLES        (TEST_MAX_DAYS * TEST_DAY_SAMPLES)
+#define TEST_MAX_POINTS         (TEST_MAX_SAMPLES + 4096U)
+#define TEST_READ_BATCH         64U
+#define TEST_ROW_BYTES          40.0        /* meteo_readings row */
+#define TEST_HOUR_USEC          (3600LL * 1000000LL)
+#define TEST_RETAIN_BYTES       (256L * 1024L)
+
+#define CHECK(cond, ...) \
+  do { if (!(cond)) { if (test_failures++ < 20) { printf("  FAILED line %d: ", __LINE__); \
+       printf(__VA_ARGS__); printf("\n"); } } } while (0)
+
+/* Private types -------------------------------------------------------------*/
+
+/* Points of one channel, as stored */
+typedef struct
+{
+  uint32_t count;
+  int64_t ts_usec[TEST_MAX_POINTS];
+  float value[TEST_MAX_POINTS];
+} test_points_t;
+
+/* Private variables ---------------------------------------------------------*/
+static TX_THREAD test_thread;
+static UCHAR test_stack[TEST_STACK_SIZE];
+
+static meteo_archive_sample_t test_samples[TEST_MAX_SAMPLES];
+static meteo_archive_sample_t test_rows[TEST_READ_BATCH];
+static test_points_t test_points[METEO_ARCHIVE_CHANNELS];
+static uint32_t test_count;
+static uint32_t test_days = 1U;
+static int64_t test_base_usec;
+static uint32_t test_rng = 0x2545F491UL;
+
+/* The bench's own connection to the series file */
+static db_t test_db;
+
+static int test_failures;
+
+static const char *const test_series_names[METEO_ARCHIVE_CHANNELS] =
+{
+  "temperature", "pressure", "wind_speed", "wind_direction", "voltage"
+};
+
+/* Private functions ---------------------------------------------------------*/
+
+/* meteo_archive_store.c needs it; the readings are stamped here */
+uint32_t HAL_GetTick(void)
+{
+  return 0U;
+}
+
+/* meteo_trace.c sets it around a dump; no console here */
+meteo_console_overflow_t meteo_console_set_overflow(meteo_console_overflow_t policy)
+{
+  return policy;
+}
+
+/* meteo_export_console() writes there; not run here */
+int meteo_console_write(const char *data, int length)
+{
+  (void)data;
+  return length;
+}
+
+static double test_now(void)
+{
+  struct timespec now;
+
+  clock_gettime(CLOCK_MONOTONIC, &now);
+  return (double)now.tv_sec + (double)now.tv_nsec * 1e-9;
+}
+
+static uint32_t test_random(void)
+{
+  test_rng ^= test_rng << 13;
+  test_rng ^= test_rng >> 17;
+  test_rng ^= test_rng << 5;
+  return test_rng;
+}
+
+static void test_add_frame(const char *frame)
+{
+  meteo_archive_sample_t *sample = &test_samples[test_count];
+
+  CHECK(meteo_archive_store_parse_frame(frame, sample) == TX_SUCCESS, "frame %s", frame);
+  sample->ts_usec = test_base_usec + (int64_t)test_count * 1000000;
+  test_count++;
+}
+
+static void test_simulator(void)
+{
+  meteo_sim_station_t station;
+  char frame[64];
+
+  test_count = 0U;
+  meteo_sim_station_init(&station, METEO_SIM_DEFAULT_SEED);
+  while (test_count < test_days * TEST_DAY_SAMPLES)
+  {
+    meteo_sim_station_frame(&station, frame, sizeof(frame));
+    test_add_frame(frame);
+  }
+}
+
+/* Temperature and pressure follow the sun, the wind changes over minutes;
+   a little sensor noise on each */
+static void test_diurnal(void)
+{
+  char frame[64];
+  double t;
+
+  test_count = 0U;
+  while (test_count < test_days * TEST_DAY_SAMPLES)
+  {
+    t = (double)test_count;
+    snprintf(frame, sizeof(frame), "UUU$%05lu.%05lu.%04lu.%05lu.%03lu.ABCD*QQQ",
+             (unsigned long)(lround(1500.0 + 600.0 * sin(t * 2.0 * M_PI / 86400.0)) + test_random() % 5U),
+             (unsigned long)lround(10132.0 + 20.0 * sin(t * 2.0 * M_PI / 86400.0)),
+             (unsigned long)(lround(1800.0 + 1700.0 * sin(t * 2.0 * M_PI / 21600.0)) + test_random() % 30U),
+             (unsigned long)(lround(40.0 + 20.0 * sin(t * 2.0 * M_PI / 600.0)) + test_random() % 6U),
+             (unsigned long)(115U + test_random() % 2U));
+    test_add_frame(frame);
+  }
+}
+
+static int64_t test_series_bytes(void)
+{
+  db_file_info_t info;
+
+  CHECK(DB_SUCCESS(db_file_info(test_db, &info)), "db_file_info");
+  return info.time_series_data_bytes;
+}
+
+/* Oldest point of any series, INT64_MAX when they are empty */
+static int64_t test_oldest(void)
+{
+  db_time_series_query_t query;
+  db_timestamp_usec_t ts = INT64_MAX;
+  db_fieldno_t fieldno[METEO_ARCHIVE_CHANNELS];
+  float32_t values[METEO_ARCHIVE_CHANNELS];
+  dbstatus_t status;
+
+  status = db_prepare_time_series_query(&query, test_db, (const char **)test_series_names, METEO_ARCHIVE_CHANNELS,
+                                        NULL, NULL, DB_QUERY_OLDEST_TO_NEWEST);
+  CHECK(status == METEO_ARCHIVE_CHANNELS, "query of all series: %ld", (long)status);
+  if (DB_SUCCESS(status))
+  {
+    if (db_fetch_next_timestamp_float32(query, &ts, fieldno, values, METEO_ARCHIVE_CHANNELS) <= 0)
+    {
+      ts = INT64_MAX;
+    }
+    (void)db_close_time_series_query(query);
+  }
+  return (int64_t)ts;
+}
+
+/* The points of one channel from begin to end, both included */
+static void test_read_channel(uint32_t channel, int64_t begin, int64_t end)
+{
+  test_points_t *points = &test_points[channel];
+  db_time_series_query_t query;
+  db_timestamp_usec_t from = begin;
+  db_timestamp_usec_t to = end + 1;
+  db_timestamp_usec_t ts;
+  db_fieldno_t fieldno;
+  float32_t value;
+  const char *name = test_series_names[channel];
+  dbstatus_t n;
+
+  points->count = 0U;
+  CHECK(db_prepare_time_series_query(&query, test_db, &name, 1, &from, &to, DB_QUERY_OLDEST_TO_NEWEST) == 1,
+        "query of %s", name);
+  while ((n = db_fetch_next_timestamp_float32(query, &ts, &fieldno, &value, 1)) > 0 &&
+         points->count < TEST_MAX_POINTS)
+  {
+    points->ts_usec[points->count] = (int64_t)ts;
+    points->value[points->count] = value;
+    points->count++;
+  }
+  CHECK(n == 0, "%s: fetch %ld after %lu points", name, (long)n, (unsigned long)points->count);
+  (void)db_close_time_series_query(query);
+}
+
+/* The heartbeat the cursor starts before from_usec */
+static int64_t test_lookback_usec(void)
+{
+  meteo_compress_config_t config;
+  int64_t lookback_s = METEO_COMPRESS_HEARTBEAT_S;
+  uint32_t c;
+
+  for (c = 0U; c < METEO_ARCHIVE_CHANNELS; c++)
+  {
+    if (meteo_compress_get_config(c, &config) == TX_SUCCESS && (int64_t)config.heartbeat_s > lookback_s)
+    {
+      lookback_s = (int64_t)config.heartbeat_s;
+    }
+  }
+  return lookback_s * 1000000;
+}
+
+/* Rows of the cursor against the channels read alone: a row per timestamp
+   of any channel from from_usec, once every channel has a point, each at
+   its last point */
+static void test_aligned(const char *name, int64_t from_usec, int64_t to_usec)
+{
+  meteo_archive_query_t query = { from_usec, to_usec, METEO_ARCHIVE_CHANNELS, 0.0f, 0.0f };
+  meteo_series_cursor_t cursor;
+  float last[METEO_ARCHIVE_CHANNELS] = { 0.0f };
+  uint32_t at[METEO_ARCHIVE_CHANNELS] = { 0U };
+  uint32_t seen = 0U;
+  uint32_t expected = 0U;
+  uint32_t differ = 0U;
+  uint32_t rows = 0U;
+  UINT count = 0U;
+  UINT i = 0U;
+  int64_t ts;
+  uint32_t c;
+
+  for (c = 0U; c < METEO_ARCHIVE_CHANNELS; c++)
+  {
+    test_read_channel(c, from_usec - test_lookback_usec(), to_usec);
+  }
+  CHECK(meteo_series_cursor_open(&cursor, &query) == TX_SUCCESS, "%s: cursor open", name);
+
+  while (1)
+  {
+    // Next timestamp of any channel
+    ts = INT64_MAX;
+    for (c = 0U; c < METEO_ARCHIVE_CHANNELS; c++)
+    {
+      if (at[c] < test_points[c].count && test_points[c].ts_usec[at[c]] < ts)
+      {
+        ts = test_points[c].ts_usec[at[c]];
+      }
+    }
+    if (ts == INT64_MAX)
+    {
+      break;
+    }
+    for (c = 0U; c < METEO_ARCHIVE_CHANNELS; c++)
+    {
+      if (at[c] < test_points[c].count && test_points[c].ts_usec[at[c]] == ts)
+      {
+        last[c] = test_points[c].value[at[c]++];
+        seen |= 1UL << c;
+      }
+    }
+    if (ts < from_usec || seen != (1UL << METEO_ARCHIVE_CHANNELS) - 1U)
+    {
+      continue;
+    }
+
+    expected++;
+    if (i == count)
+    {
+      CHECK(meteo_series_read(&cursor, test_rows, TEST_READ_BATCH, &count) == TX_SUCCESS, "%s: read", name);
+      i = 0U;
+    }
+    if (i < count)
+    {
+      differ += (test_rows[i].ts_usec != ts || memcmp(test_rows[i].value, last, sizeof(last)) != 0) ? 1U : 0U;
+      rows++;
+      i++;
+    }
+  }
+  // Nothing past the last expected row
+  rows += count - i;
+  differ += count - i;
+  while (meteo_series_read(&cursor, test_rows, TEST_READ_BATCH, &count) == TX_SUCCESS && count > 0U)
+  {
+    rows += count;
+    differ += count;
+  }
+  meteo_series_cursor_close(&cursor);
+
+  printf("  aligned: %lu rows, %lu expected, %lu differ\n", (unsigned long)rows, (unsigned long)expected,
+         (unsigned long)differ);
+  CHECK(rows == expected && differ == 0U && expected > 0U, "%s: %lu rows of %lu, %lu differ", name,
+        (unsigned long)rows, (unsigned long)expected, (unsigned long)differ);
+}
+
+static void test_ingest(const char *name)
+{
+  meteo_archive_sample_t kept[2];
+  meteo_series_stats_t before;
+  meteo_series_stats_t after;
+  uint32_t rows = 0U;
+  int64_t bytes;
+  double start;
+  double apply_ns;
+  double add_ns;
+  uint32_t c;
+  uint32_t n;
+
+  printf("%s: %lu readings\n", name, (unsigned long)test_count);
+
+  start = test_now();
+  for (n = 0U; n < test_count; n++)
+  {
+    rows += meteo_compress_apply(&test_samples[n], kept);
+  }
+  apply_ns = (test_now() - start) / (double)test_count * 1e9;
+
+  meteo_series_get_stats(&before);
+  bytes = test_series_bytes();
+  start = test_now();
+  for (n = 0U; n < test_count; n++)
+  {
+    (void)meteo_series_add(&test_samples[n]);
+  }
+  add_ns = (test_now() - start) / (double)test_count * 1e9;
+  meteo_series_get_stats(&after);
+  bytes = test_series_bytes() - bytes;
+
+  printf("  points:");
+  for (c = 0U; c < METEO_ARCHIVE_CHANNELS; c++)
+  {
+    test_read_channel(c, test_samples[0].ts_usec, test_samples[test_count - 1U].ts_usec);
+    printf(" %s %lu", test_series_names[c], (unsigned long)test_points[c].count);
+  }
+  printf("\n");
+  printf("  series %.2f bytes a reading (%lu points), rows %.2f (%lu rows)\n",
+         (double)bytes / (double)test_count, (unsigned long)(after.points - before.points),
+         (double)rows * TEST_ROW_BYTES / (double)test_count, (unsigned long)rows);
+  printf("  ns a reading: meteo_series_add %.0f, meteo_compress_apply %.0f\n", add_ns, apply_ns);
+  CHECK(after.put_errors == before.put_errors, "%s: %lu puts failed", name,
+        (unsigned long)(after.put_errors - before.put_errors));
+  CHECK(after.samples - before.samples == test_count, "%s: %lu samples counted", name,
+        (unsigned long)(after.samples - before.samples));
+}
+
+static uint32_t test_range(const char *name, int64_t from_usec, int64_t to_usec, uint32_t channel, float min,
+                           float max)
+{
+  meteo_archive_query_t query = { from_usec, to_usec, channel, min, max };
+  meteo_series_cursor_t cursor;
+  uint32_t rows = 0U;
+  UINT count;
+  double start;
+  double us;
+
+  start = test_now();
+  CHECK(meteo_series_cursor_open(&cursor, &query) == TX_SUCCESS, "%s: cursor open", name);
+  do
+  {
+    CHECK(meteo_series_read(&cursor, test_rows, TEST_READ_BATCH, &count) == TX_SUCCESS, "%s: read", name);
+    rows += count;
+  } while (count > 0U);
+  us = (test_now() - start) * 1e6;
+  meteo_series_cursor_close(&cursor);
+
+  printf("  %-28s %7lu rows, %7lu timestamps read, %8.0f us, %.0f ns a row\n", name, (unsigned long)rows,
+         (unsigned long)cursor.stats.timestamps, us, (rows > 0U) ? us * 1000.0 / (double)rows : 0.0);
+  CHECK(cursor.stats.rows == rows, "%s: stats rows %lu of %lu", name, (unsigned long)cursor.stats.rows,
+        (unsigned long)rows);
+  return rows;
+}
+
+static int test_count_sink(void *context, const char *data, uint32_t length)
+{
+  (void)context;
+  (void)data;
+  (void)length;
+  return 0;
+}
+
+static void test_queries(int64_t first_usec, int64_t last_usec)
+{
+  meteo_archive_query_t query = { last_usec - TEST_HOUR_USEC, last_usec, METEO_ARCHIVE_CHANNELS, 0.0f, 0.0f };
+  meteo_export_stats_t stats;
+  uint32_t hour;
+
+  printf("range queries\n");
+  hour = test_range("last hour", last_usec - TEST_HOUR_USEC, last_usec, METEO_ARCHIVE_CHANNELS, 0.0f, 0.0f);
+  (void)test_range("last day", last_usec - 24 * TEST_HOUR_USEC, last_usec, METEO_ARCHIVE_CHANNELS, 0.0f, 0.0f);
+  (void)test_range("all", first_usec, last_usec, METEO_ARCHIVE_CHANNELS, 0.0f, 0.0f);
+  (void)test_range("temperature 20..21, all", first_usec, last_usec, METEO_ARCHIVE_TEMPERATURE, 20.0f, 21.0f);
+
+  CHECK(meteo_export_series_run(&query, METEO_EXPORT_CSV, test_count_sink, NULL, &stats) == TX_SUCCESS,
+        "series export");
+  printf("  CSV export of the last hour: %lu rows, %lu bytes\n", (unsigned long)stats.rows,
+         (unsigned long)stats.bytes);
+  CHECK(stats.rows == hour && stats.query.matched == hour, "export %lu rows, cursor %lu",
+        (unsigned long)stats.rows, (unsigned long)hour);
+}
+
+static void test_retention(int64_t last_usec)
+{
+  int64_t before_usec = last_usec - 12 * TEST_HOUR_USEC;
+  int64_t oldest;
+  int64_t freed;
+  int64_t trimmed = 0;
+  int64_t bytes;
+  uint32_t removed;
+  uint32_t steps = 0U;
+  uint32_t total = 0U;
+  double start;
+  UINT status;
+
+  printf("retention\n");
+  CHECK(meteo_series_set_retention(TEST_RETAIN_BYTES) == TX_SUCCESS, "set retention");
+  CHECK(meteo_series_set_retention(DB_DEF_PAGE_SIZE - 1) == TX_SIZE_ERROR, "retention under a page");
+  bytes = test_series_bytes();
+  oldest = test_oldest();
+  printf("  retention %ld bytes: %ld bytes of series, oldest %.2f h before the last\n", (long)TEST_RETAIN_BYTES,
+         (long)bytes, (double)(last_usec - oldest) / (double)TEST_HOUR_USEC);
+  CHECK(bytes <= TEST_RETAIN_BYTES + METEO_SERIES_SLACK_BYTES && bytes > TEST_RETAIN_BYTES / 2,
+        "%ld bytes of series", (long)bytes);
+  CHECK(oldest < last_usec, "no series left");
+
+  start = test_now();
+  do
+  {
+    status = meteo_series_trim(before_usec, TEST_HOUR_USEC, &removed, &freed);
+    CHECK(status == TX_SUCCESS, "trim step %lu: %u", (unsigned long)steps, status);
+    steps += (removed > 0U) ? 1U : 0U;
+    total += removed;
+    trimmed += freed;
+  } while (status == TX_SUCCESS && removed > 0U);
+  oldest = test_oldest();
+  printf("  trim to 12 h: %lu steps, %lu timestamps, %ld bytes, %.0f us a step; oldest %.2f h before the last\n",
+         (unsigned long)steps, (unsigned long)total, (long)trimmed,
+         (steps > 0U) ? (test_now() - start) * 1e6 / steps : 0.0, (double)(last_usec - oldest) / (double)TEST_HOUR_USEC);
+  CHECK(steps > 0U && trimmed == bytes - test_series_bytes(), "%ld bytes trimmed of %ld", (long)trimmed,
+        (long)(bytes - test_series_bytes()));
+  CHECK(oldest > before_usec - TEST_HOUR_USEC && oldest <= before_usec, "oldest %.2f h before the last",
+        (double)(last_usec - oldest) / (double)TEST_HOUR_USEC);
+}
+
+static void test_entry(ULONG input)
+{
+  int64_t first_usec;
+  int64_t last_usec;
+
+  (void)input;
+
+  CHECK(meteo_series_open() == TX_SUCCESS, "meteo_series_open");
+  CHECK(DB_SUCCESS(db_connect(&test_db, METEO_SERIES_FILE, NULL, NULL, NULL)), "connect");
+
+  test_base_usec = 1000000000LL * 1000000LL;
+  first_usec = test_base_usec;
+  test_simulator();
+  test_ingest("simulator");
+  test_aligned("simulator", test_samples[0].ts_usec, test_samples[test_count - 1U].ts_usec);
+
+  test_base_usec = test_samples[test_count - 1U].ts_usec + 1000000;
+  test_diurnal();
+  test_ingest("diurnal");
+  test_aligned("diurnal", test_samples[0].ts_usec, test_samples[test_count - 1U].ts_usec);
+  last_usec = test_samples[test_count - 1U].ts_usec;
+
+  test_queries(first_usec, last_usec);
+  test_retention(last_usec);
+
+  (void)db_disconnect(test_db);
+  printf("%s (%d failures)\n", test_failures ? "FAILED" : "PASSED", test_failures);
+  exit(test_failures != 0);
+}
+
+void tx_application_define(void *first_unused_memory)
+{
+  (void)first_unused_memory;
+
+  meteo_compress_init();
+  meteo_series_init();
+  meteo_export_init();
+  tx_thread_create(&test_thread, "test", test_entry, 0U, test_stack, TEST_STACK_SIZE,
+                   5U, 5U, TX_NO_TIME_SLICE, TX_AUTO_START);
+}
+
+int main(int argc, char *argv[])
+{
+  int opt;
+
+  while ((opt = getopt(argc, argv, "d:")) != -1)
+  {
+    switch (opt)
+    {
+      case 'd':
+        test_days = (uint32_t)atol(optarg);
+        break;
+      default:
+        fprintf(stderr, "Usage: %s [-d days]\n", argv[0]);
+        return 2;
+    }
+  }
+  if (test_days < 1U || test_days > TEST_MAX_DAYS)
+  {
+    fprintf(stderr, "days 1..%u\n", TEST_MAX_DAYS);
+    return 2;
+  }
+
+  tx_kernel_enter();
+  return 0;
+}
@@ -0,0 +1,314 @@
+/**
+  ******************************************************************************
+  * @file    meteo_stats_test.cpp
+  * @brief   Checks and per-value cost of the incremental estimators of
+  *          meteo_stats.hpp: Welford, Ewma, MinMax and Circular.
+  *
+  *          - Welford against a two-pass mean and variance of 100000
+  *            pressures.
+  *          - Ewma: a step reaches half after one half-life, the variance
+  *            of +-1 is 1.
+  *          - MinMax against a brute force min and max over the same
+  *            bucket-aligned window, 200000 values with gaps in time; a
+  *            falling series is exact to one bucket; an expired window is
+  *            empty (NaN).
+  *          - Circular: 350 and 10 average to 0, a constant direction has
+  *            no spread, 200 +- 20 averages to 200.
+  *          Then each estimator takes 10 million values and the time per
+  *          value is printed, with the time to rescan an hour of readings
+  *          for mean and variance as the baseline.
+  *
+  *          Build: g++ -O2 -ICore/Inc -o meteo_stats_test Core/Host/Tools/meteo_stats_test.cpp
+  *          Usage: meteo_stats_test
+  ******************************************************************************
+  */
+
+/* Includes ------------------------------------------------------------------*/
+#include <cmath>
+#include <cstdint>
+#include <cstdio>
+#include <ctime>
+#include <vector>
+
+#include "meteo_stats.hpp"
+
+using namespace meteo::stats;
+
+/* Private defines -----------------------------------------------------------*/
+#define TEST_BENCH_VALUES       10000000
+#define TEST_BENCH_RESCANS      2000
+
+#define CHECK(cond) \
+  do { if (!(cond)) { test_failures++; printf("  FAILED line %d: %s\n", __LINE__, #cond); } } while (0)
+
+/* Private variables ---------------------------------------------------------*/
+static int test_failures;
+static uint32_t test_seed = 1U;
+
+/* Private functions ---------------------------------------------------------*/
+
+static double test_now(void)
+{
+  timespec now;
+
+  clock_gettime(CLOCK_MONOTONIC, &now);
+  return (double)now.tv_sec + (double)now.tv_nsec * 1e-9;
+}
+
+/* xorshift32, the generator of the simulator stations */
+static uint32_t test_random(void)
+{
+  test_seed ^= test_seed << 13;
+  test_seed ^= test_seed >> 17;
+  test_seed ^= test_seed << 5;
+  return test_seed;
+}
+
+static void test_welford(void)
+{
+  std::vector<double> values;
+  Welford<double> welford;
+  Welford<float> single;
+  Welford<double> empty;
+  double mean = 0.0;
+  double variance = 0.0;
+
+  printf("Welford\n");
+  for (int i = 0; i < 100000; i++)
+  {
+    double x = 1013.0 + (double)((int)(test_random() % 2000U) - 1000) / 100.0;
+
+    values.push_back(x);
+    welford.add(x);
+    single.add((float)x);
+  }
+  for (double x : values)
+  {
+    mean += x;
+  }
+  mean /= (double)values.size();
+  for (double x : values)
+  {
+    variance += (x - mean) * (x - mean);
+  }
+  variance /= (double)(values.size() - 1U);
+
+  printf("  mean %.6f variance %.6f, two-pass %.6f %.6f, float mean %.4f\n",
+         welford.mean(), welford.variance(), mean, variance, (double)single.mean());
+  CHECK(std::fabs(welford.mean() - mean) < 1e-9);
+  CHECK(std::fabs(welford.variance() - variance) / variance < 1e-9);
+  CHECK(std::fabs((double)single.mean() - mean) < 0.01);
+
+  CHECK(empty.variance() == 0.0);
+  empty.add(5.0);
+  CHECK(empty.variance() == 0.0 && empty.mean() == 5.0);
+}
+
+static void test_ewma(void)
+{
+  Ewma<float> step(600U, 1U);
+  Ewma<float> noise(10U, 1U);
+
+  printf("Ewma\n");
+  step.add(0.0f);
+  for (int i = 0; i < 600; i++)
+  {
+    step.add(1.0f);
+  }
+  for (int i = 0; i < 10000; i++)
+  {
+    noise.add((i & 1) ? 1.0f : -1.0f);
+  }
+  printf("  step after one half-life %.4f, variance of +-1 %.3f\n",
+         (double)step.mean(), (double)noise.variance());
+  CHECK(std::fabs(step.mean() - 0.5f) < 0.002f);
+  CHECK(std::fabs(noise.variance() - 1.0f) < 0.1f);
+}
+
+static void test_minmax(void)
+{
+  const uint32_t horizon = 100U;
+  const uint32_t buckets = 10U;
+  const uint32_t width = horizon / buckets;
+  MinMax<float, 10> minmax(horizon);
+  MinMax<float, 60> falling(3600U);
+  MinMax<float, 8> expired(10U);
+  MinMax<float, 8> small(3U);
+  std::vector<std::pair<uint32_t, float>> history;
+  uint32_t time = 5U;
+  int errors = 0;
+
+  printf("MinMax\n");
+  for (int i = 0; i < 200000; i++)
+  {
+    float x = (float)(test_random() % 1000U);
+    float lo = INFINITY;
+    float hi = -INFINITY;
+
+    // Mostly steady, now and then a gap longer than the horizon
+    time += (test_random() % 50U == 0U) ? test_random() % 300U : test_random() % 3U;
+    minmax.add(x, time);
+    history.emplace_back(time, x);
+
+    // Brute force over the buckets of the window
+    for (size_t k = history.size(); k-- > 0U && history[k].first / width + buckets > time / width;)
+    {
+      lo = (history[k].second < lo) ? history[k].second : lo;
+      hi = (history[k].second > hi) ? history[k].second : hi;
+    }
+    if (history.size() > 2000U)
+    {
+      history.erase(history.begin(), history.begin() + 1000);
+    }
+    errors += (minmax.min() != lo || minmax.max() != hi) ? 1 : 0;
+  }
+  printf("  random with gaps: %d differences from brute force\n", errors);
+  CHECK(errors == 0);
+
+  // Falling series: the exact hour starts at 16400, the buckets kept at 16440
+  for (uint32_t i = 0U; i < 20000U; i++)
+  {
+    falling.add(30000.0f - (float)i, i);
+  }
+  printf("  falling: max %.0f, exact hour %.0f\n", (double)falling.max(), 30000.0 - (19999 - 3599));
+  CHECK(falling.max() <= 30000.0f - (19999 - 3599) && falling.max() >= 30000.0f - (19999 - 3540));
+
+  expired.add(5.0f, 1U);
+  expired.expire(100U);
+  CHECK(std::isnan(expired.max()) && std::isnan(expired.min()));
+
+  small.add(1.0f, 0U);
+  small.add(2.0f, 1U);
+  CHECK(small.max() == 2.0f && small.min() == 1.0f);
+}
+
+static void test_circular(void)
+{
+  Circular<float> pair;
+  Circular<float> uniform;
+  Circular<float> steady;
+  Circular<float> spread;
+
+  printf("Circular\n");
+  pair.add(350.0f);
+  pair.add(10.0f);
+  printf("  350 and 10: mean %.3f, deviation %.3f, resultant %.4f\n",
+         (double)pair.mean(), (double)pair.stddev(), (double)pair.resultant());
+  CHECK(pair.mean() < 0.01f || pair.mean() > 359.99f);
+  CHECK(pair.stddev() < 10.1f);
+
+  for (int i = 0; i < 360; i++)
+  {
+    uniform.add((float)i);
+  }
+  printf("  0..359: resultant %.6f\n", (double)uniform.resultant());
+  CHECK(uniform.resultant() < 0.001f);
+
+  for (int i = 0; i < 1000; i++)
+  {
+    steady.add(270.0f);
+  }
+  CHECK(std::fabs(steady.mean() - 270.0f) < 0.01f && steady.stddev() < 0.1f);
+
+  for (int i = 0; i < 100000; i++)
+  {
+    spread.add(200.0f + (float)((int)(test_random() % 41U) - 20));
+  }
+  printf("  200 +- 20: mean %.3f, deviation %.3f\n", (double)spread.mean(), (double)spread.stddev());
+  CHECK(std::fabs(spread.mean() - 200.0f) < 0.5f);
+}
+
+static void test_bench(void)
+{
+  std::vector<float> values(4096U);
+  Welford<double> welford_double;
+  Welford<float> welford_float;
+  Ewma<float> ewma(600U);
+  MinMax<float, 60> minmax(3600U);
+  Circular<float> circular;
+  double sink = 0.0;
+  double start;
+
+  for (float &value : values)
+  {
+    value = (float)(test_random() % 36000U) / 100.0f;
+  }
+
+  printf("ns per value\n");
+  start = test_now();
+  for (int i = 0; i < TEST_BENCH_VALUES; i++)
+  {
+    welford_double.add(values[i & 4095]);
+  }
+  printf("  Welford<double>      %5.1f\n", (test_now() - start) / TEST_BENCH_VALUES * 1e9);
+
+  start = test_now();
+  for (int i = 0; i < TEST_BENCH_VALUES; i++)
+  {
+    welford_float.add(values[i & 4095]);
+  }
+  printf("  Welford<float>       %5.1f\n", (test_now() - start) / TEST_BENCH_VALUES * 1e9);
+
+  start = test_now();
+  for (int i = 0; i < TEST_BENCH_VALUES; i++)
+  {
+    ewma.add(values[i & 4095]);
+  }
+  printf("  Ewma<float>          %5.1f\n", (test_now() - start) / TEST_BENCH_VALUES * 1e9);
+
+  start = test_now();
+  for (int i = 0; i < TEST_BENCH_VALUES; i++)
+  {
+    minmax.add(values[i & 4095], (uint32_t)i);
+  }
+  printf("  MinMax<float, 60>    %5.1f\n", (test_now() - start) / TEST_BENCH_VALUES * 1e9);
+
+  start = test_now();
+  for (int i = 0; i < TEST_BENCH_VALUES; i++)
+  {
+    circular.add(values[i & 4095]);
+  }
+  printf("  Circular<float>      %5.1f\n", (test_now() - start) / TEST_BENCH_VALUES * 1e9);
+
+  // Baseline: mean and variance of the last hour scanned again each time
+  start = test_now();
+  for (int r = 0; r < TEST_BENCH_RESCANS; r++)
+  {
+    double mean = 0.0;
+    double variance = 0.0;
+
+    for (int i = 0; i < 3600; i++)
+    {
+      mean += values[(i + r) & 4095];
+    }
+    mean /= 3600.0;
+    for (int i = 0; i < 3600; i++)
+    {
+      double delta = values[(i + r) & 4095] - mean;
+
+      variance += delta * delta;
+    }
+    sink += variance;
+  }
+  printf("rescan of 3600 values for mean and variance: %.1f us\n",
+         (test_now() - start) / TEST_BENCH_RESCANS * 1e6);
+
+  // Keep the results alive
+  sink += welford_double.mean() + welford_float.mean() + ewma.mean() + minmax.max() + circular.mean();
+  if (std::isnan(sink))
+  {
+    printf("  (nan)\n");
+  }
+}
+
+int main(void)
+{
+  test_welford();
+  test_ewma();
+  test_minmax();
+  test_circular();
+  test_bench();
+
+  printf("%s (%d failures)\n", test_failures ? "FAILED" : "PASSED", test_failures);
+  return test_failures != 0;
+}
@@ -0,0 +1,320 @@
+/**
+  ******************************************************************************
+  * @file    meteo_streams_test.c
+  * @brief   Smoke test of the stream glue (meteo_example.c, meteo_streams.c,
+  *          meteo_database.c) on the ITTIA stand-in of the Linux host
+  *          (host_ittia_db.c).
+  *
+  *          - meteo_example_init() and run_meteo_example() create the
+  *            meteo_readings4 stream; it cannot be registered twice.
+  *          - A frame through ProcessMeteoFrameToStream() is one row of
+  *            the stream: the real-time view holds the values of
+  *            meteo_archive_store_parse_frame(), id 1 until the IDC agent
+  *            sets meteo_instance_id, and the time of HAL_GetTick(). A
+  *            reading with its own time keeps it. A frame that does not
+  *            parse is no row.
+  *          - Table: open_meteo_database() and
+  *            output_stream_to_meteo_readings_table() keep the latest row
+  *            of each id. delete_meteo_readings_before(), one row a call,
+  *            removes the rows past a time and goes on from the id where
+  *            the call before stopped.
+  *          - 4 ThreadX threads, time-sliced, each with its own input into
+  *            the same table: no row is lost.
+  *          Then the ns per put_meteo_readings_stream() into the view and
+  *          the table.
+  *
+  *          Build: TX=Middlewares/ST/threadx
+  *                 DB=Middlewares/Third_Party/ITTIA_DB_Database_ITTIA_DB_Lite/ITTIA_DB_Lite
+  *                 gcc -O2 -DTX_INCLUDE_USER_DEFINE_FILE -DOS_LINUX -ICore/Host/Inc -ICore/Inc
+  *                     -I$TX/ports/linux/gnu/inc -I$TX/common/inc
+  *                     -I$TX/utility/execution_profile_kit -I$DB/inc -o meteo_streams_test
+  *                     Core/Host/Tools/meteo_streams_test.c Core/Src/meteo_example.c
+  *                     Core/Src/meteo_streams.c Core/Src/meteo_database.c
+  *                     Core/Host/Src/host_ittia_db.c $DB/src/dbs_error_info.c
+  *                     Core/Src/meteo_archive.c Core/Src/meteo_archive_store.c
+  *                     Core/Src/meteo_ospi.c Core/Src/meteo_trace.c Core/Src/meteo_format.c
+  *                     Core/Host/Src/host_ospi.c
+  *                     <the ThreadX sources of the meteo_host build line in
+  *                     README.md> -lpthread
+  *          Usage: meteo_streams_test [-n rows]
+  *            -n  rows per thread and for the timing (default 20000)
+  ******************************************************************************
+  */
+
+/* Includes ------------------------------------------------------------------*/
+#include <math.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <unistd.h>
+
+#include "tx_api.h"
+#include "host_ittia_db.h"
+#include "meteo_archive_store.h"
+#include "meteo_console.h"
+#include "meteo_database.h"
+#include "meteo_example.h"
+#include "meteo_streams.h"
+
+/* Private defines -----------------------------------------------------------*/
+#define TEST_STACK_SIZE         16384U
+#define TEST_ROW_BYTES          36U         /* meteo_readings4 row, packed */
+#define TEST_WRITERS            4U
+#define TEST_WRITER_ID_STEP     1000000
+#define TEST_DATABASE           "meteo_streams_test"
+
+#define CHECK(cond, ...) \
+  do { if (!(cond)) { test_failures++; printf("  FAILED line %d: ", __LINE__); \
+                      printf(__VA_ARGS__); printf("\n"); } } while (0)
+
+/* Private variables ---------------------------------------------------------*/
+static TX_THREAD test_thread;
+static UCHAR test_stack[TEST_STACK_SIZE];
+static TX_THREAD test_writer[TEST_WRITERS];
+static UCHAR test_writer_stack[TEST_WRITERS][TEST_STACK_SIZE];
+static TX_SEMAPHORE test_done;
+
+static db_t test_db;
+static uint32_t test_tick;
+static long test_rows = 20000L;
+static int test_failures;
+
+/* Private functions ---------------------------------------------------------*/
+
+uint32_t HAL_GetTick(void)
+{
+  return test_tick;
+}
+
+/* meteo_trace.c sets it around a dump; no console here */
+meteo_console_overflow_t meteo_console_set_overflow(meteo_console_overflow_t policy)
+{
+  return policy;
+}
+
+static double test_now(void)
+{
+  struct timespec now;
+
+  clock_gettime(CLOCK_MONOTONIC, &now);
+  return (double)now.tv_sec + (double)now.tv_nsec * 1e-9;
+}
+
+static meteo_readings_row_t test_view(void)
+{
+  meteo_readings_row_t row;
+
+  get_meteo_readings_stream(meteo_output_node, &row);
+  return row;
+}
+
+static void test_frames(void)
+{
+  static const char frame[] = "UUU$02047.10132.2715.00034.115.ABCD*QQQ";
+  meteo_archive_sample_t sample;
+  meteo_readings_row_t row;
+  uint32_t rows;
+  int32_t id = 7;
+
+  printf("frames\n");
+  CHECK(meteo_example_init(NULL, NULL) == EXIT_SUCCESS, "meteo_example_init");
+  CHECK(run_meteo_example(NULL, NULL) == EXIT_SUCCESS, "run_meteo_example");
+  CHECK(db_stream_register_output(&meteo_output_node, meteo_input_node, meteo_stream_env,
+                                  "meteo_readings4") == DB_EEXIST, "stream registered twice");
+
+  test_tick = 5000U;
+  ProcessMeteoFrameToStream(frame);
+  row = test_view();
+  CHECK(host_ittia_db_stream_rows(meteo_stream_env, "meteo_readings4") == 1U, "one row");
+  CHECK(row.id == 1 && row.ts == 5000000, "id %ld ts %lld", (long)row.id, (long long)row.ts);
+  CHECK(fabs(row.temperature - 20.47) < 1e-4 && fabs(row.wind_speed - 3.4) < 1e-4 &&
+        fabs(row.wind_direction - 271.5) < 1e-4, "T %.4f WS %.4f WD %.4f",
+        row.temperature, row.wind_speed, row.wind_direction);
+
+  // Once the IDC agent has connected
+  meteo_instance_id = &id;
+  CHECK(meteo_archive_store_parse_frame(frame, &sample) == TX_SUCCESS, "parse");
+  sample.ts_usec = 1234567;
+  ProcessMeteoSampleToStream(&sample);
+  row = test_view();
+  CHECK(row.id == 7 && row.ts == 1234567, "id %ld ts %lld", (long)row.id, (long long)row.ts);
+  meteo_instance_id = NULL;
+
+  rows = host_ittia_db_stream_rows(meteo_stream_env, "meteo_readings4");
+  ProcessMeteoFrameToStream("UUU$02047.10132.27");
+  ProcessMeteoFrameToStream("garbage");
+  CHECK(host_ittia_db_stream_rows(meteo_stream_env, "meteo_readings4") == rows, "bad frames stored");
+  CHECK(test_view().ts == 1234567, "view changed by a bad frame");
+}
+
+static void test_table(void)
+{
+  db_database_config_t config;
+  meteo_readings_row_t row = { 0, 0, 20.0, 1.0, 90.0 };
+  static const int32_t ids[] = { 3, 1, 2, 1, 3 };
+  uint32_t i;
+
+  printf("table\n");
+  memset(&config, 0, sizeof(config));
+  config.flags = DB_OPEN_OR_CREATE;
+  config.page_size = DB_DEF_PAGE_SIZE;
+  CHECK(open_meteo_database(TEST_DATABASE, &config) == DB_NOERROR, "open_meteo_database");
+  CHECK(db_connect(&test_db, TEST_DATABASE, NULL, NULL, NULL) == DB_NOERROR, "db_connect");
+  CHECK(output_stream_to_meteo_readings_table(meteo_input_node, test_db, NULL) == DB_NOERROR,
+        "output_stream_to_meteo_readings_table");
+
+  for (i = 0; i < sizeof(ids) / sizeof(ids[0]); i++)
+  {
+    row.id = ids[i];
+    row.ts = (db_timestamp_usec_t)(i + 1U) * 1000000;
+    CHECK(put_meteo_readings_stream(meteo_input_node, &row) == DB_NOERROR, "put %lu", (unsigned long)i);
+  }
+  printf("  %lu puts of 3 ids: %ld rows\n", (unsigned long)i, (long)host_ittia_db_index_rows(test_db, 0));
+  CHECK(host_ittia_db_index_rows(test_db, 0) == 3, "%ld rows, expected 3", (long)host_ittia_db_index_rows(test_db, 0));
+}
+
+/* The table holds id 1 at 4 s, id 2 at 3 s, id 3 at 5 s */
+static void test_delete(void)
+{
+  static const size_t expected[] = { 1U, 1U, 0U, 0U };
+  static const int32_t next[] = { 2, 3, 4, INT32_MIN };
+  int32_t next_id = INT32_MIN;
+  size_t removed;
+  size_t bytes;
+  uint32_t i;
+
+  printf("delete\n");
+  for (i = 0; i < sizeof(expected) / sizeof(expected[0]); i++)
+  {
+    CHECK(delete_meteo_readings_before(test_db, 4500000, 1U, &next_id, &removed, &bytes) == DB_NOERROR,
+          "delete_meteo_readings_before %lu", (unsigned long)i);
+    CHECK(removed == expected[i] && next_id == next[i], "call %lu: %lu removed, next id %ld", (unsigned long)i,
+          (unsigned long)removed, (long)next_id);
+    CHECK(bytes == removed * TEST_ROW_BYTES, "call %lu: %lu bytes", (unsigned long)i, (unsigned long)bytes);
+  }
+  printf("  ids 1 and 2 before 4.5 s: %ld rows left\n", (long)host_ittia_db_index_rows(test_db, 0));
+  CHECK(host_ittia_db_index_rows(test_db, 0) == 1, "%ld rows, expected 1", (long)host_ittia_db_index_rows(test_db, 0));
+}
+
+/* Its own graph and input, ids of its own */
+static void test_writer_entry(ULONG input)
+{
+  static const db_fielddef_t fields[] = {
+    { kMeteoReadingsId,            "id",             DB_COLTYPE_SINT32,    0, 0, DB_NOT_NULL, NULL, 0 },
+    { kMeteoReadingsTs,            "ts",             DB_COLTYPE_TIMESTAMP, 0, 0, DB_NOT_NULL, NULL, 0 },
+    { kMeteoReadingsTemperature,   "temperature",    DB_COLTYPE_FLOAT64,   0, 0, DB_NOT_NULL, NULL, 0 },
+    { kMeteoReadingsWindSpeed,     "wind_speed",     DB_COLTYPE_FLOAT64,   0, 0, DB_NOT_NULL, NULL, 0 },
+    { kMeteoReadingsWindDirection, "wind_direction", DB_COLTYPE_FLOAT64,   0, 0, DB_NOT_NULL, NULL, 0 },
+  };
+  static const db_fieldno_t keys[] = { kMeteoReadingsId };
+  meteo_readings_row_t row = { 0, 0, 20.0, 1.0, 90.0 };
+  db_stream_graph_t graph;
+  db_stream_node_t node;
+  long i;
+
+  if (db_stream_create_graph(&graph, NULL, 0) != DB_NOERROR ||
+      db_stream_create_row_input_compound_key(&node, graph, fields, 5, kMeteoReadingsTs, keys, 1) != DB_NOERROR ||
+      output_stream_to_meteo_readings_table(node, test_db, NULL) != DB_NOERROR)
+  {
+    CHECK(0, "writer %lu set-up", (unsigned long)input);
+  }
+  else
+  {
+    for (i = 0; i < test_rows; i++)
+    {
+      row.id = TEST_WRITER_ID_STEP * (int32_t)(input + 1U) + (int32_t)i;
+      row.ts = i;
+      CHECK(put_meteo_readings_stream(node, &row) == DB_NOERROR, "writer %lu put %ld", (unsigned long)input, i);
+    }
+    db_stream_free_graph(graph, NULL);
+  }
+  tx_semaphore_put(&test_done);
+}
+
+static void test_writers(void)
+{
+  int32_t before = host_ittia_db_index_rows(test_db, 0);
+  int32_t after;
+  uint32_t i;
+
+  printf("writers\n");
+  tx_semaphore_create(&test_done, "done", 0U);
+  for (i = 0; i < TEST_WRITERS; i++)
+  {
+    tx_thread_create(&test_writer[i], "writer", test_writer_entry, i, test_writer_stack[i], TEST_STACK_SIZE,
+                     10U, 10U, 1U, TX_AUTO_START);
+  }
+  for (i = 0; i < TEST_WRITERS; i++)
+  {
+    tx_semaphore_get(&test_done, TX_WAIT_FOREVER);
+  }
+  after = host_ittia_db_index_rows(test_db, 0);
+  printf("  %lu threads x %ld rows: %ld new rows\n", (unsigned long)TEST_WRITERS, test_rows, (long)(after - before));
+  CHECK(after - before == (int32_t)TEST_WRITERS * (int32_t)test_rows, "%ld rows lost",
+        (long)TEST_WRITERS * test_rows - (long)(after - before));
+}
+
+static void test_bench(void)
+{
+  meteo_readings_row_t row = { 1, 0, 20.0, 1.0, 90.0 };
+  double start = test_now();
+  long i;
+
+  for (i = 0; i < test_rows; i++)
+  {
+    row.id = 1 + (int32_t)(i % 8);
+    row.ts = i;
+    (void)put_meteo_readings_stream(meteo_input_node, &row);
+  }
+  printf("ns per put (view and table): %.0f\n", (test_now() - start) / (double)test_rows * 1e9);
+}
+
+static void test_entry(ULONG input)
+{
+  (void)input;
+
+  test_frames();
+  test_table();
+  test_delete();
+  test_writers();
+  test_bench();
+
+  printf("%s (%d failures)\n", test_failures ? "FAILED" : "PASSED", test_failures);
+  exit(test_failures != 0);
+}
+
+void tx_application_define(void *first_unused_memory)
+{
+  (void)first_unused_memory;
+
+  tx_thread_create(&test_thread, "test", test_entry, 0U, test_stack, TEST_STACK_SIZE,
+                   5U, 5U, TX_NO_TIME_SLICE, TX_AUTO_START);
+}
+
+int main(int argc, char *argv[])
+{
+  int opt;
+
+  while ((opt = getopt(argc, argv, "n:")) != -1)
+  {
+    switch (opt)
+    {
+      case 'n':
+        test_rows = atol(optarg);
+        break;
+      default:
+        fprintf(stderr, "Usage: %s [-n rows]\n", argv[0]);
+        return 2;
+    }
+  }
+  if (test_rows < 1L || test_rows > 100000L)
+  {
+    fprintf(stderr, "rows 1..100000\n");
+    return 2;
+  }
+
+  tx_kernel_enter();
+  return 0;
+}
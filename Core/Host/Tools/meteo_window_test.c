@@ -0,0 +1,296 @@
+/**
+  ******************************************************************************
+  * @file    meteo_window_test.c
+  * @brief   Checks and add cost of the NanoEdge window (meteo_window.c) on
+  *          the Linux port of ThreadX.
+  *
+  *          - meteo_window_get() is NULL until the window is full, then the
+  *            last METEO_WINDOW_SAMPLES readings, oldest first, axes
+  *            interleaved, in one array: compared after every add with a
+  *            plain ring of the same readings, across many wraps.
+  *          - Callback cadence for K = 1, 7, 16, 64 and 100: the first call
+  *            when the window fills, then every K readings, the window of
+  *            each call equal to the plain ring. Setting the callback again
+  *            halfway calls on the next add; NULL or K = 0 stops the calls.
+  *          - The counters follow.
+  *          Then the ns per add, against an unwrapping copy of a ring on
+  *          every add (what a library needing one array would otherwise
+  *          cost).
+  *
+  *          Build: TX=Middlewares/ST/threadx
+  *                 gcc -O2 -DTX_INCLUDE_USER_DEFINE_FILE -ICore/Host/Inc -ICore/Inc
+  *                     -I$TX/ports/linux/gnu/inc -I$TX/common/inc
+  *                     -I$TX/utility/execution_profile_kit -o meteo_window_test
+  *                     Core/Host/Tools/meteo_window_test.c Core/Src/meteo_window.c
+  *                     <the ThreadX sources of the meteo_host build line in
+  *                     README.md> -lpthread
+  *          Usage: meteo_window_test
+  ******************************************************************************
+  */
+
+/* Includes ------------------------------------------------------------------*/
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+#include "tx_api.h"
+#include "meteo_window.h"
+
+/* Private defines -----------------------------------------------------------*/
+#define TEST_STACK_SIZE         16384U
+#define TEST_STRIDE             (METEO_WINDOW_SAMPLES * METEO_WINDOW_AXES)
+#define TEST_READINGS           5000U
+#define TEST_BENCH_ADDS         2000000L
+
+#define CHECK(cond, ...) \
+  do { if (!(cond)) { if (test_failures++ < 20) { printf("  FAILED line %d: ", __LINE__); \
+       printf(__VA_ARGS__); printf("\n"); } } } while (0)
+
+/* Private variables ---------------------------------------------------------*/
+static TX_THREAD test_thread;
+static UCHAR test_stack[TEST_STACK_SIZE];
+
+/* Plain ring of every reading added, and its unwrapped copy */
+static float test_ring[TEST_STRIDE];
+static float test_copy[TEST_STRIDE];
+static uint32_t test_added;
+
+/* Calls seen by the callback */
+static uint32_t test_calls;
+static uint32_t test_last_call;
+static uint32_t test_bad_windows;
+
+static int test_failures;
+
+/* Private functions ---------------------------------------------------------*/
+
+static double test_now(void)
+{
+  struct timespec now;
+
+  clock_gettime(CLOCK_MONOTONIC, &now);
+  return (double)now.tv_sec + (double)now.tv_nsec * 1e-9;
+}
+
+/* Reading n: every value tells which reading and which axis it is */
+static void test_reading(uint32_t n, float *values)
+{
+  uint32_t axis;
+
+  for (axis = 0U; axis < METEO_WINDOW_AXES; axis++)
+  {
+    values[axis] = (float)n * 8.0f + (float)axis;
+  }
+}
+
+static void test_unwrap(void)
+{
+  uint32_t oldest = (test_added % METEO_WINDOW_SAMPLES) * METEO_WINDOW_AXES;
+
+  memcpy(test_copy, &test_ring[oldest], (TEST_STRIDE - oldest) * sizeof(float));
+  memcpy(&test_copy[TEST_STRIDE - oldest], test_ring, oldest * sizeof(float));
+}
+
+static void test_callback(void *context, const float *window)
+{
+  float newest[METEO_WINDOW_AXES];
+
+  (void)context;
+
+  test_calls++;
+  test_last_call = test_added + 1U;
+  // test_copy is the window before this reading
+  test_reading(test_added, newest);
+  if (memcmp(window, &test_copy[METEO_WINDOW_AXES], (TEST_STRIDE - METEO_WINDOW_AXES) * sizeof(float)) != 0 ||
+      memcmp(&window[TEST_STRIDE - METEO_WINDOW_AXES], newest, sizeof(newest)) != 0)
+  {
+    test_bad_windows++;
+  }
+}
+
+static void test_add(void)
+{
+  float values[METEO_WINDOW_AXES];
+
+  test_reading(test_added, values);
+  test_unwrap();
+  meteo_window_add(values);
+  memcpy(&test_ring[(test_added % METEO_WINDOW_SAMPLES) * METEO_WINDOW_AXES], values, sizeof(values));
+  test_added++;
+}
+
+static void test_contents(void)
+{
+  const float *window;
+  uint32_t n;
+
+  printf("contents\n");
+  for (n = 0U; n < TEST_READINGS; n++)
+  {
+    test_add();
+    window = meteo_window_get();
+    if (test_added < METEO_WINDOW_SAMPLES)
+    {
+      CHECK(window == NULL, "window after %lu readings", (unsigned long)test_added);
+      continue;
+    }
+    test_unwrap();
+    CHECK(window != NULL && memcmp(window, test_copy, sizeof(test_copy)) == 0,
+          "window after %lu readings", (unsigned long)test_added);
+    CHECK(window != NULL && window[TEST_STRIDE - METEO_WINDOW_AXES] == (float)(test_added - 1U) * 8.0f,
+          "newest reading after %lu", (unsigned long)test_added);
+    if (test_failures > 0)
+    {
+      break;
+    }
+  }
+  printf("  %lu readings, %lu wraps\n", (unsigned long)test_added,
+         (unsigned long)(test_added / METEO_WINDOW_SAMPLES));
+}
+
+static void test_cadence(uint32_t every)
+{
+  meteo_window_stats_t before;
+  meteo_window_stats_t after;
+  uint32_t first;
+  uint32_t expected;
+  uint32_t n;
+
+  meteo_window_get_stats(&before);
+  test_calls = 0U;
+  test_bad_windows = 0U;
+
+  // Full already: the first call is on the next add
+  meteo_window_set_callback(test_callback, NULL, every);
+  first = test_added + 1U;
+  for (n = 0U; n < TEST_READINGS; n++)
+  {
+    test_add();
+    if (test_calls > 0U && test_last_call == test_added)
+    {
+      CHECK((test_added - first) % every == 0U, "K %lu: call at reading %lu, first %lu", (unsigned long)every,
+            (unsigned long)test_added, (unsigned long)first);
+    }
+  }
+  meteo_window_get_stats(&after);
+  expected = 1U + (TEST_READINGS - 1U) / every;
+  printf("  K %3lu: %lu calls in %lu readings\n", (unsigned long)every, (unsigned long)test_calls,
+         (unsigned long)TEST_READINGS);
+  CHECK(test_calls == expected, "K %lu: %lu calls, expected %lu", (unsigned long)every,
+        (unsigned long)test_calls, (unsigned long)expected);
+  CHECK(test_bad_windows == 0U, "K %lu: %lu windows differ", (unsigned long)every,
+        (unsigned long)test_bad_windows);
+  CHECK(after.windows - before.windows == test_calls && after.every == every,
+        "K %lu: stats windows %lu, every %lu", (unsigned long)every,
+        (unsigned long)(after.windows - before.windows), (unsigned long)after.every);
+  CHECK(after.samples - before.samples == TEST_READINGS, "K %lu: stats samples %lu", (unsigned long)every,
+        (unsigned long)(after.samples - before.samples));
+}
+
+static void test_stop(void)
+{
+  uint32_t n;
+
+  meteo_window_set_callback(test_callback, NULL, 0U);
+  test_calls = 0U;
+  for (n = 0U; n < 200U; n++)
+  {
+    test_add();
+  }
+  CHECK(test_calls == 0U, "K 0: %lu calls", (unsigned long)test_calls);
+
+  meteo_window_set_callback(NULL, NULL, 5U);
+  for (n = 0U; n < 200U; n++)
+  {
+    test_add();
+  }
+  CHECK(test_calls == 0U, "NULL callback: %lu calls", (unsigned long)test_calls);
+}
+
+/* The first call waits for a full window */
+static void test_fill(void)
+{
+  uint32_t n;
+
+  // The window is never emptied: run before anything was added
+  CHECK(test_added == 0U, "fill check after %lu readings", (unsigned long)test_added);
+  meteo_window_set_callback(test_callback, NULL, 1U);
+  for (n = 0U; n < METEO_WINDOW_SAMPLES; n++)
+  {
+    test_add();
+  }
+  CHECK(test_calls == 1U && test_last_call == METEO_WINDOW_SAMPLES, "%lu calls while filling, last at %lu",
+        (unsigned long)test_calls, (unsigned long)test_last_call);
+  CHECK(test_bad_windows == 0U, "first window differs");
+  meteo_window_set_callback(NULL, NULL, 0U);
+}
+
+static void test_bench(void)
+{
+  float values[METEO_WINDOW_AXES];
+  double start;
+  double window_ns;
+  double copy_ns;
+  float sink = 0.0f;
+  long i;
+
+  meteo_window_set_callback(NULL, NULL, 0U);
+  test_reading(1U, values);
+  start = test_now();
+  for (i = 0; i < TEST_BENCH_ADDS; i++)
+  {
+    values[0] = (float)i;
+    meteo_window_add(values);
+    sink += meteo_window_get()[0];
+  }
+  window_ns = (test_now() - start) / (double)TEST_BENCH_ADDS * 1e9;
+
+  start = test_now();
+  for (i = 0; i < TEST_BENCH_ADDS; i++)
+  {
+    values[0] = (float)i;
+    memcpy(&test_ring[(test_added % METEO_WINDOW_SAMPLES) * METEO_WINDOW_AXES], values, sizeof(values));
+    test_added++;
+    test_unwrap();
+    sink += test_copy[0];
+  }
+  copy_ns = (test_now() - start) / (double)TEST_BENCH_ADDS * 1e9;
+
+  printf("ns per add: window %.1f, ring and unwrapping copy %.1f (%g)\n", window_ns, copy_ns, (double)sink);
+}
+
+static void test_entry(ULONG input)
+{
+  (void)input;
+
+  test_fill();
+  test_contents();
+  printf("cadence\n");
+  test_cadence(1U);
+  test_cadence(7U);
+  test_cadence(16U);
+  test_cadence(METEO_WINDOW_SAMPLES);
+  test_cadence(100U);
+  test_stop();
+  test_bench();
+
+  printf("%s (%d failures)\n", test_failures ? "FAILED" : "PASSED", test_failures);
+  exit(test_failures != 0);
+}
+
+void tx_application_define(void *first_unused_memory)
+{
+  (void)first_unused_memory;
+
+  meteo_window_init();
+  tx_thread_create(&test_thread, "test", test_entry, 0U, test_stack, TEST_STACK_SIZE,
+                   5U, 5U, TX_NO_TIME_SLICE, TX_AUTO_START);
+}
+
+int main(void)
+{
+  tx_kernel_enter();
+  return 0;
+}
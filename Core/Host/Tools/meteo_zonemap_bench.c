@@ -0,0 +1,310 @@
+/**
+  ******************************************************************************
+  * @file    meteo_zonemap_bench.c
+  * @brief   Flash bytes read by archive queries with and without the zone
+  *          map (meteo_archive_store.c), on the emulated OSPI flash of the
+  *          Linux host.
+  *
+  *          8 days of readings at 1 Hz go into the archive through
+  *          meteo_archive_store_add_frame(): temperature and pressure that
+  *          follow the day and the week, a gusty wind with two 6-hour
+  *          storms (20-29 m/s), a noisy direction. Then, for each query:
+  *          - meteo_archive_store_query(): blocks skipped by the zone map,
+  *            segments by their header, the rest read whole;
+  *          - the same walk without the zone map, every block entered and
+  *            every segment header read (counted here from the flash);
+  *          - a scan of every segment, the bytes a reader without any map
+  *            would read.
+  *          The samples the query returns must be those a decode of the
+  *          whole flash finds.
+  *
+  *          Build: TX=Middlewares/ST/threadx
+  *                 gcc -O2 -DTX_INCLUDE_USER_DEFINE_FILE -ICore/Host/Inc -ICore/Inc
+  *                     -I$TX/ports/linux/gnu/inc -I$TX/common/inc
+  *                     -I$TX/utility/execution_profile_kit -o meteo_zonemap_bench
+  *                     Core/Host/Tools/meteo_zonemap_bench.c Core/Src/meteo_archive.c
+  *                     Core/Src/meteo_archive_store.c Core/Src/meteo_ospi.c
+  *                     Core/Src/meteo_trace.c Core/Host/Src/host_ospi.c
+  *                     <the ThreadX sources of the meteo_host build line in
+  *                     README.md> -lpthread -lm
+  *          Usage: meteo_zonemap_bench [-d days]
+  ******************************************************************************
+  */
+
+/* Includes ------------------------------------------------------------------*/
+#include <float.h>
+#include <math.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+
+#include "tx_api.h"
+#include "lx_stm32_ospi_driver.h"
+#include "meteo_archive.h"
+#include "meteo_archive_store.h"
+#include "meteo_console.h"
+#include "meteo_ospi.h"
+
+/* Private defines -----------------------------------------------------------*/
+#define TEST_STACK_SIZE         16384U
+#define TEST_BLOCK_SIZE         65536U
+#define TEST_ARCHIVE_BYTES      (METEO_ARCHIVE_STORE_BLOCKS * TEST_BLOCK_SIZE)
+#define TEST_DAY_SECONDS        86400U
+#define TEST_HOUR_USEC          3600000000LL
+#define TEST_DAY_USEC           (24LL * TEST_HOUR_USEC)
+
+#define CHECK(cond, ...) \
+  do { if (!(cond)) { if (test_failures++ < 20) { printf("  FAILED line %d: ", __LINE__); \
+       printf(__VA_ARGS__); printf("\n"); } } } while (0)
+
+/* Private types -------------------------------------------------------------*/
+typedef struct
+{
+  uint32_t matched;
+  uint32_t headers_bytes;   /* Without the zone map */
+  uint32_t scan_bytes;      /* Every segment whole */
+} test_walk_t;
+
+/* Private variables ---------------------------------------------------------*/
+static TX_THREAD test_thread;
+static UCHAR test_stack[TEST_STACK_SIZE];
+
+static uint8_t test_image[TEST_ARCHIVE_BYTES];
+static ULONG test_base;
+
+static uint32_t test_tick;
+static uint32_t test_days = 8U;
+static uint32_t test_rng = 0x2545F491UL;
+static int test_failures;
+
+/* Private functions ---------------------------------------------------------*/
+
+/* The archive clock, moved by hand: one reading a second */
+uint32_t HAL_GetTick(void)
+{
+  return test_tick;
+}
+
+/* meteo_trace.c sets it around a dump; no console here */
+meteo_console_overflow_t meteo_console_set_overflow(meteo_console_overflow_t policy)
+{
+  return policy;
+}
+
+static uint32_t test_random(void)
+{
+  test_rng ^= test_rng << 13;
+  test_rng ^= test_rng >> 17;
+  test_rng ^= test_rng << 5;
+  return test_rng;
+}
+
+/* Reading n seconds after the start, in the units of the frame */
+static void test_fill(void)
+{
+  meteo_archive_store_stats_t stats;
+  char frame[64];
+  double t;
+  long temp;
+  long wind;
+  long dir;
+  uint32_t day;
+  uint32_t hour;
+  uint32_t n;
+
+  for (n = 0U; n < test_days * TEST_DAY_SECONDS; n++)
+  {
+    t = (double)n;
+    day = n / TEST_DAY_SECONDS;
+    hour = (n % TEST_DAY_SECONDS) / 3600U;
+    temp = lround(1500.0 + 800.0 * sin(t * 2.0 * M_PI / 86400.0) + 300.0 * sin(t * 2.0 * M_PI / 691200.0)) +
+           (long)(test_random() % 5U) - 2L;
+    wind = lround(30.0 + 20.0 * sin(t * 2.0 * M_PI / 3600.0)) + (long)(test_random() % 30U);
+    if ((day == 2U || day == 5U) && hour >= 12U && hour < 18U)
+    {
+      wind = 200L + (long)(test_random() % 90U);
+    }
+    dir = (lround(1800.0 + 900.0 * sin(t * 2.0 * M_PI / 43200.0)) + (long)(test_random() % 100U) + 3550L) % 3600L;
+    snprintf(frame, sizeof(frame), "UUU$%05ld.%05ld.%04ld.%05ld.%03lu.ABCD*QQQ", temp,
+             lround(10132.0 + 80.0 * sin(t * 2.0 * M_PI / 259200.0)), dir, wind,
+             (unsigned long)(115U + test_random() % 2U));
+    test_tick += 1000U;
+    if (meteo_archive_store_add_frame(frame) != TX_SUCCESS)
+    {
+      CHECK(0, "add of reading %lu", (unsigned long)n);
+      break;
+    }
+  }
+  meteo_archive_store_flush();
+  meteo_archive_store_get_stats(&stats);
+  printf("%lu days at 1 Hz: %lu segments, %lu bytes (%.2f a sample)\n",
+         (unsigned long)test_days, (unsigned long)stats.segments, (unsigned long)stats.bytes,
+         (double)stats.bytes / (double)stats.samples);
+}
+
+static int test_match(const meteo_archive_query_t *query, int64_t ts_min, int64_t ts_max,
+                      const meteo_archive_range_t *range)
+{
+  if (ts_max < query->from_usec || ts_min > query->to_usec)
+  {
+    return 0;
+  }
+  return query->channel >= METEO_ARCHIVE_CHANNELS ||
+         (range[query->channel].max >= query->min && range[query->channel].min <= query->max);
+}
+
+/* The query over the flash image without the zone map: what the cursor
+   reads when it must enter every block, and the samples it must return */
+static void test_walk(const meteo_archive_query_t *query, test_walk_t *walk)
+{
+  meteo_archive_decoder_t decoder;
+  meteo_archive_header_t header;
+  meteo_archive_sample_t sample;
+  uint32_t block;
+  uint32_t offset;
+
+  memset(walk, 0, sizeof(*walk));
+  for (block = 0U; block < METEO_ARCHIVE_STORE_BLOCKS; block++)
+  {
+    offset = block * TEST_BLOCK_SIZE;
+    while (1)
+    {
+      // The header that ends the block is read too
+      walk->headers_bytes += METEO_ARCHIVE_HEADER_SIZE;
+      if (offset + METEO_ARCHIVE_HEADER_SIZE > (block + 1U) * TEST_BLOCK_SIZE ||
+          meteo_archive_header_read(&test_image[offset], METEO_ARCHIVE_HEADER_SIZE, &header) != METEO_ARCHIVE_OK ||
+          offset + header.bytes > (block + 1U) * TEST_BLOCK_SIZE)
+      {
+        break;
+      }
+      walk->scan_bytes += header.bytes;
+      if (test_match(query, header.ts_min_usec, header.ts_max_usec, header.range))
+      {
+        walk->headers_bytes += header.bytes - METEO_ARCHIVE_HEADER_SIZE;
+        if (meteo_archive_decoder_init(&decoder, &test_image[offset], header.bytes) == METEO_ARCHIVE_OK)
+        {
+          while (meteo_archive_decoder_next(&decoder, &sample) == METEO_ARCHIVE_OK)
+          {
+            if (sample.ts_usec >= query->from_usec && sample.ts_usec <= query->to_usec &&
+                (query->channel >= METEO_ARCHIVE_CHANNELS ||
+                 (sample.value[query->channel] >= query->min && sample.value[query->channel] <= query->max)))
+            {
+              walk->matched++;
+            }
+          }
+        }
+      }
+      offset += header.bytes;
+    }
+  }
+}
+
+static int test_count(void *context, const meteo_archive_sample_t *sample)
+{
+  (void)sample;
+
+  (*(uint32_t *)context)++;
+  return 0;
+}
+
+static void test_query(const char *name, int64_t from_usec, int64_t to_usec, uint32_t channel,
+                       float min, float max)
+{
+  meteo_archive_query_t query;
+  meteo_archive_query_stats_t stats;
+  test_walk_t walk;
+  uint32_t matched = 0U;
+
+  query.from_usec = from_usec;
+  query.to_usec = to_usec;
+  query.channel = channel;
+  query.min = min;
+  query.max = max;
+  CHECK(meteo_archive_store_query(&query, test_count, &matched, &stats) == TX_SUCCESS, "%s: query", name);
+  test_walk(&query, &walk);
+
+  printf("%-28s %7lu %9lu %5.1f %% %9lu %5.1f %% %9lu  %3lu/%3lu\n", name, (unsigned long)matched,
+         (unsigned long)stats.bytes_read, 100.0 * (double)stats.bytes_read / (double)walk.scan_bytes,
+         (unsigned long)walk.headers_bytes, 100.0 * (double)walk.headers_bytes / (double)walk.scan_bytes,
+         (unsigned long)walk.scan_bytes, (unsigned long)stats.blocks_read,
+         (unsigned long)(stats.blocks_read + stats.blocks_skipped));
+  CHECK(matched == walk.matched && stats.matched == matched, "%s: %lu samples, %lu on flash", name,
+        (unsigned long)matched, (unsigned long)walk.matched);
+  CHECK(stats.segments_bad == 0U, "%s: %lu bad segments", name, (unsigned long)stats.segments_bad);
+  CHECK(stats.bytes_read <= walk.headers_bytes, "%s: zone map read %lu bytes, %lu without", name,
+        (unsigned long)stats.bytes_read, (unsigned long)walk.headers_bytes);
+}
+
+static void test_entry(ULONG input)
+{
+  ULONG block_size;
+  ULONG total_blocks;
+  ULONG offset;
+  int64_t now;
+
+  (void)input;
+
+  meteo_ospi_get_info(&block_size, &total_blocks);
+  CHECK(block_size == TEST_BLOCK_SIZE, "block size %lu", (unsigned long)block_size);
+  test_base = (total_blocks - METEO_OSPI_RESERVED_BLOCKS) * block_size;
+
+  CHECK(meteo_archive_store_open() == TX_SUCCESS, "open");
+  test_fill();
+  for (offset = 0U; offset < TEST_ARCHIVE_BYTES; offset += TEST_BLOCK_SIZE)
+  {
+    meteo_ospi_read(test_base + offset, &test_image[offset], TEST_BLOCK_SIZE);
+  }
+
+  now = meteo_archive_store_now();
+  printf("%-28s %7s %17s %17s %9s  %7s\n", "query", "samples", "zone map", "headers only", "scan",
+         "blocks");
+  test_query("last hour", now - TEST_HOUR_USEC, now, METEO_ARCHIVE_CHANNELS, 0.0f, 0.0f);
+  test_query("last day", now - TEST_DAY_USEC, now, METEO_ARCHIVE_CHANNELS, 0.0f, 0.0f);
+  test_query("temp 20..21 C, last 2 days", now - 2LL * TEST_DAY_USEC, now, METEO_ARCHIVE_TEMPERATURE,
+             20.0f, 21.0f);
+  test_query("wind >= 20 m/s", INT64_MIN, INT64_MAX, METEO_ARCHIVE_WIND_SPEED, 20.0f, FLT_MAX);
+  test_query("everything", INT64_MIN, INT64_MAX, METEO_ARCHIVE_CHANNELS, 0.0f, 0.0f);
+
+  printf("%s (%d failures)\n", test_failures ? "FAILED" : "PASSED", test_failures);
+  exit(test_failures != 0);
+}
+
+void tx_application_define(void *first_unused_memory)
+{
+  (void)first_unused_memory;
+
+  meteo_ospi_init();
+  meteo_archive_store_init();
+  tx_thread_create(&test_thread, "test", test_entry, 0U, test_stack, TEST_STACK_SIZE,
+                   5U, 5U, TX_NO_TIME_SLICE, TX_AUTO_START);
+}
+
+int main(int argc, char *argv[])
+{
+  int opt;
+
+  while ((opt = getopt(argc, argv, "d:")) != -1)
+  {
+    switch (opt)
+    {
+      case 'd':
+        test_days = (uint32_t)atol(optarg);
+        break;
+      default:
+        fprintf(stderr, "Usage: %s [-d days]\n", argv[0]);
+        return 2;
+    }
+  }
+  if (test_days < 1U || test_days > 40U)
+  {
+    fprintf(stderr, "days 1..40\n");
+    return 2;
+  }
+
+  // No METEO_HOST_OSPI: the flash is in RAM, erased at start
+  unsetenv(LX_STM32_OSPI_HOST_FILE_ENV);
+  tx_kernel_enter();
+  return 0;
+}
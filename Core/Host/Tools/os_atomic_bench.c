@@ -0,0 +1,167 @@
+/**
+  ******************************************************************************
+  * @file    os_atomic_bench.c
+  * @brief   Throughput of the ITTIA OS layer atomics (os_atomic.h) on the
+  *          Linux host, native against the lock-striped fallback.
+  *
+  *          Each thread runs the same loop on shared variables: one
+  *          os_atomic_inc, one os_atomic_add and one os_atomic_cas_ptr
+  *          retried until it succeeds. The totals are checked at the end,
+  *          so a lost update fails the run. The rate is in million
+  *          operations per second, all threads together.
+  *
+  *          Built as is, the operations are the gcc __atomic builtins
+  *          (atomic_gcc_builtin.h, inlined). Built with
+  *          -DOS_DISABLE_NATIVE_ATOMIC, they are the calls of
+  *          generic_atomic.c, under its 32 striped fast locks
+  *          (GENERIC_ATOMIC_USE_FASTLOCK on Linux).
+  *
+  *          Build: DB=Middlewares/Third_Party/ITTIA_DB_Database_ITTIA_DB_Lite/ITTIA_DB_Lite
+  *                 gcc -O2 -DOS_LINUX [-DOS_DISABLE_NATIVE_ATOMIC] -I$DB/inc -I$DB/src
+  *                     -o os_atomic_bench Core/Host/Tools/os_atomic_bench.c
+  *                     $DB/src/generic/generic_atomic.c $DB/src/posix/posix_fastlock.c
+  *                     $DB/src/posix/posix.c $DB/src/posix/posix_tls.c
+  *                     $DB/src/os_error.c -lpthread
+  *          Usage: os_atomic_bench [-t threads] [-n loops]
+  *            -t  threads (default 4)
+  *            -n  loops per thread (default 1000000), 3 operations each
+  ******************************************************************************
+  */
+
+/* Includes ------------------------------------------------------------------*/
+#include <pthread.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <time.h>
+#include <unistd.h>
+
+#include "ittia/os/os_atomic.h"
+#include "ittia/os/os_error.h"
+#include "os/os_lib.h"
+
+/* Private defines -----------------------------------------------------------*/
+#define BENCH_MAX_THREADS       64
+#define BENCH_OPS_PER_LOOP      3U
+
+/* Private variables ---------------------------------------------------------*/
+static os_atomic_t bench_counter;
+static void *bench_pointer;
+static long bench_loops = 1000000L;
+static uint64_t bench_retries[BENCH_MAX_THREADS];
+
+/* Private functions ---------------------------------------------------------*/
+
+static double bench_now(void)
+{
+  struct timespec now;
+
+  clock_gettime(CLOCK_MONOTONIC, &now);
+  return (double)now.tv_sec + (double)now.tv_nsec * 1e-9;
+}
+
+static void *bench_thread(void *arg)
+{
+  uint64_t *retries = (uint64_t *)arg;
+  void *seen;
+  long i;
+
+  for (i = 0; i < bench_loops; i++)
+  {
+    os_atomic_inc(&bench_counter);
+    os_atomic_add(&bench_counter, 2);
+
+    /* The pointer is only used as a counter here */
+    for (;;)
+    {
+      seen = bench_pointer;
+      if (os_atomic_cas_ptr(&bench_pointer, seen, (char *)seen + 1))
+      {
+        break;
+      }
+      (*retries)++;
+    }
+  }
+  return NULL;
+}
+
+int main(int argc, char *argv[])
+{
+  pthread_t threads[BENCH_MAX_THREADS];
+  int thread_count = 4;
+  uint64_t retries = 0U;
+  double start;
+  double elapsed;
+  double ops;
+  long expected;
+  long counter;
+  long pointer;
+  int opt;
+  int i;
+
+  while ((opt = getopt(argc, argv, "t:n:")) != -1)
+  {
+    switch (opt)
+    {
+      case 't':
+        thread_count = atoi(optarg);
+        break;
+      case 'n':
+        bench_loops = atol(optarg);
+        break;
+      default:
+        fprintf(stderr, "Usage: %s [-t threads] [-n loops]\n", argv[0]);
+        return 2;
+    }
+  }
+  if (thread_count < 1 || thread_count > BENCH_MAX_THREADS || bench_loops < 1)
+  {
+    fprintf(stderr, "threads 1..%d, loops > 0\n", BENCH_MAX_THREADS);
+    return 2;
+  }
+
+  /* The fallback creates its locks here; nothing to do for the native set */
+  if (DB_FAILED(os_atomic_init()))
+  {
+    fprintf(stderr, "os_atomic_init failed\n");
+    return 1;
+  }
+
+  start = bench_now();
+  for (i = 0; i < thread_count; i++)
+  {
+    pthread_create(&threads[i], NULL, bench_thread, &bench_retries[i]);
+  }
+  for (i = 0; i < thread_count; i++)
+  {
+    pthread_join(threads[i], NULL);
+    retries += bench_retries[i];
+  }
+  elapsed = bench_now() - start;
+
+  ops = (double)thread_count * (double)bench_loops * BENCH_OPS_PER_LOOP;
+  expected = (long)thread_count * bench_loops;
+
+#ifdef OS_DISABLE_NATIVE_ATOMIC
+  printf("lock-striped fallback (generic_atomic.c)\n");
+#else
+  printf("native (atomic/atomic.h)\n");
+#endif
+  printf("threads %d, loops %ld: %.0f operations in %.3f s, %.1f Mops/s, "
+         "%llu cas retries\n",
+         thread_count, bench_loops, ops, elapsed, ops / elapsed * 1e-6,
+         (unsigned long long)retries);
+
+  counter = (long)os_atomic_fetch(&bench_counter);
+  pointer = (long)(uintptr_t)bench_pointer;
+  (void)os_atomic_done();
+
+  if (counter != 3L * expected || pointer != expected)
+  {
+    printf("FAILED: counter %ld, pointer %ld, expected %ld and %ld\n",
+           counter, pointer, 3L * expected, expected);
+    return 1;
+  }
+  printf("PASSED\n");
+  return 0;
+}
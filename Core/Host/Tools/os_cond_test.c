@@ -0,0 +1,531 @@
+/**
+  ******************************************************************************
+  * @file    os_cond_test.c
+  * @brief   Checks and wakeup latency of the ITTIA OS layer condition
+  *          variable on ThreadX, run on the Linux port of ThreadX.
+  *
+  *          The same program is built twice: with generic_cv.c (the
+  *          semaphore-gated variable, OS_THREADX_GENERIC_CONDVAR, the
+  *          default) and with threadx_cv.c and -DOS_THREADX_NATIVE_CONDVAR
+  *          (the waiter list under TX_DISABLE). Both must pass the same
+  *          checks:
+  *            - a wait times out after its ticks with DB_ELOCKED, and
+  *              returns with the mutex held,
+  *            - a signal or broadcast with no waiter is not remembered,
+  *            - a signal wakes exactly one waiter, the oldest first,
+  *            - a broadcast wakes every waiter,
+  *            - waiters that timed out are gone, a signal after them
+  *              reaches the one still waiting,
+  *            - producers and consumers on a bounded buffer, with timed
+  *              and untimed waits, lose no item and no wakeup.
+  *          Then a ping-pong between two threads gives the time from
+  *          os_cond_signal() to the waiter running with the mutex, in
+  *          host ns, once signalling with the mutex held and once after
+  *          the unlock.
+  *
+  *          Build: TX=Middlewares/ST/threadx
+  *                 DB=Middlewares/Third_Party/ITTIA_DB_Database_ITTIA_DB_Lite/ITTIA_DB_Lite
+  *                 gcc -O2 -DTX_INCLUDE_USER_DEFINE_FILE -DOS_THREADX
+  *                     -ICore/Host/Inc -ICore/Inc -I$TX/ports/linux/gnu/inc
+  *                     -I$TX/common/inc -I$TX/utility/execution_profile_kit
+  *                     -I$DB/inc -I$DB/src -o os_cond_test
+  *                     Core/Host/Tools/os_cond_test.c $DB/src/generic/generic_cv.c
+  *                     $DB/src/threadx/threadx_mutex.c $DB/src/threadx/threadx_sem.c
+  *                     $DB/src/threadx/threadx.c <the ThreadX sources of the
+  *                     meteo_host build line in README.md> -lpthread
+  *                 For the native variable, add -DOS_THREADX_NATIVE_CONDVAR and
+  *                 take $DB/src/threadx/threadx_cv.c instead of generic_cv.c.
+  *          Usage: os_cond_test [-n round trips]
+  *            -n  ping-pong round trips for the latency (default 2000)
+  ******************************************************************************
+  */
+
+/* Includes ------------------------------------------------------------------*/
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <unistd.h>
+
+#include "tx_api.h"
+#include "ittia/os/os_condvar.h"
+#include "ittia/os/os_mutex.h"
+#include "ittia/os/os_error.h"
+
+/* Private defines -----------------------------------------------------------*/
+#define TEST_WAITERS            8
+#define TEST_STACK_SIZE         4096U
+#define TEST_MAIN_PRIORITY      15U
+#define TEST_WAITER_PRIORITY    10U
+
+/* Bounded buffer run */
+#define TEST_PRODUCERS          2
+#define TEST_CONSUMERS          2
+#define TEST_ITEMS              20000L
+#define TEST_SLOTS              4
+
+#define TEST_LATENCY_MAX        100000L
+
+#define CHECK(cond, ...) \
+  do { if (!(cond)) { test_failures++; printf("  FAILED line %d: ", __LINE__); \
+       printf(__VA_ARGS__); printf("\n"); } } while (0)
+
+/* Private types -------------------------------------------------------------*/
+typedef struct
+{
+  TX_THREAD thread;
+  UCHAR stack[TEST_STACK_SIZE];
+  int id;
+  os_wait_time_t timeout;
+  int result;
+  int done;
+} test_waiter_t;
+
+/* Private variables ---------------------------------------------------------*/
+static TX_THREAD test_main_thread;
+static UCHAR test_main_stack[TEST_STACK_SIZE];
+static test_waiter_t test_waiters[TEST_WAITERS];
+
+static os_mutex_t test_mutex;
+static os_cond_t test_cv;
+static os_cond_t test_cv_other;
+
+/* Under test_mutex */
+static int test_waiting;
+static int test_returns;
+static int test_order[TEST_WAITERS];
+
+/* Bounded buffer, under test_mutex */
+static long test_slots[TEST_SLOTS];
+static int test_count;
+static int test_head;
+static long test_produced_sum;
+static long test_consumed_sum;
+static long test_consumed;
+static long test_timeouts;
+static int test_producers_done;
+
+/* Ping-pong */
+static long test_round_trips = 2000L;
+static int test_turn;
+static uint64_t test_signal_ns;
+static uint32_t test_latency_ns[TEST_LATENCY_MAX];
+
+static int test_failures;
+
+/* Private functions ---------------------------------------------------------*/
+
+/* os_threadx_error() records the code for get_db_error() in a TLS slot
+   (os_error.c). The slot needs os_init() and the ITTIA allocator, so here
+   the code is only returned. */
+dbstatus_t set_db_error(dbstatus_t rc)
+{
+  return rc;
+}
+
+static uint64_t test_now_ns(void)
+{
+  struct timespec now;
+
+  clock_gettime(CLOCK_MONOTONIC, &now);
+  return (uint64_t)now.tv_sec * 1000000000U + (uint64_t)now.tv_nsec;
+}
+
+static int test_mutex_owned(void)
+{
+  TX_THREAD *owner = TX_NULL;
+
+  tx_mutex_info_get((TX_MUTEX *)&test_mutex, TX_NULL, TX_NULL, &owner, TX_NULL, TX_NULL, TX_NULL);
+  return owner == tx_thread_identify();
+}
+
+static void test_waiter_entry(ULONG input)
+{
+  test_waiter_t *waiter = &test_waiters[input];
+
+  os_mutex_lock(&test_mutex);
+  test_waiting++;
+  waiter->result = os_cond_wait(&test_cv, &test_mutex, waiter->timeout);
+  if (!test_mutex_owned())
+  {
+    waiter->result = DB_EOSERROR;
+  }
+  test_waiting--;
+  test_order[test_returns++] = waiter->id;
+  waiter->done = 1;
+  os_mutex_unlock(&test_mutex);
+}
+
+static void test_waiter_start(int id, os_wait_time_t timeout)
+{
+  test_waiter_t *waiter = &test_waiters[id];
+
+  tx_thread_delete(&waiter->thread);
+  memset(&waiter->thread, 0, sizeof(waiter->thread));
+  waiter->id = id;
+  waiter->timeout = timeout;
+  waiter->result = 1;
+  waiter->done = 0;
+  tx_thread_create(&waiter->thread, "waiter", test_waiter_entry, (ULONG)id,
+                   waiter->stack, TEST_STACK_SIZE, TEST_WAITER_PRIORITY,
+                   TEST_WAITER_PRIORITY, TX_NO_TIME_SLICE, TX_AUTO_START);
+}
+
+/* Start the waiters one by one, so they queue in id order */
+static void test_waiters_start(int count, os_wait_time_t timeout)
+{
+  int i;
+
+  test_returns = 0;
+  for (i = 0; i < count; i++)
+  {
+    test_waiter_start(i, timeout);
+    while (test_waiting != i + 1)
+    {
+      tx_thread_sleep(1);
+    }
+  }
+}
+
+static int test_waiters_done(int count)
+{
+  int done = 0;
+  int i;
+
+  for (i = 0; i < count; i++)
+  {
+    done += test_waiters[i].done;
+  }
+  return done;
+}
+
+static void test_timeout(void)
+{
+  ULONG start;
+  ULONG elapsed;
+  int rc;
+
+  printf("timeout\n");
+  os_mutex_lock(&test_mutex);
+  start = tx_time_get();
+  rc = os_cond_wait(&test_cv, &test_mutex, 5);
+  elapsed = tx_time_get() - start;
+  CHECK(rc == DB_ELOCKED, "wait returned %d", rc);
+  CHECK(elapsed >= 5U && elapsed <= 7U, "timed out after %lu ticks", (unsigned long)elapsed);
+  CHECK(test_mutex_owned(), "mutex not held after the timeout");
+
+  rc = os_cond_wait(&test_cv, &test_mutex, 0);
+  CHECK(rc == DB_ELOCKED, "wait of 0 ticks returned %d", rc);
+  os_mutex_unlock(&test_mutex);
+}
+
+static void test_no_waiter(void)
+{
+  int rc;
+
+  printf("signal and broadcast with no waiter\n");
+  os_mutex_lock(&test_mutex);
+  os_cond_signal(&test_cv);
+  os_cond_broadcast(&test_cv);
+  rc = os_cond_wait(&test_cv, &test_mutex, 3);
+  CHECK(rc == DB_ELOCKED, "wait after an unheard signal returned %d", rc);
+  os_mutex_unlock(&test_mutex);
+}
+
+static void test_signal(void)
+{
+  int i;
+
+  printf("signal wakes one, oldest first\n");
+  test_waiters_start(4, OS_WAIT_FOREVER);
+  for (i = 0; i < 4; i++)
+  {
+    os_mutex_lock(&test_mutex);
+    os_cond_signal(&test_cv);
+    os_mutex_unlock(&test_mutex);
+    tx_thread_sleep(2);
+
+    CHECK(test_returns == i + 1, "%d waiters returned after %d signals", test_returns, i + 1);
+    CHECK(test_order[i] == i, "signal %d woke waiter %d", i, test_order[i]);
+    CHECK(test_waiters[i].result == DB_NOERROR, "waiter %d returned %d", i, test_waiters[i].result);
+  }
+}
+
+static void test_broadcast(void)
+{
+  int i;
+
+  printf("broadcast wakes all\n");
+  test_waiters_start(TEST_WAITERS, OS_WAIT_FOREVER);
+  os_mutex_lock(&test_mutex);
+  os_cond_broadcast(&test_cv);
+  os_mutex_unlock(&test_mutex);
+  tx_thread_sleep(2);
+
+  CHECK(test_returns == TEST_WAITERS, "%d of %d waiters returned", test_returns, TEST_WAITERS);
+  for (i = 0; i < TEST_WAITERS; i++)
+  {
+    CHECK(test_waiters[i].result == DB_NOERROR, "waiter %d returned %d", i, test_waiters[i].result);
+  }
+
+  /* The next waiters are not woken by the broadcast already delivered */
+  test_waiters_start(2, 3);
+  tx_thread_sleep(6);
+  CHECK(test_waiters_done(2) == 2 && test_waiters[0].result == DB_ELOCKED
+        && test_waiters[1].result == DB_ELOCKED, "late waiters did not time out");
+}
+
+static void test_timed_out_waiters(void)
+{
+  printf("timed out waiters leave the queue\n");
+  test_returns = 0;
+  test_waiter_start(0, 3);
+  test_waiter_start(1, OS_WAIT_FOREVER);
+  test_waiter_start(2, 3);
+  while (test_waiting != 3)
+  {
+    tx_thread_sleep(1);
+  }
+  tx_thread_sleep(6);
+  CHECK(test_waiters[0].done && test_waiters[0].result == DB_ELOCKED, "waiter 0 did not time out");
+  CHECK(test_waiters[2].done && test_waiters[2].result == DB_ELOCKED, "waiter 2 did not time out");
+  CHECK(!test_waiters[1].done, "waiter 1 returned without a signal");
+
+  os_mutex_lock(&test_mutex);
+  os_cond_signal(&test_cv);
+  os_mutex_unlock(&test_mutex);
+  tx_thread_sleep(2);
+  CHECK(test_waiters[1].done && test_waiters[1].result == DB_NOERROR, "signal did not reach waiter 1");
+}
+
+static void test_producer_entry(ULONG input)
+{
+  long i;
+
+  for (i = 1; i <= TEST_ITEMS; i++)
+  {
+    os_mutex_lock(&test_mutex);
+    while (test_count == TEST_SLOTS)
+    {
+      os_cond_wait(&test_cv_other, &test_mutex, OS_WAIT_FOREVER);
+    }
+    test_slots[(test_head + test_count) % TEST_SLOTS] = i * (long)(input + 1U);
+    test_count++;
+    test_produced_sum += i * (long)(input + 1U);
+    os_cond_signal(&test_cv);
+    os_mutex_unlock(&test_mutex);
+  }
+
+  os_mutex_lock(&test_mutex);
+  test_producers_done++;
+  os_cond_broadcast(&test_cv);
+  os_mutex_unlock(&test_mutex);
+  test_waiters[input].done = 1;
+}
+
+static void test_consumer_entry(ULONG input)
+{
+  /* One consumer waits with a timeout of one tick, racing timeouts
+     against the signals */
+  os_wait_time_t timeout = (input == TEST_PRODUCERS) ? 1U : OS_WAIT_FOREVER;
+
+  os_mutex_lock(&test_mutex);
+  while (1)
+  {
+    while (test_count == 0 && test_producers_done < TEST_PRODUCERS)
+    {
+      if (os_cond_wait(&test_cv, &test_mutex, timeout) == DB_ELOCKED)
+      {
+        test_timeouts++;
+      }
+    }
+    if (test_count == 0)
+    {
+      break;
+    }
+    test_consumed_sum += test_slots[test_head];
+    test_head = (test_head + 1) % TEST_SLOTS;
+    test_count--;
+    test_consumed++;
+    os_cond_signal(&test_cv_other);
+  }
+  os_mutex_unlock(&test_mutex);
+  test_waiters[input].done = 1;
+}
+
+static void test_bounded_buffer(void)
+{
+  int i;
+
+  printf("bounded buffer, %d producers and %d consumers\n", TEST_PRODUCERS, TEST_CONSUMERS);
+  for (i = 0; i < TEST_PRODUCERS + TEST_CONSUMERS; i++)
+  {
+    test_waiter_t *thread = &test_waiters[i];
+
+    tx_thread_delete(&thread->thread);
+    memset(&thread->thread, 0, sizeof(thread->thread));
+    thread->done = 0;
+    tx_thread_create(&thread->thread, "buffer",
+                     (i < TEST_PRODUCERS) ? test_producer_entry : test_consumer_entry,
+                     (ULONG)i, thread->stack, TEST_STACK_SIZE, TEST_WAITER_PRIORITY,
+                     TEST_WAITER_PRIORITY, 1U, TX_AUTO_START);
+  }
+  while (test_waiters_done(TEST_PRODUCERS + TEST_CONSUMERS) != TEST_PRODUCERS + TEST_CONSUMERS)
+  {
+    tx_thread_sleep(10);
+  }
+
+  CHECK(test_consumed == TEST_PRODUCERS * TEST_ITEMS, "%ld items consumed", test_consumed);
+  CHECK(test_consumed_sum == test_produced_sum, "sum %ld, produced %ld",
+        test_consumed_sum, test_produced_sum);
+  printf("  %ld items, %ld timed out waits\n", test_consumed, test_timeouts);
+}
+
+static void test_pong_entry(ULONG input)
+{
+  long i;
+
+  (void)input;
+  os_mutex_lock(&test_mutex);
+  for (i = 0; i < test_round_trips; i++)
+  {
+    while (test_turn != 1)
+    {
+      os_cond_wait(&test_cv, &test_mutex, OS_WAIT_FOREVER);
+    }
+    test_latency_ns[i] = (uint32_t)(test_now_ns() - test_signal_ns);
+    test_turn = 0;
+    os_cond_signal(&test_cv_other);
+  }
+  os_mutex_unlock(&test_mutex);
+  test_waiters[0].done = 1;
+}
+
+static int test_compare(const void *a, const void *b)
+{
+  uint32_t x = *(const uint32_t *)a;
+  uint32_t y = *(const uint32_t *)b;
+
+  return (x > y) - (x < y);
+}
+
+/* held: signal with the mutex held, the waiter then waits for the unlock;
+   else signal after the unlock, the waiter runs at once */
+static void test_latency(int held)
+{
+  test_waiter_t *pong = &test_waiters[0];
+  uint64_t start;
+  uint64_t total = 0U;
+  long i;
+
+  printf("wakeup latency, signal %s, %ld round trips\n",
+         held ? "with the mutex held" : "after the unlock", test_round_trips);
+  tx_thread_delete(&pong->thread);
+  memset(&pong->thread, 0, sizeof(pong->thread));
+  pong->done = 0;
+  tx_thread_create(&pong->thread, "pong", test_pong_entry, 0U, pong->stack, TEST_STACK_SIZE,
+                   TEST_WAITER_PRIORITY, TEST_WAITER_PRIORITY, TX_NO_TIME_SLICE, TX_AUTO_START);
+
+  start = test_now_ns();
+  for (i = 0; i < test_round_trips; i++)
+  {
+    os_mutex_lock(&test_mutex);
+    test_turn = 1;
+    if (!held)
+    {
+      os_mutex_unlock(&test_mutex);
+    }
+    test_signal_ns = test_now_ns();
+    os_cond_signal(&test_cv);
+    if (!held)
+    {
+      os_mutex_lock(&test_mutex);
+    }
+    while (test_turn != 0)
+    {
+      os_cond_wait(&test_cv_other, &test_mutex, OS_WAIT_FOREVER);
+    }
+    os_mutex_unlock(&test_mutex);
+  }
+  start = test_now_ns() - start;
+  while (!pong->done)
+  {
+    tx_thread_sleep(1);
+  }
+
+  for (i = 0; i < test_round_trips; i++)
+  {
+    total += test_latency_ns[i];
+  }
+  qsort(test_latency_ns, (size_t)test_round_trips, sizeof(test_latency_ns[0]), test_compare);
+  printf("  signal to waiter running: mean %lu ns, p50 %lu, p99 %lu, max %lu\n",
+         (unsigned long)(total / (uint64_t)test_round_trips),
+         (unsigned long)test_latency_ns[test_round_trips / 2],
+         (unsigned long)test_latency_ns[test_round_trips * 99 / 100],
+         (unsigned long)test_latency_ns[test_round_trips - 1]);
+  printf("  round trip: %lu ns\n", (unsigned long)(start / (uint64_t)test_round_trips));
+}
+
+static void test_main_entry(ULONG input)
+{
+  (void)input;
+
+  if (os_mutex_init(&test_mutex) != DB_NOERROR || os_cond_init(&test_cv) != DB_NOERROR
+      || os_cond_init(&test_cv_other) != DB_NOERROR)
+  {
+    printf("init failed\n");
+    exit(1);
+  }
+
+#ifdef HAVE_THREADX_CONDVAR
+  printf("threadx_cv.c (OS_THREADX_NATIVE_CONDVAR), os_cond_t %u bytes\n", (unsigned)sizeof(os_cond_t));
+#else
+  printf("generic_cv.c, os_cond_t %u bytes\n", (unsigned)sizeof(os_cond_t));
+#endif
+
+  test_timeout();
+  test_no_waiter();
+  test_signal();
+  test_broadcast();
+  test_timed_out_waiters();
+  test_bounded_buffer();
+  test_latency(1);
+  test_latency(0);
+
+  CHECK(os_cond_destroy(&test_cv) == DB_NOERROR, "destroy with no waiter failed");
+  printf("%s (%d failures)\n", test_failures ? "FAILED" : "PASSED", test_failures);
+  exit(test_failures != 0);
+}
+
+void tx_application_define(void *first_unused_memory)
+{
+  (void)first_unused_memory;
+
+  tx_thread_create(&test_main_thread, "main", test_main_entry, 0U, test_main_stack,
+                   TEST_STACK_SIZE, TEST_MAIN_PRIORITY, TEST_MAIN_PRIORITY,
+                   TX_NO_TIME_SLICE, TX_AUTO_START);
+}
+
+int main(int argc, char *argv[])
+{
+  int opt;
+
+  while ((opt = getopt(argc, argv, "n:")) != -1)
+  {
+    if (opt != 'n')
+    {
+      fprintf(stderr, "Usage: %s [-n round trips]\n", argv[0]);
+      return 2;
+    }
+    test_round_trips = atol(optarg);
+  }
+  if (test_round_trips < 1 || test_round_trips > TEST_LATENCY_MAX)
+  {
+    fprintf(stderr, "round trips 1..%ld\n", TEST_LATENCY_MAX);
+    return 2;
+  }
+
+  tx_kernel_enter();
+  return 0;
+}
@@ -0,0 +1,239 @@
+/**
+  ******************************************************************************
+  * @file    tx_byte_pool_bench.c
+  * @brief   Allocation time and fragmentation of a ThreadX byte pool on the
+  *          Linux port, first fit against TLSF (TX_BYTE_POOL_ENABLE_TLSF).
+  *
+  *          A 96 KB pool serves 256 slots picked at random: a free slot is
+  *          allocated (8..207 bytes, one in 8 from 512 to 3511 bytes) and
+  *          filled with its number, a used one is checked and released.
+  *          Every allocation is timed with CLOCK_MONOTONIC. At the end all
+  *          slots are released: every byte must be back, and with TLSF,
+  *          which merges on release, the pool must be whole again.
+  *
+  *          The same seed gives the same requests in both builds. Out of
+  *          the ThreadX performance counters come the blocks searched per
+  *          allocation (first fit) or lists visited (TLSF), the merges and
+  *          the splits.
+  *
+  *          Build: TX=Middlewares/ST/threadx
+  *                 gcc -O2 -DTX_INCLUDE_USER_DEFINE_FILE
+  *                     -DTX_BYTE_POOL_ENABLE_PERFORMANCE_INFO [-DTX_BYTE_POOL_ENABLE_TLSF]
+  *                     -ICore/Host/Inc -ICore/Inc -I$TX/ports/linux/gnu/inc
+  *                     -I$TX/common/inc -I$TX/utility/execution_profile_kit
+  *                     -o tx_byte_pool_bench Core/Host/Tools/tx_byte_pool_bench.c
+  *                     <the ThreadX sources of the meteo_host build line in
+  *                     README.md> -lpthread
+  *          Usage: tx_byte_pool_bench [-s seed] [-n operations]
+  *            -s  seed of the requests (default 1)
+  *            -n  allocations and releases (default 400000)
+  ******************************************************************************
+  */
+
+/* Includes ------------------------------------------------------------------*/
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <unistd.h>
+
+#include "tx_api.h"
+#include "tx_byte_pool.h"
+
+/* Private defines -----------------------------------------------------------*/
+#define BENCH_POOL_BYTES        (96U * 1024U)
+#define BENCH_SLOTS             256U
+#define BENCH_OPS_MAX           4000000L
+
+/* Private variables ---------------------------------------------------------*/
+static UCHAR bench_memory[BENCH_POOL_BYTES] __attribute__((aligned(8)));
+static TX_BYTE_POOL bench_pool;
+static UCHAR *bench_slot[BENCH_SLOTS];
+static ULONG bench_slot_size[BENCH_SLOTS];
+static uint32_t bench_ns[BENCH_OPS_MAX];
+static uint32_t bench_seed = 1U;
+
+/* Private functions ---------------------------------------------------------*/
+
+static uint64_t bench_now_ns(void)
+{
+  struct timespec now;
+
+  clock_gettime(CLOCK_MONOTONIC, &now);
+  return (uint64_t)now.tv_sec * 1000000000U + (uint64_t)now.tv_nsec;
+}
+
+/* xorshift32, the generator of the simulator stations */
+static uint32_t bench_random(void)
+{
+  bench_seed ^= bench_seed << 13;
+  bench_seed ^= bench_seed >> 17;
+  bench_seed ^= bench_seed << 5;
+  return bench_seed;
+}
+
+static int bench_compare(const void *a, const void *b)
+{
+  uint32_t x = *(const uint32_t *)a;
+  uint32_t y = *(const uint32_t *)b;
+
+  return (x > y) - (x < y);
+}
+
+static ULONG bench_fragments(void)
+{
+  ULONG fragments = 0U;
+
+  tx_byte_pool_info_get(&bench_pool, TX_NULL, TX_NULL, &fragments, TX_NULL, TX_NULL, TX_NULL);
+  return fragments;
+}
+
+int main(int argc, char *argv[])
+{
+  long operations = 400000L;
+  long allocations = 0L;
+  long failures = 0L;
+  ULONG available_start;
+  ULONG available_end;
+  ULONG fragments_start;
+  ULONG fragments_end;
+  ULONG fragments_max = 0U;
+  ULONG allocates;
+  ULONG releases;
+  ULONG searched;
+  ULONG merges;
+  ULONG splits;
+  uint64_t start;
+  UINT status;
+  ULONG size;
+  ULONG slot;
+  ULONG i;
+  long op;
+  int opt;
+
+  while ((opt = getopt(argc, argv, "s:n:")) != -1)
+  {
+    switch (opt)
+    {
+      case 's':
+        bench_seed = (uint32_t)strtoul(optarg, NULL, 0);
+        break;
+      case 'n':
+        operations = atol(optarg);
+        break;
+      default:
+        fprintf(stderr, "Usage: %s [-s seed] [-n operations]\n", argv[0]);
+        return 2;
+    }
+  }
+  if (bench_seed == 0U || operations < 1L || operations > BENCH_OPS_MAX)
+  {
+    fprintf(stderr, "seed > 0, operations 1..%ld\n", BENCH_OPS_MAX);
+    return 2;
+  }
+
+  if (_tx_byte_pool_create(&bench_pool, "bench", bench_memory, BENCH_POOL_BYTES) != TX_SUCCESS)
+  {
+    printf("FAILED: pool create\n");
+    return 1;
+  }
+  tx_byte_pool_info_get(&bench_pool, TX_NULL, &available_start, &fragments_start,
+                        TX_NULL, TX_NULL, TX_NULL);
+
+  for (op = 0; op < operations; op++)
+  {
+    slot = bench_random() % BENCH_SLOTS;
+    if (bench_slot[slot] != TX_NULL)
+    {
+      for (i = 0U; i < bench_slot_size[slot]; i++)
+      {
+        if (bench_slot[slot][i] != (UCHAR)slot)
+        {
+          printf("FAILED: slot %lu overwritten\n", (unsigned long)slot);
+          return 1;
+        }
+      }
+      if (_tx_byte_release(bench_slot[slot]) != TX_SUCCESS)
+      {
+        printf("FAILED: release\n");
+        return 1;
+      }
+      bench_slot[slot] = TX_NULL;
+    }
+    else
+    {
+      size = ((bench_random() & 7U) == 0U) ? 512U + bench_random() % 3000U
+                                           : 8U + bench_random() % 200U;
+      start = bench_now_ns();
+      status = _tx_byte_allocate(&bench_pool, (VOID **)&bench_slot[slot], size, TX_NO_WAIT);
+      bench_ns[allocations++] = (uint32_t)(bench_now_ns() - start);
+      if (status == TX_SUCCESS)
+      {
+        bench_slot_size[slot] = size;
+        memset(bench_slot[slot], (int)slot, size);
+      }
+      else
+      {
+        bench_slot[slot] = TX_NULL;
+        failures++;
+      }
+    }
+
+    size = bench_fragments();
+    fragments_max = (size > fragments_max) ? size : fragments_max;
+  }
+
+  for (slot = 0U; slot < BENCH_SLOTS; slot++)
+  {
+    if (bench_slot[slot] != TX_NULL)
+    {
+      _tx_byte_release(bench_slot[slot]);
+    }
+  }
+  tx_byte_pool_info_get(&bench_pool, TX_NULL, &available_end, &fragments_end,
+                        TX_NULL, TX_NULL, TX_NULL);
+  _tx_byte_pool_performance_info_get(&bench_pool, &allocates, &releases, &searched,
+                                     &merges, &splits, TX_NULL, TX_NULL);
+  qsort(bench_ns, (size_t)allocations, sizeof(bench_ns[0]), bench_compare);
+
+#ifdef TX_BYTE_POOL_ENABLE_TLSF
+  printf("TLSF\n");
+#else
+  printf("first fit\n");
+#endif
+  printf("allocations %ld, failed %ld (pool full)\n", allocations, failures);
+  printf("ns: p50 %lu, p99 %lu, p99.9 %lu, max %lu\n",
+         (unsigned long)bench_ns[allocations / 2],
+         (unsigned long)bench_ns[allocations * 99 / 100],
+         (unsigned long)bench_ns[allocations * 999 / 1000],
+         (unsigned long)bench_ns[allocations - 1]);
+  printf("searched per allocation %lu.%lu, merges %lu, splits %lu, releases %lu\n",
+         (unsigned long)(searched / allocates), (unsigned long)(searched * 10U / allocates % 10U),
+         (unsigned long)merges, (unsigned long)splits, (unsigned long)releases);
+  printf("available %lu -> %lu bytes, fragments %lu -> %lu, at most %lu\n",
+         (unsigned long)available_start, (unsigned long)available_end,
+         (unsigned long)fragments_start, (unsigned long)fragments_end,
+         (unsigned long)fragments_max);
+
+  /* First fit only merges free neighbours on the next search */
+  if (available_end != available_start)
+  {
+    printf("FAILED: %lu bytes lost\n", (unsigned long)(available_start - available_end));
+    return 1;
+  }
+#ifdef TX_BYTE_POOL_ENABLE_TLSF
+  if (fragments_end != fragments_start)
+  {
+    printf("FAILED: pool not whole after the last release\n");
+    return 1;
+  }
+#endif
+  printf("PASSED\n");
+  return 0;
+}
+
+void tx_application_define(void *first_unused_memory)
+{
+  (void)first_unused_memory;
+}
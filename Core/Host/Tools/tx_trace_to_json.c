@@ -0,0 +1,788 @@
+/**
+  ******************************************************************************
+  * @file    tx_trace_to_json.c
+  * @brief   Convert a ThreadX event trace (TX_ENABLE_EVENT_TRACE) to the
+  *          Chrome trace event JSON format, for chrome://tracing or
+  *          https://ui.perfetto.dev.
+  *
+  *          Input is either the console log of the 'D' key ([TRACE] hex
+  *          lines, the last complete dump is used) or, with -b, the raw
+  *          buffer as served on METEO_TRACE_TCP_PORT or saved by a debugger
+  *          from the .tx_trace section.
+  *
+  *          The timeline has
+  *            - a CPU track with the running thread (gaps are idle),
+  *            - one track per thread: running slices, ThreadX service calls
+  *              and the METEO_TRACE() events of meteo_trace.h,
+  *            - one track per interrupt source (exception number on the
+  *              board, emulated source on the host) with the handler time.
+  *          The running thread follows the "next thread" field of the
+  *          resume, suspend and time-slice events; a switch requested from
+  *          an interrupt takes effect when the outermost handler exits.
+  *
+  *          Build: gcc -O2 -o tx_trace_to_json Core/Host/Tools/tx_trace_to_json.c
+  *          Usage: tx_trace_to_json [-b] [-f hz] [-k] dump > trace.json
+  *            -b  input is the raw trace buffer
+  *            -f  trace time source in Hz (default 250000000: the DWT cycle
+  *                counter at 250 MHz; 1000000 for meteo_host, which uses us)
+  *            -k  leave out the ThreadX service call events
+  ******************************************************************************
+  */
+
+/* Includes ------------------------------------------------------------------*/
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+
+/* Private defines -----------------------------------------------------------*/
+
+/* Trace buffer layout, see Middlewares/ST/threadx/common/inc/tx_trace.h */
+#define TRACE_VALID             0x54585442UL
+#define TRACE_HEADER_SIZE       48U
+#define TRACE_OBJECT_FIXED      16U
+#define TRACE_EVENT_SIZE        32U
+
+#define TRACE_CONTEXT_ISR       0xFFFFFFFFUL
+#define TRACE_CONTEXT_INIT      0xF0F0F0F0UL
+
+#define TRACE_OBJECT_THREAD     1U
+
+#define TRACE_THREAD_RESUME     1U
+#define TRACE_THREAD_SUSPEND    2U
+#define TRACE_ISR_ENTER         3U
+#define TRACE_ISR_EXIT          4U
+#define TRACE_TIME_SLICE        5U
+#define TRACE_RUNNING           6U
+#define TRACE_USER_EVENT_START  4096U
+
+/* Tracks (Chrome "tid") */
+#define TID_CPU                 1
+#define TID_INIT                2
+#define TID_THREAD_BASE         100
+#define TID_ISR_BASE            1000
+
+#define MAX_THREADS             64
+#define MAX_ISR_NESTING         16
+#define MAX_ISR_TRACKS          256
+#define LOG_LINE_SIZE           512
+
+/* Private types -------------------------------------------------------------*/
+typedef struct
+{
+  uint32_t pointer;
+  char name[40];
+  unsigned priority;
+  int tid;
+} trace_thread_t;
+
+typedef struct
+{
+  uint32_t id;
+  const char *name;
+} trace_name_t;
+
+/* User event kinds */
+enum { USER_INSTANT, USER_BEGIN, USER_END };
+
+typedef struct
+{
+  uint32_t id;
+  const char *name;
+  int kind;
+  const char *arg1;
+  const char *arg2;
+} trace_user_event_t;
+
+/* Private variables ---------------------------------------------------------*/
+
+/* METEO_TRACE() events, in step with Core/Inc/meteo_trace.h */
+static const trace_user_event_t user_events[] =
+{
+  { TRACE_USER_EVENT_START + 0, "frame received",   USER_INSTANT, "length",      "status" },
+  { TRACE_USER_EVENT_START + 1, "frame decoded",    USER_INSTANT, "checksum_ok", "status" },
+  { TRACE_USER_EVENT_START + 2, "stream processed", USER_INSTANT, "stored",      "db_status" },
+  { TRACE_USER_EVENT_START + 3, "IDC send",         USER_INSTANT, "bytes",       "status" },
+  { TRACE_USER_EVENT_START + 4, "console write",    USER_BEGIN,   "bytes",       NULL },
+  { TRACE_USER_EVENT_START + 5, "console write",    USER_END,     "bytes",       NULL },
+  { TRACE_USER_EVENT_START + 6, "OSPI erase",       USER_BEGIN,   "block",       NULL },
+  { TRACE_USER_EVENT_START + 7, "OSPI erase",       USER_END,     "block",       "status" },
+  { TRACE_USER_EVENT_START + 8, "load run",         USER_BEGIN,   "rate_hz",     "stations" },
+  { TRACE_USER_EVENT_START + 9, "load run",         USER_END,     "generated",   "dropped" },
+};
+
+/* ThreadX service call events */
+static const trace_name_t service_events[] =
+{
+    {  10, "tx_block_allocate" },
+    {  11, "tx_block_pool_create" },
+    {  12, "tx_block_pool_delete" },
+    {  13, "tx_block_pool_info_get" },
+    {  14, "tx_block_pool_performance_info_get" },
+    {  15, "tx_block_pool_performance_system_info_get" },
+    {  16, "tx_block_pool_prioritize" },
+    {  17, "tx_block_release" },
+    {  20, "tx_byte_allocate" },
+    {  21, "tx_byte_pool_create" },
+    {  22, "tx_byte_pool_delete" },
+    {  23, "tx_byte_pool_info_get" },
+    {  24, "tx_byte_pool_performance_info_get" },
+    {  25, "tx_byte_pool_performance_system_info_get" },
+    {  26, "tx_byte_pool_prioritize" },
+    {  27, "tx_byte_release" },
+    {  30, "tx_event_flags_create" },
+    {  31, "tx_event_flags_delete" },
+    {  32, "tx_event_flags_get" },
+    {  33, "tx_event_flags_info_get" },
+    {  34, "tx_event_flags_performance_info_get" },
+    {  35, "tx_event_flags_performance_system_info_get" },
+    {  36, "tx_event_flags_set" },
+    {  37, "tx_event_flags_set_notify" },
+    {  40, "tx_interrupt_control" },
+    {  50, "tx_mutex_create" },
+    {  51, "tx_mutex_delete" },
+    {  52, "tx_mutex_get" },
+    {  53, "tx_mutex_info_get" },
+    {  54, "tx_mutex_performance_info_get" },
+    {  55, "tx_mutex_performance_system_info_get" },
+    {  56, "tx_mutex_prioritize" },
+    {  57, "tx_mutex_put" },
+    {  60, "tx_queue_create" },
+    {  61, "tx_queue_delete" },
+    {  62, "tx_queue_flush" },
+    {  63, "tx_queue_front_send" },
+    {  64, "tx_queue_info_get" },
+    {  65, "tx_queue_performance_info_get" },
+    {  66, "tx_queue_performance_system_info_get" },
+    {  67, "tx_queue_prioritize" },
+    {  68, "tx_queue_receive" },
+    {  69, "tx_queue_send" },
+    {  70, "tx_queue_send_notify" },
+    {  80, "tx_semaphore_ceiling_put" },
+    {  81, "tx_semaphore_create" },
+    {  82, "tx_semaphore_delete" },
+    {  83, "tx_semaphore_get" },
+    {  84, "tx_semaphore_info_get" },
+    {  85, "tx_semaphore_performance_info_get" },
+    {  86, "tx_semaphore_performance_system_info_get" },
+    {  87, "tx_semaphore_prioritize" },
+    {  88, "tx_semaphore_put" },
+    {  89, "tx_semaphore_put_notify" },
+    { 100, "tx_thread_create" },
+    { 101, "tx_thread_delete" },
+    { 102, "tx_thread_entry_exit_notify" },
+    { 103, "tx_thread_identify" },
+    { 104, "tx_thread_info_get" },
+    { 105, "tx_thread_performance_info_get" },
+    { 106, "tx_thread_performance_system_info_get" },
+    { 107, "tx_thread_preemption_change" },
+    { 108, "tx_thread_priority_change" },
+    { 109, "tx_thread_relinquish" },
+    { 110, "tx_thread_reset" },
+    { 111, "tx_thread_resume" },
+    { 112, "tx_thread_sleep" },
+    { 113, "tx_thread_stack_error_notify" },
+    { 114, "tx_thread_suspend" },
+    { 115, "tx_thread_terminate" },
+    { 116, "tx_thread_time_slice_change" },
+    { 117, "tx_thread_wait_abort" },
+    { 120, "tx_time_get" },
+    { 121, "tx_time_set" },
+    { 122, "tx_timer_activate" },
+    { 123, "tx_timer_change" },
+    { 124, "tx_timer_create" },
+    { 125, "tx_timer_deactivate" },
+    { 126, "tx_timer_delete" },
+    { 127, "tx_timer_info_get" },
+    { 128, "tx_timer_performance_info_get" },
+    { 129, "tx_timer_performance_system_info_get" },
+};
+
+static const uint8_t *trace;
+static size_t trace_size;
+static uint32_t trace_base;
+static double ticks_per_us = 250.0;
+static int skip_services;
+
+static trace_thread_t threads[MAX_THREADS];
+static unsigned thread_count;
+static unsigned char isr_seen[MAX_ISR_TRACKS];
+
+/* Registry, for the names of the objects in service call events */
+static const uint8_t *registry;
+static unsigned registry_entries;
+static unsigned registry_entry_size;
+static unsigned registry_name_size;
+
+/* Private functions ---------------------------------------------------------*/
+static uint32_t get32(const uint8_t *p)
+{
+  return (uint32_t)p[0] | ((uint32_t)p[1] << 8) | ((uint32_t)p[2] << 16) | ((uint32_t)p[3] << 24);
+}
+
+static const uint8_t *trace_at(uint32_t pointer, size_t length)
+{
+  uint32_t offset = pointer - trace_base;
+
+  if ((size_t)offset > trace_size || length > trace_size - offset)
+  {
+    return NULL;
+  }
+  return trace + offset;
+}
+
+static void json_string(const char *s)
+{
+  putchar('"');
+  for (; *s != '\0'; s++)
+  {
+    if (*s == '"' || *s == '\\')
+    {
+      putchar('\\');
+      putchar(*s);
+    }
+    else if ((unsigned char)*s >= 0x20U)
+    {
+      putchar(*s);
+    }
+  }
+  putchar('"');
+}
+
+static void json_track_name(int tid, const char *name, int sort)
+{
+  printf("{\"ph\":\"M\",\"pid\":1,\"tid\":%d,\"name\":\"thread_name\",\"args\":{\"name\":", tid);
+  json_string(name);
+  printf("}},\n");
+  printf("{\"ph\":\"M\",\"pid\":1,\"tid\":%d,\"name\":\"thread_sort_index\",\"args\":{\"sort_index\":%d}},\n",
+         tid, sort);
+}
+
+static const char *registry_name(uint32_t pointer)
+{
+  unsigned i;
+
+  for (i = 0; i < registry_entries; i++)
+  {
+    const uint8_t *entry = registry + (size_t)i * registry_entry_size;
+
+    if (get32(entry + 4) == pointer && entry[TRACE_OBJECT_FIXED] != 0U)
+    {
+      return (const char *)(entry + TRACE_OBJECT_FIXED);
+    }
+  }
+  return NULL;
+}
+
+static trace_thread_t *thread_find(uint32_t pointer)
+{
+  unsigned i;
+
+  if (pointer == 0U || pointer == TRACE_CONTEXT_ISR || pointer == TRACE_CONTEXT_INIT)
+  {
+    return NULL;
+  }
+  for (i = 0; i < thread_count; i++)
+  {
+    if (threads[i].pointer == pointer)
+    {
+      return &threads[i];
+    }
+  }
+  if (thread_count == MAX_THREADS)
+  {
+    return NULL;
+  }
+
+  /* Thread created and deleted before the registry was read */
+  threads[thread_count].pointer = pointer;
+  snprintf(threads[thread_count].name, sizeof(threads[thread_count].name), "thread 0x%08X", (unsigned)pointer);
+  threads[thread_count].priority = 0;
+  threads[thread_count].tid = TID_THREAD_BASE + (int)thread_count;
+  json_track_name(threads[thread_count].tid, threads[thread_count].name, threads[thread_count].tid);
+  return &threads[thread_count++];
+}
+
+static int isr_track(uint32_t isr_id)
+{
+  uint32_t slot = isr_id < MAX_ISR_TRACKS ? isr_id : MAX_ISR_TRACKS - 1U;
+  char name[32];
+
+  if (!isr_seen[slot])
+  {
+    isr_seen[slot] = 1;
+    if (slot == 15U)
+    {
+      snprintf(name, sizeof(name), "ISR 15 (SysTick)");
+    }
+    else if (slot >= 16U)
+    {
+      snprintf(name, sizeof(name), "ISR %u (IRQ %u)", (unsigned)slot, (unsigned)(slot - 16U));
+    }
+    else
+    {
+      snprintf(name, sizeof(name), "ISR %u", (unsigned)slot);
+    }
+    json_track_name(TID_ISR_BASE + (int)slot, name, TID_ISR_BASE + (int)slot);
+  }
+  return TID_ISR_BASE + (int)slot;
+}
+
+static void read_registry(const uint8_t *header)
+{
+  uint32_t start = get32(header + 12);
+  uint32_t end = get32(header + 20);
+  unsigned i;
+
+  registry_name_size = (unsigned)header[18] | ((unsigned)header[19] << 8);
+  registry_entry_size = TRACE_OBJECT_FIXED + registry_name_size;
+  registry_entries = (unsigned)((end - start) / registry_entry_size);
+  registry = trace_at(start, (size_t)registry_entries * registry_entry_size);
+  if (registry == NULL)
+  {
+    registry_entries = 0;
+    return;
+  }
+
+  for (i = 0; i < registry_entries && thread_count < MAX_THREADS; i++)
+  {
+    const uint8_t *entry = registry + (size_t)i * registry_entry_size;
+    trace_thread_t *thread = &threads[thread_count];
+
+    if (entry[1] != TRACE_OBJECT_THREAD || entry[TRACE_OBJECT_FIXED] == 0U)
+    {
+      continue;
+    }
+    thread->pointer = get32(entry + 4);
+    snprintf(thread->name, sizeof(thread->name), "%.*s", (int)registry_name_size - 1,
+             (const char *)(entry + TRACE_OBJECT_FIXED));
+    thread->priority = (((unsigned)entry[2] & 0x7FU) << 8) | entry[3];
+    thread->tid = TID_THREAD_BASE + (int)thread_count;
+    json_track_name(thread->tid, thread->name, TID_THREAD_BASE + (int)thread->priority);
+    thread_count++;
+  }
+}
+
+/* Close the running slice of the current thread and start the next one */
+static void switch_thread(trace_thread_t **current, double *since, trace_thread_t *next, double now)
+{
+  if (*current == next)
+  {
+    return;
+  }
+  if (*current != NULL && now > *since)
+  {
+    printf("{\"ph\":\"X\",\"pid\":1,\"tid\":%d,\"ts\":%.3f,\"dur\":%.3f,\"name\":", TID_CPU, *since, now - *since);
+    json_string((*current)->name);
+    printf("},\n");
+    printf("{\"ph\":\"X\",\"pid\":1,\"tid\":%d,\"ts\":%.3f,\"dur\":%.3f,\"name\":\"running\"},\n",
+           (*current)->tid, *since, now - *since);
+  }
+  *current = next;
+  *since = now;
+}
+
+static void user_event(const uint8_t *event, uint32_t id, int tid, double now)
+{
+  const trace_user_event_t *user = NULL;
+  unsigned i;
+
+  for (i = 0; i < sizeof(user_events) / sizeof(user_events[0]); i++)
+  {
+    if (user_events[i].id == id)
+    {
+      user = &user_events[i];
+    }
+  }
+
+  if (user == NULL)
+  {
+    printf("{\"ph\":\"i\",\"s\":\"t\",\"pid\":1,\"tid\":%d,\"ts\":%.3f,\"name\":\"user %u\","
+           "\"args\":{\"i1\":%u,\"i2\":%u,\"i3\":%u,\"i4\":%u}},\n",
+           tid, now, (unsigned)id, (unsigned)get32(event + 16), (unsigned)get32(event + 20),
+           (unsigned)get32(event + 24), (unsigned)get32(event + 28));
+    return;
+  }
+
+  printf("{\"ph\":\"%s\",", user->kind == USER_BEGIN ? "B" : user->kind == USER_END ? "E" : "i\",\"s\":\"t");
+  printf("\"pid\":1,\"tid\":%d,\"ts\":%.3f,\"name\":\"%s\",\"args\":{\"%s\":%u",
+         tid, now, user->name, user->arg1, (unsigned)get32(event + 16));
+  if (user->arg2 != NULL)
+  {
+    printf(",\"%s\":%d", user->arg2, (int)get32(event + 20));
+  }
+  printf("}},\n");
+}
+
+static void service_event(const uint8_t *event, uint32_t id, int tid, double now)
+{
+  const char *name = NULL;
+  const char *object;
+  unsigned i;
+
+  for (i = 0; i < sizeof(service_events) / sizeof(service_events[0]); i++)
+  {
+    if (service_events[i].id == id)
+    {
+      name = service_events[i].name;
+    }
+  }
+
+  printf("{\"ph\":\"i\",\"s\":\"t\",\"pid\":1,\"tid\":%d,\"ts\":%.3f,\"name\":", tid, now);
+  if (name != NULL)
+  {
+    json_string(name);
+  }
+  else
+  {
+    printf("\"event %u\"", (unsigned)id);
+  }
+  printf(",\"args\":{");
+  object = registry_name(get32(event + 16));
+  if (object != NULL)
+  {
+    printf("\"object\":");
+    json_string(object);
+    printf(",");
+  }
+  printf("\"i1\":\"0x%08X\",\"i2\":%u,\"i3\":%u,\"i4\":%u}},\n", (unsigned)get32(event + 16),
+         (unsigned)get32(event + 20), (unsigned)get32(event + 24), (unsigned)get32(event + 28));
+}
+
+static int convert(void)
+{
+  const uint8_t *header = trace;
+  const uint8_t *buffer_start;
+  const uint8_t *buffer_end;
+  const uint8_t *current;
+  const uint8_t *event;
+  uint32_t mask;
+  uint32_t last_stamp = 0;
+  uint64_t ticks = 0;
+  unsigned long events = 0;
+  trace_thread_t *running = NULL;
+  trace_thread_t *pending = NULL;
+  int switch_pending = 0;
+  double since = 0.0;
+  double now = 0.0;
+  uint32_t isr_stack[MAX_ISR_NESTING];
+  double isr_since[MAX_ISR_NESTING];
+  unsigned isr_depth = 0;
+  int pass;
+
+  if (trace_size < TRACE_HEADER_SIZE || get32(header) != TRACE_VALID)
+  {
+    fprintf(stderr, "No valid ThreadX trace header\n");
+    return -1;
+  }
+
+  mask = get32(header + 4);
+  trace_base = get32(header + 8);
+  buffer_start = trace_at(get32(header + 24), 0);
+  buffer_end = trace_at(get32(header + 28), 0);
+  current = trace_at(get32(header + 32), 0);
+  if (buffer_start == NULL || buffer_end == NULL || current == NULL ||
+      buffer_end < buffer_start || current < buffer_start || current > buffer_end)
+  {
+    fprintf(stderr, "Trace header pointers are outside the buffer\n");
+    return -1;
+  }
+
+  printf("{\"displayTimeUnit\":\"ns\",\"traceEvents\":[\n");
+  printf("{\"ph\":\"M\",\"pid\":1,\"name\":\"process_name\",\"args\":{\"name\":\"ThreadX\"}},\n");
+  json_track_name(TID_CPU, "CPU", 0);
+  json_track_name(TID_INIT, "Initialization", 1);
+  read_registry(header);
+
+  /* Oldest entry first: from the current entry to the end, then from the start */
+  for (pass = 0; pass < 2; pass++)
+  {
+    const uint8_t *from = pass == 0 ? current : buffer_start;
+    const uint8_t *to = pass == 0 ? buffer_end : current;
+
+    for (event = from; event + TRACE_EVENT_SIZE <= to; event += TRACE_EVENT_SIZE)
+    {
+      uint32_t context = get32(event);
+      uint32_t id = get32(event + 8);
+      uint32_t stamp = get32(event + 12) & mask;
+      trace_thread_t *thread = NULL;
+      int tid;
+
+      /* Never written */
+      if (context == 0U)
+      {
+        continue;
+      }
+
+      /* A stamp a little behind the previous one (recorded concurrently,
+         e.g. by an emulated interrupt on the host) is drawn at the same time;
+         only a step of less than half the range is a real advance or wrap */
+      if (events == 0U)
+      {
+        last_stamp = stamp;
+      }
+      else if ((((uint32_t)(stamp - last_stamp)) & mask) <= mask / 2U)
+      {
+        ticks += (uint32_t)(stamp - last_stamp) & mask;
+        last_stamp = stamp;
+      }
+      now = (double)ticks / ticks_per_us;
+      events++;
+
+      if (context == TRACE_CONTEXT_ISR)
+      {
+        tid = isr_depth > 0U ? isr_track(isr_stack[isr_depth - 1U]) : isr_track(0);
+      }
+      else if (context == TRACE_CONTEXT_INIT)
+      {
+        tid = TID_INIT;
+      }
+      else
+      {
+        /* An event from a thread shows it is running */
+        thread = thread_find(context);
+        if (thread != NULL && isr_depth == 0U)
+        {
+          switch_thread(&running, &since, thread, now);
+        }
+        tid = thread != NULL ? thread->tid : TID_INIT;
+      }
+
+      switch (id)
+      {
+        case TRACE_THREAD_RESUME:
+        case TRACE_THREAD_SUSPEND:
+        case TRACE_TIME_SLICE:
+          pending = thread_find(get32(event + (id == TRACE_TIME_SLICE ? 16 : 28)));
+          if (context == TRACE_CONTEXT_ISR || isr_depth > 0U)
+          {
+            switch_pending = 1;
+          }
+          else if (context != TRACE_CONTEXT_INIT)
+          {
+            switch_thread(&running, &since, pending, now);
+          }
+          break;
+
+        case TRACE_ISR_ENTER:
+          if (isr_depth < MAX_ISR_NESTING)
+          {
+            isr_stack[isr_depth] = get32(event + 20);
+            isr_since[isr_depth] = now;
+          }
+          isr_depth++;
+          break;
+
+        case TRACE_ISR_EXIT:
+          if (isr_depth == 0U)
+          {
+            break;
+          }
+          isr_depth--;
+          if (isr_depth < MAX_ISR_NESTING)
+          {
+            printf("{\"ph\":\"X\",\"pid\":1,\"tid\":%d,\"ts\":%.3f,\"dur\":%.3f,\"name\":\"handler\"},\n",
+                   isr_track(isr_stack[isr_depth]), isr_since[isr_depth], now - isr_since[isr_depth]);
+          }
+          if (isr_depth == 0U && switch_pending)
+          {
+            switch_thread(&running, &since, pending, now);
+            switch_pending = 0;
+          }
+          break;
+
+        case TRACE_RUNNING:
+          break;
+
+        default:
+          if (id >= TRACE_USER_EVENT_START)
+          {
+            user_event(event, id, tid, now);
+          }
+          else if (!skip_services)
+          {
+            service_event(event, id, tid, now);
+          }
+          break;
+      }
+    }
+  }
+
+  switch_thread(&running, &since, NULL, now);
+
+  /* Trailing metadata entry: the event list needs no comma handling */
+  printf("{\"ph\":\"M\",\"pid\":1,\"name\":\"process_sort_index\",\"args\":{\"sort_index\":0}}\n]}\n");
+
+  fprintf(stderr, "%lu events over %.3f ms, %u threads, %u registry entries%s\n",
+          events, now / 1000.0, thread_count, registry_entries,
+          current != buffer_start && get32(buffer_end - TRACE_EVENT_SIZE) != 0U ? ", buffer wrapped" : "");
+  return 0;
+}
+
+static int hex_digit(int c)
+{
+  if (c >= '0' && c <= '9')
+  {
+    return c - '0';
+  }
+  if (c >= 'A' && c <= 'F')
+  {
+    return c - 'A' + 10;
+  }
+  if (c >= 'a' && c <= 'f')
+  {
+    return c - 'a' + 10;
+  }
+  return -1;
+}
+
+/* [TRACE] lines of meteo_trace_dump(): all-zero lines are not printed */
+static uint8_t *read_log(FILE *in, size_t *size)
+{
+  char line[LOG_LINE_SIZE];
+  uint8_t *buffer = NULL;
+  uint8_t *complete = NULL;
+  size_t length = 0;
+  size_t complete_length = 0;
+
+  while (fgets(line, sizeof(line), in) != NULL)
+  {
+    char *p = strstr(line, "[TRACE] ");
+    char *end;
+    unsigned long offset;
+
+    if (p == NULL)
+    {
+      continue;
+    }
+    p += 8;
+
+    if (strncmp(p, "BEGIN ", 6) == 0)
+    {
+      free(buffer);
+      length = strtoul(p + 6, NULL, 10);
+      buffer = calloc(length != 0U ? length : 1U, 1);
+      if (buffer == NULL)
+      {
+        length = 0;
+      }
+      continue;
+    }
+    if (strncmp(p, "END", 3) == 0)
+    {
+      if (buffer != NULL)
+      {
+        free(complete);
+        complete = buffer;
+        complete_length = length;
+        buffer = NULL;
+      }
+      continue;
+    }
+    if (buffer == NULL)
+    {
+      continue;
+    }
+
+    offset = strtoul(p, &end, 16);
+    if (end == p || *end != ' ')
+    {
+      continue;
+    }
+    for (p = end + 1; hex_digit(p[0]) >= 0 && hex_digit(p[1]) >= 0 && offset < length; p += 2)
+    {
+      buffer[offset++] = (uint8_t)((hex_digit(p[0]) << 4) | hex_digit(p[1]));
+    }
+  }
+
+  free(buffer);
+  *size = complete_length;
+  return complete;
+}
+
+static uint8_t *read_raw(FILE *in, size_t *size)
+{
+  uint8_t *buffer = NULL;
+  size_t length = 0;
+  size_t capacity = 0;
+  size_t n;
+
+  do
+  {
+    if (length == capacity)
+    {
+      uint8_t *grown;
+
+      capacity = capacity != 0U ? capacity * 2U : 65536U;
+      grown = realloc(buffer, capacity);
+      if (grown == NULL)
+      {
+        free(buffer);
+        return NULL;
+      }
+      buffer = grown;
+    }
+    n = fread(buffer + length, 1, capacity - length, in);
+    length += n;
+  } while (n != 0U);
+
+  *size = length;
+  return buffer;
+}
+
+int main(int argc, char **argv)
+{
+  int raw = 0;
+  int opt;
+  FILE *in;
+  uint8_t *buffer;
+  int result;
+
+  while ((opt = getopt(argc, argv, "bf:k")) != -1)
+  {
+    switch (opt)
+    {
+      case 'b':
+        raw = 1;
+        break;
+      case 'f':
+        ticks_per_us = strtod(optarg, NULL) / 1e6;
+        break;
+      case 'k':
+        skip_services = 1;
+        break;
+      default:
+        fprintf(stderr, "Usage: %s [-b] [-f hz] [-k] dump > trace.json\n", argv[0]);
+        return 2;
+    }
+  }
+  if (ticks_per_us <= 0.0)
+  {
+    fprintf(stderr, "Invalid time source frequency\n");
+    return 2;
+  }
+
+  in = optind < argc ? fopen(argv[optind], raw ? "rb" : "r") : stdin;
+  if (in == NULL)
+  {
+    perror(argv[optind]);
+    return 1;
+  }
+
+  buffer = raw ? read_raw(in, &trace_size) : read_log(in, &trace_size);
+  if (in != stdin)
+  {
+    fclose(in);
+  }
+  if (buffer == NULL)
+  {
+    fprintf(stderr, "No complete trace dump in the input\n");
+    return 1;
+  }
+
+  trace = buffer;
+  result = convert();
+  free(buffer);
+  return result == 0 ? 0 : 1;
+}
@@ -63,7 +63,7 @@ extern "C" {
 /* Exported functions prototypes ---------------------------------------------*/
 void MX_ITTIA_Init(void);
 /* USER CODE BEGIN EFP */
-
+void app_ittia_mem_profile_print(int csv);
 /* USER CODE END EFP */
 
 /* Private defines -----------------------------------------------------------*/
@@ -48,7 +48,12 @@ extern "C" {
 #define TX_APP_THREAD_PRIO                      10
 
 /* USER CODE BEGIN PD */
-
+/* 19.10.26 METEO app threads: the frame path above the database, the
+   console / simulator (tx app thread, once the services are up) with the
+   DB thread */
+#define METEO_THREAD_PRIO                       10
+#define METEO_DB_THREAD_PRIO                    15
+#define METEO_SIMULATOR_THREAD_PRIO             METEO_DB_THREAD_PRIO
 /* USER CODE END PD */
 
 /* Main thread defines -------------------------------------------------------*/
@@ -224,6 +224,9 @@ void Error_Handler(void);
 
 extern TX_QUEUE meteo_frame_queue;
 extern UCHAR meteo_queue_storage[METEO_QUEUE_STORAGE_SIZE];
+// 19.10.26 Framer/simulator -> meteo thread (same geometry)
+extern TX_QUEUE meteo_rx_queue;
+extern UCHAR meteo_rx_queue_storage[METEO_QUEUE_STORAGE_SIZE];
 
 /* USER CODE END Prototypes */
 
@@ -0,0 +1,224 @@
+/* USER CODE BEGIN HeaderArchive */
+/**
+  ******************************************************************************
+  * @file           : meteo_archive.h
+  * @brief          : Header for meteo_archive.c file.
+  *                   Compressed column segments for long-term readings
+  ******************************************************************************
+  * @attention
+  *
+  * Copyright (c) 2026 STMicroelectronics.
+  * All rights reserved.
+  *
+  ******************************************************************************
+  */
+/* USER CODE END HeaderArchive */
+
+#ifndef METEO_ARCHIVE_H
+#define METEO_ARCHIVE_H
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/* Includes ------------------------------------------------------------------*/
+/* No RTOS or HAL: the decoder also builds on Linux (Core/Host/Tools) */
+#include <stdint.h>
+
+/* Exported constants --------------------------------------------------------*/
+
+#define METEO_ARCHIVE_MAGIC         0x4352414DUL    /* "MARC" */
+#define METEO_ARCHIVE_VERSION       1U
+
+/* Serialized header, then the columns (each padded to 4 bytes), then the
+   CRC-32 (IEEE) of everything before it. All little endian. */
+#define METEO_ARCHIVE_HEADER_SIZE   176U
+
+/* Encoder column buffers. A chunk is sealed early when one is nearly full. */
+#define METEO_ARCHIVE_TS_BYTES      1024U
+#define METEO_ARCHIVE_XOR_BYTES     3072U
+#define METEO_ARCHIVE_RLE_BYTES     1536U
+#define METEO_ARCHIVE_SEGMENT_MAX   (METEO_ARCHIVE_HEADER_SIZE + METEO_ARCHIVE_TS_BYTES + \
+                                     3U * METEO_ARCHIVE_XOR_BYTES + 2U * METEO_ARCHIVE_RLE_BYTES + 4U)
+
+/* Default time chunk and timestamp resolution (HAL_GetTick() is in ms) */
+#define METEO_ARCHIVE_CHUNK_SECONDS 900U
+#define METEO_ARCHIVE_TS_SCALE_US   1000U
+
+/* Status */
+#define METEO_ARCHIVE_OK            0
+#define METEO_ARCHIVE_END           1
+#define METEO_ARCHIVE_ERROR_FORMAT  (-1)
+#define METEO_ARCHIVE_ERROR_CRC     (-2)
+#define METEO_ARCHIVE_ERROR_SINK    (-3)
+
+/* Exported types ------------------------------------------------------------*/
+
+/* Value columns; column 0 holds the timestamps */
+typedef enum
+{
+  METEO_ARCHIVE_TEMPERATURE = 0,    /* degC, XOR      */
+  METEO_ARCHIVE_PRESSURE,           /* hPa, RLE x10   */
+  METEO_ARCHIVE_WIND_SPEED,         /* m/s, XOR       */
+  METEO_ARCHIVE_WIND_DIRECTION,     /* deg, XOR       */
+  METEO_ARCHIVE_VOLTAGE,            /* RLE x1         */
+  METEO_ARCHIVE_CHANNELS
+} meteo_archive_channel_t;
+
+#define METEO_ARCHIVE_COLUMNS       (METEO_ARCHIVE_CHANNELS + 1U)
+
+typedef enum
+{
+  METEO_ARCHIVE_CODEC_DOD = 0,      /* Delta of delta (Gorilla timestamps)      */
+  METEO_ARCHIVE_CODEC_XOR,          /* float32 XOR with the previous (Gorilla)  */
+  METEO_ARCHIVE_CODEC_RLE           /* value x scale as integer runs            */
+} meteo_archive_codec_t;
+
+typedef struct
+{
+  int64_t ts_usec;
+  float value[METEO_ARCHIVE_CHANNELS];
+} meteo_archive_sample_t;
+
+typedef struct
+{
+  float min;
+  float max;
+  float first;
+  float last;
+} meteo_archive_range_t;
+
+/* Segment header. Timestamps are those the decoder returns: chunk start
+   plus a multiple of ts_scale_us. */
+typedef struct
+{
+  uint32_t bytes;                   /* Whole segment, CRC included */
+  uint32_t seq;                     /* Segment number, +1 per segment */
+  uint32_t samples;
+  uint32_t ts_scale_us;
+  int64_t chunk_start_usec;
+  int64_t ts_first_usec;
+  int64_t ts_last_usec;
+  int64_t ts_min_usec;
+  int64_t ts_max_usec;
+  uint8_t codec[METEO_ARCHIVE_COLUMNS];
+  uint16_t scale[METEO_ARCHIVE_COLUMNS];
+  uint16_t column_bytes[METEO_ARCHIVE_COLUMNS];
+  meteo_archive_range_t range[METEO_ARCHIVE_CHANNELS];
+} meteo_archive_header_t;
+
+/* Receives a sealed segment; returns 0 when it was stored */
+typedef int (*meteo_archive_sink_t)(void *context, const uint8_t *segment, uint32_t bytes);
+
+typedef struct
+{
+  uint8_t *data;
+  uint32_t capacity;                /* bits */
+  uint32_t bits;
+} meteo_archive_bitbuf_t;
+
+typedef struct
+{
+  const uint8_t *data;
+  uint32_t bits;
+  uint32_t pos;
+} meteo_archive_bitreader_t;
+
+/* Streaming encoder: one chunk in RAM (~13 KB), no heap */
+typedef struct
+{
+  uint8_t buffer[METEO_ARCHIVE_SEGMENT_MAX];
+  meteo_archive_bitbuf_t column[METEO_ARCHIVE_COLUMNS];
+  meteo_archive_header_t header;
+  int64_t chunk_usec;
+  int64_t prev_ts;                  /* ts_scale_us units from the chunk start */
+  int64_t prev_delta;
+  uint32_t prev_bits[METEO_ARCHIVE_CHANNELS];
+  uint8_t leading[METEO_ARCHIVE_CHANNELS];
+  uint8_t trailing[METEO_ARCHIVE_CHANNELS];
+  int32_t run_base[METEO_ARCHIVE_CHANNELS];
+  int32_t run_value[METEO_ARCHIVE_CHANNELS];
+  uint32_t run_count[METEO_ARCHIVE_CHANNELS];
+  uint32_t next_seq;
+  meteo_archive_sink_t sink;
+  void *context;
+  uint32_t sealed;                  /* Segments handed to the sink */
+  uint32_t sink_errors;             /* ... that it failed to store */
+} meteo_archive_encoder_t;
+
+/* Streaming decoder over one segment in memory, no heap */
+typedef struct
+{
+  meteo_archive_header_t header;
+  meteo_archive_bitreader_t column[METEO_ARCHIVE_COLUMNS];
+  uint32_t index;
+  int64_t prev_ts;
+  int64_t prev_delta;
+  uint32_t prev_bits[METEO_ARCHIVE_CHANNELS];
+  uint8_t leading[METEO_ARCHIVE_CHANNELS];
+  uint8_t length[METEO_ARCHIVE_CHANNELS];
+  int32_t run_value[METEO_ARCHIVE_CHANNELS];
+  uint32_t run_left[METEO_ARCHIVE_CHANNELS];
+} meteo_archive_decoder_t;
+
+/* Exported functions --------------------------------------------------------*/
+
+/**
+ * @brief Start an encoder
+ * @param chunk_seconds Time chunk: samples in the same multiple of it go in
+ *        one segment (clamped so the offsets fit 30 bits)
+ * @param ts_scale_us Timestamp resolution kept
+ * @param first_seq seq of the first segment
+ * @param sink Called with each sealed segment
+ */
+void meteo_archive_encoder_init(meteo_archive_encoder_t *encoder, uint32_t chunk_seconds,
+                                uint32_t ts_scale_us, uint32_t first_seq,
+                                meteo_archive_sink_t sink, void *context);
+
+/**
+ * @brief Add one sample. Seals the chunk first when the sample is in the
+ *        next one or a column is nearly full.
+ * @return METEO_ARCHIVE_OK, METEO_ARCHIVE_ERROR_SINK when a sealed segment
+ *         was not stored (it is dropped, the sample is kept)
+ */
+int meteo_archive_encoder_add(meteo_archive_encoder_t *encoder, const meteo_archive_sample_t *sample);
+
+/**
+ * @brief Seal the current chunk now (no-op when empty)
+ */
+int meteo_archive_encoder_flush(meteo_archive_encoder_t *encoder);
+
+/**
+ * @brief Samples and compressed bits in the open chunk
+ */
+uint32_t meteo_archive_encoder_pending(const meteo_archive_encoder_t *encoder, uint32_t *bits);
+
+/**
+ * @brief Check and parse a segment header (the CRC needs the whole segment)
+ * @param size Bytes available at data
+ * @return METEO_ARCHIVE_OK or METEO_ARCHIVE_ERROR_FORMAT
+ */
+int meteo_archive_header_read(const uint8_t *data, uint32_t size, meteo_archive_header_t *header);
+
+/**
+ * @brief Start decoding a whole segment (header and CRC are checked)
+ * @return METEO_ARCHIVE_OK, METEO_ARCHIVE_ERROR_FORMAT or METEO_ARCHIVE_ERROR_CRC
+ */
+int meteo_archive_decoder_init(meteo_archive_decoder_t *decoder, const uint8_t *data, uint32_t size);
+
+/**
+ * @brief Next sample, in the order they were added
+ * @return METEO_ARCHIVE_OK, METEO_ARCHIVE_END, METEO_ARCHIVE_ERROR_FORMAT
+ */
+int meteo_archive_decoder_next(meteo_archive_decoder_t *decoder, meteo_archive_sample_t *sample);
+
+/**
+ * @brief CRC-32 (IEEE 802.3) of a buffer
+ */
+uint32_t meteo_archive_crc32(const uint8_t *data, uint32_t length);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* METEO_ARCHIVE_H */
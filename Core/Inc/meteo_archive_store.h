@@ -0,0 +1,227 @@
+/* USER CODE BEGIN HeaderArchiveStore */
+/**
+  ******************************************************************************
+  * @file           : meteo_archive_store.h
+  * @brief          : Header for meteo_archive_store.c file.
+  *                   Archive segments on OSPI flash
+  ******************************************************************************
+  * @attention
+  *
+  * Copyright (c) 2026 STMicroelectronics.
+  * All rights reserved.
+  *
+  ******************************************************************************
+  */
+/* USER CODE END HeaderArchiveStore */
+
+#ifndef METEO_ARCHIVE_STORE_H
+#define METEO_ARCHIVE_STORE_H
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/* Includes ------------------------------------------------------------------*/
+#include "tx_api.h"
+#include "meteo_archive.h"
+#include "meteo_ospi.h"
+#include <stdint.h>
+
+/* Exported constants --------------------------------------------------------*/
+
+/* Below the frame journal (meteo_ospi.h), 128 x 64 KB = 8 MB.
+   The last METEO_ARCHIVE_ZONE_BLOCKS hold checkpoints of the zone map. */
+#define METEO_ARCHIVE_ZONE_BLOCKS   2U
+#define METEO_ARCHIVE_STORE_BLOCKS  (METEO_OSPI_ARCHIVE_BLOCKS - METEO_ARCHIVE_ZONE_BLOCKS)
+
+/* Segments are written in pieces of this size, the OSPI lock is released
+   between them */
+#define METEO_ARCHIVE_STORE_WRITE   1024U
+
+/* Exported types ------------------------------------------------------------*/
+
+typedef struct
+{
+  uint32_t next_seq;        /* seq of the next segment */
+  uint32_t oldest;          /* Oldest seq still on flash */
+  uint32_t segments;        /* Written since start-up */
+  uint32_t samples;         /* Added since start-up */
+  uint32_t bytes;           /* Segment bytes written since start-up */
+  uint32_t pending;         /* Samples in the open chunk (RAM) */
+  uint32_t pending_bits;
+  uint32_t erases;
+  uint32_t trimmed;         /* Blocks erased by meteo_archive_store_trim() */
+  uint32_t preerased;       /* Blocks the writer entered trimmed, not erasing them */
+  uint32_t write_errors;    /* Segments dropped: flash error */
+  uint32_t open_reads;      /* Header reads to find the end at start-up */
+  uint32_t checkpoints;     /* Zone map checkpoints written */
+  uint32_t zones_rebuilt;   /* Blocks walked at start-up, newer than the checkpoint */
+  int64_t time_base_usec;   /* Archive time at tick 0 of this start-up */
+  uint8_t  opened;
+} meteo_archive_store_stats_t;
+
+/* Zone map entry of one archive block: time range and value ranges of the
+   segments in it, so a query skips the block without reading it */
+typedef struct
+{
+  int64_t ts_min_usec;
+  int64_t ts_max_usec;
+  uint32_t first_seq;
+  uint32_t segments;        /* 0: empty block */
+  float min[METEO_ARCHIVE_CHANNELS];
+  float max[METEO_ARCHIVE_CHANNELS];
+} meteo_archive_zone_t;
+
+/* Range query over the sealed segments */
+typedef struct
+{
+  int64_t from_usec;        /* Archive time, both ends included */
+  int64_t to_usec;
+  uint32_t channel;         /* Value predicate, METEO_ARCHIVE_CHANNELS for none */
+  float min;                /* channel value in [min, max] */
+  float max;
+} meteo_archive_query_t;
+
+typedef struct
+{
+  uint32_t blocks_skipped;  /* By the zone map, not read */
+  uint32_t blocks_read;
+  uint32_t segments_skipped;/* By their header */
+  uint32_t segments_read;
+  uint32_t segments_bad;    /* CRC or decode error */
+  uint32_t samples;         /* Decoded */
+  uint32_t matched;         /* Passed to the callback */
+  uint32_t bytes_read;      /* Flash bytes, headers included */
+} meteo_archive_query_stats_t;
+
+/* Receives each matching sample; a non-zero return stops the query */
+typedef int (*meteo_archive_query_cb_t)(void *context, const meteo_archive_sample_t *sample);
+
+/* A query read a few samples at a time (meteo_archive_store_read). The
+   segment being decoded is kept here, so nothing is locked between reads;
+   the decoder points into it and the cursor must not be copied. Segments
+   written after the cursor was opened may be returned too. */
+typedef struct
+{
+  meteo_archive_query_t query;
+  meteo_archive_query_stats_t stats;
+  uint32_t head;            /* Writer block when opened: read last */
+  uint32_t step;            /* Blocks entered, up to METEO_ARCHIVE_STORE_BLOCKS */
+  ULONG offset;             /* Next segment header in the block */
+  uint8_t in_block;
+  uint8_t decoding;
+  uint8_t done;
+  meteo_archive_decoder_t decoder;
+  uint32_t segment[(METEO_ARCHIVE_SEGMENT_MAX + 3U) / sizeof(uint32_t)];
+} meteo_archive_cursor_t;
+
+/* Exported functions --------------------------------------------------------*/
+
+/**
+ * @brief Create the mutex. Call from App_ThreadX_Init.
+ */
+void meteo_archive_store_init(void);
+
+/**
+ * @brief Find the newest segment by binary search over the blocks.
+ *        Call from a thread once the OSPI is initialized.
+ * @return TX_SUCCESS, TX_NOT_DONE on a flash error
+ */
+UINT meteo_archive_store_open(void);
+
+/**
+ * @brief Decode the readings of a METEO frame, scaled as the archive keeps
+ *        them (ts_usec is left 0)
+ * @return TX_SUCCESS, TX_SIZE_ERROR for a frame that does not parse
+ */
+UINT meteo_archive_store_parse_frame(const char *frame, meteo_archive_sample_t *sample);
+
+/**
+ * @brief Add one decoded sample (DB thread), stamped with the archive time
+ *        when sample->ts_usec is 0 (it is set), else as stamped by the
+ *        caller from meteo_archive_store_now(). A sealed chunk is written
+ *        to flash before the call returns.
+ * @return TX_SUCCESS, TX_NOT_AVAILABLE before meteo_archive_store_open(),
+ *         TX_NOT_DONE when a sealed segment could not be written
+ */
+UINT meteo_archive_store_add(meteo_archive_sample_t *sample);
+
+/**
+ * @brief meteo_archive_store_parse_frame() and meteo_archive_store_add()
+ * @return TX_SUCCESS, TX_NOT_AVAILABLE before meteo_archive_store_open(),
+ *         TX_SIZE_ERROR for a frame that does not parse, TX_NOT_DONE when
+ *         a sealed segment could not be written
+ */
+UINT meteo_archive_store_add_frame(const char *frame);
+
+/**
+ * @brief Seal the open chunk now (it is lost on a reset otherwise)
+ * @return TX_SUCCESS, TX_NOT_AVAILABLE, TX_NOT_DONE
+ */
+UINT meteo_archive_store_flush(void);
+
+/**
+ * @brief Erase the oldest block ahead of the writer, if its samples are all
+ *        older than before_usec or the blocks in use take more than
+ *        max_bytes. One block per call, never the one being written; the
+ *        archive is not locked while the flash erases.
+ * @param bytes Flash bytes freed: a block, or 0 when nothing was due
+ * @return TX_SUCCESS, TX_NOT_AVAILABLE before meteo_archive_store_open(),
+ *         TX_NOT_DONE on a flash error
+ */
+UINT meteo_archive_store_trim(int64_t before_usec, ULONG max_bytes, ULONG *bytes);
+
+/**
+ * @brief Samples of the sealed segments that match a query, oldest block
+ *        first. Blocks and segments that cannot match are skipped using the
+ *        zone map and the segment headers; only the others are read whole.
+ *        The DB thread keeps adding while a query runs.
+ * @param stats Optional, filled in
+ * @return TX_SUCCESS, TX_NOT_AVAILABLE before meteo_archive_store_open(),
+ *         TX_NOT_DONE on a flash error
+ */
+UINT meteo_archive_store_query(const meteo_archive_query_t *query, meteo_archive_query_cb_t callback,
+                               void *context, meteo_archive_query_stats_t *stats);
+
+/**
+ * @brief Start a cursor over the samples that match a query, in the order
+ *        of meteo_archive_store_query()
+ * @return TX_SUCCESS, TX_NOT_AVAILABLE before meteo_archive_store_open()
+ *         (the cursor is then at its end)
+ */
+UINT meteo_archive_store_cursor_open(meteo_archive_cursor_t *cursor, const meteo_archive_query_t *query);
+
+/**
+ * @brief Read up to max matching samples from the cursor and advance it
+ * @param count Samples stored in samples, less than max only at the end
+ * @return TX_SUCCESS (count is 0 once the query is done), TX_NOT_DONE on a
+ *         flash error (the cursor is then at its end)
+ */
+UINT meteo_archive_store_read(meteo_archive_cursor_t *cursor, meteo_archive_sample_t *samples,
+                              UINT max, UINT *count);
+
+/**
+ * @brief Archive time of the current tick, as given to the samples added now.
+ *        HAL_GetTick() wraps every 49.7 days: the wraps are counted when this
+ *        or meteo_archive_store_add() reads the clock, so one of them must
+ *        run at least once per wrap: the DB thread does for every reading,
+ *        the retention thread at every step.
+ */
+int64_t meteo_archive_store_now(void);
+
+/**
+ * @brief Copy the zone map entry of an archive block
+ * @return TX_SUCCESS, TX_SIZE_ERROR for a block out of range
+ */
+UINT meteo_archive_store_get_zone(uint32_t block, meteo_archive_zone_t *zone);
+
+/**
+ * @brief Copy the counters
+ */
+void meteo_archive_store_get_stats(meteo_archive_store_stats_t *stats);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* METEO_ARCHIVE_STORE_H */
@@ -0,0 +1,137 @@
+/* USER CODE BEGIN HeaderColumns */
+/**
+  ******************************************************************************
+  * @file           : meteo_columns.h
+  * @brief          : Header for meteo_columns.c file.
+  *                   Binary column export format (MCOL) and its reader
+  ******************************************************************************
+  * @attention
+  *
+  * Copyright (c) 2026 STMicroelectronics.
+  * All rights reserved.
+  *
+  ******************************************************************************
+  */
+/* USER CODE END HeaderColumns */
+
+#ifndef METEO_COLUMNS_H
+#define METEO_COLUMNS_H
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/* Includes ------------------------------------------------------------------*/
+/* No RTOS or HAL: the reader also builds on Linux (Core/Host/Tools) */
+#include <stddef.h>
+#include <stdint.h>
+#include "meteo_archive.h"
+
+/* Exported constants --------------------------------------------------------*/
+
+#define METEO_COLUMNS_MAGIC         0x4C4F434DUL    /* "MCOL" */
+#define METEO_COLUMNS_CHUNK_MAGIC   0x4B48434DUL    /* "MCHK" */
+#define METEO_COLUMNS_VERSION       1U
+
+/* A stream is the header (schema), column chunks and an end chunk (0 rows).
+   Header: magic, version u16, columns u16, header bytes u32, 0 u32, then
+   per column name[20] (NUL padded), type u8, decimals u8, 0 u16.
+   Chunk: magic, rows u32, chunk bytes u32, 0 u32, then per column rows
+   little endian values padded to 8 bytes. Every part is a multiple of 8
+   bytes, so in a mapped file each array is aligned for its type. */
+#define METEO_COLUMNS_HEADER_FIXED  16U
+#define METEO_COLUMNS_FIELD_SIZE    24U
+#define METEO_COLUMNS_NAME_SIZE     20U
+#define METEO_COLUMNS_CHUNK_HEADER  16U
+
+/* Most columns the reader takes */
+#define METEO_COLUMNS_MAX           16U
+
+/* Columns written by the export: ts, then the archive channels */
+#define METEO_COLUMNS_EXPORTED      (METEO_ARCHIVE_CHANNELS + 1U)
+
+/* Status */
+#define METEO_COLUMNS_OK            0
+#define METEO_COLUMNS_END           1
+#define METEO_COLUMNS_ERROR_FORMAT  (-1)
+#define METEO_COLUMNS_ERROR_TRUNCATED (-2)
+
+/* Exported types ------------------------------------------------------------*/
+
+/* Column types, as the db_fielddef_t types of the meteo_readings table */
+typedef enum
+{
+  METEO_COLUMNS_TIMESTAMP = 1,      /* int64_t, us since 1970 (DB_COLTYPE_TIMESTAMP) */
+  METEO_COLUMNS_FLOAT32,            /* float (DB_COLTYPE_FLOAT32)                     */
+  METEO_COLUMNS_SINT32              /* int32_t (DB_COLTYPE_SINT32)                    */
+} meteo_columns_type_t;
+
+typedef struct
+{
+  char name[METEO_COLUMNS_NAME_SIZE];   /* NUL terminated */
+  uint8_t type;                         /* meteo_columns_type_t */
+  uint8_t decimals;                     /* For text: of the seconds for a timestamp */
+  uint8_t width;                        /* Bytes per value */
+} meteo_columns_field_t;
+
+/* Reader over a whole stream in memory, e.g. a mapped file. No copies:
+   the chunks point into the data. */
+typedef struct
+{
+  const uint8_t *data;
+  size_t size;
+  size_t offset;                        /* Of the next chunk */
+  uint32_t columns;
+  meteo_columns_field_t field[METEO_COLUMNS_MAX];
+  uint32_t chunks;
+  uint64_t rows;
+} meteo_columns_reader_t;
+
+typedef struct
+{
+  uint32_t rows;
+  /* Per column, rows values of the field type; aligned when data is 8-byte aligned */
+  const void *column[METEO_COLUMNS_MAX];
+} meteo_columns_chunk_t;
+
+/* Exported functions --------------------------------------------------------*/
+
+/**
+ * @brief Header of the export schema: ts, then the channels of
+ *        meteo_archive_channel_t as float32
+ * @return Bytes written, 0 when size is too small
+ */
+uint32_t meteo_columns_header(uint8_t *out, uint32_t size);
+
+/**
+ * @brief Bytes of a chunk of rows samples of the export schema
+ */
+uint32_t meteo_columns_chunk_bytes(uint32_t rows);
+
+/**
+ * @brief Chunk of rows samples of the export schema; rows 0 is the end chunk
+ * @return Bytes written, 0 when size is too small
+ */
+uint32_t meteo_columns_chunk(uint8_t *out, uint32_t size, const meteo_archive_sample_t *samples,
+                             uint32_t rows);
+
+/**
+ * @brief Check the header and read the schema. Little endian hosts only
+ *        (the arrays are used as they are).
+ * @return METEO_COLUMNS_OK or METEO_COLUMNS_ERROR_FORMAT
+ */
+int meteo_columns_open(meteo_columns_reader_t *reader, const void *data, size_t size);
+
+/**
+ * @brief Next chunk
+ * @return METEO_COLUMNS_OK, METEO_COLUMNS_END at the end chunk,
+ *         METEO_COLUMNS_ERROR_TRUNCATED when the data stops before it,
+ *         METEO_COLUMNS_ERROR_FORMAT for a damaged chunk
+ */
+int meteo_columns_next(meteo_columns_reader_t *reader, meteo_columns_chunk_t *chunk);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* METEO_COLUMNS_H */
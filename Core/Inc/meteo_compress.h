@@ -0,0 +1,159 @@
+/* USER CODE BEGIN HeaderCompress */
+/**
+  ******************************************************************************
+  * @file           : meteo_compress.h
+  * @brief          : Header for meteo_compress.c file.
+  *                   Deadband and swinging-door compression of the readings
+  ******************************************************************************
+  * @attention
+  *
+  * Copyright (c) 2026 STMicroelectronics.
+  * All rights reserved.
+  *
+  ******************************************************************************
+  */
+/* USER CODE END HeaderCompress */
+
+#ifndef METEO_COMPRESS_H
+#define METEO_COMPRESS_H
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/* Includes ------------------------------------------------------------------*/
+#include "tx_api.h"
+#include "meteo_archive.h"
+#include <stdint.h>
+
+/* Exported constants --------------------------------------------------------*/
+
+/* Longest time without a kept reading by default, whatever the values */
+#define METEO_COMPRESS_HEARTBEAT_S  60U
+
+/* Channels of a meteo_readings row: only they decide which rows are kept */
+#define METEO_COMPRESS_ROW_CHANNELS ((1UL << METEO_ARCHIVE_TEMPERATURE) | \
+                                     (1UL << METEO_ARCHIVE_WIND_SPEED) | \
+                                     (1UL << METEO_ARCHIVE_WIND_DIRECTION))
+
+/* Exported types ------------------------------------------------------------*/
+
+typedef enum
+{
+  METEO_COMPRESS_OFF = 0,         /* Every reading */
+  METEO_COMPRESS_DEADBAND,        /* When it moved more than tolerance from
+                                     the last kept one (hold in between) */
+  METEO_COMPRESS_SWINGING_DOOR    /* When the line from the last kept one
+                                     would miss a reading by more than
+                                     tolerance (interpolate in between) */
+} meteo_compress_mode_t;
+
+typedef struct
+{
+  uint8_t mode;                   /* meteo_compress_mode_t */
+  uint8_t circular;               /* Degrees: changes across 0/360 are short
+                                     (deadband only) */
+  float tolerance;                /* Units of the channel */
+  uint32_t heartbeat_s;           /* A reading at least this often, 0 = none */
+} meteo_compress_config_t;
+
+/* What a channel needs for a new reading */
+typedef enum
+{
+  METEO_COMPRESS_SKIP = 0,        /* Nothing kept yet */
+  METEO_COMPRESS_HELD,            /* Keep the previous reading first */
+  METEO_COMPRESS_KEEP             /* Keep this one */
+} meteo_compress_action_t;
+
+/* One channel. The swinging door is the range of slopes from the last kept
+   point that pass within tolerance of every reading since: it closes when a
+   reading leaves no such slope, and the previous reading is kept, on the
+   door, so the line to it misses none by more than tolerance. */
+typedef struct
+{
+  int64_t anchor_usec;            /* Last kept point */
+  int64_t held_usec;              /* Previous reading, not kept */
+  float anchor;
+  float held;
+  float slope_min;                /* Door, per second */
+  float slope_max;
+  uint8_t anchored;
+  uint8_t holding;
+} meteo_compress_t;
+
+typedef struct
+{
+  uint32_t readings;
+  uint32_t rows;                  /* Kept by meteo_compress_apply() */
+  uint32_t held;                  /* ... of them previous readings, for a door */
+} meteo_compress_stats_t;
+
+/* Exported functions --------------------------------------------------------*/
+
+/**
+ * @brief Forget the points and the door of one channel
+ */
+void meteo_compress_reset(meteo_compress_t *channel);
+
+/**
+ * @brief What the channel needs for a reading at ts_usec (after the last one)
+ */
+meteo_compress_action_t meteo_compress_check(const meteo_compress_t *channel,
+                                             const meteo_compress_config_t *config,
+                                             int64_t ts_usec, float value);
+
+/**
+ * @brief Keep the previous reading: swinging door, its value on the door
+ * @return Value to store at held_usec
+ */
+float meteo_compress_keep_held(meteo_compress_t *channel, const meteo_compress_config_t *config);
+
+/**
+ * @brief Keep this reading: swinging door, on the door with it
+ * @return Value to store at ts_usec
+ */
+float meteo_compress_keep(meteo_compress_t *channel, const meteo_compress_config_t *config,
+                          int64_t ts_usec, float value);
+
+/**
+ * @brief Drop this reading: narrow the door to it and hold it
+ */
+void meteo_compress_drop(meteo_compress_t *channel, const meteo_compress_config_t *config,
+                         int64_t ts_usec, float value);
+
+/**
+ * @brief Channels on their own, as a series per channel would keep them:
+ *        check, then keep_held / keep / drop
+ * @param points Out: up to two points of (ts_usec, value)
+ * @return Points kept, 0..2
+ */
+uint32_t meteo_compress_add(meteo_compress_t *channel, const meteo_compress_config_t *config,
+                            int64_t ts_usec, float value, int64_t points_usec[2], float points[2]);
+
+/**
+ * @brief Create the mutex and set the default configuration. Call from
+ *        App_ThreadX_Init.
+ */
+void meteo_compress_init(void);
+
+UINT meteo_compress_set_config(uint32_t channel, const meteo_compress_config_t *config);
+UINT meteo_compress_get_config(uint32_t channel, meteo_compress_config_t *config);
+
+/**
+ * @brief Readings to rows for the stream (DB thread). A row is kept when
+ *        any of METEO_COMPRESS_ROW_CHANNELS needs it, with every channel:
+ *        the previous reading when a door closes, then this one for a
+ *        deadband, an OFF channel or the heartbeat.
+ * @param sample With ts_usec set
+ * @param rows Out: the rows to store, in time order
+ * @return Rows, 0..2
+ */
+uint32_t meteo_compress_apply(const meteo_archive_sample_t *sample, meteo_archive_sample_t rows[2]);
+
+void meteo_compress_get_stats(meteo_compress_stats_t *stats);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* METEO_COMPRESS_H */
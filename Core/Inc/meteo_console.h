@@ -0,0 +1,119 @@
+/* USER CODE BEGIN HeaderConsole */
+/**
+  ******************************************************************************
+  * @file           : meteo_console.h
+  * @brief          : Header for meteo_console.c file.
+  *                   Non-blocking console output (COM1 TX by DMA)
+  ******************************************************************************
+  * @attention
+  *
+  * Copyright (c) 2026 STMicroelectronics.
+  * All rights reserved.
+  *
+  ******************************************************************************
+  */
+/* USER CODE END HeaderConsole */
+
+#ifndef METEO_CONSOLE_H
+#define METEO_CONSOLE_H
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/* Includes ------------------------------------------------------------------*/
+#include "main.h"
+#include "tx_api.h"
+
+/* Exported constants --------------------------------------------------------*/
+
+/* Output ring: about 0.35 s of console at 115200 baud (power of 2) */
+#ifndef METEO_CONSOLE_RING_SIZE
+#define METEO_CONSOLE_RING_SIZE        4096U
+#endif
+
+/* Longest single DMA transfer, bytes */
+#define METEO_CONSOLE_DMA_MAX          512U
+
+/* A blocked writer re-checks the ring at least this often */
+#define METEO_CONSOLE_BLOCK_TICKS      (TX_TIMER_TICKS_PER_SECOND / 10)
+
+/* Exported types ------------------------------------------------------------*/
+
+/* What a thread does when the ring is full. Interrupt handlers, the
+   initialization and code running before the kernel always drop. */
+typedef enum
+{
+  METEO_CONSOLE_DROP = 0,   /* Count the write as dropped and return   */
+  METEO_CONSOLE_BLOCK       /* Wait for the DMA to make room            */
+} meteo_console_overflow_t;
+
+#ifndef METEO_CONSOLE_OVERFLOW_DEFAULT
+#define METEO_CONSOLE_OVERFLOW_DEFAULT METEO_CONSOLE_DROP
+#endif
+
+typedef struct
+{
+  ULONG bytes_written;      /* Accepted into the ring                     */
+  ULONG bytes_dropped;      /* Lost to a full ring                        */
+  ULONG writes_dropped;     /* Writes with at least one byte lost         */
+  ULONG blocked;            /* Writes that waited for room                */
+  ULONG dma_transfers;
+  ULONG dma_errors;
+  ULONG high_water;         /* Most bytes waiting in the ring             */
+} meteo_console_stats_t;
+
+/* Exported functions --------------------------------------------------------*/
+
+/**
+ * @brief Route console output through the ring and COM1 TX DMA.
+ *        Until then _write() sends byte by byte (blocking).
+ *        Call from tx_application_define, after BSP_COM_Init().
+ */
+void meteo_console_init(void);
+
+/**
+ * @brief Returns non-zero once meteo_console_init() has run
+ */
+int meteo_console_active(void);
+
+/**
+ * @brief Queue console output, any context (lock-free, multi-producer).
+ *        A thread follows the overflow policy, other contexts drop.
+ * @return Bytes queued (less than len when some were dropped)
+ */
+int meteo_console_write(const char *ptr, int len);
+
+/**
+ * @brief Queue console output from an interrupt handler: never waits
+ * @return Bytes queued, 0 when the ring is full
+ */
+int meteo_console_write_isr(const char *ptr, int len);
+
+/**
+ * @brief Bytes queued and not yet sent (e.g. wait for 0 before a reset)
+ */
+ULONG meteo_console_pending(void);
+
+/**
+ * @brief Select the overflow policy for threads
+ * @return Previous policy
+ */
+meteo_console_overflow_t meteo_console_set_overflow(meteo_console_overflow_t policy);
+
+/**
+ * @brief Copy the output counters
+ */
+void meteo_console_get_stats(meteo_console_stats_t *stats);
+
+/**
+ * @brief COM1 TX complete / error hooks, called from the HAL UART callbacks
+ */
+void meteo_console_tx_cplt(void);
+void meteo_console_tx_error(UART_HandleTypeDef *huart);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* METEO_CONSOLE_H */
@@ -30,6 +30,21 @@ typedef struct meteo_readings_row_s {
     double wind_direction;                // Wind direction in degrees
 } meteo_readings_row_t;
 
+/* Index of the table in the storage of open_meteo_database() */
+#define METEO_READINGS_INDEX        0
+
+/** @brief Ranged delete by timestamp: remove the rows with a ts before
+ *         before_usec. Looks at most max_rows rows per call, in id order
+ *         from *next_id, so a call stays short; 19.10.26
+ * @param next_id In: first id to look at (INT32_MIN from the start). Out:
+ *        where the next call goes on, INT32_MIN once the table was done.
+ * @param removed Rows removed
+ * @param bytes Row bytes removed
+ * @return DB_NOERROR, or the dbstatus_t of the index call that failed.
+ */
+dbstatus_t delete_meteo_readings_before(db_t database, db_timestamp_usec_t before_usec, size_t max_rows,
+                                        int32_t *next_id, size_t *removed, size_t *bytes);
+
 /* Database API functions */
 static inline dbstatus_t put_meteo_readings(db_t database, const meteo_readings_row_t *meteo_array, size_t count);
 static inline dbstatus_t insert_meteo_readings(db_t database, const meteo_readings_row_t *meteo);
@@ -10,6 +10,7 @@
 
 #include <ittia/db/db_index_storage.h>
 #include <ittia/db/db_stream.h>
+#include "meteo_archive.h"
 
 #ifdef __cplusplus
 extern "C" {
@@ -42,6 +43,12 @@ int run_meteo_idc_agent(const char * proto_name, void * proto_param);
 //3.2.26 - commented out - 8.2.26 reinserted declaration
 void ProcessMeteoFrameToStream(const char* frame);
 
+/**
+ * @brief Insert a decoded reading into the stream (DB thread) - 19.10.26
+ * @param sample From meteo_archive_store_parse_frame(), after meteo_filter_apply()
+ */
+void ProcessMeteoSampleToStream(const meteo_archive_sample_t* sample);
+
 /* Global stream environment shared by METEO threads */
 extern db_stream_environment_t meteo_stream_env;
 extern int32_t * meteo_instance_id;
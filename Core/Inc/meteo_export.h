@@ -0,0 +1,120 @@
+/* USER CODE BEGIN HeaderExport */
+/**
+  ******************************************************************************
+  * @file           : meteo_export.h
+  * @brief          : Header for meteo_export.c file.
+  *                   Streaming CSV / JSON / MCOL export of the archive
+  ******************************************************************************
+  * @attention
+  *
+  * Copyright (c) 2026 STMicroelectronics.
+  * All rights reserved.
+  *
+  ******************************************************************************
+  */
+/* USER CODE END HeaderExport */
+
+#ifndef METEO_EXPORT_H
+#define METEO_EXPORT_H
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/* Includes ------------------------------------------------------------------*/
+#include "tx_api.h"
+#include "meteo_archive_store.h"
+#include "meteo_series.h"
+#include <stdint.h>
+
+/* Exported constants --------------------------------------------------------*/
+
+/* Export server (app_netxduo.c), 0 = console export only */
+#ifndef METEO_EXPORT_ENABLED
+#define METEO_EXPORT_ENABLED        1
+#endif
+
+#define METEO_EXPORT_TCP_PORT       16537
+
+/* Output buffer: the sink gets at most this many bytes at a time. It holds
+   the MCOL chunk of a whole batch (912 bytes for 32 samples). */
+#define METEO_EXPORT_BUFFER_SIZE    1024U
+
+/* Samples read from the archive cursor at a time */
+#define METEO_EXPORT_BATCH          32U
+
+/* Longest request line of the export server */
+#define METEO_EXPORT_REQUEST_MAX    64U
+
+/* Exported types ------------------------------------------------------------*/
+
+typedef enum
+{
+  METEO_EXPORT_CSV = 0,     /* Header line, then ts (archive seconds) and the channels */
+  METEO_EXPORT_NANOEDGE,    /* Channels only, no header: NanoEdge AI Studio signal file */
+  METEO_EXPORT_JSON,        /* One object per line, ts in ISO-8601 */
+  METEO_EXPORT_COLUMNS      /* MCOL binary column chunks (meteo_columns.h), one per batch */
+} meteo_export_format_t;
+
+/* Receives each full output buffer, and the last one. It may block: that is
+   the flow control. A non-zero return stops the export. */
+typedef int (*meteo_export_sink_t)(void *context, const char *data, uint32_t length);
+
+typedef struct
+{
+  uint32_t rows;
+  uint32_t bytes;           /* Handed to the sink */
+  uint32_t chunks;          /* Sink calls */
+  ULONG ticks;              /* Run time, sink included */
+  meteo_archive_query_stats_t query;
+} meteo_export_stats_t;
+
+/* Exported functions --------------------------------------------------------*/
+
+/**
+ * @brief Create the mutex. Call from App_ThreadX_Init.
+ */
+void meteo_export_init(void);
+
+/**
+ * @brief Stream the archive samples matching a query to a sink, oldest
+ *        first. RAM use is fixed (cursor, one batch of samples, one output
+ *        buffer) whatever the range; one export runs at a time, others wait.
+ * @param stats Optional, filled in
+ * @return TX_SUCCESS, TX_NOT_AVAILABLE before meteo_archive_store_open(),
+ *         TX_NOT_DONE on a flash error, TX_WAIT_ABORTED when the sink stopped it
+ */
+UINT meteo_export_run(const meteo_archive_query_t *query, meteo_export_format_t format,
+                      meteo_export_sink_t sink, void *context, meteo_export_stats_t *stats);
+
+#if METEO_SERIES_ENABLED
+/**
+ * @brief meteo_export_run() over the aligned rows of the time series
+ *        (meteo_series_cursor_open) instead of the archive. stats->query
+ *        has the timestamps read in samples and the rows in matched.
+ * @return As meteo_export_run(), TX_NOT_AVAILABLE when the series are not open
+ */
+UINT meteo_export_series_run(const meteo_archive_query_t *query, meteo_export_format_t format,
+                             meteo_export_sink_t sink, void *context, meteo_export_stats_t *stats);
+#endif
+
+/**
+ * @brief meteo_export_run() to COM1. The console blocks instead of dropping
+ *        while it runs, so the UART paces the export.
+ */
+UINT meteo_export_console(const meteo_archive_query_t *query, meteo_export_format_t format,
+                          meteo_export_stats_t *stats);
+
+/**
+ * @brief Parse an export request: "csv|nanoedge|json|mcol [seconds | from to]".
+ *        seconds: the last seconds up to now; from to: archive seconds;
+ *        neither: the whole archive. An empty line is "csv".
+ * @return TX_SUCCESS, TX_SIZE_ERROR for a line that does not parse
+ */
+UINT meteo_export_parse(const char *line, meteo_archive_query_t *query, meteo_export_format_t *format);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* METEO_EXPORT_H */
@@ -0,0 +1,116 @@
+/* USER CODE BEGIN HeaderFilter */
+/**
+  ******************************************************************************
+  * @file           : meteo_filter.h
+  * @brief          : Header for meteo_filter.c file.
+  *                   Sliding median and spike filter of the readings
+  ******************************************************************************
+  * @attention
+  *
+  * Copyright (c) 2026 STMicroelectronics.
+  * All rights reserved.
+  *
+  ******************************************************************************
+  */
+/* USER CODE END HeaderFilter */
+
+#ifndef METEO_FILTER_H
+#define METEO_FILTER_H
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/* Includes ------------------------------------------------------------------*/
+#include "tx_api.h"
+#include "meteo_archive.h"
+#include <stdint.h>
+
+/* Exported constants --------------------------------------------------------*/
+
+/* Samples in the median window of each channel (odd: one middle value).
+   RAM is 16 bytes a sample and channel. */
+#ifndef METEO_FILTER_WINDOW
+#define METEO_FILTER_WINDOW         61U
+#endif
+
+/* Largest window of a meteo_median_t */
+#define METEO_MEDIAN_MAX            32767U
+
+/* Samples in the window before anything is flagged */
+#define METEO_FILTER_WARMUP         15U
+
+/* Flagged values are replaced by the median (0: only counted) */
+#ifndef METEO_FILTER_REPLACE
+#define METEO_FILTER_REPLACE        1
+#endif
+
+/* Exported types ------------------------------------------------------------*/
+
+/* Median of the last window values, two heaps around the median in one
+   array (max-heap below, min-heap above) and the ring of values in arrival
+   order. The value that leaves the window is overwritten by the new one
+   where it sits in the heaps and sifted: O(log window), no heap memory. */
+typedef struct
+{
+  float *data;              /* [window] values, ring */
+  int16_t *pos;             /* [window] heap index of each ring slot */
+  uint16_t *heap;           /* Ring slots by heap index, offset to index 0 */
+  uint32_t window;
+  uint32_t index;           /* Ring slot of the next value */
+  uint32_t count;           /* Values in the window */
+} meteo_median_t;
+
+typedef struct
+{
+  uint32_t samples;
+  uint32_t flagged;         /* Beyond k x MAD of the median */
+  uint32_t replaced;        /* ... and replaced by it */
+  float median;             /* Of the window before the last sample */
+  float mad;                /* Median absolute deviation */
+} meteo_filter_stats_t;
+
+/* Exported functions --------------------------------------------------------*/
+
+/**
+ * @brief Start an empty median
+ * @param data, pos, heap Arrays of window entries
+ * @param window 1..METEO_MEDIAN_MAX
+ */
+void meteo_median_init(meteo_median_t *median, float *data, int16_t *pos, uint16_t *heap, uint32_t window);
+
+/**
+ * @brief Add a value; once the window is full the oldest one leaves
+ */
+void meteo_median_add(meteo_median_t *median, float value);
+
+/**
+ * @brief Median of the values in the window (mean of the middle two for an
+ *        even count), 0 when empty
+ */
+float meteo_median_get(const meteo_median_t *median);
+
+/**
+ * @brief Create the mutex and empty the windows. Call from App_ThreadX_Init.
+ */
+void meteo_filter_init(void);
+
+/**
+ * @brief Check a reading against the median of the previous ones, channel
+ *        by channel (DB thread). A value further than k x 1.4826 x MAD
+ *        (a standard deviation for normal noise, with a floor per
+ *        channel) is flagged and, with METEO_FILTER_REPLACE, replaced by
+ *        the median. The window gets the raw value, so a lasting step is
+ *        accepted once it fills half the window.
+ * @param values meteo_archive_sample_t.value, changed in place
+ * @return Bit per flagged channel (meteo_archive_channel_t)
+ */
+uint32_t meteo_filter_apply(float *values);
+
+void meteo_filter_get_stats(meteo_filter_stats_t stats[METEO_ARCHIVE_CHANNELS]);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* METEO_FILTER_H */
@@ -0,0 +1,131 @@
+/* USER CODE BEGIN HeaderFormat */
+/**
+  ******************************************************************************
+  * @file           : meteo_format.h
+  * @brief          : Header for meteo_format.c file.
+  *                   Fixed-point number, time and CSV/JSON row formatting
+  ******************************************************************************
+  * @attention
+  *
+  * Copyright (c) 2026 STMicroelectronics.
+  * All rights reserved.
+  *
+  ******************************************************************************
+  */
+/* USER CODE END HeaderFormat */
+
+#ifndef METEO_FORMAT_H
+#define METEO_FORMAT_H
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/* Includes ------------------------------------------------------------------*/
+#include <stdint.h>
+
+/* Exported constants --------------------------------------------------------*/
+
+/* Most decimals of meteo_format_fixed() and meteo_format_float() */
+#define METEO_FORMAT_DECIMALS_MAX   6U
+
+/* Longest meteo_format_iso8601() text, "+294247-01-10T04:00:54.775807Z" */
+#define METEO_FORMAT_ISO8601_MAX    30U
+
+/* Exported types ------------------------------------------------------------*/
+
+typedef enum
+{
+  METEO_FORMAT_CSV = 0,     /* Values separated by ',', row ends with '\n' */
+  METEO_FORMAT_JSON         /* {"name":value,...} per row, one per line     */
+} meteo_format_style_t;
+
+/* Rows written one after the other into a caller buffer. A field that does
+   not fit marks the row; meteo_format_row_end() then takes it back whole. */
+typedef struct
+{
+  char *buffer;
+  uint32_t size;
+  uint32_t length;          /* Bytes of complete rows */
+  uint32_t end;             /* End of the row being written */
+  uint32_t fields;          /* In the row being written */
+  meteo_format_style_t style;
+  uint8_t overflow;
+} meteo_format_writer_t;
+
+/* Exported functions --------------------------------------------------------*/
+
+/* The meteo_format_xxx() number and time functions write at out, with no
+   NUL, and return the bytes written: 0 when the text needs more than size. */
+
+uint32_t meteo_format_uint(char *out, uint32_t size, uint32_t value);
+uint32_t meteo_format_int(char *out, uint32_t size, int32_t value);
+
+/**
+ * @brief Integer with an implied decimal point: (2003, 2) is "20.03",
+ *        (-5, 1) is "-0.5"
+ * @param decimals 0..METEO_FORMAT_DECIMALS_MAX
+ */
+uint32_t meteo_format_fixed(char *out, uint32_t size, int32_t value, uint32_t decimals);
+
+/**
+ * @brief Float with a fixed number of decimals, rounded half away from zero
+ *        (printf rounds the binary value, so the last digit of an exact
+ *        half may differ). "nan", "inf" or "-inf" when it is not a number
+ *        or its whole part does not fit 31 bits.
+ */
+uint32_t meteo_format_float(char *out, uint32_t size, float value, uint32_t decimals);
+
+/**
+ * @brief Microseconds as seconds with decimals (truncated): (1500000, 3)
+ *        is "1.500"
+ */
+uint32_t meteo_format_seconds(char *out, uint32_t size, int64_t usec, uint32_t decimals);
+
+/**
+ * @brief ISO-8601 UTC time of microseconds since 1970-01-01, e.g.
+ *        "2026-10-19T08:30:00.250Z". The readings are stamped with the
+ *        uptime until the board has a wall clock, so they come out in 1970.
+ * @param decimals Of the seconds: 0, 3 or 6
+ */
+uint32_t meteo_format_iso8601(char *out, uint32_t size, int64_t usec, uint32_t decimals);
+
+/**
+ * @brief Start writing rows at the start of buffer
+ */
+void meteo_format_writer_init(meteo_format_writer_t *writer, char *buffer, uint32_t size,
+                              meteo_format_style_t style);
+
+/**
+ * @brief Fields of a row, in column order. name is the JSON key (a
+ *        constant, not escaped), unused in CSV.
+ */
+void meteo_format_field_uint(meteo_format_writer_t *writer, const char *name, uint32_t value);
+void meteo_format_field_fixed(meteo_format_writer_t *writer, const char *name, int32_t value, uint32_t decimals);
+void meteo_format_field_float(meteo_format_writer_t *writer, const char *name, float value, uint32_t decimals);
+void meteo_format_field_seconds(meteo_format_writer_t *writer, const char *name, int64_t usec, uint32_t decimals);
+void meteo_format_field_iso8601(meteo_format_writer_t *writer, const char *name, int64_t usec, uint32_t decimals);
+
+/**
+ * @brief End the row
+ * @return Bytes of the row, 0 when it did not fit (it is then removed and
+ *         the buffer holds the complete rows before it)
+ */
+uint32_t meteo_format_row_end(meteo_format_writer_t *writer);
+
+/**
+ * @brief A whole row given as text, with its '\n' (e.g. a CSV header)
+ * @return As meteo_format_row_end()
+ */
+uint32_t meteo_format_row_text(meteo_format_writer_t *writer, const char *text);
+
+/**
+ * @brief Remove the complete rows, e.g. once they have been sent
+ */
+void meteo_format_writer_reset(meteo_format_writer_t *writer);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* METEO_FORMAT_H */
@@ -0,0 +1,66 @@
+/* USER CODE BEGIN HeaderFramer */
+/**
+  ******************************************************************************
+  * @file           : meteo_framer.h
+  * @brief          : Header for meteo_framer.c file.
+  *                   METEO frame delimiting (UUU$ ... *QQQ), one byte at a time
+  ******************************************************************************
+  * @attention
+  *
+  * Copyright (c) 2026 STMicroelectronics.
+  * All rights reserved.
+  *
+  ******************************************************************************
+  */
+/* USER CODE END HeaderFramer */
+
+#ifndef METEO_FRAMER_H
+#define METEO_FRAMER_H
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/* Includes ------------------------------------------------------------------*/
+#include "main.h"
+#include <stdint.h>
+
+/* Exported types ------------------------------------------------------------*/
+
+/* Result of one byte */
+typedef enum
+{
+  METEO_FRAMER_MORE = 0,    /* Byte consumed, no complete frame yet          */
+  METEO_FRAMER_FRAME,       /* buffer holds a complete, NUL terminated frame */
+  METEO_FRAMER_OVERFLOW     /* No *QQQ within RX_BUFFER_SIZE: frame dropped  */
+} meteo_framer_result_t;
+
+/* One framer per byte source: the USART3 ISR and the simulator each own one */
+typedef struct
+{
+  char buffer[RX_BUFFER_SIZE];
+  uint32_t window;          /* Last 4 bytes received */
+  uint8_t index;
+  uint8_t in_frame;
+} meteo_framer_t;
+
+/* Exported functions --------------------------------------------------------*/
+
+/**
+ * @brief Start hunting for UUU$ again. A UUU$ inside a frame also restarts
+ *        it: the frame before was cut short.
+ */
+void meteo_framer_reset(meteo_framer_t *framer);
+
+/**
+ * @brief Feed one received byte
+ * @return METEO_FRAMER_FRAME when framer->buffer holds a frame; it stays
+ *         valid until the next call
+ */
+meteo_framer_result_t meteo_framer_byte(meteo_framer_t *framer, uint8_t byte);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* METEO_FRAMER_H */
@@ -0,0 +1,147 @@
+/* USER CODE BEGIN HeaderJournal */
+/**
+  ******************************************************************************
+  * @file           : meteo_journal.h
+  * @brief          : Header for meteo_journal.c file.
+  *                   Raw frame journal on OSPI flash (store and forward)
+  ******************************************************************************
+  * @attention
+  *
+  * Copyright (c) 2026 STMicroelectronics.
+  * All rights reserved.
+  *
+  ******************************************************************************
+  */
+/* USER CODE END HeaderJournal */
+
+#ifndef METEO_JOURNAL_H
+#define METEO_JOURNAL_H
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/* Includes ------------------------------------------------------------------*/
+#include "tx_api.h"
+#include "meteo_ospi.h"
+#include <stdint.h>
+
+/* Exported constants --------------------------------------------------------*/
+
+/* Journal uplink server (app_netxduo.c), 0 = journal only */
+#ifndef METEO_JOURNAL_ENABLED
+#define METEO_JOURNAL_ENABLED       1
+#endif
+
+/* Top of the OSPI flash (meteo_ospi.h), 64 x 64 KB = 4 MB.
+   The last METEO_JOURNAL_ACK_BLOCKS hold the acknowledged position. */
+#define METEO_JOURNAL_BLOCKS        METEO_OSPI_JOURNAL_BLOCKS
+#define METEO_JOURNAL_ACK_BLOCKS    2U
+
+/* The acknowledged position is written after this many records or ticks,
+   so a reset resends at most that much (at-least-once delivery) */
+#define METEO_JOURNAL_ACK_EVERY     64U
+#define METEO_JOURNAL_ACK_TICKS     (10U * TX_TIMER_TICKS_PER_SECOND)
+
+#define METEO_JOURNAL_TCP_PORT      16536
+
+/* Exported types ------------------------------------------------------------*/
+
+/* One frame on flash, 32 bytes little endian, sent as is by the uplink.
+   Values are the raw frame fields; crc is CRC-32 (IEEE) of the 28 bytes
+   before it. Slot n of the journal always holds seq n (mod capacity). */
+typedef struct
+{
+  uint32_t seq;
+  uint32_t time_ms;         /* HAL_GetTick() when stored */
+  uint32_t temp;            /* ttttt */
+  uint32_t pressure;        /* bbbbb */
+  uint32_t wind_speed;      /* sssss */
+  uint16_t wind_dir;        /* dddd */
+  uint16_t voltage;         /* vvv */
+  uint16_t boot;            /* Start-up count: time_ms restarts with it */
+  uint16_t reserved;        /* 0 */
+  uint32_t crc;
+} meteo_journal_record_t;
+
+/* Read position of one consumer */
+typedef struct
+{
+  uint32_t next;            /* seq of the next record to read */
+} meteo_journal_cursor_t;
+
+typedef struct
+{
+  uint32_t head;            /* seq of the next record to write */
+  uint32_t oldest;          /* Oldest seq still on flash */
+  uint32_t acked;           /* Delivered up to (not including) this seq */
+  uint32_t capacity;        /* Records */
+  uint32_t lost;            /* Not acknowledged before they were erased */
+  uint32_t bad;             /* Skipped by readers: CRC error or torn */
+  uint32_t erases;
+  uint32_t write_errors;
+  uint32_t open_reads;      /* Flash reads to find the tail at start-up */
+  uint16_t boot;
+  uint8_t  opened;
+} meteo_journal_stats_t;
+
+/* Exported functions --------------------------------------------------------*/
+
+/**
+ * @brief Create the events. Call from App_ThreadX_Init.
+ */
+void meteo_journal_init(void);
+
+/**
+ * @brief Find the last record by binary search and the acknowledged
+ *        position. Call from a thread once the OSPI is initialized
+ *        (after the ITTIA storage is open).
+ * @return TX_SUCCESS, TX_NOT_DONE on a flash error
+ */
+UINT meteo_journal_open(void);
+
+/**
+ * @brief Append one METEO frame (DB thread). Erases the next block when
+ *        needed: records not yet acknowledged there are counted as lost.
+ * @return TX_SUCCESS, TX_NOT_AVAILABLE before meteo_journal_open(),
+ *         TX_SIZE_ERROR for a frame that does not parse, TX_NOT_DONE on a
+ *         flash error
+ */
+UINT meteo_journal_append_frame(const char *frame);
+
+/**
+ * @brief Start a cursor at the acknowledged position
+ */
+void meteo_journal_cursor_init(meteo_journal_cursor_t *cursor);
+
+/**
+ * @brief Read up to max valid records from the cursor and advance it.
+ *        Erased or damaged slots are skipped.
+ * @param count Records stored in records
+ * @return TX_SUCCESS (count may be 0 at the head), TX_NOT_DONE on a flash error
+ */
+UINT meteo_journal_read(meteo_journal_cursor_t *cursor, meteo_journal_record_t *records,
+                        UINT max, UINT *count);
+
+/**
+ * @brief Wait until there are records after the cursor
+ * @return TX_SUCCESS, or TX_NO_EVENTS after wait_option ticks
+ */
+UINT meteo_journal_wait(const meteo_journal_cursor_t *cursor, ULONG wait_option);
+
+/**
+ * @brief Records before next_seq were delivered
+ * @return TX_SUCCESS, TX_SIZE_ERROR when next_seq is past the head
+ */
+UINT meteo_journal_ack(uint32_t next_seq);
+
+/**
+ * @brief Copy the counters
+ */
+void meteo_journal_get_stats(meteo_journal_stats_t *stats);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* METEO_JOURNAL_H */
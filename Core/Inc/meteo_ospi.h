@@ -0,0 +1,70 @@
+/* USER CODE BEGIN HeaderOspi */
+/**
+  ******************************************************************************
+  * @file           : meteo_ospi.h
+  * @brief          : Header for meteo_ospi.c file.
+  *                   OSPI flash layout and access shared by the METEO modules
+  ******************************************************************************
+  * @attention
+  *
+  * Copyright (c) 2026 STMicroelectronics.
+  * All rights reserved.
+  *
+  ******************************************************************************
+  */
+/* USER CODE END HeaderOspi */
+
+#ifndef METEO_OSPI_H
+#define METEO_OSPI_H
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/* Includes ------------------------------------------------------------------*/
+#include "tx_api.h"
+
+/* Exported constants --------------------------------------------------------*/
+
+/* Regions at the top of the OSPI flash, in 64 KB blocks, from the end:
+   frame journal, then archive segments. ITTIA DB gets the blocks below. */
+#define METEO_OSPI_JOURNAL_BLOCKS   64U
+#define METEO_OSPI_ARCHIVE_BLOCKS   128U
+#define METEO_OSPI_RESERVED_BLOCKS  (METEO_OSPI_JOURNAL_BLOCKS + METEO_OSPI_ARCHIVE_BLOCKS)
+
+/* Exported functions --------------------------------------------------------*/
+
+/**
+ * @brief Create the lock. Call from App_ThreadX_Init, before anything uses
+ *        the OSPI.
+ */
+void meteo_ospi_init(void);
+
+/**
+ * @brief Exclusive use of the OSPI: the METEO modules and the ITTIA media
+ *        driver share the XSPI DMA and its semaphores
+ */
+void meteo_ospi_lock(void);
+void meteo_ospi_unlock(void);
+
+/**
+ * @brief Flash geometry (64 KB blocks)
+ * @return TX_SUCCESS, TX_NOT_DONE when the driver has none
+ */
+UINT meteo_ospi_get_info(ULONG *block_size, ULONG *total_blocks);
+
+/**
+ * @brief Flash access with the lock held, as the ITTIA media driver does it:
+ *        wait until not busy, transfer by DMA, wait for the completion.
+ *        Sizes are multiples of 4 bytes.
+ * @return TX_SUCCESS, TX_NOT_DONE on a timeout or driver error
+ */
+UINT meteo_ospi_read(ULONG address, void *buffer, ULONG bytes);
+UINT meteo_ospi_write(ULONG address, const void *buffer, ULONG bytes);
+UINT meteo_ospi_erase_block(ULONG block);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* METEO_OSPI_H */
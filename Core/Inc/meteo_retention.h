@@ -0,0 +1,122 @@
+/* USER CODE BEGIN HeaderRetention */
+/**
+  ******************************************************************************
+  * @file           : meteo_retention.h
+  * @brief          : Header for meteo_retention.c file.
+  *                   Age and byte budgets of the stored readings
+  ******************************************************************************
+  * @attention
+  *
+  * Copyright (c) 2026 STMicroelectronics.
+  * All rights reserved.
+  *
+  ******************************************************************************
+  */
+/* USER CODE END HeaderRetention */
+
+#ifndef METEO_RETENTION_H
+#define METEO_RETENTION_H
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/* Includes ------------------------------------------------------------------*/
+#include "tx_api.h"
+#include "meteo_archive_store.h"
+#include <stdint.h>
+
+/* Exported constants --------------------------------------------------------*/
+
+/* Readings kept by default: about three months, 0 = no age limit */
+#define METEO_RETENTION_MAX_AGE_S       (92UL * 24UL * 3600UL)
+
+/* Archive blocks kept erased ahead of the writer: the default byte budget
+   is the rest of the ring (64 KB blocks) */
+#define METEO_RETENTION_SPARE_BLOCKS    4U
+#define METEO_RETENTION_ARCHIVE_BYTES   ((METEO_ARCHIVE_STORE_BLOCKS - METEO_RETENTION_SPARE_BLOCKS) * 65536UL)
+
+/* Series data removed per step, from the oldest point: the series keep up
+   to this much more than the age */
+#define METEO_RETENTION_SERIES_STEP_S   3600U
+
+/* meteo_readings4 rows looked at per step (delete_meteo_readings_before) */
+#define METEO_RETENTION_TABLE_ROWS      64U
+
+/* Name of the storage of the table, as given to open_meteo_database() */
+#define METEO_RETENTION_TABLE_NAME_SIZE 32U
+
+/* One step per period, when the DB thread has no frame waiting */
+#define METEO_RETENTION_PERIOD_TICKS    TX_TIMER_TICKS_PER_SECOND
+
+/* Below the DB and IDC threads: it runs in their idle time */
+#define METEO_RETENTION_PRIORITY        20U
+
+/* Exported types ------------------------------------------------------------*/
+
+typedef struct
+{
+  uint32_t max_age_s;             /* Older readings go, 0 = no age limit */
+  ULONG archive_bytes;            /* Archive blocks in use at most */
+  int64_t series_bytes;           /* Series data kept (METEO_SERIES_ENABLED) */
+} meteo_retention_config_t;
+
+typedef struct
+{
+  uint32_t periods;               /* Thread wake-ups */
+  uint32_t busy;                  /* ... skipped: frames waiting for the DB thread */
+  uint32_t steps;                 /* Steps that freed something */
+  uint32_t archive_blocks;        /* Archive blocks erased */
+  uint32_t series_removed;        /* Series timestamps removed */
+  uint32_t table_removed;         /* meteo_readings4 rows removed */
+  uint32_t errors;                /* Steps that failed */
+  int64_t bytes;                  /* Freed, archive and series */
+  uint32_t last_us;               /* Time of the last step that freed something */
+  uint32_t max_us;                /* ... the longest */
+  uint64_t total_us;              /* ... all of them */
+} meteo_retention_stats_t;
+
+/* Exported functions --------------------------------------------------------*/
+
+/**
+ * @brief Create the mutex and set the default budgets. Call from
+ *        App_ThreadX_Init.
+ */
+void meteo_retention_init(void);
+
+UINT meteo_retention_set_config(const meteo_retention_config_t *config);
+void meteo_retention_get_config(meteo_retention_config_t *config);
+
+/**
+ * @brief Trim the meteo_readings4 table of this storage by age too. The
+ *        retention thread connects to it on its next step.
+ * @param database_name As given to open_meteo_database(), NULL for none
+ *        (the default: the board keeps no table)
+ * @return TX_SUCCESS, TX_SIZE_ERROR for a name too long
+ */
+UINT meteo_retention_set_table(const char *database_name);
+
+/**
+ * @brief One bounded step: erase the oldest archive block past a budget,
+ *        else remove up to METEO_RETENTION_SERIES_STEP_S of series data
+ *        past the age, else look at up to METEO_RETENTION_TABLE_ROWS rows
+ *        of the table and remove those past the age
+ * @param bytes Optional, bytes freed (0 when nothing was due)
+ * @return TX_SUCCESS, TX_NOT_AVAILABLE before the archive is open,
+ *         TX_NOT_DONE on a flash or database error
+ */
+UINT meteo_retention_step(int64_t *bytes);
+
+/**
+ * @brief Retention thread: a step every METEO_RETENTION_PERIOD_TICKS while
+ *        meteo_frame_queue is empty. Created at METEO_RETENTION_PRIORITY.
+ */
+void meteo_retention_thread_entry(ULONG thread_input);
+
+void meteo_retention_get_stats(meteo_retention_stats_t *stats);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* METEO_RETENTION_H */
@@ -0,0 +1,167 @@
+/* USER CODE BEGIN HeaderSeries */
+/**
+  ******************************************************************************
+  * @file           : meteo_series.h
+  * @brief          : Header for meteo_series.c file.
+  *                   A float32 time series per channel (ITTIA DB IoT storage)
+  ******************************************************************************
+  * @attention
+  *
+  * Copyright (c) 2026 STMicroelectronics.
+  * All rights reserved.
+  *
+  ******************************************************************************
+  */
+/* USER CODE END HeaderSeries */
+
+#ifndef METEO_SERIES_H
+#define METEO_SERIES_H
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/* Includes ------------------------------------------------------------------*/
+#include "tx_api.h"
+#include "meteo_archive_store.h"
+#include <ittia/db/db_iot_storage.h>
+#include <stdint.h>
+
+/* Exported constants --------------------------------------------------------*/
+
+/* Series storage next to the stream (DB thread), 0 = stream only. The IoT
+   storage is a file: the ITTIA OS layer needs a file system (FileX) on
+   the board. */
+#ifndef METEO_SERIES_ENABLED
+#define METEO_SERIES_ENABLED        0
+#endif
+
+#define METEO_SERIES_FILE           "meteo_series.ittiadb"
+
+/* Page cache of the storage */
+#define METEO_SERIES_CACHE_SIZE     (32U * 1024U)
+
+/* Series data kept: once it passes MAX the oldest pages go, down to RETAIN.
+   MAX must be at least a page more than RETAIN. */
+#define METEO_SERIES_RETAIN_BYTES   (4L * 1024L * 1024L)
+#define METEO_SERIES_SLACK_BYTES    (16L * DB_DEF_PAGE_SIZE)
+#define METEO_SERIES_MAX_BYTES      (METEO_SERIES_RETAIN_BYTES + METEO_SERIES_SLACK_BYTES)
+
+/* Each series gets only the points its channel's deadband / swinging door
+   (meteo_compress.h) keeps, 0 = every reading */
+#ifndef METEO_SERIES_COMPRESS
+#define METEO_SERIES_COMPRESS       1
+#endif
+
+/* Samples between db_file_info() calls for the statistics */
+#define METEO_SERIES_INFO_EVERY     60U
+
+/* Exported types ------------------------------------------------------------*/
+
+typedef struct
+{
+  uint32_t samples;
+  uint32_t points;                /* Put, all series */
+  uint32_t put_errors;
+  uint32_t removed;               /* Timestamps, by meteo_series_trim() */
+  int64_t data_file_bytes;        /* Last db_file_info() */
+  int64_t series_bytes;           /* ... of them series data */
+  int32_t open_status;            /* dbstatus_t of meteo_series_open() */
+  uint8_t opened;
+} meteo_series_stats_t;
+
+typedef struct
+{
+  uint32_t timestamps;            /* Fetched */
+  uint32_t values;
+  uint32_t rows;                  /* Passed on */
+} meteo_series_query_stats_t;
+
+/* Aligned query of all the series: one row per timestamp where any channel
+   has a point, the others at their last point. Holds its own connection,
+   so it is read from one thread. */
+typedef struct
+{
+  db_t db;
+  db_time_series_query_t query;
+  meteo_archive_query_t range;
+  meteo_series_query_stats_t stats;
+  float value[METEO_ARCHIVE_CHANNELS];
+  int8_t channel[METEO_ARCHIVE_CHANNELS + 1U];  /* By fieldno, -1 unknown */
+  uint32_t seen;                  /* Channels with a value so far */
+  uint8_t done;
+} meteo_series_cursor_t;
+
+/* Exported functions --------------------------------------------------------*/
+
+/**
+ * @brief Create the mutex. Call from App_ThreadX_Init.
+ */
+void meteo_series_init(void);
+
+/**
+ * @brief Open the storage, connect and open a series per channel, set the
+ *        retention. Call from the DB thread, which then owns the connection.
+ * @return TX_SUCCESS, TX_NOT_DONE when the storage does not open (nothing
+ *         is stored then)
+ */
+UINT meteo_series_open(void);
+
+/**
+ * @brief Put a reading into the series (DB thread)
+ * @param sample With ts_usec set, after meteo_filter_apply()
+ * @return Points put, all channels
+ */
+uint32_t meteo_series_add(const meteo_archive_sample_t *sample);
+
+/**
+ * @brief Start an aligned query: the rows from query->from_usec to
+ *        query->to_usec, both included, that pass its value predicate.
+ *        Starts a heartbeat earlier, so each channel has its value at
+ *        from_usec; rows before every channel has one are skipped.
+ * @return TX_SUCCESS, TX_NOT_AVAILABLE before meteo_series_open(),
+ *         TX_NOT_DONE on a database error (the cursor is then at its end)
+ */
+UINT meteo_series_cursor_open(meteo_series_cursor_t *cursor, const meteo_archive_query_t *query);
+
+/**
+ * @brief Read up to max rows from the cursor and advance it
+ * @param count Rows stored in samples, less than max only at the end
+ * @return TX_SUCCESS (count is 0 once the query is done), TX_NOT_DONE on a
+ *         database error (the cursor is then at its end)
+ */
+UINT meteo_series_read(meteo_series_cursor_t *cursor, meteo_archive_sample_t *samples, UINT max, UINT *count);
+
+/**
+ * @brief Close the query and its connection. Safe on a closed cursor.
+ */
+void meteo_series_cursor_close(meteo_series_cursor_t *cursor);
+
+/**
+ * @brief Once the oldest point is step_usec before before_usec, remove
+ *        step_usec of points from it: a call stays short, and the series
+ *        keep up to step_usec more than asked. Holds its own connection:
+ *        call from one thread (meteo_retention.c).
+ * @param removed Timestamps removed
+ * @param bytes Series data bytes freed (db_file_info before and after)
+ * @return TX_SUCCESS, TX_NOT_AVAILABLE before meteo_series_open(),
+ *         TX_NOT_DONE on a database error
+ */
+UINT meteo_series_trim(int64_t before_usec, int64_t step_usec, uint32_t *removed, int64_t *bytes);
+
+/**
+ * @brief Series data kept from now on: the oldest pages go past
+ *        retain_bytes + METEO_SERIES_SLACK_BYTES. Same thread as
+ *        meteo_series_trim().
+ * @return TX_SUCCESS, TX_NOT_AVAILABLE before meteo_series_open(),
+ *         TX_SIZE_ERROR for less than a page, TX_NOT_DONE on a database error
+ */
+UINT meteo_series_set_retention(int64_t retain_bytes);
+
+void meteo_series_get_stats(meteo_series_stats_t *stats);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* METEO_SERIES_H */
@@ -26,13 +26,102 @@ extern "C" {
 #include <stddef.h>
 #include <stdint.h>
 
+/* Exported constants --------------------------------------------------------*/
+
+/* Load generator limits and console defaults (19.10.26) */
+#define METEO_SIM_MAX_STATIONS     8U
+#define METEO_SIM_RATE_MAX_HZ      10000U
+#define METEO_SIM_DEFAULT_SEED     0x4D45544FUL     /* "METO" */
+#define METEO_SIM_LOAD_RATE_HZ     1000U
+#define METEO_SIM_LOAD_STATIONS    4U
+
+/* Fault injection: one frame in METEO_SIM_FAULT_EVERY is damaged, bursts
+   release METEO_SIM_BURST_FRAMES frames at once, gaps are 200..455 bytes */
+#define METEO_SIM_FAULT_EVERY      4U
+#define METEO_SIM_BURST_FRAMES     32U
+#define METEO_SIM_GAP_MIN          200U
+#define METEO_SIM_STRESS_RATE_HZ   200U
+#define METEO_SIM_STRESS_FRAMES    1000U
+
+/* Exported types ------------------------------------------------------------*/
+
+/* One virtual METEO station: its own weather and random sequence, so a
+   given seed always produces the same frames */
+typedef struct
+{
+  uint32_t rng;             /* xorshift32 state, never 0 */
+  int32_t temp;             /* 0.01 degC */
+  int32_t pressure;         /* 0.1 hPa */
+  uint16_t wind_dir;        /* 0.1 deg */
+  uint16_t wind_speed;
+  uint16_t voltage;         /* mV */
+  uint32_t frames;
+} meteo_sim_station_t;
+
+/* Where load generator frames enter the ingest path */
+typedef enum
+{
+  METEO_SIM_INJECT_UART = 0,  /* Bytes through a framer, then Meteo_Frame_Submit() */
+  METEO_SIM_INJECT_DB         /* Frames straight into meteo_frame_queue (DB thread) */
+} meteo_sim_inject_t;
+
+/* What the load generator does to the USART3 byte stream */
+typedef enum
+{
+  METEO_SIM_FAULT_NONE = 0,
+  METEO_SIM_FAULT_BITFLIP,    /* One bit of one byte inverted           */
+  METEO_SIM_FAULT_DROP,       /* One byte lost                          */
+  METEO_SIM_FAULT_TRUNCATE,   /* Frame cut short, the next one follows  */
+  METEO_SIM_FAULT_DUP_HEADER, /* UUU$ sent twice                        */
+  METEO_SIM_FAULT_BURST,      /* Back to back, no line end, in bursts   */
+  METEO_SIM_FAULT_IDLE_GAP,   /* Line noise (0xFF) before the frame     */
+  METEO_SIM_FAULT_COUNT
+} meteo_sim_fault_t;
+
+typedef struct
+{
+  uint32_t generated;
+  uint32_t accepted;        /* Taken by the first queue */
+  uint32_t dropped;         /* Queue full */
+  uint32_t framer_errors;   /* UART mode: framer overflow (should stay 0) */
+  uint32_t db_dropped;      /* UART mode: meteo thread found the DB queue full */
+  uint32_t rejected;        /* UART mode: checksum failed in the meteo thread */
+  uint32_t db_rejected;     /* Dropped by the DB thread: fields do not decode */
+  uint32_t damaged;         /* Frames whose own bytes were damaged */
+  uint32_t lost_intact;     /* Frames sent intact that the framer did not return */
+  uint32_t damaged_accepted;/* Queued frames that were not sent that way, checksum still good */
+  uint32_t checks_failed;   /* UART mode: counts that do not add up (stress run: all profiles) */
+  uint32_t resyncs;         /* Faults followed by a valid frame */
+  uint32_t resync_bytes;    /* Sum over resyncs: bytes from fault start to the end of the next valid frame */
+  uint32_t resync_bytes_max;
+  ULONG ticks;              /* Run time */
+} meteo_sim_load_report_t;
+
+typedef struct
+{
+  uint32_t rate_hz;         /* Frames per second over all stations, 1..METEO_SIM_RATE_MAX_HZ */
+  uint8_t stations;         /* 1..METEO_SIM_MAX_STATIONS, frames taken round-robin */
+  uint32_t seed;
+  uint32_t frames;          /* Stop after this many, 0 = until stopped */
+  meteo_sim_inject_t inject;
+  meteo_sim_fault_t fault;  /* UART mode only */
+  /* Called by the simulator thread when the run ends (NULL = report only) */
+  void (*done)(const meteo_sim_load_report_t *report);
+} meteo_sim_load_config_t;
+
 /* Exported functions --------------------------------------------------------*/
 
 /**
- * @brief Initialize METEO simulator thread
+ * @brief Initialize METEO simulator (event flags, frame timer, console RX)
  */
 void meteo_simulator_init(void);
 
+/**
+ * @brief Simulator/console thread body (never returns)
+ * @param thread_input Unused
+ */
+void meteo_simulator_thread_entry(ULONG thread_input);
+
 /**
  * @brief Toggle simulator on/off
  */
@@ -51,11 +140,56 @@ UINT meteo_simulator_is_enabled(void);
  */
 void meteo_simulator_generate_frame(char *buffer, size_t buf_size);
 
+/**
+ * @brief Start a station from its seed (same seed, same frames)
+ * @note  meteo_sim_station.c: no ThreadX or HAL, linked by host tools too
+ */
+void meteo_sim_station_init(meteo_sim_station_t *station, uint32_t seed);
+
+/**
+ * @brief Next frame of a station, with correct checksum
+ * @param buffer Output buffer (minimum 64 bytes)
+ * @return Frame length
+ */
+int meteo_sim_station_frame(meteo_sim_station_t *station, char *buffer, size_t buf_size);
+
+/**
+ * @brief Start a load generator run. Call from the simulator thread or
+ *        during initialization (after meteo_simulator_init()).
+ * @return TX_SUCCESS, TX_NOT_DONE if a run is active, TX_SIZE_ERROR for a
+ *         rate or station count out of range
+ */
+UINT meteo_simulator_load_start(const meteo_sim_load_config_t *config);
+
+/**
+ * @brief Stop the load generator run and print its report
+ */
+void meteo_simulator_load_stop(void);
+
+/**
+ * @brief Run every fault profile in turn (UART bytes, same seed), then print
+ *        one line per profile. Same calling rules as meteo_simulator_load_start().
+ * @param done Called once after the last profile (NULL = table only)
+ */
+UINT meteo_simulator_stress_start(uint32_t rate_hz, uint32_t frames,
+                                  void (*done)(const meteo_sim_load_report_t *report));
+
+/**
+ * @brief Name of a fault profile ("none", "bitflip" ...)
+ */
+const char *meteo_simulator_fault_name(meteo_sim_fault_t fault);
+
 /**
  * @brief Check console for simulator commands (non-blocking)
  */
 void meteo_simulator_check_console(void);
 
+/**
+ * @brief COM1 RX complete / error hooks, called from the HAL UART callbacks
+ */
+void meteo_simulator_console_rx_cplt(void);
+void meteo_simulator_console_rx_error(void);
+
 #ifdef __cplusplus
 }
 #endif
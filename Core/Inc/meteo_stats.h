@@ -0,0 +1,120 @@
+/* USER CODE BEGIN HeaderStats */
+/**
+  ******************************************************************************
+  * @file           : meteo_stats.h
+  * @brief          : Header for meteo_stats.cpp file.
+  *                   Running statistics of the readings, per channel
+  ******************************************************************************
+  * @attention
+  *
+  * Copyright (c) 2026 STMicroelectronics.
+  * All rights reserved.
+  *
+  ******************************************************************************
+  */
+/* USER CODE END HeaderStats */
+
+#ifndef METEO_STATS_H
+#define METEO_STATS_H
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/* Includes ------------------------------------------------------------------*/
+#include "tx_api.h"
+#include "meteo_archive.h"
+#include <stdint.h>
+
+/* Exported constants --------------------------------------------------------*/
+
+/* Half-life of the EWMA, and the min/max horizon, in seconds */
+#define METEO_STATS_HALF_LIFE_S     600U
+#define METEO_STATS_HORIZON_S       3600U
+
+/* Reading period the EWMA alpha is worked out for (1 frame/s) */
+#define METEO_STATS_PERIOD_S        1U
+
+/* Buckets of the min/max horizon: one a minute */
+#define METEO_STATS_BUCKETS         60U
+
+/* Wind speed quantiles (P50, P90, P99) of each hour and day of uptime */
+#define METEO_STATS_QUANTILES       3U
+#define METEO_STATS_HOUR_S          3600U
+#define METEO_STATS_DAY_S           86400U
+
+/* t-digest compression: at most this many + 2 centroids, 2.2 KB a digest */
+#define METEO_STATS_DIGEST_SIZE     100U
+
+/* A [STATS] line every this many readings (DB thread), 0 = none */
+#ifndef METEO_STATS_PUBLISH_SAMPLES
+#define METEO_STATS_PUBLISH_SAMPLES 300U
+#endif
+
+/* Exported types ------------------------------------------------------------*/
+
+/* Wind direction: mean and stddev are circular (degrees), ewma is the
+   direction of the EWMA of the unit vectors */
+typedef struct
+{
+  float mean;               /* Since the last reset */
+  float stddev;
+  float ewma;               /* Recent, METEO_STATS_HALF_LIFE_S */
+  float min;                /* Last METEO_STATS_HORIZON_S */
+  float max;
+} meteo_stats_channel_t;
+
+typedef struct
+{
+  uint32_t samples;         /* Since the last reset */
+  ULONG since;              /* Ticks since the last reset */
+  meteo_stats_channel_t channel[METEO_ARCHIVE_CHANNELS];
+  float wind_steadiness;    /* Mean resultant length of the direction, 0..1 */
+} meteo_stats_snapshot_t;
+
+/* Wind speed quantiles of one hour or day, from P2 (fixed quantiles, every
+   reading) and from the t-digest (the day's is the merge of its hours) */
+typedef struct
+{
+  uint32_t start;           /* Seconds since start-up */
+  uint32_t samples;         /* 0: no complete window yet */
+  float p2[METEO_STATS_QUANTILES];
+  float digest[METEO_STATS_QUANTILES];
+  float max;
+} meteo_stats_quantiles_t;
+
+/* Exported functions --------------------------------------------------------*/
+
+/**
+ * @brief Create the mutex. Call from App_ThreadX_Init.
+ */
+void meteo_stats_init(void);
+
+/**
+ * @brief Add one decoded reading (DB thread), O(1)
+ */
+void meteo_stats_add(const meteo_archive_sample_t *sample);
+
+/**
+ * @brief Start the means and standard deviations again (the EWMA and the
+ *        min/max keep going)
+ */
+void meteo_stats_reset(void);
+
+void meteo_stats_get(meteo_stats_snapshot_t *snapshot);
+
+/**
+ * @brief Wind speed quantiles of the last complete hour and day
+ */
+void meteo_stats_get_quantiles(meteo_stats_quantiles_t *hour, meteo_stats_quantiles_t *day);
+
+/**
+ * @brief One line per channel on the console
+ */
+void meteo_stats_print(void);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* METEO_STATS_H */
@@ -0,0 +1,634 @@
+/* USER CODE BEGIN HeaderStatsHpp */
+/**
+  ******************************************************************************
+  * @file           : meteo_stats.hpp
+  * @brief          : Incremental statistics, header only (C++).
+  *                   Each estimator takes one value at a time in O(1), holds
+  *                   a few numbers and never allocates: instantiate one per
+  *                   channel and feed it as the readings arrive, instead of
+  *                   scanning the history again for every consumer.
+  *                   - Welford: mean and variance without cancellation
+  *                   - Ewma: exponentially weighted mean and variance with a
+  *                     half-life
+  *                   - MinMax: min and max of the last horizon (time units),
+  *                     in buckets
+  *                   - Circular: mean direction and circular standard
+  *                     deviation of angles in degrees (wind direction wraps
+  *                     at 360, so 350 and 10 average to 0, not 180)
+  *                   - P2: one fixed quantile in five markers
+  *                   - TDigest: any quantile from a bounded set of
+  *                     centroids, mergeable across windows and stations
+  ******************************************************************************
+  * @attention
+  *
+  * Copyright (c) 2026 STMicroelectronics.
+  * All rights reserved.
+  *
+  ******************************************************************************
+  */
+/* USER CODE END HeaderStatsHpp */
+
+#ifndef METEO_STATS_HPP
+#define METEO_STATS_HPP
+
+/* Includes ------------------------------------------------------------------*/
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <limits>
+
+namespace meteo
+{
+namespace stats
+{
+
+/* Welford -------------------------------------------------------------------*/
+
+/* Running mean and variance (B. P. Welford, 1962): one division per value,
+   stable where sum(x^2) - n*mean^2 cancels */
+template <typename T>
+class Welford
+{
+public:
+  Welford() { reset(); }
+
+  void reset()
+  {
+    n_ = 0U;
+    mean_ = T(0);
+    m2_ = T(0);
+  }
+
+  void add(T x)
+  {
+    T delta = x - mean_;
+
+    n_++;
+    mean_ += delta / T(n_);
+    m2_ += delta * (x - mean_);
+  }
+
+  uint32_t count() const { return n_; }
+  T mean() const { return mean_; }
+
+  /* Sample variance (n - 1), 0 below two values */
+  T variance() const { return (n_ > 1U) ? m2_ / T(n_ - 1U) : T(0); }
+  T stddev() const { return std::sqrt(variance()); }
+
+private:
+  uint32_t n_;
+  T mean_;
+  T m2_;            /* Sum of squared deviations from the mean */
+};
+
+/* Ewma ----------------------------------------------------------------------*/
+
+/* Exponentially weighted mean and variance. The weight of a value halves
+   every half_life; values come every period (same unit, e.g. seconds), so
+   alpha = 1 - 2^(-period / half_life) is worked out once. */
+template <typename T>
+class Ewma
+{
+public:
+  explicit Ewma(T half_life, T period = T(1))
+    : alpha_(T(1) - std::exp2(-period / half_life))
+  {
+    reset();
+  }
+
+  void reset()
+  {
+    primed_ = false;
+    mean_ = T(0);
+    variance_ = T(0);
+  }
+
+  void add(T x)
+  {
+    T delta;
+
+    if (!primed_)
+    {
+      // The first value is the mean, not alpha x
+      primed_ = true;
+      mean_ = x;
+      return;
+    }
+    delta = x - mean_;
+    mean_ += alpha_ * delta;
+    variance_ = (T(1) - alpha_) * (variance_ + alpha_ * delta * delta);
+  }
+
+  bool primed() const { return primed_; }
+  T alpha() const { return alpha_; }
+  T mean() const { return mean_; }
+  T variance() const { return variance_; }
+  T stddev() const { return std::sqrt(variance_); }
+
+private:
+  T alpha_;
+  bool primed_;
+  T mean_;
+  T variance_;
+};
+
+/* MinMax --------------------------------------------------------------------*/
+
+/* Min and max of the last horizon, kept per bucket of horizon / B time
+   units in a ring of B buckets. A value updates the current bucket, O(1);
+   moving to the next bucket clears the one that leaves the horizon. The
+   answer covers the last B buckets, the current one partly: the horizon to
+   within one bucket, exactly, whatever the trend. Reading it scans the B
+   buckets. */
+template <typename T, uint32_t B>
+class MinMax
+{
+public:
+  explicit MinMax(uint32_t horizon) : width_((horizon > B) ? (horizon + B - 1U) / B : 1U) { reset(); }
+
+  void reset()
+  {
+    uint32_t i;
+
+    for (i = 0; i < B; i++)
+    {
+      clear(bucket_[i]);
+    }
+    current_ = 0U;
+    index_ = 0U;
+    started_ = false;
+  }
+
+  /* time: not decreasing, in the unit of horizon */
+  void add(T x, uint32_t time)
+  {
+    expire(time);
+
+    Bucket &b = bucket_[current_];
+
+    if (x < b.min)
+    {
+      b.min = x;
+    }
+    if (x > b.max)
+    {
+      b.max = x;
+    }
+  }
+
+  /* Drop the buckets that are older than horizon at time */
+  void expire(uint32_t time)
+  {
+    uint32_t index = time / width_;
+    uint32_t steps;
+
+    if (!started_)
+    {
+      started_ = true;
+      index_ = index;
+      return;
+    }
+    if (index <= index_)
+    {
+      return;
+    }
+    steps = (index - index_ < B) ? index - index_ : B;
+    index_ = index;
+    while (steps-- != 0U)
+    {
+      current_ = (current_ + 1U < B) ? current_ + 1U : 0U;
+      clear(bucket_[current_]);
+    }
+  }
+
+  /* NaN when empty */
+  T min() const
+  {
+    T result = std::numeric_limits<T>::infinity();
+    uint32_t i;
+
+    for (i = 0; i < B; i++)
+    {
+      result = (bucket_[i].min < result) ? bucket_[i].min : result;
+    }
+    return (result != std::numeric_limits<T>::infinity()) ? result : std::numeric_limits<T>::quiet_NaN();
+  }
+
+  T max() const
+  {
+    T result = -std::numeric_limits<T>::infinity();
+    uint32_t i;
+
+    for (i = 0; i < B; i++)
+    {
+      result = (bucket_[i].max > result) ? bucket_[i].max : result;
+    }
+    return (result != -std::numeric_limits<T>::infinity()) ? result : std::numeric_limits<T>::quiet_NaN();
+  }
+
+private:
+  struct Bucket
+  {
+    T min;
+    T max;
+  };
+
+  static void clear(Bucket &b)
+  {
+    b.min = std::numeric_limits<T>::infinity();
+    b.max = -std::numeric_limits<T>::infinity();
+  }
+
+  uint32_t width_;
+  uint32_t current_;
+  uint32_t index_;          /* time / width_ of the current bucket */
+  bool started_;
+  Bucket bucket_[B];
+};
+
+/* Circular ------------------------------------------------------------------*/
+
+/* Angles in degrees as unit vectors: the mean direction is that of the mean
+   vector, its length R (1: all the same, 0: no prevailing direction) gives
+   the circular standard deviation sqrt(-2 ln R). The vector components are
+   running means as in Welford, not sums that grow without bound. */
+template <typename T>
+class Circular
+{
+public:
+  Circular() { reset(); }
+
+  void reset()
+  {
+    n_ = 0U;
+    cos_ = T(0);
+    sin_ = T(0);
+  }
+
+  void add(T degrees)
+  {
+    T radians = degrees * (kPi / T(180));
+
+    n_++;
+    cos_ += (std::cos(radians) - cos_) / T(n_);
+    sin_ += (std::sin(radians) - sin_) / T(n_);
+  }
+
+  uint32_t count() const { return n_; }
+
+  /* 0..1 */
+  T resultant() const { return std::sqrt(cos_ * cos_ + sin_ * sin_); }
+
+  /* 0 <= mean < 360; NaN when the vectors cancel out */
+  T mean() const
+  {
+    T degrees;
+
+    // Below sqrt(epsilon) the direction is rounding noise
+    if (n_ == 0U || resultant() < std::sqrt(std::numeric_limits<T>::epsilon()))
+    {
+      return std::numeric_limits<T>::quiet_NaN();
+    }
+    degrees = std::atan2(sin_, cos_) * (T(180) / kPi);
+    if (degrees < T(0))
+    {
+      degrees += T(360);
+    }
+    // -tiny + 360 rounds to 360
+    return (degrees < T(360)) ? degrees : T(0);
+  }
+
+  /* Degrees; infinite when the vectors cancel out */
+  T stddev() const
+  {
+    T r = resultant();
+
+    if (r >= T(1))
+    {
+      return T(0);
+    }
+    return std::sqrt(T(-2) * std::log(r)) * (T(180) / kPi);
+  }
+
+private:
+  static constexpr T kPi = T(3.14159265358979323846);
+
+  uint32_t n_;
+  T cos_;           /* Mean of cos, sin */
+  T sin_;
+};
+
+template <typename T>
+constexpr T Circular<T>::kPi;
+
+/* P2 ------------------------------------------------------------------------*/
+
+/* One quantile p without storing the values (R. Jain, I. Chlamtac, 1985):
+   five markers at the min, p/2, p, (1+p)/2 and the max, whose heights are
+   moved by a parabola through their neighbours as the values arrive. O(1),
+   within a few tenths of a percent of rank on smooth distributions, but two
+   of them cannot be merged: use TDigest for that. */
+template <typename T>
+class P2
+{
+public:
+  explicit P2(T p = T(0.5)) : p_(p) { reset(); }
+
+  void reset() { n_ = 0U; }
+
+  void add(T x)
+  {
+    uint32_t k;
+    uint32_t i;
+
+    if (n_ < 5U)
+    {
+      // The first five are kept sorted, then become the markers
+      for (i = n_; i > 0U && q_[i - 1U] > x; i--)
+      {
+        q_[i] = q_[i - 1U];
+      }
+      q_[i] = x;
+      if (++n_ == 5U)
+      {
+        for (i = 0; i < 5U; i++)
+        {
+          pos_[i] = (int32_t)i;
+        }
+      }
+      return;
+    }
+
+    if (x < q_[0])
+    {
+      q_[0] = x;
+      k = 0U;
+    }
+    else if (x >= q_[4])
+    {
+      q_[4] = x;
+      k = 3U;
+    }
+    else
+    {
+      for (k = 0U; x >= q_[k + 1U]; k++)
+      {
+      }
+    }
+    for (i = k + 1U; i < 5U; i++)
+    {
+      pos_[i]++;
+    }
+    n_++;
+
+    for (i = 1U; i < 4U; i++)
+    {
+      // Desired position from the count, not summed: a float sum of
+      // increments stops moving after a day of readings
+      T d = T(n_ - 1U) * increment(i) - T(pos_[i]);
+      int32_t s;
+      T h;
+
+      if ((d >= T(1) && pos_[i + 1U] - pos_[i] > 1) || (d <= T(-1) && pos_[i - 1U] - pos_[i] < -1))
+      {
+        s = (d >= T(0)) ? 1 : -1;
+        h = parabolic(i, s);
+        if (!(q_[i - 1U] < h && h < q_[i + 1U]))
+        {
+          h = q_[i] + T(s) * (q_[i + s] - q_[i]) / T(pos_[i + s] - pos_[i]);
+        }
+        q_[i] = h;
+        pos_[i] += s;
+      }
+    }
+  }
+
+  uint32_t count() const { return n_; }
+  T p() const { return p_; }
+
+  /* NaN when empty; exact (nearest rank) below five values */
+  T quantile() const
+  {
+    if (n_ == 0U)
+    {
+      return std::numeric_limits<T>::quiet_NaN();
+    }
+    if (n_ < 5U)
+    {
+      return q_[(uint32_t)(p_ * T(n_ - 1U) + T(0.5))];
+    }
+    return q_[2];
+  }
+
+private:
+  /* Desired position of marker i moves this much a value */
+  T increment(uint32_t i) const
+  {
+    return (i == 1U) ? p_ / T(2) : (i == 2U) ? p_ : (T(1) + p_) / T(2);
+  }
+
+  T parabolic(uint32_t i, int32_t s) const
+  {
+    T below = T(pos_[i] - pos_[i - 1U]);
+    T above = T(pos_[i + 1U] - pos_[i]);
+
+    return q_[i] + T(s) / (below + above) *
+           ((below + T(s)) * (q_[i + 1U] - q_[i]) / above + (above - T(s)) * (q_[i] - q_[i - 1U]) / below);
+  }
+
+  T p_;
+  uint32_t n_;
+  T q_[5];          /* Marker heights */
+  int32_t pos_[5];  /* Marker positions, 0-based ranks */
+};
+
+/* TDigest -------------------------------------------------------------------*/
+
+/* Any quantile from a merging t-digest (T. Dunning, 2019): values go into a
+   buffer; when it is full it is sorted and merged with the centroids, each
+   of which may hold at most one unit of k(q) = C / (2 pi) asin(2q - 1), so
+   they stay small near the tails (P99) and there are at most C + 2 of them.
+   Adding a value is O(1) amortised plus the sort of the buffer every
+   Buffer values. merge() adds the centroids of another digest, of another
+   hour or another station, as weighted values. No heap: about
+   (2 (C + 2) + Buffer) x 2 x sizeof(T) bytes. */
+template <typename T, uint32_t C, uint32_t Buffer = C>
+class TDigest
+{
+public:
+  TDigest() { reset(); }
+
+  void reset()
+  {
+    active_ = 0U;
+    centroids_ = 0U;
+    buffered_ = 0U;
+    total_ = T(0);
+    min_ = std::numeric_limits<T>::infinity();
+    max_ = -std::numeric_limits<T>::infinity();
+  }
+
+  void add(T x, T weight = T(1))
+  {
+    if (buffered_ == Buffer)
+    {
+      compress();
+    }
+    buffer_[buffered_].mean = x;
+    buffer_[buffered_].weight = weight;
+    buffered_++;
+    total_ += weight;
+    min_ = (x < min_) ? x : min_;
+    max_ = (x > max_) ? x : max_;
+  }
+
+  template <uint32_t B>
+  void merge(const TDigest<T, C, B> &other)
+  {
+    uint32_t i;
+
+    for (i = 0; i < other.centroids_; i++)
+    {
+      add(other.centroid_[other.active_][i].mean, other.centroid_[other.active_][i].weight);
+    }
+    for (i = 0; i < other.buffered_; i++)
+    {
+      add(other.buffer_[i].mean, other.buffer_[i].weight);
+    }
+    min_ = (other.min_ < min_) ? other.min_ : min_;
+    max_ = (other.max_ > max_) ? other.max_ : max_;
+  }
+
+  /* Fold the buffer into the centroids */
+  void compress()
+  {
+    const Centroid *from = centroid_[active_];
+    Centroid *to = centroid_[active_ ^ 1U];
+    uint32_t i = 0U;
+    uint32_t j = 0U;
+    uint32_t n = 0U;
+    T q0 = T(0);
+    T limit;
+
+    if (buffered_ == 0U)
+    {
+      return;
+    }
+    std::sort(buffer_, buffer_ + buffered_, [](const Centroid &a, const Centroid &b) { return a.mean < b.mean; });
+
+    // Both runs sorted: merge them, growing the last centroid while it
+    // stays within one unit of k
+    limit = limit_after(q0);
+    while (i < centroids_ || j < buffered_)
+    {
+      const Centroid &next = (j == buffered_ || (i < centroids_ && from[i].mean < buffer_[j].mean)) ? from[i++]
+                                                                                                     : buffer_[j++];
+
+      if (n != 0U && (q0 + (to[n - 1U].weight + next.weight) / total_ <= limit || n == C + 2U))
+      {
+        Centroid &last = to[n - 1U];
+
+        last.weight += next.weight;
+        last.mean += (next.mean - last.mean) * next.weight / last.weight;
+      }
+      else
+      {
+        if (n != 0U)
+        {
+          q0 += to[n - 1U].weight / total_;
+          limit = limit_after(q0);
+        }
+        to[n++] = next;
+      }
+    }
+
+    active_ ^= 1U;
+    centroids_ = n;
+    buffered_ = 0U;
+  }
+
+  /* Total weight */
+  T count() const { return total_; }
+  T min() const { return (total_ > T(0)) ? min_ : std::numeric_limits<T>::quiet_NaN(); }
+  T max() const { return (total_ > T(0)) ? max_ : std::numeric_limits<T>::quiet_NaN(); }
+
+  uint32_t centroids()
+  {
+    compress();
+    return centroids_;
+  }
+
+  /* 0 <= q <= 1, NaN when empty. Interpolates between the centroid
+     centres, and from the min and to the max at the ends. */
+  T quantile(T q)
+  {
+    const Centroid *c;
+    T index = q * total_;
+    T below = T(0);           /* Weight of the centroids before i */
+    T left = T(0);
+    T x0 = min_;
+    uint32_t i;
+
+    compress();
+    if (centroids_ == 0U)
+    {
+      return std::numeric_limits<T>::quiet_NaN();
+    }
+    c = centroid_[active_];
+    for (i = 0; i <= centroids_; i++)
+    {
+      T right = (i < centroids_) ? below + c[i].weight / T(2) : total_;
+      T x1 = (i < centroids_) ? c[i].mean : max_;
+
+      if (index <= right)
+      {
+        return (right > left) ? x0 + (x1 - x0) * (index - left) / (right - left) : x1;
+      }
+      left = right;
+      x0 = x1;
+      if (i < centroids_)
+      {
+        below += c[i].weight;
+      }
+    }
+    return max_;
+  }
+
+private:
+  template <typename, uint32_t, uint32_t>
+  friend class TDigest;
+
+  struct Centroid
+  {
+    T mean;
+    T weight;
+  };
+
+  /* The q a centroid starting at q0 may reach: k^-1(k(q0) + 1) */
+  static T limit_after(T q0)
+  {
+    const T pi = T(3.14159265358979323846);
+    T k = T(C) / (T(2) * pi) * std::asin(T(2) * q0 - T(1)) + T(1);
+
+    if (k >= T(C) / T(4))
+    {
+      return T(1);
+    }
+    return (std::sin(k * T(2) * pi / T(C)) + T(1)) / T(2);
+  }
+
+  uint32_t active_;         /* centroid_[active_] holds them, the other is
+                               the output of the next compress() */
+  uint32_t centroids_;
+  uint32_t buffered_;
+  T total_;
+  T min_;
+  T max_;
+  Centroid centroid_[2][C + 2U];
+  Centroid buffer_[Buffer];
+};
+
+} // namespace stats
+} // namespace meteo
+
+#endif /* METEO_STATS_HPP */
@@ -22,6 +22,24 @@ extern UCHAR meteo_thread_stack[2048];
 /* Exported functions --------------------------------------------------------*/
 void Meteo_Thread_Entry(ULONG thread_input);
 
+/* 19.10.26 Post a complete frame (RX_BUFFER_SIZE bytes, NUL terminated) to the
+ * meteo thread for validation, display and storage. ISR safe, never blocks;
+ * returns TX_QUEUE_FULL when the frame had to be dropped. */
+UINT Meteo_Frame_Submit(const char *frame);
+
+/* 19.10.26 Frames the meteo thread validated but could not pass to the DB
+ * thread (meteo_frame_queue full), since start-up */
+ULONG Meteo_Frame_Db_Dropped(void);
+
+/* 19.10.26 Frames the meteo thread rejected (checksum), since start-up */
+ULONG Meteo_Frame_Rejected(void);
+
+/* 19.10.26 Frames the DB thread dropped because their fields do not decode
+ * (checksum good), since start-up. Meteo_Frame_Db_Reject() counts one; DB
+ * thread only. */
+void Meteo_Frame_Db_Reject(void);
+ULONG Meteo_Frame_Db_Rejected(void);
+
 #ifdef __cplusplus
 }
 #endif
@@ -0,0 +1,89 @@
+/* USER CODE BEGIN HeaderStats */
+/**
+  ******************************************************************************
+  * @file           : meteo_thread_stats.h
+  * @brief          : Header for meteo_thread_stats.c file.
+  *                   Per-thread CPU load and stack high-water marks
+  ******************************************************************************
+  * @attention
+  *
+  * Copyright (c) 2026 STMicroelectronics.
+  * All rights reserved.
+  *
+  ******************************************************************************
+  */
+/* USER CODE END HeaderStats */
+
+#ifndef METEO_THREAD_STATS_H
+#define METEO_THREAD_STATS_H
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/* Includes ------------------------------------------------------------------*/
+#include "tx_api.h"
+#include <stdint.h>
+
+/* Exported constants --------------------------------------------------------*/
+
+/* Sampling period: CPU loads are shares of this window */
+#define METEO_STATS_PERIOD_TICKS     (5 * TX_TIMER_TICKS_PER_SECOND)
+
+/* Table sizes (threads beyond this are not reported) */
+#define METEO_STATS_MAX_THREADS      16
+#define METEO_STATS_MAX_ISRS         8
+
+/*
+ * Binary stats record, little-endian, version 1:
+ *
+ *   header  16 bytes  'T' 'S' version header_size
+ *                     u8 threads, u8 isrs, u16 record size
+ *                     u32 tx_time_get() at the sample
+ *                     u16 idle load, u16 ISR load
+ *   thread  20 bytes  char name[8] (not terminated when 8 long)
+ *                     u16 load, u8 priority, u8 state
+ *                     u32 stack size, u32 stack high-water (bytes)
+ *   isr      8 bytes  u16 exception number (15 SysTick, 16 + IRQn)
+ *                     u16 load, u32 interrupts in the window
+ *
+ * Loads are in 0.01 % of the last sampling window.
+ */
+#define METEO_STATS_RECORD_VERSION   1
+#define METEO_STATS_HEADER_SIZE      16
+#define METEO_STATS_THREAD_SIZE      20
+#define METEO_STATS_ISR_SIZE         8
+#define METEO_STATS_RECORD_MAX       (METEO_STATS_HEADER_SIZE + \
+                                      METEO_STATS_MAX_THREADS * METEO_STATS_THREAD_SIZE + \
+                                      METEO_STATS_MAX_ISRS * METEO_STATS_ISR_SIZE)
+
+/* Exported functions --------------------------------------------------------*/
+
+/**
+ * @brief Start periodic sampling (call once all threads are created)
+ */
+void meteo_thread_stats_init(void);
+
+/**
+ * @brief Print the last sample as a table on the console
+ */
+void meteo_thread_stats_print(void);
+
+/**
+ * @brief Encode the last sample as a binary stats record
+ * @param buffer Output buffer (METEO_STATS_RECORD_MAX is always enough)
+ * @param size Size of output buffer
+ * @return Record size in bytes, 0 if the buffer is too small
+ */
+UINT meteo_thread_stats_record(uint8_t *buffer, UINT size);
+
+/**
+ * @brief Print the binary stats record as one hex line ("[STATS] 5453...")
+ */
+void meteo_thread_stats_print_record(void);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* METEO_THREAD_STATS_H */
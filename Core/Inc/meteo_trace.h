@@ -0,0 +1,92 @@
+/* USER CODE BEGIN HeaderTrace */
+/**
+  ******************************************************************************
+  * @file           : meteo_trace.h
+  * @brief          : Header for meteo_trace.c file.
+  *                   ThreadX event trace capture and dump
+  ******************************************************************************
+  * @attention
+  *
+  * Copyright (c) 2026 STMicroelectronics.
+  * All rights reserved.
+  *
+  ******************************************************************************
+  */
+/* USER CODE END HeaderTrace */
+
+#ifndef METEO_TRACE_H
+#define METEO_TRACE_H
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/* Includes ------------------------------------------------------------------*/
+#include "tx_api.h"
+
+/* Exported constants --------------------------------------------------------*/
+
+/* Trace buffer, in the .tx_trace RAM section: about 950 events */
+#define METEO_TRACE_BUFFER_SIZE       (32 * 1024)
+
+/* Object registry entries (threads, queues, timers, NetX objects ...) */
+#define METEO_TRACE_REGISTRY_ENTRIES  48
+
+/* TCP port serving the raw trace buffer: connect, read until closed */
+#define METEO_TRACE_TCP_PORT          16535
+
+/*
+ * Application events in the ThreadX trace (info fields I1, I2).
+ * Core/Host/Tools/tx_trace_to_json.c names them: keep both in step.
+ * A _BEGIN/_END pair becomes a slice on the timeline.
+ */
+#define METEO_TRACE_FRAME_RECEIVED    (TX_TRACE_USER_EVENT_START + 0)  /* I1 = frame length, I2 = rx queue status   */
+#define METEO_TRACE_FRAME_DECODED     (TX_TRACE_USER_EVENT_START + 1)  /* I1 = checksum ok, I2 = DB queue status    */
+#define METEO_TRACE_STREAM_PROCESSED  (TX_TRACE_USER_EVENT_START + 2)  /* I1 = stored, I2 = DB status               */
+#define METEO_TRACE_IDC_SEND          (TX_TRACE_USER_EVENT_START + 3)  /* I1 = bytes, I2 = NetX status              */
+#define METEO_TRACE_CONSOLE_BEGIN     (TX_TRACE_USER_EVENT_START + 4)  /* I1 = bytes, console write (_write)        */
+#define METEO_TRACE_CONSOLE_END       (TX_TRACE_USER_EVENT_START + 5)  /* I1 = bytes                                */
+#define METEO_TRACE_OSPI_ERASE_BEGIN  (TX_TRACE_USER_EVENT_START + 6)  /* I1 = block                                */
+#define METEO_TRACE_OSPI_ERASE_END    (TX_TRACE_USER_EVENT_START + 7)  /* I1 = block, I2 = driver status            */
+#define METEO_TRACE_LOAD_START        (TX_TRACE_USER_EVENT_START + 8)  /* I1 = rate Hz, I2 = stations               */
+#define METEO_TRACE_LOAD_DONE         (TX_TRACE_USER_EVENT_START + 9)  /* I1 = generated, I2 = dropped queue full   */
+
+/* Exported macro ------------------------------------------------------------*/
+
+/* ISR and thread safe, compiles out without TX_ENABLE_EVENT_TRACE */
+#ifdef TX_ENABLE_EVENT_TRACE
+#define METEO_TRACE(id, i1, i2)  ((void)tx_trace_user_event_insert((ULONG)(id), (ULONG)(i1), (ULONG)(i2), 0UL, 0UL))
+#else
+#define METEO_TRACE(id, i1, i2)  ((void)0)
+#endif
+
+/* Exported functions --------------------------------------------------------*/
+
+/**
+ * @brief Start tracing (call early in tx_application_define)
+ */
+void meteo_trace_init(void);
+
+/**
+ * @brief Stop tracing and give access to the trace buffer
+ * @param buffer Start of the buffer (trace control header first)
+ * @param size Size of the buffer in bytes
+ * @return TX_SUCCESS, TX_NOT_DONE when not tracing (or another dump is running)
+ */
+UINT meteo_trace_stop(const UCHAR **buffer, ULONG *size);
+
+/**
+ * @brief Start a new trace after meteo_trace_stop()
+ */
+void meteo_trace_restart(void);
+
+/**
+ * @brief Dump the trace buffer on the console as [TRACE] hex lines, then restart
+ */
+void meteo_trace_dump(void);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* METEO_TRACE_H */
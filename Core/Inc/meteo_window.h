@@ -0,0 +1,87 @@
+/* USER CODE BEGIN HeaderWindow */
+/**
+  ******************************************************************************
+  * @file           : meteo_window.h
+  * @brief          : Header for meteo_window.c file.
+  *                   Sliding window of the latest readings for NanoEdge AI
+  ******************************************************************************
+  * @attention
+  *
+  * Copyright (c) 2026 STMicroelectronics.
+  * All rights reserved.
+  *
+  ******************************************************************************
+  */
+/* USER CODE END HeaderWindow */
+
+#ifndef METEO_WINDOW_H
+#define METEO_WINDOW_H
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/* Includes ------------------------------------------------------------------*/
+#include "tx_api.h"
+#include "meteo_archive.h"
+#include <stdint.h>
+
+/* Exported constants --------------------------------------------------------*/
+
+/* Samples in the window: the buffer length of the NanoEdge library */
+#ifndef METEO_WINDOW_SAMPLES
+#define METEO_WINDOW_SAMPLES        64U
+#endif
+
+/* Values per sample, in meteo_archive_channel_t order as in the NanoEdge
+   export, so a library trained on exported files gets the same axes */
+#define METEO_WINDOW_AXES           METEO_ARCHIVE_CHANNELS
+
+/* Exported types ------------------------------------------------------------*/
+
+/* Runs in the DB thread. window is METEO_WINDOW_SAMPLES x METEO_WINDOW_AXES
+   floats, oldest sample first, axes interleaved (what neai_anomalydetection_detect()
+   takes). It is only valid during the call. */
+typedef void (*meteo_window_callback_t)(void *context, const float *window);
+
+typedef struct
+{
+  uint32_t samples;         /* Added */
+  uint32_t windows;         /* Callbacks made */
+  uint32_t every;           /* Samples between callbacks, 0 = none */
+} meteo_window_stats_t;
+
+/* Exported functions --------------------------------------------------------*/
+
+/**
+ * @brief Create the mutex. Call from App_ThreadX_Init.
+ */
+void meteo_window_init(void);
+
+/**
+ * @brief Call callback with the window once it is full, then every every
+ *        samples; NULL or every 0 stops the calls. The callback must not
+ *        call the meteo_window_xxx() functions.
+ */
+void meteo_window_set_callback(meteo_window_callback_t callback, void *context, uint32_t every);
+
+/**
+ * @brief Add the readings of one frame (DB thread)
+ * @param values METEO_WINDOW_AXES values, meteo_archive_sample_t.value
+ */
+void meteo_window_add(const float *values);
+
+/**
+ * @brief The window as the callback gets it, from the DB thread only (the
+ *        next meteo_window_add() changes it)
+ * @return NULL until METEO_WINDOW_SAMPLES samples have been added
+ */
+const float *meteo_window_get(void);
+
+void meteo_window_get_stats(meteo_window_stats_t *stats);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* METEO_WINDOW_H */
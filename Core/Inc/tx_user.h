@@ -123,7 +123,11 @@
    processing is done directly from the timer ISR, thereby eliminating the timer thread control
    block, stack, and context switching to activate it.  */
 
-/*#define TX_TIMER_PROCESS_IN_ISR*/
+/* 19.10.26 Enabled: the application and NetX Duo timer callbacks only set event flags or read
+   counters, and timers longer than the 32-entry timer wheel otherwise wake the timer thread
+   every 32 ticks just to re-insert them.  */
+
+#define TX_TIMER_PROCESS_IN_ISR
 
 /* Determine if in-line timer reactivation should be used within the timer expiration processing.
    By default, this is disabled and a function call is used. When the following is defined,
@@ -201,8 +205,18 @@
 /* Determine if the trace event logging code should be enabled. This causes slight increases in
    code size and overhead, but provides the ability to generate system trace information which
    is available for viewing in TraceX.  */
+/* 19.10.26 Enabled: meteo_trace.c places the buffer in the .tx_trace RAM section and dumps it
+   on the COM1 'D' key or over TCP; Core/Host/Tools/tx_trace_to_json converts the dump to a
+   Chrome/Perfetto timeline.  */
+
+#define TX_ENABLE_EVENT_TRACE
 
-/*#define TX_ENABLE_EVENT_TRACE*/
+/* Determine if the execution profile kit (utility/execution_profile_kit) is used. When the
+   following is defined, the scheduler and ISR entry/exit accumulate the time spent in each thread,
+   in each interrupt source and idle, measured with the DWT cycle counter. The kit directory must
+   be on the include path of everything that includes tx_api.h.  */
+
+#define TX_EXECUTION_PROFILE_ENABLE
 
 /* Determine if block pool performance gathering is required by the application. When the following is
    defined, ThreadX gathers various block pool performance information. */
@@ -214,6 +228,14 @@
 
 /*#define TX_BYTE_POOL_ENABLE_PERFORMANCE_INFO*/
 
+/* Determine if byte pools use the two-level segregated fit (TLSF) allocator. By default, byte
+   pools use a first-fit search that walks and merges fragments, so its time grows with
+   fragmentation. When the following is defined, tx_byte_allocate and tx_byte_release take
+   constant time, at the cost of an index of a few hundred bytes at the start of each pool.
+   Pools must then be at least TX_BYTE_POOL_MIN (1024) bytes.  */
+
+/*#define TX_BYTE_POOL_ENABLE_TLSF*/
+
 /* Determine if event flags performance gathering is required by the application. When the following is
    defined, ThreadX gathers various event flags performance information. */
 
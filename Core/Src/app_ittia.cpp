@@ -38,7 +38,7 @@
 #include <string.h>
 #include <stdio.h>
 /* USER CODE BEGIN Includes */
-
+#include <ittia/os/os_malloc.h>
 /* USER CODE END Includes */
 
 /* Private typedef -----------------------------------------------------------*/
@@ -147,4 +147,82 @@ void MX_ITTIA_Init(void)
 
 /* USER CODE BEGIN 1 */
 
+#ifdef DB_MEMPROFILE
+static const char * const mem_kind_names[DB_MEMPROFILE_KINDS] = {
+  "unknown", "free", "delayfree", "system", "malloc", "new", "newarr", "other"
+};
+
+static const char * mem_kind_name(int kind)
+{
+  return (kind >= 0 && kind < DB_MEMPROFILE_KINDS) ? mem_kind_names[kind] : "overflow";
+}
+#endif
+
+/**
+  * @brief  Print the ITTIA DB allocation profile (build with DB_MEMPROFILE)
+  * @param  csv  0 = readable table, 1 = CSV with one row per site and kind
+  * @retval None
+  */
+void app_ittia_mem_profile_print(int csv)
+{
+#ifdef DB_MEMPROFILE
+  db_mem_site_t site;
+  _db_MemStatistics heap_stats;
+  int i, rc;
+
+  if (csv) {
+    printf("scope,kind,file,line,caller,live_bytes,peak_bytes,live_blocks,calls\n");
+  } else {
+    printf("\n=== ITTIA DB memory profile ===\n");
+    if (!DB_FAILED(_db_get_mem_statistics(&heap_stats, 0))) {
+      printf("  Segment: %lu bytes, used %lu, peak %lu\n",
+             (unsigned long)DB_APP_MEM_SEG_BUFFER_SIZE,
+             (unsigned long)heap_stats.sys_cur,
+             (unsigned long)heap_stats.sys_max);
+    }
+    printf("  %-10s %10s %10s %8s %8s\n", "kind", "live", "peak", "blocks", "calls");
+  }
+
+  for (i = 0; i < DB_MEMPROFILE_KINDS; ++i) {
+    if (db_mem_profile_kind(i, &site) != DB_NOERROR || (site.calls == 0 && site.live_blocks == 0))
+      continue;
+    if (csv)
+      printf("kind,%s,,,,%ld,%ld,%ld,%ld\n", mem_kind_name(i),
+             (long)site.live_bytes, (long)site.peak_bytes,
+             (long)site.live_blocks, (long)site.calls);
+    else
+      printf("  %-10s %10ld %10ld %8ld %8ld\n", mem_kind_name(i),
+             (long)site.live_bytes, (long)site.peak_bytes,
+             (long)site.live_blocks, (long)site.calls);
+  }
+
+  if (!csv)
+    printf("  %-10s %10s %10s %8s %8s  site\n", "kind", "live", "peak", "blocks", "calls");
+
+  for (i = 0; (rc = db_mem_profile_site(i, &site)) >= 0; ++i) {
+    if (rc == 0)
+      continue;
+    if (csv)
+      printf("site,%s,%s,%d,%p,%ld,%ld,%ld,%ld\n", mem_kind_name(site.block_kind),
+             site.file ? site.file : "", site.line, site.caller,
+             (long)site.live_bytes, (long)site.peak_bytes,
+             (long)site.live_blocks, (long)site.calls);
+    else if (site.file)
+      printf("  %-10s %10ld %10ld %8ld %8ld  %s:%d\n", mem_kind_name(site.block_kind),
+             (long)site.live_bytes, (long)site.peak_bytes,
+             (long)site.live_blocks, (long)site.calls, site.file, site.line);
+    else
+      printf("  %-10s %10ld %10ld %8ld %8ld  %p\n", mem_kind_name(site.block_kind),
+             (long)site.live_bytes, (long)site.peak_bytes,
+             (long)site.live_blocks, (long)site.calls, site.caller);
+  }
+
+  if (!csv)
+    printf("  (resolve addresses with arm-none-eabi-addr2line -e <elf>)\n\n");
+#else
+  (void)csv;
+  printf("[MEM] Allocation profiler not built; define DB_MEMPROFILE\n");
+#endif
+}
+
 /* USER CODE END 1 */
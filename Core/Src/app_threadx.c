@@ -40,6 +40,35 @@
 //10.2.26 Simulator
 #include "meteo_simulator.h"
 
+// 19.10.26 Thread CPU load / stack statistics
+#include "meteo_thread_stats.h"
+
+// 19.10.26 ThreadX event trace
+#include "meteo_trace.h"
+
+// 19.10.26 Console output by DMA
+#include "meteo_console.h"
+
+// 19.10.26 Raw frame journal on the OSPI (store and forward)
+#include "meteo_journal.h"
+#include "meteo_ospi.h"
+// 19.10.26 Compressed long-term archive on the OSPI
+#include "meteo_archive_store.h"
+// 19.10.26 CSV export of the archive (COM1, TCP)
+#include "meteo_export.h"
+// 19.10.26 Latest readings as one window for NanoEdge AI
+#include "meteo_window.h"
+// 19.10.26 Running statistics per channel (C++, meteo_stats.hpp)
+#include "meteo_stats.h"
+// 19.10.26 Sliding median spike filter ahead of the stream
+#include "meteo_filter.h"
+// 19.10.26 Deadband / swinging door in front of the stream
+#include "meteo_compress.h"
+// 19.10.26 A float32 time series per channel (ITTIA DB IoT storage)
+#include "meteo_series.h"
+// 19.10.26 Age and byte budgets of the archive and the series
+#include "meteo_retention.h"
+
 // 13.2.26 Include Buffer Sizes in main.h for queues
 // --> for METEO_QUEUE_STORAGE_SIZE
 #include "main.h"
@@ -78,7 +107,11 @@ extern XSPI_HandleTypeDef hospi1;  // From CubeMX
 
 /* *** 12.2.26 added METEO database processing thread *** */
 TX_THREAD meteo_db_thread;
-UCHAR meteo_db_thread_stack[2048];
+UCHAR meteo_db_thread_stack[3072];  // 19.10.26 +1 KB: archive segment header reads
+
+// 19.10.26 Trims the archive and the series in the idle time of the others
+TX_THREAD meteo_retention_thread;
+UCHAR meteo_retention_thread_stack[3072];
 
 // *** NEW: IDC agent thread (if enabled) ***
 #if METEO_IDC_ENABLED
@@ -122,6 +155,24 @@ UINT App_ThreadX_Init(VOID *memory_ptr)
   
   /* USER CODE BEGIN App_ThreadX_Init */
 
+  // 19.10.26 Trace from here on: objects created later register themselves
+  meteo_trace_init();
+
+  // 19.10.26 printf no longer waits for the UART: ring + COM1 TX DMA
+  meteo_console_init();
+
+  // 19.10.26 OSPI lock, shared by the journal, the archive and the ITTIA media driver
+  meteo_ospi_init();
+  meteo_journal_init();
+  meteo_archive_store_init();
+  meteo_export_init();
+  meteo_window_init();
+  meteo_stats_init();
+  meteo_filter_init();
+  meteo_compress_init();
+  meteo_series_init();
+  meteo_retention_init();
+
   /* *** 12-02-26 Create METEO frame queue (before threads) *** */
   /* Queue and storage global in main.c                         */
   extern TX_QUEUE meteo_frame_queue;
@@ -160,6 +211,17 @@ UINT App_ThreadX_Init(VOID *memory_ptr)
     printf("ERROR: Failed to create METEO frame queue\n");
     return TX_QUEUE_ERROR;
   }
+
+  // 19.10.26 UART3 framer / simulator -> meteo thread
+  if (tx_queue_create(&meteo_rx_queue,
+                      "METEO RX Queue",
+                      RX_BUFFER_SIZE / sizeof(ULONG),
+                      meteo_rx_queue_storage,
+                      METEO_QUEUE_STORAGE_SIZE) != TX_SUCCESS)
+  {
+    printf("ERROR: Failed to create METEO RX queue\n");
+    return TX_QUEUE_ERROR;
+  }
   
   
   /* Declare thread and stack as static or extern */
@@ -174,7 +236,7 @@ UINT App_ThreadX_Init(VOID *memory_ptr)
   if (tx_thread_create(&meteo_thread, "Meteo Thread",
                        Meteo_Thread_Entry, 0,
                        meteo_thread_stack, sizeof(meteo_thread_stack),
-                       10, 10, TX_NO_TIME_SLICE, TX_AUTO_START) != TX_SUCCESS)
+                       METEO_THREAD_PRIO, METEO_THREAD_PRIO, TX_NO_TIME_SLICE, TX_AUTO_START) != TX_SUCCESS)
   {
     return TX_THREAD_ERROR;
   }
@@ -189,14 +251,24 @@ UINT App_ThreadX_Init(VOID *memory_ptr)
                        0,
                        meteo_db_thread_stack,
                        sizeof(meteo_db_thread_stack),
-                       15,  // Priority
-                       15,
+                       METEO_DB_THREAD_PRIO,
+                       METEO_DB_THREAD_PRIO,
                        TX_NO_TIME_SLICE,
                        TX_AUTO_START) != TX_SUCCESS)
   {
     printf("[WARNING] METEO DB thread creation failed\n");
     // Continue anyway
   }
+
+  // 19.10.26 Lowest of the app threads: steps only when nothing else runs
+  if (tx_thread_create(&meteo_retention_thread, "METEO Retention",
+                       meteo_retention_thread_entry, 0,
+                       meteo_retention_thread_stack, sizeof(meteo_retention_thread_stack),
+                       METEO_RETENTION_PRIORITY, METEO_RETENTION_PRIORITY,
+                       TX_NO_TIME_SLICE, TX_AUTO_START) != TX_SUCCESS)
+  {
+    printf("[WARNING] METEO retention thread creation failed - flash fills up to the ring\n");
+  }
   
 
 #if METEO_IDC_ENABLED
@@ -229,6 +301,8 @@ UINT App_ThreadX_Init(VOID *memory_ptr)
   }
 
   /* USER CODE BEGIN App_ThreadX_Init */
+  // 19.10.26 Sample CPU load and stack usage of all threads every 5 s
+  meteo_thread_stats_init();
   /* USER CODE END App_ThreadX_Init */
 
   return ret;
@@ -250,6 +324,7 @@ void tx_app_thread_entry(ULONG thread_input)
 
 
   // 9.2.26 NEW: Initialize MeteoSimulator thread (internal message if fails)
+  // 19.10.26 Only events, timer and console RX - this thread runs it below
   meteo_simulator_init();
 
   printf("Services started - press 'S' to toggle simulator\n");
@@ -273,6 +348,10 @@ void tx_app_thread_entry(ULONG thread_input)
     Error_Handler();
   }
 
+  // 19.10.26 OSPI is up: find the end of the frame journal and the archive
+  (void)meteo_journal_open();
+  (void)meteo_archive_store_open();
+
   printf("=== METEO system ready ===\n");  // update menu 11.2.26
   printf("  - Real sensor: Connect METEO to UART3\n");
   printf("  - Simulator: Press 'S' to toggle\n");
@@ -285,10 +364,11 @@ void tx_app_thread_entry(ULONG thread_input)
 
   // *** Main thread entering - UART ISR handles data ***
   // No while loop here.. 10/2/26
-  //while (1)
-  //{
-  //tx_thread_sleep(1000);  // Sleep 1 second
-  //}
+  // 19.10.26 Instead of falling off, this thread continues as the console /
+  // simulator thread at the priority of the other app threads (no extra stack)
+  UINT old_priority;
+  tx_thread_priority_change(&tx_app_thread, METEO_SIMULATOR_THREAD_PRIO, &old_priority);
+  meteo_simulator_thread_entry(0);
 
   /* USER CODE END tx_app_thread_entry */
 }
@@ -384,17 +464,53 @@ static void meteo_db_thread_entry(ULONG thread_input)
 {
     (void)thread_input;
     char frame_buffer[RX_BUFFER_SIZE];  // 13.2.26 RX_BUFFER_SIZE from main.H
+    meteo_archive_sample_t sample;
+    meteo_archive_sample_t kept[2];
+    uint32_t rows;
+    uint32_t i;
     extern TX_QUEUE meteo_frame_queue;
     
     printf("[DB Thread] Started - waiting for METEO frames\n");
+#if METEO_SERIES_ENABLED
+    // 19.10.26 This thread's connection puts the series
+    (void)meteo_series_open();
+#endif
     
     while(1)
     {
         // Wait for frame from queue (blocks until available)
         if (tx_queue_receive(&meteo_frame_queue, frame_buffer, TX_WAIT_FOREVER) == TX_SUCCESS)
         {
-            // Now safe to call ITTIA DB functions (thread context!)
-            ProcessMeteoFrameToStream(frame_buffer);
+            // 19.10.26 Decoded once: spikes replaced by the median, then the stream
+            // (compressed rows), the archive, and the NanoEdge window
+            if (meteo_archive_store_parse_frame(frame_buffer, &sample) == TX_SUCCESS)
+            {
+                // 19.10.26 Keep it for the uplink until Analitica has it
+                (void)meteo_journal_append_frame(frame_buffer);
+                // One time for the stream and the archive
+                sample.ts_usec = meteo_archive_store_now();
+                (void)meteo_filter_apply(sample.value);
+                // Now safe to call ITTIA DB functions (thread context!)
+                // Only the rows the deadband / swinging door keep
+                rows = meteo_compress_apply(&sample, kept);
+                for (i = 0; i < rows; i++)
+                {
+                    ProcessMeteoSampleToStream(&kept[i]);
+                }
+#if METEO_SERIES_ENABLED
+                (void)meteo_series_add(&sample);
+#endif
+                (void)meteo_archive_store_add(&sample);
+                meteo_window_add(sample.value);
+                meteo_stats_add(&sample);
+            }
+            else
+            {
+                // 19.10.26 Checksum good but the fields do not decode: dropped,
+                // not stored raw
+                Meteo_Frame_Db_Reject();
+                printf("[DB Thread] Frame does not decode - dropped\n");
+            }
         }
     }
 }
@@ -43,6 +43,7 @@
 #include <stdio.h>
 #include <string.h>
 #include <stdlib.h>
+#include <inttypes.h>
 // To avoid linker errors
 // using int _gettimeofday(struct timeval *tv, void *tzvp) in USER CODE 4
 #include <sys/time.h>
@@ -57,6 +58,13 @@
 // 8.2.26 New checksum validation - Based on old CL2 (2014) -8-bit meteo.c/.h
 #include "meteo_checksum.h" 
 
+// 19.10.26 Frame path events in the ThreadX trace
+#include "meteo_trace.h"
+#include "meteo_console.h"
+#include "meteo_framer.h"
+// 19.10.26 Readings printed as fixed point, no float printf
+#include "meteo_format.h"
+
 // 9.2.26 Added METEO Simulator in file meteo_simulator.c, USER button 
 // changes from UART3 to Simulator data. USER button already in BSP package
 #include "stm32h573i_discovery.h"
@@ -104,10 +112,7 @@ extern UART_HandleTypeDef huart3;       // From CubeMX
 // extern UART_HandleTypeDef huart1;       // VCP
 
 static uint8_t rxByte;
-static char rxBuffer[RX_BUFFER_SIZE];
-static uint8_t rxIndex = 0;
-static uint8_t frameInProgress = 0;
-static uint32_t lastReceptionTick = 0;
+static meteo_framer_t uart3_framer;     // 19.10.26 was rxBuffer/rxIndex/frameInProgress
 
 /* 17.1.26 ThreadX variables for meteo thread */
 TX_THREAD meteo_thread;
@@ -121,6 +126,15 @@ UCHAR meteo_thread_stack[2048];  // Small stack for minimal thread
 TX_QUEUE meteo_frame_queue;
 UCHAR meteo_queue_storage[METEO_QUEUE_STORAGE_SIZE];
 
+/* 19.10.26 Raw frames from the UART3 framer (and the simulator) to the
+ * meteo thread, which validates and displays them outside the ISR */
+TX_QUEUE meteo_rx_queue;
+UCHAR meteo_rx_queue_storage[METEO_QUEUE_STORAGE_SIZE];
+static volatile ULONG meteoRxDropped = 0;
+static volatile ULONG meteoDbDropped = 0;
+static volatile ULONG meteoRxRejected = 0;
+static volatile ULONG meteoDbRejected = 0;   // written by the DB thread only
+
 /* USER CODE END PV */
 
 /* Private function prototypes -----------------------------------------------*/
@@ -391,9 +405,13 @@ static void MX_GPDMA1_Init(void)
 
 /* Meteo thread entry function (runs the UART3 interrupt reception) */
 /* 27.1.26 not static any more */
+/* 19.10.26 Frame worker: blocks on meteo_rx_queue instead of polling, validates
+ * and displays each frame, then hands it to the DB thread */
 void Meteo_Thread_Entry(ULONG thread_input)
 {
   (void)thread_input;  // Unused
+  char frame[RX_BUFFER_SIZE];
+  ULONG dropped_reported = 0;
 
   /* USER CODE BEGIN METEO_THREAD */
   // Start the initial interrupt reception (single byte)
@@ -405,12 +423,84 @@ void Meteo_Thread_Entry(ULONG thread_input)
 
   while (1)
   {
-    // Thread sleeps until interrupt callback wakes it (or use semaphore if needed)
-    tx_thread_sleep(50);  // Small sleep to avoid 100% CPU - adjust as needed
+    // Sleeps until the framer or the simulator posts a frame
+    if (tx_queue_receive(&meteo_rx_queue, frame, TX_WAIT_FOREVER) != TX_SUCCESS)
+    {
+      continue;
+    }
+
+    if (meteoRxDropped != dropped_reported)
+    {
+      printf("[METEO] %lu frame(s) dropped - worker busy\n",
+             (unsigned long)(meteoRxDropped - dropped_reported));
+      dropped_reported = meteoRxDropped;
+    }
+
+    printf("\n[METEO Frame] (%d bytes): %s\r\n", (int)strlen(frame), frame);
+
+    if (meteo_validate_checksum(frame))
+    {
+      printf("[METEO] Checksum OK\n");
+
+      // Display values
+      ProcessMeteoFrame(frame);
+
+      // 13.2.26 Post to queue for database storage (DB thread)
+      UINT status = tx_queue_send(&meteo_frame_queue, frame, TX_NO_WAIT);
+      METEO_TRACE(METEO_TRACE_FRAME_DECODED, 1, status);
+      if (status != TX_SUCCESS)
+      {
+        meteoDbDropped++;
+        printf("[METEO] Queue full - frame dropped\n");
+      }
+    }
+    else
+    {
+      METEO_TRACE(METEO_TRACE_FRAME_DECODED, 0, 0);
+      meteoRxRejected++;
+      printf("[METEO] Checksum validation failed\n");
+    }
   }
   /* USER CODE END METEO_THREAD */
 }
 
+/**
+ * @brief  Hand a complete frame to the meteo thread - 19.10.26
+ * @note   ISR safe, never blocks. frame must point to RX_BUFFER_SIZE bytes.
+ * @retval TX_SUCCESS, or TX_QUEUE_FULL when the frame was dropped
+ */
+UINT Meteo_Frame_Submit(const char *frame)
+{
+  UINT status = tx_queue_send(&meteo_rx_queue, (VOID *)frame, TX_NO_WAIT);
+
+  if (status != TX_SUCCESS)
+  {
+    meteoRxDropped++;
+  }
+  METEO_TRACE(METEO_TRACE_FRAME_RECEIVED, strlen(frame), status);
+  return status;
+}
+
+ULONG Meteo_Frame_Db_Dropped(void)
+{
+  return meteoDbDropped;
+}
+
+ULONG Meteo_Frame_Rejected(void)
+{
+  return meteoRxRejected;
+}
+
+void Meteo_Frame_Db_Reject(void)
+{
+  meteoDbRejected++;
+}
+
+ULONG Meteo_Frame_Db_Rejected(void)
+{
+  return meteoDbRejected;
+}
+
 /* UART3 RX complete callback (called on each byte) */
 // 27.1.26 20:16Hs
 // Frame correction 8-2-26 with 16-bit checksum
@@ -421,82 +511,32 @@ void HAL_UART_RxCpltCallback(UART_HandleTypeDef *huart)
 {
   if (huart->Instance == USART3)
   {
-    if (!frameInProgress)
+    /* 19.10.26 Framing moved to meteo_framer.c (own state, resyncs on UUU$) */
+    switch (meteo_framer_byte(&uart3_framer, rxByte))
     {
-      /* Look for 'U' 'U' 'U' '$' sequence */
-      rxBuffer[rxIndex % 4] = rxByte;
-      if (rxIndex >= 3 &&
-          rxBuffer[(rxIndex - 3) % 4] == 'U' &&
-          rxBuffer[(rxIndex - 2) % 4] == 'U' &&
-          rxBuffer[(rxIndex - 1) % 4] == 'U' &&
-          rxBuffer[rxIndex % 4] == '$')
-      {
-        frameInProgress = 1;
-        rxBuffer[0] = 'U';
-        rxBuffer[1] = 'U';
-        rxBuffer[2] = 'U';
-        rxBuffer[3] = '$';
-        rxIndex = 4;
-      }
-      else
-      {
-        rxIndex++;
-      }
-    }
-    else
-    {
-      /* Collecting frame data */
-      if (rxIndex < RX_BUFFER_SIZE - 1)
-      {
-        rxBuffer[rxIndex++] = rxByte;
-
-        /* Check for end: *QQQ */
-        if (rxIndex >= 4 &&
-            rxBuffer[rxIndex - 4] == '*' &&
-            rxBuffer[rxIndex - 3] == 'Q' &&
-            rxBuffer[rxIndex - 2] == 'Q' &&
-            rxBuffer[rxIndex - 1] == 'Q')
-        {
-          rxBuffer[rxIndex] = '\0';
-
-          /* Frame complete */
-          printf("\n[METEO Frame] (%d bytes): %s\r\n", rxIndex, rxBuffer);
-
-          if (meteo_validate_checksum(rxBuffer))
-          {
-            printf("[METEO] Checksum OK\n");
-            
-            // Display immediately (safe in ISR)
-            ProcessMeteoFrame(rxBuffer);
-            
-            // 13.2.26 Post to queue for database storage (thread context) ***
-            extern TX_QUEUE meteo_frame_queue;
-            if (tx_queue_send(&meteo_frame_queue, rxBuffer, TX_NO_WAIT) != TX_SUCCESS)
-            {
-                printf("[METEO] Queue full - frame dropped\n");
-            }
-          }
-          else
-          {
-            printf("[METEO] Checksum validation failed\n");
-          }
-
-          frameInProgress = 0;
-          rxIndex = 0;
-        }
-      }
-      else
-      {
+      case METEO_FRAMER_FRAME:
+        /* Frame complete - 19.10.26 validation and printing moved to
+         * the meteo thread, the ISR only queues the frame */
+        (void)Meteo_Frame_Submit(uart3_framer.buffer);
+        break;
+
+      case METEO_FRAMER_OVERFLOW:
         /* Buffer overflow */
-        printf("[METEO] Buffer overflow - frame dropped\n");
-        frameInProgress = 0;
-        rxIndex = 0;
-      }
+        meteoRxDropped++;
+        break;
+
+      default:
+        break;
     }
 
     /* Restart reception */
     HAL_UART_Receive_IT(&huart3, &rxByte, 1);
   }
+  // 19.10.26 Console key (COM1) received by interrupt
+  else if (huart == &hcom_uart[COM1])
+  {
+    meteo_simulator_console_rx_cplt();
+  }
 }
 
 /* UART3 error callback (clear framing errors)
@@ -510,7 +550,7 @@ void HAL_UART_ErrorCallback(UART_HandleTypeDef *huart)
 	      // 9.2.26 Only print actual errors, not normal idle/timeout flags
 	      if (isr & (UART_FLAG_PE | UART_FLAG_FE | UART_FLAG_NE | UART_FLAG_ORE))
 	      {
-	          printf("[UART ERR: ISR=0x%08lX]\r\n", isr);
+	          printf("[UART ERR: ISR=0x%08" PRIX32 "]\r\n", isr);
 	      }
 
 	      __HAL_UART_CLEAR_FLAG(huart, UART_CLEAR_OREF | UART_CLEAR_FEF |
@@ -519,6 +559,21 @@ void HAL_UART_ErrorCallback(UART_HandleTypeDef *huart)
 	      // Restart reception
 	      HAL_UART_Receive_IT(&huart3, &rxByte, 1);
   }
+  // 19.10.26 Re-arm the console after a COM1 error
+  else if (huart == &hcom_uart[COM1])
+  {
+    meteo_console_tx_error(huart);
+    meteo_simulator_console_rx_error();
+  }
+}
+
+/* 19.10.26 COM1 TX DMA transfer done: the console sends the next block */
+void HAL_UART_TxCpltCallback(UART_HandleTypeDef *huart)
+{
+  if (huart == &hcom_uart[COM1])
+  {
+    meteo_console_tx_cplt();
+  }
 }
 
 
@@ -531,18 +586,20 @@ void ProcessMeteoFrame(const char* frame)
   uint32_t ts = HAL_GetTick();
   uint32_t temp_adc = 0, baro_adc = 0, wdir = 0, wspeed = 0, volt = 0;
   uint16_t crcc = 0;
+  char temp_c[12];
+  char pressure_hpa[12];
 
   // Format: UUU$ttttt.bbbbb.dddd.sssss.vvv.CRCC*QQQ
   // Parse: skip the CRCC field in scanf
   if (sscanf(frame, "UUU$%5u.%5u.%4u.%5u.%3u.%4hx",
              &temp_adc, &baro_adc, &wdir, &wspeed, &volt, &crcc) >= 5)
   {
-    // Convert to engineering units
-    float temp_c = temp_adc * 0.01f;        // e.g., 08030 → 80.30°C
-    float pressure_hpa = baro_adc * 0.1f;   // e.g., 00327 → 32.7 hPa
-    
+    // Convert to engineering units, 19.10.26 as text with the decimal point placed
+    temp_c[meteo_format_fixed(temp_c, sizeof(temp_c) - 1U, (int32_t)temp_adc, 2)] = '\0';            // e.g., 08030 → 80.30°C
+    pressure_hpa[meteo_format_fixed(pressure_hpa, sizeof(pressure_hpa) - 1U, (int32_t)baro_adc, 1)] = '\0';  // e.g., 00327 → 32.7 hPa
+
     // Display on console
-    printf("[TS %lu] T=%.2f [degC] P=%.1f [hPa] WDir=%u.%u [deg] WSpeed=%u [m/s] V=%u mV CRC=0x%04X\r\n",
+    printf("[TS %" PRIu32 "] T=%s [degC] P=%s [hPa] WDir=%u.%u [deg] WSpeed=%u [m/s] V=%u mV CRC=0x%04X\r\n",
            ts, temp_c, pressure_hpa, wdir/10, wdir%10, wspeed, volt, crcc);
 
     #ifdef NEW_LCD
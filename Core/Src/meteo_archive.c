@@ -0,0 +1,877 @@
+/**
+ * @brief Compressed column segments for long-term readings
+ * @version 19.10.26
+ * @author R.Oliva
+ * @description A row of meteo_readings is 40 bytes: at 1 Hz that is 3.4 MB
+ *              of flash per station and day. The archive keeps the readings
+ *              of one time chunk (METEO_ARCHIVE_CHUNK_SECONDS) as one
+ *              segment of bit-packed columns, as in Facebook's Gorilla:
+ *              - timestamps: delta of delta, 1 bit when the period is steady
+ *              - temperature, wind: float32 XOR with the previous value,
+ *                only the bits that changed
+ *              - pressure, voltage: runs of the value x scale (integer), so
+ *                a steady value costs a few bits per run
+ *              The header has min/max/first/last per channel and the time
+ *              range, so a reader can skip a segment without decoding it.
+ *              The encoder streams: one sample at a time into fixed column
+ *              buffers, no heap. The decoder is plain C and also builds on
+ *              Linux (Core/Host/Tools/meteo_archive_dump.c).
+ */
+
+#include "meteo_archive.h"
+#include <string.h>
+
+// Column 0 is the timestamps, then the channels in meteo_archive_channel_t order
+static const struct
+{
+    uint8_t codec;
+    uint16_t scale;
+    uint16_t bytes;
+} archive_columns[METEO_ARCHIVE_COLUMNS] =
+{
+    { METEO_ARCHIVE_CODEC_DOD, 1U,  METEO_ARCHIVE_TS_BYTES  },
+    { METEO_ARCHIVE_CODEC_XOR, 1U,  METEO_ARCHIVE_XOR_BYTES },  // temperature
+    { METEO_ARCHIVE_CODEC_RLE, 10U, METEO_ARCHIVE_RLE_BYTES },  // pressure, 0.1 hPa
+    { METEO_ARCHIVE_CODEC_XOR, 1U,  METEO_ARCHIVE_XOR_BYTES },  // wind speed
+    { METEO_ARCHIVE_CODEC_XOR, 1U,  METEO_ARCHIVE_XOR_BYTES },  // wind direction
+    { METEO_ARCHIVE_CODEC_RLE, 1U,  METEO_ARCHIVE_RLE_BYTES }   // voltage
+};
+
+// Most bits one sample can add to a column. RLE: the run it ends, plus the
+// last run written when the chunk is sealed.
+#define ARCHIVE_DOD_WORST       36U
+#define ARCHIVE_XOR_WORST       44U
+#define ARCHIVE_RLE_WORST       260U
+
+// Timestamp offsets in a chunk stay below 2^30 units, so a delta of delta fits 32 bits
+#define ARCHIVE_MAX_OFFSET      (1LL << 30)
+
+#define ARCHIVE_NO_WINDOW       0xFFU
+
+/* CRC -----------------------------------------------------------------------*/
+
+uint32_t meteo_archive_crc32(const uint8_t *data, uint32_t length)
+{
+    static const uint32_t table[16] =
+    {
+        0x00000000UL, 0x1DB71064UL, 0x3B6E20C8UL, 0x26D930ACUL,
+        0x76DC4190UL, 0x6B6B51F4UL, 0x4DB26158UL, 0x5005713CUL,
+        0xEDB88320UL, 0xF00F9344UL, 0xD6D6A3E8UL, 0xCB61B38CUL,
+        0x9B64C2B0UL, 0x86D3D2D4UL, 0xA00AE278UL, 0xBDBDF21CUL
+    };
+    uint32_t crc = 0xFFFFFFFFUL;
+
+    while (length-- != 0U)
+    {
+        crc ^= *data++;
+        crc = (crc >> 4) ^ table[crc & 0x0FU];
+        crc = (crc >> 4) ^ table[crc & 0x0FU];
+    }
+
+    return ~crc;
+}
+
+/* Little endian fields ------------------------------------------------------*/
+
+static void put_u16(uint8_t *p, uint16_t v)
+{
+    p[0] = (uint8_t)v;
+    p[1] = (uint8_t)(v >> 8);
+}
+
+static void put_u32(uint8_t *p, uint32_t v)
+{
+    put_u16(p, (uint16_t)v);
+    put_u16(p + 2, (uint16_t)(v >> 16));
+}
+
+static void put_u64(uint8_t *p, uint64_t v)
+{
+    put_u32(p, (uint32_t)v);
+    put_u32(p + 4, (uint32_t)(v >> 32));
+}
+
+static void put_f32(uint8_t *p, float v)
+{
+    uint32_t bits;
+
+    memcpy(&bits, &v, sizeof(bits));
+    put_u32(p, bits);
+}
+
+static uint16_t get_u16(const uint8_t *p)
+{
+    return (uint16_t)(p[0] | (p[1] << 8));
+}
+
+static uint32_t get_u32(const uint8_t *p)
+{
+    return (uint32_t)get_u16(p) | ((uint32_t)get_u16(p + 2) << 16);
+}
+
+static uint64_t get_u64(const uint8_t *p)
+{
+    return (uint64_t)get_u32(p) | ((uint64_t)get_u32(p + 4) << 32);
+}
+
+static float get_f32(const uint8_t *p)
+{
+    uint32_t bits = get_u32(p);
+    float v;
+
+    memcpy(&v, &bits, sizeof(v));
+    return v;
+}
+
+/* Header layout (offsets) */
+#define HDR_MAGIC           0U
+#define HDR_VERSION         4U
+#define HDR_COLUMNS         5U
+#define HDR_SIZE            6U
+#define HDR_BYTES           8U
+#define HDR_SEQ             12U
+#define HDR_SAMPLES         16U
+#define HDR_TS_SCALE        20U
+#define HDR_CHUNK_START     24U
+#define HDR_TS_FIRST        32U
+#define HDR_TS_LAST         40U
+#define HDR_TS_MIN          48U
+#define HDR_TS_MAX          56U
+#define HDR_CODEC           64U     /* u8 per column, then 2 reserved bytes */
+#define HDR_SCALE           72U     /* u16 per column */
+#define HDR_COLUMN_BYTES    84U     /* u16 per column */
+#define HDR_RANGE           96U     /* min, max, first, last f32 per channel */
+
+static void header_write(uint8_t *p, const meteo_archive_header_t *h)
+{
+    uint32_t i;
+
+    memset(p, 0, METEO_ARCHIVE_HEADER_SIZE);
+    put_u32(p + HDR_MAGIC, METEO_ARCHIVE_MAGIC);
+    p[HDR_VERSION] = METEO_ARCHIVE_VERSION;
+    p[HDR_COLUMNS] = METEO_ARCHIVE_COLUMNS;
+    put_u16(p + HDR_SIZE, METEO_ARCHIVE_HEADER_SIZE);
+    put_u32(p + HDR_BYTES, h->bytes);
+    put_u32(p + HDR_SEQ, h->seq);
+    put_u32(p + HDR_SAMPLES, h->samples);
+    put_u32(p + HDR_TS_SCALE, h->ts_scale_us);
+    put_u64(p + HDR_CHUNK_START, (uint64_t)h->chunk_start_usec);
+    put_u64(p + HDR_TS_FIRST, (uint64_t)h->ts_first_usec);
+    put_u64(p + HDR_TS_LAST, (uint64_t)h->ts_last_usec);
+    put_u64(p + HDR_TS_MIN, (uint64_t)h->ts_min_usec);
+    put_u64(p + HDR_TS_MAX, (uint64_t)h->ts_max_usec);
+    for (i = 0; i < METEO_ARCHIVE_COLUMNS; i++)
+    {
+        p[HDR_CODEC + i] = h->codec[i];
+        put_u16(p + HDR_SCALE + 2U * i, h->scale[i]);
+        put_u16(p + HDR_COLUMN_BYTES + 2U * i, h->column_bytes[i]);
+    }
+    for (i = 0; i < METEO_ARCHIVE_CHANNELS; i++)
+    {
+        put_f32(p + HDR_RANGE + 16U * i, h->range[i].min);
+        put_f32(p + HDR_RANGE + 16U * i + 4U, h->range[i].max);
+        put_f32(p + HDR_RANGE + 16U * i + 8U, h->range[i].first);
+        put_f32(p + HDR_RANGE + 16U * i + 12U, h->range[i].last);
+    }
+}
+
+int meteo_archive_header_read(const uint8_t *p, uint32_t size, meteo_archive_header_t *h)
+{
+    uint32_t columns = 0;
+    uint32_t i;
+
+    if (size < METEO_ARCHIVE_HEADER_SIZE ||
+        get_u32(p + HDR_MAGIC) != METEO_ARCHIVE_MAGIC ||
+        p[HDR_VERSION] != METEO_ARCHIVE_VERSION ||
+        p[HDR_COLUMNS] != METEO_ARCHIVE_COLUMNS ||
+        get_u16(p + HDR_SIZE) != METEO_ARCHIVE_HEADER_SIZE)
+    {
+        return METEO_ARCHIVE_ERROR_FORMAT;
+    }
+
+    h->bytes = get_u32(p + HDR_BYTES);
+    h->seq = get_u32(p + HDR_SEQ);
+    h->samples = get_u32(p + HDR_SAMPLES);
+    h->ts_scale_us = get_u32(p + HDR_TS_SCALE);
+    h->chunk_start_usec = (int64_t)get_u64(p + HDR_CHUNK_START);
+    h->ts_first_usec = (int64_t)get_u64(p + HDR_TS_FIRST);
+    h->ts_last_usec = (int64_t)get_u64(p + HDR_TS_LAST);
+    h->ts_min_usec = (int64_t)get_u64(p + HDR_TS_MIN);
+    h->ts_max_usec = (int64_t)get_u64(p + HDR_TS_MAX);
+    for (i = 0; i < METEO_ARCHIVE_COLUMNS; i++)
+    {
+        h->codec[i] = p[HDR_CODEC + i];
+        h->scale[i] = get_u16(p + HDR_SCALE + 2U * i);
+        h->column_bytes[i] = get_u16(p + HDR_COLUMN_BYTES + 2U * i);
+        columns += h->column_bytes[i];
+        if (h->codec[i] != archive_columns[i].codec || h->scale[i] == 0U || (h->column_bytes[i] & 3U) != 0U)
+        {
+            return METEO_ARCHIVE_ERROR_FORMAT;
+        }
+    }
+    for (i = 0; i < METEO_ARCHIVE_CHANNELS; i++)
+    {
+        h->range[i].min = get_f32(p + HDR_RANGE + 16U * i);
+        h->range[i].max = get_f32(p + HDR_RANGE + 16U * i + 4U);
+        h->range[i].first = get_f32(p + HDR_RANGE + 16U * i + 8U);
+        h->range[i].last = get_f32(p + HDR_RANGE + 16U * i + 12U);
+    }
+
+    if (h->ts_scale_us == 0U ||
+        h->bytes != METEO_ARCHIVE_HEADER_SIZE + columns + 4U ||
+        h->bytes > METEO_ARCHIVE_SEGMENT_MAX)
+    {
+        return METEO_ARCHIVE_ERROR_FORMAT;
+    }
+
+    return METEO_ARCHIVE_OK;
+}
+
+/* Bits, most significant first ----------------------------------------------*/
+
+static void bits_put(meteo_archive_bitbuf_t *b, uint32_t value, uint32_t n)
+{
+    uint32_t room;
+    uint32_t take;
+
+    while (n != 0U)
+    {
+        room = 8U - (b->bits & 7U);
+        take = (n < room) ? n : room;
+        b->data[b->bits >> 3] |= (uint8_t)(((value >> (n - take)) & ((1UL << take) - 1U)) << (room - take));
+        b->bits += take;
+        n -= take;
+    }
+}
+
+static void bits_put64(meteo_archive_bitbuf_t *b, uint64_t value, uint32_t n)
+{
+    if (n > 32U)
+    {
+        bits_put(b, (uint32_t)(value >> 32), n - 32U);
+        n = 32U;
+    }
+    bits_put(b, (uint32_t)value, n);
+}
+
+/* Exp-Golomb (order 0): small numbers in few bits, any number fits */
+static void bits_put_golomb(meteo_archive_bitbuf_t *b, uint64_t x)
+{
+    uint64_t v = x + 1U;
+    uint32_t n = 0;
+
+    while ((v >> n) > 1U)
+    {
+        n++;
+    }
+    bits_put64(b, 0, n);
+    bits_put64(b, v, n + 1U);
+}
+
+static int bits_get(meteo_archive_bitreader_t *r, uint32_t n, uint32_t *value)
+{
+    uint32_t v = 0;
+    uint32_t room;
+    uint32_t take;
+
+    if (n > r->bits - r->pos)
+    {
+        return METEO_ARCHIVE_ERROR_FORMAT;
+    }
+
+    while (n != 0U)
+    {
+        room = 8U - (r->pos & 7U);
+        take = (n < room) ? n : room;
+        v = (v << take) | ((uint32_t)(r->data[r->pos >> 3] >> (room - take)) & ((1UL << take) - 1U));
+        r->pos += take;
+        n -= take;
+    }
+
+    *value = v;
+    return METEO_ARCHIVE_OK;
+}
+
+static int bits_get64(meteo_archive_bitreader_t *r, uint32_t n, uint64_t *value)
+{
+    uint32_t high = 0;
+    uint32_t low;
+
+    if (n > 32U && bits_get(r, n - 32U, &high) != METEO_ARCHIVE_OK)
+    {
+        return METEO_ARCHIVE_ERROR_FORMAT;
+    }
+    if (bits_get(r, (n > 32U) ? 32U : n, &low) != METEO_ARCHIVE_OK)
+    {
+        return METEO_ARCHIVE_ERROR_FORMAT;
+    }
+
+    *value = ((uint64_t)high << 32) | low;
+    return METEO_ARCHIVE_OK;
+}
+
+static int bits_get_golomb(meteo_archive_bitreader_t *r, uint64_t *x)
+{
+    uint32_t n = 0;
+    uint32_t bit;
+    uint64_t rest = 0;
+
+    do
+    {
+        if (n > 63U || bits_get(r, 1U, &bit) != METEO_ARCHIVE_OK)
+        {
+            return METEO_ARCHIVE_ERROR_FORMAT;
+        }
+        n++;
+    } while (bit == 0U);
+    n--;
+
+    if (n != 0U && bits_get64(r, n, &rest) != METEO_ARCHIVE_OK)
+    {
+        return METEO_ARCHIVE_ERROR_FORMAT;
+    }
+
+    *x = ((1ULL << n) | rest) - 1U;
+    return METEO_ARCHIVE_OK;
+}
+
+static uint64_t zigzag(int64_t v)
+{
+    return ((uint64_t)v << 1) ^ (uint64_t)(v >> 63);
+}
+
+static int64_t unzigzag(uint64_t v)
+{
+    return (int64_t)(v >> 1) ^ -(int64_t)(v & 1U);
+}
+
+static int64_t sign_extend(uint32_t v, uint32_t n)
+{
+    return (n < 32U && (v & (1UL << (n - 1U))) != 0U) ? (int64_t)v - (1LL << n) : (int64_t)(int32_t)v;
+}
+
+/* Encoder -------------------------------------------------------------------*/
+
+static void encoder_reset(meteo_archive_encoder_t *encoder)
+{
+    uint8_t *p = encoder->buffer + METEO_ARCHIVE_HEADER_SIZE;
+    uint32_t ts_scale_us = encoder->header.ts_scale_us;
+    uint32_t i;
+
+    memset(p, 0, METEO_ARCHIVE_SEGMENT_MAX - METEO_ARCHIVE_HEADER_SIZE);
+    memset(&encoder->header, 0, sizeof(encoder->header));
+    encoder->header.ts_scale_us = ts_scale_us;
+    for (i = 0; i < METEO_ARCHIVE_COLUMNS; i++)
+    {
+        encoder->column[i].data = p;
+        encoder->column[i].capacity = archive_columns[i].bytes * 8U;
+        encoder->column[i].bits = 0;
+        encoder->header.codec[i] = archive_columns[i].codec;
+        encoder->header.scale[i] = archive_columns[i].scale;
+        p += archive_columns[i].bytes;
+    }
+    for (i = 0; i < METEO_ARCHIVE_CHANNELS; i++)
+    {
+        encoder->leading[i] = ARCHIVE_NO_WINDOW;
+        encoder->trailing[i] = 0;
+        encoder->run_base[i] = 0;
+        encoder->run_count[i] = 0;
+    }
+    encoder->header.seq = encoder->next_seq;
+    encoder->prev_ts = 0;
+    encoder->prev_delta = 0;
+}
+
+static int encoder_room(const meteo_archive_encoder_t *encoder)
+{
+    static const uint32_t worst[3] = { ARCHIVE_DOD_WORST, ARCHIVE_XOR_WORST, ARCHIVE_RLE_WORST };
+    uint32_t i;
+
+    for (i = 0; i < METEO_ARCHIVE_COLUMNS; i++)
+    {
+        if (encoder->column[i].capacity - encoder->column[i].bits < worst[archive_columns[i].codec])
+        {
+            return 0;
+        }
+    }
+
+    return 1;
+}
+
+static void encode_ts(meteo_archive_encoder_t *encoder, int64_t offset)
+{
+    meteo_archive_bitbuf_t *b = &encoder->column[0];
+    int64_t delta = offset - encoder->prev_ts;
+    int64_t dod = delta - encoder->prev_delta;
+
+    if (dod == 0)
+    {
+        bits_put(b, 0U, 1U);
+    }
+    else if (dod >= -64 && dod <= 63)
+    {
+        bits_put(b, 0x2U, 2U);
+        bits_put(b, (uint32_t)dod & 0x7FU, 7U);
+    }
+    else if (dod >= -256 && dod <= 255)
+    {
+        bits_put(b, 0x6U, 3U);
+        bits_put(b, (uint32_t)dod & 0x1FFU, 9U);
+    }
+    else if (dod >= -2048 && dod <= 2047)
+    {
+        bits_put(b, 0xEU, 4U);
+        bits_put(b, (uint32_t)dod & 0xFFFU, 12U);
+    }
+    else
+    {
+        bits_put(b, 0xFU, 4U);
+        bits_put(b, (uint32_t)dod, 32U);
+    }
+
+    encoder->prev_ts = offset;
+    encoder->prev_delta = delta;
+}
+
+static void encode_xor(meteo_archive_encoder_t *encoder, uint32_t channel, float value)
+{
+    meteo_archive_bitbuf_t *b = &encoder->column[channel + 1U];
+    uint32_t bits;
+    uint32_t x;
+    uint32_t leading;
+    uint32_t trailing;
+    uint32_t length;
+
+    memcpy(&bits, &value, sizeof(bits));
+
+    if (encoder->header.samples == 0U)
+    {
+        bits_put(b, bits, 32U);
+    }
+    else if ((x = bits ^ encoder->prev_bits[channel]) == 0U)
+    {
+        bits_put(b, 0U, 1U);
+    }
+    else
+    {
+        leading = (uint32_t)__builtin_clz(x);
+        trailing = (uint32_t)__builtin_ctz(x);
+        if (encoder->leading[channel] != ARCHIVE_NO_WINDOW &&
+            leading >= encoder->leading[channel] && trailing >= encoder->trailing[channel])
+        {
+            // Changed bits inside the previous window
+            length = 32U - encoder->leading[channel] - encoder->trailing[channel];
+            bits_put(b, 0x2U, 2U);
+            bits_put(b, x >> encoder->trailing[channel], length);
+        }
+        else
+        {
+            length = 32U - leading - trailing;
+            bits_put(b, 0x3U, 2U);
+            bits_put(b, leading, 5U);
+            bits_put(b, length - 1U, 5U);
+            bits_put(b, x >> trailing, length);
+            encoder->leading[channel] = (uint8_t)leading;
+            encoder->trailing[channel] = (uint8_t)trailing;
+        }
+    }
+
+    encoder->prev_bits[channel] = bits;
+}
+
+static void encode_run_end(meteo_archive_encoder_t *encoder, uint32_t channel)
+{
+    meteo_archive_bitbuf_t *b = &encoder->column[channel + 1U];
+
+    bits_put_golomb(b, zigzag((int64_t)encoder->run_value[channel] - encoder->run_base[channel]));
+    bits_put_golomb(b, encoder->run_count[channel] - 1U);
+    encoder->run_base[channel] = encoder->run_value[channel];
+    encoder->run_count[channel] = 0;
+}
+
+/**
+ * @return The value as the decoder returns it
+ */
+static float encode_rle(meteo_archive_encoder_t *encoder, uint32_t channel, float value)
+{
+    float scaled = value * (float)archive_columns[channel + 1U].scale;
+    int32_t q;
+
+    // Round to nearest, clamped to int32
+    if (scaled >= 2147483520.0f)
+    {
+        q = INT32_MAX;
+    }
+    else if (scaled <= -2147483520.0f)
+    {
+        q = INT32_MIN;
+    }
+    else
+    {
+        q = (int32_t)(scaled + ((scaled >= 0.0f) ? 0.5f : -0.5f));
+    }
+
+    if (encoder->run_count[channel] != 0U && q != encoder->run_value[channel])
+    {
+        encode_run_end(encoder, channel);
+    }
+    encoder->run_value[channel] = q;
+    encoder->run_count[channel]++;
+
+    return (float)q / (float)archive_columns[channel + 1U].scale;
+}
+
+void meteo_archive_encoder_init(meteo_archive_encoder_t *encoder, uint32_t chunk_seconds,
+                                uint32_t ts_scale_us, uint32_t first_seq,
+                                meteo_archive_sink_t sink, void *context)
+{
+    if (chunk_seconds == 0U)
+    {
+        chunk_seconds = METEO_ARCHIVE_CHUNK_SECONDS;
+    }
+    if (ts_scale_us == 0U)
+    {
+        ts_scale_us = 1U;
+    }
+
+    encoder->chunk_usec = (int64_t)chunk_seconds * 1000000LL;
+    if (encoder->chunk_usec / ts_scale_us >= ARCHIVE_MAX_OFFSET)
+    {
+        encoder->chunk_usec = (ARCHIVE_MAX_OFFSET - 1) * ts_scale_us;
+    }
+    encoder->next_seq = first_seq;
+    encoder->sink = sink;
+    encoder->context = context;
+    encoder->sealed = 0;
+    encoder->sink_errors = 0;
+    encoder->header.ts_scale_us = ts_scale_us;
+    encoder_reset(encoder);
+}
+
+int meteo_archive_encoder_flush(meteo_archive_encoder_t *encoder)
+{
+    meteo_archive_header_t *h = &encoder->header;
+    uint8_t *dst = encoder->buffer + METEO_ARCHIVE_HEADER_SIZE;
+    uint32_t bytes;
+    uint32_t i;
+    int status = METEO_ARCHIVE_OK;
+
+    if (h->samples == 0U)
+    {
+        return METEO_ARCHIVE_OK;
+    }
+
+    for (i = 0; i < METEO_ARCHIVE_CHANNELS; i++)
+    {
+        if (archive_columns[i + 1U].codec == METEO_ARCHIVE_CODEC_RLE && encoder->run_count[i] != 0U)
+        {
+            encode_run_end(encoder, i);
+        }
+    }
+
+    // Columns back to back after the header (they only move down)
+    for (i = 0; i < METEO_ARCHIVE_COLUMNS; i++)
+    {
+        bytes = ((encoder->column[i].bits + 31U) / 32U) * 4U;
+        memmove(dst, encoder->column[i].data, bytes);
+        h->column_bytes[i] = (uint16_t)bytes;
+        dst += bytes;
+    }
+    h->bytes = (uint32_t)(dst - encoder->buffer) + 4U;
+    header_write(encoder->buffer, h);
+    put_u32(dst, meteo_archive_crc32(encoder->buffer, h->bytes - 4U));
+
+    if (encoder->sink != NULL && encoder->sink(encoder->context, encoder->buffer, h->bytes) != 0)
+    {
+        encoder->sink_errors++;
+        status = METEO_ARCHIVE_ERROR_SINK;
+    }
+    encoder->sealed++;
+    encoder->next_seq++;
+
+    encoder_reset(encoder);
+    return status;
+}
+
+int meteo_archive_encoder_add(meteo_archive_encoder_t *encoder, const meteo_archive_sample_t *sample)
+{
+    meteo_archive_header_t *h = &encoder->header;
+    meteo_archive_range_t *range;
+    int64_t chunk;
+    int64_t offset;
+    int64_t ts;
+    float value;
+    uint32_t i;
+    int status = METEO_ARCHIVE_OK;
+
+    // Chunk: the multiple of chunk_usec at or before the sample
+    chunk = sample->ts_usec / encoder->chunk_usec;
+    if (sample->ts_usec < 0 && (sample->ts_usec % encoder->chunk_usec) != 0)
+    {
+        chunk--;
+    }
+    chunk *= encoder->chunk_usec;
+
+    if (h->samples != 0U && (chunk != h->chunk_start_usec || !encoder_room(encoder)))
+    {
+        status = meteo_archive_encoder_flush(encoder);
+    }
+    if (h->samples == 0U)
+    {
+        h->chunk_start_usec = chunk;
+    }
+
+    offset = (sample->ts_usec - chunk) / h->ts_scale_us;
+    ts = chunk + offset * h->ts_scale_us;
+    encode_ts(encoder, offset);
+
+    for (i = 0; i < METEO_ARCHIVE_CHANNELS; i++)
+    {
+        value = sample->value[i];
+        if (archive_columns[i + 1U].codec == METEO_ARCHIVE_CODEC_XOR)
+        {
+            encode_xor(encoder, i, value);
+        }
+        else
+        {
+            // Range of the rounded values, so it bounds what a reader gets
+            value = encode_rle(encoder, i, value);
+        }
+
+        range = &h->range[i];
+        if (h->samples == 0U)
+        {
+            range->min = value;
+            range->max = value;
+            range->first = value;
+        }
+        else if (value < range->min)
+        {
+            range->min = value;
+        }
+        else if (value > range->max)
+        {
+            range->max = value;
+        }
+        range->last = value;
+    }
+
+    if (h->samples == 0U)
+    {
+        h->ts_first_usec = ts;
+        h->ts_min_usec = ts;
+        h->ts_max_usec = ts;
+    }
+    else if (ts < h->ts_min_usec)
+    {
+        h->ts_min_usec = ts;
+    }
+    else if (ts > h->ts_max_usec)
+    {
+        h->ts_max_usec = ts;
+    }
+    h->ts_last_usec = ts;
+    h->samples++;
+
+    return status;
+}
+
+uint32_t meteo_archive_encoder_pending(const meteo_archive_encoder_t *encoder, uint32_t *bits)
+{
+    uint32_t i;
+
+    *bits = 0;
+    for (i = 0; i < METEO_ARCHIVE_COLUMNS; i++)
+    {
+        *bits += encoder->column[i].bits;
+    }
+
+    return encoder->header.samples;
+}
+
+/* Decoder -------------------------------------------------------------------*/
+
+int meteo_archive_decoder_init(meteo_archive_decoder_t *decoder, const uint8_t *data, uint32_t size)
+{
+    const uint8_t *p = data + METEO_ARCHIVE_HEADER_SIZE;
+    uint32_t i;
+
+    if (meteo_archive_header_read(data, size, &decoder->header) != METEO_ARCHIVE_OK ||
+        decoder->header.bytes > size)
+    {
+        return METEO_ARCHIVE_ERROR_FORMAT;
+    }
+    if (meteo_archive_crc32(data, decoder->header.bytes - 4U) != get_u32(data + decoder->header.bytes - 4U))
+    {
+        return METEO_ARCHIVE_ERROR_CRC;
+    }
+
+    for (i = 0; i < METEO_ARCHIVE_COLUMNS; i++)
+    {
+        decoder->column[i].data = p;
+        decoder->column[i].bits = decoder->header.column_bytes[i] * 8U;
+        decoder->column[i].pos = 0;
+        p += decoder->header.column_bytes[i];
+    }
+    for (i = 0; i < METEO_ARCHIVE_CHANNELS; i++)
+    {
+        decoder->prev_bits[i] = 0;
+        decoder->leading[i] = 0;
+        decoder->length[i] = 0;
+        decoder->run_value[i] = 0;
+        decoder->run_left[i] = 0;
+    }
+    decoder->index = 0;
+    decoder->prev_ts = 0;
+    decoder->prev_delta = 0;
+
+    return METEO_ARCHIVE_OK;
+}
+
+static int decode_ts(meteo_archive_decoder_t *decoder, int64_t *ts)
+{
+    static const uint8_t widths[4] = { 7U, 9U, 12U, 32U };
+    meteo_archive_bitreader_t *r = &decoder->column[0];
+    uint32_t prefix;
+    uint32_t bit = 1U;
+    uint32_t value;
+    int64_t dod = 0;
+
+    // 0, 10, 110, 1110, 1111
+    for (prefix = 0; prefix < 4U; prefix++)
+    {
+        if (bits_get(r, 1U, &bit) != METEO_ARCHIVE_OK)
+        {
+            return METEO_ARCHIVE_ERROR_FORMAT;
+        }
+        if (bit == 0U)
+        {
+            break;
+        }
+    }
+    if (prefix != 0U)
+    {
+        prefix = (bit == 0U) ? prefix - 1U : 3U;
+        if (bits_get(r, widths[prefix], &value) != METEO_ARCHIVE_OK)
+        {
+            return METEO_ARCHIVE_ERROR_FORMAT;
+        }
+        dod = sign_extend(value, widths[prefix]);
+    }
+
+    decoder->prev_delta += dod;
+    decoder->prev_ts += decoder->prev_delta;
+    *ts = decoder->header.chunk_start_usec + decoder->prev_ts * (int64_t)decoder->header.ts_scale_us;
+    return METEO_ARCHIVE_OK;
+}
+
+static int decode_xor(meteo_archive_decoder_t *decoder, uint32_t channel, float *value)
+{
+    meteo_archive_bitreader_t *r = &decoder->column[channel + 1U];
+    uint32_t bit;
+    uint32_t x;
+    uint32_t leading;
+    uint32_t length;
+
+    if (decoder->index == 0U)
+    {
+        if (bits_get(r, 32U, &decoder->prev_bits[channel]) != METEO_ARCHIVE_OK)
+        {
+            return METEO_ARCHIVE_ERROR_FORMAT;
+        }
+    }
+    else
+    {
+        if (bits_get(r, 1U, &bit) != METEO_ARCHIVE_OK)
+        {
+            return METEO_ARCHIVE_ERROR_FORMAT;
+        }
+        if (bit != 0U)
+        {
+            if (bits_get(r, 1U, &bit) != METEO_ARCHIVE_OK)
+            {
+                return METEO_ARCHIVE_ERROR_FORMAT;
+            }
+            if (bit != 0U)
+            {
+                if (bits_get(r, 5U, &leading) != METEO_ARCHIVE_OK ||
+                    bits_get(r, 5U, &length) != METEO_ARCHIVE_OK)
+                {
+                    return METEO_ARCHIVE_ERROR_FORMAT;
+                }
+                length++;
+                if (leading + length > 32U)
+                {
+                    return METEO_ARCHIVE_ERROR_FORMAT;
+                }
+                decoder->leading[channel] = (uint8_t)leading;
+                decoder->length[channel] = (uint8_t)length;
+            }
+            else if (decoder->length[channel] == 0U)
+            {
+                return METEO_ARCHIVE_ERROR_FORMAT;
+            }
+            if (bits_get(r, decoder->length[channel], &x) != METEO_ARCHIVE_OK)
+            {
+                return METEO_ARCHIVE_ERROR_FORMAT;
+            }
+            decoder->prev_bits[channel] ^= x << (32U - decoder->leading[channel] - decoder->length[channel]);
+        }
+    }
+
+    memcpy(value, &decoder->prev_bits[channel], sizeof(*value));
+    return METEO_ARCHIVE_OK;
+}
+
+static int decode_rle(meteo_archive_decoder_t *decoder, uint32_t channel, float *value)
+{
+    meteo_archive_bitreader_t *r = &decoder->column[channel + 1U];
+    uint64_t delta;
+    uint64_t count;
+
+    if (decoder->run_left[channel] == 0U)
+    {
+        if (bits_get_golomb(r, &delta) != METEO_ARCHIVE_OK ||
+            bits_get_golomb(r, &count) != METEO_ARCHIVE_OK ||
+            count >= 0xFFFFFFFFULL)
+        {
+            return METEO_ARCHIVE_ERROR_FORMAT;
+        }
+        decoder->run_value[channel] = (int32_t)((int64_t)decoder->run_value[channel] + unzigzag(delta));
+        decoder->run_left[channel] = (uint32_t)count + 1U;
+    }
+    decoder->run_left[channel]--;
+
+    *value = (float)decoder->run_value[channel] / (float)decoder->header.scale[channel + 1U];
+    return METEO_ARCHIVE_OK;
+}
+
+int meteo_archive_decoder_next(meteo_archive_decoder_t *decoder, meteo_archive_sample_t *sample)
+{
+    uint32_t i;
+    int status;
+
+    if (decoder->index >= decoder->header.samples)
+    {
+        return METEO_ARCHIVE_END;
+    }
+
+    status = decode_ts(decoder, &sample->ts_usec);
+    for (i = 0; i < METEO_ARCHIVE_CHANNELS && status == METEO_ARCHIVE_OK; i++)
+    {
+        if (decoder->header.codec[i + 1U] == METEO_ARCHIVE_CODEC_XOR)
+        {
+            status = decode_xor(decoder, i, &sample->value[i]);
+        }
+        else
+        {
+            status = decode_rle(decoder, i, &sample->value[i]);
+        }
+    }
+    if (status == METEO_ARCHIVE_OK)
+    {
+        decoder->index++;
+    }
+
+    return status;
+}
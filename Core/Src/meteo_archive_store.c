@@ -0,0 +1,1023 @@
+/**
+ * @brief Archive segments on OSPI flash
+ * @version 19.10.26
+ * @author R.Oliva
+ * @description Long-term readings, compressed by meteo_archive.c, in a ring
+ *              of 64 KB blocks below the frame journal. Segments are written
+ *              back to back in a block and never span two; a block is erased
+ *              when the writer enters it. At start-up:
+ *              - the newest block is found by binary search over the seq of
+ *                the first segment of each block (about 8 reads)
+ *              - its segment headers are walked to the end; a torn segment
+ *                that cannot be skipped sends the writer to the next block
+ *              Archive time is HAL_GetTick() in us, as the meteo_readings
+ *              rows, plus a base that keeps it increasing over restarts: the
+ *              chunk after the newest sample on flash. The 32-bit ms tick
+ *              wraps after 49.7 days; its wraps are counted under the archive
+ *              mutex each time the clock is read (every reading added, and
+ *              every retention step), so the time goes on past them.
+ *              The open chunk (up to METEO_ARCHIVE_CHUNK_SECONDS) is in RAM
+ *              and lost on a reset; the frame journal still has those frames.
+ *
+ *              Zone map: per block, the time range and the min/max of each
+ *              channel over its segments, updated as segments are written.
+ *              A query skips a block whose zone cannot match without reading
+ *              it, then a segment by its header (the same ranges, per chunk),
+ *              and reads only the remaining segments whole. The table (8 KB)
+ *              is in RAM and checkpointed to the last two archive blocks each
+ *              time the writer enters a block; at start-up only the blocks
+ *              written since the checkpoint are walked again.
+ *
+ *              Reads go through a cursor that keeps the segment being
+ *              decoded, so a long export reads a few samples at a time and
+ *              holds no lock in between.
+ *
+ *              Trim (meteo_retention.c): the oldest block is erased ahead of
+ *              the writer once it is past the age or byte budget, one block
+ *              per call, the archive mutex released while the flash erases.
+ *              The block is marked in RAM, so the writer enters it without
+ *              erasing it again; the DB thread then no longer waits for an
+ *              erase when it crosses a block.
+ */
+
+#include "meteo_archive_store.h"
+#include "main.h"
+#include <stdio.h>
+#include <string.h>
+
+// Header states
+#define ARCHIVE_HEADER_ERASED   0
+#define ARCHIVE_HEADER_VALID    1
+#define ARCHIVE_HEADER_BAD      2
+#define ARCHIVE_HEADER_ERROR    3
+
+#define ARCHIVE_CHECKPOINT_MAGIC    0x504D5A4DUL    // "MZMP"
+#define ARCHIVE_CHECKPOINT_SLOT     8192U           // flash bytes per checkpoint
+
+// Zone map as checkpointed: magic and crc are written last
+typedef struct
+{
+    uint32_t magic;
+    uint32_t crc;               // CRC-32 of what follows
+    uint32_t seq;               // +1 per checkpoint
+    uint32_t block;             // writer block: it and the blocks after it are walked at start-up
+    meteo_archive_zone_t zone[METEO_ARCHIVE_STORE_BLOCKS];
+} archive_checkpoint_t;
+
+#define ARCHIVE_CHECKPOINT_CRC_OFFSET   (2U * sizeof(uint32_t))
+
+static TX_MUTEX archive_mutex;
+static TX_MUTEX archive_query_mutex;
+static meteo_archive_encoder_t archive_encoder;
+static archive_checkpoint_t archive_zones;
+
+// Cursor of meteo_archive_store_query(), one query at a time
+static meteo_archive_cursor_t archive_query_cursor;
+
+// Erased by meteo_archive_store_trim() since start-up, not entered yet
+static uint8_t archive_erased[METEO_ARCHIVE_STORE_BLOCKS];
+
+static struct
+{
+    ULONG base;                 // flash address of archive block 0
+    ULONG zone_base;            // flash address of the first checkpoint block
+    ULONG block_size;
+    ULONG first_block;          // OSPI block number of archive block 0
+    uint32_t block;             // block being written
+    ULONG offset;               // next segment in it
+    uint32_t checkpoint_slot;   // next checkpoint
+    uint32_t checkpoint_slots;
+    uint32_t tick_last;         // HAL_GetTick() when the clock was last read
+    uint32_t tick_wraps;        // ... and the times it wrapped since start-up
+    meteo_archive_store_stats_t stats;
+} archive;
+
+/* Flash ---------------------------------------------------------------------*/
+
+static UINT archive_flash_read(ULONG address, void *buffer, ULONG bytes)
+{
+    UINT status;
+
+    meteo_ospi_lock();
+    status = meteo_ospi_read(address, buffer, bytes);
+    meteo_ospi_unlock();
+
+    return status;
+}
+
+/**
+ * @brief Write in METEO_ARCHIVE_STORE_WRITE pieces, the lock released between them
+ */
+static UINT archive_flash_write(ULONG address, const uint8_t *data, ULONG bytes)
+{
+    ULONG done;
+    ULONG n;
+    UINT status = TX_SUCCESS;
+
+    for (done = 0; done < bytes && status == TX_SUCCESS; done += n)
+    {
+        n = (bytes - done < METEO_ARCHIVE_STORE_WRITE) ? bytes - done : METEO_ARCHIVE_STORE_WRITE;
+        meteo_ospi_lock();
+        status = meteo_ospi_write(address + done, data + done, n);
+        meteo_ospi_unlock();
+    }
+
+    return status;
+}
+
+static UINT archive_flash_erase(ULONG block)
+{
+    UINT status;
+
+    meteo_ospi_lock();
+    status = meteo_ospi_erase_block(block);
+    meteo_ospi_unlock();
+
+    if (status == TX_SUCCESS)
+    {
+        archive.stats.erases++;
+    }
+    return status;
+}
+
+/**
+ * @brief Read and check the segment header at offset of a block
+ * @param raw METEO_ARCHIVE_HEADER_SIZE bytes, 4-byte aligned
+ */
+static UINT archive_read_header(uint32_t block, ULONG offset, uint32_t *raw, meteo_archive_header_t *header)
+{
+    UINT i;
+
+    if (offset + METEO_ARCHIVE_HEADER_SIZE > archive.block_size)
+    {
+        return ARCHIVE_HEADER_ERASED;
+    }
+
+    if (archive_flash_read(archive.base + block * archive.block_size + offset, raw,
+                           METEO_ARCHIVE_HEADER_SIZE) != TX_SUCCESS)
+    {
+        return ARCHIVE_HEADER_ERROR;
+    }
+
+    if (meteo_archive_header_read((const uint8_t *)raw, METEO_ARCHIVE_HEADER_SIZE, header) == METEO_ARCHIVE_OK &&
+        offset + header->bytes <= archive.block_size)
+    {
+        return ARCHIVE_HEADER_VALID;
+    }
+
+    for (i = 0; i < METEO_ARCHIVE_HEADER_SIZE / sizeof(uint32_t) && raw[i] == 0xFFFFFFFFUL; i++)
+    {
+    }
+
+    return (i == METEO_ARCHIVE_HEADER_SIZE / sizeof(uint32_t)) ? ARCHIVE_HEADER_ERASED : ARCHIVE_HEADER_BAD;
+}
+
+static UINT archive_open_header(uint32_t block, ULONG offset, meteo_archive_header_t *header)
+{
+    uint32_t raw[METEO_ARCHIVE_HEADER_SIZE / sizeof(uint32_t)];
+
+    archive.stats.open_reads++;
+    return archive_read_header(block, offset, raw, header);
+}
+
+/* Zone map ------------------------------------------------------------------*/
+
+static void archive_zone_add(meteo_archive_zone_t *zone, const meteo_archive_header_t *header)
+{
+    uint32_t i;
+
+    if (zone->segments == 0U)
+    {
+        zone->first_seq = header->seq;
+        zone->ts_min_usec = header->ts_min_usec;
+        zone->ts_max_usec = header->ts_max_usec;
+        for (i = 0; i < METEO_ARCHIVE_CHANNELS; i++)
+        {
+            zone->min[i] = header->range[i].min;
+            zone->max[i] = header->range[i].max;
+        }
+    }
+    else
+    {
+        if (header->ts_min_usec < zone->ts_min_usec)
+        {
+            zone->ts_min_usec = header->ts_min_usec;
+        }
+        if (header->ts_max_usec > zone->ts_max_usec)
+        {
+            zone->ts_max_usec = header->ts_max_usec;
+        }
+        for (i = 0; i < METEO_ARCHIVE_CHANNELS; i++)
+        {
+            if (header->range[i].min < zone->min[i])
+            {
+                zone->min[i] = header->range[i].min;
+            }
+            if (header->range[i].max > zone->max[i])
+            {
+                zone->max[i] = header->range[i].max;
+            }
+        }
+    }
+    zone->segments++;
+}
+
+/**
+ * @brief Can a block or segment with these ranges hold a matching sample
+ */
+static UINT archive_zone_match(const meteo_archive_query_t *query, int64_t ts_min, int64_t ts_max,
+                               float min, float max)
+{
+    if (ts_max < query->from_usec || ts_min > query->to_usec)
+    {
+        return 0;
+    }
+
+    return query->channel >= METEO_ARCHIVE_CHANNELS || (max >= query->min && min <= query->max);
+}
+
+/**
+ * @brief Walk the segment headers of a block into its zone map entry
+ * @param end Offset after the last segment (block size after a torn header)
+ * @param last seq of the last segment, unchanged when there is none
+ */
+static UINT archive_walk_block(uint32_t block, ULONG *end, uint32_t *last)
+{
+    meteo_archive_header_t header;
+    ULONG offset = 0;
+    UINT state;
+
+    memset(&archive_zones.zone[block], 0, sizeof(archive_zones.zone[block]));
+    archive.stats.zones_rebuilt++;
+
+    while ((state = archive_open_header(block, offset, &header)) == ARCHIVE_HEADER_VALID)
+    {
+        archive_zone_add(&archive_zones.zone[block], &header);
+        *last = header.seq;
+        offset += header.bytes;
+    }
+    if (state == ARCHIVE_HEADER_BAD)
+    {
+        // Torn header: its length is unknown, nothing more fits
+        offset = archive.block_size;
+    }
+
+    *end = offset;
+    return (state == ARCHIVE_HEADER_ERROR) ? TX_NOT_DONE : TX_SUCCESS;
+}
+
+static ULONG archive_checkpoint_address(uint32_t slot)
+{
+    uint32_t per_block = archive.checkpoint_slots / METEO_ARCHIVE_ZONE_BLOCKS;
+
+    return archive.zone_base + (slot / per_block) * archive.block_size + (slot % per_block) * ARCHIVE_CHECKPOINT_SLOT;
+}
+
+/**
+ * @brief Write the zone map to the next checkpoint slot, erasing the
+ *        checkpoint block when the slot starts one
+ */
+static UINT archive_checkpoint_write(void)
+{
+    uint32_t per_block = archive.checkpoint_slots / METEO_ARCHIVE_ZONE_BLOCKS;
+    uint32_t slot = archive.checkpoint_slot % archive.checkpoint_slots;
+    ULONG address = archive_checkpoint_address(slot);
+
+    if ((slot % per_block) == 0U &&
+        archive_flash_erase(archive.first_block + METEO_ARCHIVE_STORE_BLOCKS + slot / per_block) != TX_SUCCESS)
+    {
+        return TX_NOT_DONE;
+    }
+    archive.checkpoint_slot = slot + 1U;
+
+    archive_zones.magic = ARCHIVE_CHECKPOINT_MAGIC;
+    archive_zones.seq++;
+    archive_zones.block = archive.block;
+    archive_zones.crc = meteo_archive_crc32((const uint8_t *)&archive_zones + ARCHIVE_CHECKPOINT_CRC_OFFSET,
+                                            sizeof(archive_zones) - ARCHIVE_CHECKPOINT_CRC_OFFSET);
+
+    // Table first, magic last: a torn checkpoint is never taken
+    if (archive_flash_write(address + ARCHIVE_CHECKPOINT_CRC_OFFSET,
+                            (const uint8_t *)&archive_zones + ARCHIVE_CHECKPOINT_CRC_OFFSET,
+                            sizeof(archive_zones) - ARCHIVE_CHECKPOINT_CRC_OFFSET) != TX_SUCCESS ||
+        archive_flash_write(address, (const uint8_t *)&archive_zones, ARCHIVE_CHECKPOINT_CRC_OFFSET) != TX_SUCCESS)
+    {
+        return TX_NOT_DONE;
+    }
+
+    archive.stats.checkpoints++;
+    return TX_SUCCESS;
+}
+
+/**
+ * @brief Load the newest good checkpoint
+ * @return 1 when one was loaded, else the zone map is empty
+ */
+static UINT archive_checkpoint_load(void)
+{
+    uint32_t head[4];
+    uint32_t tried = 0;
+    uint32_t limit = 0xFFFFFFFFUL;
+    uint32_t best;
+    uint32_t best_seq;
+    uint32_t slot;
+
+    while (tried++ < archive.checkpoint_slots)
+    {
+        // Newest seq below the last one tried
+        best = archive.checkpoint_slots;
+        best_seq = 0;
+        for (slot = 0; slot < archive.checkpoint_slots; slot++)
+        {
+            archive.stats.open_reads++;
+            if (archive_flash_read(archive_checkpoint_address(slot), head, sizeof(head)) == TX_SUCCESS &&
+                head[0] == ARCHIVE_CHECKPOINT_MAGIC && head[3] < METEO_ARCHIVE_STORE_BLOCKS &&
+                head[2] < limit && (best == archive.checkpoint_slots || head[2] > best_seq))
+            {
+                best = slot;
+                best_seq = head[2];
+            }
+        }
+        if (best == archive.checkpoint_slots)
+        {
+            break;
+        }
+        limit = best_seq;
+
+        archive.stats.open_reads++;
+        if (archive_flash_read(archive_checkpoint_address(best), &archive_zones, sizeof(archive_zones)) == TX_SUCCESS &&
+            archive_zones.crc == meteo_archive_crc32((const uint8_t *)&archive_zones + ARCHIVE_CHECKPOINT_CRC_OFFSET,
+                                                     sizeof(archive_zones) - ARCHIVE_CHECKPOINT_CRC_OFFSET))
+        {
+            archive.checkpoint_slot = best + 1U;
+            return 1;
+        }
+    }
+
+    memset(&archive_zones, 0, sizeof(archive_zones));
+    archive.checkpoint_slot = 0;
+    return 0;
+}
+
+/* Writer --------------------------------------------------------------------*/
+
+/**
+ * @brief Archive time of the current tick, the tick extended to 64 bits by
+ *        counting its wraps. Under archive_mutex; correct as long as it is
+ *        read at least once per wrap.
+ */
+static int64_t archive_clock_usec(void)
+{
+    uint32_t tick = HAL_GetTick();
+
+    if (tick < archive.tick_last)
+    {
+        archive.tick_wraps++;
+    }
+    archive.tick_last = tick;
+
+    return archive.stats.time_base_usec + (int64_t)(((uint64_t)archive.tick_wraps << 32) | tick) * 1000;
+}
+
+/**
+ * @brief Erase the next block, unless trimmed already, and move the writer there
+ */
+static UINT archive_next_block(void)
+{
+    uint32_t next;
+
+    archive.block = (archive.block + 1U) % METEO_ARCHIVE_STORE_BLOCKS;
+    archive.offset = 0;
+
+    if (archive_erased[archive.block])
+    {
+        archive_erased[archive.block] = 0;
+        archive.stats.preerased++;
+    }
+    else if (archive_flash_erase(archive.first_block + archive.block) != TX_SUCCESS)
+    {
+        // Not usable: try the one after it with the next segment
+        archive.offset = archive.block_size;
+        return TX_NOT_DONE;
+    }
+
+    // Segments in the erased block are gone
+    memset(&archive_zones.zone[archive.block], 0, sizeof(archive_zones.zone[archive.block]));
+    next = (archive.block + 1U) % METEO_ARCHIVE_STORE_BLOCKS;
+    if (archive_zones.zone[next].segments != 0U)
+    {
+        archive.stats.oldest = archive_zones.zone[next].first_seq;
+    }
+
+    // A failed checkpoint only costs more walking at start-up
+    (void)archive_checkpoint_write();
+    return TX_SUCCESS;
+}
+
+/**
+ * @brief Encoder sink: write a sealed segment at the end of the ring
+ */
+static int archive_sink(void *context, const uint8_t *segment, uint32_t bytes)
+{
+    meteo_archive_header_t header;
+    UINT status;
+
+    (void)context;
+
+    if (archive.offset + bytes > archive.block_size && archive_next_block() != TX_SUCCESS)
+    {
+        archive.stats.write_errors++;
+        return -1;
+    }
+
+    status = archive_flash_write(archive.base + archive.block * archive.block_size + archive.offset,
+                                 segment, bytes);
+
+    // The space is used even if the write failed
+    archive.offset += bytes;
+    if (status != TX_SUCCESS)
+    {
+        archive.stats.write_errors++;
+        return -1;
+    }
+
+    if (meteo_archive_header_read(segment, bytes, &header) == METEO_ARCHIVE_OK)
+    {
+        archive_zone_add(&archive_zones.zone[archive.block], &header);
+    }
+    archive.stats.segments++;
+    archive.stats.bytes += bytes;
+    return 0;
+}
+
+/**
+ * @brief Newest block by binary search (blocks of the current lap have a
+ *        first seq at or above block 0's). Without block 0 (erased or torn
+ *        on the way round, or trimmed) the blocks in use are one run that
+ *        does not wrap: the search starts at its first block, found by a
+ *        scan.
+ * @param head Newest block, METEO_ARCHIVE_STORE_BLOCKS when empty
+ */
+static UINT archive_find_head(uint32_t *head)
+{
+    meteo_archive_header_t header;
+    uint32_t first0;
+    uint32_t lo;
+    uint32_t hi;
+    uint32_t mid;
+    UINT state;
+
+    for (lo = 0; lo < METEO_ARCHIVE_STORE_BLOCKS; lo++)
+    {
+        state = archive_open_header(lo, 0, &header);
+        if (state == ARCHIVE_HEADER_ERROR)
+        {
+            return TX_NOT_DONE;
+        }
+        if (state == ARCHIVE_HEADER_VALID)
+        {
+            break;
+        }
+    }
+
+    if (lo < METEO_ARCHIVE_STORE_BLOCKS)
+    {
+        first0 = header.seq;
+        hi = METEO_ARCHIVE_STORE_BLOCKS - 1U;
+        while (lo < hi)
+        {
+            mid = (lo + hi + 1U) / 2U;
+            state = archive_open_header(mid, 0, &header);
+            if (state == ARCHIVE_HEADER_ERROR)
+            {
+                return TX_NOT_DONE;
+            }
+            if (state == ARCHIVE_HEADER_VALID && header.seq >= first0)
+            {
+                lo = mid;
+            }
+            else
+            {
+                hi = mid - 1U;
+            }
+        }
+        *head = lo;
+    }
+    else
+    {
+        *head = METEO_ARCHIVE_STORE_BLOCKS;
+    }
+
+    return TX_SUCCESS;
+}
+
+/**
+ * @brief Head, zone map and oldest segment at start-up
+ */
+static UINT archive_find_end(void)
+{
+    uint32_t loaded = archive_checkpoint_load();
+    uint32_t last = 0;
+    uint32_t head;
+    uint32_t block;
+    uint32_t i;
+    ULONG end = 0;
+
+    if (archive_find_head(&head) != TX_SUCCESS)
+    {
+        return TX_NOT_DONE;
+    }
+
+    if (head == METEO_ARCHIVE_STORE_BLOCKS)
+    {
+        // Empty: the first segment erases block 0
+        memset(archive_zones.zone, 0, sizeof(archive_zones.zone));
+        archive.block = METEO_ARCHIVE_STORE_BLOCKS - 1U;
+        archive.offset = archive.block_size;
+        archive.stats.next_seq = 0;
+        archive.stats.oldest = 0;
+        return TX_SUCCESS;
+    }
+
+    // Walk the blocks written since the checkpoint, all of them without one
+    block = loaded ? archive_zones.block : (head + 1U) % METEO_ARCHIVE_STORE_BLOCKS;
+    for (;;)
+    {
+        if (archive_walk_block(block, &end, &last) != TX_SUCCESS)
+        {
+            return TX_NOT_DONE;
+        }
+        if (block == head)
+        {
+            break;
+        }
+        block = (block + 1U) % METEO_ARCHIVE_STORE_BLOCKS;
+    }
+    archive.block = head;
+    archive.offset = end;
+    archive.stats.next_seq = last + 1U;
+
+    // Oldest: first non-empty block after the newest
+    for (i = 1; i <= METEO_ARCHIVE_STORE_BLOCKS; i++)
+    {
+        block = (head + i) % METEO_ARCHIVE_STORE_BLOCKS;
+        if (archive_zones.zone[block].segments != 0U)
+        {
+            archive.stats.oldest = archive_zones.zone[block].first_seq;
+            break;
+        }
+    }
+
+    // Archive time goes on from the chunk after the newest sample
+    archive.stats.time_base_usec = archive_zones.zone[head].ts_max_usec;
+
+    if (archive.stats.zones_rebuilt > 1U)
+    {
+        (void)archive_checkpoint_write();
+    }
+    return TX_SUCCESS;
+}
+
+/* Reader --------------------------------------------------------------------*/
+
+/**
+ * @brief Next matching sample of a cursor. Oldest block first, the one being
+ *        written when the cursor was opened last. A block whose zone cannot
+ *        match is skipped unread, a segment by its header; the others are
+ *        read whole into the cursor and decoded.
+ * @return TX_SUCCESS with a sample, or with cursor->done set at the end;
+ *         TX_NOT_DONE on a flash error, which ends the cursor
+ */
+static UINT archive_cursor_next(meteo_archive_cursor_t *cursor, meteo_archive_sample_t *sample)
+{
+    const meteo_archive_query_t *query = &cursor->query;
+    uint8_t *segment = (uint8_t *)cursor->segment;
+    uint32_t channel = (query->channel < METEO_ARCHIVE_CHANNELS) ? query->channel : 0U;
+    meteo_archive_header_t header;
+    meteo_archive_zone_t zone;
+    uint32_t block;
+    ULONG offset;
+    UINT state;
+    int result;
+
+    while (!cursor->done)
+    {
+        if (cursor->decoding)
+        {
+            while ((result = meteo_archive_decoder_next(&cursor->decoder, sample)) == METEO_ARCHIVE_OK)
+            {
+                cursor->stats.samples++;
+                if (sample->ts_usec >= query->from_usec && sample->ts_usec <= query->to_usec &&
+                    (query->channel >= METEO_ARCHIVE_CHANNELS ||
+                     (sample->value[channel] >= query->min && sample->value[channel] <= query->max)))
+                {
+                    cursor->stats.matched++;
+                    return TX_SUCCESS;
+                }
+            }
+            if (result < 0)
+            {
+                cursor->stats.segments_bad++;
+            }
+            cursor->decoding = 0;
+        }
+
+        if (!cursor->in_block)
+        {
+            if (cursor->step == METEO_ARCHIVE_STORE_BLOCKS)
+            {
+                cursor->done = 1;
+                break;
+            }
+            cursor->step++;
+            block = (cursor->head + cursor->step) % METEO_ARCHIVE_STORE_BLOCKS;
+
+            tx_mutex_get(&archive_mutex, TX_WAIT_FOREVER);
+            zone = archive_zones.zone[block];
+            tx_mutex_put(&archive_mutex);
+
+            if (zone.segments == 0U ||
+                !archive_zone_match(query, zone.ts_min_usec, zone.ts_max_usec, zone.min[channel], zone.max[channel]))
+            {
+                cursor->stats.blocks_skipped++;
+                continue;
+            }
+            cursor->stats.blocks_read++;
+            cursor->in_block = 1;
+            cursor->offset = 0;
+        }
+
+        block = (cursor->head + cursor->step) % METEO_ARCHIVE_STORE_BLOCKS;
+        offset = cursor->offset;
+        state = archive_read_header(block, offset, cursor->segment, &header);
+        cursor->stats.bytes_read += METEO_ARCHIVE_HEADER_SIZE;
+        if (state != ARCHIVE_HEADER_VALID)
+        {
+            // End of the block; a segment erased under us fails its CRC
+            cursor->in_block = 0;
+            if (state == ARCHIVE_HEADER_ERROR)
+            {
+                cursor->done = 1;
+                return TX_NOT_DONE;
+            }
+            continue;
+        }
+        cursor->offset += header.bytes;
+
+        if (!archive_zone_match(query, header.ts_min_usec, header.ts_max_usec,
+                                header.range[channel].min, header.range[channel].max))
+        {
+            cursor->stats.segments_skipped++;
+            continue;
+        }
+
+        if (archive_flash_read(archive.base + block * archive.block_size + offset + METEO_ARCHIVE_HEADER_SIZE,
+                               segment + METEO_ARCHIVE_HEADER_SIZE,
+                               header.bytes - METEO_ARCHIVE_HEADER_SIZE) != TX_SUCCESS)
+        {
+            cursor->done = 1;
+            return TX_NOT_DONE;
+        }
+        cursor->stats.bytes_read += header.bytes - METEO_ARCHIVE_HEADER_SIZE;
+
+        if (meteo_archive_decoder_init(&cursor->decoder, segment, header.bytes) != METEO_ARCHIVE_OK)
+        {
+            cursor->stats.segments_bad++;
+            continue;
+        }
+        cursor->stats.segments_read++;
+        cursor->decoding = 1;
+    }
+
+    return TX_SUCCESS;
+}
+
+/* API -----------------------------------------------------------------------*/
+
+void meteo_archive_store_init(void)
+{
+    if (tx_mutex_create(&archive_mutex, "METEO Archive Mutex", TX_INHERIT) != TX_SUCCESS ||
+        tx_mutex_create(&archive_query_mutex, "METEO Archive Query", TX_INHERIT) != TX_SUCCESS)
+    {
+        printf("[ARCHIVE] Create failed\n");
+    }
+}
+
+UINT meteo_archive_store_open(void)
+{
+    ULONG block_size;
+    ULONG total_blocks;
+    int64_t chunk_usec;
+    UINT status;
+
+    if (meteo_ospi_get_info(&block_size, &total_blocks) != TX_SUCCESS ||
+        total_blocks <= METEO_OSPI_RESERVED_BLOCKS ||
+        block_size < METEO_ARCHIVE_SEGMENT_MAX || block_size < ARCHIVE_CHECKPOINT_SLOT ||
+        sizeof(archive_checkpoint_t) > ARCHIVE_CHECKPOINT_SLOT)
+    {
+        printf("[ARCHIVE] No OSPI geometry\n");
+        return TX_NOT_DONE;
+    }
+
+    tx_mutex_get(&archive_mutex, TX_WAIT_FOREVER);
+
+    memset(&archive.stats, 0, sizeof(archive.stats));
+    memset(archive_erased, 0, sizeof(archive_erased));
+    archive.tick_last = 0U;
+    archive.tick_wraps = 0U;
+    archive.block_size = block_size;
+    archive.first_block = total_blocks - METEO_OSPI_RESERVED_BLOCKS;
+    archive.base = archive.first_block * block_size;
+    archive.zone_base = archive.base + METEO_ARCHIVE_STORE_BLOCKS * block_size;
+    archive.checkpoint_slots = METEO_ARCHIVE_ZONE_BLOCKS * (block_size / ARCHIVE_CHECKPOINT_SLOT);
+
+    status = archive_find_end();
+    if (status == TX_SUCCESS)
+    {
+        meteo_archive_encoder_init(&archive_encoder, METEO_ARCHIVE_CHUNK_SECONDS, METEO_ARCHIVE_TS_SCALE_US,
+                                   archive.stats.next_seq, archive_sink, NULL);
+        chunk_usec = archive_encoder.chunk_usec;
+        if (archive.stats.time_base_usec != 0)
+        {
+            archive.stats.time_base_usec = (archive.stats.time_base_usec / chunk_usec + 1) * chunk_usec;
+        }
+    }
+    archive.stats.opened = (status == TX_SUCCESS);
+
+    tx_mutex_put(&archive_mutex);
+
+    if (status != TX_SUCCESS)
+    {
+        printf("[ARCHIVE] Open failed - flash error\n");
+        return status;
+    }
+
+    printf("[ARCHIVE] Blocks %lu-%lu: segments %lu..%lu, time base %lu s (%lu reads, %lu blocks walked)\n",
+           (unsigned long)archive.first_block,
+           (unsigned long)(archive.first_block + METEO_OSPI_ARCHIVE_BLOCKS - 1U),
+           (unsigned long)archive.stats.oldest, (unsigned long)archive.stats.next_seq,
+           (unsigned long)(archive.stats.time_base_usec / 1000000),
+           (unsigned long)archive.stats.open_reads, (unsigned long)archive.stats.zones_rebuilt);
+
+    return TX_SUCCESS;
+}
+
+UINT meteo_archive_store_parse_frame(const char *frame, meteo_archive_sample_t *sample)
+{
+    unsigned int temp;
+    unsigned int pressure;
+    unsigned int wind_dir;
+    unsigned int wind_speed;
+    unsigned int voltage;
+
+    // Format: UUU$ttttt.bbbbb.dddd.sssss.vvv.CRCC*QQQ, scaled as in ProcessMeteoFrameToStream
+    if (sscanf(frame, "UUU$%5u.%5u.%4u.%5u.%3u",
+               &temp, &pressure, &wind_dir, &wind_speed, &voltage) != 5)
+    {
+        return TX_SIZE_ERROR;
+    }
+
+    sample->ts_usec = 0;
+    sample->value[METEO_ARCHIVE_TEMPERATURE] = (float)temp / 100.0f;
+    sample->value[METEO_ARCHIVE_PRESSURE] = (float)pressure / 10.0f;
+    sample->value[METEO_ARCHIVE_WIND_SPEED] = (float)wind_speed / 10.0f;
+    sample->value[METEO_ARCHIVE_WIND_DIRECTION] = (float)wind_dir / 10.0f;
+    sample->value[METEO_ARCHIVE_VOLTAGE] = (float)voltage;
+
+    return TX_SUCCESS;
+}
+
+UINT meteo_archive_store_add(meteo_archive_sample_t *sample)
+{
+    UINT status = TX_SUCCESS;
+
+    tx_mutex_get(&archive_mutex, TX_WAIT_FOREVER);
+
+    if (!archive.stats.opened)
+    {
+        tx_mutex_put(&archive_mutex);
+        return TX_NOT_AVAILABLE;
+    }
+
+    // 19.10.26 The DB thread stamps it once for the stream and the archive
+    if (sample->ts_usec == 0)
+    {
+        sample->ts_usec = archive_clock_usec();
+    }
+    if (meteo_archive_encoder_add(&archive_encoder, sample) != METEO_ARCHIVE_OK)
+    {
+        status = TX_NOT_DONE;
+    }
+    archive.stats.samples++;
+    archive.stats.next_seq = archive_encoder.next_seq;
+
+    tx_mutex_put(&archive_mutex);
+
+    return status;
+}
+
+UINT meteo_archive_store_add_frame(const char *frame)
+{
+    meteo_archive_sample_t sample;
+    UINT status;
+
+    status = meteo_archive_store_parse_frame(frame, &sample);
+    if (status == TX_SUCCESS)
+    {
+        status = meteo_archive_store_add(&sample);
+    }
+
+    return status;
+}
+
+UINT meteo_archive_store_flush(void)
+{
+    UINT status = TX_SUCCESS;
+
+    tx_mutex_get(&archive_mutex, TX_WAIT_FOREVER);
+
+    if (!archive.stats.opened)
+    {
+        status = TX_NOT_AVAILABLE;
+    }
+    else
+    {
+        if (meteo_archive_encoder_flush(&archive_encoder) != METEO_ARCHIVE_OK)
+        {
+            status = TX_NOT_DONE;
+        }
+        archive.stats.next_seq = archive_encoder.next_seq;
+    }
+
+    tx_mutex_put(&archive_mutex);
+
+    return status;
+}
+
+UINT meteo_archive_store_query(const meteo_archive_query_t *query, meteo_archive_query_cb_t callback,
+                               void *context, meteo_archive_query_stats_t *stats)
+{
+    meteo_archive_sample_t sample;
+    UINT status;
+
+    tx_mutex_get(&archive_query_mutex, TX_WAIT_FOREVER);
+
+    status = meteo_archive_store_cursor_open(&archive_query_cursor, query);
+    while (status == TX_SUCCESS && (status = archive_cursor_next(&archive_query_cursor, &sample)) == TX_SUCCESS &&
+           !archive_query_cursor.done)
+    {
+        if (callback(context, &sample) != 0)
+        {
+            break;
+        }
+    }
+
+    if (stats != NULL)
+    {
+        *stats = archive_query_cursor.stats;
+    }
+
+    tx_mutex_put(&archive_query_mutex);
+
+    return status;
+}
+
+UINT meteo_archive_store_cursor_open(meteo_archive_cursor_t *cursor, const meteo_archive_query_t *query)
+{
+    UINT status = TX_SUCCESS;
+
+    memset(&cursor->stats, 0, sizeof(cursor->stats));
+    cursor->query = *query;
+    cursor->step = 0;
+    cursor->offset = 0;
+    cursor->in_block = 0;
+    cursor->decoding = 0;
+
+    tx_mutex_get(&archive_mutex, TX_WAIT_FOREVER);
+    cursor->head = archive.block;
+    if (!archive.stats.opened)
+    {
+        status = TX_NOT_AVAILABLE;
+    }
+    tx_mutex_put(&archive_mutex);
+
+    cursor->done = (status != TX_SUCCESS);
+    return status;
+}
+
+UINT meteo_archive_store_read(meteo_archive_cursor_t *cursor, meteo_archive_sample_t *samples,
+                              UINT max, UINT *count)
+{
+    UINT status = TX_SUCCESS;
+    UINT n;
+
+    for (n = 0; n < max; n++)
+    {
+        status = archive_cursor_next(cursor, &samples[n]);
+        if (status != TX_SUCCESS || cursor->done)
+        {
+            break;
+        }
+    }
+
+    *count = n;
+    return status;
+}
+
+UINT meteo_archive_store_trim(int64_t before_usec, ULONG max_bytes, ULONG *bytes)
+{
+    uint32_t block = METEO_ARCHIVE_STORE_BLOCKS;
+    uint32_t used = 1U;
+    uint32_t next;
+    uint32_t i;
+    UINT status;
+
+    *bytes = 0;
+    tx_mutex_get(&archive_mutex, TX_WAIT_FOREVER);
+
+    if (!archive.stats.opened)
+    {
+        tx_mutex_put(&archive_mutex);
+        return TX_NOT_AVAILABLE;
+    }
+
+    // Oldest block in use after the writer, and the blocks in use with it
+    for (i = 1; i < METEO_ARCHIVE_STORE_BLOCKS; i++)
+    {
+        next = (archive.block + i) % METEO_ARCHIVE_STORE_BLOCKS;
+        if (archive_zones.zone[next].segments != 0U)
+        {
+            block = (block == METEO_ARCHIVE_STORE_BLOCKS) ? next : block;
+            used++;
+        }
+    }
+    if (block == METEO_ARCHIVE_STORE_BLOCKS ||
+        (archive_zones.zone[block].ts_max_usec >= before_usec && used * archive.block_size <= max_bytes))
+    {
+        tx_mutex_put(&archive_mutex);
+        return TX_SUCCESS;
+    }
+
+    // Gone for the readers from here; a cursor in it fails the CRC
+    memset(&archive_zones.zone[block], 0, sizeof(archive_zones.zone[block]));
+    for (next = (block + 1U) % METEO_ARCHIVE_STORE_BLOCKS;
+         next != archive.block && archive_zones.zone[next].segments == 0U;
+         next = (next + 1U) % METEO_ARCHIVE_STORE_BLOCKS)
+    {
+    }
+    archive.stats.oldest = (archive_zones.zone[next].segments != 0U) ? archive_zones.zone[next].first_seq
+                                                                     : archive.stats.next_seq;
+
+    // Taken before the mutex is released: a writer entering the block
+    // erases it again after this erase, not before it
+    meteo_ospi_lock();
+    tx_mutex_put(&archive_mutex);
+    status = meteo_ospi_erase_block(archive.first_block + block);
+    meteo_ospi_unlock();
+
+    tx_mutex_get(&archive_mutex, TX_WAIT_FOREVER);
+    if (status == TX_SUCCESS)
+    {
+        archive.stats.erases++;
+        archive.stats.trimmed++;
+        archive_erased[block] = (block != archive.block);
+        *bytes = archive.block_size;
+    }
+    // A failed checkpoint only costs more walking at start-up
+    (void)archive_checkpoint_write();
+    tx_mutex_put(&archive_mutex);
+
+    return (status == TX_SUCCESS) ? TX_SUCCESS : TX_NOT_DONE;
+}
+
+int64_t meteo_archive_store_now(void)
+{
+    int64_t now;
+
+    tx_mutex_get(&archive_mutex, TX_WAIT_FOREVER);
+    now = archive_clock_usec();
+    tx_mutex_put(&archive_mutex);
+
+    return now;
+}
+
+UINT meteo_archive_store_get_zone(uint32_t block, meteo_archive_zone_t *zone)
+{
+    if (block >= METEO_ARCHIVE_STORE_BLOCKS)
+    {
+        return TX_SIZE_ERROR;
+    }
+
+    tx_mutex_get(&archive_mutex, TX_WAIT_FOREVER);
+    *zone = archive_zones.zone[block];
+    tx_mutex_put(&archive_mutex);
+
+    return TX_SUCCESS;
+}
+
+void meteo_archive_store_get_stats(meteo_archive_store_stats_t *stats)
+{
+    // Snapshot for display, not locked
+    *stats = archive.stats;
+    stats->pending = meteo_archive_encoder_pending(&archive_encoder, &stats->pending_bits);
+}
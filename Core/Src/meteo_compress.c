@@ -0,0 +1,329 @@
+/**
+ * @brief Deadband and swinging-door compression of the readings
+ * @version 19.10.26
+ * @author R.Oliva
+ * @description Temperature and the others change slowly, yet every 1 Hz
+ *              reading went into the stream, the meteo_readings table and
+ *              the sync to Analitica, also when it was the same as the one
+ *              before. The DB thread now passes each reading through
+ *              meteo_compress_apply() and stores only the rows it keeps.
+ *              Per channel:
+ *              - deadband: keep a reading when it is more than tolerance
+ *                from the last kept one; holding the kept value is then
+ *                never further than tolerance from a reading
+ *              - swinging door (E. H. Bristol, 1990): keep the previous
+ *                reading when no line from the last kept point passes
+ *                within tolerance of all of them; interpolating between
+ *                kept points is then never further than tolerance
+ *              - off: every reading
+ *              and a heartbeat: a row at least every heartbeat_s, so a
+ *              quiet channel still shows it is alive.
+ *              The door is two slopes, so a channel is O(1) and 40 bytes.
+ *              A swinging-door reading is kept on the door, not as read:
+ *              as read, the line to it may miss an earlier one by up to
+ *              twice the tolerance.
+ *              The archive still gets every reading (its codecs are
+ *              lossless and a steady value costs a few bits there), as do
+ *              the NanoEdge window and the statistics.
+ */
+
+#include "meteo_compress.h"
+#include <math.h>
+#include <stdio.h>
+#include <string.h>
+
+/* Channel -------------------------------------------------------------------*/
+
+static void compress_open_door(meteo_compress_t *channel)
+{
+    channel->slope_min = -INFINITY;
+    channel->slope_max = INFINITY;
+}
+
+void meteo_compress_reset(meteo_compress_t *channel)
+{
+    memset(channel, 0, sizeof(*channel));
+    compress_open_door(channel);
+}
+
+meteo_compress_action_t meteo_compress_check(const meteo_compress_t *channel,
+                                             const meteo_compress_config_t *config,
+                                             int64_t ts_usec, float value)
+{
+    int64_t elapsed = ts_usec - channel->anchor_usec;
+    float change = value - channel->anchor;
+    float seconds;
+
+    if (!channel->anchored || config->mode == METEO_COMPRESS_OFF)
+    {
+        return METEO_COMPRESS_KEEP;
+    }
+
+    if (config->mode == METEO_COMPRESS_SWINGING_DOOR && channel->holding && elapsed > 0)
+    {
+        seconds = (float)elapsed * 1e-6f;
+        if (fmaxf(channel->slope_min, (change - config->tolerance) / seconds) >
+            fminf(channel->slope_max, (change + config->tolerance) / seconds))
+        {
+            return METEO_COMPRESS_HELD;
+        }
+    }
+    else if (config->mode == METEO_COMPRESS_DEADBAND)
+    {
+        if (config->circular)
+        {
+            change = fmodf(change, 360.0f);
+            change = (change > 180.0f) ? change - 360.0f : (change < -180.0f) ? change + 360.0f : change;
+        }
+        if (fabsf(change) > config->tolerance)
+        {
+            return METEO_COMPRESS_KEEP;
+        }
+    }
+
+    if (config->heartbeat_s != 0U && elapsed >= (int64_t)config->heartbeat_s * 1000000)
+    {
+        return METEO_COMPRESS_KEEP;
+    }
+    return METEO_COMPRESS_SKIP;
+}
+
+float meteo_compress_keep_held(meteo_compress_t *channel, const meteo_compress_config_t *config)
+{
+    float seconds = (float)(channel->held_usec - channel->anchor_usec) * 1e-6f;
+    float value = channel->held;
+
+    if (config->mode == METEO_COMPRESS_SWINGING_DOOR && seconds > 0.0f)
+    {
+        // The slope to the reading, clamped into the door
+        float slope = (value - channel->anchor) / seconds;
+
+        slope = fminf(fmaxf(slope, channel->slope_min), channel->slope_max);
+        value = channel->anchor + slope * seconds;
+    }
+
+    channel->anchor_usec = channel->held_usec;
+    channel->anchor = value;
+    channel->holding = 0U;
+    compress_open_door(channel);
+
+    return value;
+}
+
+void meteo_compress_drop(meteo_compress_t *channel, const meteo_compress_config_t *config,
+                         int64_t ts_usec, float value)
+{
+    float seconds = (float)(ts_usec - channel->anchor_usec) * 1e-6f;
+    float change = value - channel->anchor;
+
+    channel->held_usec = ts_usec;
+    channel->held = value;
+    channel->holding = 1U;
+    if (config->mode == METEO_COMPRESS_SWINGING_DOOR && seconds > 0.0f)
+    {
+        channel->slope_min = fmaxf(channel->slope_min, (change - config->tolerance) / seconds);
+        channel->slope_max = fminf(channel->slope_max, (change + config->tolerance) / seconds);
+    }
+}
+
+float meteo_compress_keep(meteo_compress_t *channel, const meteo_compress_config_t *config,
+                          int64_t ts_usec, float value)
+{
+    if (!channel->anchored)
+    {
+        channel->anchor_usec = ts_usec;
+        channel->anchor = value;
+        channel->anchored = 1U;
+        channel->holding = 0U;
+        compress_open_door(channel);
+        return value;
+    }
+    // Also kept when another channel needed the row: on the door with it
+    meteo_compress_drop(channel, config, ts_usec, value);
+    return meteo_compress_keep_held(channel, config);
+}
+
+uint32_t meteo_compress_add(meteo_compress_t *channel, const meteo_compress_config_t *config,
+                            int64_t ts_usec, float value, int64_t points_usec[2], float points[2])
+{
+    meteo_compress_action_t action = meteo_compress_check(channel, config, ts_usec, value);
+    uint32_t kept = 0U;
+
+    if (action == METEO_COMPRESS_HELD)
+    {
+        points_usec[0] = channel->held_usec;
+        points[0] = meteo_compress_keep_held(channel, config);
+        kept = 1U;
+        action = meteo_compress_check(channel, config, ts_usec, value);
+    }
+    if (action == METEO_COMPRESS_KEEP)
+    {
+        points_usec[kept] = ts_usec;
+        points[kept] = meteo_compress_keep(channel, config, ts_usec, value);
+        kept++;
+    }
+    else
+    {
+        meteo_compress_drop(channel, config, ts_usec, value);
+    }
+
+    return kept;
+}
+
+/* Stage ---------------------------------------------------------------------*/
+
+static TX_MUTEX compress_mutex;
+
+// Tolerances of about the sensor resolution
+static meteo_compress_config_t compress_config[METEO_ARCHIVE_CHANNELS] =
+{
+    { METEO_COMPRESS_SWINGING_DOOR, 0U, 0.1f, METEO_COMPRESS_HEARTBEAT_S },  // temperature, degC
+    { METEO_COMPRESS_SWINGING_DOOR, 0U, 0.2f, METEO_COMPRESS_HEARTBEAT_S },  // pressure, hPa
+    { METEO_COMPRESS_SWINGING_DOOR, 0U, 0.5f, METEO_COMPRESS_HEARTBEAT_S },  // wind speed, m/s
+    { METEO_COMPRESS_DEADBAND,      1U, 10.0f, METEO_COMPRESS_HEARTBEAT_S }, // wind direction, deg
+    { METEO_COMPRESS_DEADBAND,      0U, 2.0f, METEO_COMPRESS_HEARTBEAT_S }   // voltage
+};
+
+static meteo_compress_t compress_channel[METEO_ARCHIVE_CHANNELS];
+static meteo_archive_sample_t compress_previous;
+static meteo_compress_stats_t compress_stats;
+
+void meteo_compress_init(void)
+{
+    uint32_t c;
+
+    for (c = 0; c < METEO_ARCHIVE_CHANNELS; c++)
+    {
+        meteo_compress_reset(&compress_channel[c]);
+    }
+    memset(&compress_stats, 0, sizeof(compress_stats));
+
+    if (tx_mutex_create(&compress_mutex, "METEO Compress Mutex", TX_INHERIT) != TX_SUCCESS)
+    {
+        printf("[COMPRESS] Create failed\n");
+    }
+}
+
+UINT meteo_compress_set_config(uint32_t channel, const meteo_compress_config_t *config)
+{
+    if (channel >= METEO_ARCHIVE_CHANNELS || config->mode > METEO_COMPRESS_SWINGING_DOOR ||
+        !(config->tolerance >= 0.0f))
+    {
+        return TX_SIZE_ERROR;
+    }
+
+    tx_mutex_get(&compress_mutex, TX_WAIT_FOREVER);
+    compress_config[channel] = *config;
+    // The door so far was for the old tolerance: the next row starts again
+    meteo_compress_reset(&compress_channel[channel]);
+    tx_mutex_put(&compress_mutex);
+
+    return TX_SUCCESS;
+}
+
+UINT meteo_compress_get_config(uint32_t channel, meteo_compress_config_t *config)
+{
+    if (channel >= METEO_ARCHIVE_CHANNELS)
+    {
+        return TX_SIZE_ERROR;
+    }
+
+    tx_mutex_get(&compress_mutex, TX_WAIT_FOREVER);
+    *config = compress_config[channel];
+    tx_mutex_put(&compress_mutex);
+
+    return TX_SUCCESS;
+}
+
+/**
+ * @brief The strongest action any row channel needs
+ */
+static meteo_compress_action_t compress_check_row(const meteo_archive_sample_t *sample)
+{
+    meteo_compress_action_t result = METEO_COMPRESS_SKIP;
+    uint32_t c;
+
+    for (c = 0; c < METEO_ARCHIVE_CHANNELS; c++)
+    {
+        meteo_compress_action_t action;
+
+        if ((METEO_COMPRESS_ROW_CHANNELS & (1UL << c)) == 0U)
+        {
+            continue;
+        }
+        action = meteo_compress_check(&compress_channel[c], &compress_config[c], sample->ts_usec,
+                                      sample->value[c]);
+        if (action == METEO_COMPRESS_HELD)
+        {
+            return action;
+        }
+        if (action == METEO_COMPRESS_KEEP)
+        {
+            result = action;
+        }
+    }
+
+    return result;
+}
+
+uint32_t meteo_compress_apply(const meteo_archive_sample_t *sample, meteo_archive_sample_t rows[2])
+{
+    meteo_compress_action_t action;
+    uint32_t kept = 0U;
+    uint32_t c;
+
+    tx_mutex_get(&compress_mutex, TX_WAIT_FOREVER);
+
+    compress_stats.readings++;
+    action = compress_check_row(sample);
+
+    if (action == METEO_COMPRESS_HELD)
+    {
+        // Every channel at the previous reading, then this one against it
+        rows[0] = compress_previous;
+        for (c = 0; c < METEO_ARCHIVE_CHANNELS; c++)
+        {
+            if (compress_channel[c].holding)
+            {
+                rows[0].value[c] = meteo_compress_keep_held(&compress_channel[c], &compress_config[c]);
+            }
+        }
+        kept = 1U;
+        compress_stats.held++;
+        action = compress_check_row(sample);
+    }
+
+    if (action == METEO_COMPRESS_KEEP)
+    {
+        rows[kept] = *sample;
+    }
+    for (c = 0; c < METEO_ARCHIVE_CHANNELS; c++)
+    {
+        if (action == METEO_COMPRESS_KEEP)
+        {
+            rows[kept].value[c] = meteo_compress_keep(&compress_channel[c], &compress_config[c],
+                                                      sample->ts_usec, sample->value[c]);
+        }
+        else
+        {
+            meteo_compress_drop(&compress_channel[c], &compress_config[c], sample->ts_usec, sample->value[c]);
+        }
+    }
+    if (action == METEO_COMPRESS_KEEP)
+    {
+        kept++;
+    }
+    compress_previous = *sample;
+    compress_stats.rows += kept;
+
+    tx_mutex_put(&compress_mutex);
+
+    return kept;
+}
+
+void meteo_compress_get_stats(meteo_compress_stats_t *stats)
+{
+    tx_mutex_get(&compress_mutex, TX_WAIT_FOREVER);
+    *stats = compress_stats;
+    tx_mutex_put(&compress_mutex);
+}
@@ -0,0 +1,357 @@
+/**
+ * @brief Non-blocking console output: lock-free ring drained by COM1 TX DMA
+ * @version 19.10.26
+ * @author R.Oliva
+ * @description printf() used to send every byte with a blocking
+ *              HAL_UART_Transmit(): a 100 character line held its caller
+ *              ~9 ms at 115200 baud. Now _write() copies the text into a ring
+ *              and GPDMA1 channel 2 sends it to USART1 in the background.
+ *
+ *              Writers (threads and interrupt handlers) never take a lock:
+ *              one 32-bit word holds the ring head and the number of writers
+ *              still copying. A writer reserves its bytes with a
+ *              compare-and-swap that moves the head and adds itself, copies,
+ *              then removes itself; the last writer out publishes the head
+ *              as the commit index, so the DMA never sends a half-copied
+ *              line. Only the owner of the DMA flag moves the tail.
+ *
+ *              Full ring: threads drop (counted) or wait, see
+ *              meteo_console_set_overflow(); other contexts always drop.
+ */
+
+#include "meteo_console.h"
+#include "stm32h573i_discovery.h"
+#include "tx_thread.h"
+#include <string.h>
+
+// Head/commit/tail are free-running 24-bit indexes, the top byte of the
+// state word counts the writers still copying
+#define CONSOLE_INDEX_MASK      0x00FFFFFFUL
+#define CONSOLE_WRITER_ONE      0x01000000UL
+#define CONSOLE_WRITERS(state)  ((state) >> 24)
+#define CONSOLE_RING_MASK       (METEO_CONSOLE_RING_SIZE - 1U)
+
+// Longest piece reserved at once, so a long write still gets through a busy ring
+#define CONSOLE_CHUNK_MAX       (METEO_CONSOLE_RING_SIZE / 2U)
+
+#if (METEO_CONSOLE_RING_SIZE & CONSOLE_RING_MASK) != 0U || METEO_CONSOLE_RING_SIZE > 0x800000UL
+#error "METEO_CONSOLE_RING_SIZE must be a power of 2, at most 8 MB"
+#endif
+
+extern UART_HandleTypeDef hcom_uart[COM_NBR];  // BSP COM array
+
+#ifndef OS_LINUX
+DMA_HandleTypeDef handle_GPDMA1_Channel2;      // COM1 TX, IRQ in stm32h5xx_it.c
+#endif
+
+static uint8_t console_ring[METEO_CONSOLE_RING_SIZE];
+static uint32_t console_state;         // writers << 24 | head
+static uint32_t console_commit;        // bytes before this index are complete
+static uint32_t console_tail;          // next byte for the DMA
+static uint32_t console_dma_length;    // bytes in the running transfer
+static uint8_t console_dma_busy;       // owner sends from the ring and moves the tail
+static uint8_t console_ready;
+
+static meteo_console_overflow_t console_overflow = METEO_CONSOLE_OVERFLOW_DEFAULT;
+static TX_SEMAPHORE console_space;     // put on TX complete while a thread waits
+static uint32_t console_waiters;
+
+static meteo_console_stats_t console_stats;
+
+#define CONSOLE_COUNT(field, n)  ((void)__atomic_fetch_add(&console_stats.field, (ULONG)(n), __ATOMIC_RELAXED))
+
+#ifndef OS_LINUX
+/**
+ * @brief GPDMA1 channel 2: memory to USART1 TDR, linked as COM1 hdmatx
+ */
+static void console_dma_init(void)
+{
+    __HAL_RCC_GPDMA1_CLK_ENABLE();
+
+    handle_GPDMA1_Channel2.Instance = GPDMA1_Channel2;
+    handle_GPDMA1_Channel2.Init.Request = GPDMA1_REQUEST_USART1_TX;
+    handle_GPDMA1_Channel2.Init.BlkHWRequest = DMA_BREQ_SINGLE_BURST;
+    handle_GPDMA1_Channel2.Init.Direction = DMA_MEMORY_TO_PERIPH;
+    handle_GPDMA1_Channel2.Init.SrcInc = DMA_SINC_INCREMENTED;
+    handle_GPDMA1_Channel2.Init.DestInc = DMA_DINC_FIXED;
+    handle_GPDMA1_Channel2.Init.SrcDataWidth = DMA_SRC_DATAWIDTH_BYTE;
+    handle_GPDMA1_Channel2.Init.DestDataWidth = DMA_DEST_DATAWIDTH_BYTE;
+    handle_GPDMA1_Channel2.Init.Priority = DMA_LOW_PRIORITY_LOW_WEIGHT;
+    handle_GPDMA1_Channel2.Init.SrcBurstLength = 1;
+    handle_GPDMA1_Channel2.Init.DestBurstLength = 1;
+    handle_GPDMA1_Channel2.Init.TransferAllocatedPort = DMA_SRC_ALLOCATED_PORT0|DMA_DEST_ALLOCATED_PORT0;
+    handle_GPDMA1_Channel2.Init.TransferEventMode = DMA_TCEM_BLOCK_TRANSFER;
+    handle_GPDMA1_Channel2.Init.Mode = DMA_NORMAL;
+    if (HAL_DMA_Init(&handle_GPDMA1_Channel2) != HAL_OK)
+    {
+        Error_Handler();
+    }
+
+    __HAL_LINKDMA(&hcom_uart[COM1], hdmatx, handle_GPDMA1_Channel2);
+
+    if (HAL_DMA_ConfigChannelAttributes(&handle_GPDMA1_Channel2, DMA_CHANNEL_NPRIV) != HAL_OK)
+    {
+        Error_Handler();
+    }
+
+    // Same priority as the console RX (meteo_simulator_init); USART1 raises
+    // TX complete once the last byte has left the shift register
+    HAL_NVIC_SetPriority(GPDMA1_Channel2_IRQn, 7, 0);
+    HAL_NVIC_EnableIRQ(GPDMA1_Channel2_IRQn);
+    HAL_NVIC_SetPriority(USART1_IRQn, 7, 0);
+    HAL_NVIC_EnableIRQ(USART1_IRQn);
+}
+#endif
+
+/**
+ * @brief Start the next DMA transfer if none is running and bytes are
+ *        committed. Any context; whoever sets the DMA flag owns the tail.
+ */
+static void console_kick(void)
+{
+    uint32_t tail;
+    uint32_t avail;
+    uint32_t offset;
+    uint32_t length;
+
+    while (!__atomic_test_and_set(&console_dma_busy, __ATOMIC_ACQUIRE))
+    {
+        tail = console_tail;
+        avail = (__atomic_load_n(&console_commit, __ATOMIC_ACQUIRE) - tail) & CONSOLE_INDEX_MASK;
+        if (avail == 0U)
+        {
+            __atomic_clear(&console_dma_busy, __ATOMIC_RELEASE);
+
+            // A writer that committed meanwhile found the flag set: look again
+            if (((__atomic_load_n(&console_commit, __ATOMIC_ACQUIRE) - tail) & CONSOLE_INDEX_MASK) == 0U)
+            {
+                return;
+            }
+            continue;
+        }
+
+        // Up to the end of the ring, the rest goes in the next transfer
+        offset = tail & CONSOLE_RING_MASK;
+        length = METEO_CONSOLE_RING_SIZE - offset;
+        if (length > avail)
+        {
+            length = avail;
+        }
+        if (length > METEO_CONSOLE_DMA_MAX)
+        {
+            length = METEO_CONSOLE_DMA_MAX;
+        }
+
+        console_dma_length = length;
+        if (HAL_UART_Transmit_DMA(&hcom_uart[COM1], &console_ring[offset], (uint16_t)length) == HAL_OK)
+        {
+            CONSOLE_COUNT(dma_transfers, 1);
+            return;
+        }
+
+        // UART not ready: skip these bytes rather than stall the console
+        CONSOLE_COUNT(dma_errors, 1);
+        CONSOLE_COUNT(bytes_dropped, length);
+        __atomic_store_n(&console_tail, (tail + length) & CONSOLE_INDEX_MASK, __ATOMIC_RELEASE);
+        __atomic_clear(&console_dma_busy, __ATOMIC_RELEASE);
+    }
+}
+
+/**
+ * @brief Reserve length bytes at the head and count this writer in
+ * @return Ring index of the first byte, or -1 when they do not fit
+ */
+static int32_t console_reserve(uint32_t length)
+{
+    uint32_t state = __atomic_load_n(&console_state, __ATOMIC_RELAXED);
+    uint32_t head;
+    uint32_t used;
+    uint32_t next;
+
+    do
+    {
+        head = state & CONSOLE_INDEX_MASK;
+        used = (head - __atomic_load_n(&console_tail, __ATOMIC_ACQUIRE)) & CONSOLE_INDEX_MASK;
+        if (used + length > METEO_CONSOLE_RING_SIZE || CONSOLE_WRITERS(state) == 0xFFU)
+        {
+            return -1;
+        }
+        next = (state & ~CONSOLE_INDEX_MASK) + CONSOLE_WRITER_ONE + ((head + length) & CONSOLE_INDEX_MASK);
+    }
+    while (!__atomic_compare_exchange_n(&console_state, &state, next, 1,
+                                        __ATOMIC_ACQ_REL, __ATOMIC_RELAXED));
+
+    if (used + length > console_stats.high_water)
+    {
+        console_stats.high_water = used + length;
+    }
+    return (int32_t)head;
+}
+
+/**
+ * @brief Count this writer out. The last one out publishes the head: every
+ *        byte before it has been copied.
+ */
+static void console_commit_reserved(void)
+{
+    uint32_t state = __atomic_load_n(&console_state, __ATOMIC_RELAXED);
+
+    do
+    {
+        // Sole writer: nobody else can publish until this one is out
+        if (CONSOLE_WRITERS(state) == 1U)
+        {
+            __atomic_store_n(&console_commit, state & CONSOLE_INDEX_MASK, __ATOMIC_RELEASE);
+        }
+    }
+    while (!__atomic_compare_exchange_n(&console_state, &state, state - CONSOLE_WRITER_ONE, 1,
+                                        __ATOMIC_ACQ_REL, __ATOMIC_RELAXED));
+}
+
+static void console_copy(uint32_t index, const char *ptr, uint32_t length)
+{
+    uint32_t offset = index & CONSOLE_RING_MASK;
+    uint32_t first = METEO_CONSOLE_RING_SIZE - offset;
+
+    if (first > length)
+    {
+        first = length;
+    }
+    memcpy(&console_ring[offset], ptr, first);
+    memcpy(console_ring, ptr + first, length - first);
+}
+
+static int console_write(const char *ptr, int len, int may_block)
+{
+    uint32_t done = 0U;
+    uint32_t length;
+    int32_t index;
+    int waited = 0;
+
+    while (done < (uint32_t)len)
+    {
+        length = (uint32_t)len - done;
+        if (length > CONSOLE_CHUNK_MAX)
+        {
+            length = CONSOLE_CHUNK_MAX;
+        }
+
+        index = console_reserve(length);
+        if (index < 0)
+        {
+            if (may_block && console_overflow == METEO_CONSOLE_BLOCK)
+            {
+                // Checked again once registered, a TX complete in between is not missed
+                __atomic_fetch_add(&console_waiters, 1U, __ATOMIC_ACQ_REL);
+                index = console_reserve(length);
+                if (index < 0)
+                {
+                    (void)tx_semaphore_get(&console_space, METEO_CONSOLE_BLOCK_TICKS);
+                }
+                __atomic_fetch_sub(&console_waiters, 1U, __ATOMIC_ACQ_REL);
+                waited = 1;
+            }
+            if (index < 0)
+            {
+                if (may_block && console_overflow == METEO_CONSOLE_BLOCK)
+                {
+                    continue;
+                }
+                CONSOLE_COUNT(writes_dropped, 1);
+                CONSOLE_COUNT(bytes_dropped, (uint32_t)len - done);
+                break;
+            }
+        }
+
+        console_copy((uint32_t)index, ptr + done, length);
+        console_commit_reserved();
+        console_kick();
+        done += length;
+    }
+
+    if (waited)
+    {
+        CONSOLE_COUNT(blocked, 1);
+    }
+    CONSOLE_COUNT(bytes_written, done);
+    return (int)done;
+}
+
+void meteo_console_init(void)
+{
+#ifndef OS_LINUX
+    console_dma_init();
+#endif
+    if (tx_semaphore_create(&console_space, "Console Space", 0) != TX_SUCCESS)
+    {
+        return;
+    }
+    __atomic_store_n(&console_ready, 1U, __ATOMIC_RELEASE);
+}
+
+int meteo_console_active(void)
+{
+    return __atomic_load_n(&console_ready, __ATOMIC_ACQUIRE) != 0U;
+}
+
+int meteo_console_write(const char *ptr, int len)
+{
+    // Only a thread may wait: not interrupts, initialization or pre-kernel code
+    int may_block = (TX_THREAD_GET_SYSTEM_STATE() == 0U) && (tx_thread_identify() != TX_NULL);
+
+    return console_write(ptr, len, may_block);
+}
+
+int meteo_console_write_isr(const char *ptr, int len)
+{
+    return console_write(ptr, len, 0);
+}
+
+ULONG meteo_console_pending(void)
+{
+    uint32_t head = __atomic_load_n(&console_state, __ATOMIC_ACQUIRE) & CONSOLE_INDEX_MASK;
+
+    return (head - __atomic_load_n(&console_tail, __ATOMIC_ACQUIRE)) & CONSOLE_INDEX_MASK;
+}
+
+meteo_console_overflow_t meteo_console_set_overflow(meteo_console_overflow_t policy)
+{
+    meteo_console_overflow_t previous = console_overflow;
+
+    console_overflow = policy;
+    return previous;
+}
+
+void meteo_console_get_stats(meteo_console_stats_t *stats)
+{
+    *stats = console_stats;
+}
+
+void meteo_console_tx_cplt(void)
+{
+    if (!__atomic_load_n(&console_dma_busy, __ATOMIC_ACQUIRE))
+    {
+        return;
+    }
+
+    __atomic_store_n(&console_tail, (console_tail + console_dma_length) & CONSOLE_INDEX_MASK, __ATOMIC_RELEASE);
+    __atomic_clear(&console_dma_busy, __ATOMIC_RELEASE);
+
+    if (__atomic_load_n(&console_waiters, __ATOMIC_ACQUIRE) != 0U)
+    {
+        (void)tx_semaphore_ceiling_put(&console_space, 1);
+    }
+    console_kick();
+}
+
+void meteo_console_tx_error(UART_HandleTypeDef *huart)
+{
+    // TX DMA error: the transfer is over, its bytes are lost
+    if ((huart->ErrorCode & HAL_UART_ERROR_DMA) != 0U &&
+        __atomic_load_n(&console_dma_busy, __ATOMIC_ACQUIRE))
+    {
+        CONSOLE_COUNT(dma_errors, 1);
+        CONSOLE_COUNT(bytes_dropped, console_dma_length);
+        meteo_console_tx_cplt();
+    }
+}
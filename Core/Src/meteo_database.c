@@ -5,8 +5,14 @@
 /**************************************************************************/
 
 #include "meteo_database.h"
+#include <stdint.h>
 #include <string.h>
 
+// 19.10.26 A row as the table output stores it: the fields packed in order,
+// id (the key) first, then ts
+#define METEO_READINGS_ID_OFFSET    0U
+#define METEO_READINGS_TS_OFFSET    sizeof(int32_t)
+
 // Index key compare function for table: meteo_readings4
 static dbstatus_t compare_meteo_readings_by_PK(const void *v1, const void *v2, size_t key_field_count, uint32_t flags)
 {
@@ -38,3 +44,59 @@ dbstatus_t open_meteo_database(const char * database_name, const db_database_con
 
     return db_open_index_storage(database_name, config, compare_functions, 1);
 }
+
+// 19.10.26 The key is the id alone: the rows past the age are found by
+// looking at each one, a bounded number per call
+dbstatus_t delete_meteo_readings_before(db_t database, db_timestamp_usec_t before_usec, size_t max_rows,
+                                        int32_t *next_id, size_t *removed, size_t *bytes)
+{
+    db_index_t index;
+    const void *data;
+    size_t size;
+    size_t looked = 0U;
+    int32_t id = *next_id;
+    db_timestamp_usec_t ts;
+    dbstatus_t status;
+
+    *removed = 0U;
+    *bytes = 0U;
+    status = db_open_index(&index, database, METEO_READINGS_INDEX, NULL);
+    if (DB_FAILED(status)) {
+        return status;
+    }
+
+    while (looked < max_rows) {
+        status = db_index_get(index, &id, sizeof id, 1U, &data, &size);
+        if (status == DB_ENOTFOUND) {
+            // Past the last row: the next call starts again
+            id = INT32_MIN;
+            status = DB_NOERROR;
+            break;
+        }
+        if (DB_FAILED(status) || size < METEO_READINGS_TS_OFFSET + sizeof ts) {
+            status = DB_FAILED(status) ? status : DB_EINVAL;
+            break;
+        }
+        (void)memcpy(&id, (const uint8_t *)data + METEO_READINGS_ID_OFFSET, sizeof id);
+        (void)memcpy(&ts, (const uint8_t *)data + METEO_READINGS_TS_OFFSET, sizeof ts);
+        looked++;
+
+        if (ts < before_usec) {
+            status = db_index_remove(index, data, sizeof id, NULL);
+            if (DB_FAILED(status)) {
+                break;
+            }
+            (*removed)++;
+            *bytes += size;
+        }
+        if (id == INT32_MAX) {
+            id = INT32_MIN;
+            break;
+        }
+        id++;
+    }
+
+    *next_id = id;
+    (void)db_close_index(index);
+    return status;
+}
@@ -8,6 +8,9 @@
 #include "meteo_example.h"
 #include "meteo_database.h"
 #include "meteo_streams.h"
+#include "meteo_trace.h"
+#include "meteo_format.h"
+#include "meteo_archive_store.h"
 
 #include <ittia/os/os_wait_time.h>
 #include <stdio.h>
@@ -111,52 +114,70 @@ int run_meteo_example(db_media_driver_t driver, void * driver_info)
  */
 void ProcessMeteoFrameToStream(const char* frame)
 {
-    uint32_t temp_adc = 0, baro_adc = 0, wdir = 0, wspeed = 0, volt = 0;
-    uint16_t crcc = 0;
-    
-    /* Parse the METEO frame - upd 11.02.26 */
-    if (sscanf(frame, "UUU$%5u.%5u.%4u.%5u.%3u.%4hx",
-               &temp_adc, &baro_adc, &wdir, &wspeed, &volt, &crcc) >= 5)
+    meteo_archive_sample_t sample;
+
+    /* Parse the METEO frame - upd 11.02.26, 19.10.26 one parser with the archive */
+    if (meteo_archive_store_parse_frame(frame, &sample) == TX_SUCCESS)
     {
-        /* Create timestamp in microseconds */
-        extern uint32_t HAL_GetTick(void);  // From STM32 HAL
-        db_timestamp_usec_t timestamp = (db_timestamp_usec_t)HAL_GetTick() * 1000ULL;
-        
-        /* Convert ADC values to engineering units */
-        // TODO: Adjust these conversion factors based on your sensor calibration
-        double pressure = baro_adc / 10.0;            // 00327 -> 32.7 hPa
-        double temperature = temp_adc / 100.0;        // Example: ADC to °C
-        double wind_speed = wspeed / 10.0;            // Example: to m/s
-        double wind_direction = wdir / 10.0;          // Already in degrees (0.1° resolution)
-        
-         /* *** 11.2.26 SAFETY: Use default ID if IDC agent hasn't connected yet *** */
-        int32_t instance_id = (meteo_instance_id != NULL && *meteo_instance_id > 0) 
-                              ? *meteo_instance_id 
-                              : 1;  // Default instance ID       
-		
-		/* Create meteo reading - modified id 11.2.26 */
-        meteo_readings_row_t meteo = {
-            .id = instance_id,
-            .ts = timestamp,
-            .temperature = temperature,
-            .wind_speed = wind_speed,
-            .wind_direction = wind_direction
-        };
-        
-        /* Insert into stream */
-        dbstatus_t status = put_meteo_readings_stream(meteo_input_node, &meteo);
-        
-        if (DB_FAILED(status)) {
-            fprintf(stderr,
-                "Cannot process METEO stream input: %s\n",
-                dbs_get_error_info(status).description);
-        } else {
-            /* 11.2.26 Optional: Reduced logging to avoid spam */
-            printf("[DB] Stored: T=%.2f degC P=%.1f hPa WS=%.1f m/s WD=%.1f deg V=%u\n",
-                   temperature, pressure, wind_speed, wind_direction, volt);
-        }
+        ProcessMeteoSampleToStream(&sample);
     }
     else {
+        METEO_TRACE(METEO_TRACE_STREAM_PROCESSED, 0, 0);
         fprintf(stderr, "METEO frame parse error: %s\n", frame);
     }
 }
+
+/**
+ * @brief Insert a decoded (filtered, kept) reading into the stream - 19.10.26
+ */
+void ProcessMeteoSampleToStream(const meteo_archive_sample_t* sample)
+{
+    /* Create timestamp in microseconds */
+    extern uint32_t HAL_GetTick(void);  // From STM32 HAL
+    // 19.10.26 A kept row can be the previous reading: its own time, as archived
+    db_timestamp_usec_t timestamp = (sample->ts_usec != 0)
+                                    ? (db_timestamp_usec_t)sample->ts_usec
+                                    : (db_timestamp_usec_t)(HAL_GetTick() * 1000ULL);
+
+    /* Engineering units, scaled in meteo_archive_store_parse_frame() */
+    // TODO: Adjust these conversion factors based on your sensor calibration
+    // 19.10.26 Pressure is not a meteo_readings column, only printed
+
+     /* *** 11.2.26 SAFETY: Use default ID if IDC agent hasn't connected yet *** */
+    int32_t instance_id = (meteo_instance_id != NULL && *meteo_instance_id > 0) 
+                          ? *meteo_instance_id 
+                          : 1;  // Default instance ID       
+
+    /* Create meteo reading - modified id 11.2.26 */
+    meteo_readings_row_t meteo = {
+        .id = instance_id,
+        .ts = timestamp,
+        .temperature = sample->value[METEO_ARCHIVE_TEMPERATURE],
+        .wind_speed = sample->value[METEO_ARCHIVE_WIND_SPEED],
+        .wind_direction = sample->value[METEO_ARCHIVE_WIND_DIRECTION]
+    };
+
+    /* Insert into stream */
+    dbstatus_t status = put_meteo_readings_stream(meteo_input_node, &meteo);
+    METEO_TRACE(METEO_TRACE_STREAM_PROCESSED, !DB_FAILED(status), status);
+
+    if (DB_FAILED(status)) {
+        fprintf(stderr,
+            "Cannot process METEO stream input: %s\n",
+            dbs_get_error_info(status).description);
+    } else {
+        /* 11.2.26 Optional: Reduced logging to avoid spam */
+        /* 19.10.26 No float printf */
+        static const uint8_t decimals[METEO_ARCHIVE_CHANNELS] = { 2U, 1U, 1U, 1U, 0U };
+        char text[METEO_ARCHIVE_CHANNELS][12];
+        uint32_t i;
+
+        for (i = 0; i < METEO_ARCHIVE_CHANNELS; i++) {
+            text[i][meteo_format_float(text[i], sizeof(text[i]) - 1U, sample->value[i], decimals[i])] = '\0';
+        }
+        printf("[DB] Stored: T=%s degC P=%s hPa WS=%s m/s WD=%s deg V=%s\n",
+               text[METEO_ARCHIVE_TEMPERATURE], text[METEO_ARCHIVE_PRESSURE],
+               text[METEO_ARCHIVE_WIND_SPEED], text[METEO_ARCHIVE_WIND_DIRECTION],
+               text[METEO_ARCHIVE_VOLTAGE]);
+    }
+}
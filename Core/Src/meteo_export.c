@@ -0,0 +1,362 @@
+/**
+ * @brief Streaming CSV / JSON / MCOL export of the archive
+ * @version 19.10.26
+ * @author R.Oliva
+ * @description Readings leave the board as CSV for Analitica or NanoEdge
+ *              AI Studio, as JSON lines, or as MCOL column chunks
+ *              (meteo_columns.c) for bulk transfers. An export walks a time range of
+ *              the archive with a cursor, METEO_EXPORT_BATCH samples at a
+ *              time, formats rows (meteo_format.c) or a column chunk into one output buffer
+ *              and hands it to a sink each time it is full: TCP (export
+ *              server in app_netxduo.c), COM1, or a file on the Linux host. The sink blocks while the link is
+ *              busy, which paces the export; RAM use does not depend on the
+ *              range, and nothing is locked while the sink waits, so the DB
+ *              thread and queries go on.
+ *              19.10.26 The same rows from the time series of each channel
+ *              (meteo_series.c), when they are stored.
+ */
+
+#include "meteo_export.h"
+#include "meteo_columns.h"
+#include "meteo_console.h"
+#include "meteo_format.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#define EXPORT_CSV_HEADER   "ts,temperature,pressure,wind_speed,wind_direction,voltage\n"
+
+static TX_MUTEX export_mutex;
+
+// State of the running export
+static meteo_archive_cursor_t export_cursor;
+#if METEO_SERIES_ENABLED
+static meteo_series_cursor_t export_series;
+#endif
+static meteo_archive_sample_t export_samples[METEO_EXPORT_BATCH];
+static char export_buffer[METEO_EXPORT_BUFFER_SIZE];
+
+/**
+ * @brief Format one row after the complete ones
+ * @return Bytes added, 0 when the row does not fit
+ */
+static uint32_t export_format_row(meteo_format_writer_t *writer, const meteo_archive_sample_t *sample,
+                                  meteo_export_format_t format)
+{
+    const float *value = sample->value;
+
+    if (format == METEO_EXPORT_CSV)
+    {
+        meteo_format_field_seconds(writer, "ts", sample->ts_usec, 3);
+    }
+    else if (format == METEO_EXPORT_JSON)
+    {
+        meteo_format_field_iso8601(writer, "ts", sample->ts_usec, 3);
+    }
+    meteo_format_field_float(writer, "temperature", value[METEO_ARCHIVE_TEMPERATURE], 2);
+    meteo_format_field_float(writer, "pressure", value[METEO_ARCHIVE_PRESSURE], 1);
+    meteo_format_field_float(writer, "wind_speed", value[METEO_ARCHIVE_WIND_SPEED], 1);
+    meteo_format_field_float(writer, "wind_direction", value[METEO_ARCHIVE_WIND_DIRECTION], 1);
+    meteo_format_field_float(writer, "voltage", value[METEO_ARCHIVE_VOLTAGE], 0);
+
+    return meteo_format_row_end(writer);
+}
+
+static UINT export_flush(meteo_export_sink_t sink, void *context, uint32_t length,
+                         meteo_export_stats_t *counts)
+{
+    if (length == 0U)
+    {
+        return TX_SUCCESS;
+    }
+    if (sink(context, export_buffer, length) != 0)
+    {
+        return TX_WAIT_ABORTED;
+    }
+
+    counts->chunks++;
+    counts->bytes += length;
+    return TX_SUCCESS;
+}
+
+/**
+ * @brief Rows of one batch after the complete ones, sending the buffer each
+ *        time it is full
+ */
+static UINT export_rows(meteo_export_sink_t sink, void *context, meteo_format_writer_t *writer,
+                        UINT count, meteo_export_format_t format, meteo_export_stats_t *counts)
+{
+    UINT i;
+
+    for (i = 0; i < count; i++)
+    {
+        if (export_format_row(writer, &export_samples[i], format) == 0U)
+        {
+            // Buffer full: send it, the row goes at the start
+            if (export_flush(sink, context, writer->length, counts) != TX_SUCCESS)
+            {
+                return TX_WAIT_ABORTED;
+            }
+            meteo_format_writer_reset(writer);
+            (void)export_format_row(writer, &export_samples[i], format);
+        }
+        counts->rows++;
+    }
+
+    return TX_SUCCESS;
+}
+
+/**
+ * @brief One batch as an MCOL chunk after *length bytes (count 0: the end
+ *        chunk), sending the buffer first when the chunk does not fit
+ */
+static UINT export_columns(meteo_export_sink_t sink, void *context, uint32_t *length,
+                           UINT count, meteo_export_stats_t *counts)
+{
+    if (*length + meteo_columns_chunk_bytes(count) > sizeof(export_buffer))
+    {
+        if (export_flush(sink, context, *length, counts) != TX_SUCCESS)
+        {
+            return TX_WAIT_ABORTED;
+        }
+        *length = 0U;
+    }
+
+    *length += meteo_columns_chunk((uint8_t *)&export_buffer[*length], sizeof(export_buffer) - *length,
+                                   export_samples, count);
+    counts->rows += count;
+    return TX_SUCCESS;
+}
+
+static int export_console_sink(void *context, const char *data, uint32_t length)
+{
+    (void)context;
+
+    return (meteo_console_write(data, (int)length) == (int)length) ? 0 : -1;
+}
+
+/**
+ * @brief Open the cursor of the archive, or of the series
+ */
+static UINT export_open(const meteo_archive_query_t *query, uint8_t series)
+{
+#if METEO_SERIES_ENABLED
+    if (series)
+    {
+        return meteo_series_cursor_open(&export_series, query);
+    }
+#else
+    (void)series;
+#endif
+    return meteo_archive_store_cursor_open(&export_cursor, query);
+}
+
+static UINT export_read(uint8_t series, UINT *count)
+{
+#if METEO_SERIES_ENABLED
+    if (series)
+    {
+        return meteo_series_read(&export_series, export_samples, METEO_EXPORT_BATCH, count);
+    }
+#endif
+    return meteo_archive_store_read(&export_cursor, export_samples, METEO_EXPORT_BATCH, count);
+}
+
+/**
+ * @brief Close the cursor and fill in its counts
+ */
+static void export_close(uint8_t series, meteo_export_stats_t *counts)
+{
+#if METEO_SERIES_ENABLED
+    if (series)
+    {
+        meteo_series_cursor_close(&export_series);
+        memset(&counts->query, 0, sizeof(counts->query));
+        counts->query.samples = export_series.stats.timestamps;
+        counts->query.matched = export_series.stats.rows;
+        return;
+    }
+#endif
+    counts->query = export_cursor.stats;
+}
+
+void meteo_export_init(void)
+{
+    if (tx_mutex_create(&export_mutex, "METEO Export Mutex", TX_INHERIT) != TX_SUCCESS)
+    {
+        printf("[EXPORT] Create failed\n");
+    }
+}
+
+static UINT export_run(const meteo_archive_query_t *query, meteo_export_format_t format,
+                       meteo_export_sink_t sink, void *context, meteo_export_stats_t *stats, uint8_t series)
+{
+    meteo_export_stats_t counts;
+    meteo_format_writer_t writer;
+    ULONG start = tx_time_get();
+    uint32_t length = 0U;
+    UINT count = METEO_EXPORT_BATCH;
+    UINT status;
+
+    memset(&counts, 0, sizeof(counts));
+
+    tx_mutex_get(&export_mutex, TX_WAIT_FOREVER);
+
+    meteo_format_writer_init(&writer, export_buffer, sizeof(export_buffer),
+                             (format == METEO_EXPORT_JSON) ? METEO_FORMAT_JSON : METEO_FORMAT_CSV);
+    status = export_open(query, series);
+    if (status == TX_SUCCESS && format == METEO_EXPORT_CSV)
+    {
+        (void)meteo_format_row_text(&writer, EXPORT_CSV_HEADER);
+    }
+    else if (status == TX_SUCCESS && format == METEO_EXPORT_COLUMNS)
+    {
+        length = meteo_columns_header((uint8_t *)export_buffer, sizeof(export_buffer));
+    }
+
+    // A short batch is the end of the cursor
+    while (status == TX_SUCCESS && count == METEO_EXPORT_BATCH)
+    {
+        status = export_read(series, &count);
+
+        if (format != METEO_EXPORT_COLUMNS)
+        {
+            if (export_rows(sink, context, &writer, count, format, &counts) != TX_SUCCESS)
+            {
+                status = TX_WAIT_ABORTED;
+            }
+        }
+        else if (count != 0U && export_columns(sink, context, &length, count, &counts) != TX_SUCCESS)
+        {
+            status = TX_WAIT_ABORTED;
+        }
+    }
+
+    // The end chunk tells the reader the stream is complete, so not after an error
+    if (status == TX_SUCCESS && format == METEO_EXPORT_COLUMNS &&
+        export_columns(sink, context, &length, 0U, &counts) != TX_SUCCESS)
+    {
+        status = TX_WAIT_ABORTED;
+    }
+    if (format != METEO_EXPORT_COLUMNS)
+    {
+        length = writer.length;
+    }
+    if (status != TX_WAIT_ABORTED && export_flush(sink, context, length, &counts) != TX_SUCCESS)
+    {
+        status = TX_WAIT_ABORTED;
+    }
+
+    export_close(series, &counts);
+    counts.ticks = tx_time_get() - start;
+
+    tx_mutex_put(&export_mutex);
+
+    if (stats != NULL)
+    {
+        *stats = counts;
+    }
+    return status;
+}
+
+UINT meteo_export_run(const meteo_archive_query_t *query, meteo_export_format_t format,
+                      meteo_export_sink_t sink, void *context, meteo_export_stats_t *stats)
+{
+    return export_run(query, format, sink, context, stats, 0U);
+}
+
+#if METEO_SERIES_ENABLED
+UINT meteo_export_series_run(const meteo_archive_query_t *query, meteo_export_format_t format,
+                             meteo_export_sink_t sink, void *context, meteo_export_stats_t *stats)
+{
+    return export_run(query, format, sink, context, stats, 1U);
+}
+#endif
+
+UINT meteo_export_console(const meteo_archive_query_t *query, meteo_export_format_t format,
+                          meteo_export_stats_t *stats)
+{
+    meteo_console_overflow_t previous;
+    UINT status;
+
+    previous = meteo_console_set_overflow(METEO_CONSOLE_BLOCK);
+    status = meteo_export_run(query, format, export_console_sink, NULL, stats);
+    (void)meteo_console_set_overflow(previous);
+
+    return status;
+}
+
+UINT meteo_export_parse(const char *line, meteo_archive_query_t *query, meteo_export_format_t *format)
+{
+    unsigned long value[2];
+    const char *p = line;
+    char *end;
+    UINT n;
+
+    while (*p == ' ')
+    {
+        p++;
+    }
+    if (strncmp(p, "nanoedge", 8) == 0)
+    {
+        *format = METEO_EXPORT_NANOEDGE;
+        p += 8;
+    }
+    else if (strncmp(p, "json", 4) == 0)
+    {
+        *format = METEO_EXPORT_JSON;
+        p += 4;
+    }
+    else if (strncmp(p, "mcol", 4) == 0)
+    {
+        *format = METEO_EXPORT_COLUMNS;
+        p += 4;
+    }
+    else
+    {
+        *format = METEO_EXPORT_CSV;
+        if (strncmp(p, "csv", 3) == 0)
+        {
+            p += 3;
+        }
+    }
+
+    for (n = 0; n < 2U; n++)
+    {
+        value[n] = strtoul(p, &end, 10);
+        if (end == p)
+        {
+            break;
+        }
+        p = end;
+    }
+    while (*p == ' ' || *p == '\r' || *p == '\n')
+    {
+        p++;
+    }
+    if (*p != '\0')
+    {
+        return TX_SIZE_ERROR;
+    }
+
+    query->channel = METEO_ARCHIVE_CHANNELS;
+    query->min = 0.0f;
+    query->max = 0.0f;
+    if (n == 0U)
+    {
+        query->from_usec = 0;
+        query->to_usec = INT64_MAX;
+    }
+    else if (n == 1U)
+    {
+        query->to_usec = meteo_archive_store_now();
+        query->from_usec = query->to_usec - (int64_t)value[0] * 1000000;
+    }
+    else
+    {
+        query->from_usec = (int64_t)value[0] * 1000000;
+        query->to_usec = (int64_t)value[1] * 1000000 + 999999;
+    }
+
+    return TX_SUCCESS;
+}
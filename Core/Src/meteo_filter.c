@@ -0,0 +1,308 @@
+/**
+ * @brief Sliding median and spike filter of the readings
+ * @version 19.10.26
+ * @author R.Oliva
+ * @description The temperature and wind speed ADCs now and then give a
+ *              single wild value, which went straight into the stream, the
+ *              archive and on to Analitica. The DB thread now checks each
+ *              decoded reading against the median of the previous
+ *              METEO_FILTER_WINDOW ones, per channel (a causal Hampel
+ *              filter): beyond k x MAD it is flagged, counted and replaced
+ *              by the median before anything stores it. Wind direction is
+ *              not filtered: its median makes no sense across 0/360.
+ *              The median keeps two heaps around the middle value in one
+ *              array plus the ring of values, each knowing where the other
+ *              is, so the value leaving the window is replaced in place by
+ *              the new one: O(log W) a sample, which keeps windows of
+ *              thousands of samples cheap. The MAD is the median of the
+ *              deviations of each value from the median when it arrived, a
+ *              second such window, instead of recomputing every deviation
+ *              (O(W)) each time.
+ */
+
+#include "meteo_filter.h"
+#include <math.h>
+#include <stdio.h>
+#include <string.h>
+
+#if (METEO_FILTER_WINDOW < 1) || (METEO_FILTER_WINDOW > METEO_MEDIAN_MAX)
+#error "METEO_FILTER_WINDOW must be 1..METEO_MEDIAN_MAX"
+#endif
+
+// MAD to standard deviation for normal noise
+#define FILTER_MAD_SIGMA        1.4826f
+
+/* Median --------------------------------------------------------------------*/
+
+// Heap index 0 is the median, 1.. the min-heap of the values above it
+// (children 2i, 2i+1), -1.. the max-heap of those below (children 2i, 2i-1)
+#define MEDIAN_ABOVE(m)         (((int32_t)(m)->count - 1) / 2)
+#define MEDIAN_BELOW(m)         ((int32_t)(m)->count / 2)
+
+static int median_less(const meteo_median_t *m, int32_t i, int32_t j)
+{
+    return m->data[m->heap[i]] < m->data[m->heap[j]];
+}
+
+/**
+ * @brief Swap heap entries i and j when i is less than j
+ * @return 1 when swapped
+ */
+static int median_swap_less(meteo_median_t *m, int32_t i, int32_t j)
+{
+    uint16_t slot;
+
+    if (!median_less(m, i, j))
+    {
+        return 0;
+    }
+    slot = m->heap[i];
+    m->heap[i] = m->heap[j];
+    m->heap[j] = slot;
+    m->pos[m->heap[i]] = (int16_t)i;
+    m->pos[m->heap[j]] = (int16_t)j;
+    return 1;
+}
+
+static void median_above_down(meteo_median_t *m, int32_t i)
+{
+    for (; i <= MEDIAN_ABOVE(m); i *= 2)
+    {
+        if (i > 1 && i < MEDIAN_ABOVE(m) && median_less(m, i + 1, i))
+        {
+            i++;
+        }
+        if (!median_swap_less(m, i, i / 2))
+        {
+            break;
+        }
+    }
+}
+
+static void median_below_down(meteo_median_t *m, int32_t i)
+{
+    for (; i >= -MEDIAN_BELOW(m); i *= 2)
+    {
+        if (i < -1 && i > -MEDIAN_BELOW(m) && median_less(m, i, i - 1))
+        {
+            i--;
+        }
+        if (!median_swap_less(m, i / 2, i))
+        {
+            break;
+        }
+    }
+}
+
+/**
+ * @return 1 when the entry reached the median
+ */
+static int median_above_up(meteo_median_t *m, int32_t i)
+{
+    while (i > 0 && median_swap_less(m, i, i / 2))
+    {
+        i /= 2;
+    }
+    return i == 0;
+}
+
+static int median_below_up(meteo_median_t *m, int32_t i)
+{
+    while (i < 0 && median_swap_less(m, i / 2, i))
+    {
+        i /= 2;
+    }
+    return i == 0;
+}
+
+void meteo_median_init(meteo_median_t *median, float *data, int16_t *pos, uint16_t *heap, uint32_t window)
+{
+    uint32_t slot;
+
+    median->data = data;
+    median->pos = pos;
+    median->heap = heap + window / 2U;
+    median->window = window;
+    median->index = 0U;
+    median->count = 0U;
+
+    // Slots fill the heaps from the middle out: 0, -1, 1, -2, 2 ...
+    for (slot = 0; slot < window; slot++)
+    {
+        int32_t i = (int32_t)((slot + 1U) / 2U);
+
+        pos[slot] = (int16_t)(((slot & 1U) != 0U) ? -i : i);
+        median->heap[pos[slot]] = (uint16_t)slot;
+        data[slot] = 0.0f;
+    }
+}
+
+void meteo_median_add(meteo_median_t *median, float value)
+{
+    uint32_t slot = median->index;
+    int32_t i = median->pos[slot];
+    int full = (median->count == median->window);
+    float old = median->data[slot];
+
+    median->data[slot] = value;
+    median->index = (slot + 1U < median->window) ? slot + 1U : 0U;
+    if (!full)
+    {
+        median->count++;
+    }
+
+    // The new value takes the old one's place in the heaps, then moves
+    if (i > 0)
+    {
+        if (full && old < value)
+        {
+            median_above_down(median, i * 2);
+        }
+        else if (median_above_up(median, i))
+        {
+            median_below_down(median, -1);
+        }
+    }
+    else if (i < 0)
+    {
+        if (full && value < old)
+        {
+            median_below_down(median, i * 2);
+        }
+        else if (median_below_up(median, i))
+        {
+            median_above_down(median, 1);
+        }
+    }
+    else
+    {
+        if (MEDIAN_BELOW(median) != 0)
+        {
+            median_below_down(median, -1);
+        }
+        if (MEDIAN_ABOVE(median) != 0)
+        {
+            median_above_down(median, 1);
+        }
+    }
+}
+
+float meteo_median_get(const meteo_median_t *median)
+{
+    if (median->count == 0U)
+    {
+        return 0.0f;
+    }
+    if ((median->count & 1U) != 0U)
+    {
+        return median->data[median->heap[0]];
+    }
+    return (median->data[median->heap[0]] + median->data[median->heap[-1]]) * 0.5f;
+}
+
+/* Filter --------------------------------------------------------------------*/
+
+// Per channel: k, and the least MAD (units of the channel) so that steady
+// readings, whose MAD is 0, do not flag the next small change
+static const struct
+{
+    uint8_t enabled;
+    float k;
+    float mad_min;
+} filter_config[METEO_ARCHIVE_CHANNELS] =
+{
+    { 1U, 4.0f, 0.2f },     // temperature, degC
+    { 1U, 4.0f, 0.3f },     // pressure, hPa
+    { 1U, 6.0f, 1.0f },     // wind speed, m/s: gusts are real
+    { 0U, 0.0f, 0.0f },     // wind direction
+    { 1U, 4.0f, 2.0f }      // voltage
+};
+
+static TX_MUTEX filter_mutex;
+
+// Two windows per channel: the values and their deviations
+static float filter_data[METEO_ARCHIVE_CHANNELS][2][METEO_FILTER_WINDOW];
+static int16_t filter_pos[METEO_ARCHIVE_CHANNELS][2][METEO_FILTER_WINDOW];
+static uint16_t filter_heap[METEO_ARCHIVE_CHANNELS][2][METEO_FILTER_WINDOW];
+
+static meteo_median_t filter_value[METEO_ARCHIVE_CHANNELS];
+static meteo_median_t filter_deviation[METEO_ARCHIVE_CHANNELS];
+static meteo_filter_stats_t filter_stats[METEO_ARCHIVE_CHANNELS];
+
+void meteo_filter_init(void)
+{
+    uint32_t c;
+
+    for (c = 0; c < METEO_ARCHIVE_CHANNELS; c++)
+    {
+        meteo_median_init(&filter_value[c], filter_data[c][0], filter_pos[c][0], filter_heap[c][0],
+                          METEO_FILTER_WINDOW);
+        meteo_median_init(&filter_deviation[c], filter_data[c][1], filter_pos[c][1], filter_heap[c][1],
+                          METEO_FILTER_WINDOW);
+    }
+    memset(filter_stats, 0, sizeof(filter_stats));
+
+    if (tx_mutex_create(&filter_mutex, "METEO Filter Mutex", TX_INHERIT) != TX_SUCCESS)
+    {
+        printf("[FILTER] Create failed\n");
+    }
+}
+
+uint32_t meteo_filter_apply(float *values)
+{
+    uint32_t flagged = 0U;
+    uint32_t c;
+
+    tx_mutex_get(&filter_mutex, TX_WAIT_FOREVER);
+
+    for (c = 0; c < METEO_ARCHIVE_CHANNELS; c++)
+    {
+        meteo_filter_stats_t *stats = &filter_stats[c];
+        float value = values[c];
+        float median;
+        float mad;
+
+        if (!filter_config[c].enabled)
+        {
+            continue;
+        }
+
+        median = (filter_value[c].count != 0U) ? meteo_median_get(&filter_value[c]) : value;
+        mad = meteo_median_get(&filter_deviation[c]);
+        stats->median = median;
+        stats->mad = mad;
+        stats->samples++;
+
+        if (filter_value[c].count >= METEO_FILTER_WARMUP || filter_value[c].count == METEO_FILTER_WINDOW)
+        {
+            if (mad < filter_config[c].mad_min)
+            {
+                mad = filter_config[c].mad_min;
+            }
+            if (fabsf(value - median) > filter_config[c].k * FILTER_MAD_SIGMA * mad)
+            {
+                flagged |= 1UL << c;
+                stats->flagged++;
+#if METEO_FILTER_REPLACE
+                values[c] = median;
+                stats->replaced++;
+#endif
+            }
+        }
+
+        // The raw value: a lasting change takes over the median
+        meteo_median_add(&filter_value[c], value);
+        meteo_median_add(&filter_deviation[c], fabsf(value - median));
+    }
+
+    tx_mutex_put(&filter_mutex);
+
+    return flagged;
+}
+
+void meteo_filter_get_stats(meteo_filter_stats_t stats[METEO_ARCHIVE_CHANNELS])
+{
+    tx_mutex_get(&filter_mutex, TX_WAIT_FOREVER);
+    memcpy(stats, filter_stats, sizeof(filter_stats));
+    tx_mutex_put(&filter_mutex);
+}
@@ -0,0 +1,439 @@
+/**
+ * @brief Fixed-point number, time and CSV/JSON row formatting
+ * @version 19.10.26
+ * @author R.Oliva
+ * @description printf("%.2f") pulls newlib's float printf into the image and
+ *              takes tens of microseconds a value on the M33, paid for every
+ *              console line and every exported cell. The readings are
+ *              integers with a known scale (0.01 degC, 0.1 hPa ...), so they
+ *              are written here as integers with an implied decimal point:
+ *              digits two at a time from a table, one division by 100 per
+ *              pair, no locale, no heap, straight into the caller buffer.
+ *              Floats are scaled and rounded to such an integer first.
+ *              Times are seconds with decimals or ISO-8601 (UTC, civil date
+ *              from the day number without tables).
+ *              The row writer appends CSV or JSON rows to a buffer and takes
+ *              a row back whole when it does not fit, so a full buffer can be
+ *              sent and the row written again at the start.
+ */
+
+#include "meteo_format.h"
+#include <string.h>
+
+#define FORMAT_DIGITS_MAX       20U     // uint64_t
+
+static const char format_pairs[200] =
+    "0001020304050607080910111213141516171819"
+    "2021222324252627282930313233343536373839"
+    "4041424344454647484950515253545556575859"
+    "6061626364656667686970717273747576777879"
+    "8081828384858687888990919293949596979899";
+
+static const uint32_t format_pow10[METEO_FORMAT_DECIMALS_MAX + 1U] =
+{
+    1UL, 10UL, 100UL, 1000UL, 10000UL, 100000UL, 1000000UL
+};
+
+/* Digits --------------------------------------------------------------------*/
+
+/**
+ * @brief Digits of value, written backwards ending at end
+ * @return Number of digits
+ */
+static uint32_t format_digits32(char *end, uint32_t value)
+{
+    char *p = end;
+    uint32_t pair;
+
+    while (value >= 100U)
+    {
+        pair = (value % 100U) * 2U;
+        value /= 100U;
+        *--p = format_pairs[pair + 1U];
+        *--p = format_pairs[pair];
+    }
+    if (value >= 10U)
+    {
+        pair = value * 2U;
+        *--p = format_pairs[pair + 1U];
+        *--p = format_pairs[pair];
+    }
+    else
+    {
+        *--p = (char)('0' + value);
+    }
+
+    return (uint32_t)(end - p);
+}
+
+/**
+ * @brief As format_digits32; 64-bit divisions only above 32 bits
+ */
+static uint32_t format_digits64(char *end, uint64_t value)
+{
+    uint32_t n = 0;
+    uint32_t low;
+    uint32_t i;
+
+    while (value > 0xFFFFFFFFULL)
+    {
+        low = (uint32_t)(value % 1000000000ULL);
+        value /= 1000000000ULL;
+        i = format_digits32(end - n, low);
+        for (; i < 9U; i++)
+        {
+            end[-(int32_t)(n + i) - 1] = '0';
+        }
+        n += 9U;
+    }
+
+    return n + format_digits32(end - n, (uint32_t)value);
+}
+
+static uint32_t format_copy(char *out, uint32_t size, const char *text, uint32_t length)
+{
+    if (length > size)
+    {
+        return 0;
+    }
+    memcpy(out, text, length);
+    return length;
+}
+
+/**
+ * @brief Sign, magnitude digits and a decimal point before the last decimals
+ */
+static uint32_t format_scaled(char *out, uint32_t size, int negative, uint64_t magnitude, uint32_t decimals)
+{
+    char text[FORMAT_DIGITS_MAX + 3U];
+    char *end = text + sizeof(text);
+    char *p;
+    uint32_t n;
+    uint32_t length;
+
+    n = format_digits64(end, magnitude);
+    for (; n < decimals + 1U; n++)
+    {
+        end[-(int32_t)n - 1] = '0';
+    }
+    p = end - n;
+
+    length = n + (negative ? 1U : 0U) + (decimals != 0U ? 1U : 0U);
+    if (length > size)
+    {
+        return 0;
+    }
+
+    if (negative)
+    {
+        *out++ = '-';
+    }
+    memcpy(out, p, n - decimals);
+    if (decimals != 0U)
+    {
+        out[n - decimals] = '.';
+        memcpy(out + n - decimals + 1U, end - decimals, decimals);
+    }
+
+    return length;
+}
+
+/* Numbers and times ---------------------------------------------------------*/
+
+uint32_t meteo_format_uint(char *out, uint32_t size, uint32_t value)
+{
+    char text[10];
+    uint32_t n = format_digits32(text + sizeof(text), value);
+
+    return format_copy(out, size, text + sizeof(text) - n, n);
+}
+
+uint32_t meteo_format_int(char *out, uint32_t size, int32_t value)
+{
+    return format_scaled(out, size, value < 0, (value < 0) ? 0U - (uint32_t)value : (uint32_t)value, 0);
+}
+
+uint32_t meteo_format_fixed(char *out, uint32_t size, int32_t value, uint32_t decimals)
+{
+    if (decimals > METEO_FORMAT_DECIMALS_MAX)
+    {
+        return 0;
+    }
+
+    return format_scaled(out, size, value < 0, (value < 0) ? 0U - (uint32_t)value : (uint32_t)value, decimals);
+}
+
+uint32_t meteo_format_float(char *out, uint32_t size, float value, uint32_t decimals)
+{
+    float magnitude = (value < 0.0f) ? -value : value;
+    uint32_t whole;
+    uint32_t fraction;
+
+    if (decimals > METEO_FORMAT_DECIMALS_MAX)
+    {
+        return 0;
+    }
+    if (value != value)
+    {
+        return format_copy(out, size, "nan", 3);
+    }
+    if (magnitude >= 2147483648.0f)
+    {
+        return format_copy(out, size, (value < 0.0f) ? "-inf" : "inf", (value < 0.0f) ? 4U : 3U);
+    }
+
+    // Whole part exact, the fraction scaled on its own: no digits are made
+    // up past the 24 bits of the float
+    whole = (uint32_t)magnitude;
+    fraction = (uint32_t)((magnitude - (float)whole) * (float)format_pow10[decimals] + 0.5f);
+
+    return format_scaled(out, size, value < 0.0f && (whole | fraction) != 0U,
+                         (uint64_t)whole * format_pow10[decimals] + fraction, decimals);
+}
+
+uint32_t meteo_format_seconds(char *out, uint32_t size, int64_t usec, uint32_t decimals)
+{
+    uint64_t magnitude = (usec < 0) ? 0U - (uint64_t)usec : (uint64_t)usec;
+
+    if (decimals > METEO_FORMAT_DECIMALS_MAX)
+    {
+        return 0;
+    }
+
+    return format_scaled(out, size, usec < 0, magnitude / format_pow10[METEO_FORMAT_DECIMALS_MAX - decimals],
+                         decimals);
+}
+
+uint32_t meteo_format_iso8601(char *out, uint32_t size, int64_t usec, uint32_t decimals)
+{
+    char text[METEO_FORMAT_ISO8601_MAX];
+    char digits[FORMAT_DIGITS_MAX];
+    char *p = text;
+    int64_t days;
+    int64_t era;
+    int64_t year;
+    int64_t rest;
+    uint32_t second;
+    uint32_t fraction;
+    uint32_t doe;
+    uint32_t yoe;
+    uint32_t doy;
+    uint32_t mp;
+    uint32_t month;
+    uint32_t day;
+    uint32_t n;
+    uint32_t i;
+
+    if (decimals != 0U && decimals != 3U && decimals != 6U)
+    {
+        return 0;
+    }
+
+    // Floor division: times before 1970 are in the days before it
+    days = usec / 86400000000LL;
+    rest = usec % 86400000000LL;
+    if (rest < 0)
+    {
+        days--;
+        rest += 86400000000LL;
+    }
+    second = (uint32_t)(rest / 1000000);
+    fraction = (uint32_t)(rest % 1000000);
+
+    // Civil date of a day number (days from 1970-01-01), H. Hinnant
+    days += 719468;
+    era = (days >= 0 ? days : days - 146096) / 146097;
+    doe = (uint32_t)(days - era * 146097);
+    yoe = (doe - doe / 1460U + doe / 36524U - doe / 146096U) / 365U;
+    doy = doe - (365U * yoe + yoe / 4U - yoe / 100U);
+    mp = (5U * doy + 2U) / 153U;
+    day = doy - (153U * mp + 2U) / 5U + 1U;
+    month = (mp < 10U) ? mp + 3U : mp - 9U;
+    year = (int64_t)yoe + era * 400 + (month <= 2U ? 1 : 0);
+
+    // Four digits, signed and longer outside 0000..9999
+    if (year < 0 || year > 9999)
+    {
+        *p++ = (year < 0) ? '-' : '+';
+    }
+    n = format_digits64(digits + sizeof(digits), (year < 0) ? 0U - (uint64_t)year : (uint64_t)year);
+    for (; n < 4U; n++)
+    {
+        digits[sizeof(digits) - n - 1U] = '0';
+    }
+    memcpy(p, digits + sizeof(digits) - n, n);
+    p += n;
+
+    p[0] = '-';
+    memcpy(p + 1, &format_pairs[month * 2U], 2);
+    p[3] = '-';
+    memcpy(p + 4, &format_pairs[day * 2U], 2);
+    p[6] = 'T';
+    memcpy(p + 7, &format_pairs[(second / 3600U) * 2U], 2);
+    p[9] = ':';
+    memcpy(p + 10, &format_pairs[((second / 60U) % 60U) * 2U], 2);
+    p[12] = ':';
+    memcpy(p + 13, &format_pairs[(second % 60U) * 2U], 2);
+    p += 15;
+
+    if (decimals != 0U)
+    {
+        *p++ = '.';
+        fraction /= format_pow10[METEO_FORMAT_DECIMALS_MAX - decimals];
+        for (i = decimals; i > 0U; i--)
+        {
+            p[i - 1U] = (char)('0' + fraction % 10U);
+            fraction /= 10U;
+        }
+        p += decimals;
+    }
+    *p++ = 'Z';
+
+    return format_copy(out, size, text, (uint32_t)(p - text));
+}
+
+/* Rows ----------------------------------------------------------------------*/
+
+static void writer_put(meteo_format_writer_t *writer, const char *text, uint32_t length)
+{
+    if (writer->overflow || length > writer->size - writer->end)
+    {
+        writer->overflow = 1;
+        return;
+    }
+    memcpy(writer->buffer + writer->end, text, length);
+    writer->end += length;
+}
+
+static void writer_field(meteo_format_writer_t *writer, const char *name)
+{
+    if (writer->style == METEO_FORMAT_JSON)
+    {
+        writer_put(writer, (writer->fields == 0U) ? "{\"" : ",\"", 2);
+        writer_put(writer, name, (uint32_t)strlen(name));
+        writer_put(writer, "\":", 2);
+    }
+    else if (writer->fields != 0U)
+    {
+        writer_put(writer, ",", 1);
+    }
+    writer->fields++;
+}
+
+/**
+ * @brief Account for a value written at the end of the row (0: did not fit)
+ */
+static void writer_value(meteo_format_writer_t *writer, uint32_t length)
+{
+    if (length == 0U)
+    {
+        writer->overflow = 1;
+    }
+    writer->end += length;
+}
+
+#define WRITER_OUT(w)   ((w)->buffer + (w)->end), ((w)->overflow ? 0U : (w)->size - (w)->end)
+
+void meteo_format_writer_init(meteo_format_writer_t *writer, char *buffer, uint32_t size,
+                              meteo_format_style_t style)
+{
+    writer->buffer = buffer;
+    writer->size = size;
+    writer->style = style;
+    meteo_format_writer_reset(writer);
+}
+
+void meteo_format_field_uint(meteo_format_writer_t *writer, const char *name, uint32_t value)
+{
+    writer_field(writer, name);
+    writer_value(writer, meteo_format_uint(WRITER_OUT(writer), value));
+}
+
+void meteo_format_field_fixed(meteo_format_writer_t *writer, const char *name, int32_t value, uint32_t decimals)
+{
+    writer_field(writer, name);
+    writer_value(writer, meteo_format_fixed(WRITER_OUT(writer), value, decimals));
+}
+
+void meteo_format_field_float(meteo_format_writer_t *writer, const char *name, float value, uint32_t decimals)
+{
+    writer_field(writer, name);
+    if (writer->style == METEO_FORMAT_JSON && (value != value || value - value != 0.0f))
+    {
+        // JSON has no nan / inf
+        writer_put(writer, "null", 4);
+        return;
+    }
+    writer_value(writer, meteo_format_float(WRITER_OUT(writer), value, decimals));
+}
+
+void meteo_format_field_seconds(meteo_format_writer_t *writer, const char *name, int64_t usec, uint32_t decimals)
+{
+    writer_field(writer, name);
+    writer_value(writer, meteo_format_seconds(WRITER_OUT(writer), usec, decimals));
+}
+
+void meteo_format_field_iso8601(meteo_format_writer_t *writer, const char *name, int64_t usec, uint32_t decimals)
+{
+    writer_field(writer, name);
+    if (writer->style == METEO_FORMAT_JSON)
+    {
+        writer_put(writer, "\"", 1);
+        writer_value(writer, meteo_format_iso8601(WRITER_OUT(writer), usec, decimals));
+        writer_put(writer, "\"", 1);
+    }
+    else
+    {
+        writer_value(writer, meteo_format_iso8601(WRITER_OUT(writer), usec, decimals));
+    }
+}
+
+uint32_t meteo_format_row_end(meteo_format_writer_t *writer)
+{
+    uint32_t length;
+
+    if (writer->style == METEO_FORMAT_JSON)
+    {
+        writer_put(writer, (writer->fields == 0U) ? "{}\n" : "}\n", (writer->fields == 0U) ? 3U : 2U);
+    }
+    else
+    {
+        writer_put(writer, "\n", 1);
+    }
+
+    writer->fields = 0;
+    if (writer->overflow)
+    {
+        writer->overflow = 0;
+        writer->end = writer->length;
+        return 0;
+    }
+
+    length = writer->end - writer->length;
+    writer->length = writer->end;
+    return length;
+}
+
+uint32_t meteo_format_row_text(meteo_format_writer_t *writer, const char *text)
+{
+    uint32_t length = (uint32_t)strlen(text);
+
+    if (length > writer->size - writer->length)
+    {
+        return 0;
+    }
+    memcpy(writer->buffer + writer->length, text, length);
+    writer->length += length;
+    writer->end = writer->length;
+    writer->fields = 0;
+    writer->overflow = 0;
+    return length;
+}
+
+void meteo_format_writer_reset(meteo_format_writer_t *writer)
+{
+    writer->length = 0;
+    writer->end = 0;
+    writer->fields = 0;
+    writer->overflow = 0;
+}
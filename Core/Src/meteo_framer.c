@@ -0,0 +1,67 @@
+/**
+ * @brief METEO frame delimiting, one byte at a time
+ * @version 19.10.26
+ * @author R.Oliva
+ * @description Moved out of HAL_UART_RxCpltCallback (main.c), with its state
+ *              in a meteo_framer_t, so the USART3 ISR and the simulator load
+ *              generator run the same code on separate instances.
+ *              Format: UUU$ttttt.bbbbb.dddd.sssss.vvv.CRCC*QQQ
+ *              19.10.26 The last 4 bytes are kept in a 32-bit window that
+ *              finds both "UUU$" and "*QQQ". The old buffer[index % 4] hunt
+ *              missed a header after 256 bytes of noise (uint8_t index wrap),
+ *              and a frame cut short swallowed the next one up to its *QQQ.
+ *              Now a UUU$ always starts a new frame (it cannot occur inside
+ *              a valid one), so the stress run loses no intact frame.
+ */
+
+#include "meteo_framer.h"
+#include <string.h>
+
+/* Last 4 bytes, newest in bits 0..7 */
+#define METEO_FRAMER_HEADER   0x55555524UL   /* "UUU$" */
+#define METEO_FRAMER_TRAILER  0x2A515151UL   /* "*QQQ" */
+
+void meteo_framer_reset(meteo_framer_t *framer)
+{
+    framer->window = 0;
+    framer->index = 0;
+    framer->in_frame = 0;
+}
+
+meteo_framer_result_t meteo_framer_byte(meteo_framer_t *framer, uint8_t byte)
+{
+    framer->window = (framer->window << 8) | byte;
+
+    /* Header: start (or restart) the frame */
+    if (framer->window == METEO_FRAMER_HEADER)
+    {
+        memcpy(framer->buffer, "UUU$", 4);
+        framer->index = 4;
+        framer->in_frame = 1;
+        return METEO_FRAMER_MORE;
+    }
+
+    if (!framer->in_frame)
+    {
+        return METEO_FRAMER_MORE;
+    }
+
+    /* Buffer overflow */
+    if (framer->index >= RX_BUFFER_SIZE - 1)
+    {
+        meteo_framer_reset(framer);
+        return METEO_FRAMER_OVERFLOW;
+    }
+
+    /* Collecting frame data until *QQQ */
+    framer->buffer[framer->index++] = (char)byte;
+    if (framer->window == METEO_FRAMER_TRAILER)
+    {
+        framer->buffer[framer->index] = '\0';
+        framer->index = 0;
+        framer->in_frame = 0;
+        return METEO_FRAMER_FRAME;
+    }
+
+    return METEO_FRAMER_MORE;
+}
@@ -0,0 +1,686 @@
+/**
+ * @brief Raw frame journal on OSPI flash, for store and forward
+ * @version 19.10.26
+ * @author R.Oliva
+ * @description The IDC agent only keeps Analitica's real-time view up to
+ *              date, so readings taken while the link is down were lost.
+ *              Every stored frame is now also appended to a ring of 64 KB
+ *              blocks at the top of the OSPI flash, as a 32-byte record
+ *              with a CRC-32. Slot n always holds seq n (mod capacity):
+ *              - a cursor is just a seq, seeking is arithmetic
+ *              - at start-up the newest block and the last slot in it are
+ *                found by binary search (about 20 reads, not a scan)
+ *              - a torn last record is skipped, its slot stays used
+ *              A block is erased when the writer enters it; records there
+ *              that were not acknowledged are counted as lost.
+ *              The uplink reads with its own cursor and acknowledges what
+ *              was delivered; the acknowledged seq is appended to a small
+ *              log in the last two blocks (also found by binary search).
+ *              Flash access is serialized with the ITTIA media driver by
+ *              meteo_ospi_lock(), held for one record or one read batch, so
+ *              a backlog drain never holds up the DB thread for long.
+ */
+
+#include "meteo_journal.h"
+#include "meteo_ospi.h"
+#include "main.h"
+#include <stdio.h>
+#include <string.h>
+
+#define JOURNAL_RECORD_SIZE     ((ULONG)sizeof(meteo_journal_record_t))
+#define JOURNAL_DATA_BLOCKS     (METEO_JOURNAL_BLOCKS - METEO_JOURNAL_ACK_BLOCKS)
+#define JOURNAL_CRC_BYTES       (sizeof(meteo_journal_record_t) - sizeof(uint32_t))
+#define JOURNAL_EVENT_APPEND    0x01UL
+
+// Slot states
+#define JOURNAL_SLOT_ERASED     0
+#define JOURNAL_SLOT_VALID      1
+#define JOURNAL_SLOT_BAD        2
+
+// Acknowledged position, check = ~seq (an erased entry never checks)
+typedef struct
+{
+    uint32_t seq;
+    uint32_t check;
+} journal_ack_t;
+
+static TX_EVENT_FLAGS_GROUP journal_events;
+
+static struct
+{
+    ULONG base;                 // flash address of data block 0
+    ULONG ack_base;             // flash address of ack block 0
+    ULONG block_size;
+    ULONG first_block;          // OSPI block number of data block 0
+    uint32_t per_block;         // records per block
+    uint32_t acks_per_block;
+    uint32_t ack_written;       // acknowledged seq on flash
+    ULONG ack_tick;
+    uint32_t ack_block;         // next ack entry
+    uint32_t ack_slot;
+    meteo_journal_stats_t stats;
+} journal;
+
+/**
+ * @brief CRC-32 (IEEE 802.3, reflected), 4 bits at a time
+ */
+static uint32_t journal_crc32(const uint8_t *data, ULONG length)
+{
+    static const uint32_t table[16] =
+    {
+        0x00000000UL, 0x1DB71064UL, 0x3B6E20C8UL, 0x26D930ACUL,
+        0x76DC4190UL, 0x6B6B51F4UL, 0x4DB26158UL, 0x5005713CUL,
+        0xEDB88320UL, 0xF00F9344UL, 0xD6D6A3E8UL, 0xCB61B38CUL,
+        0x9B64C2B0UL, 0x86D3D2D4UL, 0xA00AE278UL, 0xBDBDF21CUL
+    };
+    uint32_t crc = 0xFFFFFFFFUL;
+
+    while (length-- != 0U)
+    {
+        crc ^= *data++;
+        crc = (crc >> 4) ^ table[crc & 0x0FU];
+        crc = (crc >> 4) ^ table[crc & 0x0FU];
+    }
+
+    return ~crc;
+}
+
+/* Flash access, OSPI lock held --------------------------------------------*/
+
+static UINT journal_flash_read(ULONG address, void *buffer, ULONG bytes)
+{
+    return meteo_ospi_read(address, buffer, bytes);
+}
+
+static UINT journal_flash_write(ULONG address, const void *buffer, ULONG bytes)
+{
+    if (meteo_ospi_write(address, buffer, bytes) != TX_SUCCESS)
+    {
+        journal.stats.write_errors++;
+        return TX_NOT_DONE;
+    }
+
+    return TX_SUCCESS;
+}
+
+static UINT journal_flash_erase(ULONG address)
+{
+    if (meteo_ospi_erase_block(address / journal.block_size) != TX_SUCCESS)
+    {
+        journal.stats.write_errors++;
+        return TX_NOT_DONE;
+    }
+    journal.stats.erases++;
+
+    return TX_SUCCESS;
+}
+
+/* Records -------------------------------------------------------------------*/
+
+static ULONG journal_slot_address(uint32_t slot)
+{
+    return journal.base + (slot / journal.per_block) * journal.block_size +
+           (slot % journal.per_block) * JOURNAL_RECORD_SIZE;
+}
+
+/**
+ * @brief Erased, valid for this slot, or bad (torn, CRC error, stale)
+ */
+static UINT journal_slot_state(const meteo_journal_record_t *record, uint32_t slot)
+{
+    const uint32_t *word = (const uint32_t *)record;
+    UINT i;
+
+    for (i = 0; i < JOURNAL_RECORD_SIZE / sizeof(uint32_t) && word[i] == 0xFFFFFFFFUL; i++)
+    {
+    }
+    if (i == JOURNAL_RECORD_SIZE / sizeof(uint32_t))
+    {
+        return JOURNAL_SLOT_ERASED;
+    }
+
+    if (record->crc == journal_crc32((const uint8_t *)record, JOURNAL_CRC_BYTES) &&
+        (record->seq % journal.stats.capacity) == slot)
+    {
+        return JOURNAL_SLOT_VALID;
+    }
+
+    return JOURNAL_SLOT_BAD;
+}
+
+static UINT journal_read_slot(uint32_t slot, meteo_journal_record_t *record, UINT *state)
+{
+    UINT status = journal_flash_read(journal_slot_address(slot), record, JOURNAL_RECORD_SIZE);
+
+    journal.stats.open_reads++;
+    *state = journal_slot_state(record, slot);
+    return status;
+}
+
+/**
+ * @brief seq of the first slot of a data block, from slot 1 when slot 0 is torn
+ * @return 1 when known
+ */
+static UINT journal_block_first(uint32_t block, uint32_t *seq)
+{
+    meteo_journal_record_t record;
+    uint32_t slot = block * journal.per_block;
+    UINT state;
+
+    if (journal_read_slot(slot, &record, &state) != TX_SUCCESS)
+    {
+        return 0;
+    }
+    if (state == JOURNAL_SLOT_VALID)
+    {
+        *seq = record.seq;
+        return 1;
+    }
+    if (state == JOURNAL_SLOT_BAD &&
+        journal_read_slot(slot + 1U, &record, &state) == TX_SUCCESS &&
+        state == JOURNAL_SLOT_VALID)
+    {
+        *seq = record.seq - 1U;
+        return 1;
+    }
+
+    return 0;
+}
+
+/**
+ * @brief Find head and oldest: the newest block by binary search over the
+ *        block first seqs (one lap ahead of the blocks after it), then the
+ *        last written slot in it
+ */
+static UINT journal_find_head(void)
+{
+    meteo_journal_record_t record;
+    uint32_t first0;
+    uint32_t first;
+    uint32_t seq;
+    uint32_t head_block;
+    uint32_t lo;
+    uint32_t hi;
+    uint32_t mid;
+    UINT state;
+    UINT i;
+
+    journal.stats.boot = 1;
+
+    if (journal_block_first(0, &first0))
+    {
+        // Blocks of the current lap hold first0 + b * per_block
+        lo = 0;
+        hi = JOURNAL_DATA_BLOCKS - 1U;
+        while (lo < hi)
+        {
+            mid = (lo + hi + 1U) / 2U;
+            if (journal_block_first(mid, &seq) && seq == first0 + mid * journal.per_block)
+            {
+                lo = mid;
+            }
+            else
+            {
+                hi = mid - 1U;
+            }
+        }
+        head_block = lo;
+        first = first0 + lo * journal.per_block;
+    }
+    else if (journal_block_first(JOURNAL_DATA_BLOCKS - 1U, &first))
+    {
+        // Block 0 erased or torn on the way round: the last block is newest
+        head_block = JOURNAL_DATA_BLOCKS - 1U;
+    }
+    else
+    {
+        journal.stats.head = 0;
+        journal.stats.oldest = 0;
+        return TX_SUCCESS;
+    }
+
+    // Written slots first, erased after them
+    lo = 0;
+    hi = journal.per_block - 1U;
+    while (lo < hi)
+    {
+        mid = (lo + hi + 1U) / 2U;
+        if (journal_read_slot(head_block * journal.per_block + mid, &record, &state) != TX_SUCCESS)
+        {
+            return TX_NOT_DONE;
+        }
+        if (state != JOURNAL_SLOT_ERASED)
+        {
+            lo = mid;
+        }
+        else
+        {
+            hi = mid - 1U;
+        }
+    }
+
+    journal.stats.head = first + lo + 1U;
+    journal.stats.oldest = (first > (JOURNAL_DATA_BLOCKS - 1U) * journal.per_block) ?
+                           first - (JOURNAL_DATA_BLOCKS - 1U) * journal.per_block : 0U;
+
+    // Start-up count of the last good record
+    for (i = 0; i < 4U && i <= lo; i++)
+    {
+        if (journal_read_slot((journal.stats.head - 1U - i) % journal.stats.capacity,
+                              &record, &state) == TX_SUCCESS && state == JOURNAL_SLOT_VALID)
+        {
+            journal.stats.boot = (uint16_t)(record.boot + 1U);
+            break;
+        }
+    }
+
+    return TX_SUCCESS;
+}
+
+/* Acknowledged position -----------------------------------------------------*/
+
+static ULONG journal_ack_address(uint32_t block, uint32_t slot)
+{
+    return journal.ack_base + block * journal.block_size + slot * (ULONG)sizeof(journal_ack_t);
+}
+
+static UINT journal_ack_valid(const journal_ack_t *ack)
+{
+    return (ack->seq ^ ack->check) == 0xFFFFFFFFUL;
+}
+
+static UINT journal_ack_erased(const journal_ack_t *ack)
+{
+    return ack->seq == 0xFFFFFFFFUL && ack->check == 0xFFFFFFFFUL;
+}
+
+/**
+ * @brief Last entry of an ack block, by binary search
+ * @param slot Index of the last written entry
+ * @return 1 when the block holds a valid entry
+ */
+static UINT journal_ack_last(uint32_t block, uint32_t *slot, uint32_t *seq)
+{
+    journal_ack_t ack;
+    uint32_t lo = 0;
+    uint32_t hi = journal.acks_per_block - 1U;
+    uint32_t mid;
+
+    journal.stats.open_reads++;
+    if (journal_flash_read(journal_ack_address(block, 0), &ack, sizeof(ack)) != TX_SUCCESS ||
+        journal_ack_erased(&ack))
+    {
+        return 0;
+    }
+
+    while (lo < hi)
+    {
+        mid = (lo + hi + 1U) / 2U;
+        journal.stats.open_reads++;
+        if (journal_flash_read(journal_ack_address(block, mid), &ack, sizeof(ack)) != TX_SUCCESS)
+        {
+            return 0;
+        }
+        if (!journal_ack_erased(&ack))
+        {
+            lo = mid;
+        }
+        else
+        {
+            hi = mid - 1U;
+        }
+    }
+    *slot = lo;
+
+    // Torn last entry: the one before it
+    journal.stats.open_reads++;
+    if (journal_flash_read(journal_ack_address(block, lo), &ack, sizeof(ack)) == TX_SUCCESS &&
+        journal_ack_valid(&ack))
+    {
+        *seq = ack.seq;
+        return 1;
+    }
+    journal.stats.open_reads++;
+    if (lo > 0U &&
+        journal_flash_read(journal_ack_address(block, lo - 1U), &ack, sizeof(ack)) == TX_SUCCESS &&
+        journal_ack_valid(&ack))
+    {
+        *seq = ack.seq;
+        return 1;
+    }
+
+    return 0;
+}
+
+static UINT journal_find_ack(void)
+{
+    uint32_t slot[METEO_JOURNAL_ACK_BLOCKS] = { 0 };
+    uint32_t seq[METEO_JOURNAL_ACK_BLOCKS] = { 0 };
+    UINT valid[METEO_JOURNAL_ACK_BLOCKS];
+    uint32_t block;
+
+    for (block = 0; block < METEO_JOURNAL_ACK_BLOCKS; block++)
+    {
+        valid[block] = journal_ack_last(block, &slot[block], &seq[block]);
+    }
+
+    // Empty journal: forget an old position (ack block 0 is erased on first use)
+    if (journal.stats.head == 0U)
+    {
+        for (block = 0; block < METEO_JOURNAL_ACK_BLOCKS; block++)
+        {
+            if (valid[block] && journal_flash_erase(journal_ack_address(block, 0)) != TX_SUCCESS)
+            {
+                return TX_NOT_DONE;
+            }
+        }
+        journal.stats.acked = 0;
+        journal.ack_block = 0;
+        journal.ack_slot = 0;
+    }
+    else if (valid[0] || valid[1])
+    {
+        journal.ack_block = (valid[1] && (!valid[0] || seq[1] > seq[0])) ? 1U : 0U;
+        journal.ack_slot = slot[journal.ack_block] + 1U;
+        journal.stats.acked = seq[journal.ack_block];
+    }
+    else
+    {
+        // Nothing acknowledged yet: everything on flash is to be sent
+        journal.stats.acked = journal.stats.oldest;
+        journal.ack_block = 0;
+        journal.ack_slot = 0;
+    }
+
+    if (journal.stats.acked < journal.stats.oldest)
+    {
+        journal.stats.lost += journal.stats.oldest - journal.stats.acked;
+        journal.stats.acked = journal.stats.oldest;
+    }
+    if (journal.stats.acked > journal.stats.head)
+    {
+        journal.stats.acked = journal.stats.head;
+    }
+    journal.ack_written = journal.stats.acked;
+    journal.ack_tick = tx_time_get();
+
+    return TX_SUCCESS;
+}
+
+/**
+ * @brief Append the acknowledged seq to the ack log
+ */
+static UINT journal_ack_write(void)
+{
+    journal_ack_t ack;
+
+    if (journal.ack_slot >= journal.acks_per_block)
+    {
+        journal.ack_block = (journal.ack_block + 1U) % METEO_JOURNAL_ACK_BLOCKS;
+        journal.ack_slot = 0;
+    }
+    if (journal.ack_slot == 0U &&
+        journal_flash_erase(journal_ack_address(journal.ack_block, 0)) != TX_SUCCESS)
+    {
+        return TX_NOT_DONE;
+    }
+
+    ack.seq = journal.stats.acked;
+    ack.check = ~ack.seq;
+    journal.ack_written = ack.seq;
+    journal.ack_tick = tx_time_get();
+
+    // The slot is used even if the write failed
+    return journal_flash_write(journal_ack_address(journal.ack_block, journal.ack_slot++),
+                               &ack, sizeof(ack));
+}
+
+/* API -----------------------------------------------------------------------*/
+
+void meteo_journal_init(void)
+{
+    if (tx_event_flags_create(&journal_events, "METEO Journal Events") != TX_SUCCESS)
+    {
+        printf("[JOURNAL] Create failed\n");
+    }
+}
+
+UINT meteo_journal_open(void)
+{
+    ULONG block_size;
+    ULONG total_blocks;
+    UINT status;
+
+    if (meteo_ospi_get_info(&block_size, &total_blocks) != TX_SUCCESS ||
+        total_blocks <= METEO_JOURNAL_BLOCKS)
+    {
+        printf("[JOURNAL] No OSPI geometry\n");
+        return TX_NOT_DONE;
+    }
+
+    meteo_ospi_lock();
+
+    memset(&journal.stats, 0, sizeof(journal.stats));
+    journal.block_size = block_size;
+    journal.first_block = total_blocks - METEO_JOURNAL_BLOCKS;
+    journal.base = journal.first_block * block_size;
+    journal.ack_base = journal.base + JOURNAL_DATA_BLOCKS * block_size;
+    journal.per_block = block_size / JOURNAL_RECORD_SIZE;
+    journal.acks_per_block = block_size / sizeof(journal_ack_t);
+    journal.stats.capacity = JOURNAL_DATA_BLOCKS * journal.per_block;
+
+    status = journal_find_head();
+    if (status == TX_SUCCESS)
+    {
+        status = journal_find_ack();
+    }
+    journal.stats.opened = (status == TX_SUCCESS);
+
+    meteo_ospi_unlock();
+
+    if (status != TX_SUCCESS)
+    {
+        printf("[JOURNAL] Open failed - flash error\n");
+        return status;
+    }
+
+    printf("[JOURNAL] Blocks %lu-%lu: seq %lu..%lu, %lu to send, boot %u (%lu reads)\n",
+           (unsigned long)journal.first_block,
+           (unsigned long)(journal.first_block + METEO_JOURNAL_BLOCKS - 1U),
+           (unsigned long)journal.stats.oldest, (unsigned long)journal.stats.head,
+           (unsigned long)(journal.stats.head - journal.stats.acked),
+           (unsigned)journal.stats.boot, (unsigned long)journal.stats.open_reads);
+    tx_event_flags_set(&journal_events, JOURNAL_EVENT_APPEND, TX_OR);
+
+    return TX_SUCCESS;
+}
+
+UINT meteo_journal_append_frame(const char *frame)
+{
+    meteo_journal_record_t record;
+    unsigned int temp;
+    unsigned int pressure;
+    unsigned int wind_dir;
+    unsigned int wind_speed;
+    unsigned int voltage;
+    uint32_t slot;
+    uint32_t oldest;
+    UINT status = TX_SUCCESS;
+
+    // Format: UUU$ttttt.bbbbb.dddd.sssss.vvv.CRCC*QQQ (checksum already checked)
+    if (sscanf(frame, "UUU$%5u.%5u.%4u.%5u.%3u",
+               &temp, &pressure, &wind_dir, &wind_speed, &voltage) != 5)
+    {
+        return TX_SIZE_ERROR;
+    }
+
+    meteo_ospi_lock();
+
+    if (!journal.stats.opened)
+    {
+        meteo_ospi_unlock();
+        return TX_NOT_AVAILABLE;
+    }
+
+    slot = journal.stats.head % journal.stats.capacity;
+    if ((slot % journal.per_block) == 0U)
+    {
+        // Entering a block: what it held is gone
+        status = journal_flash_erase(journal_slot_address(slot));
+        if (journal.stats.head + journal.per_block > journal.stats.capacity)
+        {
+            oldest = journal.stats.head + journal.per_block - journal.stats.capacity;
+            if (oldest > journal.stats.oldest)
+            {
+                journal.stats.oldest = oldest;
+            }
+        }
+        if (journal.stats.acked < journal.stats.oldest)
+        {
+            journal.stats.lost += journal.stats.oldest - journal.stats.acked;
+            journal.stats.acked = journal.stats.oldest;
+        }
+    }
+
+    if (status == TX_SUCCESS)
+    {
+        record.seq = journal.stats.head;
+        record.time_ms = HAL_GetTick();
+        record.temp = temp;
+        record.pressure = pressure;
+        record.wind_speed = wind_speed;
+        record.wind_dir = (uint16_t)wind_dir;
+        record.voltage = (uint16_t)voltage;
+        record.boot = journal.stats.boot;
+        record.reserved = 0;
+        record.crc = journal_crc32((const uint8_t *)&record, JOURNAL_CRC_BYTES);
+
+        // A failed write may leave a torn record: the slot is used either way
+        status = journal_flash_write(journal_slot_address(slot), &record, sizeof(record));
+        journal.stats.head++;
+    }
+
+    meteo_ospi_unlock();
+
+    tx_event_flags_set(&journal_events, JOURNAL_EVENT_APPEND, TX_OR);
+    return status;
+}
+
+void meteo_journal_cursor_init(meteo_journal_cursor_t *cursor)
+{
+    cursor->next = journal.stats.acked;
+}
+
+UINT meteo_journal_read(meteo_journal_cursor_t *cursor, meteo_journal_record_t *records,
+                        UINT max, UINT *count)
+{
+    uint32_t slot;
+    uint32_t n;
+    uint32_t i;
+    UINT kept;
+    UINT status = TX_SUCCESS;
+
+    *count = 0;
+
+    meteo_ospi_lock();
+
+    if (!journal.stats.opened)
+    {
+        meteo_ospi_unlock();
+        return TX_NOT_AVAILABLE;
+    }
+
+    if (cursor->next < journal.stats.oldest)
+    {
+        cursor->next = journal.stats.oldest;
+    }
+    if (cursor->next > journal.stats.head)
+    {
+        cursor->next = journal.stats.head;
+    }
+
+    while (*count < max && cursor->next < journal.stats.head)
+    {
+        // Contiguous on flash up to the end of the block
+        slot = cursor->next % journal.stats.capacity;
+        n = max - *count;
+        if (n > journal.stats.head - cursor->next)
+        {
+            n = journal.stats.head - cursor->next;
+        }
+        if (n > journal.per_block - (slot % journal.per_block))
+        {
+            n = journal.per_block - (slot % journal.per_block);
+        }
+
+        status = journal_flash_read(journal_slot_address(slot), &records[*count], n * JOURNAL_RECORD_SIZE);
+        if (status != TX_SUCCESS)
+        {
+            break;
+        }
+
+        // Keep the valid ones, in place
+        for (i = 0, kept = *count; i < n; i++)
+        {
+            if (journal_slot_state(&records[*count + i], slot + i) == JOURNAL_SLOT_VALID &&
+                records[*count + i].seq == cursor->next + i)
+            {
+                records[kept++] = records[*count + i];
+            }
+            else
+            {
+                journal.stats.bad++;
+            }
+        }
+        *count = kept;
+        cursor->next += n;
+    }
+
+    meteo_ospi_unlock();
+
+    return status;
+}
+
+UINT meteo_journal_wait(const meteo_journal_cursor_t *cursor, ULONG wait_option)
+{
+    ULONG actual;
+
+    if (cursor->next < journal.stats.head)
+    {
+        return TX_SUCCESS;
+    }
+    (void)tx_event_flags_get(&journal_events, JOURNAL_EVENT_APPEND, TX_OR_CLEAR, &actual, wait_option);
+
+    return (cursor->next < journal.stats.head) ? TX_SUCCESS : TX_NO_EVENTS;
+}
+
+UINT meteo_journal_ack(uint32_t next_seq)
+{
+    UINT status = TX_SUCCESS;
+
+    meteo_ospi_lock();
+
+    if (next_seq > journal.stats.head)
+    {
+        status = TX_SIZE_ERROR;
+    }
+    else if (next_seq > journal.stats.acked)
+    {
+        journal.stats.acked = next_seq;
+        if ((journal.stats.acked - journal.ack_written >= METEO_JOURNAL_ACK_EVERY) ||
+            (tx_time_get() - journal.ack_tick >= METEO_JOURNAL_ACK_TICKS))
+        {
+            status = journal_ack_write();
+        }
+    }
+
+    meteo_ospi_unlock();
+
+    return status;
+}
+
+void meteo_journal_get_stats(meteo_journal_stats_t *stats)
+{
+    // Snapshot for display, not locked
+    *stats = journal.stats;
+}
@@ -0,0 +1,106 @@
+/**
+ * @brief OSPI flash access shared by the METEO modules
+ * @version 19.10.26
+ * @author R.Oliva
+ * @description Moved out of meteo_journal.c when the archive segments got a
+ *              region of their own. Every OSPI user, the ITTIA media driver
+ *              included, takes meteo_ospi_lock() around its transfers; the
+ *              mutex inherits priority, so the DB thread is not held up by a
+ *              lower priority reader for longer than one transfer.
+ */
+
+#include "meteo_ospi.h"
+#include "meteo_trace.h"
+#include "lx_stm32_ospi_driver.h"
+#include <stdint.h>
+#include <stdio.h>
+
+static TX_MUTEX ospi_mutex;
+
+void meteo_ospi_init(void)
+{
+    if (tx_mutex_create(&ospi_mutex, "METEO OSPI Mutex", TX_INHERIT) != TX_SUCCESS)
+    {
+        printf("[OSPI] Mutex create failed\n");
+    }
+}
+
+void meteo_ospi_lock(void)
+{
+    (void)tx_mutex_get(&ospi_mutex, TX_WAIT_FOREVER);
+}
+
+void meteo_ospi_unlock(void)
+{
+    (void)tx_mutex_put(&ospi_mutex);
+}
+
+UINT meteo_ospi_get_info(ULONG *block_size, ULONG *total_blocks)
+{
+    return (lx_stm32_ospi_get_info(LX_STM32_OSPI_INSTANCE, block_size, total_blocks) == 0) ?
+           TX_SUCCESS : TX_NOT_DONE;
+}
+
+/**
+ * @brief Wait until the OSPI is not busy
+ */
+static UINT ospi_ready(void)
+{
+    ULONG start = tx_time_get();
+
+    while (tx_time_get() - start < LX_STM32_OSPI_DEFAULT_TIMEOUT)
+    {
+        if (lx_stm32_ospi_get_status(LX_STM32_OSPI_INSTANCE) == 0)
+        {
+            return TX_SUCCESS;
+        }
+    }
+
+    return TX_NOT_DONE;
+}
+
+UINT meteo_ospi_read(ULONG address, void *buffer, ULONG bytes)
+{
+    UINT status = 0;
+
+    if (ospi_ready() != TX_SUCCESS ||
+        lx_stm32_ospi_read(LX_STM32_OSPI_INSTANCE, (ULONG *)(uintptr_t)address, (ULONG *)buffer,
+                           bytes / sizeof(ULONG)) != 0)
+    {
+        return TX_NOT_DONE;
+    }
+    LX_STM32_OSPI_READ_CPLT_NOTIFY(status);
+
+    return (status == 0) ? TX_SUCCESS : TX_NOT_DONE;
+}
+
+UINT meteo_ospi_write(ULONG address, const void *buffer, ULONG bytes)
+{
+    UINT status = 0;
+
+    if (ospi_ready() != TX_SUCCESS ||
+        lx_stm32_ospi_write(LX_STM32_OSPI_INSTANCE, (ULONG *)(uintptr_t)address, (ULONG *)buffer,
+                            bytes / sizeof(ULONG)) != 0)
+    {
+        return TX_NOT_DONE;
+    }
+    LX_STM32_OSPI_WRITE_CPLT_NOTIFY(status);
+
+    return (status == 0) ? TX_SUCCESS : TX_NOT_DONE;
+}
+
+UINT meteo_ospi_erase_block(ULONG block)
+{
+    INT status;
+
+    if (ospi_ready() != TX_SUCCESS)
+    {
+        return TX_NOT_DONE;
+    }
+
+    METEO_TRACE(METEO_TRACE_OSPI_ERASE_BEGIN, block, 0);
+    status = lx_stm32_ospi_erase(LX_STM32_OSPI_INSTANCE, block, 0, 0);
+    METEO_TRACE(METEO_TRACE_OSPI_ERASE_END, block, status);
+
+    return (status == 0) ? TX_SUCCESS : TX_NOT_DONE;
+}
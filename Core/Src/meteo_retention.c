@@ -0,0 +1,303 @@
+/**
+ * @brief Age and byte budgets of the stored readings
+ * @version 19.10.26
+ * @author R.Oliva
+ * @description The archive ring and the series storage only made room when
+ *              they were full: the writer erased the oldest archive block as
+ *              it entered it, in the DB thread, and the series dropped pages
+ *              past METEO_SERIES_MAX_BYTES on a put. Nothing went by age.
+ *              A low-priority thread now trims them to a configured age and
+ *              byte budget, one bounded step per METEO_RETENTION_PERIOD_TICKS
+ *              and only while meteo_frame_queue is empty:
+ *              - archive: the oldest block is erased once its newest sample
+ *                is past the age, or the blocks in use pass the budget
+ *                (meteo_archive_store_trim). The default budget leaves
+ *                METEO_RETENTION_SPARE_BLOCKS erased ahead of the writer.
+ *              - series (METEO_SERIES_ENABLED): the points past the age go
+ *                METEO_RETENTION_SERIES_STEP_S at a time (meteo_series_trim);
+ *                the byte budget is the storage's own retention
+ *                (meteo_series_set_retention).
+ *              - table (meteo_retention_set_table): the meteo_readings4
+ *                rows past the age go by a ranged delete on ts
+ *                (delete_meteo_readings_before), METEO_RETENTION_TABLE_ROWS
+ *                rows looked at a step, resuming at the next id. The board
+ *                keeps no table for now (the IDC agent takes the rows from
+ *                the stream), so none is set there.
+ *              Each step that frees something is timed with the execution
+ *              profile time source and reported with the bytes freed.
+ */
+
+#include "meteo_retention.h"
+#include "meteo_series.h"
+#include "meteo_database.h"
+#include "main.h"
+#include <stdio.h>
+#include <string.h>
+
+#ifdef TX_EXECUTION_PROFILE_ENABLE
+#include "tx_execution_profile.h"
+#ifdef TX_LINUX_SPEEDUP_ENV
+#define RETENTION_TIME_PER_US   1000U                           // ns on the Linux host
+#else
+#define RETENTION_TIME_PER_US   (SystemCoreClock / 1000000U)    // DWT cycles
+#endif
+#endif
+
+static TX_MUTEX retention_mutex;
+static meteo_retention_config_t retention_config;
+static meteo_retention_stats_t retention_stats;
+
+static char retention_table_name[METEO_RETENTION_TABLE_NAME_SIZE];
+
+// Retention thread only
+static db_t retention_table_db;
+static char retention_table_connected[METEO_RETENTION_TABLE_NAME_SIZE];
+static int32_t retention_table_next_id = INT32_MIN;
+#if METEO_SERIES_ENABLED
+static int64_t retention_series_bytes;      // applied, 0 = storage default
+#endif
+
+/**
+ * @brief Time source for a step: execution profile units, else ticks
+ */
+static ULONG retention_time(void)
+{
+#ifdef TX_EXECUTION_PROFILE_ENABLE
+    return (ULONG)TX_EXECUTION_TIME_SOURCE;
+#else
+    return tx_time_get();
+#endif
+}
+
+static uint32_t retention_elapsed_us(ULONG start)
+{
+    // Modulo the width of the source: a step is well within one wrap
+    ULONG elapsed = retention_time() - start;
+
+#ifdef TX_EXECUTION_PROFILE_ENABLE
+    return (uint32_t)(elapsed / RETENTION_TIME_PER_US);
+#else
+    return (uint32_t)(elapsed * (1000000U / TX_TIMER_TICKS_PER_SECOND));
+#endif
+}
+
+void meteo_retention_init(void)
+{
+    memset(&retention_stats, 0, sizeof(retention_stats));
+    retention_config.max_age_s = METEO_RETENTION_MAX_AGE_S;
+    retention_config.archive_bytes = METEO_RETENTION_ARCHIVE_BYTES;
+#if METEO_SERIES_ENABLED
+    retention_config.series_bytes = METEO_SERIES_RETAIN_BYTES;
+#endif
+
+    if (tx_mutex_create(&retention_mutex, "METEO Retention Mutex", TX_INHERIT) != TX_SUCCESS)
+    {
+        printf("[RETENTION] Create failed\n");
+    }
+}
+
+UINT meteo_retention_set_config(const meteo_retention_config_t *config)
+{
+    if (config->archive_bytes == 0U || config->series_bytes < 0)
+    {
+        return TX_SIZE_ERROR;
+    }
+
+    tx_mutex_get(&retention_mutex, TX_WAIT_FOREVER);
+    retention_config = *config;
+    tx_mutex_put(&retention_mutex);
+
+    return TX_SUCCESS;
+}
+
+void meteo_retention_get_config(meteo_retention_config_t *config)
+{
+    tx_mutex_get(&retention_mutex, TX_WAIT_FOREVER);
+    *config = retention_config;
+    tx_mutex_put(&retention_mutex);
+}
+
+UINT meteo_retention_set_table(const char *database_name)
+{
+    if (database_name != NULL && strlen(database_name) >= sizeof(retention_table_name))
+    {
+        return TX_SIZE_ERROR;
+    }
+
+    tx_mutex_get(&retention_mutex, TX_WAIT_FOREVER);
+    strcpy(retention_table_name, (database_name != NULL) ? database_name : "");
+    tx_mutex_put(&retention_mutex);
+
+    return TX_SUCCESS;
+}
+
+/**
+ * @brief Ranged delete on the table set, through this thread's connection
+ * @return TX_SUCCESS, TX_NOT_AVAILABLE with no table, TX_NOT_DONE on a
+ *         database error
+ */
+static UINT retention_table_trim(int64_t before_usec, uint32_t *rows, int64_t *bytes)
+{
+    char name[METEO_RETENTION_TABLE_NAME_SIZE];
+    size_t removed;
+    size_t removed_bytes;
+    dbstatus_t status;
+
+    tx_mutex_get(&retention_mutex, TX_WAIT_FOREVER);
+    strcpy(name, retention_table_name);
+    tx_mutex_put(&retention_mutex);
+
+    if (retention_table_db != NULL && strcmp(name, retention_table_connected) != 0)
+    {
+        (void)db_disconnect(retention_table_db);
+        retention_table_db = NULL;
+        retention_table_next_id = INT32_MIN;
+    }
+    if (name[0] == '\0')
+    {
+        return TX_NOT_AVAILABLE;
+    }
+    if (retention_table_db == NULL)
+    {
+        if (DB_FAILED(db_connect(&retention_table_db, name, NULL, NULL, NULL)))
+        {
+            retention_table_db = NULL;
+            return TX_NOT_DONE;
+        }
+        strcpy(retention_table_connected, name);
+    }
+
+    status = delete_meteo_readings_before(retention_table_db, (db_timestamp_usec_t)before_usec,
+                                          METEO_RETENTION_TABLE_ROWS, &retention_table_next_id,
+                                          &removed, &removed_bytes);
+    *rows = (uint32_t)removed;
+    *bytes = (int64_t)removed_bytes;
+    return DB_SUCCESS(status) ? TX_SUCCESS : TX_NOT_DONE;
+}
+
+UINT meteo_retention_step(int64_t *bytes)
+{
+    meteo_retention_config_t config;
+    int64_t before_usec = INT64_MIN;
+    int64_t now_usec;
+    int64_t freed;
+    ULONG block_bytes = 0;
+    uint32_t removed = 0U;
+    uint32_t rows = 0U;
+    uint32_t usec;
+    ULONG start;
+    UINT status;
+
+    meteo_retention_get_config(&config);
+    // Read with no age limit as well: it counts the wraps of the tick
+    now_usec = meteo_archive_store_now();
+    if (config.max_age_s != 0U)
+    {
+        before_usec = now_usec - (int64_t)config.max_age_s * 1000000;
+    }
+
+    start = retention_time();
+    status = meteo_archive_store_trim(before_usec, config.archive_bytes, &block_bytes);
+    freed = (int64_t)block_bytes;
+#if METEO_SERIES_ENABLED
+    if (status != TX_NOT_DONE && freed == 0)
+    {
+        UINT series_status = TX_SUCCESS;
+
+        if (config.series_bytes != 0 && config.series_bytes != retention_series_bytes)
+        {
+            series_status = meteo_series_set_retention(config.series_bytes);
+            retention_series_bytes = (series_status == TX_SUCCESS) ? config.series_bytes : retention_series_bytes;
+        }
+        if (series_status == TX_SUCCESS && config.max_age_s != 0U)
+        {
+            series_status = meteo_series_trim(before_usec, (int64_t)METEO_RETENTION_SERIES_STEP_S * 1000000,
+                                              &removed, &freed);
+        }
+        // Stream only: not an error
+        status = (series_status == TX_NOT_AVAILABLE) ? status : series_status;
+    }
+#endif
+    if (status != TX_NOT_DONE && freed == 0 && config.max_age_s != 0U)
+    {
+        UINT table_status = retention_table_trim(before_usec, &rows, &freed);
+
+        // No table: not an error
+        status = (table_status == TX_NOT_AVAILABLE) ? status : table_status;
+    }
+    usec = retention_elapsed_us(start);
+
+    tx_mutex_get(&retention_mutex, TX_WAIT_FOREVER);
+    if (status == TX_NOT_DONE)
+    {
+        retention_stats.errors++;
+    }
+    if (block_bytes != 0U || removed != 0U || rows != 0U)
+    {
+        retention_stats.steps++;
+        retention_stats.archive_blocks += (block_bytes != 0U) ? 1U : 0U;
+        retention_stats.series_removed += removed;
+        retention_stats.table_removed += rows;
+        retention_stats.bytes += freed;
+        retention_stats.last_us = usec;
+        retention_stats.max_us = (usec > retention_stats.max_us) ? usec : retention_stats.max_us;
+        retention_stats.total_us += usec;
+    }
+    tx_mutex_put(&retention_mutex);
+
+    if (block_bytes != 0U)
+    {
+        printf("[RETENTION] Archive block erased: %lu bytes in %lu us\n",
+               (unsigned long)block_bytes, (unsigned long)usec);
+    }
+    else if (removed != 0U)
+    {
+        printf("[RETENTION] Series: %lu timestamps, %ld bytes in %lu us\n",
+               (unsigned long)removed, (long)freed, (unsigned long)usec);
+    }
+    else if (rows != 0U)
+    {
+        printf("[RETENTION] Table: %lu rows, %ld bytes in %lu us\n",
+               (unsigned long)rows, (long)freed, (unsigned long)usec);
+    }
+
+    if (bytes != NULL)
+    {
+        *bytes = freed;
+    }
+    return status;
+}
+
+void meteo_retention_thread_entry(ULONG thread_input)
+{
+    ULONG enqueued;
+    int busy;
+
+    (void)thread_input;
+
+    while (1)
+    {
+        tx_thread_sleep(METEO_RETENTION_PERIOD_TICKS);
+
+        // Frames waiting: the DB thread comes first, try again next period
+        busy = (tx_queue_info_get(&meteo_frame_queue, TX_NULL, &enqueued, TX_NULL,
+                                  TX_NULL, TX_NULL, TX_NULL) == TX_SUCCESS && enqueued != 0U);
+
+        tx_mutex_get(&retention_mutex, TX_WAIT_FOREVER);
+        retention_stats.periods++;
+        retention_stats.busy += busy ? 1U : 0U;
+        tx_mutex_put(&retention_mutex);
+
+        if (!busy)
+        {
+            (void)meteo_retention_step(NULL);
+        }
+    }
+}
+
+void meteo_retention_get_stats(meteo_retention_stats_t *stats)
+{
+    tx_mutex_get(&retention_mutex, TX_WAIT_FOREVER);
+    *stats = retention_stats;
+    tx_mutex_put(&retention_mutex);
+}
@@ -0,0 +1,463 @@
+/**
+ * @brief A float32 time series per channel in ITTIA DB IoT storage
+ * @version 19.10.26
+ * @author R.Oliva
+ * @description The stream stores a meteo_readings row (id, ts, three
+ *              doubles) for every kept reading, even when only one channel
+ *              moved, and pressure and voltage are not stored at all. With
+ *              METEO_SERIES_ENABLED the DB thread also puts each channel
+ *              into its own float32 series of the IoT storage
+ *              (db_open_time_series / db_time_series_put_float32): a point
+ *              is a timestamp and a float, and with METEO_SERIES_COMPRESS a
+ *              channel gets only the points of its own deadband / swinging
+ *              door (meteo_compress_add), not those the other channels
+ *              needed. The storage drops its oldest pages past
+ *              METEO_SERIES_MAX_BYTES (db_set_time_series_data_retention).
+ *              Rows come back with one query over all the series
+ *              (db_prepare_time_series_query): a row per timestamp where
+ *              any channel has a point, the others held at their last
+ *              one, in the meteo_archive_sample_t of the archive, so the
+ *              export formats them as it does the archive.
+ *              A connection belongs to one thread: the DB thread puts
+ *              through its own, each cursor opens another, and so does
+ *              the retention thread that trims the series by age
+ *              (db_time_series_remove_before, an hour at a time).
+ */
+
+#include "meteo_series.h"
+#include "meteo_compress.h"
+#include <stdio.h>
+#include <string.h>
+
+#define SERIES_ALL_CHANNELS     ((1UL << METEO_ARCHIVE_CHANNELS) - 1U)
+
+// As the CSV export columns
+static const char *series_names[METEO_ARCHIVE_CHANNELS] =
+{
+    "temperature", "pressure", "wind_speed", "wind_direction", "voltage"
+};
+
+static TX_MUTEX series_mutex;
+
+// Page cache of the storage: static, it is used until the storage closes
+static uint32_t series_cache[METEO_SERIES_CACHE_SIZE / sizeof(uint32_t)];
+
+// DB thread only
+static db_t series_db;
+static db_time_series_t series[METEO_ARCHIVE_CHANNELS];
+#if METEO_SERIES_COMPRESS
+static meteo_compress_t series_channel[METEO_ARCHIVE_CHANNELS];
+static meteo_compress_config_t series_config[METEO_ARCHIVE_CHANNELS];
+#endif
+
+static meteo_series_stats_t series_stats;
+
+// Retention thread only
+static db_t series_trim_db;
+static uint8_t series_trim_connected;
+
+void meteo_series_init(void)
+{
+    memset(&series_stats, 0, sizeof(series_stats));
+
+    if (tx_mutex_create(&series_mutex, "METEO Series Mutex", TX_INHERIT) != TX_SUCCESS)
+    {
+        printf("[SERIES] Create failed\n");
+    }
+}
+
+UINT meteo_series_open(void)
+{
+    dbstatus_t status;
+    uint32_t opened = 0U;
+    int connected = 0;
+    uint32_t c;
+
+    status = db_open_iot_file_storage(METEO_SERIES_FILE, NULL, DB_OPEN_OR_CREATE | DB_TIME_SERIES_FAST_RANGE,
+                                      DB_DEF_PAGE_SIZE, series_cache, sizeof(series_cache), NULL);
+    if (DB_SUCCESS(status))
+    {
+        status = db_connect(&series_db, METEO_SERIES_FILE, NULL, NULL, NULL);
+        connected = DB_SUCCESS(status);
+        if (!connected)
+        {
+            (void)db_close_storage(METEO_SERIES_FILE);
+        }
+    }
+    for (c = 0; c < METEO_ARCHIVE_CHANNELS && DB_SUCCESS(status); c++)
+    {
+        status = db_open_time_series(&series[c], series_db, series_names[c], DB_COLTYPE_FLOAT32);
+        opened += DB_SUCCESS(status) ? 1U : 0U;
+    }
+    if (opened == METEO_ARCHIVE_CHANNELS)
+    {
+        status = db_set_time_series_data_retention(series_db, METEO_SERIES_RETAIN_BYTES, METEO_SERIES_MAX_BYTES);
+    }
+    if (connected && DB_FAILED(status))
+    {
+        // Not half a set of series
+        while (opened > 0U)
+        {
+            (void)db_close_time_series(series[--opened]);
+        }
+        (void)db_disconnect(series_db);
+        (void)db_close_storage(METEO_SERIES_FILE);
+    }
+
+#if METEO_SERIES_COMPRESS
+    for (c = 0; c < METEO_ARCHIVE_CHANNELS; c++)
+    {
+        meteo_compress_reset(&series_channel[c]);
+        (void)meteo_compress_get_config(c, &series_config[c]);
+    }
+#endif
+
+    tx_mutex_get(&series_mutex, TX_WAIT_FOREVER);
+    series_stats.open_status = (int32_t)status;
+    series_stats.opened = DB_SUCCESS(status) ? 1U : 0U;
+    tx_mutex_put(&series_mutex);
+
+    if (DB_FAILED(status))
+    {
+        printf("[SERIES] Open failed (%ld), stream only\n", (long)status);
+        return TX_NOT_DONE;
+    }
+    printf("[SERIES] %s: %u series, retain %ld of %ld bytes\n", METEO_SERIES_FILE,
+           (unsigned)METEO_ARCHIVE_CHANNELS, (long)METEO_SERIES_RETAIN_BYTES, (long)METEO_SERIES_MAX_BYTES);
+    return TX_SUCCESS;
+}
+
+uint32_t meteo_series_add(const meteo_archive_sample_t *sample)
+{
+    int64_t points_usec[2];
+    float points[2];
+    uint32_t put = 0U;
+    uint32_t errors = 0U;
+    uint32_t kept;
+    uint32_t c;
+    uint32_t i;
+    db_file_info_t info;
+    int info_ok = 0;
+
+    // Written by this thread only
+    if (!series_stats.opened)
+    {
+        return 0U;
+    }
+
+    for (c = 0; c < METEO_ARCHIVE_CHANNELS; c++)
+    {
+#if METEO_SERIES_COMPRESS
+        meteo_compress_config_t config;
+
+        (void)meteo_compress_get_config(c, &config);
+        if (config.mode != series_config[c].mode || config.circular != series_config[c].circular ||
+            config.tolerance != series_config[c].tolerance || config.heartbeat_s != series_config[c].heartbeat_s)
+        {
+            // As the stream: the door so far was for the old tolerance
+            series_config[c] = config;
+            meteo_compress_reset(&series_channel[c]);
+        }
+        kept = meteo_compress_add(&series_channel[c], &series_config[c], sample->ts_usec, sample->value[c],
+                                  points_usec, points);
+#else
+        points_usec[0] = sample->ts_usec;
+        points[0] = sample->value[c];
+        kept = 1U;
+#endif
+        for (i = 0; i < kept; i++)
+        {
+            if (DB_SUCCESS(db_time_series_put_float32(series[c], (db_timestamp_usec_t)points_usec[i], points[i])))
+            {
+                put++;
+            }
+            else
+            {
+                errors++;
+            }
+        }
+    }
+
+    if ((series_stats.samples + 1U) % METEO_SERIES_INFO_EVERY == 0U)
+    {
+        info_ok = DB_SUCCESS(db_file_info(series_db, &info));
+    }
+
+    tx_mutex_get(&series_mutex, TX_WAIT_FOREVER);
+    series_stats.samples++;
+    series_stats.points += put;
+    series_stats.put_errors += errors;
+    if (info_ok)
+    {
+        series_stats.data_file_bytes = info.data_file_bytes;
+        series_stats.series_bytes = info.time_series_data_bytes;
+    }
+    tx_mutex_put(&series_mutex);
+
+    return put;
+}
+
+/* Retention -----------------------------------------------------------------*/
+
+/**
+ * @brief Connection of the retention thread, made on first use
+ */
+static UINT series_trim_connect(void)
+{
+    uint8_t opened;
+
+    tx_mutex_get(&series_mutex, TX_WAIT_FOREVER);
+    opened = series_stats.opened;
+    tx_mutex_put(&series_mutex);
+    if (!opened)
+    {
+        return TX_NOT_AVAILABLE;
+    }
+
+    if (!series_trim_connected)
+    {
+        if (DB_FAILED(db_connect(&series_trim_db, METEO_SERIES_FILE, NULL, NULL, NULL)))
+        {
+            return TX_NOT_DONE;
+        }
+        series_trim_connected = 1U;
+    }
+    return TX_SUCCESS;
+}
+
+UINT meteo_series_trim(int64_t before_usec, int64_t step_usec, uint32_t *removed, int64_t *bytes)
+{
+    db_time_series_query_t query;
+    db_timestamp_usec_t oldest;
+    db_fieldno_t fieldno[METEO_ARCHIVE_CHANNELS];
+    float32_t values[METEO_ARCHIVE_CHANNELS];
+    db_file_info_t info;
+    int64_t used;
+    dbstatus_t status;
+    UINT result;
+
+    *removed = 0U;
+    *bytes = 0;
+    result = series_trim_connect();
+    if (result != TX_SUCCESS)
+    {
+        return result;
+    }
+
+    // Oldest point of any series
+    status = db_prepare_time_series_query(&query, series_trim_db, series_names, METEO_ARCHIVE_CHANNELS,
+                                          NULL, NULL, DB_QUERY_OLDEST_TO_NEWEST);
+    if (DB_SUCCESS(status))
+    {
+        status = db_fetch_next_timestamp_float32(query, &oldest, fieldno, values, METEO_ARCHIVE_CHANNELS);
+        (void)db_close_time_series_query(query);
+    }
+    if (DB_FAILED(status))
+    {
+        return TX_NOT_DONE;
+    }
+    // A step at a time: not for every new point past the age
+    if (status == 0 || (int64_t)oldest >= before_usec || before_usec - (int64_t)oldest < step_usec)
+    {
+        return TX_SUCCESS;
+    }
+    before_usec = (int64_t)oldest + step_usec;
+
+    status = db_file_info(series_trim_db, &info);
+    used = DB_SUCCESS(status) ? info.time_series_data_bytes : 0;
+    status = db_time_series_remove_before(series_trim_db, (db_timestamp_usec_t)before_usec);
+    if (DB_FAILED(status))
+    {
+        return TX_NOT_DONE;
+    }
+    *removed = (uint32_t)status;
+    if (used != 0 && DB_SUCCESS(db_file_info(series_trim_db, &info)) && info.time_series_data_bytes < used)
+    {
+        *bytes = used - info.time_series_data_bytes;
+    }
+
+    tx_mutex_get(&series_mutex, TX_WAIT_FOREVER);
+    series_stats.removed += *removed;
+    tx_mutex_put(&series_mutex);
+
+    return TX_SUCCESS;
+}
+
+UINT meteo_series_set_retention(int64_t retain_bytes)
+{
+    UINT result;
+
+    if (retain_bytes < DB_DEF_PAGE_SIZE)
+    {
+        return TX_SIZE_ERROR;
+    }
+    result = series_trim_connect();
+    if (result != TX_SUCCESS)
+    {
+        return result;
+    }
+
+    return DB_SUCCESS(db_set_time_series_data_retention(series_trim_db, retain_bytes,
+                                                        retain_bytes + METEO_SERIES_SLACK_BYTES))
+           ? TX_SUCCESS : TX_NOT_DONE;
+}
+
+/* Query ---------------------------------------------------------------------*/
+
+/**
+ * @brief Channel of a field of the query, looked up by name the first time
+ * @return -1 for a series that is not a channel
+ */
+static int32_t series_channel_of(meteo_series_cursor_t *cursor, db_fieldno_t fieldno)
+{
+    const char *name;
+    uint32_t c;
+
+    if (fieldno >= 0 && fieldno <= (db_fieldno_t)METEO_ARCHIVE_CHANNELS && cursor->channel[fieldno] >= 0)
+    {
+        return cursor->channel[fieldno];
+    }
+
+    name = db_get_time_series_name(cursor->query, fieldno);
+    for (c = 0; name != NULL && c < METEO_ARCHIVE_CHANNELS; c++)
+    {
+        if (strcmp(name, series_names[c]) == 0)
+        {
+            if (fieldno >= 0 && fieldno <= (db_fieldno_t)METEO_ARCHIVE_CHANNELS)
+            {
+                cursor->channel[fieldno] = (int8_t)c;
+            }
+            return (int32_t)c;
+        }
+    }
+    return -1;
+}
+
+UINT meteo_series_cursor_open(meteo_series_cursor_t *cursor, const meteo_archive_query_t *query)
+{
+    meteo_compress_config_t config;
+    db_timestamp_usec_t begin;
+    db_timestamp_usec_t end;
+    int64_t lookback_s = METEO_COMPRESS_HEARTBEAT_S;
+    dbstatus_t status;
+    uint8_t opened;
+    uint32_t c;
+
+    memset(cursor, 0, sizeof(*cursor));
+    memset(cursor->channel, -1, sizeof(cursor->channel));
+    cursor->range = *query;
+    cursor->done = 1U;
+
+    tx_mutex_get(&series_mutex, TX_WAIT_FOREVER);
+    opened = series_stats.opened;
+    tx_mutex_put(&series_mutex);
+    if (!opened)
+    {
+        return TX_NOT_AVAILABLE;
+    }
+
+    // Every channel has a point within its heartbeat before from_usec
+    for (c = 0; c < METEO_ARCHIVE_CHANNELS; c++)
+    {
+        if (meteo_compress_get_config(c, &config) == TX_SUCCESS && (int64_t)config.heartbeat_s > lookback_s)
+        {
+            lookback_s = (int64_t)config.heartbeat_s;
+        }
+    }
+    begin = (query->from_usec > INT64_MIN + lookback_s * 1000000) ? query->from_usec - lookback_s * 1000000
+                                                                  : INT64_MIN;
+    end = (query->to_usec < INT64_MAX) ? query->to_usec + 1 : INT64_MAX;
+
+    status = db_connect(&cursor->db, METEO_SERIES_FILE, NULL, NULL, NULL);
+    if (DB_SUCCESS(status))
+    {
+        status = db_prepare_time_series_query(&cursor->query, cursor->db, series_names, METEO_ARCHIVE_CHANNELS,
+                                              &begin, (end < INT64_MAX) ? &end : NULL, DB_QUERY_OLDEST_TO_NEWEST);
+    }
+    if (DB_FAILED(status))
+    {
+        meteo_series_cursor_close(cursor);
+        return TX_NOT_DONE;
+    }
+
+    cursor->done = 0U;
+    return TX_SUCCESS;
+}
+
+UINT meteo_series_read(meteo_series_cursor_t *cursor, meteo_archive_sample_t *samples, UINT max, UINT *count)
+{
+    db_timestamp_usec_t ts;
+    db_fieldno_t fieldno[METEO_ARCHIVE_CHANNELS];
+    float32_t values[METEO_ARCHIVE_CHANNELS];
+    dbstatus_t n;
+    int32_t c;
+    int32_t i;
+
+    *count = 0U;
+    while (!cursor->done && *count < max)
+    {
+        // All the values at the next timestamp: one per series at most
+        n = db_fetch_next_timestamp_float32(cursor->query, &ts, fieldno, values, METEO_ARCHIVE_CHANNELS);
+        if (n <= 0)
+        {
+            meteo_series_cursor_close(cursor);
+            if (DB_FAILED(n))
+            {
+                return TX_NOT_DONE;
+            }
+            break;
+        }
+
+        cursor->stats.timestamps++;
+        cursor->stats.values += (uint32_t)n;
+        for (i = 0; i < (int32_t)n; i++)
+        {
+            c = series_channel_of(cursor, fieldno[i]);
+            if (c >= 0)
+            {
+                cursor->value[c] = values[i];
+                cursor->seen |= 1UL << c;
+            }
+        }
+
+        if (ts < cursor->range.from_usec || cursor->seen != SERIES_ALL_CHANNELS)
+        {
+            continue;
+        }
+        if (cursor->range.channel < METEO_ARCHIVE_CHANNELS &&
+            !(cursor->value[cursor->range.channel] >= cursor->range.min &&
+              cursor->value[cursor->range.channel] <= cursor->range.max))
+        {
+            continue;
+        }
+
+        samples[*count].ts_usec = (int64_t)ts;
+        memcpy(samples[*count].value, cursor->value, sizeof(cursor->value));
+        (*count)++;
+        cursor->stats.rows++;
+    }
+
+    return TX_SUCCESS;
+}
+
+void meteo_series_cursor_close(meteo_series_cursor_t *cursor)
+{
+    if (cursor->query != NULL)
+    {
+        (void)db_close_time_series_query(cursor->query);
+        cursor->query = NULL;
+    }
+    if (cursor->db != NULL)
+    {
+        (void)db_disconnect(cursor->db);
+        cursor->db = NULL;
+    }
+    cursor->done = 1U;
+}
+
+void meteo_series_get_stats(meteo_series_stats_t *stats)
+{
+    tx_mutex_get(&series_mutex, TX_WAIT_FOREVER);
+    *stats = series_stats;
+    tx_mutex_put(&series_mutex);
+}
@@ -0,0 +1,95 @@
+/**
+ * @brief Virtual METEO stations of the simulator
+ * @version 19.10.26
+ * @author R.Oliva
+ * @description Split from meteo_simulator.c: a station is a random walk of
+ *              the 5 readings with its own seeded xorshift32, so the same
+ *              seed gives the same frames on the target and on the host.
+ *              Nothing here needs ThreadX or the HAL, so the host tools
+ *              feed the simulator's frames to the archive and compressor.
+ */
+
+#include "meteo_simulator.h"
+#include <stdio.h>
+
+// Simulated sensor ranges
+#define SIM_TEMP_MIN     (-1000)    // -10.0°C
+#define SIM_TEMP_MAX     (5000)     // 50.0°C
+#define SIM_PRESSURE_MIN (9500)     // 950.0 hPa
+#define SIM_PRESSURE_MAX (10500)    // 1050.0 hPa
+#define SIM_WIND_DIR_MAX (3599)     // 0-359.9 degrees
+
+/**
+ * @brief xorshift32: same sequence on the target and on the host, unlike rand()
+ */
+static uint32_t station_random(uint32_t *state)
+{
+    uint32_t x = *state;
+
+    x ^= x << 13;
+    x ^= x >> 17;
+    x ^= x << 5;
+    *state = x;
+    return x;
+}
+
+/**
+ * @brief Start a station from its seed (same seed, same frames)
+ */
+void meteo_sim_station_init(meteo_sim_station_t *station, uint32_t seed)
+{
+    // Spread nearby seeds (station 0, 1, 2 ...) over the whole state
+    seed ^= seed >> 16;
+    seed *= 0x7FEB352DUL;
+    seed ^= seed >> 15;
+    seed *= 0x846CA68BUL;
+    seed ^= seed >> 16;
+
+    station->rng = (seed != 0U) ? seed : 1U;
+    station->temp = 2000;            // Start at 20.0°C
+    station->pressure = 10132;       // Start at 1013.2 hPa
+    station->wind_dir = 0;
+    station->wind_speed = 0;
+    station->voltage = 115;          // 115mV = 1.15V
+    station->frames = 0;
+}
+
+/**
+ * @brief Next frame of a station, with correct checksum
+ * @param buffer Output buffer for generated frame
+ * @param buf_size Size of output buffer
+ * @return Frame length
+ */
+int meteo_sim_station_frame(meteo_sim_station_t *station, char *buffer, size_t buf_size)
+{
+    // Add random variations (realistic changes)
+    station->temp += (int32_t)(station_random(&station->rng) % 10) - 5;       // ±0.5°C change
+    station->pressure += (int32_t)(station_random(&station->rng) % 5) - 2;    // ±0.2 hPa change
+    station->wind_dir = (station->wind_dir + (station_random(&station->rng) % 50)) % 3600;  // Gradual rotation
+    station->wind_speed = station_random(&station->rng) % 40;                 // 0-39 units m/s 10/2/26
+    station->voltage = 110 + (station_random(&station->rng) % 10);            // 110-119mV
+    
+    // Clamp to realistic ranges
+    if (station->temp < SIM_TEMP_MIN) station->temp = SIM_TEMP_MIN;
+    if (station->temp > SIM_TEMP_MAX) station->temp = SIM_TEMP_MAX;
+    if (station->pressure < SIM_PRESSURE_MIN) station->pressure = SIM_PRESSURE_MIN;
+    if (station->pressure > SIM_PRESSURE_MAX) station->pressure = SIM_PRESSURE_MAX;
+    if (station->wind_dir > SIM_WIND_DIR_MAX) station->wind_dir = SIM_WIND_DIR_MAX;
+    
+    // Calculate checksum: sum of all 5 values
+    uint16_t checksum = (uint16_t)(station->temp + station->pressure + station->wind_dir +
+                                   station->wind_speed + station->voltage);
+    
+    station->frames++;
+
+    // Format complete frame with checksum
+    // Format: UUU$ttttt.bbbbb.dddd.sssss.vvv.CRCC*QQQ
+    return snprintf(buffer, buf_size,
+                    "UUU$%05ld.%05ld.%04u.%05u.%03u.%04x*QQQ",
+                    (long)station->temp,
+                    (long)station->pressure,
+                    station->wind_dir,
+                    station->wind_speed,
+                    station->voltage,
+                    checksum);
+}
@@ -4,10 +4,35 @@
  * @author R.Oliva
  * @description Generates realistic METEO frames with correct checksums
  *              Console control: Press 'S' to toggle, 'H' for help
+ *              19.10.26 Event driven: console keys arrive by USART1 interrupt
+ *              into a ring, frames are paced by a ThreadX timer, and the
+ *              thread sleeps on an event flags group in between.
+ *              19.10.26 Stations with their own seeded random sequence, and
+ *              a load generator: several stations at up to
+ *              METEO_SIM_RATE_MAX_HZ frames/s, fed as UART bytes through a
+ *              framer or as records into the DB queue, with a report of
+ *              the frames the ingest path accepted and dropped.
+ *              19.10.26 The stations are in meteo_sim_station.c.
  */
 
 #include "meteo_simulator.h"
 #include "meteo_checksum.h"
+#include "app_ittia.h"
+#include "meteo_thread_stats.h"
+#include "meteo_trace.h"
+#include "meteo_console.h"
+#include "meteo_thread.h"
+#include "meteo_framer.h"
+#include "meteo_journal.h"
+#include "meteo_archive_store.h"
+#include "meteo_export.h"
+#include "meteo_window.h"
+#include "meteo_stats.h"
+#include "meteo_filter.h"
+#include "meteo_compress.h"
+#include "meteo_series.h"
+#include "meteo_retention.h"
+#include "main.h"
 #include "stm32h573i_discovery.h"  // ADD BSP HEADER 10.2.26
 #include "tx_api.h"
 #include "stm32h5xx_hal.h"
@@ -15,77 +40,621 @@
 #include <stdlib.h>
 #include <string.h>
 
-// Forward declarations for frame processing
-extern void ProcessMeteoFrame(const char* frame);
-extern void ProcessMeteoFrameToStream(const char* frame);
-
 // *** USE BSP COM HANDLE ***
 extern UART_HandleTypeDef hcom_uart[COM_NBR];  // BSP COM array
 
-static TX_THREAD simulator_thread;
-static UCHAR simulator_stack[2048];
 static UINT simulator_enabled = 0;
 
-// Simulated sensor ranges
-#define SIM_TEMP_MIN     (-1000)    // -10.0°C
-#define SIM_TEMP_MAX     (5000)     // 50.0°C
-#define SIM_PRESSURE_MIN (9500)     // 950.0 hPa
-#define SIM_PRESSURE_MAX (10500)    // 1050.0 hPa
-#define SIM_WIND_DIR_MAX (3599)     // 0-359.9 degrees
+// 19.10.26 Wake-up sources of the simulator thread
+#define SIM_EVENT_CONSOLE   0x01UL   // key(s) in console_ring
+#define SIM_EVENT_FRAME     0x02UL   // frame period elapsed
+
+// Frame period while enabled (1 frame/second)
+#define SIM_FRAME_TICKS     TX_TIMER_TICKS_PER_SECOND
+
+// Console RX ring, filled by the USART1 ISR (power of 2)
+#define SIM_CONSOLE_RING    32U
+
+static TX_EVENT_FLAGS_GROUP simulator_events;
+static TX_TIMER simulator_timer;
+
+static uint8_t console_rx_byte;
+static uint8_t console_ring[SIM_CONSOLE_RING];
+static volatile UINT console_head = 0;   // written by the ISR only
+static volatile UINT console_tail = 0;   // written by the thread only
+static volatile ULONG console_overruns = 0;
+
+// Load generator: tick timer, stations and own framer 19.10.26
+#define SIM_EVENT_LOAD      0x04UL   // load generator tick
+
+// End of a run: ticks for the meteo thread to check the last frames
+#define SIM_LOAD_SETTLE_TICKS   2U
+
+static TX_TIMER sim_load_timer;
+
+static struct
+{
+    meteo_sim_load_config_t config;
+    meteo_sim_station_t station[METEO_SIM_MAX_STATIONS];
+    meteo_framer_t framer;
+    meteo_sim_load_report_t report;
+    ULONG start;
+    ULONG db_dropped_mark;
+    ULONG rejected_mark;
+    ULONG db_rejected_mark;
+    uint32_t fault_rng;
+    uint32_t resync_count;    // bytes since the fault began
+    uint32_t intact_accepted; // queued exactly as sent
+    UINT resync_pending;
+    UINT running;
+} sim_load;
+
+// Fault profile stress run ('F') 19.10.26
+static struct
+{
+    meteo_sim_load_report_t report[METEO_SIM_FAULT_COUNT];
+    void (*done)(const meteo_sim_load_report_t *report);
+} sim_stress;
+
+// Console load settings ('L', 'J', '+', '-')
+static meteo_sim_load_config_t sim_load_console =
+{
+    METEO_SIM_LOAD_RATE_HZ, METEO_SIM_LOAD_STATIONS, METEO_SIM_DEFAULT_SEED,
+    0, METEO_SIM_INJECT_UART, METEO_SIM_FAULT_NONE, NULL
+};
+
+// Station of the 1 frame/s simulator ('S')
+static meteo_sim_station_t sim_station;
+
+/**
+ * @brief xorshift32: same sequence on the target and on the host, unlike rand()
+ */
+static uint32_t sim_random(uint32_t *state)
+{
+    uint32_t x = *state;
+
+    x ^= x << 13;
+    x ^= x >> 17;
+    x ^= x << 5;
+    *state = x;
+    return x;
+}
 
 /**
  * @brief Generate simulated METEO frame with correct checksum
  * @param buffer Output buffer for generated frame
  * @param buf_size Size of output buffer
+ * @note 19.10.26 Frames of the console station ('S'), reset by 'R'
  */
 void meteo_simulator_generate_frame(char *buffer, size_t buf_size)
 {
-    // Simulate realistic weather data
-    static int32_t temp = 2000;      // Start at 20.0°C
-    static int32_t pressure = 10132; // Start at 1013.2 hPa
-    static uint16_t wind_dir = 0;
-    static uint16_t wind_speed = 0;
-    static uint16_t voltage = 115;   // 115mV = 1.15V
-    
-    // Add random variations (realistic changes)
-    temp += (rand() % 10) - 5;           // ±0.5°C change
-    pressure += (rand() % 5) - 2;        // ±0.2 hPa change
-    wind_dir = (wind_dir + (rand() % 50)) % 3600;  // Gradual rotation
-    wind_speed = rand() % 40;            // 0-39 units m/s 10/2/26
-    voltage = 110 + (rand() % 10);       // 110-119mV
-    
-    // Clamp to realistic ranges
-    if (temp < SIM_TEMP_MIN) temp = SIM_TEMP_MIN;
-    if (temp > SIM_TEMP_MAX) temp = SIM_TEMP_MAX;
-    if (pressure < SIM_PRESSURE_MIN) pressure = SIM_PRESSURE_MIN;
-    if (pressure > SIM_PRESSURE_MAX) pressure = SIM_PRESSURE_MAX;
-    if (wind_dir > SIM_WIND_DIR_MAX) wind_dir = SIM_WIND_DIR_MAX;
-    
-    // Calculate checksum: sum of all 5 values
-    uint16_t checksum = (uint16_t)(temp + pressure + wind_dir + wind_speed + voltage);
-    
-    // Format complete frame with checksum
-    // Format: UUU$ttttt.bbbbb.dddd.sssss.vvv.CRCC*QQQ
-    snprintf(buffer, buf_size,
-             "UUU$%05ld.%05ld.%04u.%05u.%03u.%04x*QQQ",
-             (long)temp,
-             (long)pressure,
-             wind_dir,
-             wind_speed,
-             voltage,
-             checksum);
+    if (sim_station.rng == 0U)
+    {
+        meteo_sim_station_init(&sim_station, METEO_SIM_DEFAULT_SEED);
+    }
+    (void)meteo_sim_station_frame(&sim_station, buffer, buf_size);
+}
+
+/* Load generator 19.10.26 ---------------------------------------------------*/
+
+static const char *const sim_fault_names[METEO_SIM_FAULT_COUNT] =
+{
+    "none", "bitflip", "drop", "truncate", "dup-header", "burst", "idle-gap"
+};
+
+/**
+ * @brief Name of a fault profile
+ */
+const char *meteo_simulator_fault_name(meteo_sim_fault_t fault)
+{
+    return (fault < METEO_SIM_FAULT_COUNT) ? sim_fault_names[fault] : "?";
+}
+
+/**
+ * @brief Load tick timer (timer context)
+ */
+static void sim_load_timer_expired(ULONG input)
+{
+    (void)input;
+    tx_event_flags_set(&simulator_events, SIM_EVENT_LOAD, TX_OR);
+}
+
+/**
+ * @brief Feed bytes to the load framer as USART3 would, and submit the
+ *        frames that come out
+ * @param intact Frame these bytes carry undamaged, NULL when none
+ * @return 1 when intact came out of the framer
+ */
+static UINT sim_load_feed(const uint8_t *bytes, int len, const char *intact)
+{
+    UINT delivered = 0;
+    UINT status;
+    int i;
+
+    for (i = 0; i < len; i++)
+    {
+        if (sim_load.resync_pending)
+        {
+            sim_load.resync_count++;
+        }
+
+        switch (meteo_framer_byte(&sim_load.framer, bytes[i]))
+        {
+            case METEO_FRAMER_FRAME:
+                status = Meteo_Frame_Submit(sim_load.framer.buffer);
+                if (status == TX_SUCCESS)
+                {
+                    sim_load.report.accepted++;
+                }
+                else if (status == TX_QUEUE_FULL)
+                {
+                    sim_load.report.dropped++;
+                }
+                if ((intact != NULL) && (strcmp(sim_load.framer.buffer, intact) == 0))
+                {
+                    delivered = 1;
+                    if (status == TX_SUCCESS)
+                    {
+                        sim_load.intact_accepted++;
+                    }
+                }
+                // 19.10.26 A damaged frame the checksum lets through is stored as a reading
+                else if ((status == TX_SUCCESS) && meteo_validate_checksum(sim_load.framer.buffer))
+                {
+                    sim_load.report.damaged_accepted++;
+                }
+                // First valid frame after a fault ends the resync
+                if (sim_load.resync_pending && meteo_validate_checksum(sim_load.framer.buffer))
+                {
+                    sim_load.resync_pending = 0;
+                    sim_load.report.resyncs++;
+                    sim_load.report.resync_bytes += sim_load.resync_count;
+                    if (sim_load.resync_count > sim_load.report.resync_bytes_max)
+                    {
+                        sim_load.report.resync_bytes_max = sim_load.resync_count;
+                    }
+                }
+                break;
+
+            case METEO_FRAMER_OVERFLOW:
+                sim_load.report.framer_errors++;
+                break;
+
+            default:
+                break;
+        }
+    }
+
+    return delivered;
+}
+
+/**
+ * @brief Resync latency is counted from the first byte of a fault
+ */
+static void sim_load_fault_begin(void)
+{
+    if (!sim_load.resync_pending)
+    {
+        sim_load.resync_pending = 1;
+        sim_load.resync_count = 0;
+    }
+}
+
+/**
+ * @brief Send one frame as USART3 bytes, with the fault of the run
+ */
+static void sim_load_send_uart(const char *frame, int len)
+{
+    static const uint8_t line_end[] = { '\r', '\n' };
+    uint8_t bytes[RX_BUFFER_SIZE];
+    uint8_t noise[32];
+    meteo_sim_fault_t fault = sim_load.config.fault;
+    const char *intact = frame;
+    UINT gap;
+    UINT n;
+    int cut;
+
+    // Intact frames must always come out of the framer; bursts damage nothing
+    if ((fault == METEO_SIM_FAULT_BURST) ||
+        ((sim_random(&sim_load.fault_rng) % METEO_SIM_FAULT_EVERY) != 0U))
+    {
+        fault = METEO_SIM_FAULT_NONE;
+    }
+
+    memcpy(bytes, frame, (size_t)len);
+    switch (fault)
+    {
+        case METEO_SIM_FAULT_BITFLIP:
+            bytes[sim_random(&sim_load.fault_rng) % (uint32_t)len] ^=
+                (uint8_t)(1U << (sim_random(&sim_load.fault_rng) % 8U));
+            intact = NULL;
+            break;
+
+        case METEO_SIM_FAULT_DROP:
+            cut = (int)(sim_random(&sim_load.fault_rng) % (uint32_t)len);
+            memmove(&bytes[cut], &bytes[cut + 1], (size_t)(len - cut - 1));
+            len--;
+            intact = NULL;
+            break;
+
+        case METEO_SIM_FAULT_TRUNCATE:
+            // At least the header, never the whole *QQQ
+            len = 4 + (int)(sim_random(&sim_load.fault_rng) % (uint32_t)(len - 7));
+            intact = NULL;
+            break;
+
+        case METEO_SIM_FAULT_DUP_HEADER:
+            sim_load_fault_begin();
+            (void)sim_load_feed((const uint8_t *)"UUU$", 4, NULL);
+            break;
+
+        case METEO_SIM_FAULT_IDLE_GAP:
+            sim_load_fault_begin();
+            memset(noise, 0xFF, sizeof(noise));
+            gap = METEO_SIM_GAP_MIN + (sim_random(&sim_load.fault_rng) % 256U);
+            for (; gap != 0U; gap -= n)
+            {
+                n = (gap < sizeof(noise)) ? gap : sizeof(noise);
+                (void)sim_load_feed(noise, (int)n, NULL);
+            }
+            break;
+
+        default:
+            break;
+    }
+
+    if (intact == NULL)
+    {
+        sim_load.report.damaged++;
+        sim_load_fault_begin();
+    }
+
+    if (!sim_load_feed(bytes, len, intact) && (intact != NULL))
+    {
+        sim_load.report.lost_intact++;
+    }
+
+    // The sensor ends each line; a burst or a cut frame runs into the next
+    if ((sim_load.config.fault != METEO_SIM_FAULT_BURST) && (fault != METEO_SIM_FAULT_TRUNCATE))
+    {
+        (void)sim_load_feed(line_end, sizeof(line_end), NULL);
+    }
+}
+
+/**
+ * @brief UART mode: every intact frame came out of the framer, and the meteo
+ *        thread rejected exactly the queued frames whose checksum fails,
+ *        i.e. accepted = intact + damaged but accepted + rejected
+ * @return Number of checks that failed
+ */
+static uint32_t sim_load_check(const meteo_sim_load_report_t *report)
+{
+    uint32_t failed = 0;
+
+    if (report->lost_intact != 0U)
+    {
+        failed++;
+    }
+    if (report->accepted != sim_load.intact_accepted + report->damaged_accepted + report->rejected)
+    {
+        failed++;
+    }
+
+    return failed;
+}
+
+/**
+ * @brief Print the report of the run
+ */
+static void sim_load_report_print(const meteo_sim_load_report_t *report)
+{
+    ULONG ms = (report->ticks * 1000U) / TX_TIMER_TICKS_PER_SECOND;
+    ULONG hz = (ms != 0U) ? (ULONG)(((uint64_t)report->accepted * 1000U) / ms) : 0U;
+    // The frames have filled the console: wait rather than lose the report
+    meteo_console_overflow_t overflow = meteo_console_set_overflow(METEO_CONSOLE_BLOCK);
+
+    printf("\n[LOAD] %lu frames in %lu ms from %u station(s), %s, %lu Hz offered\n",
+           (unsigned long)report->generated, (unsigned long)ms,
+           (unsigned)sim_load.config.stations,
+           (sim_load.config.inject == METEO_SIM_INJECT_UART) ? "UART bytes" : "DB records",
+           (unsigned long)sim_load.config.rate_hz);
+    printf("[LOAD] %lu accepted (%lu Hz), %lu dropped queue full, %lu framer errors\n",
+           (unsigned long)report->accepted, (unsigned long)hz,
+           (unsigned long)report->dropped, (unsigned long)report->framer_errors);
+    if (report->db_rejected != 0U)
+    {
+        printf("[LOAD] %lu dropped by the DB thread (fields do not decode)\n",
+               (unsigned long)report->db_rejected);
+    }
+    if (sim_load.config.inject == METEO_SIM_INJECT_UART)
+    {
+        printf("[LOAD] %lu rejected (checksum), %lu dropped by the meteo thread (DB queue full)\n",
+               (unsigned long)report->rejected, (unsigned long)report->db_dropped);
+        printf("[LOAD] %lu intact + %lu damaged but accepted + %lu rejected = %lu accepted: %s\n",
+               (unsigned long)sim_load.intact_accepted, (unsigned long)report->damaged_accepted,
+               (unsigned long)report->rejected, (unsigned long)report->accepted,
+               (report->checks_failed == 0U) ? "ok" : "MISMATCH");
+        printf("[LOAD] Faults '%s': %lu frames damaged, %lu intact frames lost, "
+               "resync %lu bytes avg, %lu max\n",
+               meteo_simulator_fault_name(sim_load.config.fault),
+               (unsigned long)report->damaged, (unsigned long)report->lost_intact,
+               (unsigned long)(report->resyncs ? report->resync_bytes / report->resyncs : 0U),
+               (unsigned long)report->resync_bytes_max);
+    }
+    (void)meteo_console_set_overflow(overflow);
+}
+
+/**
+ * @brief End the run: report, then the done callback
+ */
+static void sim_load_finish(void)
+{
+    tx_timer_deactivate(&sim_load_timer);
+    sim_load.running = 0;
+    sim_load.report.ticks = tx_time_get() - sim_load.start;
+
+    // Let the meteo thread check the last frames before counting
+    tx_thread_sleep(SIM_LOAD_SETTLE_TICKS);
+    sim_load.report.db_dropped = Meteo_Frame_Db_Dropped() - sim_load.db_dropped_mark;
+    sim_load.report.rejected = Meteo_Frame_Rejected() - sim_load.rejected_mark;
+    sim_load.report.db_rejected = Meteo_Frame_Db_Rejected() - sim_load.db_rejected_mark;
+    if (sim_load.config.inject == METEO_SIM_INJECT_UART)
+    {
+        sim_load.report.checks_failed = sim_load_check(&sim_load.report);
+    }
+
+    METEO_TRACE(METEO_TRACE_LOAD_DONE, sim_load.report.generated, sim_load.report.dropped);
+    sim_load_report_print(&sim_load.report);
+    if (sim_load.config.done != NULL)
+    {
+        sim_load.config.done(&sim_load.report);
+    }
+}
+
+/**
+ * @brief Generate the frames due since the start of the run
+ * @note The count follows tx_time_get(), not the number of timer events, so
+ *       late or merged events do not lower the rate
+ */
+static void sim_load_run(void)
+{
+    char frame[RX_BUFFER_SIZE];
+    meteo_sim_station_t *station;
+    ULONG elapsed = tx_time_get() - sim_load.start;
+    uint64_t due = ((uint64_t)elapsed * sim_load.config.rate_hz) / TX_TIMER_TICKS_PER_SECOND;
+    UINT status;
+    int len;
+
+    if ((sim_load.config.frames != 0U) && (due > sim_load.config.frames))
+    {
+        due = sim_load.config.frames;
+    }
+    else if ((sim_load.config.inject == METEO_SIM_INJECT_UART) &&
+             (sim_load.config.fault == METEO_SIM_FAULT_BURST))
+    {
+        // Same average rate, released METEO_SIM_BURST_FRAMES at a time
+        due -= due % METEO_SIM_BURST_FRAMES;
+    }
+
+    while (sim_load.report.generated < due)
+    {
+        station = &sim_load.station[sim_load.report.generated % sim_load.config.stations];
+        len = meteo_sim_station_frame(station, frame, sizeof(frame));
+        sim_load.report.generated++;
+
+        if (sim_load.config.inject == METEO_SIM_INJECT_UART)
+        {
+            sim_load_send_uart(frame, len);
+            continue;
+        }
+
+        status = tx_queue_send(&meteo_frame_queue, frame, TX_NO_WAIT);
+        if (status == TX_SUCCESS)
+        {
+            sim_load.report.accepted++;
+        }
+        else
+        {
+            sim_load.report.dropped++;
+        }
+    }
+
+    if ((sim_load.config.frames != 0U) && (sim_load.report.generated >= sim_load.config.frames))
+    {
+        sim_load_finish();
+    }
+}
+
+/**
+ * @brief Start a load generator run
+ */
+UINT meteo_simulator_load_start(const meteo_sim_load_config_t *config)
+{
+    UINT i;
+
+    if (sim_load.running)
+    {
+        return TX_NOT_DONE;
+    }
+    if ((config->rate_hz == 0U) || (config->rate_hz > METEO_SIM_RATE_MAX_HZ) ||
+        (config->stations == 0U) || (config->stations > METEO_SIM_MAX_STATIONS) ||
+        (config->fault >= METEO_SIM_FAULT_COUNT))
+    {
+        return TX_SIZE_ERROR;
+    }
+
+    sim_load.config = *config;
+    for (i = 0; i < config->stations; i++)
+    {
+        meteo_sim_station_init(&sim_load.station[i], config->seed + i);
+    }
+    // Faults follow their own sequence, so every profile sends the same frames
+    sim_load.fault_rng = sim_load.station[0].rng ^ 0xA5A5A5A5UL;
+    meteo_framer_reset(&sim_load.framer);
+    memset(&sim_load.report, 0, sizeof(sim_load.report));
+    sim_load.intact_accepted = 0;
+    sim_load.resync_pending = 0;
+    sim_load.start = tx_time_get();
+    sim_load.db_dropped_mark = Meteo_Frame_Db_Dropped();
+    sim_load.rejected_mark = Meteo_Frame_Rejected();
+    sim_load.db_rejected_mark = Meteo_Frame_Db_Rejected();
+    sim_load.running = 1;
+
+    printf("[LOAD] Start: %lu Hz, %u station(s), seed 0x%08lX, %s, faults '%s', %lu frames\n",
+           (unsigned long)config->rate_hz, (unsigned)config->stations,
+           (unsigned long)config->seed,
+           (config->inject == METEO_SIM_INJECT_UART) ? "UART bytes" : "DB records",
+           meteo_simulator_fault_name(config->fault),
+           (unsigned long)config->frames);
+    METEO_TRACE(METEO_TRACE_LOAD_START, config->rate_hz, config->stations);
+
+    return tx_timer_activate(&sim_load_timer);
+}
+
+/**
+ * @brief Stop the load generator run and print its report
+ */
+void meteo_simulator_load_stop(void)
+{
+    if (sim_load.running)
+    {
+        sim_load_finish();
+    }
+}
+
+/**
+ * @brief Next profile of the stress run, from the done callback
+ */
+static void sim_stress_next(const meteo_sim_load_report_t *report)
+{
+    meteo_sim_load_config_t config = sim_load.config;
+    meteo_console_overflow_t overflow;
+    meteo_sim_load_report_t last = *report;
+    const meteo_sim_load_report_t *r;
+    UINT i;
+
+    sim_stress.report[config.fault] = *report;
+    if (config.fault + 1 < METEO_SIM_FAULT_COUNT)
+    {
+        config.fault = (meteo_sim_fault_t)(config.fault + 1);
+        if (meteo_simulator_load_start(&config) == TX_SUCCESS)
+        {
+            return;
+        }
+    }
+
+    overflow = meteo_console_set_overflow(METEO_CONSOLE_BLOCK);
+    printf("\n[STRESS] %lu frames per profile at %lu Hz, 1 in %u damaged\n",
+           (unsigned long)config.frames, (unsigned long)config.rate_hz,
+           (unsigned)METEO_SIM_FAULT_EVERY);
+    printf("[STRESS] profile     accepted rejected  q-full damaged dmg-accept lost-intact resync-avg resync-max check\n");
+    last.checks_failed = 0;
+    for (i = 0; i <= (UINT)config.fault; i++)
+    {
+        r = &sim_stress.report[i];
+        printf("[STRESS] %-10s %9lu %8lu %7lu %7lu %10lu %11lu %10lu %10lu %s\n",
+               meteo_simulator_fault_name((meteo_sim_fault_t)i),
+               (unsigned long)r->accepted, (unsigned long)r->rejected,
+               (unsigned long)(r->dropped + r->db_dropped), (unsigned long)r->damaged,
+               (unsigned long)r->damaged_accepted, (unsigned long)r->lost_intact,
+               (unsigned long)(r->resyncs ? r->resync_bytes / r->resyncs : 0U),
+               (unsigned long)r->resync_bytes_max, (r->checks_failed == 0U) ? "ok" : "FAIL");
+        last.checks_failed += r->checks_failed;
+    }
+    printf("[STRESS] %s\n", (last.checks_failed == 0U) ? "Every profile adds up" : "Counts do not add up");
+    (void)meteo_console_set_overflow(overflow);
+
+    // The last profile's report, with the failed checks of the whole run
+    if (sim_stress.done != NULL)
+    {
+        sim_stress.done(&last);
+    }
+}
+
+/**
+ * @brief Run every fault profile in turn
+ */
+UINT meteo_simulator_stress_start(uint32_t rate_hz, uint32_t frames,
+                                  void (*done)(const meteo_sim_load_report_t *report))
+{
+    meteo_sim_load_config_t config =
+    {
+        rate_hz, METEO_SIM_LOAD_STATIONS, METEO_SIM_DEFAULT_SEED,
+        frames, METEO_SIM_INJECT_UART, METEO_SIM_FAULT_NONE, sim_stress_next
+    };
+
+    if (frames == 0U)
+    {
+        return TX_SIZE_ERROR;
+    }
+    sim_stress.done = done;
+    return meteo_simulator_load_start(&config);
+}
+
+/**
+ * @brief Frame period timer - 19.10.26 (timer thread context)
+ */
+static void meteo_simulator_timer_expired(ULONG input)
+{
+    (void)input;
+    tx_event_flags_set(&simulator_events, SIM_EVENT_FRAME, TX_OR);
+}
+
+/**
+ * @brief Console RX complete, called from HAL_UART_RxCpltCallback (ISR)
+ */
+void meteo_simulator_console_rx_cplt(void)
+{
+    UINT head = console_head;
+
+    if ((head - console_tail) < SIM_CONSOLE_RING)
+    {
+        console_ring[head % SIM_CONSOLE_RING] = console_rx_byte;
+        console_head = head + 1;
+    }
+    else
+    {
+        console_overruns++;
+    }
+    tx_event_flags_set(&simulator_events, SIM_EVENT_CONSOLE, TX_OR);
+
+    HAL_UART_Receive_IT(&hcom_uart[COM1], &console_rx_byte, 1);
+}
+
+/**
+ * @brief Console RX error, called from HAL_UART_ErrorCallback (ISR)
+ */
+void meteo_simulator_console_rx_error(void)
+{
+    HAL_UART_Receive_IT(&hcom_uart[COM1], &console_rx_byte, 1);
 }
 
 /**
  * @brief Check console for simulator commands (non-blocking)
+ * @note 19.10.26 Handles all keys received by interrupt since the last call
  */
 void meteo_simulator_check_console(void)
 {
     uint8_t key;
+    meteo_journal_stats_t journal_stats;
+    meteo_archive_store_stats_t archive_stats;
+    meteo_archive_query_t export_query;
+    meteo_export_stats_t export_stats;
+    meteo_console_stats_t console_stats;
+    meteo_window_stats_t window_stats;
+    meteo_filter_stats_t filter_stats[METEO_ARCHIVE_CHANNELS];
+    meteo_compress_stats_t compress_stats;
+#if METEO_SERIES_ENABLED
+    meteo_series_stats_t series_stats;
+#endif
+    meteo_retention_stats_t retention_stats;
+    UINT status;
     
-    // Non-blocking receive from VCP/BSP COM1 console
-    if (HAL_UART_Receive(&hcom_uart[COM1], &key, 1, 0) == HAL_OK)
+    while (console_tail != console_head)
     {
+        key = console_ring[console_tail % SIM_CONSOLE_RING];
+        console_tail++;
+
         switch(key)
         {
             case 's':
@@ -106,15 +675,27 @@ void meteo_simulator_check_console(void)
                 printf("  H - Show this help                           \n");
                 printf("  R - Reset simulator to defaults              \n");
                 printf("  I - Show simulator info/status               \n");
+                printf("  M - Show ITTIA DB memory profile             \n");
+                printf("  P - Dump ITTIA DB memory profile as CSV      \n");
+                printf("  T - Show thread CPU load and stack usage     \n");
+                printf("  B - Dump thread statistics as binary record  \n");
+                printf("  D - Dump ThreadX event trace and restart it  \n");
+                printf("  L - Start/stop load generator run            \n");
+                printf("  J - Load injection: UART bytes / DB records  \n");
+                printf("  + - Double load rate, - halve it             \n");
+                printf("  F - Fault injection stress run (all profiles)\n");
+                printf("  A - Seal archive chunk now, show archive     \n");
+                printf("  E - Export last hour of archive as CSV       \n");
+                printf("  W - Running statistics, then restart the means\n");
                 printf("================================================\n");
                 printf("\n");
                 break;
                 
             case 'r':
             case 'R':
-                // Reset simulator (will restart from defaults)
+                // Reset simulator: same frames as after power-up 19.10.26
+                meteo_sim_station_init(&sim_station, METEO_SIM_DEFAULT_SEED);
                 printf("\n[SIMULATOR] Reset - restarting from default values\n");
-                // Note: Static variables will reset on next frame generation
                 break;
                 
             case 'i':
@@ -127,10 +708,203 @@ void meteo_simulator_check_console(void)
                 printf("  Temp range: -10.0 to 50.0°C\n");
                 printf("  Pressure range: 950.0 to 1050.0 hPa\n");
                 printf("  Update rate: 1 frame/second\n");
+                printf("  Load: %s, %lu Hz, %u station(s), %s\n",
+                       sim_load.running ? "RUNNING" : "stopped",
+                       (unsigned long)sim_load_console.rate_hz, (unsigned)sim_load_console.stations,
+                       (sim_load_console.inject == METEO_SIM_INJECT_UART) ? "UART bytes" : "DB records");
+                // Console output ring 19.10.26
+                meteo_console_get_stats(&console_stats);
+                printf("  Console: %lu bytes queued, %lu dropped (%lu writes), "
+                       "%lu waits, peak %lu/%u bytes\n",
+                       (unsigned long)console_stats.bytes_written, (unsigned long)console_stats.bytes_dropped,
+                       (unsigned long)console_stats.writes_dropped, (unsigned long)console_stats.blocked,
+                       (unsigned long)console_stats.high_water, (unsigned)METEO_CONSOLE_RING_SIZE);
+                // Frame journal 19.10.26
+                meteo_journal_get_stats(&journal_stats);
+                printf("  Journal: seq %lu..%lu of %lu, %lu to send, %lu lost, %lu bad, "
+                       "%lu erases, %lu write errors\n",
+                       (unsigned long)journal_stats.oldest, (unsigned long)journal_stats.head,
+                       (unsigned long)journal_stats.capacity,
+                       (unsigned long)(journal_stats.head - journal_stats.acked),
+                       (unsigned long)journal_stats.lost, (unsigned long)journal_stats.bad,
+                       (unsigned long)journal_stats.erases, (unsigned long)journal_stats.write_errors);
+                // Compressed archive 19.10.26
+                meteo_archive_store_get_stats(&archive_stats);
+                printf("  Archive: segments %lu..%lu, %lu samples in %lu bytes, %lu open, "
+                       "%lu erases, %lu write errors\n",
+                       (unsigned long)archive_stats.oldest, (unsigned long)archive_stats.next_seq,
+                       (unsigned long)archive_stats.samples, (unsigned long)archive_stats.bytes,
+                       (unsigned long)archive_stats.pending,
+                       (unsigned long)archive_stats.erases, (unsigned long)archive_stats.write_errors);
+                // NanoEdge window 19.10.26
+                meteo_window_get_stats(&window_stats);
+                printf("  Window: %u x %u, %lu samples, %lu callbacks (every %lu)\n",
+                       (unsigned)METEO_WINDOW_SAMPLES, (unsigned)METEO_WINDOW_AXES,
+                       (unsigned long)window_stats.samples, (unsigned long)window_stats.windows,
+                       (unsigned long)window_stats.every);
+                // Spike filter 19.10.26
+                meteo_filter_get_stats(filter_stats);
+                printf("  Filter: window %u, flagged/replaced T %lu/%lu P %lu/%lu WS %lu/%lu V %lu/%lu\n",
+                       (unsigned)METEO_FILTER_WINDOW,
+                       (unsigned long)filter_stats[METEO_ARCHIVE_TEMPERATURE].flagged,
+                       (unsigned long)filter_stats[METEO_ARCHIVE_TEMPERATURE].replaced,
+                       (unsigned long)filter_stats[METEO_ARCHIVE_PRESSURE].flagged,
+                       (unsigned long)filter_stats[METEO_ARCHIVE_PRESSURE].replaced,
+                       (unsigned long)filter_stats[METEO_ARCHIVE_WIND_SPEED].flagged,
+                       (unsigned long)filter_stats[METEO_ARCHIVE_WIND_SPEED].replaced,
+                       (unsigned long)filter_stats[METEO_ARCHIVE_VOLTAGE].flagged,
+                       (unsigned long)filter_stats[METEO_ARCHIVE_VOLTAGE].replaced);
+                // Deadband / swinging door 19.10.26
+                meteo_compress_get_stats(&compress_stats);
+                printf("  Compress: %lu readings, %lu rows kept (%lu for a door), %lu.%02lu : 1\n",
+                       (unsigned long)compress_stats.readings, (unsigned long)compress_stats.rows,
+                       (unsigned long)compress_stats.held,
+                       (unsigned long)((compress_stats.rows != 0U) ?
+                                       compress_stats.readings / compress_stats.rows : 0U),
+                       (unsigned long)((compress_stats.rows != 0U) ?
+                                       (compress_stats.readings % compress_stats.rows) * 100U /
+                                       compress_stats.rows : 0U));
+#if METEO_SERIES_ENABLED
+                // Time series per channel 19.10.26
+                meteo_series_get_stats(&series_stats);
+                printf("  Series: %s, %lu samples, %lu points, %lu put errors, %lu of %lu file bytes\n",
+                       series_stats.opened ? "open" : "not open", (unsigned long)series_stats.samples,
+                       (unsigned long)series_stats.points, (unsigned long)series_stats.put_errors,
+                       (unsigned long)series_stats.series_bytes, (unsigned long)series_stats.data_file_bytes);
+#endif
+                // Age and byte budgets 19.10.26
+                meteo_retention_get_stats(&retention_stats);
+                printf("  Retention: %lu steps (%lu busy periods), %lu archive blocks (%lu entered erased), "
+                       "%lu series timestamps, %lu table rows, %lu KB freed, step %lu us last / %lu us max\n",
+                       (unsigned long)retention_stats.steps, (unsigned long)retention_stats.busy,
+                       (unsigned long)retention_stats.archive_blocks, (unsigned long)archive_stats.preerased,
+                       (unsigned long)retention_stats.series_removed, (unsigned long)retention_stats.table_removed,
+                       (unsigned long)(retention_stats.bytes / 1024), (unsigned long)retention_stats.last_us,
+                       (unsigned long)retention_stats.max_us);
                 printf("===============================\n");
                 printf("\n");
                 break;
                 
+            case 'm':
+            case 'M':
+                // Allocation profile per site and block kind 19.10.26
+                app_ittia_mem_profile_print(0);
+                break;
+
+            case 'p':
+            case 'P':
+                app_ittia_mem_profile_print(1);
+                break;
+
+            case 't':
+            case 'T':
+                // Per-thread CPU load and stack high-water marks 19.10.26
+                meteo_thread_stats_print();
+                break;
+
+            case 'b':
+            case 'B':
+                meteo_thread_stats_print_record();
+                break;
+
+            case 'd':
+            case 'D':
+                // ThreadX event trace as [TRACE] hex lines, for
+                // Core/Host/Tools/tx_trace_to_json 19.10.26
+                meteo_trace_dump();
+                break;
+
+            case 'l':
+            case 'L':
+                // Load generator run until 'L' again 19.10.26
+                if (sim_load.running)
+                {
+                    meteo_simulator_load_stop();
+                }
+                else
+                {
+                    sim_load_console.seed = METEO_SIM_DEFAULT_SEED;
+                    (void)meteo_simulator_load_start(&sim_load_console);
+                }
+                break;
+
+            case 'f':
+            case 'F':
+                // Every fault profile over the UART framer 19.10.26
+                if (meteo_simulator_stress_start(METEO_SIM_STRESS_RATE_HZ,
+                                                 METEO_SIM_STRESS_FRAMES, NULL) != TX_SUCCESS)
+                {
+                    printf("[STRESS] Load generator busy - press 'L' to stop it\n");
+                }
+                break;
+
+            case 'a':
+            case 'A':
+                // Seal the open archive chunk (it is lost on a reset) 19.10.26
+                meteo_archive_store_get_stats(&archive_stats);
+                if (meteo_archive_store_flush() != TX_SUCCESS)
+                {
+                    printf("[ARCHIVE] Not sealed - archive not open or flash error\n");
+                    break;
+                }
+                printf("[ARCHIVE] Sealed %lu samples (%lu bits)\n",
+                       (unsigned long)archive_stats.pending, (unsigned long)archive_stats.pending_bits);
+                meteo_archive_store_get_stats(&archive_stats);
+                printf("[ARCHIVE] Segments %lu..%lu, %lu written, %lu samples in %lu bytes (%lu.%02lu bytes/sample)\n",
+                       (unsigned long)archive_stats.oldest, (unsigned long)archive_stats.next_seq,
+                       (unsigned long)archive_stats.segments, (unsigned long)archive_stats.samples,
+                       (unsigned long)archive_stats.bytes,
+                       (unsigned long)((archive_stats.samples != 0U) ? archive_stats.bytes / archive_stats.samples : 0U),
+                       (unsigned long)((archive_stats.samples != 0U) ?
+                                       (archive_stats.bytes % archive_stats.samples) * 100U / archive_stats.samples : 0U));
+                break;
+
+            case 'e':
+            case 'E':
+                // Last hour of sealed segments to COM1, paced by the UART 19.10.26
+                export_query.to_usec = meteo_archive_store_now();
+                export_query.from_usec = export_query.to_usec - 3600LL * 1000000;
+                export_query.channel = METEO_ARCHIVE_CHANNELS;
+                status = meteo_export_console(&export_query, METEO_EXPORT_CSV, &export_stats);
+                printf("[EXPORT] %lu rows, %lu bytes in %lu ms (%lu rows/s), %lu/%lu blocks read (0x%02X)\n",
+                       (unsigned long)export_stats.rows, (unsigned long)export_stats.bytes,
+                       (unsigned long)(export_stats.ticks * 1000U / TX_TIMER_TICKS_PER_SECOND),
+                       (unsigned long)((export_stats.ticks != 0U) ?
+                                       export_stats.rows * TX_TIMER_TICKS_PER_SECOND / export_stats.ticks : 0U),
+                       (unsigned long)export_stats.query.blocks_read,
+                       (unsigned long)(export_stats.query.blocks_read + export_stats.query.blocks_skipped),
+                       status);
+                break;
+
+            case 'w':
+            case 'W':
+                // Snapshot of the running statistics, means from here on 19.10.26
+                meteo_stats_print();
+                meteo_stats_reset();
+                break;
+
+            case 'j':
+            case 'J':
+                sim_load_console.inject = (sim_load_console.inject == METEO_SIM_INJECT_UART) ?
+                                          METEO_SIM_INJECT_DB : METEO_SIM_INJECT_UART;
+                printf("[LOAD] Next run: %s\n",
+                       (sim_load_console.inject == METEO_SIM_INJECT_UART) ? "UART bytes" : "DB records");
+                break;
+
+            case '+':
+            case '-':
+                if (key == '+')
+                {
+                    sim_load_console.rate_hz = (sim_load_console.rate_hz * 2U > METEO_SIM_RATE_MAX_HZ) ?
+                                               METEO_SIM_RATE_MAX_HZ : sim_load_console.rate_hz * 2U;
+                }
+                else if (sim_load_console.rate_hz > 1U)
+                {
+                    sim_load_console.rate_hz /= 2U;
+                }
+                printf("[LOAD] Next run: %lu Hz\n", (unsigned long)sim_load_console.rate_hz);
+                break;
+
             case '\r':
             case '\n':
                 // Ignore newlines
@@ -145,13 +919,16 @@ void meteo_simulator_check_console(void)
 }
 
 /**
- * @brief Simulator thread - generates frames periodically
+ * @brief Simulator thread - handles console keys and generates frames
  * @param thread_input Unused parameter
+ * @note 19.10.26 Sleeps on simulator_events, no polling
  */
 void meteo_simulator_thread_entry(ULONG thread_input)
 {
     (void)thread_input;
-    char sim_frame[64];
+    char sim_frame[RX_BUFFER_SIZE];
+    ULONG events;
+    ULONG overruns_reported = 0;
     
     printf("\n");
     printf("====================================================\n");
@@ -164,43 +941,49 @@ void meteo_simulator_thread_entry(ULONG thread_input)
     
     while(1)
     {
-        // Check for console commands (non-blocking)
-        meteo_simulator_check_console();
+        if (tx_event_flags_get(&simulator_events, SIM_EVENT_CONSOLE | SIM_EVENT_FRAME | SIM_EVENT_LOAD,
+                               TX_OR_CLEAR, &events, TX_WAIT_FOREVER) != TX_SUCCESS)
+        {
+            continue;
+        }
+
+        if (events & SIM_EVENT_CONSOLE)
+        {
+            if (console_overruns != overruns_reported)
+            {
+                printf("[SIMULATOR] %lu console key(s) lost\n",
+                       (unsigned long)(console_overruns - overruns_reported));
+                overruns_reported = console_overruns;
+            }
+            meteo_simulator_check_console();
+        }
         
+        if ((events & SIM_EVENT_LOAD) && sim_load.running)
+        {
+            sim_load_run();
+        }
+
         // Generate frames if simulator is enabled
-        if (simulator_enabled)
+        if ((events & SIM_EVENT_FRAME) && simulator_enabled)
         {
             // Generate frame with correct checksum
+            memset(sim_frame, 0, sizeof(sim_frame));
             meteo_simulator_generate_frame(sim_frame, sizeof(sim_frame));
             
-            // Display frame (same format as real UART)
-            printf("\n[SIMULATOR Frame] (%d bytes): %s\r\n", 
-                   (int)strlen(sim_frame), sim_frame);
-            
-            // Validate our own checksum (should always pass!)
-            if (meteo_validate_checksum(sim_frame))
-            {
-                printf("[SIMULATOR] Checksum OK\n");
-                
-                // Process frame (display and optionally store)
-                ProcessMeteoFrame(sim_frame);
-                
-                // TODO: Uncomment when queue architecture is ready
-                // ProcessMeteoFrameToStream(sim_frame);
-            }
-            else
+            // Same path as a real UART3 frame: meteo thread validates,
+            // displays and forwards it to the DB thread
+            if (Meteo_Frame_Submit(sim_frame) != TX_SUCCESS)
             {
-                printf("[SIMULATOR] SChecksum FAILED (bug in simulator!)\n");
+                printf("[SIMULATOR] Meteo thread busy - frame dropped\n");
             }
         }
-        
-        // Sleep 100ms (check console 10x/sec, generate frames 1x/sec)
-        tx_thread_sleep(50);  // 50 ticks = 500ms 10/2/26
     }
 }
 
 /**
  * @brief Initialize METEO simulator
+ * @note 19.10.26 Creates the event flags and frame timer and arms console
+ *       reception. The caller runs meteo_simulator_thread_entry().
  */
 void meteo_simulator_init(void)
 {
@@ -208,26 +991,48 @@ void meteo_simulator_init(void)
     
     printf("\n=== Initializing METEO Simulator ===\n");
     printf("Using BSP COM1 for console commands\n");
+    meteo_sim_station_init(&sim_station, METEO_SIM_DEFAULT_SEED);
     
-    // Create simulator thread
-    status = tx_thread_create(&simulator_thread,
-                             "METEO Simulator",
-                             meteo_simulator_thread_entry,
-                             0,
-                             simulator_stack,
-                             sizeof(simulator_stack),
-                             15,  // Priority (same as other app threads)
-                             15,
-                             TX_NO_TIME_SLICE,
-                             TX_AUTO_START);
+    status = tx_event_flags_create(&simulator_events, "METEO Simulator Events");
+    if (status == TX_SUCCESS)
+    {
+        // Started by meteo_simulator_toggle()
+        status = tx_timer_create(&simulator_timer,
+                                 "METEO Simulator Timer",
+                                 meteo_simulator_timer_expired,
+                                 0,
+                                 SIM_FRAME_TICKS,
+                                 SIM_FRAME_TICKS,
+                                 TX_NO_ACTIVATE);
+    }
+    if (status == TX_SUCCESS)
+    {
+        // Started by meteo_simulator_load_start()
+        status = tx_timer_create(&sim_load_timer,
+                                 "METEO Load Timer",
+                                 sim_load_timer_expired,
+                                 0,
+                                 1,
+                                 1,
+                                 TX_NO_ACTIVATE);
+    }
     
     if (status != TX_SUCCESS)
     {
-        printf("ERROR: Failed to create simulator thread (status=0x%X)\n", status);
+        printf("ERROR: Failed to create simulator events/timer (status=0x%X)\n", status);
+        return;
+    }
+    
+    // Console keys by interrupt (USART1 = BSP COM1)
+    HAL_NVIC_SetPriority(USART1_IRQn, 7, 0);
+    HAL_NVIC_EnableIRQ(USART1_IRQn);
+    if (HAL_UART_Receive_IT(&hcom_uart[COM1], &console_rx_byte, 1) != HAL_OK)
+    {
+        printf("ERROR: Console RX interrupt start failed\n");
     }
     else
     {
-        printf("OK Simulator thread created\n");
+        printf("OK Simulator console armed\n");
     }
 }
 
@@ -238,6 +1043,16 @@ void meteo_simulator_toggle(void)
 {
     simulator_enabled = !simulator_enabled;
     
+    // 19.10.26 Frame timer only runs while enabled
+    if (simulator_enabled)
+    {
+        tx_timer_activate(&simulator_timer);
+    }
+    else
+    {
+        tx_timer_deactivate(&simulator_timer);
+    }
+    
     if (simulator_enabled)
     {
         printf("\n");
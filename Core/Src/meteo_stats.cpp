@@ -0,0 +1,355 @@
+/**
+ * @brief Running statistics of the readings, per channel
+ * @version 19.10.26
+ * @author R.Oliva
+ * @description The estimators of meteo_stats.hpp, one set per channel, fed
+ *              by the DB thread with every decoded frame: mean and standard
+ *              deviation since the last reset, EWMA (10 min half-life), min
+ *              and max of the last hour. Wind direction gets the circular
+ *              mean and deviation and the EWMA of its unit vector instead.
+ *              Consumers read a snapshot (meteo_stats_get(), 'W' on the
+ *              console, a [STATS] line every METEO_STATS_PUBLISH_SAMPLES)
+ *              instead of scanning the history.
+ *              Wind speed also gets P50/P90/P99 of each hour and day of
+ *              uptime for the design loads, without keeping the readings:
+ *              P2 estimators for the three of them, and a t-digest per hour
+ *              that is merged into the day's when the hour closes. Each
+ *              closed window is kept for meteo_stats_get_quantiles() and
+ *              goes out as a [STATS] line.
+ *              The means since reset are in double: in float a mean near
+ *              1013 hPa stops moving after a few hours of 1 Hz readings.
+ *              That is soft float on the M33, a few us per frame.
+ */
+
+#include "meteo_stats.h"
+#include "meteo_stats.hpp"
+#include "meteo_format.h"
+#include <stdio.h>
+
+namespace
+{
+
+struct Channel
+{
+    Channel()
+        : ewma((float)METEO_STATS_HALF_LIFE_S, (float)METEO_STATS_PERIOD_S),
+          range(METEO_STATS_HORIZON_S)
+    {
+    }
+
+    meteo::stats::Welford<double> welford;
+    meteo::stats::Ewma<float> ewma;
+    meteo::stats::MinMax<float, METEO_STATS_BUCKETS> range;
+};
+
+const char *const stats_names[METEO_ARCHIVE_CHANNELS] =
+{
+    "temperature", "pressure", "wind_speed", "wind_direction", "voltage"
+};
+
+// Decimals of the console lines
+const uint8_t stats_decimals[METEO_ARCHIVE_CHANNELS] = { 2U, 1U, 1U, 1U, 1U };
+
+const float stats_degrees = 180.0f / 3.14159265f;
+
+const float quant_levels[METEO_STATS_QUANTILES] = { 0.5f, 0.9f, 0.99f };
+
+// Wind speed over one hour or day
+struct Quantiles
+{
+    Quantiles() : start(0U), samples(0U)
+    {
+        uint32_t i;
+
+        for (i = 0; i < METEO_STATS_QUANTILES; i++)
+        {
+            p2[i] = meteo::stats::P2<float>(quant_levels[i]);
+        }
+    }
+
+    void reset(uint32_t time)
+    {
+        uint32_t i;
+
+        for (i = 0; i < METEO_STATS_QUANTILES; i++)
+        {
+            p2[i].reset();
+        }
+        digest.reset();
+        start = time;
+        samples = 0U;
+    }
+
+    void close(meteo_stats_quantiles_t *out)
+    {
+        uint32_t i;
+
+        out->start = start;
+        out->samples = samples;
+        for (i = 0; i < METEO_STATS_QUANTILES; i++)
+        {
+            out->p2[i] = p2[i].quantile();
+            out->digest[i] = digest.quantile(quant_levels[i]);
+        }
+        out->max = digest.max();
+    }
+
+    meteo::stats::P2<float> p2[METEO_STATS_QUANTILES];
+    meteo::stats::TDigest<float, METEO_STATS_DIGEST_SIZE, 64U> digest;
+    uint32_t start;             /* Seconds since start-up */
+    uint32_t samples;
+};
+
+TX_MUTEX stats_mutex;
+Channel stats_channel[METEO_ARCHIVE_CHANNELS];
+meteo::stats::Circular<float> stats_direction;
+meteo::stats::Ewma<float> stats_direction_cos((float)METEO_STATS_HALF_LIFE_S, (float)METEO_STATS_PERIOD_S);
+meteo::stats::Ewma<float> stats_direction_sin((float)METEO_STATS_HALF_LIFE_S, (float)METEO_STATS_PERIOD_S);
+uint32_t stats_samples;
+ULONG stats_reset_time;
+// The day's digest only gets the hours, merged
+Quantiles quant_hour;
+Quantiles quant_day;
+bool quant_started;
+meteo_stats_quantiles_t quant_last_hour;
+meteo_stats_quantiles_t quant_last_day;
+
+/**
+ * @brief value as text with a NUL, in out[12]
+ */
+const char *stats_text(char *out, float value, uint32_t decimals)
+{
+    uint32_t length = meteo_format_float(out, 11U, value, decimals);
+
+    out[length] = '\0';
+    return out;
+}
+
+void stats_snapshot(meteo_stats_snapshot_t *snapshot)
+{
+    uint32_t now = (uint32_t)(tx_time_get() / TX_TIMER_TICKS_PER_SECOND);
+    float direction;
+    uint32_t i;
+
+    snapshot->samples = stats_samples;
+    snapshot->since = tx_time_get() - stats_reset_time;
+    for (i = 0; i < METEO_ARCHIVE_CHANNELS; i++)
+    {
+        Channel &c = stats_channel[i];
+
+        // Also when no frame came for a while
+        c.range.expire(now);
+        snapshot->channel[i].mean = (float)c.welford.mean();
+        snapshot->channel[i].stddev = (float)c.welford.stddev();
+        snapshot->channel[i].ewma = c.ewma.mean();
+        snapshot->channel[i].min = c.range.min();
+        snapshot->channel[i].max = c.range.max();
+    }
+
+    snapshot->channel[METEO_ARCHIVE_WIND_DIRECTION].mean = stats_direction.mean();
+    snapshot->channel[METEO_ARCHIVE_WIND_DIRECTION].stddev = stats_direction.stddev();
+    direction = std::atan2(stats_direction_sin.mean(), stats_direction_cos.mean()) * stats_degrees;
+    snapshot->channel[METEO_ARCHIVE_WIND_DIRECTION].ewma = (direction < 0.0f) ? direction + 360.0f : direction;
+    snapshot->wind_steadiness = stats_direction.resultant();
+}
+
+/* One line: mean/stddev of each channel */
+void stats_publish(const meteo_stats_snapshot_t *snapshot)
+{
+    char mean[METEO_ARCHIVE_CHANNELS][12];
+    char stddev[METEO_ARCHIVE_CHANNELS][12];
+    uint32_t i;
+
+    for (i = 0; i < METEO_ARCHIVE_CHANNELS; i++)
+    {
+        (void)stats_text(mean[i], snapshot->channel[i].mean, stats_decimals[i]);
+        (void)stats_text(stddev[i], snapshot->channel[i].stddev, stats_decimals[i]);
+    }
+    printf("[STATS] %lu readings: T %s/%s P %s/%s WS %s/%s WD %s/%s V %s/%s\n",
+           (unsigned long)snapshot->samples, mean[0], stddev[0], mean[1], stddev[1],
+           mean[2], stddev[2], mean[3], stddev[3], mean[4], stddev[4]);
+}
+
+/**
+ * @brief Add a wind speed, closing the hour and the day when now is past them
+ * @return 1 when an hour closed, 3 when the day did too
+ */
+uint32_t quant_add(float value, uint32_t now)
+{
+    uint32_t closed = 0U;
+    uint32_t i;
+
+    if (!quant_started)
+    {
+        quant_started = true;
+        quant_hour.reset(now - now % METEO_STATS_HOUR_S);
+        quant_day.reset(now - now % METEO_STATS_DAY_S);
+    }
+    if (now / METEO_STATS_HOUR_S != quant_hour.start / METEO_STATS_HOUR_S)
+    {
+        quant_hour.close(&quant_last_hour);
+        quant_day.digest.merge(quant_hour.digest);
+        quant_hour.reset(now - now % METEO_STATS_HOUR_S);
+        closed = 1U;
+        if (now / METEO_STATS_DAY_S != quant_day.start / METEO_STATS_DAY_S)
+        {
+            quant_day.close(&quant_last_day);
+            quant_day.reset(now - now % METEO_STATS_DAY_S);
+            closed = 3U;
+        }
+    }
+
+    quant_hour.digest.add(value);
+    quant_hour.samples++;
+    quant_day.samples++;
+    for (i = 0; i < METEO_STATS_QUANTILES; i++)
+    {
+        quant_hour.p2[i].add(value);
+        quant_day.p2[i].add(value);
+    }
+
+    return closed;
+}
+
+/* One line: the quantiles of a closed hour or day */
+void quant_publish(const char *window, uint32_t number, const meteo_stats_quantiles_t *q)
+{
+    char text[7][12];
+    uint32_t i;
+
+    for (i = 0; i < METEO_STATS_QUANTILES; i++)
+    {
+        (void)stats_text(text[i], q->p2[i], 1U);
+        (void)stats_text(text[3U + i], q->digest[i], 1U);
+    }
+    (void)stats_text(text[6], q->max, 1U);
+    printf("[STATS] wind_speed %s %lu: %lu readings, P50/P90/P99 %s/%s/%s (t-digest %s/%s/%s), max %s m/s\n",
+           window, (unsigned long)number, (unsigned long)q->samples, text[0], text[1], text[2],
+           text[3], text[4], text[5], text[6]);
+}
+
+} // namespace
+
+extern "C" void meteo_stats_init(void)
+{
+    if (tx_mutex_create(&stats_mutex, (CHAR *)"METEO Stats Mutex", TX_INHERIT) != TX_SUCCESS)
+    {
+        printf("[STATS] Create failed\n");
+    }
+}
+
+extern "C" void meteo_stats_add(const meteo_archive_sample_t *sample)
+{
+    meteo_stats_snapshot_t snapshot;
+    uint32_t now = (uint32_t)(tx_time_get() / TX_TIMER_TICKS_PER_SECOND);
+    float direction = sample->value[METEO_ARCHIVE_WIND_DIRECTION] / stats_degrees;
+    meteo_stats_quantiles_t hour;
+    meteo_stats_quantiles_t day;
+    uint32_t closed;
+    bool publish;
+    uint32_t i;
+
+    tx_mutex_get(&stats_mutex, TX_WAIT_FOREVER);
+
+    for (i = 0; i < METEO_ARCHIVE_CHANNELS; i++)
+    {
+        stats_channel[i].welford.add(sample->value[i]);
+        stats_channel[i].ewma.add(sample->value[i]);
+        stats_channel[i].range.add(sample->value[i], now);
+    }
+    stats_direction.add(sample->value[METEO_ARCHIVE_WIND_DIRECTION]);
+    stats_direction_cos.add(std::cos(direction));
+    stats_direction_sin.add(std::sin(direction));
+    stats_samples++;
+    closed = quant_add(sample->value[METEO_ARCHIVE_WIND_SPEED], now);
+    hour = quant_last_hour;
+    day = quant_last_day;
+
+    publish = (METEO_STATS_PUBLISH_SAMPLES != 0U) && (stats_samples % METEO_STATS_PUBLISH_SAMPLES == 0U);
+    if (publish)
+    {
+        stats_snapshot(&snapshot);
+    }
+
+    tx_mutex_put(&stats_mutex);
+
+    if (publish)
+    {
+        stats_publish(&snapshot);
+    }
+    if ((closed & 1U) != 0U)
+    {
+        quant_publish("hour", hour.start / METEO_STATS_HOUR_S, &hour);
+    }
+    if ((closed & 2U) != 0U)
+    {
+        quant_publish("day", day.start / METEO_STATS_DAY_S, &day);
+    }
+}
+
+extern "C" void meteo_stats_reset(void)
+{
+    uint32_t i;
+
+    tx_mutex_get(&stats_mutex, TX_WAIT_FOREVER);
+
+    for (i = 0; i < METEO_ARCHIVE_CHANNELS; i++)
+    {
+        stats_channel[i].welford.reset();
+    }
+    stats_direction.reset();
+    stats_samples = 0U;
+    stats_reset_time = tx_time_get();
+
+    tx_mutex_put(&stats_mutex);
+}
+
+extern "C" void meteo_stats_get(meteo_stats_snapshot_t *snapshot)
+{
+    tx_mutex_get(&stats_mutex, TX_WAIT_FOREVER);
+    stats_snapshot(snapshot);
+    tx_mutex_put(&stats_mutex);
+}
+
+extern "C" void meteo_stats_get_quantiles(meteo_stats_quantiles_t *hour, meteo_stats_quantiles_t *day)
+{
+    tx_mutex_get(&stats_mutex, TX_WAIT_FOREVER);
+    *hour = quant_last_hour;
+    *day = quant_last_day;
+    tx_mutex_put(&stats_mutex);
+}
+
+extern "C" void meteo_stats_print(void)
+{
+    meteo_stats_snapshot_t snapshot;
+    meteo_stats_quantiles_t hour;
+    meteo_stats_quantiles_t day;
+    char text[5][12];
+    uint32_t i;
+
+    meteo_stats_get(&snapshot);
+    meteo_stats_get_quantiles(&hour, &day);
+
+    printf("=== Statistics: %lu readings in %lu s ===\n", (unsigned long)snapshot.samples,
+           (unsigned long)(snapshot.since / TX_TIMER_TICKS_PER_SECOND));
+    printf("  %-15s %9s %9s %9s %9s %9s\n", "", "mean", "stddev", "ewma 10m", "min 1h", "max 1h");
+    for (i = 0; i < METEO_ARCHIVE_CHANNELS; i++)
+    {
+        const meteo_stats_channel_t &c = snapshot.channel[i];
+
+        printf("  %-15s %9s %9s %9s %9s %9s\n", stats_names[i],
+               stats_text(text[0], c.mean, stats_decimals[i]), stats_text(text[1], c.stddev, stats_decimals[i]),
+               stats_text(text[2], c.ewma, stats_decimals[i]), stats_text(text[3], c.min, stats_decimals[i]),
+               stats_text(text[4], c.max, stats_decimals[i]));
+    }
+    printf("  Wind direction is circular, steadiness %s (1 = constant)\n",
+           stats_text(text[0], snapshot.wind_steadiness, 2U));
+    if (hour.samples != 0U)
+    {
+        quant_publish("hour", hour.start / METEO_STATS_HOUR_S, &hour);
+    }
+    if (day.samples != 0U)
+    {
+        quant_publish("day", day.start / METEO_STATS_DAY_S, &day);
+    }
+}
@@ -0,0 +1,414 @@
+/**
+ * @brief Per-thread CPU load and stack high-water marks
+ * @version 19.10.26
+ * @author R.Oliva
+ * @description CPU time per thread, per interrupt source and idle comes from
+ *              the ThreadX execution profile kit (TX_EXECUTION_PROFILE_ENABLE,
+ *              DWT cycle counter on target, CLOCK_MONOTONIC on the Linux
+ *              host). A ThreadX timer samples it every METEO_STATS_PERIOD_TICKS
+ *              together with the stack high-water mark of every thread, found
+ *              like tx_thread_stack_analyze by scanning for the stack fill
+ *              pattern. Console: 'T' table, 'B' binary record.
+ */
+
+#include "meteo_thread_stats.h"
+#include "main.h"
+#include "tx_api.h"
+#include "tx_thread.h"
+#include <stdio.h>
+#include <string.h>
+
+#ifdef TX_EXECUTION_PROFILE_ENABLE
+#include "tx_execution_profile.h"
+typedef EXECUTION_TIME stats_time_t;
+#else
+typedef ULONG64 stats_time_t;
+#endif
+
+// One sampled thread
+typedef struct
+{
+    TX_THREAD *thread;
+    const CHAR *name;
+    UINT priority;
+    UINT state;
+    ULONG stack_size;
+    ULONG stack_used;           // high-water mark, bytes
+    uint16_t load;              // 0.01 % of the window
+    stats_time_t time;          // execution time at the sample
+} stats_thread_t;
+
+// One sampled interrupt source
+typedef struct
+{
+    ULONG id;                   // exception number
+    ULONG count;                // interrupts in the window
+    ULONG count_total;
+    uint16_t load;
+    stats_time_t time;
+} stats_isr_t;
+
+typedef struct
+{
+    ULONG tick;                 // tx_time_get() at the sample
+    ULONG window_ticks;
+    UINT thread_count;
+    UINT isr_count;
+    uint16_t idle_load;
+    uint16_t isr_load;
+    stats_time_t idle_time;
+    stats_time_t isr_time;
+    stats_time_t thread_time;
+    stats_thread_t threads[METEO_STATS_MAX_THREADS];
+    stats_isr_t isrs[METEO_STATS_MAX_ISRS];
+} stats_sample_t;
+
+/* Two samples: the timer fills one while the console reads the other */
+static stats_sample_t stats_samples[2];
+static volatile UINT stats_current;
+static TX_TIMER stats_timer;
+
+static void stats_timer_entry(ULONG input);
+static void stats_sample(void);
+
+/**
+ * @brief Stack high-water mark: bytes from the top of the stack down to the
+ *        lowest word that no longer holds the fill pattern
+ */
+static ULONG stats_stack_used(const TX_THREAD *thread)
+{
+    const UCHAR *start = (const UCHAR *)thread->tx_thread_stack_start;
+    const UCHAR *end = (const UCHAR *)thread->tx_thread_stack_end;
+    const ULONG *word = (const ULONG *)(((ALIGN_TYPE)start + sizeof(ULONG) - 1U) & ~(ALIGN_TYPE)(sizeof(ULONG) - 1U));
+
+    while ((const UCHAR *)(word + 1) <= end && *word == TX_STACK_FILL)
+    {
+        word++;
+    }
+    return (ULONG)(end - (const UCHAR *)word) + 1U;
+}
+
+/**
+ * @brief Share of a window in 0.01 %
+ */
+static uint16_t stats_load(stats_time_t part, stats_time_t window)
+{
+    if (window == 0U)
+    {
+        return 0U;
+    }
+    if (part > window)
+    {
+        part = window;
+    }
+    return (uint16_t)((part * 10000U + window / 2U) / window);
+}
+
+/**
+ * @brief Start periodic sampling
+ */
+void meteo_thread_stats_init(void)
+{
+    UINT status;
+
+    stats_sample();
+
+    status = tx_timer_create(&stats_timer, "METEO Stats", stats_timer_entry, 0,
+                             METEO_STATS_PERIOD_TICKS, METEO_STATS_PERIOD_TICKS,
+                             TX_AUTO_ACTIVATE);
+    if (status != TX_SUCCESS)
+    {
+        printf("ERROR: Failed to create stats timer (status=0x%X)\n", status);
+    }
+}
+
+static void stats_timer_entry(ULONG input)
+{
+    (void)input;
+    stats_sample();
+}
+
+/**
+ * @brief Sample all threads and interrupt sources into the spare buffer,
+ *        then publish it. Runs in the timer thread.
+ */
+static void stats_sample(void)
+{
+    const stats_sample_t *last = &stats_samples[stats_current];
+    stats_sample_t *next = &stats_samples[stats_current ^ 1U];
+    TX_THREAD *thread;
+    ULONG count;
+    UINT old_posture;
+    UINT i;
+    UINT j;
+
+    next->tick = tx_time_get();
+    next->window_ticks = next->tick - last->tick;
+
+    // Walk the created list with interrupts locked, keep it short
+    old_posture = tx_interrupt_control(TX_INT_DISABLE);
+    thread = _tx_thread_created_ptr;
+    count = _tx_thread_created_count;
+    for (i = 0; i < METEO_STATS_MAX_THREADS && count > 0U; i++, count--)
+    {
+        next->threads[i].thread = thread;
+        next->threads[i].name = thread->tx_thread_name;
+        next->threads[i].priority = thread->tx_thread_priority;
+        next->threads[i].state = thread->tx_thread_state;
+        next->threads[i].stack_size = thread->tx_thread_stack_size;
+        thread = thread->tx_thread_created_next;
+    }
+    next->thread_count = i;
+    tx_interrupt_control(old_posture);
+
+    for (i = 0; i < next->thread_count; i++)
+    {
+        next->threads[i].stack_used = stats_stack_used(next->threads[i].thread);
+    }
+
+#ifdef TX_EXECUTION_PROFILE_ENABLE
+    {
+        stats_time_t window;
+        TX_EXECUTION_ISR isr;
+
+        _tx_execution_idle_time_get(&next->idle_time);
+        _tx_execution_isr_time_get(&next->isr_time);
+        _tx_execution_thread_total_time_get(&next->thread_time);
+        window = (next->idle_time - last->idle_time) +
+                 (next->isr_time - last->isr_time) +
+                 (next->thread_time - last->thread_time);
+
+        next->idle_load = stats_load(next->idle_time - last->idle_time, window);
+        next->isr_load = stats_load(next->isr_time - last->isr_time, window);
+
+        for (i = 0; i < next->thread_count; i++)
+        {
+            stats_thread_t *entry = &next->threads[i];
+            stats_time_t previous = 0U;
+
+            _tx_execution_thread_time_get(entry->thread, &entry->time);
+            for (j = 0; j < last->thread_count; j++)
+            {
+                if (last->threads[j].thread == entry->thread)
+                {
+                    previous = last->threads[j].time;
+                    break;
+                }
+            }
+            entry->load = stats_load(entry->time - previous, window);
+        }
+
+        for (i = 0; i < METEO_STATS_MAX_ISRS &&
+                    _tx_execution_isr_source_get(i, &isr) == TX_SUCCESS; i++)
+        {
+            stats_isr_t *entry = &next->isrs[i];
+            ULONG previous_count = 0U;
+            stats_time_t previous_time = 0U;
+
+            // Table entries never move, so index i is the same source as last time
+            if (i < last->isr_count && last->isrs[i].id == isr.tx_execution_isr_id)
+            {
+                previous_count = last->isrs[i].count_total;
+                previous_time = last->isrs[i].time;
+            }
+            entry->id = isr.tx_execution_isr_id;
+            entry->count_total = isr.tx_execution_isr_count;
+            entry->count = isr.tx_execution_isr_count - previous_count;
+            entry->time = isr.tx_execution_isr_time;
+            entry->load = stats_load(entry->time - previous_time, window);
+        }
+        next->isr_count = i;
+    }
+#else
+    next->isr_count = 0;
+#endif
+
+    stats_current ^= 1U;
+}
+
+static const char *stats_state_name(UINT state)
+{
+    switch (state)
+    {
+        case TX_READY:          return "READY";
+        case TX_COMPLETED:      return "DONE";
+        case TX_TERMINATED:     return "TERM";
+        case TX_SUSPENDED:      return "SUSP";
+        case TX_SLEEP:          return "SLEEP";
+        case TX_QUEUE_SUSP:     return "QUEUE";
+        case TX_SEMAPHORE_SUSP: return "SEMA";
+        case TX_EVENT_FLAG:     return "EVENT";
+        case TX_BLOCK_MEMORY:   return "BLOCK";
+        case TX_BYTE_MEMORY:    return "BYTE";
+        case TX_MUTEX_SUSP:     return "MUTEX";
+        default:                return "OTHER";
+    }
+}
+
+static void stats_isr_name(ULONG id, char *buffer, size_t size)
+{
+    switch (id)
+    {
+        case 15U:                           snprintf(buffer, size, "SysTick");  break;
+        case 16U + EXTI13_IRQn:             snprintf(buffer, size, "EXTI13");   break;
+        case 16U + EXTI14_IRQn:             snprintf(buffer, size, "EXTI14");   break;
+        case 16U + GPDMA1_Channel0_IRQn:    snprintf(buffer, size, "GPDMA1_0"); break;
+        case 16U + GPDMA1_Channel1_IRQn:    snprintf(buffer, size, "GPDMA1_1"); break;
+        case 16U + GPDMA1_Channel2_IRQn:    snprintf(buffer, size, "GPDMA1_2"); break;
+        case 16U + TIM6_IRQn:               snprintf(buffer, size, "TIM6");     break;
+        case 16U + USART1_IRQn:             snprintf(buffer, size, "USART1");   break;
+        case 16U + USART3_IRQn:             snprintf(buffer, size, "USART3");   break;
+        case 16U + OCTOSPI1_IRQn:           snprintf(buffer, size, "OCTOSPI1"); break;
+        case 16U + ETH_IRQn:                snprintf(buffer, size, "ETH");      break;
+        case 0xFFFFFFFFUL:                  snprintf(buffer, size, "other");    break;
+        default:
+            if (id >= 16U)
+            {
+                snprintf(buffer, size, "IRQ %lu", (unsigned long)(id - 16U));
+            }
+            else
+            {
+                snprintf(buffer, size, "exc %lu", (unsigned long)id);
+            }
+            break;
+    }
+}
+
+/**
+ * @brief Print the last sample as a table on the console
+ */
+void meteo_thread_stats_print(void)
+{
+    const stats_sample_t *sample = &stats_samples[stats_current];
+    char isr_name[16];
+    UINT i;
+
+    printf("\n");
+    printf("=== Thread Statistics (window %lu ms) ===\n",
+           (unsigned long)(sample->window_ticks * 1000U / TX_TIMER_TICKS_PER_SECOND));
+    printf("  %-20s %4s %-6s %7s %7s %7s %5s\n",
+           "Thread", "Prio", "State", "CPU%", "Stack", "Used", "Used%");
+    for (i = 0; i < sample->thread_count; i++)
+    {
+        const stats_thread_t *entry = &sample->threads[i];
+        ULONG used_pct = entry->stack_size ? (entry->stack_used * 100U) / entry->stack_size : 0U;
+
+        printf("  %-20.20s %4u %-6s %4u.%02u %7lu %7lu %4lu%%%s\n",
+               entry->name ? entry->name : "?",
+               entry->priority,
+               stats_state_name(entry->state),
+               entry->load / 100U, entry->load % 100U,
+               (unsigned long)entry->stack_size,
+               (unsigned long)entry->stack_used,
+               (unsigned long)used_pct,
+               used_pct >= 90U ? " !" : "");
+    }
+
+#ifdef TX_EXECUTION_PROFILE_ENABLE
+    printf("  %-20s %4s %-6s %4u.%02u\n", "(idle)", "", "", sample->idle_load / 100U, sample->idle_load % 100U);
+    printf("  %-20s %4s %-6s %4u.%02u\n", "(interrupts)", "", "", sample->isr_load / 100U, sample->isr_load % 100U);
+    printf("  %-20s %12s %7s\n", "Interrupt", "CPU%", "Count");
+    for (i = 0; i < sample->isr_count; i++)
+    {
+        const stats_isr_t *entry = &sample->isrs[i];
+
+        stats_isr_name(entry->id, isr_name, sizeof(isr_name));
+        printf("  %-20s %9u.%02u %7lu\n", isr_name,
+               entry->load / 100U, entry->load % 100U, (unsigned long)entry->count);
+    }
+#else
+    printf("  CPU load not available (TX_EXECUTION_PROFILE_ENABLE not set)\n");
+#endif
+    printf("=========================================\n");
+    printf("\n");
+}
+
+static uint8_t *stats_put16(uint8_t *p, uint16_t value)
+{
+    p[0] = (uint8_t)value;
+    p[1] = (uint8_t)(value >> 8);
+    return p + 2;
+}
+
+static uint8_t *stats_put32(uint8_t *p, uint32_t value)
+{
+    p[0] = (uint8_t)value;
+    p[1] = (uint8_t)(value >> 8);
+    p[2] = (uint8_t)(value >> 16);
+    p[3] = (uint8_t)(value >> 24);
+    return p + 4;
+}
+
+/**
+ * @brief Encode the last sample as a binary stats record
+ */
+UINT meteo_thread_stats_record(uint8_t *buffer, UINT size)
+{
+    const stats_sample_t *sample = &stats_samples[stats_current];
+    UINT record_size = METEO_STATS_HEADER_SIZE +
+                       sample->thread_count * METEO_STATS_THREAD_SIZE +
+                       sample->isr_count * METEO_STATS_ISR_SIZE;
+    uint8_t *p = buffer;
+    UINT i;
+
+    if (buffer == NULL || size < record_size)
+    {
+        return 0;
+    }
+
+    *p++ = 'T';
+    *p++ = 'S';
+    *p++ = METEO_STATS_RECORD_VERSION;
+    *p++ = METEO_STATS_HEADER_SIZE;
+    *p++ = (uint8_t)sample->thread_count;
+    *p++ = (uint8_t)sample->isr_count;
+    p = stats_put16(p, (uint16_t)record_size);
+    p = stats_put32(p, (uint32_t)sample->tick);
+    p = stats_put16(p, sample->idle_load);
+    p = stats_put16(p, sample->isr_load);
+
+    for (i = 0; i < sample->thread_count; i++)
+    {
+        const stats_thread_t *entry = &sample->threads[i];
+
+        memset(p, 0, 8);
+        if (entry->name != NULL)
+        {
+            strncpy((char *)p, entry->name, 8);
+        }
+        p += 8;
+        p = stats_put16(p, entry->load);
+        *p++ = (uint8_t)entry->priority;
+        *p++ = (uint8_t)entry->state;
+        p = stats_put32(p, (uint32_t)entry->stack_size);
+        p = stats_put32(p, (uint32_t)entry->stack_used);
+    }
+
+    for (i = 0; i < sample->isr_count; i++)
+    {
+        const stats_isr_t *entry = &sample->isrs[i];
+
+        p = stats_put16(p, (uint16_t)entry->id);
+        p = stats_put16(p, entry->load);
+        p = stats_put32(p, (uint32_t)entry->count);
+    }
+
+    return record_size;
+}
+
+/**
+ * @brief Print the binary stats record as one hex line
+ */
+void meteo_thread_stats_print_record(void)
+{
+    static uint8_t record[METEO_STATS_RECORD_MAX];
+    UINT length = meteo_thread_stats_record(record, sizeof(record));
+    UINT i;
+
+    printf("[STATS] ");
+    for (i = 0; i < length; i++)
+    {
+        printf("%02X", record[i]);
+    }
+    printf("\n");
+}
@@ -0,0 +1,125 @@
+/**
+ * @brief ThreadX event trace capture and dump
+ * @version 19.10.26
+ * @author R.Oliva
+ * @description With TX_ENABLE_EVENT_TRACE the kernel records scheduling,
+ *              interrupts and service calls, and the application adds
+ *              METEO_TRACE() events, in a circular buffer placed in the
+ *              .tx_trace RAM section (NOLOAD: not cleared at start-up, so
+ *              the debugger can also read it after a fault). A dump stops
+ *              the trace, sends the buffer and starts a new trace:
+ *              console 'D' prints it as hex lines, the NetX thread serves
+ *              it raw on METEO_TRACE_TCP_PORT. Core/Host/Tools/
+ *              tx_trace_to_json.c converts either to a Chrome/Perfetto
+ *              timeline.
+ */
+
+#include "meteo_trace.h"
+#include "meteo_console.h"
+#include <stdio.h>
+
+#ifdef TX_ENABLE_EVENT_TRACE
+
+// Dump line: offset, then METEO_TRACE_LINE_BYTES bytes in hex
+#define METEO_TRACE_LINE_BYTES  32U
+
+#ifdef OS_LINUX
+#define METEO_TRACE_SECTION
+#else
+#define METEO_TRACE_SECTION     __attribute__((section(".tx_trace")))
+#endif
+
+static ULONG trace_buffer[METEO_TRACE_BUFFER_SIZE / sizeof(ULONG)] METEO_TRACE_SECTION;
+
+void meteo_trace_init(void)
+{
+    UINT status = tx_trace_enable(trace_buffer, sizeof(trace_buffer), METEO_TRACE_REGISTRY_ENTRIES);
+
+    if (status != TX_SUCCESS)
+    {
+        printf("[TRACE] Enable failed (0x%02X)\n", status);
+    }
+}
+
+UINT meteo_trace_stop(const UCHAR **buffer, ULONG *size)
+{
+    // Only one dump at a time: a second stop finds the trace disabled
+    UINT status = tx_trace_disable();
+
+    *buffer = (const UCHAR *)trace_buffer;
+    *size = sizeof(trace_buffer);
+    return status;
+}
+
+void meteo_trace_restart(void)
+{
+    meteo_trace_init();
+}
+
+void meteo_trace_dump(void)
+{
+    const UCHAR *buffer;
+    ULONG size;
+    ULONG offset;
+    ULONG lines = 0;
+    UINT i;
+    meteo_console_overflow_t overflow;
+
+    if (meteo_trace_stop(&buffer, &size) != TX_SUCCESS)
+    {
+        printf("[TRACE] Not running\n");
+        return;
+    }
+
+    // ~80 KB of text: wait for the console rather than lose lines
+    overflow = meteo_console_set_overflow(METEO_CONSOLE_BLOCK);
+
+    // All-zero lines (unused entries) are skipped, the converter refills them
+    printf("[TRACE] BEGIN %lu\n", (unsigned long)size);
+    for (offset = 0; offset < size; offset += METEO_TRACE_LINE_BYTES)
+    {
+        for (i = 0; i < METEO_TRACE_LINE_BYTES && buffer[offset + i] == 0U; i++)
+        {
+        }
+        if (i == METEO_TRACE_LINE_BYTES)
+        {
+            continue;
+        }
+
+        printf("[TRACE] %05lX ", (unsigned long)offset);
+        for (i = 0; i < METEO_TRACE_LINE_BYTES; i++)
+        {
+            printf("%02X", buffer[offset + i]);
+        }
+        printf("\n");
+        lines++;
+    }
+    printf("[TRACE] END %lu\n", (unsigned long)lines);
+    (void)meteo_console_set_overflow(overflow);
+
+    meteo_trace_restart();
+}
+
+#else
+
+void meteo_trace_init(void)
+{
+}
+
+UINT meteo_trace_stop(const UCHAR **buffer, ULONG *size)
+{
+    *buffer = TX_NULL;
+    *size = 0;
+    return TX_FEATURE_NOT_ENABLED;
+}
+
+void meteo_trace_restart(void)
+{
+}
+
+void meteo_trace_dump(void)
+{
+    printf("[TRACE] TX_ENABLE_EVENT_TRACE is not defined in tx_user.h\n");
+}
+
+#endif
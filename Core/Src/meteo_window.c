@@ -0,0 +1,101 @@
+/**
+ * @brief Sliding window of the latest readings for NanoEdge AI
+ * @version 19.10.26
+ * @author R.Oliva
+ * @description NanoEdge AI libraries take a fixed buffer of samples x axes
+ *              floats, interleaved. The DB thread adds each decoded frame
+ *              here; the last METEO_WINDOW_SAMPLES are always one
+ *              contiguous array, without copying them out of a ring: the
+ *              buffer is twice the window and every sample is written at
+ *              its slot and at slot + METEO_WINDOW_SAMPLES, so the window
+ *              starting at the oldest slot never wraps. That costs a second
+ *              20-byte store per frame instead of a 1280-byte copy per
+ *              inference. Every K samples a callback gets the window in
+ *              the DB thread, at the ingest rate, e.g. to run
+ *              neai_anomalydetection_detect() on it.
+ */
+
+#include "meteo_window.h"
+#include <stdio.h>
+#include <string.h>
+
+#define WINDOW_STRIDE           (METEO_WINDOW_SAMPLES * METEO_WINDOW_AXES)
+
+static TX_MUTEX window_mutex;
+
+// Two copies of the ring, one after the other: a slot is at i and i + METEO_WINDOW_SAMPLES
+static float window_buffer[2U * WINDOW_STRIDE];
+
+static struct
+{
+    uint32_t head;                  // Next slot, the oldest sample once full
+    uint32_t count;                 // Samples in the window
+    uint32_t due;                   // Samples until the next callback
+    meteo_window_callback_t callback;
+    void *context;
+    meteo_window_stats_t stats;
+} window;
+
+void meteo_window_init(void)
+{
+    if (tx_mutex_create(&window_mutex, "METEO Window Mutex", TX_INHERIT) != TX_SUCCESS)
+    {
+        printf("[WINDOW] Create failed\n");
+    }
+}
+
+void meteo_window_set_callback(meteo_window_callback_t callback, void *context, uint32_t every)
+{
+    tx_mutex_get(&window_mutex, TX_WAIT_FOREVER);
+
+    if (every == 0U)
+    {
+        callback = NULL;
+    }
+    window.callback = callback;
+    window.context = context;
+    window.stats.every = (callback != NULL) ? every : 0U;
+    // First call for the next full window
+    window.due = 1U;
+
+    tx_mutex_put(&window_mutex);
+}
+
+void meteo_window_add(const float *values)
+{
+    float *slot;
+
+    tx_mutex_get(&window_mutex, TX_WAIT_FOREVER);
+
+    slot = &window_buffer[window.head * METEO_WINDOW_AXES];
+    memcpy(slot, values, METEO_WINDOW_AXES * sizeof(float));
+    memcpy(slot + WINDOW_STRIDE, values, METEO_WINDOW_AXES * sizeof(float));
+
+    window.head = (window.head + 1U < METEO_WINDOW_SAMPLES) ? window.head + 1U : 0U;
+    if (window.count < METEO_WINDOW_SAMPLES)
+    {
+        window.count++;
+    }
+    window.stats.samples++;
+
+    if (window.callback != NULL && window.count == METEO_WINDOW_SAMPLES && --window.due == 0U)
+    {
+        window.due = window.stats.every;
+        window.stats.windows++;
+        window.callback(window.context, &window_buffer[window.head * METEO_WINDOW_AXES]);
+    }
+
+    tx_mutex_put(&window_mutex);
+}
+
+const float *meteo_window_get(void)
+{
+    return (window.count == METEO_WINDOW_SAMPLES) ? &window_buffer[window.head * METEO_WINDOW_AXES] : NULL;
+}
+
+void meteo_window_get_stats(meteo_window_stats_t *stats)
+{
+    tx_mutex_get(&window_mutex, TX_WAIT_FOREVER);
+    *stats = window.stats;
+    tx_mutex_put(&window_mutex);
+}
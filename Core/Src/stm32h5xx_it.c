@@ -22,6 +22,7 @@
 #include "stm32h5xx_it.h"
 /* Private includes ----------------------------------------------------------*/
 /* USER CODE BEGIN Includes */
+#include "tx_api.h"
 /* USER CODE END Includes */
 
 /* Private typedef -----------------------------------------------------------*/
@@ -36,7 +37,24 @@
 
 /* Private macro -------------------------------------------------------------*/
 /* USER CODE BEGIN PM */
-
+/* 19.10.26 Charge the handler time to its IRQ in the thread statistics */
+#ifdef TX_EXECUTION_PROFILE_ENABLE
+#define ISR_TIME_ENTER()      _tx_execution_isr_enter()
+#define ISR_TIME_EXIT()       _tx_execution_isr_exit()
+#else
+#define ISR_TIME_ENTER()
+#define ISR_TIME_EXIT()
+#endif
+/* 19.10.26 and mark it in the ThreadX trace, ISR id = exception number */
+#ifdef TX_ENABLE_EVENT_TRACE
+#define ISR_TRACE_ENTER()     tx_trace_isr_enter_insert(__get_IPSR())
+#define ISR_TRACE_EXIT()      tx_trace_isr_exit_insert(__get_IPSR())
+#else
+#define ISR_TRACE_ENTER()
+#define ISR_TRACE_EXIT()
+#endif
+#define ISR_PROFILE_ENTER()   do { ISR_TIME_ENTER(); ISR_TRACE_ENTER(); } while (0)
+#define ISR_PROFILE_EXIT()    do { ISR_TRACE_EXIT(); ISR_TIME_EXIT(); } while (0)
 /* USER CODE END PM */
 
 /* Private variables ---------------------------------------------------------*/
@@ -63,7 +81,8 @@ extern DMA_HandleTypeDef handle_GPDMA1_Channel1;
 extern DMA_HandleTypeDef handle_GPDMA1_Channel0;
 extern XSPI_HandleTypeDef hospi1;
 /* USER CODE BEGIN EV */
-
+// 19.10.26 Console output (meteo_console.c)
+extern DMA_HandleTypeDef handle_GPDMA1_Channel2;
 /* USER CODE END EV */
 
 /******************************************************************************/
@@ -200,11 +219,11 @@ void DebugMon_Handler(void)
 void EXTI14_IRQHandler(void)
 {
   /* USER CODE BEGIN EXTI14_IRQn 0 */
-
+  ISR_PROFILE_ENTER();
   /* USER CODE END EXTI14_IRQn 0 */
   HAL_GPIO_EXTI_IRQHandler(GPIO_PIN_14);
   /* USER CODE BEGIN EXTI14_IRQn 1 */
-
+  ISR_PROFILE_EXIT();
   /* USER CODE END EXTI14_IRQn 1 */
 }
 
@@ -214,11 +233,11 @@ void EXTI14_IRQHandler(void)
 void GPDMA1_Channel0_IRQHandler(void)
 {
   /* USER CODE BEGIN GPDMA1_Channel0_IRQn 0 */
-
+  ISR_PROFILE_ENTER();
   /* USER CODE END GPDMA1_Channel0_IRQn 0 */
   HAL_DMA_IRQHandler(&handle_GPDMA1_Channel0);
   /* USER CODE BEGIN GPDMA1_Channel0_IRQn 1 */
-
+  ISR_PROFILE_EXIT();
   /* USER CODE END GPDMA1_Channel0_IRQn 1 */
 }
 
@@ -228,11 +247,11 @@ void GPDMA1_Channel0_IRQHandler(void)
 void GPDMA1_Channel1_IRQHandler(void)
 {
   /* USER CODE BEGIN GPDMA1_Channel1_IRQn 0 */
-
+  ISR_PROFILE_ENTER();
   /* USER CODE END GPDMA1_Channel1_IRQn 0 */
   HAL_DMA_IRQHandler(&handle_GPDMA1_Channel1);
   /* USER CODE BEGIN GPDMA1_Channel1_IRQn 1 */
-
+  ISR_PROFILE_EXIT();
   /* USER CODE END GPDMA1_Channel1_IRQn 1 */
 }
 
@@ -242,11 +261,11 @@ void GPDMA1_Channel1_IRQHandler(void)
 void TIM6_IRQHandler(void)
 {
   /* USER CODE BEGIN TIM6_IRQn 0 */
-
+  ISR_PROFILE_ENTER();
   /* USER CODE END TIM6_IRQn 0 */
   HAL_TIM_IRQHandler(&htim6);
   /* USER CODE BEGIN TIM6_IRQn 1 */
-
+  ISR_PROFILE_EXIT();
   /* USER CODE END TIM6_IRQn 1 */
 }
 
@@ -256,11 +275,11 @@ void TIM6_IRQHandler(void)
 void OCTOSPI1_IRQHandler(void)
 {
   /* USER CODE BEGIN OCTOSPI1_IRQn 0 */
-
+  ISR_PROFILE_ENTER();
   /* USER CODE END OCTOSPI1_IRQn 0 */
   HAL_XSPI_IRQHandler(&hospi1);
   /* USER CODE BEGIN OCTOSPI1_IRQn 1 */
-
+  ISR_PROFILE_EXIT();
   /* USER CODE END OCTOSPI1_IRQn 1 */
 }
 /**
@@ -269,11 +288,11 @@ void OCTOSPI1_IRQHandler(void)
 void USART3_IRQHandler(void)
 {
   /* USER CODE BEGIN USART3_IRQn 0 */
-
+  ISR_PROFILE_ENTER();
   /* USER CODE END USART3_IRQn 0 */
   HAL_UART_IRQHandler(&huart3);
   /* USER CODE BEGIN USART3_IRQn 1 */
-
+  ISR_PROFILE_EXIT();
   /* USER CODE END USART3_IRQn 1 */
 }
 
@@ -283,11 +302,11 @@ void USART3_IRQHandler(void)
 void ETH_IRQHandler(void)
 {
   /* USER CODE BEGIN ETH_IRQn 0 */
-
+  ISR_PROFILE_ENTER();
   /* USER CODE END ETH_IRQn 0 */
   HAL_ETH_IRQHandler(&heth);
   /* USER CODE BEGIN ETH_IRQn 1 */
-
+  ISR_PROFILE_EXIT();
   /* USER CODE END ETH_IRQn 1 */
 }
 
@@ -299,7 +318,29 @@ void ETH_IRQHandler(void)
  */
 void EXTI13_IRQHandler(void)
 {
+    ISR_PROFILE_ENTER();
     HAL_GPIO_EXTI_IRQHandler(GPIO_PIN_13);
+    ISR_PROFILE_EXIT();
+}
+
+/** Added 19.10.26 Console keys by interrupt
+ * @brief USART1 (BSP COM1 / VCP) global interrupt handler
+ */
+void USART1_IRQHandler(void)
+{
+    ISR_PROFILE_ENTER();
+    HAL_UART_IRQHandler(&hcom_uart[COM1]);
+    ISR_PROFILE_EXIT();
+}
+
+/** Added 19.10.26 Console output by DMA (meteo_console.c)
+ * @brief GPDMA1 Channel 2 (COM1 TX) global interrupt handler
+ */
+void GPDMA1_Channel2_IRQHandler(void)
+{
+    ISR_PROFILE_ENTER();
+    HAL_DMA_IRQHandler(&handle_GPDMA1_Channel2);
+    ISR_PROFILE_EXIT();
 }
 
 /* USER CODE END 1 */
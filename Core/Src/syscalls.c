@@ -29,6 +29,8 @@
 #include <time.h>
 #include <sys/time.h>
 #include <sys/times.h>
+#include "meteo_trace.h"
+#include "meteo_console.h"
 
 
 /* Variables */
@@ -82,10 +84,23 @@ __attribute__((weak)) int _write(int file, char *ptr, int len)
   (void)file;
   int DataIdx;
 
-  for (DataIdx = 0; DataIdx < len; DataIdx++)
+  /* 19.10.26 Console output time in the trace */
+  METEO_TRACE(METEO_TRACE_CONSOLE_BEGIN, len, 0);
+  if (meteo_console_active())
+  {
+    /* 19.10.26 Queued for COM1 TX DMA. Bytes lost to a full ring are
+       counted there, not reported to newlib (it would retry them) */
+    (void)meteo_console_write(ptr, len);
+  }
+  else
   {
-    __io_putchar(*ptr++);
+    /* Before meteo_console_init(): blocking, byte by byte */
+    for (DataIdx = 0; DataIdx < len; DataIdx++)
+    {
+      __io_putchar(*ptr++);
+    }
   }
+  METEO_TRACE(METEO_TRACE_CONSOLE_END, len, 0);
   return len;
 }
 
@@ -31,6 +31,7 @@
 
 #include "db_netxduo_tcp.h"
 #include "tx_api.h"
+#include "meteo_trace.h"
 
 #include <ittia/os/os_debug.h>
 
@@ -388,6 +389,7 @@ db_netxduo_tcp_send( db_udcp_handle_t h, const void * buffer, size_t buffer_size
 	/* Send buffer to client. */
 	status = nx_tcp_socket_send(netxduo_tcp_handle->server_socket, netxduo_packet, 200);
 	netxduo_tcp_handle->wait_thread_ptr = NULL;
+	METEO_TRACE(METEO_TRACE_IDC_SEND, buffer_size, status);
 	if(status != NX_SUCCESS) {
 		nx_packet_release(netxduo_packet);
 		return DB_ESOCKETSEND;
@@ -30,6 +30,8 @@
 
 #include "tx_api.h"
 #include "lx_stm32_ospi_driver.h" //  1.2.26 Added LevelX
+#include "meteo_trace.h" // 19.10.26 Block erases in the ThreadX trace
+#include "meteo_ospi.h" // 19.10.26 OSPI shared with the frame journal and archive
 
 static dbstatus_t check_ospi_status(uint64_t timeout);
 
@@ -55,7 +57,8 @@ static dbstatus_t ittia_media_ospi_init(void * driver_info, const char * storage
 	LX_STM32_OSPI_POST_INIT();
 
 	*block_size = ospi_block_size;
-	*total_blocks = ospi_total_blocks;
+	// 19.10.26 The top blocks belong to the frame journal and the archive
+	*total_blocks = ospi_total_blocks - METEO_OSPI_RESERVED_BLOCKS;
 
 	return DB_NOERROR;
 }
@@ -69,7 +72,7 @@ static dbstatus_t ittia_media_ospi_shutdown(void * driver_info)
 	return DB_NOERROR;
 }
 
-static dbstatus_t ittia_media_ospi_read_bytes(void * driver_info, void * region_info, uint64_t offset, void * data, uint32_t byte_count)
+static dbstatus_t ospi_read_bytes_locked(void * driver_info, void * region_info, uint64_t offset, void * data, uint32_t byte_count)
 {
     dbstatus_t status = DB_NOERROR;
 
@@ -99,7 +102,7 @@ static dbstatus_t ittia_media_ospi_read_bytes(void * driver_info, void * region_
 	return status;
 }
 
-static dbstatus_t ittia_media_ospi_append_bytes(void * driver_info, void * region_info, uint64_t offset, const void * data, uint32_t byte_count)
+static dbstatus_t ospi_append_bytes_locked(void * driver_info, void * region_info, uint64_t offset, const void * data, uint32_t byte_count)
 {
     dbstatus_t status = DB_NOERROR;
     if ((NULL != data) && (check_ospi_status(((TX_TIMER_TICKS_PER_SECOND/100) * (byte_count * byte_count)) + (TX_TIMER_TICKS_PER_SECOND/100)) != DB_NOERROR))
@@ -129,9 +132,15 @@ static dbstatus_t ittia_media_ospi_append_bytes(void * driver_info, void * regio
 	return status;
 }
 
-static dbstatus_t ittia_media_ospi_erase_block(void * driver_info, uint64_t block_number)
+static dbstatus_t ospi_erase_block_locked(void * driver_info, uint64_t block_number)
 {
-	if (0 != lx_stm32_ospi_erase(LX_STM32_OSPI_INSTANCE, block_number, 0, 0))
+	INT status;
+
+	METEO_TRACE(METEO_TRACE_OSPI_ERASE_BEGIN, block_number, 0);
+	status = lx_stm32_ospi_erase(LX_STM32_OSPI_INSTANCE, block_number, 0, 0);
+	METEO_TRACE(METEO_TRACE_OSPI_ERASE_END, block_number, status);
+
+	if (0 != status)
 	{
 		return DB_EIO;
 	}
@@ -139,6 +148,40 @@ static dbstatus_t ittia_media_ospi_erase_block(void * driver_info, uint64_t bloc
 	return DB_NOERROR;
 }
 
+// 19.10.26 One OSPI user at a time: the journal and archive use the same XSPI DMA and semaphores
+static dbstatus_t ittia_media_ospi_read_bytes(void * driver_info, void * region_info, uint64_t offset, void * data, uint32_t byte_count)
+{
+	dbstatus_t status;
+
+	meteo_ospi_lock();
+	status = ospi_read_bytes_locked(driver_info, region_info, offset, data, byte_count);
+	meteo_ospi_unlock();
+
+	return status;
+}
+
+static dbstatus_t ittia_media_ospi_append_bytes(void * driver_info, void * region_info, uint64_t offset, const void * data, uint32_t byte_count)
+{
+	dbstatus_t status;
+
+	meteo_ospi_lock();
+	status = ospi_append_bytes_locked(driver_info, region_info, offset, data, byte_count);
+	meteo_ospi_unlock();
+
+	return status;
+}
+
+static dbstatus_t ittia_media_ospi_erase_block(void * driver_info, uint64_t block_number)
+{
+	dbstatus_t status;
+
+	meteo_ospi_lock();
+	status = ospi_erase_block_locked(driver_info, block_number);
+	meteo_ospi_unlock();
+
+	return status;
+}
+
 static dbstatus_t ittia_media_ospi_sync_writes(void * driver_info)
 {
 	/* The OSPI driver does not have any buffers to flush. */
@@ -44,6 +44,8 @@
 /*  05-19-2020     William E. Lamie         Initial Version 6.0           */
 /*  09-30-2020     Yuxin Zhou               Modified comment(s),          */
 /*                                            resulting in version 6.1    */
+/*  10-19-2026                              Added the TLSF allocator      */
+/*                                            option                      */
 /*                                                                        */
 /**************************************************************************/
 
@@ -63,11 +65,82 @@
 #define TX_BYTE_BLOCK_MIN                       ((ULONG) 20)
 #endif
 
+#ifdef TX_BYTE_POOL_ENABLE_TLSF
+
+/* The TLSF index lives at the start of the pool memory, which raises the
+   smallest usable pool.  */
+
+#ifndef TX_BYTE_POOL_MIN
+#define TX_BYTE_POOL_MIN                        ((ULONG) 1024)
+#endif
+#endif
+
 #ifndef TX_BYTE_POOL_MIN
 #define TX_BYTE_POOL_MIN                        ((ULONG) 100)
 #endif
 
 
+#ifdef TX_BYTE_POOL_ENABLE_TLSF
+
+/* Define the two-level segregated fit (TLSF) parameters. Free blocks are
+   kept in one list per size class: the first level splits sizes by powers
+   of two, the second level splits each power of two into
+   2^TX_BYTE_POOL_TLSF_SL_LOG2 linear ranges. Blocks smaller than
+   TX_BYTE_POOL_TLSF_SMALL_SIZE all go to first level 0, one list per
+   ALIGN_TYPE step. The second level must fit in a ULONG bitmap.  */
+
+#ifndef TX_BYTE_POOL_TLSF_SL_LOG2
+#define TX_BYTE_POOL_TLSF_SL_LOG2               ((UINT) 4)
+#endif
+
+#define TX_BYTE_POOL_TLSF_SL_COUNT              (((UINT) 1) << TX_BYTE_POOL_TLSF_SL_LOG2)
+#define TX_BYTE_POOL_TLSF_ALIGN_LOG2            (((sizeof(ALIGN_TYPE)) == ((UINT) 8)) ? ((UINT) 3) : ((UINT) 2))
+#define TX_BYTE_POOL_TLSF_SMALL_LOG2            (TX_BYTE_POOL_TLSF_SL_LOG2 + TX_BYTE_POOL_TLSF_ALIGN_LOG2)
+#define TX_BYTE_POOL_TLSF_SMALL_SIZE            (((ULONG) 1) << TX_BYTE_POOL_TLSF_SMALL_LOG2)
+
+
+/* Define the bit scan used for the size class mapping and the bitmap
+   lookups. Both are single instructions on Cortex-M (CLZ, RBIT+CLZ).  */
+
+#ifndef TX_BYTE_POOL_TLSF_MSB
+#ifdef __GNUC__
+#define TX_BYTE_POOL_TLSF_MSB(v)                ((UINT) (((sizeof(unsigned long)) * ((UINT) 8)) - ((UINT) 1) - ((UINT) __builtin_clzl((unsigned long) (v)))))
+#define TX_BYTE_POOL_TLSF_LSB(v)                ((UINT) __builtin_ctzl((unsigned long) (v)))
+#else
+#define TX_BYTE_POOL_TLSF_MSB(v)                _tx_byte_pool_tlsf_msb((ULONG) (v))
+#define TX_BYTE_POOL_TLSF_LSB(v)                _tx_byte_pool_tlsf_lsb((ULONG) (v))
+#define TX_BYTE_POOL_TLSF_PORTABLE_BIT_SCAN
+#endif
+#endif
+
+
+/* Define the TLSF index. It is placed at the start of the pool memory,
+   followed by the second level bitmaps and the free list heads, so its
+   size follows the pool size. tx_byte_pool_start points to it and
+   tx_byte_pool_list to the first block after it.  */
+
+typedef struct TX_BYTE_POOL_TLSF_STRUCT
+{
+
+    /* Define the number of first level classes.  */
+    ULONG               tx_byte_pool_tlsf_fl_count;
+
+    /* Define the bitmap of non-empty first level classes.  */
+    ULONG               tx_byte_pool_tlsf_fl_bitmap;
+
+    /* Define the bitmaps of non-empty second level lists, one per first
+       level class.  */
+    ULONG               *tx_byte_pool_tlsf_sl_bitmap;
+
+    /* Define the free list heads, TX_BYTE_POOL_TLSF_SL_COUNT per first
+       level class.  */
+    UCHAR               **tx_byte_pool_tlsf_free_list;
+
+} TX_BYTE_POOL_TLSF;
+
+#endif
+
+
 /* Determine if in-line component initialization is supported by the
    caller.  */
 
@@ -104,6 +177,14 @@ VOID        _tx_byte_pool_initialize(VOID);
 
 UCHAR       *_tx_byte_pool_search(TX_BYTE_POOL *pool_ptr, ULONG memory_size);
 VOID        _tx_byte_pool_cleanup(TX_THREAD *thread_ptr, ULONG suspension_sequence);
+#ifdef TX_BYTE_POOL_ENABLE_TLSF
+UINT        _tx_byte_pool_tlsf_create(TX_BYTE_POOL *pool_ptr);
+VOID        _tx_byte_pool_tlsf_release(TX_BYTE_POOL *pool_ptr, UCHAR *block_ptr);
+#ifdef TX_BYTE_POOL_TLSF_PORTABLE_BIT_SCAN
+UINT        _tx_byte_pool_tlsf_msb(ULONG value);
+UINT        _tx_byte_pool_tlsf_lsb(ULONG value);
+#endif
+#endif
 
 
 /* Byte pool management component data declarations follow.  */
@@ -450,12 +450,14 @@ TRACE_DECLARE  ULONG                             _tx_trace_available_registry_en
 TRACE_DECLARE  ULONG                             _tx_trace_registry_search_start;
 
 
-/* Define the event trace macros that are expanded in-line when event tracing is enabled.  */
+/* Define the event trace macros that are expanded in-line when event tracing is enabled.
+   Trace fields are 32-bit: pointers go through ALIGN_TYPE, so on a 64-bit host the
+   object IDs are the low 32 bits of the address, as in the object registry.  */
 
 #ifdef TX_MISRA_ENABLE
-#define TX_TRACE_INFO_FIELD_ASSIGNMENT(a,b,c,d)  trace_event_ptr -> tx_trace_buffer_entry_info_1 =  (ULONG) (a); trace_event_ptr -> tx_trace_buffer_entry_info_2 =  (ULONG) (b); trace_event_ptr -> tx_trace_buffer_entry_info_3 =  (ULONG) (c); trace_event_ptr -> tx_trace_buffer_entry_info_4 =  (ULONG) (d);
+#define TX_TRACE_INFO_FIELD_ASSIGNMENT(a,b,c,d)  trace_event_ptr -> tx_trace_buffer_entry_info_1 =  (ULONG) (ALIGN_TYPE) (a); trace_event_ptr -> tx_trace_buffer_entry_info_2 =  (ULONG) (ALIGN_TYPE) (b); trace_event_ptr -> tx_trace_buffer_entry_info_3 =  (ULONG) (ALIGN_TYPE) (c); trace_event_ptr -> tx_trace_buffer_entry_info_4 =  (ULONG) (ALIGN_TYPE) (d);
 #else
-#define TX_TRACE_INFO_FIELD_ASSIGNMENT(a,b,c,d)  trace_event_ptr -> tx_trace_buffer_entry_information_field_1 =  (ULONG) (a); trace_event_ptr -> tx_trace_buffer_entry_information_field_2 =  (ULONG) (b); trace_event_ptr -> tx_trace_buffer_entry_information_field_3 =  (ULONG) (c); trace_event_ptr -> tx_trace_buffer_entry_information_field_4 =  (ULONG) (d);
+#define TX_TRACE_INFO_FIELD_ASSIGNMENT(a,b,c,d)  trace_event_ptr -> tx_trace_buffer_entry_information_field_1 =  (ULONG) (ALIGN_TYPE) (a); trace_event_ptr -> tx_trace_buffer_entry_information_field_2 =  (ULONG) (ALIGN_TYPE) (b); trace_event_ptr -> tx_trace_buffer_entry_information_field_3 =  (ULONG) (ALIGN_TYPE) (c); trace_event_ptr -> tx_trace_buffer_entry_information_field_4 =  (ULONG) (ALIGN_TYPE) (d);
 #endif
 
 
@@ -483,7 +485,7 @@ TRACE_DECLARE  ULONG                             _tx_trace_registry_search_start
                 } \
                 else if (trace_system_state < 0xF0F0F0F0UL) \
                 { \
-                    trace_priority =    (ULONG) trace_thread_ptr; \
+                    trace_priority =    (ULONG) (ALIGN_TYPE) trace_thread_ptr; \
                     trace_thread_ptr =  (TX_THREAD *) 0xFFFFFFFFUL; \
                 } \
                 else \
@@ -491,7 +493,7 @@ TRACE_DECLARE  ULONG                             _tx_trace_registry_search_start
                     trace_thread_ptr =  (TX_THREAD *) 0xF0F0F0F0UL; \
                     trace_priority =    0; \
                 } \
-                trace_event_ptr -> tx_trace_buffer_entry_thread_pointer =       (ULONG) trace_thread_ptr; \
+                trace_event_ptr -> tx_trace_buffer_entry_thread_pointer =       (ULONG) (ALIGN_TYPE) trace_thread_ptr; \
                 trace_event_ptr -> tx_trace_buffer_entry_thread_priority =      (ULONG) trace_priority; \
                 trace_event_ptr -> tx_trace_buffer_entry_event_id =             (ULONG) (i); \
                 trace_event_ptr -> tx_trace_buffer_entry_time_stamp =           (ULONG) TX_TRACE_TIME_SOURCE; \
@@ -501,14 +503,14 @@ TRACE_DECLARE  ULONG                             _tx_trace_registry_search_start
                 { \
                     trace_event_ptr =  _tx_trace_buffer_start_ptr; \
                     _tx_trace_buffer_current_ptr =  trace_event_ptr;  \
-                    _tx_trace_header_ptr -> tx_trace_header_buffer_current_pointer =  (ULONG) trace_event_ptr; \
+                    _tx_trace_header_ptr -> tx_trace_header_buffer_current_pointer =  (ULONG) (ALIGN_TYPE) trace_event_ptr; \
                     if (_tx_trace_full_notify_function) \
                         (_tx_trace_full_notify_function)((VOID *) _tx_trace_header_ptr); \
                 } \
                 else \
                 { \
                     _tx_trace_buffer_current_ptr =  trace_event_ptr;  \
-                    _tx_trace_header_ptr -> tx_trace_header_buffer_current_pointer =  (ULONG) trace_event_ptr; \
+                    _tx_trace_header_ptr -> tx_trace_header_buffer_current_pointer =  (ULONG) (ALIGN_TYPE) trace_event_ptr; \
                 } \
             } \
         }
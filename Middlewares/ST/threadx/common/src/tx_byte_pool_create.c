@@ -55,10 +55,11 @@
 /*  OUTPUT                                                                */
 /*                                                                        */
 /*    TX_SUCCESS                        Successful completion status      */
+/*    TX_SIZE_ERROR                     Pool too small for the TLSF index */
 /*                                                                        */
 /*  CALLS                                                                 */
 /*                                                                        */
-/*    None                                                                */
+/*    _tx_byte_pool_tlsf_create         Build the TLSF index (option)     */
 /*                                                                        */
 /*  CALLED BY                                                             */
 /*                                                                        */
@@ -71,6 +72,8 @@
 /*  05-19-2020     William E. Lamie         Initial Version 6.0           */
 /*  09-30-2020     Yuxin Zhou               Modified comment(s),          */
 /*                                            resulting in version 6.1    */
+/*  10-19-2026                              Added the TLSF allocator      */
+/*                                            option                      */
 /*                                                                        */
 /**************************************************************************/
 UINT  _tx_byte_pool_create(TX_BYTE_POOL *pool_ptr, CHAR *name_ptr, VOID *pool_start, ULONG pool_size)
@@ -78,12 +81,16 @@ UINT  _tx_byte_pool_create(TX_BYTE_POOL *pool_ptr, CHAR *name_ptr, VOID *pool_st
 
 TX_INTERRUPT_SAVE_AREA
 
+TX_BYTE_POOL        *next_pool;
+TX_BYTE_POOL        *previous_pool;
+#if !defined(TX_BYTE_POOL_ENABLE_TLSF) || defined(TX_ENABLE_EVENT_TRACE)
 UCHAR               *block_ptr;
+#endif
+#ifndef TX_BYTE_POOL_ENABLE_TLSF
 UCHAR               **block_indirect_ptr;
 UCHAR               *temp_ptr;
-TX_BYTE_POOL        *next_pool;
-TX_BYTE_POOL        *previous_pool;
 ALIGN_TYPE          *free_ptr;
+#endif
 
 
     /* Initialize the byte pool control block to all zeros.  */
@@ -100,6 +107,20 @@ ALIGN_TYPE          *free_ptr;
     pool_ptr -> tx_byte_pool_start =   TX_VOID_TO_UCHAR_POINTER_CONVERT(pool_start);
     pool_ptr -> tx_byte_pool_size =    pool_size;
 
+#ifdef TX_BYTE_POOL_ENABLE_TLSF
+
+    /* Build the TLSF index and the initial free block.  */
+    if (_tx_byte_pool_tlsf_create(pool_ptr) != TX_SUCCESS)
+    {
+
+        /* The pool cannot hold its index.  */
+        return(TX_SIZE_ERROR);
+    }
+#ifdef TX_ENABLE_EVENT_TRACE
+    block_ptr =  pool_ptr -> tx_byte_pool_list;
+#endif
+#else
+
     /* Setup memory list to the beginning as well as the search pointer.  */
     pool_ptr -> tx_byte_pool_list =    TX_VOID_TO_UCHAR_POINTER_CONVERT(pool_start);
     pool_ptr -> tx_byte_pool_search =  TX_VOID_TO_UCHAR_POINTER_CONVERT(pool_start);
@@ -139,6 +160,7 @@ ALIGN_TYPE          *free_ptr;
     block_ptr =            TX_UCHAR_POINTER_ADD(block_ptr, (sizeof(UCHAR *)));
     free_ptr =             TX_UCHAR_TO_ALIGN_TYPE_POINTER_CONVERT(block_ptr);
     *free_ptr =            TX_BYTE_BLOCK_FREE;
+#endif
 
     /* Clear the owner id.  */
     pool_ptr -> tx_byte_pool_owner =  TX_NULL;
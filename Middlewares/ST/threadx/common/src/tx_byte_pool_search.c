@@ -30,6 +30,11 @@
 #include "tx_byte_pool.h"
 
 
+/* With TX_BYTE_POOL_ENABLE_TLSF the search is provided by
+   tx_byte_pool_tlsf.c.  */
+
+#ifndef TX_BYTE_POOL_ENABLE_TLSF
+
 /**************************************************************************/
 /*                                                                        */
 /*  FUNCTION                                               RELEASE        */
@@ -82,6 +87,8 @@
 /*  06-02-2021      Scott Larson            Improve possible free bytes   */
 /*                                            calculation,                */
 /*                                            resulting in version 6.1.7  */
+/*  10-19-2026                              Not built with the TLSF       */
+/*                                            allocator option            */
 /*                                                                        */
 /**************************************************************************/
 UCHAR  *_tx_byte_pool_search(TX_BYTE_POOL *pool_ptr, ULONG memory_size)
@@ -351,4 +358,4 @@ ULONG           total_theoretical_available;
     /* Return the search pointer.  */
     return(current_ptr);
 }
-
+#endif
@@ -0,0 +1,662 @@
+/**************************************************************************/
+/*                                                                        */
+/*       Copyright (c) Microsoft Corporation. All rights reserved.        */
+/*                                                                        */
+/*       This software is licensed under the Microsoft Software License   */
+/*       Terms for Microsoft Azure RTOS. Full text of the license can be  */
+/*       found in the LICENSE file at https://aka.ms/AzureRTOS_EULA       */
+/*       and in the root directory of this software.                      */
+/*                                                                        */
+/**************************************************************************/
+
+
+/**************************************************************************/
+/**************************************************************************/
+/**                                                                       */
+/** ThreadX Component                                                     */
+/**                                                                       */
+/**   Byte Pool                                                           */
+/**                                                                       */
+/**************************************************************************/
+/**************************************************************************/
+
+#define TX_SOURCE_CODE
+
+
+/* Include necessary system files.  */
+
+#include "tx_api.h"
+#include "tx_thread.h"
+#include "tx_byte_pool.h"
+
+
+#ifdef TX_BYTE_POOL_ENABLE_TLSF
+
+/* Blocks keep the layout of the first-fit pool: a pointer to the next
+   physical block followed by an ALIGN_TYPE that holds TX_BYTE_BLOCK_FREE or
+   the owning pool, so tx_byte_release and the debug views see the same
+   headers. In addition:
+
+     - bit 0 of the next pointer is set when the previous physical block is
+       free; the last pointer of that free block then holds its address
+     - a free block holds its free list links at the start of its memory
+
+   so both neighbours of a released block are found without a search.  */
+
+#define TX_BYTE_POOL_TLSF_HEADER        ((sizeof(UCHAR *)) + (sizeof(ALIGN_TYPE)))
+#define TX_BYTE_POOL_TLSF_PREV_FREE     ((ALIGN_TYPE) 1)
+
+/* Smallest block memory: two free list links and the boundary tag.  */
+
+#define TX_BYTE_POOL_TLSF_MIN_SIZE      (((((sizeof(UCHAR *)) * ((ULONG) 3)) + (sizeof(ALIGN_TYPE))) - ((ULONG) 1)) & ~((sizeof(ALIGN_TYPE)) - ((ULONG) 1)))
+
+
+static UCHAR    *_tx_byte_pool_tlsf_next_get(UCHAR *block_ptr);
+static UINT     _tx_byte_pool_tlsf_prev_free_get(UCHAR *block_ptr);
+static VOID     _tx_byte_pool_tlsf_next_set(UCHAR *block_ptr, UCHAR *next_ptr, UINT prev_free);
+static ALIGN_TYPE *_tx_byte_pool_tlsf_owner_get(UCHAR *block_ptr);
+static UCHAR    **_tx_byte_pool_tlsf_links_get(UCHAR *block_ptr);
+static VOID     _tx_byte_pool_tlsf_mapping(ULONG size, UINT *fl, UINT *sl);
+static VOID     _tx_byte_pool_tlsf_insert(TX_BYTE_POOL_TLSF *tlsf_ptr, UCHAR *block_ptr);
+static VOID     _tx_byte_pool_tlsf_remove(TX_BYTE_POOL_TLSF *tlsf_ptr, UCHAR *block_ptr);
+
+
+static UCHAR  *_tx_byte_pool_tlsf_next_get(UCHAR *block_ptr)
+{
+
+UCHAR       **link_ptr;
+ALIGN_TYPE  next;
+
+
+    link_ptr =  TX_UCHAR_TO_INDIRECT_UCHAR_POINTER_CONVERT(block_ptr);
+    next =      TX_POINTER_TO_ALIGN_TYPE_CONVERT(*link_ptr) & ~TX_BYTE_POOL_TLSF_PREV_FREE;
+    return(TX_VOID_TO_UCHAR_POINTER_CONVERT(TX_ALIGN_TYPE_TO_POINTER_CONVERT(next)));
+}
+
+
+static UINT  _tx_byte_pool_tlsf_prev_free_get(UCHAR *block_ptr)
+{
+
+UCHAR       **link_ptr;
+
+
+    link_ptr =  TX_UCHAR_TO_INDIRECT_UCHAR_POINTER_CONVERT(block_ptr);
+    if ((TX_POINTER_TO_ALIGN_TYPE_CONVERT(*link_ptr) & TX_BYTE_POOL_TLSF_PREV_FREE) != ((ALIGN_TYPE) 0))
+    {
+        return(TX_TRUE);
+    }
+    return(TX_FALSE);
+}
+
+
+static VOID  _tx_byte_pool_tlsf_next_set(UCHAR *block_ptr, UCHAR *next_ptr, UINT prev_free)
+{
+
+UCHAR       **link_ptr;
+ALIGN_TYPE  next;
+
+
+    next =  TX_POINTER_TO_ALIGN_TYPE_CONVERT(next_ptr);
+    if (prev_free != TX_FALSE)
+    {
+        next =  next | TX_BYTE_POOL_TLSF_PREV_FREE;
+    }
+    link_ptr =   TX_UCHAR_TO_INDIRECT_UCHAR_POINTER_CONVERT(block_ptr);
+    *link_ptr =  TX_VOID_TO_UCHAR_POINTER_CONVERT(TX_ALIGN_TYPE_TO_POINTER_CONVERT(next));
+}
+
+
+static ALIGN_TYPE  *_tx_byte_pool_tlsf_owner_get(UCHAR *block_ptr)
+{
+
+    return(TX_UCHAR_TO_ALIGN_TYPE_POINTER_CONVERT(TX_UCHAR_POINTER_ADD(block_ptr, (sizeof(UCHAR *)))));
+}
+
+
+static UCHAR  **_tx_byte_pool_tlsf_links_get(UCHAR *block_ptr)
+{
+
+    return(TX_UCHAR_TO_INDIRECT_UCHAR_POINTER_CONVERT(TX_UCHAR_POINTER_ADD(block_ptr, TX_BYTE_POOL_TLSF_HEADER)));
+}
+
+
+/* Map a block memory size to the list that holds blocks of that size.  */
+
+static VOID  _tx_byte_pool_tlsf_mapping(ULONG size, UINT *fl, UINT *sl)
+{
+
+UINT        msb;
+
+
+    if (size < TX_BYTE_POOL_TLSF_SMALL_SIZE)
+    {
+
+        /* Small blocks: one list per ALIGN_TYPE step.  */
+        *fl =  ((UINT) 0);
+        *sl =  (UINT) (size >> TX_BYTE_POOL_TLSF_ALIGN_LOG2);
+    }
+    else
+    {
+
+        /* The first level is the power of two, the second level the next
+           TX_BYTE_POOL_TLSF_SL_LOG2 bits below it.  */
+        msb =  TX_BYTE_POOL_TLSF_MSB(size);
+        *fl =  (msb - TX_BYTE_POOL_TLSF_SMALL_LOG2) + ((UINT) 1);
+        *sl =  (UINT) ((size >> (msb - TX_BYTE_POOL_TLSF_SL_LOG2)) - TX_BYTE_POOL_TLSF_SL_COUNT);
+    }
+}
+
+
+/* Push a free block on the head of its list.  */
+
+static VOID  _tx_byte_pool_tlsf_insert(TX_BYTE_POOL_TLSF *tlsf_ptr, UCHAR *block_ptr)
+{
+
+UINT        fl;
+UINT        sl;
+UCHAR       **head_ptr;
+UCHAR       **links;
+ULONG       size;
+
+
+    size =  TX_UCHAR_POINTER_DIF(_tx_byte_pool_tlsf_next_get(block_ptr), block_ptr) - TX_BYTE_POOL_TLSF_HEADER;
+    _tx_byte_pool_tlsf_mapping(size, &fl, &sl);
+
+    head_ptr =  &tlsf_ptr -> tx_byte_pool_tlsf_free_list[(fl << TX_BYTE_POOL_TLSF_SL_LOG2) + sl];
+    links =     _tx_byte_pool_tlsf_links_get(block_ptr);
+    links[0] =  *head_ptr;
+    links[1] =  TX_NULL;
+    if (*head_ptr != TX_NULL)
+    {
+        _tx_byte_pool_tlsf_links_get(*head_ptr)[1] =  block_ptr;
+    }
+    *head_ptr =  block_ptr;
+
+    tlsf_ptr -> tx_byte_pool_tlsf_fl_bitmap =      tlsf_ptr -> tx_byte_pool_tlsf_fl_bitmap | (((ULONG) 1) << fl);
+    tlsf_ptr -> tx_byte_pool_tlsf_sl_bitmap[fl] =  tlsf_ptr -> tx_byte_pool_tlsf_sl_bitmap[fl] | (((ULONG) 1) << sl);
+}
+
+
+/* Unlink a free block from its list.  */
+
+static VOID  _tx_byte_pool_tlsf_remove(TX_BYTE_POOL_TLSF *tlsf_ptr, UCHAR *block_ptr)
+{
+
+UINT        fl;
+UINT        sl;
+UCHAR       **head_ptr;
+UCHAR       **links;
+ULONG       size;
+
+
+    size =  TX_UCHAR_POINTER_DIF(_tx_byte_pool_tlsf_next_get(block_ptr), block_ptr) - TX_BYTE_POOL_TLSF_HEADER;
+    _tx_byte_pool_tlsf_mapping(size, &fl, &sl);
+
+    head_ptr =  &tlsf_ptr -> tx_byte_pool_tlsf_free_list[(fl << TX_BYTE_POOL_TLSF_SL_LOG2) + sl];
+    links =     _tx_byte_pool_tlsf_links_get(block_ptr);
+    if (links[0] != TX_NULL)
+    {
+        _tx_byte_pool_tlsf_links_get(links[0])[1] =  links[1];
+    }
+    if (links[1] != TX_NULL)
+    {
+        _tx_byte_pool_tlsf_links_get(links[1])[0] =  links[0];
+    }
+    else
+    {
+
+        /* The block was the head of the list.  */
+        *head_ptr =  links[0];
+        if (*head_ptr == TX_NULL)
+        {
+            tlsf_ptr -> tx_byte_pool_tlsf_sl_bitmap[fl] =  tlsf_ptr -> tx_byte_pool_tlsf_sl_bitmap[fl] & ~(((ULONG) 1) << sl);
+            if (tlsf_ptr -> tx_byte_pool_tlsf_sl_bitmap[fl] == ((ULONG) 0))
+            {
+                tlsf_ptr -> tx_byte_pool_tlsf_fl_bitmap =  tlsf_ptr -> tx_byte_pool_tlsf_fl_bitmap & ~(((ULONG) 1) << fl);
+            }
+        }
+    }
+}
+
+
+#ifdef TX_BYTE_POOL_TLSF_PORTABLE_BIT_SCAN
+
+/* Bit scans for compilers without a count-leading-zeros builtin. Both
+   loops are bounded by the width of a ULONG.  */
+
+UINT  _tx_byte_pool_tlsf_msb(ULONG value)
+{
+
+UINT        bit =  ((UINT) 0);
+
+
+    while ((value >> ((UINT) 1)) != ((ULONG) 0))
+    {
+        value =  value >> ((UINT) 1);
+        bit++;
+    }
+    return(bit);
+}
+
+
+UINT  _tx_byte_pool_tlsf_lsb(ULONG value)
+{
+
+UINT        bit =  ((UINT) 0);
+
+
+    while ((value & ((ULONG) 1)) == ((ULONG) 0))
+    {
+        value =  value >> ((UINT) 1);
+        bit++;
+    }
+    return(bit);
+}
+#endif
+
+
+/**************************************************************************/
+/*                                                                        */
+/*  FUNCTION                                               RELEASE        */
+/*                                                                        */
+/*    _tx_byte_pool_tlsf_create                           PORTABLE C      */
+/*                                                           6.4.0        */
+/*                                                                        */
+/*  DESCRIPTION                                                           */
+/*                                                                        */
+/*    This function builds the TLSF index at the start of the pool memory */
+/*    and places the rest of the pool in it as one free block, followed   */
+/*    by the allocated end block used by the first-fit pool as well.      */
+/*                                                                        */
+/*  INPUT                                                                 */
+/*                                                                        */
+/*    pool_ptr                          Pointer to pool control block     */
+/*                                                                        */
+/*  OUTPUT                                                                */
+/*                                                                        */
+/*    TX_SUCCESS                        Successful completion status      */
+/*    TX_SIZE_ERROR                     Pool too small for its index      */
+/*                                                                        */
+/*  CALLS                                                                 */
+/*                                                                        */
+/*    None                                                                */
+/*                                                                        */
+/*  CALLED BY                                                             */
+/*                                                                        */
+/*    _tx_byte_pool_create              Create byte pool                  */
+/*                                                                        */
+/*  RELEASE HISTORY                                                       */
+/*                                                                        */
+/*    DATE              NAME                      DESCRIPTION             */
+/*                                                                        */
+/*  10-19-2026                              Initial Version               */
+/*                                                                        */
+/**************************************************************************/
+UINT  _tx_byte_pool_tlsf_create(TX_BYTE_POOL *pool_ptr)
+{
+
+TX_BYTE_POOL_TLSF   *tlsf_ptr;
+UCHAR               *work_ptr;
+UCHAR               *first_ptr;
+UCHAR               *end_ptr;
+UCHAR               **block_indirect_ptr;
+ULONG               index_size;
+UINT                fl;
+UINT                sl;
+
+
+    /* Size the index for the largest block the pool could hold.  */
+    _tx_byte_pool_tlsf_mapping(pool_ptr -> tx_byte_pool_size, &fl, &sl);
+    index_size =  (sizeof(TX_BYTE_POOL_TLSF)) +
+                  (((ULONG) fl + ((ULONG) 1)) * (sizeof(ULONG))) +
+                  ((((ULONG) fl + ((ULONG) 1)) << TX_BYTE_POOL_TLSF_SL_LOG2) * (sizeof(UCHAR *)));
+    index_size =  ((index_size + (sizeof(ALIGN_TYPE)) - ((ULONG) 1))/(sizeof(ALIGN_TYPE))) * (sizeof(ALIGN_TYPE));
+
+    /* Make sure one free block fits next to the index and the end block.  */
+    if ((index_size + (TX_BYTE_POOL_TLSF_HEADER * ((ULONG) 2)) + TX_BYTE_POOL_TLSF_MIN_SIZE) > pool_ptr -> tx_byte_pool_size)
+    {
+        return(TX_SIZE_ERROR);
+    }
+
+    /* Setup the index.  */
+    TX_MEMSET(pool_ptr -> tx_byte_pool_start, 0, index_size);
+    tlsf_ptr =  (TX_BYTE_POOL_TLSF *) ((VOID *) pool_ptr -> tx_byte_pool_start);
+    work_ptr =  TX_UCHAR_POINTER_ADD(pool_ptr -> tx_byte_pool_start, (sizeof(TX_BYTE_POOL_TLSF)));
+    tlsf_ptr -> tx_byte_pool_tlsf_fl_count =   ((ULONG) fl) + ((ULONG) 1);
+    tlsf_ptr -> tx_byte_pool_tlsf_sl_bitmap =  TX_VOID_TO_ULONG_POINTER_CONVERT(work_ptr);
+    work_ptr =  TX_UCHAR_POINTER_ADD(work_ptr, (tlsf_ptr -> tx_byte_pool_tlsf_fl_count * (sizeof(ULONG))));
+    tlsf_ptr -> tx_byte_pool_tlsf_free_list =  TX_UCHAR_TO_INDIRECT_UCHAR_POINTER_CONVERT(work_ptr);
+
+    /* Build the end block, allocated to the pool and preceded by a free
+       block.  */
+    first_ptr =  TX_UCHAR_POINTER_ADD(pool_ptr -> tx_byte_pool_start, index_size);
+    end_ptr =    TX_UCHAR_POINTER_ADD(pool_ptr -> tx_byte_pool_start, (pool_ptr -> tx_byte_pool_size - TX_BYTE_POOL_TLSF_HEADER));
+    _tx_byte_pool_tlsf_next_set(end_ptr, first_ptr, TX_TRUE);
+    block_indirect_ptr =   TX_UCHAR_TO_INDIRECT_UCHAR_POINTER_CONVERT(TX_UCHAR_POINTER_ADD(end_ptr, (sizeof(UCHAR *))));
+    *block_indirect_ptr =  TX_BYTE_POOL_TO_UCHAR_POINTER_CONVERT(pool_ptr);
+
+    /* Build the free block and its boundary tag.  */
+    _tx_byte_pool_tlsf_next_set(first_ptr, end_ptr, TX_FALSE);
+    *_tx_byte_pool_tlsf_owner_get(first_ptr) =  TX_BYTE_BLOCK_FREE;
+    block_indirect_ptr =   TX_UCHAR_TO_INDIRECT_UCHAR_POINTER_CONVERT(TX_UCHAR_POINTER_SUB(end_ptr, (sizeof(UCHAR *))));
+    *block_indirect_ptr =  first_ptr;
+    _tx_byte_pool_tlsf_insert(tlsf_ptr, first_ptr);
+
+    /* Account for the pool as the first-fit pool does: the free block's
+       header is counted as available, the index is not.  */
+    pool_ptr -> tx_byte_pool_list =       first_ptr;
+    pool_ptr -> tx_byte_pool_search =     first_ptr;
+    pool_ptr -> tx_byte_pool_available =  TX_UCHAR_POINTER_DIF(end_ptr, first_ptr);
+    pool_ptr -> tx_byte_pool_fragments =  ((UINT) 2);
+
+    return(TX_SUCCESS);
+}
+
+
+/**************************************************************************/
+/*                                                                        */
+/*  FUNCTION                                               RELEASE        */
+/*                                                                        */
+/*    _tx_byte_pool_search                                PORTABLE C      */
+/*                                                           6.4.0        */
+/*                                                                        */
+/*  DESCRIPTION                                                           */
+/*                                                                        */
+/*    This function is the TLSF replacement for the first-fit search.     */
+/*    The request is rounded up to the next list boundary, so the head of */
+/*    the first non-empty list at or above it always fits; that list is   */
+/*    found with two bitmap scans. Failing that, the head of the list of  */
+/*    the request itself is tried. The block is split if the remainder    */
+/*    can hold a free block. The work done does not depend on the number  */
+/*    of fragments, so the whole allocation runs with interrupts disabled */
+/*    and the pool owner protocol is never restarted.                     */
+/*                                                                        */
+/*  INPUT                                                                 */
+/*                                                                        */
+/*    pool_ptr                          Pointer to pool control block     */
+/*    memory_size                       Number of bytes required          */
+/*                                                                        */
+/*  OUTPUT                                                                */
+/*                                                                        */
+/*    UCHAR *                           Pointer to the allocated memory,  */
+/*                                        if successful.  Otherwise, a    */
+/*                                        NULL is returned                */
+/*                                                                        */
+/*  CALLS                                                                 */
+/*                                                                        */
+/*    None                                                                */
+/*                                                                        */
+/*  CALLED BY                                                             */
+/*                                                                        */
+/*    _tx_byte_allocate                 Allocate bytes of memory          */
+/*    _tx_byte_release                  Release bytes of memory           */
+/*                                                                        */
+/*  RELEASE HISTORY                                                       */
+/*                                                                        */
+/*    DATE              NAME                      DESCRIPTION             */
+/*                                                                        */
+/*  10-19-2026                              Initial Version               */
+/*                                                                        */
+/**************************************************************************/
+UCHAR  *_tx_byte_pool_search(TX_BYTE_POOL *pool_ptr, ULONG memory_size)
+{
+
+TX_INTERRUPT_SAVE_AREA
+
+TX_BYTE_POOL_TLSF   *tlsf_ptr;
+UCHAR               *current_ptr;
+UCHAR               *next_ptr;
+UCHAR               *split_ptr;
+UCHAR               **block_indirect_ptr;
+ULONG               available_bytes;
+ULONG               search_size;
+ULONG               map;
+UINT                fl;
+UINT                sl;
+
+
+    /* Every block must be able to hold the free list links once released.  */
+    if (memory_size < TX_BYTE_POOL_TLSF_MIN_SIZE)
+    {
+        memory_size =  TX_BYTE_POOL_TLSF_MIN_SIZE;
+    }
+
+    /* Round up to the next list so that any block found is large enough.  */
+    search_size =  memory_size;
+    if (search_size >= TX_BYTE_POOL_TLSF_SMALL_SIZE)
+    {
+        search_size =  search_size + ((((ULONG) 1) << (TX_BYTE_POOL_TLSF_MSB(search_size) - TX_BYTE_POOL_TLSF_SL_LOG2)) - ((ULONG) 1));
+    }
+
+    /* Disable interrupts.  */
+    TX_DISABLE
+
+    tlsf_ptr =     (TX_BYTE_POOL_TLSF *) ((VOID *) pool_ptr -> tx_byte_pool_start);
+    current_ptr =  TX_NULL;
+    if (search_size >= memory_size)
+    {
+
+        _tx_byte_pool_tlsf_mapping(search_size, &fl, &sl);
+        if (((ULONG) fl) < tlsf_ptr -> tx_byte_pool_tlsf_fl_count)
+        {
+
+            /* Look for a list at or above the request in this first level
+               class, then for the smallest non-empty class above it.  */
+            map =  tlsf_ptr -> tx_byte_pool_tlsf_sl_bitmap[fl] & (~((ULONG) 0) << sl);
+            if (map == ((ULONG) 0))
+            {
+                map =  tlsf_ptr -> tx_byte_pool_tlsf_fl_bitmap & (~((ULONG) 0) << (fl + ((UINT) 1)));
+                if (map != ((ULONG) 0))
+                {
+                    fl =   TX_BYTE_POOL_TLSF_LSB(map);
+                    map =  tlsf_ptr -> tx_byte_pool_tlsf_sl_bitmap[fl];
+                }
+            }
+            if (map != ((ULONG) 0))
+            {
+                sl =           TX_BYTE_POOL_TLSF_LSB(map);
+                current_ptr =  tlsf_ptr -> tx_byte_pool_tlsf_free_list[(fl << TX_BYTE_POOL_TLSF_SL_LOG2) + sl];
+            }
+        }
+    }
+
+    /* Rounding up may skip the only block that fits, e.g. when most of
+       the pool is requested. Try the head of the request's own list.  */
+    if (current_ptr == TX_NULL)
+    {
+
+        _tx_byte_pool_tlsf_mapping(memory_size, &fl, &sl);
+        if (((ULONG) fl) < tlsf_ptr -> tx_byte_pool_tlsf_fl_count)
+        {
+            current_ptr =  tlsf_ptr -> tx_byte_pool_tlsf_free_list[(fl << TX_BYTE_POOL_TLSF_SL_LOG2) + sl];
+            if ((current_ptr != TX_NULL) &&
+                ((TX_UCHAR_POINTER_DIF(_tx_byte_pool_tlsf_next_get(current_ptr), current_ptr) - TX_BYTE_POOL_TLSF_HEADER) < memory_size))
+            {
+                current_ptr =  TX_NULL;
+            }
+        }
+    }
+
+    if (current_ptr != TX_NULL)
+    {
+
+#ifdef TX_BYTE_POOL_ENABLE_PERFORMANCE_INFO
+
+        /* Increment the total fragment search counter.  */
+        _tx_byte_pool_performance_search_count++;
+
+        /* Increment the number of fragments searched on this pool.  */
+        pool_ptr -> tx_byte_pool_performance_search_count++;
+#endif
+
+        _tx_byte_pool_tlsf_remove(tlsf_ptr, current_ptr);
+        next_ptr =         _tx_byte_pool_tlsf_next_get(current_ptr);
+        available_bytes =  TX_UCHAR_POINTER_DIF(next_ptr, current_ptr) - TX_BYTE_POOL_TLSF_HEADER;
+
+        /* Determine if we need to split this block.  */
+        if ((available_bytes - memory_size) >= (TX_BYTE_POOL_TLSF_HEADER + TX_BYTE_POOL_TLSF_MIN_SIZE))
+        {
+
+            /* Setup the new free block after the allocated one. The block
+               after it keeps its previous-free flag, only the tag moves.  */
+            split_ptr =  TX_UCHAR_POINTER_ADD(current_ptr, (memory_size + TX_BYTE_POOL_TLSF_HEADER));
+            _tx_byte_pool_tlsf_next_set(split_ptr, next_ptr, TX_FALSE);
+            *_tx_byte_pool_tlsf_owner_get(split_ptr) =  TX_BYTE_BLOCK_FREE;
+            block_indirect_ptr =   TX_UCHAR_TO_INDIRECT_UCHAR_POINTER_CONVERT(TX_UCHAR_POINTER_SUB(next_ptr, (sizeof(UCHAR *))));
+            *block_indirect_ptr =  split_ptr;
+            _tx_byte_pool_tlsf_insert(tlsf_ptr, split_ptr);
+
+            _tx_byte_pool_tlsf_next_set(current_ptr, split_ptr, _tx_byte_pool_tlsf_prev_free_get(current_ptr));
+
+            /* Increase the total fragment counter.  */
+            pool_ptr -> tx_byte_pool_fragments++;
+
+            /* Set available equal to memory size for subsequent calculation.  */
+            available_bytes =  memory_size;
+
+#ifdef TX_BYTE_POOL_ENABLE_PERFORMANCE_INFO
+
+            /* Increment the total split counter.  */
+            _tx_byte_pool_performance_split_count++;
+
+            /* Increment the number of blocks split on this pool.  */
+            pool_ptr -> tx_byte_pool_performance_split_count++;
+#endif
+        }
+        else
+        {
+
+            /* The whole block is used, its neighbour now follows an
+               allocated block.  */
+            _tx_byte_pool_tlsf_next_set(next_ptr, _tx_byte_pool_tlsf_next_get(next_ptr), TX_FALSE);
+        }
+
+        /* In any case, mark the current block as allocated.  */
+        block_indirect_ptr =   TX_UCHAR_TO_INDIRECT_UCHAR_POINTER_CONVERT(TX_UCHAR_POINTER_ADD(current_ptr, (sizeof(UCHAR *))));
+        *block_indirect_ptr =  TX_BYTE_POOL_TO_UCHAR_POINTER_CONVERT(pool_ptr);
+
+        /* Reduce the number of available bytes in the pool.  */
+        pool_ptr -> tx_byte_pool_available =  (pool_ptr -> tx_byte_pool_available - available_bytes) - TX_BYTE_POOL_TLSF_HEADER;
+
+        /* Adjust the pointer for the application.  */
+        current_ptr =  TX_UCHAR_POINTER_ADD(current_ptr, TX_BYTE_POOL_TLSF_HEADER);
+    }
+
+    /* Restore interrupts.  */
+    TX_RESTORE
+
+    /* Return the block pointer.  */
+    return(current_ptr);
+}
+
+
+/**************************************************************************/
+/*                                                                        */
+/*  FUNCTION                                               RELEASE        */
+/*                                                                        */
+/*    _tx_byte_pool_tlsf_release                          PORTABLE C      */
+/*                                                           6.4.0        */
+/*                                                                        */
+/*  DESCRIPTION                                                           */
+/*                                                                        */
+/*    This function returns a block to a TLSF pool. It is merged with a   */
+/*    free neighbour on either side, found through the next pointer and   */
+/*    the boundary tag, and the result is pushed on its list.             */
+/*                                                                        */
+/*    It is called with interrupts disabled.                              */
+/*                                                                        */
+/*  INPUT                                                                 */
+/*                                                                        */
+/*    pool_ptr                          Pointer to pool control block     */
+/*    block_ptr                         Pointer to the block header       */
+/*                                                                        */
+/*  OUTPUT                                                                */
+/*                                                                        */
+/*    None                                                                */
+/*                                                                        */
+/*  CALLS                                                                 */
+/*                                                                        */
+/*    None                                                                */
+/*                                                                        */
+/*  CALLED BY                                                             */
+/*                                                                        */
+/*    _tx_byte_release                  Release bytes of memory           */
+/*                                                                        */
+/*  RELEASE HISTORY                                                       */
+/*                                                                        */
+/*    DATE              NAME                      DESCRIPTION             */
+/*                                                                        */
+/*  10-19-2026                              Initial Version               */
+/*                                                                        */
+/**************************************************************************/
+VOID  _tx_byte_pool_tlsf_release(TX_BYTE_POOL *pool_ptr, UCHAR *block_ptr)
+{
+
+TX_BYTE_POOL_TLSF   *tlsf_ptr;
+UCHAR               *next_ptr;
+UCHAR               *prev_ptr;
+UCHAR               **block_indirect_ptr;
+UINT                prev_free;
+
+
+    tlsf_ptr =   (TX_BYTE_POOL_TLSF *) ((VOID *) pool_ptr -> tx_byte_pool_start);
+    next_ptr =   _tx_byte_pool_tlsf_next_get(block_ptr);
+    prev_free =  _tx_byte_pool_tlsf_prev_free_get(block_ptr);
+
+    /* Update the number of available bytes in the pool.  */
+    pool_ptr -> tx_byte_pool_available =  pool_ptr -> tx_byte_pool_available + TX_UCHAR_POINTER_DIF(next_ptr, block_ptr);
+
+    /* Merge with the next block if it is free. The end block is always
+       allocated, so this never runs past the pool.  */
+    if (*_tx_byte_pool_tlsf_owner_get(next_ptr) == TX_BYTE_BLOCK_FREE)
+    {
+
+        _tx_byte_pool_tlsf_remove(tlsf_ptr, next_ptr);
+        next_ptr =  _tx_byte_pool_tlsf_next_get(next_ptr);
+
+        /* Reduce the fragment total.  */
+        pool_ptr -> tx_byte_pool_fragments--;
+
+#ifdef TX_BYTE_POOL_ENABLE_PERFORMANCE_INFO
+
+        /* Increment the total merge counter.  */
+        _tx_byte_pool_performance_merge_count++;
+
+        /* Increment the number of blocks merged on this pool.  */
+        pool_ptr -> tx_byte_pool_performance_merge_count++;
+#endif
+    }
+
+    /* Merge with the previous block if it is free.  */
+    if (prev_free != TX_FALSE)
+    {
+
+        block_indirect_ptr =  TX_UCHAR_TO_INDIRECT_UCHAR_POINTER_CONVERT(TX_UCHAR_POINTER_SUB(block_ptr, (sizeof(UCHAR *))));
+        prev_ptr =            *block_indirect_ptr;
+        _tx_byte_pool_tlsf_remove(tlsf_ptr, prev_ptr);
+        prev_free =           _tx_byte_pool_tlsf_prev_free_get(prev_ptr);
+        block_ptr =           prev_ptr;
+
+        /* Reduce the fragment total.  */
+        pool_ptr -> tx_byte_pool_fragments--;
+
+#ifdef TX_BYTE_POOL_ENABLE_PERFORMANCE_INFO
+
+        /* Increment the total merge counter.  */
+        _tx_byte_pool_performance_merge_count++;
+
+        /* Increment the number of blocks merged on this pool.  */
+        pool_ptr -> tx_byte_pool_performance_merge_count++;
+#endif
+    }
+
+    /* Mark the block free, tag it for the next block and list it.  */
+    _tx_byte_pool_tlsf_next_set(block_ptr, next_ptr, prev_free);
+    *_tx_byte_pool_tlsf_owner_get(block_ptr) =  TX_BYTE_BLOCK_FREE;
+    block_indirect_ptr =   TX_UCHAR_TO_INDIRECT_UCHAR_POINTER_CONVERT(TX_UCHAR_POINTER_SUB(next_ptr, (sizeof(UCHAR *))));
+    *block_indirect_ptr =  block_ptr;
+    _tx_byte_pool_tlsf_next_set(next_ptr, _tx_byte_pool_tlsf_next_get(next_ptr), TX_TRUE);
+    _tx_byte_pool_tlsf_insert(tlsf_ptr, block_ptr);
+}
+
+#endif
@@ -0,0 +1,95 @@
+/**************************************************************************/
+/*                                                                        */
+/*       Copyright (c) Microsoft Corporation. All rights reserved.        */
+/*                                                                        */
+/*       This software is licensed under the Microsoft Software License   */
+/*       Terms for Microsoft Azure RTOS. Full text of the license can be  */
+/*       found in the LICENSE file at https://aka.ms/AzureRTOS_EULA       */
+/*       and in the root directory of this software.                      */
+/*                                                                        */
+/**************************************************************************/
+
+
+/**************************************************************************/
+/**************************************************************************/
+/**                                                                       */
+/** ThreadX Component                                                     */
+/**                                                                       */
+/**   Trace                                                               */
+/**                                                                       */
+/**************************************************************************/
+/**************************************************************************/
+
+#define TX_SOURCE_CODE
+
+
+/* Include necessary system files.  */
+
+#include "tx_api.h"
+#include "tx_trace.h"
+
+
+/**************************************************************************/
+/*                                                                        */
+/*  FUNCTION                                               RELEASE        */
+/*                                                                        */
+/*    _tx_trace_buffer_full_notify                        PORTABLE C      */
+/*                                                           6.1          */
+/*  AUTHOR                                                                */
+/*                                                                        */
+/*    William E. Lamie, Microsoft Corporation                             */
+/*                                                                        */
+/*  DESCRIPTION                                                           */
+/*                                                                        */
+/*    This function sets up the application callback function that is     */
+/*    called whenever the trace buffer becomes full. The application can  */
+/*    then swap to a new trace buffer in order not to lose any events.    */
+/*                                                                        */
+/*  INPUT                                                                 */
+/*                                                                        */
+/*    full_buffer_callback              Full trace buffer processing      */
+/*                                        function                        */
+/*                                                                        */
+/*  OUTPUT                                                                */
+/*                                                                        */
+/*    status                            Completion status                 */
+/*                                                                        */
+/*  CALLS                                                                 */
+/*                                                                        */
+/*    None                                                                */
+/*                                                                        */
+/*  CALLED BY                                                             */
+/*                                                                        */
+/*    Application Code                                                    */
+/*                                                                        */
+/*  RELEASE HISTORY                                                       */
+/*                                                                        */
+/*    DATE              NAME                      DESCRIPTION             */
+/*                                                                        */
+/*  05-19-2020     William E. Lamie         Initial Version 6.0           */
+/*  09-30-2020     Yuxin Zhou               Modified comment(s),          */
+/*                                            resulting in version 6.1    */
+/*  10-19-2026                              Added to the METEO firmware   */
+/*                                            tree                        */
+/*                                                                        */
+/**************************************************************************/
+UINT  _tx_trace_buffer_full_notify(VOID (*full_buffer_callback)(VOID *buffer))
+{
+
+#ifdef TX_ENABLE_EVENT_TRACE
+
+    /* Setup the callback function pointer.  */
+    _tx_trace_full_notify_function =  full_buffer_callback;
+
+    /* Return success.  */
+    return(TX_SUCCESS);
+
+#else
+
+    /* Access input arguments just for the sake of lint, MISRA, etc.  */
+    TX_PARAMETER_NOT_USED(full_buffer_callback);
+
+    /* Trace not enabled, return an error.  */
+    return(TX_FEATURE_NOT_ENABLED);
+#endif
+}
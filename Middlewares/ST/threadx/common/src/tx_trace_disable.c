@@ -0,0 +1,119 @@
+/**************************************************************************/
+/*                                                                        */
+/*       Copyright (c) Microsoft Corporation. All rights reserved.        */
+/*                                                                        */
+/*       This software is licensed under the Microsoft Software License   */
+/*       Terms for Microsoft Azure RTOS. Full text of the license can be  */
+/*       found in the LICENSE file at https://aka.ms/AzureRTOS_EULA       */
+/*       and in the root directory of this software.                      */
+/*                                                                        */
+/**************************************************************************/
+
+
+/**************************************************************************/
+/**************************************************************************/
+/**                                                                       */
+/** ThreadX Component                                                     */
+/**                                                                       */
+/**   Trace                                                               */
+/**                                                                       */
+/**************************************************************************/
+/**************************************************************************/
+
+#define TX_SOURCE_CODE
+
+
+/* Include necessary system files.  */
+
+#include "tx_api.h"
+#include "tx_trace.h"
+
+
+/**************************************************************************/
+/*                                                                        */
+/*  FUNCTION                                               RELEASE        */
+/*                                                                        */
+/*    _tx_trace_disable                                   PORTABLE C      */
+/*                                                           6.1          */
+/*  AUTHOR                                                                */
+/*                                                                        */
+/*    William E. Lamie, Microsoft Corporation                             */
+/*                                                                        */
+/*  DESCRIPTION                                                           */
+/*                                                                        */
+/*    This function disables trace inside of ThreadX. The trace control   */
+/*    header is left intact, so the buffer contents remain valid for      */
+/*    analysis. Calling _tx_trace_enable afterwards starts a new trace.   */
+/*                                                                        */
+/*  INPUT                                                                 */
+/*                                                                        */
+/*    None                                                                */
+/*                                                                        */
+/*  OUTPUT                                                                */
+/*                                                                        */
+/*    status                            Completion status                 */
+/*                                                                        */
+/*  CALLS                                                                 */
+/*                                                                        */
+/*    None                                                                */
+/*                                                                        */
+/*  CALLED BY                                                             */
+/*                                                                        */
+/*    Application Code                                                    */
+/*                                                                        */
+/*  RELEASE HISTORY                                                       */
+/*                                                                        */
+/*    DATE              NAME                      DESCRIPTION             */
+/*                                                                        */
+/*  05-19-2020     William E. Lamie         Initial Version 6.0           */
+/*  09-30-2020     Yuxin Zhou               Modified comment(s),          */
+/*                                            resulting in version 6.1    */
+/*  10-19-2026                              Added to the METEO firmware   */
+/*                                            tree                        */
+/*                                                                        */
+/**************************************************************************/
+UINT  _tx_trace_disable(VOID)
+{
+
+#ifdef TX_ENABLE_EVENT_TRACE
+
+TX_INTERRUPT_SAVE_AREA
+
+UINT    status;
+
+
+    /* Disable interrupts.  */
+    TX_DISABLE
+
+    /* Determine if trace is already enabled.  */
+    if (_tx_trace_buffer_current_ptr != TX_NULL)
+    {
+
+        /* Disable the trace by clearing the current pointer.  */
+        _tx_trace_buffer_current_ptr =  TX_NULL;
+
+        /* Also stop registering objects.  */
+        _tx_trace_registry_start_ptr =  TX_NULL;
+
+        /* Successful completion.  */
+        status =  TX_SUCCESS;
+    }
+    else
+    {
+
+        /* Trace is not enabled.  */
+        status =  TX_NOT_DONE;
+    }
+
+    /* Restore interrupts.  */
+    TX_RESTORE
+
+    /* Return completion status.  */
+    return(status);
+
+#else
+
+    /* Trace not enabled, return an error.  */
+    return(TX_FEATURE_NOT_ENABLED);
+#endif
+}
@@ -0,0 +1,323 @@
+/**************************************************************************/
+/*                                                                        */
+/*       Copyright (c) Microsoft Corporation. All rights reserved.        */
+/*                                                                        */
+/*       This software is licensed under the Microsoft Software License   */
+/*       Terms for Microsoft Azure RTOS. Full text of the license can be  */
+/*       found in the LICENSE file at https://aka.ms/AzureRTOS_EULA       */
+/*       and in the root directory of this software.                      */
+/*                                                                        */
+/**************************************************************************/
+
+
+/**************************************************************************/
+/**************************************************************************/
+/**                                                                       */
+/** ThreadX Component                                                     */
+/**                                                                       */
+/**   Trace                                                               */
+/**                                                                       */
+/**************************************************************************/
+/**************************************************************************/
+
+#define TX_SOURCE_CODE
+
+
+/* Include necessary system files.  */
+
+#include "tx_api.h"
+#include "tx_trace.h"
+#include "tx_thread.h"
+#include "tx_timer.h"
+#include "tx_queue.h"
+#include "tx_semaphore.h"
+#include "tx_mutex.h"
+#include "tx_event_flags.h"
+#include "tx_block_pool.h"
+#include "tx_byte_pool.h"
+
+
+/**************************************************************************/
+/*                                                                        */
+/*  FUNCTION                                               RELEASE        */
+/*                                                                        */
+/*    _tx_trace_enable                                    PORTABLE C      */
+/*                                                           6.1          */
+/*  AUTHOR                                                                */
+/*                                                                        */
+/*    William E. Lamie, Microsoft Corporation                             */
+/*                                                                        */
+/*  DESCRIPTION                                                           */
+/*                                                                        */
+/*    This function sets up the trace buffer supplied by the              */
+/*    application: the trace control header, the object registry and the  */
+/*    event entries. All objects created so far are entered in the        */
+/*    registry and all events are enabled.                                */
+/*                                                                        */
+/*  INPUT                                                                 */
+/*                                                                        */
+/*    trace_buffer_start                Start of trace buffer             */
+/*    trace_buffer_size                 Size (bytes) of trace buffer      */
+/*    registry_entries                  Number of object registry         */
+/*                                        entries                         */
+/*                                                                        */
+/*  OUTPUT                                                                */
+/*                                                                        */
+/*    status                            Completion status                 */
+/*                                                                        */
+/*  CALLS                                                                 */
+/*                                                                        */
+/*    _tx_trace_object_register         Register existing objects         */
+/*                                                                        */
+/*  CALLED BY                                                             */
+/*                                                                        */
+/*    Application Code                                                    */
+/*                                                                        */
+/*  RELEASE HISTORY                                                       */
+/*                                                                        */
+/*    DATE              NAME                      DESCRIPTION             */
+/*                                                                        */
+/*  05-19-2020     William E. Lamie         Initial Version 6.0           */
+/*  09-30-2020     Yuxin Zhou               Modified comment(s),          */
+/*                                            resulting in version 6.1    */
+/*  10-19-2026                              Added to the METEO firmware   */
+/*                                            tree                        */
+/*                                                                        */
+/**************************************************************************/
+UINT  _tx_trace_enable(VOID *trace_buffer_start, ULONG trace_buffer_size, ULONG registry_entries)
+{
+
+#ifdef TX_ENABLE_EVENT_TRACE
+
+TX_INTERRUPT_SAVE_AREA
+
+UINT                            status;
+ULONG                           i;
+ULONG                           event_entries;
+ULONG                           object_count;
+UCHAR                           *work_ptr;
+TX_TRACE_OBJECT_ENTRY           *entry_ptr;
+TX_TRACE_BUFFER_ENTRY           *event_ptr;
+TX_THREAD                       *thread_ptr;
+TX_TIMER                        *timer_ptr;
+TX_QUEUE                        *queue_ptr;
+TX_SEMAPHORE                    *semaphore_ptr;
+TX_MUTEX                        *mutex_ptr;
+TX_EVENT_FLAGS_GROUP            *events_ptr;
+TX_BLOCK_POOL                   *block_pool_ptr;
+TX_BYTE_POOL                    *byte_pool_ptr;
+
+
+    /* First, see if there is enough room for the control header, the registry entries, and at least one event in
+       memory supplied to this call.  */
+    if (trace_buffer_size < ((sizeof(TX_TRACE_HEADER)) + ((sizeof(TX_TRACE_OBJECT_ENTRY)) * registry_entries) + (sizeof(TX_TRACE_BUFFER_ENTRY))))
+    {
+
+        /* No, the memory isn't big enough to hold one trace buffer entry.  Return an error.  */
+        status =  TX_SIZE_ERROR;
+    }
+    else
+    {
+
+        /* Disable interrupts.  */
+        TX_DISABLE
+
+        /* Determine if trace is already enabled.  */
+        if (_tx_trace_buffer_current_ptr != TX_NULL)
+        {
+
+            /* Yes, trace is already enabled.  */
+            status =  TX_NOT_DONE;
+        }
+        else
+        {
+
+            /* Set the enable bits for all events enabled.  */
+            _tx_trace_event_enable_bits =  0xFFFFFFFFUL;
+
+            /* Setup the header pointer, the header is at the start of the buffer.  */
+            _tx_trace_header_ptr =  TX_UCHAR_TO_HEADER_POINTER_CONVERT(trace_buffer_start);
+
+            /* The object registry follows the header.  */
+            work_ptr =  TX_VOID_TO_UCHAR_POINTER_CONVERT(trace_buffer_start);
+            work_ptr =  TX_UCHAR_POINTER_ADD(work_ptr, (sizeof(TX_TRACE_HEADER)));
+            _tx_trace_registry_start_ptr =  TX_UCHAR_TO_OBJECT_POINTER_CONVERT(work_ptr);
+            work_ptr =  TX_UCHAR_POINTER_ADD(work_ptr, ((sizeof(TX_TRACE_OBJECT_ENTRY)) * registry_entries));
+            _tx_trace_registry_end_ptr =  TX_UCHAR_TO_OBJECT_POINTER_CONVERT(work_ptr);
+
+            /* Mark all the registry entries as available.  */
+            entry_ptr =  _tx_trace_registry_start_ptr;
+            while (entry_ptr < _tx_trace_registry_end_ptr)
+            {
+
+                entry_ptr -> tx_trace_object_entry_available =       (UCHAR) TX_TRUE;
+                entry_ptr -> tx_trace_object_entry_type =            TX_TRACE_OBJECT_TYPE_NOT_VALID;
+                entry_ptr -> tx_trace_object_entry_reserved1 =       ((UCHAR) 0);
+                entry_ptr -> tx_trace_object_entry_reserved2 =       ((UCHAR) 0);
+                entry_ptr -> tx_trace_object_entry_thread_pointer =  ((ULONG) 0);
+                entry_ptr -> tx_trace_object_entry_param_1 =         ((ULONG) 0);
+                entry_ptr -> tx_trace_object_entry_param_2 =         ((ULONG) 0);
+                for (i = ((ULONG) 0); i < ((ULONG) TX_TRACE_OBJECT_REGISTRY_NAME); i++)
+                {
+                    entry_ptr -> tx_trace_object_entry_name[i] =  ((UCHAR) 0);
+                }
+                entry_ptr++;
+            }
+
+            /* Setup the registry counters.  */
+            _tx_trace_total_registry_entries =      registry_entries;
+            _tx_trace_available_registry_entries =  registry_entries;
+            _tx_trace_registry_search_start =       ((ULONG) 0);
+
+            /* The event entries use the remainder of the buffer, as many whole entries as fit.  */
+            event_entries =  (trace_buffer_size - (sizeof(TX_TRACE_HEADER)) - ((sizeof(TX_TRACE_OBJECT_ENTRY)) * registry_entries)) /
+                                (sizeof(TX_TRACE_BUFFER_ENTRY));
+            _tx_trace_buffer_start_ptr =  TX_UCHAR_TO_ENTRY_POINTER_CONVERT(work_ptr);
+            work_ptr =  TX_UCHAR_POINTER_ADD(work_ptr, ((sizeof(TX_TRACE_BUFFER_ENTRY)) * event_entries));
+            _tx_trace_buffer_end_ptr =  TX_UCHAR_TO_ENTRY_POINTER_CONVERT(work_ptr);
+
+            /* Mark all the event entries as empty.  */
+            event_ptr =  _tx_trace_buffer_start_ptr;
+            while (event_ptr < _tx_trace_buffer_end_ptr)
+            {
+
+                event_ptr -> tx_trace_buffer_entry_thread_pointer =  ((ULONG) 0);
+                event_ptr++;
+            }
+
+            /* Build the trace control header.  */
+            _tx_trace_header_ptr -> tx_trace_header_id =                      TX_TRACE_VALID;
+            _tx_trace_header_ptr -> tx_trace_header_timer_valid_mask =        TX_TRACE_TIME_MASK;
+            _tx_trace_header_ptr -> tx_trace_header_trace_base_address =      TX_POINTER_TO_ULONG_CONVERT(trace_buffer_start);
+            _tx_trace_header_ptr -> tx_trace_header_registry_start_pointer =  TX_POINTER_TO_ULONG_CONVERT(_tx_trace_registry_start_ptr);
+            _tx_trace_header_ptr -> tx_trace_header_reserved1 =               ((USHORT) 0);
+            _tx_trace_header_ptr -> tx_trace_header_object_name_size =        ((USHORT) TX_TRACE_OBJECT_REGISTRY_NAME);
+            _tx_trace_header_ptr -> tx_trace_header_registry_end_pointer =    TX_POINTER_TO_ULONG_CONVERT(_tx_trace_registry_end_ptr);
+            _tx_trace_header_ptr -> tx_trace_header_buffer_start_pointer =    TX_POINTER_TO_ULONG_CONVERT(_tx_trace_buffer_start_ptr);
+            _tx_trace_header_ptr -> tx_trace_header_buffer_end_pointer =      TX_POINTER_TO_ULONG_CONVERT(_tx_trace_buffer_end_ptr);
+            _tx_trace_header_ptr -> tx_trace_header_buffer_current_pointer =  TX_POINTER_TO_ULONG_CONVERT(_tx_trace_buffer_start_ptr);
+            _tx_trace_header_ptr -> tx_trace_header_reserved2 =               0xAAAAAAAAUL;
+            _tx_trace_header_ptr -> tx_trace_header_reserved3 =               0xBBBBBBBBUL;
+            _tx_trace_header_ptr -> tx_trace_header_reserved4 =               0xCCCCCCCCUL;
+
+            /* Register all the threads created so far.  */
+            thread_ptr =    _tx_thread_created_ptr;
+            object_count =  _tx_thread_created_count;
+            while (object_count != ((ULONG) 0))
+            {
+
+                TX_TRACE_OBJECT_REGISTER(TX_TRACE_OBJECT_TYPE_THREAD, thread_ptr, thread_ptr -> tx_thread_name,
+                                         TX_POINTER_TO_ULONG_CONVERT(thread_ptr -> tx_thread_stack_start), thread_ptr -> tx_thread_stack_size)
+                thread_ptr =  thread_ptr -> tx_thread_created_next;
+                object_count--;
+            }
+
+            /* Register all the timers.  */
+            timer_ptr =     _tx_timer_created_ptr;
+            object_count =  _tx_timer_created_count;
+            while (object_count != ((ULONG) 0))
+            {
+
+                TX_TRACE_OBJECT_REGISTER(TX_TRACE_OBJECT_TYPE_TIMER, timer_ptr, timer_ptr -> tx_timer_name,
+                                         timer_ptr -> tx_timer_internal.tx_timer_internal_remaining_ticks,
+                                         timer_ptr -> tx_timer_internal.tx_timer_internal_re_initialize_ticks)
+                timer_ptr =  timer_ptr -> tx_timer_created_next;
+                object_count--;
+            }
+
+            /* Register all the queues.  */
+            queue_ptr =     _tx_queue_created_ptr;
+            object_count =  _tx_queue_created_count;
+            while (object_count != ((ULONG) 0))
+            {
+
+                TX_TRACE_OBJECT_REGISTER(TX_TRACE_OBJECT_TYPE_QUEUE, queue_ptr, queue_ptr -> tx_queue_name,
+                                         queue_ptr -> tx_queue_capacity, queue_ptr -> tx_queue_message_size)
+                queue_ptr =  queue_ptr -> tx_queue_created_next;
+                object_count--;
+            }
+
+            /* Register all the semaphores.  */
+            semaphore_ptr =  _tx_semaphore_created_ptr;
+            object_count =   _tx_semaphore_created_count;
+            while (object_count != ((ULONG) 0))
+            {
+
+                TX_TRACE_OBJECT_REGISTER(TX_TRACE_OBJECT_TYPE_SEMAPHORE, semaphore_ptr, semaphore_ptr -> tx_semaphore_name,
+                                         semaphore_ptr -> tx_semaphore_count, 0)
+                semaphore_ptr =  semaphore_ptr -> tx_semaphore_created_next;
+                object_count--;
+            }
+
+            /* Register all the mutexes.  */
+            mutex_ptr =     _tx_mutex_created_ptr;
+            object_count =  _tx_mutex_created_count;
+            while (object_count != ((ULONG) 0))
+            {
+
+                TX_TRACE_OBJECT_REGISTER(TX_TRACE_OBJECT_TYPE_MUTEX, mutex_ptr, mutex_ptr -> tx_mutex_name,
+                                         mutex_ptr -> tx_mutex_inherit, 0)
+                mutex_ptr =  mutex_ptr -> tx_mutex_created_next;
+                object_count--;
+            }
+
+            /* Register all the event flags groups.  */
+            events_ptr =    _tx_event_flags_created_ptr;
+            object_count =  _tx_event_flags_created_count;
+            while (object_count != ((ULONG) 0))
+            {
+
+                TX_TRACE_OBJECT_REGISTER(TX_TRACE_OBJECT_TYPE_EVENT_FLAGS, events_ptr, events_ptr -> tx_event_flags_group_name, 0, 0)
+                events_ptr =  events_ptr -> tx_event_flags_group_created_next;
+                object_count--;
+            }
+
+            /* Register all the block pools.  */
+            block_pool_ptr =  _tx_block_pool_created_ptr;
+            object_count =    _tx_block_pool_created_count;
+            while (object_count != ((ULONG) 0))
+            {
+
+                TX_TRACE_OBJECT_REGISTER(TX_TRACE_OBJECT_TYPE_BLOCK_POOL, block_pool_ptr, block_pool_ptr -> tx_block_pool_name,
+                                         block_pool_ptr -> tx_block_pool_total, block_pool_ptr -> tx_block_pool_block_size)
+                block_pool_ptr =  block_pool_ptr -> tx_block_pool_created_next;
+                object_count--;
+            }
+
+            /* Register all the byte pools.  */
+            byte_pool_ptr =  _tx_byte_pool_created_ptr;
+            object_count =   _tx_byte_pool_created_count;
+            while (object_count != ((ULONG) 0))
+            {
+
+                TX_TRACE_OBJECT_REGISTER(TX_TRACE_OBJECT_TYPE_BYTE_POOL, byte_pool_ptr, byte_pool_ptr -> tx_byte_pool_name,
+                                         byte_pool_ptr -> tx_byte_pool_size, 0)
+                byte_pool_ptr =  byte_pool_ptr -> tx_byte_pool_created_next;
+                object_count--;
+            }
+
+            /* Finally, setup the current buffer pointer, which effectively enables the trace.  */
+            _tx_trace_buffer_current_ptr =  _tx_trace_buffer_start_ptr;
+
+            /* Return successful completion.  */
+            status =  TX_SUCCESS;
+        }
+
+        /* Restore interrupts.  */
+        TX_RESTORE
+    }
+
+    /* Return completion status.  */
+    return(status);
+
+#else
+
+    /* Access input arguments just for the sake of lint, MISRA, etc.  */
+    TX_PARAMETER_NOT_USED(trace_buffer_start);
+    TX_PARAMETER_NOT_USED(trace_buffer_size);
+    TX_PARAMETER_NOT_USED(registry_entries);
+
+    /* Trace not enabled, return an error.  */
+    return(TX_FEATURE_NOT_ENABLED);
+#endif
+}
@@ -0,0 +1,220 @@
+/**************************************************************************/
+/*                                                                        */
+/*       Copyright (c) Microsoft Corporation. All rights reserved.        */
+/*                                                                        */
+/*       This software is licensed under the Microsoft Software License   */
+/*       Terms for Microsoft Azure RTOS. Full text of the license can be  */
+/*       found in the LICENSE file at https://aka.ms/AzureRTOS_EULA       */
+/*       and in the root directory of this software.                      */
+/*                                                                        */
+/**************************************************************************/
+
+
+/**************************************************************************/
+/**************************************************************************/
+/**                                                                       */
+/** ThreadX Component                                                     */
+/**                                                                       */
+/**   Trace                                                               */
+/**                                                                       */
+/**************************************************************************/
+/**************************************************************************/
+
+#define TX_SOURCE_CODE
+
+
+/* Include necessary system files.  */
+
+#include "tx_api.h"
+#include "tx_trace.h"
+
+
+/**************************************************************************/
+/*                                                                        */
+/*  FUNCTION                                               RELEASE        */
+/*                                                                        */
+/*    _tx_trace_object_register                           PORTABLE C      */
+/*                                                           6.1          */
+/*  AUTHOR                                                                */
+/*                                                                        */
+/*    William E. Lamie, Microsoft Corporation                             */
+/*                                                                        */
+/*  DESCRIPTION                                                           */
+/*                                                                        */
+/*    This function registers a ThreadX system object in the trace        */
+/*    registry area. This provides analysis tools the ability to display  */
+/*    object names.                                                       */
+/*                                                                        */
+/*  INPUT                                                                 */
+/*                                                                        */
+/*    object_type                       Type of system object             */
+/*    object_ptr                        Address of system object          */
+/*    object_name                       Name of system object             */
+/*    parameter_1                       Supplemental parameter 1          */
+/*    parameter_2                       Supplemental parameter 2          */
+/*                                                                        */
+/*  OUTPUT                                                                */
+/*                                                                        */
+/*    None                                                                */
+/*                                                                        */
+/*  CALLS                                                                 */
+/*                                                                        */
+/*    None                                                                */
+/*                                                                        */
+/*  CALLED BY                                                             */
+/*                                                                        */
+/*    Application Code                                                    */
+/*                                                                        */
+/*  RELEASE HISTORY                                                       */
+/*                                                                        */
+/*    DATE              NAME                      DESCRIPTION             */
+/*                                                                        */
+/*  05-19-2020     William E. Lamie         Initial Version 6.0           */
+/*  09-30-2020     Yuxin Zhou               Modified comment(s),          */
+/*                                            resulting in version 6.1    */
+/*  10-19-2026                              Added to the METEO firmware   */
+/*                                            tree                        */
+/*                                                                        */
+/**************************************************************************/
+VOID  _tx_trace_object_register(UCHAR object_type, VOID *object_ptr, CHAR *object_name, ULONG parameter_1, ULONG parameter_2)
+{
+
+#ifdef TX_ENABLE_EVENT_TRACE
+
+UINT                            i;
+ULONG                           entries;
+ULONG                           index;
+ULONG                           found;
+UINT                            loop_break;
+TX_THREAD                       *thread_ptr;
+UCHAR                           *work_ptr;
+TX_TRACE_OBJECT_ENTRY           *entry_ptr;
+
+
+    /* Determine if the registry area is setup.  */
+    if (_tx_trace_registry_start_ptr != TX_NULL)
+    {
+
+        /* Trace buffer is enabled, proceed.  */
+
+        /* Pickup the total entries.  */
+        entries =  _tx_trace_total_registry_entries;
+
+        /* Initialize found to the max entries... indicating no space was found.  */
+        found =  entries;
+        loop_break =  TX_FALSE;
+
+        /* Loop to find an entry for this object, remembering the first available
+           entry on the way.  An object created again at the same address keeps its
+           entry.  */
+        index =  _tx_trace_registry_search_start;
+        do
+        {
+
+            /* Setup the registry entry pointer.  */
+            entry_ptr =  &(_tx_trace_registry_start_ptr[index]);
+
+            /* Determine if this entry is available.  */
+            if (entry_ptr -> tx_trace_object_entry_available == ((UCHAR) TX_TRUE))
+            {
+
+                /* Remember the first available entry.  */
+                if (found == entries)
+                {
+                    found =  index;
+                }
+            }
+            else if (entry_ptr -> tx_trace_object_entry_thread_pointer == TX_POINTER_TO_ULONG_CONVERT(object_ptr))
+            {
+
+                /* This object is already registered, use its entry.  */
+                found =  index;
+                loop_break =  TX_TRUE;
+            }
+            else
+            {
+
+                /* Entry in use by another object, keep looking.  */
+            }
+
+            /* Move to the next entry, wrapping at the end of the registry.  */
+            index++;
+            if (index >= entries)
+            {
+                index =  ((ULONG) 0);
+            }
+        } while ((loop_break == TX_FALSE) && (index != _tx_trace_registry_search_start));
+
+        /* Determine if an entry was found.  */
+        if (found < entries)
+        {
+
+            /* Setup the registry entry pointer.  */
+            entry_ptr =  &(_tx_trace_registry_start_ptr[found]);
+
+            /* Determine if a new entry is used.  */
+            if (entry_ptr -> tx_trace_object_entry_available == ((UCHAR) TX_TRUE))
+            {
+
+                /* Decrement the number of available entries.  */
+                _tx_trace_available_registry_entries--;
+
+                /* Start the next search after this entry.  */
+                _tx_trace_registry_search_start =  found + ((ULONG) 1);
+                if (_tx_trace_registry_search_start >= entries)
+                {
+                    _tx_trace_registry_search_start =  ((ULONG) 0);
+                }
+            }
+
+            /* Fill in the entry.  */
+            entry_ptr -> tx_trace_object_entry_available =       (UCHAR) TX_FALSE;
+            entry_ptr -> tx_trace_object_entry_type =            object_type;
+            entry_ptr -> tx_trace_object_entry_thread_pointer =  TX_POINTER_TO_ULONG_CONVERT(object_ptr);
+            entry_ptr -> tx_trace_object_entry_param_1 =         parameter_1;
+            entry_ptr -> tx_trace_object_entry_param_2 =         parameter_2;
+
+            /* Threads also record their priority.  */
+            if (object_type == TX_TRACE_OBJECT_TYPE_THREAD)
+            {
+
+                thread_ptr =  TX_VOID_TO_THREAD_POINTER_CONVERT(object_ptr);
+                entry_ptr -> tx_trace_object_entry_reserved1 =  ((UCHAR) 0x80) | ((UCHAR) (thread_ptr -> tx_thread_priority >> 8));
+                entry_ptr -> tx_trace_object_entry_reserved2 =  (UCHAR) (thread_ptr -> tx_thread_priority & ((UINT) 0xFF));
+            }
+            else
+            {
+
+                entry_ptr -> tx_trace_object_entry_reserved1 =  ((UCHAR) 0);
+                entry_ptr -> tx_trace_object_entry_reserved2 =  ((UCHAR) 0);
+            }
+
+            /* Copy the object name, the registry name is always NULL terminated.  */
+            i =  ((UINT) 0);
+            if (object_name != TX_NULL)
+            {
+
+                work_ptr =  TX_CHAR_TO_UCHAR_POINTER_CONVERT(object_name);
+                while ((i < (((UINT) TX_TRACE_OBJECT_REGISTRY_NAME) - ((UINT) 1))) && (work_ptr[i] != ((UCHAR) 0)))
+                {
+                    entry_ptr -> tx_trace_object_entry_name[i] =  work_ptr[i];
+                    i++;
+                }
+            }
+            while (i < ((UINT) TX_TRACE_OBJECT_REGISTRY_NAME))
+            {
+                entry_ptr -> tx_trace_object_entry_name[i] =  ((UCHAR) 0);
+                i++;
+            }
+        }
+    }
+#else
+
+    /* Access input arguments just for the sake of lint, MISRA, etc.  */
+    TX_PARAMETER_NOT_USED(object_type);
+    TX_PARAMETER_NOT_USED(object_ptr);
+    TX_PARAMETER_NOT_USED(object_name);
+    TX_PARAMETER_NOT_USED(parameter_1);
+    TX_PARAMETER_NOT_USED(parameter_2);
+#endif
+}
@@ -0,0 +1,125 @@
+/**************************************************************************/
+/*                                                                        */
+/*       Copyright (c) Microsoft Corporation. All rights reserved.        */
+/*                                                                        */
+/*       This software is licensed under the Microsoft Software License   */
+/*       Terms for Microsoft Azure RTOS. Full text of the license can be  */
+/*       found in the LICENSE file at https://aka.ms/AzureRTOS_EULA       */
+/*       and in the root directory of this software.                      */
+/*                                                                        */
+/**************************************************************************/
+
+
+/**************************************************************************/
+/**************************************************************************/
+/**                                                                       */
+/** ThreadX Component                                                     */
+/**                                                                       */
+/**   Trace                                                               */
+/**                                                                       */
+/**************************************************************************/
+/**************************************************************************/
+
+#define TX_SOURCE_CODE
+
+
+/* Include necessary system files.  */
+
+#include "tx_api.h"
+#include "tx_trace.h"
+
+
+/**************************************************************************/
+/*                                                                        */
+/*  FUNCTION                                               RELEASE        */
+/*                                                                        */
+/*    _tx_trace_object_unregister                         PORTABLE C      */
+/*                                                           6.1          */
+/*  AUTHOR                                                                */
+/*                                                                        */
+/*    William E. Lamie, Microsoft Corporation                             */
+/*                                                                        */
+/*  DESCRIPTION                                                           */
+/*                                                                        */
+/*    This function unregisters a ThreadX system object from the trace    */
+/*    registry area. The entry keeps its name until it is reused, so      */
+/*    events already in the buffer can still be attributed.               */
+/*                                                                        */
+/*  INPUT                                                                 */
+/*                                                                        */
+/*    object_ptr                        Address of system object          */
+/*                                                                        */
+/*  OUTPUT                                                                */
+/*                                                                        */
+/*    None                                                                */
+/*                                                                        */
+/*  CALLS                                                                 */
+/*                                                                        */
+/*    None                                                                */
+/*                                                                        */
+/*  CALLED BY                                                             */
+/*                                                                        */
+/*    Application Code                                                    */
+/*                                                                        */
+/*  RELEASE HISTORY                                                       */
+/*                                                                        */
+/*    DATE              NAME                      DESCRIPTION             */
+/*                                                                        */
+/*  05-19-2020     William E. Lamie         Initial Version 6.0           */
+/*  09-30-2020     Yuxin Zhou               Modified comment(s),          */
+/*                                            resulting in version 6.1    */
+/*  10-19-2026                              Added to the METEO firmware   */
+/*                                            tree                        */
+/*                                                                        */
+/**************************************************************************/
+VOID  _tx_trace_object_unregister(VOID *object_ptr)
+{
+
+#ifdef TX_ENABLE_EVENT_TRACE
+
+ULONG                           i;
+ULONG                           entries;
+TX_TRACE_OBJECT_ENTRY           *entry_ptr;
+
+
+    /* Determine if the registry area is setup.  */
+    if (_tx_trace_registry_start_ptr != TX_NULL)
+    {
+
+        /* Registry is setup, proceed.  */
+
+        /* Pickup the total entries.  */
+        entries =  _tx_trace_total_registry_entries;
+
+        /* Loop to find the object's entry.  */
+        for (i = ((ULONG) 0); i < entries; i++)
+        {
+
+            /* Setup the registry entry pointer.  */
+            entry_ptr =  &(_tx_trace_registry_start_ptr[i]);
+
+            /* Determine if this is the object's entry.  */
+            if ((entry_ptr -> tx_trace_object_entry_available == ((UCHAR) TX_FALSE)) &&
+                (entry_ptr -> tx_trace_object_entry_thread_pointer == TX_POINTER_TO_ULONG_CONVERT(object_ptr)))
+            {
+
+                /* Mark the entry available again.  */
+                entry_ptr -> tx_trace_object_entry_available =  (UCHAR) TX_TRUE;
+
+                /* Increment the number of available registry entries.  */
+                _tx_trace_available_registry_entries++;
+
+                /* Start the next search at this entry.  */
+                _tx_trace_registry_search_start =  i;
+
+                /* Get out of the loop.  */
+                break;
+            }
+        }
+    }
+#else
+
+    /* Access input arguments just for the sake of lint, MISRA, etc.  */
+    TX_PARAMETER_NOT_USED(object_ptr);
+#endif
+}
@@ -0,0 +1,362 @@
+/**************************************************************************/
+/*                                                                        */
+/*       Copyright (c) Microsoft Corporation. All rights reserved.        */
+/*                                                                        */
+/*       This software is licensed under the Microsoft Software License   */
+/*       Terms for Microsoft Azure RTOS. Full text of the license can be  */
+/*       found in the LICENSE file at https://aka.ms/AzureRTOS_EULA       */
+/*       and in the root directory of this software.                      */
+/*                                                                        */
+/**************************************************************************/
+
+
+/**************************************************************************/
+/**************************************************************************/
+/**                                                                       */
+/** ThreadX Component                                                     */
+/**                                                                       */
+/**   Port Specific                                                       */
+/**                                                                       */
+/**************************************************************************/
+/**************************************************************************/
+
+
+/**************************************************************************/
+/*                                                                        */
+/*  PORT SPECIFIC C INFORMATION                            RELEASE        */
+/*                                                                        */
+/*    tx_port.h                                           Linux/GNU       */
+/*                                                           6.4.0        */
+/*                                                                        */
+/*  DESCRIPTION                                                           */
+/*                                                                        */
+/*    This file contains data type definitions that make the ThreadX      */
+/*    real-time kernel function identically on a variety of different     */
+/*    processor architectures.  For example, the size or number of bits   */
+/*    in an "int" data type vary between microprocessor architectures and */
+/*    even C compilers for the same microprocessor.  ThreadX does not     */
+/*    directly use native C data types.  Instead, ThreadX creates its     */
+/*    own special types that can be mapped to actual data types by this   */
+/*    file to guarantee consistency in the interface and functionality.   */
+/*                                                                        */
+/*    This port runs the firmware thread graph as an ordinary Linux       */
+/*    process.  Every ThreadX thread is backed by a pthread, but only the */
+/*    thread selected by the scheduler is ever allowed to run: all others */
+/*    are parked on a per-thread semaphore.  "Interrupt lockout" is a     */
+/*    single process-wide mutex, and interrupts are emulated by host      */
+/*    pthreads (the timer tick and the peripheral shims) that bracket     */
+/*    their handler with _tx_thread_context_save and                      */
+/*    _tx_thread_context_restore.                                         */
+/*                                                                        */
+/*    Preemption requested by an emulated interrupt takes effect the next */
+/*    time the running thread re-enables interrupts, i.e. at its next     */
+/*    kernel service call.  A thread spinning without calling ThreadX is  */
+/*    therefore not preempted; this is acceptable for the firmware, whose */
+/*    threads block on queues, semaphores or tx_thread_sleep.             */
+/*                                                                        */
+/*    ULONG is kept at 32 bits so that message sizes, queue word counts   */
+/*    and record layouts match the Cortex-M33 target; TX_64_BIT is set on */
+/*    LP64 hosts so that pointers never travel through a ULONG.           */
+/*                                                                        */
+/*  RELEASE HISTORY                                                       */
+/*                                                                        */
+/*    DATE              NAME                      DESCRIPTION             */
+/*                                                                        */
+/*  10-19-2026                                  Initial host version for  */
+/*                                                the METEO firmware      */
+/*                                                                        */
+/**************************************************************************/
+
+#ifndef TX_PORT_H
+#define TX_PORT_H
+
+/* Determine if the optional ThreadX user define file should be used.  */
+#ifdef TX_INCLUDE_USER_DEFINE_FILE
+
+/* Yes, include the user defines in tx_user.h. The defines in this file may
+   alternately be defined on the command line.  */
+
+#include "tx_user.h"
+#endif /* TX_INCLUDE_USER_DEFINE_FILE */
+
+/* Define compiler library include files.  */
+
+#include <stdlib.h>
+#include <string.h>
+#include <pthread.h>
+#include <semaphore.h>
+
+
+/* Define ThreadX basic types for this port.  */
+
+#define VOID                                    void
+typedef char                                    CHAR;
+typedef unsigned char                           UCHAR;
+typedef int                                     INT;
+typedef unsigned int                            UINT;
+typedef int                                     LONG;
+typedef unsigned int                            ULONG;
+typedef unsigned long long                      ULONG64;
+typedef short                                   SHORT;
+typedef unsigned short                          USHORT;
+#define ULONG64_DEFINED
+
+#if defined(__LP64__) || defined(_LP64)
+
+/* Pointers do not fit in a ULONG, use the 64-bit extension pointers and
+   a pointer sized alignment type for the pools.  */
+#define TX_64_BIT
+#define ALIGN_TYPE_DEFINED
+#define ALIGN_TYPE                              ULONG64
+#endif
+
+
+/* Define the priority levels for ThreadX.  Legal values range
+   from 32 to 1024 and MUST be evenly divisible by 32.  */
+
+#ifndef TX_MAX_PRIORITIES
+#define TX_MAX_PRIORITIES                       32
+#endif
+
+
+/* Define the minimum stack for a ThreadX thread on this processor. If the size supplied during
+   thread creation is less than this value, the thread create call will return an error. The
+   ThreadX stack area is not used by the backing pthread, which runs on its own host stack.  */
+
+#ifndef TX_MINIMUM_STACK
+#define TX_MINIMUM_STACK                        200         /* Minimum stack size for this port  */
+#endif
+
+
+/* Define the system timer thread's default stack size and priority.  These are only applicable
+   if TX_TIMER_PROCESS_IN_ISR is not defined.  */
+
+#ifndef TX_TIMER_THREAD_STACK_SIZE
+#define TX_TIMER_THREAD_STACK_SIZE              1024        /* Default timer thread stack size  */
+#endif
+
+#ifndef TX_TIMER_THREAD_PRIORITY
+#define TX_TIMER_THREAD_PRIORITY                0           /* Default timer thread priority    */
+#endif
+
+
+/* Define the size of the host stack given to the pthread behind each ThreadX thread. The firmware
+   stacks are sized for the Cortex-M33 and are far too small for glibc's stdio.  */
+
+#ifndef TX_LINUX_THREAD_STACK_SIZE
+#define TX_LINUX_THREAD_STACK_SIZE              (256 * 1024)
+#endif
+
+
+/* Define the environment variable that scales the tick rate. A value of 100 runs the tick
+   100 times faster than real time; the default is real time.  */
+
+#define TX_LINUX_SPEEDUP_ENV                    "TX_LINUX_SPEEDUP"
+
+
+/* Define various constants for the ThreadX Linux port.  */
+
+#define TX_INT_DISABLE                          1           /* Disable interrupts               */
+#define TX_INT_ENABLE                           0           /* Enable interrupts                */
+
+
+/* Define the clock source for trace event entry time stamp. The following two item are port specific.
+   For example, if the time source is at the address 0x0a800024 and is 16-bits in size, the clock
+   source constants would be:
+
+#define TX_TRACE_TIME_SOURCE                    *((volatile ULONG *) 0x0a800024)
+#define TX_TRACE_TIME_MASK                      0x0000FFFFUL
+
+*/
+
+ULONG   _tx_linux_time_stamp_get(VOID);
+
+#ifndef TX_TRACE_TIME_SOURCE
+#define TX_TRACE_TIME_SOURCE                    _tx_linux_time_stamp_get()
+#endif
+#ifndef TX_TRACE_TIME_MASK
+#define TX_TRACE_TIME_MASK                      0xFFFFFFFFUL
+#endif
+
+
+/* Define the time source and interrupt source ID of the execution profile kit. Time is
+   CLOCK_MONOTONIC in nanoseconds; the 32-bit value wraps every 4.3 s, far longer than a tick.
+   Each emulated interrupt source sets _tx_linux_isr_id in its own pthread, using the Cortex-M
+   exception number of the peripheral it stands for (15 for the SysTick timer).  */
+
+#define TX_LINUX_ISR_ID_SYSTICK                 15
+
+extern __thread ULONG                   _tx_linux_isr_id;
+
+#if (defined(TX_ENABLE_EXECUTION_CHANGE_NOTIFY) || defined(TX_EXECUTION_PROFILE_ENABLE))
+VOID    _tx_execution_thread_enter(VOID);
+VOID    _tx_execution_thread_exit(VOID);
+VOID    _tx_execution_isr_enter(VOID);
+VOID    _tx_execution_isr_exit(VOID);
+#endif
+
+#ifdef TX_EXECUTION_PROFILE_ENABLE
+ULONG   _tx_linux_execution_time_get(VOID);
+
+#define TX_EXECUTION_TIME_SOURCE                ((EXECUTION_TIME_SOURCE_TYPE) _tx_linux_execution_time_get())
+#define TX_EXECUTION_TIME_SOURCE_ENABLE()
+#define TX_EXECUTION_ISR_ID()                   _tx_linux_isr_id
+#endif
+
+
+/* Define the port specific options for the _tx_build_options variable. This variable indicates
+   how the ThreadX library was built.  */
+
+#define TX_PORT_SPECIFIC_BUILD_OPTIONS          (0)
+
+
+/* Define the in-line initialization constant so that modules with in-line
+   initialization capabilities can prevent their initialization from being
+   a function call.  */
+
+#define TX_INLINE_INITIALIZATION
+
+
+/* Determine whether or not stack checking is enabled. By default, ThreadX stack checking is
+   disabled. When the following is defined, ThreadX thread stack checking is enabled.  If stack
+   checking is enabled (TX_ENABLE_STACK_CHECKING is defined), the TX_DISABLE_STACK_FILLING
+   define is negated, thereby forcing the stack fill which is necessary for the stack checking
+   logic.  */
+
+#ifdef TX_ENABLE_STACK_CHECKING
+#undef TX_DISABLE_STACK_FILLING
+#endif
+
+
+/* Define the TX_THREAD control block extensions for this port. The pthread backing the
+   thread, the semaphore it is parked on while not scheduled, its real entry function, and
+   the flag used to make it exit once the thread is deleted or reset.  */
+
+#define TX_THREAD_EXTENSION_0
+#define TX_THREAD_EXTENSION_1
+#ifdef TX_64_BIT
+#define TX_THREAD_EXTENSION_2                   VOID    *tx_thread_extension_ptr;
+#else
+#define TX_THREAD_EXTENSION_2
+#endif
+#define TX_THREAD_EXTENSION_3                   pthread_t tx_thread_linux_thread_id;                \
+                                                sem_t     tx_thread_linux_thread_run_semaphore;     \
+                                                VOID      (*tx_thread_linux_entry)(VOID);           \
+                                                UINT      tx_thread_linux_exit_request;
+
+
+/* Define the port extensions of the remaining ThreadX objects.  */
+
+#define TX_BLOCK_POOL_EXTENSION
+#define TX_BYTE_POOL_EXTENSION
+#define TX_EVENT_FLAGS_GROUP_EXTENSION
+#define TX_MUTEX_EXTENSION
+#define TX_QUEUE_EXTENSION
+#define TX_SEMAPHORE_EXTENSION
+#define TX_TIMER_EXTENSION
+
+#ifdef TX_64_BIT
+#define TX_TIMER_INTERNAL_EXTENSION             VOID    *tx_timer_internal_extension_ptr;
+
+/* The thread timeout parameter is a ULONG, which cannot carry the thread pointer on a
+   64-bit host. Pass the pointer through the timer extension instead.  */
+
+#define TX_THREAD_CREATE_TIMEOUT_SETUP(t)       (t) -> tx_thread_timer.tx_timer_internal_timeout_function =  &(_tx_thread_timeout);    \
+                                                (t) -> tx_thread_timer.tx_timer_internal_timeout_param =     ((ULONG) 0);               \
+                                                (t) -> tx_thread_timer.tx_timer_internal_extension_ptr =     (VOID *) (t);
+#define TX_THREAD_TIMEOUT_POINTER_SETUP(t)      (t) =  (TX_THREAD *) _tx_timer_expired_timer_ptr -> tx_timer_internal_extension_ptr;
+#endif
+
+
+/* Define the user extension field of the thread control block.  Nothing
+   additional is needed for this port so it is defined as white space.  */
+
+#ifndef TX_THREAD_USER_EXTENSION
+#define TX_THREAD_USER_EXTENSION
+#endif
+
+
+/* Define the macros for processing extensions in tx_thread_create, tx_thread_delete,
+   tx_thread_shell_entry, and tx_thread_terminate.  */
+
+#define TX_THREAD_CREATE_EXTENSION(thread_ptr)
+#define TX_THREAD_DELETE_EXTENSION(thread_ptr)
+#define TX_THREAD_COMPLETED_EXTENSION(thread_ptr)
+#define TX_THREAD_TERMINATED_EXTENSION(thread_ptr)
+
+
+/* Define the ThreadX object creation extensions for the remaining objects.  */
+
+#define TX_BLOCK_POOL_CREATE_EXTENSION(pool_ptr)
+#define TX_BYTE_POOL_CREATE_EXTENSION(pool_ptr)
+#define TX_EVENT_FLAGS_GROUP_CREATE_EXTENSION(group_ptr)
+#define TX_MUTEX_CREATE_EXTENSION(mutex_ptr)
+#define TX_QUEUE_CREATE_EXTENSION(queue_ptr)
+#define TX_SEMAPHORE_CREATE_EXTENSION(semaphore_ptr)
+#define TX_TIMER_CREATE_EXTENSION(timer_ptr)
+
+
+/* Define the ThreadX object deletion extensions for the remaining objects.  */
+
+#define TX_BLOCK_POOL_DELETE_EXTENSION(pool_ptr)
+#define TX_BYTE_POOL_DELETE_EXTENSION(pool_ptr)
+#define TX_EVENT_FLAGS_GROUP_DELETE_EXTENSION(group_ptr)
+#define TX_MUTEX_DELETE_EXTENSION(mutex_ptr)
+#define TX_QUEUE_DELETE_EXTENSION(queue_ptr)
+#define TX_SEMAPHORE_DELETE_EXTENSION(semaphore_ptr)
+#define TX_TIMER_DELETE_EXTENSION(timer_ptr)
+
+
+/* Define the port completion processing for thread delete and reset. The pthread behind a
+   completed or terminated thread is parked on its run semaphore; wake it with the exit
+   request set and wait for it to go away before the control block is reused.  */
+
+struct TX_THREAD_STRUCT;
+VOID    _tx_linux_thread_exit(struct TX_THREAD_STRUCT *thread_ptr);
+VOID    _tx_linux_thread_switch(struct TX_THREAD_STRUCT *thread_ptr);
+VOID    _tx_linux_thread_dispatch(VOID);
+VOID    _tx_linux_thread_wait(struct TX_THREAD_STRUCT *thread_ptr);
+
+#define TX_THREAD_DELETE_PORT_COMPLETION(thread_ptr)    _tx_linux_thread_exit(thread_ptr);
+#define TX_THREAD_RESET_PORT_COMPLETION(thread_ptr)     _tx_linux_thread_exit(thread_ptr);
+
+
+/* Define the get system state macro. The interrupt nesting of an emulated ISR is private to
+   the host pthread running it, so threads running concurrently with the ISR still see a
+   thread context, exactly as a Cortex-M thread interrupted by the ISR would.  */
+
+extern __thread ULONG                   _tx_linux_isr_nesting;
+
+#ifndef TX_THREAD_GET_SYSTEM_STATE
+#define TX_THREAD_GET_SYSTEM_STATE()            (_tx_thread_system_state | _tx_linux_isr_nesting)
+#endif
+
+
+/* Define the interrupt disable/restore macros. Interrupt lockout is the port mutex; the
+   posture is whether the calling pthread already holds it, so nesting behaves like PRIMASK.  */
+
+UINT                                            _tx_thread_interrupt_disable(VOID);
+VOID                                            _tx_thread_interrupt_restore(UINT previous_posture);
+
+#define TX_INTERRUPT_SAVE_AREA                  UINT interrupt_save;
+#define TX_DISABLE                              interrupt_save = _tx_thread_interrupt_disable();
+#define TX_RESTORE                              _tx_thread_interrupt_restore(interrupt_save);
+
+
+/* Define the interrupt emulation entry points used by the host peripheral shims.  */
+
+VOID    _tx_thread_context_save(VOID);
+VOID    _tx_thread_context_restore(VOID);
+VOID    _tx_timer_interrupt(VOID);
+
+
+/* Define the version ID of ThreadX.  This may be utilized by the application.  */
+
+#ifdef TX_THREAD_INIT
+CHAR                            _tx_version_id[] =
+                                    "Copyright (c) Microsoft Corporation. All rights reserved. * ThreadX Linux/GNU Version 6.4.0 *";
+#else
+extern  CHAR                    _tx_version_id[];
+#endif
+
+#endif
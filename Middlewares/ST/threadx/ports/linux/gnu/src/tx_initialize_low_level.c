@@ -0,0 +1,216 @@
+/**************************************************************************/
+/*                                                                        */
+/*       Copyright (c) Microsoft Corporation. All rights reserved.        */
+/*                                                                        */
+/*       This software is licensed under the Microsoft Software License   */
+/*       Terms for Microsoft Azure RTOS. Full text of the license can be  */
+/*       found in the LICENSE file at https://aka.ms/AzureRTOS_EULA       */
+/*       and in the root directory of this software.                      */
+/*                                                                        */
+/**************************************************************************/
+
+
+/**************************************************************************/
+/**************************************************************************/
+/**                                                                       */
+/** ThreadX Component                                                     */
+/**                                                                       */
+/**   Initialize                                                          */
+/**                                                                       */
+/**************************************************************************/
+/**************************************************************************/
+
+#define TX_SOURCE_CODE
+
+
+/* Include necessary system files.  */
+
+#include "tx_api.h"
+#include "tx_initialize.h"
+#include "tx_thread.h"
+#include "tx_timer.h"
+#include <stdio.h>
+#include <errno.h>
+#include <time.h>
+
+
+/* Define the size of the area handed to tx_application_define as the first
+   unused memory.  */
+
+#ifndef TX_LINUX_MEMORY_SIZE
+#define TX_LINUX_MEMORY_SIZE                    (256 * 1024)
+#endif
+
+
+/* Define the port state shared by the scheduler, the thread wrappers and the
+   interrupt emulation.  */
+
+pthread_mutex_t         _tx_linux_mutex =  PTHREAD_MUTEX_INITIALIZER;
+pthread_cond_t          _tx_linux_scheduler_cond =  PTHREAD_COND_INITIALIZER;
+UINT                    _tx_linux_scheduler_started;
+ULONG                   _tx_linux_speedup =  1;
+
+__thread TX_THREAD      *_tx_linux_thread_self;
+__thread UINT           _tx_linux_interrupt_posture;
+__thread ULONG          _tx_linux_isr_nesting;
+__thread ULONG          _tx_linux_isr_id;
+
+static ALIGN_TYPE       _tx_linux_memory_area[TX_LINUX_MEMORY_SIZE / sizeof(ALIGN_TYPE)];
+static pthread_t        _tx_linux_timer_id;
+
+
+static VOID *_tx_linux_timer_entry(VOID *ptr);
+
+
+/**************************************************************************/
+/*                                                                        */
+/*  FUNCTION                                               RELEASE        */
+/*                                                                        */
+/*    _tx_initialize_low_level                            Linux/GNU       */
+/*                                                           6.4.0        */
+/*                                                                        */
+/*  DESCRIPTION                                                           */
+/*                                                                        */
+/*    This function is responsible for any low-level processor            */
+/*    initialization, including setting up interrupt vectors, setting     */
+/*    up a periodic timer interrupt source, saving the system stack       */
+/*    pointer for use in ISR processing later, and finding the first      */
+/*    available RAM memory address for tx_application_define.             */
+/*                                                                        */
+/*    On the host the periodic interrupt is a pthread that ticks at       */
+/*    TX_TIMER_TICKS_PER_SECOND multiplied by the TX_LINUX_SPEEDUP        */
+/*    environment variable, so that a 1 Hz sensor stream can be replayed  */
+/*    at 100-1000x real time.                                             */
+/*                                                                        */
+/*  INPUT                                                                 */
+/*                                                                        */
+/*    None                                                                */
+/*                                                                        */
+/*  OUTPUT                                                                */
+/*                                                                        */
+/*    None                                                                */
+/*                                                                        */
+/*  CALLS                                                                 */
+/*                                                                        */
+/*    pthread_create                        Create the tick source        */
+/*                                                                        */
+/*  CALLED BY                                                             */
+/*                                                                        */
+/*    _tx_initialize_kernel_enter           ThreadX entry function        */
+/*                                                                        */
+/**************************************************************************/
+VOID   _tx_initialize_low_level(VOID)
+{
+
+const char  *speedup;
+long        value;
+
+
+    /* Pickup the tick speedup factor.  */
+    speedup =  getenv(TX_LINUX_SPEEDUP_ENV);
+    if (speedup != TX_NULL)
+    {
+
+        value =  strtol(speedup, TX_NULL, 10);
+        if ((value >= 1) && (value <= 100000))
+        {
+            _tx_linux_speedup =  (ULONG) value;
+        }
+        else
+        {
+            fprintf(stderr, "ThreadX: ignoring %s=%s\n", TX_LINUX_SPEEDUP_ENV, speedup);
+        }
+    }
+
+    /* Save the first available memory address.  */
+    _tx_initialize_unused_memory =  (VOID *) _tx_linux_memory_area;
+
+    /* Create the periodic timer interrupt source. It does not tick until the
+       scheduler has been entered.  */
+    if (pthread_create(&_tx_linux_timer_id, TX_NULL, _tx_linux_timer_entry, TX_NULL) != 0)
+    {
+
+        fprintf(stderr, "ThreadX: unable to create the timer interrupt thread\n");
+        abort();
+    }
+}
+
+
+/* Emulated SysTick. Runs the timer ISR at a fixed absolute period so that the
+   tick rate does not drift with the time spent in the handler.  */
+
+static VOID *_tx_linux_timer_entry(VOID *ptr)
+{
+
+struct timespec next;
+long            period_ns;
+
+
+    TX_PARAMETER_NOT_USED(ptr);
+
+    /* Wait for the scheduler to start.  */
+    pthread_mutex_lock(&_tx_linux_mutex);
+    while (_tx_linux_scheduler_started == TX_FALSE)
+    {
+        pthread_cond_wait(&_tx_linux_scheduler_cond, &_tx_linux_mutex);
+    }
+    pthread_mutex_unlock(&_tx_linux_mutex);
+
+    period_ns =  1000000000L / ((long) TX_TIMER_TICKS_PER_SECOND * (long) _tx_linux_speedup);
+    if (period_ns < 1000L)
+    {
+        period_ns =  1000L;
+    }
+
+    _tx_linux_isr_id =  TX_LINUX_ISR_ID_SYSTICK;
+
+    clock_gettime(CLOCK_MONOTONIC, &next);
+    while (1)
+    {
+
+        next.tv_nsec +=  period_ns;
+        while (next.tv_nsec >= 1000000000L)
+        {
+            next.tv_nsec -=  1000000000L;
+            next.tv_sec++;
+        }
+        while (clock_nanosleep(CLOCK_MONOTONIC, TIMER_ABSTIME, &next, TX_NULL) == EINTR)
+        {
+        }
+
+        _tx_thread_context_save();
+        _tx_timer_interrupt();
+        _tx_thread_context_restore();
+    }
+
+    return(TX_NULL);
+}
+
+
+/* Time source for trace time stamps, in microseconds.  */
+
+ULONG  _tx_linux_time_stamp_get(VOID)
+{
+
+struct timespec now;
+
+
+    clock_gettime(CLOCK_MONOTONIC, &now);
+    return((ULONG) ((now.tv_sec * 1000000L) + (now.tv_nsec / 1000L)));
+}
+
+
+#ifdef TX_EXECUTION_PROFILE_ENABLE
+
+/* Time source for the execution profile kit, in nanoseconds.  */
+
+ULONG  _tx_linux_execution_time_get(VOID)
+{
+
+struct timespec now;
+
+
+    clock_gettime(CLOCK_MONOTONIC, &now);
+    return((ULONG) (((ULONG64) now.tv_sec * 1000000000ULL) + (ULONG64) now.tv_nsec));
+}
+#endif
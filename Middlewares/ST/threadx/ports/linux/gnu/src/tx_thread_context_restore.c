@@ -0,0 +1,99 @@
+/**************************************************************************/
+/*                                                                        */
+/*       Copyright (c) Microsoft Corporation. All rights reserved.        */
+/*                                                                        */
+/*       This software is licensed under the Microsoft Software License   */
+/*       Terms for Microsoft Azure RTOS. Full text of the license can be  */
+/*       found in the LICENSE file at https://aka.ms/AzureRTOS_EULA       */
+/*       and in the root directory of this software.                      */
+/*                                                                        */
+/**************************************************************************/
+
+
+/**************************************************************************/
+/**************************************************************************/
+/**                                                                       */
+/** ThreadX Component                                                     */
+/**                                                                       */
+/**   Thread                                                              */
+/**                                                                       */
+/**************************************************************************/
+/**************************************************************************/
+
+#define TX_SOURCE_CODE
+
+
+/* Include necessary system files.  */
+
+#include "tx_api.h"
+#include "tx_thread.h"
+
+
+extern pthread_mutex_t          _tx_linux_mutex;
+extern __thread UINT            _tx_linux_interrupt_posture;
+
+
+/**************************************************************************/
+/*                                                                        */
+/*  FUNCTION                                               RELEASE        */
+/*                                                                        */
+/*    _tx_thread_context_restore                          Linux/GNU       */
+/*                                                           6.4.0        */
+/*                                                                        */
+/*  DESCRIPTION                                                           */
+/*                                                                        */
+/*    This function restores the interrupt context if it is processing a  */
+/*    nested interrupt.  If not, it returns to the interrupt thread if no */
+/*    preemption is necessary.  Otherwise, if preemption is necessary or  */
+/*    if no thread was running, the function returns to the scheduler.    */
+/*                                                                        */
+/*    If the system was idle the thread made ready by the handler is      */
+/*    dispatched here; a running thread picks up the preemption the next  */
+/*    time it enables interrupts.                                         */
+/*                                                                        */
+/*  INPUT                                                                 */
+/*                                                                        */
+/*    None                                                                */
+/*                                                                        */
+/*  OUTPUT                                                                */
+/*                                                                        */
+/*    None                                                                */
+/*                                                                        */
+/*  CALLS                                                                 */
+/*                                                                        */
+/*    _tx_linux_thread_dispatch             Resume the next thread        */
+/*    pthread_mutex_unlock                  Release other contexts        */
+/*                                                                        */
+/*  CALLED BY                                                             */
+/*                                                                        */
+/*    Emulated interrupt sources                                          */
+/*                                                                        */
+/**************************************************************************/
+VOID   _tx_thread_context_restore(VOID)
+{
+
+#ifdef TX_ENABLE_EVENT_TRACE
+
+    /* Insert the ISR exit event.  */
+    _tx_trace_isr_exit_insert(_tx_linux_isr_id);
+#endif
+
+#if (defined(TX_ENABLE_EXECUTION_CHANGE_NOTIFY) || defined(TX_EXECUTION_PROFILE_ENABLE))
+
+    /* Call the ISR exit function to indicate an ISR is complete.  */
+    _tx_execution_isr_exit();
+#endif
+
+    /* Decrement the interrupt nesting of this context.  */
+    _tx_linux_isr_nesting--;
+
+    if (_tx_linux_isr_nesting == ((ULONG) 0))
+    {
+
+        /* Resume the thread made ready by the handler if the system was idle.  */
+        _tx_linux_thread_dispatch();
+
+        _tx_linux_interrupt_posture =  TX_INT_ENABLE;
+        pthread_mutex_unlock(&_tx_linux_mutex);
+    }
+}
@@ -0,0 +1,93 @@
+/**************************************************************************/
+/*                                                                        */
+/*       Copyright (c) Microsoft Corporation. All rights reserved.        */
+/*                                                                        */
+/*       This software is licensed under the Microsoft Software License   */
+/*       Terms for Microsoft Azure RTOS. Full text of the license can be  */
+/*       found in the LICENSE file at https://aka.ms/AzureRTOS_EULA       */
+/*       and in the root directory of this software.                      */
+/*                                                                        */
+/**************************************************************************/
+
+
+/**************************************************************************/
+/**************************************************************************/
+/**                                                                       */
+/** ThreadX Component                                                     */
+/**                                                                       */
+/**   Thread                                                              */
+/**                                                                       */
+/**************************************************************************/
+/**************************************************************************/
+
+#define TX_SOURCE_CODE
+
+
+/* Include necessary system files.  */
+
+#include "tx_api.h"
+#include "tx_thread.h"
+
+
+extern pthread_mutex_t          _tx_linux_mutex;
+extern __thread UINT            _tx_linux_interrupt_posture;
+
+
+/**************************************************************************/
+/*                                                                        */
+/*  FUNCTION                                               RELEASE        */
+/*                                                                        */
+/*    _tx_thread_context_save                             Linux/GNU       */
+/*                                                           6.4.0        */
+/*                                                                        */
+/*  DESCRIPTION                                                           */
+/*                                                                        */
+/*    This function saves the context of an executing thread in the       */
+/*    beginning of interrupt processing.                                  */
+/*                                                                        */
+/*    On the host it enters an emulated interrupt on the calling pthread: */
+/*    interrupts are locked out for the duration of the handler, and the  */
+/*    handler sees an ISR system state so that ThreadX services behave as */
+/*    they would when called from a Cortex-M exception handler.           */
+/*                                                                        */
+/*  INPUT                                                                 */
+/*                                                                        */
+/*    None                                                                */
+/*                                                                        */
+/*  OUTPUT                                                                */
+/*                                                                        */
+/*    None                                                                */
+/*                                                                        */
+/*  CALLS                                                                 */
+/*                                                                        */
+/*    pthread_mutex_lock                    Lock out other contexts       */
+/*                                                                        */
+/*  CALLED BY                                                             */
+/*                                                                        */
+/*    Emulated interrupt sources                                          */
+/*                                                                        */
+/**************************************************************************/
+VOID   _tx_thread_context_save(VOID)
+{
+
+    if (_tx_linux_isr_nesting == ((ULONG) 0))
+    {
+        pthread_mutex_lock(&_tx_linux_mutex);
+        _tx_linux_interrupt_posture =  TX_INT_DISABLE;
+    }
+
+    /* Increment the interrupt nesting of this context.  */
+    _tx_linux_isr_nesting++;
+
+#if (defined(TX_ENABLE_EXECUTION_CHANGE_NOTIFY) || defined(TX_EXECUTION_PROFILE_ENABLE))
+
+    /* Call the ISR enter function to indicate an ISR is starting.  */
+    _tx_execution_isr_enter();
+#endif
+
+#ifdef TX_ENABLE_EVENT_TRACE
+
+    /* Insert the ISR enter event, the ISR ID is that of the emulated source.  */
+    _tx_trace_isr_enter_insert(_tx_linux_isr_id);
+#endif
+}
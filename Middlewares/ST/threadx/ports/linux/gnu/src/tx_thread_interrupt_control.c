@@ -0,0 +1,190 @@
+/**************************************************************************/
+/*                                                                        */
+/*       Copyright (c) Microsoft Corporation. All rights reserved.        */
+/*                                                                        */
+/*       This software is licensed under the Microsoft Software License   */
+/*       Terms for Microsoft Azure RTOS. Full text of the license can be  */
+/*       found in the LICENSE file at https://aka.ms/AzureRTOS_EULA       */
+/*       and in the root directory of this software.                      */
+/*                                                                        */
+/**************************************************************************/
+
+
+/**************************************************************************/
+/**************************************************************************/
+/**                                                                       */
+/** ThreadX Component                                                     */
+/**                                                                       */
+/**   Thread                                                              */
+/**                                                                       */
+/**************************************************************************/
+/**************************************************************************/
+
+#define TX_SOURCE_CODE
+
+
+/* Include necessary system files.  */
+
+#include "tx_api.h"
+#include "tx_thread.h"
+
+
+extern pthread_mutex_t          _tx_linux_mutex;
+extern __thread TX_THREAD       *_tx_linux_thread_self;
+extern __thread UINT            _tx_linux_interrupt_posture;
+
+
+/**************************************************************************/
+/*                                                                        */
+/*  FUNCTION                                               RELEASE        */
+/*                                                                        */
+/*    _tx_thread_interrupt_disable                        Linux/GNU       */
+/*                                                           6.4.0        */
+/*                                                                        */
+/*  DESCRIPTION                                                           */
+/*                                                                        */
+/*    This function disables interrupts by taking the port mutex, unless  */
+/*    the calling pthread already holds it, and returns the previous      */
+/*    posture.                                                            */
+/*                                                                        */
+/*  INPUT                                                                 */
+/*                                                                        */
+/*    None                                                                */
+/*                                                                        */
+/*  OUTPUT                                                                */
+/*                                                                        */
+/*    previous_posture                      Previous interrupt posture    */
+/*                                                                        */
+/*  CALLS                                                                 */
+/*                                                                        */
+/*    pthread_mutex_lock                    Lock out other contexts       */
+/*                                                                        */
+/*  CALLED BY                                                             */
+/*                                                                        */
+/*    ThreadX components                                                  */
+/*                                                                        */
+/**************************************************************************/
+UINT   _tx_thread_interrupt_disable(VOID)
+{
+
+UINT    previous_posture;
+
+
+    previous_posture =  _tx_linux_interrupt_posture;
+    if (previous_posture == TX_INT_ENABLE)
+    {
+        pthread_mutex_lock(&_tx_linux_mutex);
+        _tx_linux_interrupt_posture =  TX_INT_DISABLE;
+    }
+
+    return(previous_posture);
+}
+
+
+/**************************************************************************/
+/*                                                                        */
+/*  FUNCTION                                               RELEASE        */
+/*                                                                        */
+/*    _tx_thread_interrupt_restore                        Linux/GNU       */
+/*                                                           6.4.0        */
+/*                                                                        */
+/*  DESCRIPTION                                                           */
+/*                                                                        */
+/*    This function restores the interrupt posture returned by            */
+/*    _tx_thread_interrupt_disable.  When interrupts are re-enabled by    */
+/*    the running thread and an emulated interrupt has made another       */
+/*    thread ready in the meantime, the switch that PendSV would perform  */
+/*    on the target is carried out here.                                  */
+/*                                                                        */
+/*  INPUT                                                                 */
+/*                                                                        */
+/*    previous_posture                      Previous interrupt posture    */
+/*                                                                        */
+/*  OUTPUT                                                                */
+/*                                                                        */
+/*    None                                                                */
+/*                                                                        */
+/*  CALLS                                                                 */
+/*                                                                        */
+/*    _tx_linux_thread_switch               Give up the processor         */
+/*    pthread_mutex_unlock                  Release other contexts        */
+/*                                                                        */
+/*  CALLED BY                                                             */
+/*                                                                        */
+/*    ThreadX components                                                  */
+/*                                                                        */
+/**************************************************************************/
+VOID   _tx_thread_interrupt_restore(UINT previous_posture)
+{
+
+TX_THREAD   *thread_ptr;
+
+
+    if ((previous_posture == TX_INT_ENABLE) && (_tx_linux_interrupt_posture == TX_INT_DISABLE))
+    {
+
+        /* Determine if a preemption is pending for the running thread.  */
+        thread_ptr =  _tx_linux_thread_self;
+        if ((thread_ptr != TX_NULL) &&
+            (TX_THREAD_GET_SYSTEM_STATE() == ((ULONG) 0)) &&
+            (_tx_thread_preempt_disable == ((UINT) 0)) &&
+            (_tx_thread_current_ptr == thread_ptr) &&
+            (_tx_thread_execute_ptr != thread_ptr))
+        {
+            _tx_linux_thread_switch(thread_ptr);
+        }
+
+        _tx_linux_interrupt_posture =  TX_INT_ENABLE;
+        pthread_mutex_unlock(&_tx_linux_mutex);
+    }
+}
+
+
+/**************************************************************************/
+/*                                                                        */
+/*  FUNCTION                                               RELEASE        */
+/*                                                                        */
+/*    _tx_thread_interrupt_control                        Linux/GNU       */
+/*                                                           6.4.0        */
+/*                                                                        */
+/*  DESCRIPTION                                                           */
+/*                                                                        */
+/*    This function is responsible for changing the interrupt lockout     */
+/*    posture of the system.                                              */
+/*                                                                        */
+/*  INPUT                                                                 */
+/*                                                                        */
+/*    new_posture                           New interrupt lockout posture */
+/*                                                                        */
+/*  OUTPUT                                                                */
+/*                                                                        */
+/*    old_posture                           Old interrupt lockout posture */
+/*                                                                        */
+/*  CALLS                                                                 */
+/*                                                                        */
+/*    _tx_thread_interrupt_disable          Disable interrupts            */
+/*    _tx_thread_interrupt_restore          Restore interrupts            */
+/*                                                                        */
+/*  CALLED BY                                                             */
+/*                                                                        */
+/*    Application Code                                                    */
+/*                                                                        */
+/**************************************************************************/
+UINT   _tx_thread_interrupt_control(UINT new_posture)
+{
+
+UINT    old_posture;
+
+
+    if (new_posture == TX_INT_DISABLE)
+    {
+        old_posture =  _tx_thread_interrupt_disable();
+    }
+    else
+    {
+        old_posture =  _tx_linux_interrupt_posture;
+        _tx_thread_interrupt_restore(TX_INT_ENABLE);
+    }
+
+    return(old_posture);
+}
@@ -0,0 +1,163 @@
+/**************************************************************************/
+/*                                                                        */
+/*       Copyright (c) Microsoft Corporation. All rights reserved.        */
+/*                                                                        */
+/*       This software is licensed under the Microsoft Software License   */
+/*       Terms for Microsoft Azure RTOS. Full text of the license can be  */
+/*       found in the LICENSE file at https://aka.ms/AzureRTOS_EULA       */
+/*       and in the root directory of this software.                      */
+/*                                                                        */
+/**************************************************************************/
+
+
+/**************************************************************************/
+/**************************************************************************/
+/**                                                                       */
+/** ThreadX Component                                                     */
+/**                                                                       */
+/**   Thread                                                              */
+/**                                                                       */
+/**************************************************************************/
+/**************************************************************************/
+
+#define TX_SOURCE_CODE
+
+
+/* Include necessary system files.  */
+
+#include "tx_api.h"
+#include "tx_thread.h"
+#include "tx_timer.h"
+
+
+extern pthread_mutex_t  _tx_linux_mutex;
+extern pthread_cond_t   _tx_linux_scheduler_cond;
+extern UINT             _tx_linux_scheduler_started;
+
+
+/**************************************************************************/
+/*                                                                        */
+/*  FUNCTION                                               RELEASE        */
+/*                                                                        */
+/*    _tx_thread_schedule                                 Linux/GNU       */
+/*                                                           6.4.0        */
+/*                                                                        */
+/*  DESCRIPTION                                                           */
+/*                                                                        */
+/*    This function waits for a thread control block pointer to appear in */
+/*    the _tx_thread_execute_ptr variable.  Once a thread pointer appears */
+/*    in the variable, the corresponding thread is resumed.               */
+/*                                                                        */
+/*    The scheduler runs on the pthread that called tx_kernel_enter and   */
+/*    never returns.  It only dispatches the first thread: afterwards the */
+/*    context that gives up the processor, or the emulated interrupt that */
+/*    readies a thread while the system is idle, dispatches directly, so  */
+/*    a switch costs one host wake-up instead of two.                     */
+/*                                                                        */
+/*  INPUT                                                                 */
+/*                                                                        */
+/*    None                                                                */
+/*                                                                        */
+/*  OUTPUT                                                                */
+/*                                                                        */
+/*    None                                                                */
+/*                                                                        */
+/*  CALLS                                                                 */
+/*                                                                        */
+/*    _tx_linux_thread_dispatch             Resume the selected thread    */
+/*    pthread_cond_wait                     Idle                          */
+/*                                                                        */
+/*  CALLED BY                                                             */
+/*                                                                        */
+/*    _tx_initialize_kernel_enter          ThreadX entry function         */
+/*                                                                        */
+/**************************************************************************/
+VOID   _tx_thread_schedule(VOID)
+{
+
+    pthread_mutex_lock(&_tx_linux_mutex);
+
+    /* Release the emulated interrupt sources.  */
+    _tx_linux_scheduler_started =  TX_TRUE;
+    pthread_cond_broadcast(&_tx_linux_scheduler_cond);
+
+    while (1)
+    {
+
+        _tx_linux_thread_dispatch();
+        pthread_cond_wait(&_tx_linux_scheduler_cond, &_tx_linux_mutex);
+    }
+}
+
+
+/**************************************************************************/
+/*                                                                        */
+/*  FUNCTION                                               RELEASE        */
+/*                                                                        */
+/*    _tx_linux_thread_dispatch                           Linux/GNU       */
+/*                                                           6.4.0        */
+/*                                                                        */
+/*  DESCRIPTION                                                           */
+/*                                                                        */
+/*    This function resumes the thread in _tx_thread_execute_ptr if the   */
+/*    processor is free, by making it current and posting the semaphore   */
+/*    its pthread is parked on.  It is called with the port mutex held.   */
+/*                                                                        */
+/*  INPUT                                                                 */
+/*                                                                        */
+/*    None                                                                */
+/*                                                                        */
+/*  OUTPUT                                                                */
+/*                                                                        */
+/*    None                                                                */
+/*                                                                        */
+/*  CALLS                                                                 */
+/*                                                                        */
+/*    sem_post                              Resume the selected thread    */
+/*                                                                        */
+/*  CALLED BY                                                             */
+/*                                                                        */
+/*    _tx_thread_schedule                   Scheduler                     */
+/*    _tx_linux_thread_switch               Give up the processor         */
+/*    _tx_thread_context_restore            Interrupt exit                */
+/*                                                                        */
+/**************************************************************************/
+VOID   _tx_linux_thread_dispatch(VOID)
+{
+
+TX_THREAD   *thread_ptr;
+
+
+    /* Is the processor free and a thread ready?  */
+    thread_ptr =  _tx_thread_execute_ptr;
+    if ((_tx_thread_current_ptr != TX_NULL) || (thread_ptr == TX_NULL))
+    {
+        return;
+    }
+
+#ifdef TX_ENABLE_STACK_CHECKING
+
+    /* Check this thread's stack.  */
+    if (((ULONG *) thread_ptr -> tx_thread_stack_ptr) < ((ULONG *) thread_ptr -> tx_thread_stack_highest_ptr))
+    {
+        thread_ptr -> tx_thread_stack_highest_ptr =  thread_ptr -> tx_thread_stack_ptr;
+    }
+#endif
+
+    /* Increment the run count for this thread.  */
+    thread_ptr -> tx_thread_run_count++;
+
+    /* Setup time-slice, if present.  */
+    _tx_timer_time_slice =  thread_ptr -> tx_thread_time_slice;
+
+    /* Setup the current thread pointer and let it run.  */
+    _tx_thread_current_ptr =  thread_ptr;
+
+#if (defined(TX_ENABLE_EXECUTION_CHANGE_NOTIFY) || defined(TX_EXECUTION_PROFILE_ENABLE))
+
+    /* Call the thread entry function to indicate the thread is executing.  */
+    _tx_execution_thread_enter();
+#endif
+
+    sem_post(&thread_ptr -> tx_thread_linux_thread_run_semaphore);
+}
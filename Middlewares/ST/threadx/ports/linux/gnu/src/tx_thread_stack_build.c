@@ -0,0 +1,166 @@
+/**************************************************************************/
+/*                                                                        */
+/*       Copyright (c) Microsoft Corporation. All rights reserved.        */
+/*                                                                        */
+/*       This software is licensed under the Microsoft Software License   */
+/*       Terms for Microsoft Azure RTOS. Full text of the license can be  */
+/*       found in the LICENSE file at https://aka.ms/AzureRTOS_EULA       */
+/*       and in the root directory of this software.                      */
+/*                                                                        */
+/**************************************************************************/
+
+
+/**************************************************************************/
+/**************************************************************************/
+/**                                                                       */
+/** ThreadX Component                                                     */
+/**                                                                       */
+/**   Thread                                                              */
+/**                                                                       */
+/**************************************************************************/
+/**************************************************************************/
+
+#define TX_SOURCE_CODE
+
+
+/* Include necessary system files.  */
+
+#include "tx_api.h"
+#include "tx_thread.h"
+#include <stdio.h>
+
+
+extern __thread TX_THREAD       *_tx_linux_thread_self;
+
+
+static VOID *_tx_linux_thread_entry(VOID *ptr);
+
+
+/**************************************************************************/
+/*                                                                        */
+/*  FUNCTION                                               RELEASE        */
+/*                                                                        */
+/*    _tx_thread_stack_build                              Linux/GNU       */
+/*                                                           6.4.0        */
+/*                                                                        */
+/*  DESCRIPTION                                                           */
+/*                                                                        */
+/*    This function builds a stack frame on the supplied thread's stack.  */
+/*    The stack frame results in a fake interrupt return to the supplied  */
+/*    function pointer.                                                   */
+/*                                                                        */
+/*    On the host the "frame" is a pthread parked on the thread's run     */
+/*    semaphore; the first time the scheduler posts it, it calls the      */
+/*    supplied function.  The ThreadX stack area itself is left filled so */
+/*    that the stack checking logic sees a valid, lightly used stack.     */
+/*                                                                        */
+/*  INPUT                                                                 */
+/*                                                                        */
+/*    thread_ptr                            Pointer to thread control blk */
+/*    function_ptr                          Pointer to shell function     */
+/*                                                                        */
+/*  OUTPUT                                                                */
+/*                                                                        */
+/*    None                                                                */
+/*                                                                        */
+/*  CALLS                                                                 */
+/*                                                                        */
+/*    pthread_create                        Create the backing thread     */
+/*                                                                        */
+/*  CALLED BY                                                             */
+/*                                                                        */
+/*    _tx_thread_create                     Create thread service         */
+/*    _tx_thread_reset                      Reset thread service          */
+/*                                                                        */
+/**************************************************************************/
+VOID   _tx_thread_stack_build(TX_THREAD *thread_ptr, VOID (*function_ptr)(VOID))
+{
+
+pthread_attr_t  attributes;
+
+
+    thread_ptr -> tx_thread_linux_entry =          function_ptr;
+    thread_ptr -> tx_thread_linux_exit_request =   TX_FALSE;
+
+    if (sem_init(&thread_ptr -> tx_thread_linux_thread_run_semaphore, 0, 0) != 0)
+    {
+
+        fprintf(stderr, "ThreadX: unable to create the run semaphore of %s\n", thread_ptr -> tx_thread_name);
+        abort();
+    }
+
+    pthread_attr_init(&attributes);
+    pthread_attr_setstacksize(&attributes, TX_LINUX_THREAD_STACK_SIZE);
+    if (pthread_create(&thread_ptr -> tx_thread_linux_thread_id, &attributes, _tx_linux_thread_entry, thread_ptr) != 0)
+    {
+
+        fprintf(stderr, "ThreadX: unable to create the pthread of %s\n", thread_ptr -> tx_thread_name);
+        abort();
+    }
+    pthread_attr_destroy(&attributes);
+
+    /* Setup stack pointer just below the end of the stack area.  */
+    thread_ptr -> tx_thread_stack_ptr =  TX_ALIGN_TYPE_TO_POINTER_CONVERT((TX_POINTER_TO_ALIGN_TYPE_CONVERT(thread_ptr -> tx_thread_stack_end) - ((ALIGN_TYPE) 16)) & ~((ALIGN_TYPE) 7));
+}
+
+
+/* Body of the pthread behind a ThreadX thread.  */
+
+static VOID *_tx_linux_thread_entry(VOID *ptr)
+{
+
+TX_THREAD   *thread_ptr;
+
+
+    thread_ptr =  (TX_THREAD *) ptr;
+    _tx_linux_thread_self =  thread_ptr;
+
+    /* Wait to be scheduled for the first time.  */
+    _tx_linux_thread_wait(thread_ptr);
+
+    (thread_ptr -> tx_thread_linux_entry)();
+
+    return(TX_NULL);
+}
+
+
+/**************************************************************************/
+/*                                                                        */
+/*  FUNCTION                                               RELEASE        */
+/*                                                                        */
+/*    _tx_linux_thread_exit                               Linux/GNU       */
+/*                                                           6.4.0        */
+/*                                                                        */
+/*  DESCRIPTION                                                           */
+/*                                                                        */
+/*    This function retires the pthread behind a completed or terminated  */
+/*    thread.  The pthread is parked on its run semaphore, so it is woken */
+/*    with the exit request set and joined before the control block is    */
+/*    deleted or rebuilt by the reset service.                            */
+/*                                                                        */
+/*  INPUT                                                                 */
+/*                                                                        */
+/*    thread_ptr                            Pointer to thread control blk */
+/*                                                                        */
+/*  OUTPUT                                                                */
+/*                                                                        */
+/*    None                                                                */
+/*                                                                        */
+/*  CALLS                                                                 */
+/*                                                                        */
+/*    pthread_join                          Wait for the thread to exit   */
+/*                                                                        */
+/*  CALLED BY                                                             */
+/*                                                                        */
+/*    _tx_thread_delete                     Delete thread service         */
+/*    _tx_thread_reset                      Reset thread service          */
+/*                                                                        */
+/**************************************************************************/
+VOID   _tx_linux_thread_exit(TX_THREAD *thread_ptr)
+{
+
+    thread_ptr -> tx_thread_linux_exit_request =  TX_TRUE;
+    sem_post(&thread_ptr -> tx_thread_linux_thread_run_semaphore);
+    pthread_join(thread_ptr -> tx_thread_linux_thread_id, TX_NULL);
+    sem_destroy(&thread_ptr -> tx_thread_linux_thread_run_semaphore);
+}
@@ -0,0 +1,184 @@
+/**************************************************************************/
+/*                                                                        */
+/*       Copyright (c) Microsoft Corporation. All rights reserved.        */
+/*                                                                        */
+/*       This software is licensed under the Microsoft Software License   */
+/*       Terms for Microsoft Azure RTOS. Full text of the license can be  */
+/*       found in the LICENSE file at https://aka.ms/AzureRTOS_EULA       */
+/*       and in the root directory of this software.                      */
+/*                                                                        */
+/**************************************************************************/
+
+
+/**************************************************************************/
+/**************************************************************************/
+/**                                                                       */
+/** ThreadX Component                                                     */
+/**                                                                       */
+/**   Thread                                                              */
+/**                                                                       */
+/**************************************************************************/
+/**************************************************************************/
+
+#define TX_SOURCE_CODE
+
+
+/* Include necessary system files.  */
+
+#include "tx_api.h"
+#include "tx_thread.h"
+#include "tx_timer.h"
+#include <errno.h>
+
+
+extern pthread_mutex_t          _tx_linux_mutex;
+extern __thread TX_THREAD       *_tx_linux_thread_self;
+extern __thread UINT            _tx_linux_interrupt_posture;
+
+
+/**************************************************************************/
+/*                                                                        */
+/*  FUNCTION                                               RELEASE        */
+/*                                                                        */
+/*    _tx_linux_thread_switch                             Linux/GNU       */
+/*                                                           6.4.0        */
+/*                                                                        */
+/*  DESCRIPTION                                                           */
+/*                                                                        */
+/*    This function gives up the processor on behalf of the calling       */
+/*    thread for as long as it is not the thread selected to execute.     */
+/*    It is entered and left with the port mutex held by the caller.      */
+/*                                                                        */
+/*  INPUT                                                                 */
+/*                                                                        */
+/*    thread_ptr                            Calling thread                */
+/*                                                                        */
+/*  OUTPUT                                                                */
+/*                                                                        */
+/*    None                                                                */
+/*                                                                        */
+/*  CALLS                                                                 */
+/*                                                                        */
+/*    _tx_linux_thread_dispatch             Resume the next thread        */
+/*    _tx_linux_thread_wait                 Park until resumed            */
+/*                                                                        */
+/*  CALLED BY                                                             */
+/*                                                                        */
+/*    _tx_thread_system_return              Return to system              */
+/*    _tx_thread_interrupt_restore          Deferred preemption           */
+/*                                                                        */
+/**************************************************************************/
+VOID   _tx_linux_thread_switch(TX_THREAD *thread_ptr)
+{
+
+    while ((thread_ptr -> tx_thread_state != TX_READY) || (_tx_thread_execute_ptr != thread_ptr))
+    {
+
+        /* Save the remaining time-slice and disable it.  */
+        thread_ptr -> tx_thread_time_slice =  _tx_timer_time_slice;
+        _tx_timer_time_slice =  ((ULONG) 0);
+
+#if (defined(TX_ENABLE_EXECUTION_CHANGE_NOTIFY) || defined(TX_EXECUTION_PROFILE_ENABLE))
+
+        /* Call the thread exit function to indicate the thread is no longer executing.  */
+        _tx_execution_thread_exit();
+#endif
+
+        /* Give up the processor and hand it to the next thread, if any.  */
+        _tx_thread_current_ptr =  TX_NULL;
+        _tx_linux_thread_dispatch();
+        pthread_mutex_unlock(&_tx_linux_mutex);
+
+        /* Wait until the scheduler picks this thread again.  */
+        _tx_linux_thread_wait(thread_ptr);
+
+        pthread_mutex_lock(&_tx_linux_mutex);
+    }
+}
+
+
+/* Park the calling pthread on its run semaphore. A thread that is deleted or
+   reset while parked is woken with the exit request set and leaves here.  */
+
+VOID   _tx_linux_thread_wait(TX_THREAD *thread_ptr)
+{
+
+    while (sem_wait(&thread_ptr -> tx_thread_linux_thread_run_semaphore) != 0)
+    {
+        if (errno != EINTR)
+        {
+            abort();
+        }
+    }
+
+    if (thread_ptr -> tx_thread_linux_exit_request != TX_FALSE)
+    {
+        pthread_exit(TX_NULL);
+    }
+}
+
+
+/**************************************************************************/
+/*                                                                        */
+/*  FUNCTION                                               RELEASE        */
+/*                                                                        */
+/*    _tx_thread_system_return                            Linux/GNU       */
+/*                                                           6.4.0        */
+/*                                                                        */
+/*  DESCRIPTION                                                           */
+/*                                                                        */
+/*    This function is target processor specific.  It is used to transfer */
+/*    control from a thread back to the ThreadX system.  Only a           */
+/*    minimal context is saved since the compiler assumes temp registers  */
+/*    are going to get slicked by a function call anyway.                 */
+/*                                                                        */
+/*    The check for a pending switch is repeated under the port mutex,    */
+/*    since an emulated interrupt may have resumed the calling thread     */
+/*    between the kernel's TX_RESTORE and this call.                      */
+/*                                                                        */
+/*  INPUT                                                                 */
+/*                                                                        */
+/*    None                                                                */
+/*                                                                        */
+/*  OUTPUT                                                                */
+/*                                                                        */
+/*    None                                                                */
+/*                                                                        */
+/*  CALLS                                                                 */
+/*                                                                        */
+/*    _tx_linux_thread_switch               Give up the processor         */
+/*                                                                        */
+/*  CALLED BY                                                             */
+/*                                                                        */
+/*    ThreadX components                                                  */
+/*                                                                        */
+/**************************************************************************/
+VOID   _tx_thread_system_return(VOID)
+{
+
+TX_THREAD   *thread_ptr;
+UINT        posture;
+
+
+    /* Only a ThreadX thread can give up the processor.  */
+    thread_ptr =  _tx_linux_thread_self;
+    if ((thread_ptr == TX_NULL) || (TX_THREAD_GET_SYSTEM_STATE() != ((ULONG) 0)))
+    {
+        return;
+    }
+
+    posture =  _tx_linux_interrupt_posture;
+    if (posture == TX_INT_ENABLE)
+    {
+        pthread_mutex_lock(&_tx_linux_mutex);
+        _tx_linux_interrupt_posture =  TX_INT_DISABLE;
+    }
+
+    _tx_linux_thread_switch(thread_ptr);
+
+    if (posture == TX_INT_ENABLE)
+    {
+        _tx_linux_interrupt_posture =  TX_INT_ENABLE;
+        pthread_mutex_unlock(&_tx_linux_mutex);
+    }
+}
@@ -0,0 +1,947 @@
+/**************************************************************************/
+/*                                                                        */
+/*       Copyright (c) Microsoft Corporation. All rights reserved.        */
+/*                                                                        */
+/*       This software is licensed under the Microsoft Software License   */
+/*       Terms for Microsoft Azure RTOS. Full text of the license can be  */
+/*       found in the LICENSE file at https://aka.ms/AzureRTOS_EULA       */
+/*       and in the root directory of this software.                      */
+/*                                                                        */
+/**************************************************************************/
+
+
+/**************************************************************************/
+/**************************************************************************/
+/**                                                                       */
+/** ThreadX Component                                                     */
+/**                                                                       */
+/**   Execution Profile Kit                                               */
+/**                                                                       */
+/**************************************************************************/
+/**************************************************************************/
+
+#define TX_SOURCE_CODE
+
+
+/* Include necessary system files.  */
+
+#include "tx_api.h"
+#include "tx_thread.h"
+
+#ifdef TX_EXECUTION_PROFILE_ENABLE
+
+#include "tx_execution_profile.h"
+
+
+/* Define the totals.  */
+
+EXECUTION_TIME              _tx_execution_thread_time_total;
+EXECUTION_TIME              _tx_execution_isr_time_total;
+EXECUTION_TIME              _tx_execution_idle_time_total;
+
+
+/* Define the open intervals. At most one of a thread slice, an ISR or idle
+   time is being measured at any moment.  */
+
+TX_THREAD                   *_tx_execution_thread_running;
+TX_THREAD                   *_tx_execution_thread_interrupted;
+UINT                        _tx_execution_idle_active;
+EXECUTION_TIME_SOURCE_TYPE  _tx_execution_idle_time_last_start;
+EXECUTION_TIME_SOURCE_TYPE  _tx_execution_isr_time_last_start;
+ULONG                       _tx_execution_isr_nest_counter;
+
+
+/* Define the per interrupt source table.  */
+
+TX_EXECUTION_ISR            _tx_execution_isr_sources[TX_EXECUTION_ISR_SOURCES];
+UINT                        _tx_execution_isr_sources_used;
+TX_EXECUTION_ISR            *_tx_execution_isr_current;
+
+
+/* Find or claim the table entry of an interrupt source.  */
+
+static TX_EXECUTION_ISR  *_tx_execution_isr_source_find(ULONG isr_id)
+{
+
+UINT                i;
+TX_EXECUTION_ISR    *isr_ptr;
+
+
+    for (i =  ((UINT) 0); i < _tx_execution_isr_sources_used; i++)
+    {
+        if (_tx_execution_isr_sources[i].tx_execution_isr_id == isr_id)
+        {
+            return(&_tx_execution_isr_sources[i]);
+        }
+    }
+
+    /* Claim a new entry, or fall back to the last one.  */
+    if (_tx_execution_isr_sources_used < ((UINT) TX_EXECUTION_ISR_SOURCES))
+    {
+        isr_ptr =  &_tx_execution_isr_sources[_tx_execution_isr_sources_used];
+        _tx_execution_isr_sources_used++;
+        isr_ptr -> tx_execution_isr_id =  isr_id;
+    }
+    else
+    {
+        isr_ptr =  &_tx_execution_isr_sources[TX_EXECUTION_ISR_SOURCES - 1];
+        isr_ptr -> tx_execution_isr_id =  TX_EXECUTION_ISR_ID_OTHER;
+    }
+    return(isr_ptr);
+}
+
+
+/**************************************************************************/
+/*                                                                        */
+/*  FUNCTION                                               RELEASE        */
+/*                                                                        */
+/*    _tx_execution_initialize                            PORTABLE C      */
+/*                                                           6.4.0        */
+/*                                                                        */
+/*  DESCRIPTION                                                           */
+/*                                                                        */
+/*    This function starts the execution time source.  It is called from  */
+/*    tx_kernel_enter before the scheduler runs, so everything up to the  */
+/*    first thread is counted as idle.                                    */
+/*                                                                        */
+/*  INPUT                                                                 */
+/*                                                                        */
+/*    None                                                                */
+/*                                                                        */
+/*  OUTPUT                                                                */
+/*                                                                        */
+/*    None                                                                */
+/*                                                                        */
+/*  CALLS                                                                 */
+/*                                                                        */
+/*    None                                                                */
+/*                                                                        */
+/*  CALLED BY                                                             */
+/*                                                                        */
+/*    _tx_initialize_kernel_enter           Kernel entry                  */
+/*                                                                        */
+/*  RELEASE HISTORY                                                       */
+/*                                                                        */
+/*    DATE              NAME                      DESCRIPTION             */
+/*                                                                        */
+/*  10-19-2026                              Initial Version 6.4.0         */
+/*                                                                        */
+/**************************************************************************/
+VOID  _tx_execution_initialize(VOID)
+{
+
+    TX_EXECUTION_TIME_SOURCE_ENABLE();
+
+    _tx_execution_idle_time_last_start =  TX_EXECUTION_TIME_SOURCE;
+    _tx_execution_idle_active =  TX_TRUE;
+}
+
+
+/**************************************************************************/
+/*                                                                        */
+/*  FUNCTION                                               RELEASE        */
+/*                                                                        */
+/*    _tx_execution_thread_enter                          PORTABLE C      */
+/*                                                           6.4.0        */
+/*                                                                        */
+/*  DESCRIPTION                                                           */
+/*                                                                        */
+/*    This function is called by the scheduler, with interrupts disabled, */
+/*    once _tx_thread_current_ptr designates the thread about to run.     */
+/*    It closes the idle interval and opens a slice for the thread.       */
+/*                                                                        */
+/*  INPUT                                                                 */
+/*                                                                        */
+/*    None                                                                */
+/*                                                                        */
+/*  OUTPUT                                                                */
+/*                                                                        */
+/*    None                                                                */
+/*                                                                        */
+/*  CALLS                                                                 */
+/*                                                                        */
+/*    None                                                                */
+/*                                                                        */
+/*  CALLED BY                                                             */
+/*                                                                        */
+/*    _tx_thread_schedule                   Scheduler                     */
+/*                                                                        */
+/*  RELEASE HISTORY                                                       */
+/*                                                                        */
+/*    DATE              NAME                      DESCRIPTION             */
+/*                                                                        */
+/*  10-19-2026                              Initial Version 6.4.0         */
+/*                                                                        */
+/**************************************************************************/
+VOID  _tx_execution_thread_enter(VOID)
+{
+
+EXECUTION_TIME_SOURCE_TYPE  current_time;
+TX_THREAD                   *thread_ptr;
+
+
+    current_time =  TX_EXECUTION_TIME_SOURCE;
+
+    if (_tx_execution_idle_active != TX_FALSE)
+    {
+        _tx_execution_idle_time_total +=  (EXECUTION_TIME) (EXECUTION_TIME_SOURCE_TYPE) (current_time - _tx_execution_idle_time_last_start);
+        _tx_execution_idle_active =  TX_FALSE;
+    }
+
+    thread_ptr =  _tx_thread_current_ptr;
+    if (thread_ptr != TX_NULL)
+    {
+        thread_ptr -> tx_thread_execution_time_last_start =  current_time;
+    }
+    _tx_execution_thread_running =  thread_ptr;
+}
+
+
+/**************************************************************************/
+/*                                                                        */
+/*  FUNCTION                                               RELEASE        */
+/*                                                                        */
+/*    _tx_execution_thread_exit                           PORTABLE C      */
+/*                                                           6.4.0        */
+/*                                                                        */
+/*  DESCRIPTION                                                           */
+/*                                                                        */
+/*    This function is called by the scheduler, with interrupts disabled, */
+/*    when the running thread gives up the processor.  It charges the     */
+/*    slice to the thread and starts counting idle time.                  */
+/*                                                                        */
+/*  INPUT                                                                 */
+/*                                                                        */
+/*    None                                                                */
+/*                                                                        */
+/*  OUTPUT                                                                */
+/*                                                                        */
+/*    None                                                                */
+/*                                                                        */
+/*  CALLS                                                                 */
+/*                                                                        */
+/*    None                                                                */
+/*                                                                        */
+/*  CALLED BY                                                             */
+/*                                                                        */
+/*    _tx_thread_schedule                   Scheduler                     */
+/*                                                                        */
+/*  RELEASE HISTORY                                                       */
+/*                                                                        */
+/*    DATE              NAME                      DESCRIPTION             */
+/*                                                                        */
+/*  10-19-2026                              Initial Version 6.4.0         */
+/*                                                                        */
+/**************************************************************************/
+VOID  _tx_execution_thread_exit(VOID)
+{
+
+EXECUTION_TIME_SOURCE_TYPE  current_time;
+TX_THREAD                   *thread_ptr;
+EXECUTION_TIME              delta_time;
+
+
+    current_time =  TX_EXECUTION_TIME_SOURCE;
+
+    thread_ptr =  _tx_execution_thread_running;
+    if (thread_ptr != TX_NULL)
+    {
+        delta_time =  (EXECUTION_TIME) (EXECUTION_TIME_SOURCE_TYPE) (current_time - thread_ptr -> tx_thread_execution_time_last_start);
+        thread_ptr -> tx_thread_execution_time_total +=  delta_time;
+        _tx_execution_thread_time_total +=  delta_time;
+        _tx_execution_thread_running =  TX_NULL;
+    }
+
+    if (_tx_execution_idle_active == TX_FALSE)
+    {
+        _tx_execution_idle_time_last_start =  current_time;
+        _tx_execution_idle_active =  TX_TRUE;
+    }
+}
+
+
+/**************************************************************************/
+/*                                                                        */
+/*  FUNCTION                                               RELEASE        */
+/*                                                                        */
+/*    _tx_execution_isr_enter                             PORTABLE C      */
+/*                                                           6.4.0        */
+/*                                                                        */
+/*  DESCRIPTION                                                           */
+/*                                                                        */
+/*    This function is called at the start of an interrupt service        */
+/*    routine.  On the outermost interrupt it suspends the measurement of */
+/*    the interrupted thread (or idle) and starts timing the ISR.         */
+/*                                                                        */
+/*  INPUT                                                                 */
+/*                                                                        */
+/*    None                                                                */
+/*                                                                        */
+/*  OUTPUT                                                                */
+/*                                                                        */
+/*    None                                                                */
+/*                                                                        */
+/*  CALLS                                                                 */
+/*                                                                        */
+/*    _tx_execution_isr_source_find         Find the source entry         */
+/*                                                                        */
+/*  CALLED BY                                                             */
+/*                                                                        */
+/*    _tx_thread_context_save               ISR entry                     */
+/*    Application ISRs                                                    */
+/*                                                                        */
+/*  RELEASE HISTORY                                                       */
+/*                                                                        */
+/*    DATE              NAME                      DESCRIPTION             */
+/*                                                                        */
+/*  10-19-2026                              Initial Version 6.4.0         */
+/*                                                                        */
+/**************************************************************************/
+VOID  _tx_execution_isr_enter(VOID)
+{
+
+TX_INTERRUPT_SAVE_AREA
+
+EXECUTION_TIME_SOURCE_TYPE  current_time;
+TX_THREAD                   *thread_ptr;
+EXECUTION_TIME              delta_time;
+
+
+    TX_DISABLE
+
+    if (_tx_execution_isr_nest_counter == ((ULONG) 0))
+    {
+
+        current_time =  TX_EXECUTION_TIME_SOURCE;
+
+        /* Suspend the slice of the interrupted thread.  */
+        thread_ptr =  _tx_execution_thread_running;
+        if (thread_ptr != TX_NULL)
+        {
+            delta_time =  (EXECUTION_TIME) (EXECUTION_TIME_SOURCE_TYPE) (current_time - thread_ptr -> tx_thread_execution_time_last_start);
+            thread_ptr -> tx_thread_execution_time_total +=  delta_time;
+            _tx_execution_thread_time_total +=  delta_time;
+            _tx_execution_thread_running =  TX_NULL;
+        }
+        _tx_execution_thread_interrupted =  thread_ptr;
+
+        /* Or close the idle interval.  */
+        if (_tx_execution_idle_active != TX_FALSE)
+        {
+            _tx_execution_idle_time_total +=  (EXECUTION_TIME) (EXECUTION_TIME_SOURCE_TYPE) (current_time - _tx_execution_idle_time_last_start);
+            _tx_execution_idle_active =  TX_FALSE;
+        }
+
+        _tx_execution_isr_current =  _tx_execution_isr_source_find(TX_EXECUTION_ISR_ID());
+        _tx_execution_isr_current -> tx_execution_isr_count++;
+        _tx_execution_isr_time_last_start =  current_time;
+    }
+    _tx_execution_isr_nest_counter++;
+
+    TX_RESTORE
+}
+
+
+/**************************************************************************/
+/*                                                                        */
+/*  FUNCTION                                               RELEASE        */
+/*                                                                        */
+/*    _tx_execution_isr_exit                              PORTABLE C      */
+/*                                                           6.4.0        */
+/*                                                                        */
+/*  DESCRIPTION                                                           */
+/*                                                                        */
+/*    This function is called at the end of an interrupt service routine. */
+/*    On the outermost interrupt it charges the ISR time and resumes the  */
+/*    measurement of the interrupted thread, or of idle time.             */
+/*                                                                        */
+/*  INPUT                                                                 */
+/*                                                                        */
+/*    None                                                                */
+/*                                                                        */
+/*  OUTPUT                                                                */
+/*                                                                        */
+/*    None                                                                */
+/*                                                                        */
+/*  CALLS                                                                 */
+/*                                                                        */
+/*    None                                                                */
+/*                                                                        */
+/*  CALLED BY                                                             */
+/*                                                                        */
+/*    _tx_thread_context_restore            ISR exit                      */
+/*    Application ISRs                                                    */
+/*                                                                        */
+/*  RELEASE HISTORY                                                       */
+/*                                                                        */
+/*    DATE              NAME                      DESCRIPTION             */
+/*                                                                        */
+/*  10-19-2026                              Initial Version 6.4.0         */
+/*                                                                        */
+/**************************************************************************/
+VOID  _tx_execution_isr_exit(VOID)
+{
+
+TX_INTERRUPT_SAVE_AREA
+
+EXECUTION_TIME_SOURCE_TYPE  current_time;
+TX_THREAD                   *thread_ptr;
+EXECUTION_TIME              delta_time;
+
+
+    TX_DISABLE
+
+    if (_tx_execution_isr_nest_counter != ((ULONG) 0))
+    {
+        _tx_execution_isr_nest_counter--;
+        if (_tx_execution_isr_nest_counter == ((ULONG) 0))
+        {
+
+            current_time =  TX_EXECUTION_TIME_SOURCE;
+
+            delta_time =  (EXECUTION_TIME) (EXECUTION_TIME_SOURCE_TYPE) (current_time - _tx_execution_isr_time_last_start);
+            _tx_execution_isr_time_total +=  delta_time;
+            _tx_execution_isr_current -> tx_execution_isr_time +=  delta_time;
+
+            /* Resume the interrupted thread if it still owns the processor,
+               otherwise the scheduler picks up from idle.  */
+            thread_ptr =  _tx_execution_thread_interrupted;
+            if ((thread_ptr != TX_NULL) && (thread_ptr == _tx_thread_current_ptr))
+            {
+                thread_ptr -> tx_thread_execution_time_last_start =  current_time;
+                _tx_execution_thread_running =  thread_ptr;
+            }
+            else
+            {
+                _tx_execution_idle_time_last_start =  current_time;
+                _tx_execution_idle_active =  TX_TRUE;
+            }
+        }
+    }
+
+    TX_RESTORE
+}
+
+
+/**************************************************************************/
+/*                                                                        */
+/*  FUNCTION                                               RELEASE        */
+/*                                                                        */
+/*    _tx_execution_thread_time_reset                     PORTABLE C      */
+/*                                                           6.4.0        */
+/*                                                                        */
+/*  DESCRIPTION                                                           */
+/*                                                                        */
+/*    This function clears the execution time of the specified thread.    */
+/*                                                                        */
+/*  INPUT                                                                 */
+/*                                                                        */
+/*    thread_ptr                            Pointer to thread             */
+/*                                                                        */
+/*  OUTPUT                                                                */
+/*                                                                        */
+/*    status                                Completion status             */
+/*                                                                        */
+/*  CALLS                                                                 */
+/*                                                                        */
+/*    None                                                                */
+/*                                                                        */
+/*  CALLED BY                                                             */
+/*                                                                        */
+/*    Application Code                                                    */
+/*                                                                        */
+/*  RELEASE HISTORY                                                       */
+/*                                                                        */
+/*    DATE              NAME                      DESCRIPTION             */
+/*                                                                        */
+/*  10-19-2026                              Initial Version 6.4.0         */
+/*                                                                        */
+/**************************************************************************/
+UINT  _tx_execution_thread_time_reset(TX_THREAD *thread_ptr)
+{
+
+TX_INTERRUPT_SAVE_AREA
+
+
+    if (thread_ptr == TX_NULL)
+    {
+        return(TX_THREAD_ERROR);
+    }
+
+    TX_DISABLE
+    thread_ptr -> tx_thread_execution_time_total =  ((EXECUTION_TIME) 0);
+    TX_RESTORE
+
+    return(TX_SUCCESS);
+}
+
+
+/**************************************************************************/
+/*                                                                        */
+/*  FUNCTION                                               RELEASE        */
+/*                                                                        */
+/*    _tx_execution_thread_total_time_reset               PORTABLE C      */
+/*                                                           6.4.0        */
+/*                                                                        */
+/*  DESCRIPTION                                                           */
+/*                                                                        */
+/*    This function clears the execution time of all threads.             */
+/*                                                                        */
+/*  INPUT                                                                 */
+/*                                                                        */
+/*    None                                                                */
+/*                                                                        */
+/*  OUTPUT                                                                */
+/*                                                                        */
+/*    status                                Completion status             */
+/*                                                                        */
+/*  CALLS                                                                 */
+/*                                                                        */
+/*    None                                                                */
+/*                                                                        */
+/*  CALLED BY                                                             */
+/*                                                                        */
+/*    Application Code                                                    */
+/*                                                                        */
+/*  RELEASE HISTORY                                                       */
+/*                                                                        */
+/*    DATE              NAME                      DESCRIPTION             */
+/*                                                                        */
+/*  10-19-2026                              Initial Version 6.4.0         */
+/*                                                                        */
+/**************************************************************************/
+UINT  _tx_execution_thread_total_time_reset(VOID)
+{
+
+TX_INTERRUPT_SAVE_AREA
+
+TX_THREAD       *thread_ptr;
+ULONG           count;
+
+
+    TX_DISABLE
+
+    thread_ptr =  _tx_thread_created_ptr;
+    for (count =  _tx_thread_created_count; count != ((ULONG) 0); count--)
+    {
+        thread_ptr -> tx_thread_execution_time_total =  ((EXECUTION_TIME) 0);
+        thread_ptr =  thread_ptr -> tx_thread_created_next;
+    }
+    _tx_execution_thread_time_total =  ((EXECUTION_TIME) 0);
+
+    TX_RESTORE
+
+    return(TX_SUCCESS);
+}
+
+
+/**************************************************************************/
+/*                                                                        */
+/*  FUNCTION                                               RELEASE        */
+/*                                                                        */
+/*    _tx_execution_isr_time_reset                        PORTABLE C      */
+/*                                                           6.4.0        */
+/*                                                                        */
+/*  DESCRIPTION                                                           */
+/*                                                                        */
+/*    This function clears the total ISR time and the counts and times of */
+/*    every interrupt source.  The sources already seen keep their slot.  */
+/*                                                                        */
+/*  INPUT                                                                 */
+/*                                                                        */
+/*    None                                                                */
+/*                                                                        */
+/*  OUTPUT                                                                */
+/*                                                                        */
+/*    status                                Completion status             */
+/*                                                                        */
+/*  CALLS                                                                 */
+/*                                                                        */
+/*    None                                                                */
+/*                                                                        */
+/*  CALLED BY                                                             */
+/*                                                                        */
+/*    Application Code                                                    */
+/*                                                                        */
+/*  RELEASE HISTORY                                                       */
+/*                                                                        */
+/*    DATE              NAME                      DESCRIPTION             */
+/*                                                                        */
+/*  10-19-2026                              Initial Version 6.4.0         */
+/*                                                                        */
+/**************************************************************************/
+UINT  _tx_execution_isr_time_reset(VOID)
+{
+
+TX_INTERRUPT_SAVE_AREA
+
+UINT            i;
+
+
+    TX_DISABLE
+
+    for (i =  ((UINT) 0); i < _tx_execution_isr_sources_used; i++)
+    {
+        _tx_execution_isr_sources[i].tx_execution_isr_count =  ((ULONG) 0);
+        _tx_execution_isr_sources[i].tx_execution_isr_time =  ((EXECUTION_TIME) 0);
+    }
+    _tx_execution_isr_time_total =  ((EXECUTION_TIME) 0);
+
+    TX_RESTORE
+
+    return(TX_SUCCESS);
+}
+
+
+/**************************************************************************/
+/*                                                                        */
+/*  FUNCTION                                               RELEASE        */
+/*                                                                        */
+/*    _tx_execution_idle_time_reset                       PORTABLE C      */
+/*                                                           6.4.0        */
+/*                                                                        */
+/*  DESCRIPTION                                                           */
+/*                                                                        */
+/*    This function clears the idle time.                                 */
+/*                                                                        */
+/*  INPUT                                                                 */
+/*                                                                        */
+/*    None                                                                */
+/*                                                                        */
+/*  OUTPUT                                                                */
+/*                                                                        */
+/*    status                                Completion status             */
+/*                                                                        */
+/*  CALLS                                                                 */
+/*                                                                        */
+/*    None                                                                */
+/*                                                                        */
+/*  CALLED BY                                                             */
+/*                                                                        */
+/*    Application Code                                                    */
+/*                                                                        */
+/*  RELEASE HISTORY                                                       */
+/*                                                                        */
+/*    DATE              NAME                      DESCRIPTION             */
+/*                                                                        */
+/*  10-19-2026                              Initial Version 6.4.0         */
+/*                                                                        */
+/**************************************************************************/
+UINT  _tx_execution_idle_time_reset(VOID)
+{
+
+TX_INTERRUPT_SAVE_AREA
+
+
+    TX_DISABLE
+    _tx_execution_idle_time_total =  ((EXECUTION_TIME) 0);
+    TX_RESTORE
+
+    return(TX_SUCCESS);
+}
+
+
+/**************************************************************************/
+/*                                                                        */
+/*  FUNCTION                                               RELEASE        */
+/*                                                                        */
+/*    _tx_execution_thread_time_get                       PORTABLE C      */
+/*                                                           6.4.0        */
+/*                                                                        */
+/*  DESCRIPTION                                                           */
+/*                                                                        */
+/*    This function returns the execution time of the specified thread,   */
+/*    including the slice in progress when the thread is the caller.      */
+/*                                                                        */
+/*  INPUT                                                                 */
+/*                                                                        */
+/*    thread_ptr                            Pointer to thread             */
+/*    total_time                            Destination for the time      */
+/*                                                                        */
+/*  OUTPUT                                                                */
+/*                                                                        */
+/*    status                                Completion status             */
+/*                                                                        */
+/*  CALLS                                                                 */
+/*                                                                        */
+/*    None                                                                */
+/*                                                                        */
+/*  CALLED BY                                                             */
+/*                                                                        */
+/*    Application Code                                                    */
+/*                                                                        */
+/*  RELEASE HISTORY                                                       */
+/*                                                                        */
+/*    DATE              NAME                      DESCRIPTION             */
+/*                                                                        */
+/*  10-19-2026                              Initial Version 6.4.0         */
+/*                                                                        */
+/**************************************************************************/
+UINT  _tx_execution_thread_time_get(TX_THREAD *thread_ptr, EXECUTION_TIME *total_time)
+{
+
+TX_INTERRUPT_SAVE_AREA
+
+EXECUTION_TIME  time;
+
+
+    if ((thread_ptr == TX_NULL) || (total_time == TX_NULL))
+    {
+        return(TX_PTR_ERROR);
+    }
+
+    TX_DISABLE
+
+    time =  thread_ptr -> tx_thread_execution_time_total;
+    if (thread_ptr == _tx_execution_thread_running)
+    {
+        time +=  (EXECUTION_TIME) (EXECUTION_TIME_SOURCE_TYPE) (TX_EXECUTION_TIME_SOURCE - thread_ptr -> tx_thread_execution_time_last_start);
+    }
+
+    TX_RESTORE
+
+    *total_time =  time;
+    return(TX_SUCCESS);
+}
+
+
+/**************************************************************************/
+/*                                                                        */
+/*  FUNCTION                                               RELEASE        */
+/*                                                                        */
+/*    _tx_execution_thread_total_time_get                 PORTABLE C      */
+/*                                                           6.4.0        */
+/*                                                                        */
+/*  DESCRIPTION                                                           */
+/*                                                                        */
+/*    This function returns the execution time of all threads, including  */
+/*    the slice in progress.                                              */
+/*                                                                        */
+/*  INPUT                                                                 */
+/*                                                                        */
+/*    total_time                            Destination for the time      */
+/*                                                                        */
+/*  OUTPUT                                                                */
+/*                                                                        */
+/*    status                                Completion status             */
+/*                                                                        */
+/*  CALLS                                                                 */
+/*                                                                        */
+/*    None                                                                */
+/*                                                                        */
+/*  CALLED BY                                                             */
+/*                                                                        */
+/*    Application Code                                                    */
+/*                                                                        */
+/*  RELEASE HISTORY                                                       */
+/*                                                                        */
+/*    DATE              NAME                      DESCRIPTION             */
+/*                                                                        */
+/*  10-19-2026                              Initial Version 6.4.0         */
+/*                                                                        */
+/**************************************************************************/
+UINT  _tx_execution_thread_total_time_get(EXECUTION_TIME *total_time)
+{
+
+TX_INTERRUPT_SAVE_AREA
+
+EXECUTION_TIME  time;
+TX_THREAD       *thread_ptr;
+
+
+    if (total_time == TX_NULL)
+    {
+        return(TX_PTR_ERROR);
+    }
+
+    TX_DISABLE
+
+    time =  _tx_execution_thread_time_total;
+    thread_ptr =  _tx_execution_thread_running;
+    if (thread_ptr != TX_NULL)
+    {
+        time +=  (EXECUTION_TIME) (EXECUTION_TIME_SOURCE_TYPE) (TX_EXECUTION_TIME_SOURCE - thread_ptr -> tx_thread_execution_time_last_start);
+    }
+
+    TX_RESTORE
+
+    *total_time =  time;
+    return(TX_SUCCESS);
+}
+
+
+/**************************************************************************/
+/*                                                                        */
+/*  FUNCTION                                               RELEASE        */
+/*                                                                        */
+/*    _tx_execution_isr_time_get                          PORTABLE C      */
+/*                                                           6.4.0        */
+/*                                                                        */
+/*  DESCRIPTION                                                           */
+/*                                                                        */
+/*    This function returns the time spent in interrupt service routines. */
+/*                                                                        */
+/*  INPUT                                                                 */
+/*                                                                        */
+/*    total_time                            Destination for the time      */
+/*                                                                        */
+/*  OUTPUT                                                                */
+/*                                                                        */
+/*    status                                Completion status             */
+/*                                                                        */
+/*  CALLS                                                                 */
+/*                                                                        */
+/*    None                                                                */
+/*                                                                        */
+/*  CALLED BY                                                             */
+/*                                                                        */
+/*    Application Code                                                    */
+/*                                                                        */
+/*  RELEASE HISTORY                                                       */
+/*                                                                        */
+/*    DATE              NAME                      DESCRIPTION             */
+/*                                                                        */
+/*  10-19-2026                              Initial Version 6.4.0         */
+/*                                                                        */
+/**************************************************************************/
+UINT  _tx_execution_isr_time_get(EXECUTION_TIME *total_time)
+{
+
+TX_INTERRUPT_SAVE_AREA
+
+
+    if (total_time == TX_NULL)
+    {
+        return(TX_PTR_ERROR);
+    }
+
+    TX_DISABLE
+    *total_time =  _tx_execution_isr_time_total;
+    TX_RESTORE
+
+    return(TX_SUCCESS);
+}
+
+
+/**************************************************************************/
+/*                                                                        */
+/*  FUNCTION                                               RELEASE        */
+/*                                                                        */
+/*    _tx_execution_idle_time_get                         PORTABLE C      */
+/*                                                           6.4.0        */
+/*                                                                        */
+/*  DESCRIPTION                                                           */
+/*                                                                        */
+/*    This function returns the time spent with no thread and no ISR      */
+/*    running.                                                            */
+/*                                                                        */
+/*  INPUT                                                                 */
+/*                                                                        */
+/*    total_time                            Destination for the time      */
+/*                                                                        */
+/*  OUTPUT                                                                */
+/*                                                                        */
+/*    status                                Completion status             */
+/*                                                                        */
+/*  CALLS                                                                 */
+/*                                                                        */
+/*    None                                                                */
+/*                                                                        */
+/*  CALLED BY                                                             */
+/*                                                                        */
+/*    Application Code                                                    */
+/*                                                                        */
+/*  RELEASE HISTORY                                                       */
+/*                                                                        */
+/*    DATE              NAME                      DESCRIPTION             */
+/*                                                                        */
+/*  10-19-2026                              Initial Version 6.4.0         */
+/*                                                                        */
+/**************************************************************************/
+UINT  _tx_execution_idle_time_get(EXECUTION_TIME *total_time)
+{
+
+TX_INTERRUPT_SAVE_AREA
+
+
+    if (total_time == TX_NULL)
+    {
+        return(TX_PTR_ERROR);
+    }
+
+    TX_DISABLE
+    *total_time =  _tx_execution_idle_time_total;
+    TX_RESTORE
+
+    return(TX_SUCCESS);
+}
+
+
+/**************************************************************************/
+/*                                                                        */
+/*  FUNCTION                                               RELEASE        */
+/*                                                                        */
+/*    _tx_execution_isr_source_get                        PORTABLE C      */
+/*                                                           6.4.0        */
+/*                                                                        */
+/*  DESCRIPTION                                                           */
+/*                                                                        */
+/*    This function returns a copy of an entry of the interrupt source    */
+/*    table.  Entries are numbered from 0 in the order the sources were   */
+/*    first seen.                                                         */
+/*                                                                        */
+/*  INPUT                                                                 */
+/*                                                                        */
+/*    index                                 Entry number                  */
+/*    isr_info                              Destination for the entry     */
+/*                                                                        */
+/*  OUTPUT                                                                */
+/*                                                                        */
+/*    status                                Completion status             */
+/*                                                                        */
+/*  CALLS                                                                 */
+/*                                                                        */
+/*    None                                                                */
+/*                                                                        */
+/*  CALLED BY                                                             */
+/*                                                                        */
+/*    Application Code                                                    */
+/*                                                                        */
+/*  RELEASE HISTORY                                                       */
+/*                                                                        */
+/*    DATE              NAME                      DESCRIPTION             */
+/*                                                                        */
+/*  10-19-2026                              Initial Version 6.4.0         */
+/*                                                                        */
+/**************************************************************************/
+UINT  _tx_execution_isr_source_get(UINT index, TX_EXECUTION_ISR *isr_info)
+{
+
+TX_INTERRUPT_SAVE_AREA
+
+UINT            status;
+
+
+    if (isr_info == TX_NULL)
+    {
+        return(TX_PTR_ERROR);
+    }
+
+    TX_DISABLE
+
+    if (index < _tx_execution_isr_sources_used)
+    {
+        *isr_info =  _tx_execution_isr_sources[index];
+        status =  TX_SUCCESS;
+    }
+    else
+    {
+        status =  TX_NOT_AVAILABLE;
+    }
+
+    TX_RESTORE
+
+    return(status);
+}
+
+#endif
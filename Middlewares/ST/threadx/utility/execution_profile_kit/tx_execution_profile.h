@@ -0,0 +1,139 @@
+/**************************************************************************/
+/*                                                                        */
+/*       Copyright (c) Microsoft Corporation. All rights reserved.        */
+/*                                                                        */
+/*       This software is licensed under the Microsoft Software License   */
+/*       Terms for Microsoft Azure RTOS. Full text of the license can be  */
+/*       found in the LICENSE file at https://aka.ms/AzureRTOS_EULA       */
+/*       and in the root directory of this software.                      */
+/*                                                                        */
+/**************************************************************************/
+
+
+/**************************************************************************/
+/**************************************************************************/
+/**                                                                       */
+/** ThreadX Component                                                     */
+/**                                                                       */
+/**   Execution Profile Kit                                               */
+/**                                                                       */
+/**************************************************************************/
+/**************************************************************************/
+
+
+/**************************************************************************/
+/*                                                                        */
+/*  COMPONENT DEFINITION                                   RELEASE        */
+/*                                                                        */
+/*    tx_execution_profile.h                              PORTABLE C      */
+/*                                                           6.4.0        */
+/*                                                                        */
+/*  DESCRIPTION                                                           */
+/*                                                                        */
+/*    This file defines the execution profile kit, which accumulates the  */
+/*    time spent in each thread, in interrupt service routines (in total  */
+/*    and per interrupt source) and idle.  The kit is called from the     */
+/*    port scheduler and ISR entry/exit code when TX_EXECUTION_PROFILE_   */
+/*    ENABLE is defined.  tx_api.h includes this file ahead of the thread */
+/*    control block, which then carries the per-thread totals.            */
+/*                                                                        */
+/*    Times are in units of TX_EXECUTION_TIME_SOURCE, the DWT cycle       */
+/*    counter on Cortex-M.  The source is sampled at least once per timer */
+/*    tick, so a 32-bit counter only has to cover one tick.  Nested       */
+/*    interrupts are charged to the outermost interrupt source.           */
+/*                                                                        */
+/*  RELEASE HISTORY                                                       */
+/*                                                                        */
+/*    DATE              NAME                      DESCRIPTION             */
+/*                                                                        */
+/*  10-19-2026                              Initial Version 6.4.0         */
+/*                                                                        */
+/**************************************************************************/
+
+#ifndef TX_EXECUTION_PROFILE_H
+#define TX_EXECUTION_PROFILE_H
+
+
+/* Define the execution time types. Totals are 64-bit; the time source is
+   sampled in EXECUTION_TIME_SOURCE_TYPE and differences are taken modulo its
+   width.  */
+
+typedef ULONG64                             EXECUTION_TIME;
+
+#ifndef TX_EXECUTION_TIME_SOURCE_TYPE_DEFINED
+typedef ULONG                               EXECUTION_TIME_SOURCE_TYPE;
+#endif
+
+
+/* Define the time source. By default this is the Cortex-M DWT cycle counter,
+   which is enabled by _tx_execution_initialize.  */
+
+#ifndef TX_EXECUTION_TIME_SOURCE
+#define TX_EXECUTION_TIME_SOURCE            ((EXECUTION_TIME_SOURCE_TYPE) *((volatile ULONG *) 0xE0001004))
+#endif
+
+#ifndef TX_EXECUTION_TIME_SOURCE_ENABLE
+#define TX_EXECUTION_TIME_SOURCE_ENABLE()   {                                                                   \
+                                                *((volatile ULONG *) 0xE000EDFC) |=  ((ULONG) 0x01000000);      \
+                                                *((volatile ULONG *) 0xE0001004) =   ((ULONG) 0);               \
+                                                *((volatile ULONG *) 0xE0001000) |=  ((ULONG) 1);               \
+                                            }
+#endif
+
+
+/* Define how the current interrupt source is identified. On Cortex-M this is
+   the active exception number (IPSR): 15 is SysTick, 16 + n is IRQn.  */
+
+#ifndef TX_EXECUTION_ISR_ID
+#if defined(__ARM_ARCH_PROFILE) && (__ARM_ARCH_PROFILE == 'M')
+#define TX_EXECUTION_ISR_ID()               ((ULONG) _tx_ipsr_get())
+#else
+#define TX_EXECUTION_ISR_ID()               ((ULONG) 0)
+#endif
+#endif
+
+
+/* Define the number of interrupt sources tracked individually. Sources seen
+   after the table is full are accumulated in the last entry, whose ID is then
+   TX_EXECUTION_ISR_ID_OTHER.  */
+
+#ifndef TX_EXECUTION_ISR_SOURCES
+#define TX_EXECUTION_ISR_SOURCES            16
+#endif
+
+#define TX_EXECUTION_ISR_ID_OTHER           ((ULONG) 0xFFFFFFFF)
+
+
+/* Define the per interrupt source record.  */
+
+typedef struct TX_EXECUTION_ISR_STRUCT
+{
+    ULONG                                   tx_execution_isr_id;
+    ULONG                                   tx_execution_isr_count;
+    EXECUTION_TIME                          tx_execution_isr_time;
+} TX_EXECUTION_ISR;
+
+
+/* Define the kit entry points called by the port.  */
+
+VOID    _tx_execution_initialize(VOID);
+VOID    _tx_execution_thread_enter(VOID);
+VOID    _tx_execution_thread_exit(VOID);
+VOID    _tx_execution_isr_enter(VOID);
+VOID    _tx_execution_isr_exit(VOID);
+
+
+/* Define the application services.  */
+
+UINT    _tx_execution_thread_time_reset(struct TX_THREAD_STRUCT *thread_ptr);
+UINT    _tx_execution_thread_total_time_reset(VOID);
+UINT    _tx_execution_isr_time_reset(VOID);
+UINT    _tx_execution_idle_time_reset(VOID);
+
+UINT    _tx_execution_thread_time_get(struct TX_THREAD_STRUCT *thread_ptr, EXECUTION_TIME *total_time);
+UINT    _tx_execution_thread_total_time_get(EXECUTION_TIME *total_time);
+UINT    _tx_execution_isr_time_get(EXECUTION_TIME *total_time);
+UINT    _tx_execution_idle_time_get(EXECUTION_TIME *total_time);
+UINT    _tx_execution_isr_source_get(UINT index, TX_EXECUTION_ISR *isr_info);
+
+#endif
@@ -104,6 +104,11 @@ functions
 
 /* include basic support */
 
+/* OS_DISABLE_NATIVE_ATOMIC (see os_config.h) skips all native headers, so
+ * os_atomic_* fall back to the lock-striped implementation in
+ * generic_atomic.c. */
+#ifndef OS_DISABLE_NATIVE_ATOMIC
+
 /* use InterlockedXXX win32 API (available both for NT & CE) */
 
 #if defined(OS_WIN32)
@@ -123,6 +128,11 @@ functions
 #   include "ittia/os/atomic/atomic_arm_linux.h"
 #endif
 
+#if defined(__GNUC__) && defined(__ATOMIC_SEQ_CST)
+   /* gcc 4.7 has C11 memory model builtins, preferred over inline asm */
+#   include "ittia/os/atomic/atomic_gcc_builtin.h"
+#endif
+
 #if defined(__GNUC__) && defined(OS_CPU_X86)
 #   include "ittia/os/atomic/atomic_x86_gcc.h"
 #endif
@@ -132,6 +142,8 @@ functions
 #   include "ittia/os/atomic/atomic_gcc4.h"
 #endif
 
+#endif /* OS_DISABLE_NATIVE_ATOMIC */
+
 /* complement support */
 
 /* in case some specific functions missed */
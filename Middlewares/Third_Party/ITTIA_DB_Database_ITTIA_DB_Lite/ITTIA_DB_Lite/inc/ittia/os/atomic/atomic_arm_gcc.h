@@ -309,6 +309,32 @@ os_atomic_native_exch( os_AtomicValue * ptr,
     return curval;
 }
 
+#if OS_CPU_LEN == 32
+/* pointers are word sized, so the same exclusive monitor sequence applies.
+ * Without it generic_atomic.c keeps its 32 striped mutexes alive just to
+ * serve os_atomic_cas_ptr(). */
+#define OS_HAVE_ATOMIC_CAS_PTR  ATOMIC_IPC
+C_INLINE_DECL db_bool_t
+os_atomic_native_cas_ptr( void ** ptr,
+                          void * oldval,
+                          void * newval )
+{
+    void * curval;
+    int status;
+    _os_asm_label("os_atomic_native_cas_ptr");
+    do {
+        _os_ldrex( ptr, curval );
+        if (curval != oldval) {
+            _os_clrex( ptr, curval );
+            return DB_FALSE;
+        }
+        _os_strex( ptr, newval, status );
+    } while( status );
+    _os_asm_label("end of os_atomic_native_cas_ptr");
+    return DB_TRUE;
+}
+#endif /* OS_CPU_LEN == 32 */
+
 #undef _os_ldrex
 #undef _os_strex
 #undef _os_clrex
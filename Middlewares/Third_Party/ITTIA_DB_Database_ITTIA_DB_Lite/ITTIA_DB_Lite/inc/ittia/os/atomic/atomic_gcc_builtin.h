@@ -0,0 +1,126 @@
+/**************************************************************************/
+/*                                                                        */
+/*      Copyright (c) 2005-2023 by ITTIA L.L.C. All rights reserved.      */
+/*                                                                        */
+/*  This software is copyrighted by and is the sole property of ITTIA     */
+/*  L.L.C.  All rights, title, ownership, or other interests in the       */
+/*  software remain the property of ITTIA L.L.C.  This software may only  */
+/*  be used in accordance with the corresponding license agreement.  Any  */
+/*  unauthorized use, duplication, transmission, distribution, or         */
+/*  disclosure of this software is expressly forbidden.                   */
+/*                                                                        */
+/*  This Copyright notice may not be removed or modified without prior    */
+/*  written consent of ITTIA L.L.C.                                       */
+/*                                                                        */
+/*  ITTIA L.L.C. reserves the right to modify this software without       */
+/*  notice.                                                               */
+/*                                                                        */
+/*  info@ittia.com                                                        */
+/*  https://www.ittia.com                                                 */
+/*                                                                        */
+/*                                                                        */
+/**************************************************************************/
+
+#ifndef ATOMIC_GCC_BUILTIN_H
+#define ATOMIC_GCC_BUILTIN_H
+
+/* === gcc 4.7 __atomic builtin support (C11 memory model) === */
+
+/* - preferred over the legacy __sync builtins from atomic_gcc4.h and the
+ *   inline assembly from atomic_x86_gcc.h: the compiler picks the cheapest
+ *   instruction sequence for the target and knows the memory ordering.
+ *
+ * - excluding ARM: Cortex-M targets use LDREX/STREX from atomic_arm_gcc.h,
+ *   so the generated code does not depend on libatomic being linked in.
+ */
+
+#if defined(__GNUC__) && !defined(OS_CPU_ARM) && !defined(OS_VXWORKS) \
+    && defined(__ATOMIC_SEQ_CST) && defined(__GCC_ATOMIC_INT_LOCK_FREE) \
+    && (__GCC_ATOMIC_INT_LOCK_FREE == 2)
+
+#define OS_HAVE_ATOMIC
+
+#ifndef OS_HAVE_ATOMIC_VALUE
+
+#define OS_HAVE_ATOMIC_VALUE
+#define OS_ATOMIC_NATIVE_INIT(x) (x)
+#define OS_ATOMIC_NATIVE_CTOR(x) (x)
+typedef int    os_AtomicValue;
+
+#endif /* OS_HAVE_ATOMIC_VALUE */
+
+#ifndef OS_HAVE_ATOMIC_FETCH
+#   define OS_HAVE_ATOMIC_FETCH         ATOMIC_IPC
+#   define os_atomic_native_fetch(ptr)  __atomic_load_n(ptr, __ATOMIC_ACQUIRE)
+#   define os_atomic_native_fetch_lk(ptr) (*(os_AtomicValue*)(ptr))
+#endif
+
+#ifndef OS_HAVE_ATOMIC_STORE
+#   define OS_HAVE_ATOMIC_STORE         ATOMIC_IPC
+#   define os_atomic_native_store(ptr, newval) __atomic_store_n(ptr, newval, __ATOMIC_RELEASE)
+#   define os_atomic_native_store_lk(ptr, newval) (*(os_AtomicValue*)(ptr) = (newval))
+#endif
+
+#ifndef OS_HAVE_ATOMIC_CAS
+#   define OS_HAVE_ATOMIC_CAS           ATOMIC_IPC
+
+C_INLINE_DECL db_bool_t
+os_atomic_native_cas( os_AtomicValue * ptr,
+                      os_AtomicValue oldval,
+                      os_AtomicValue newval )
+{
+    return __atomic_compare_exchange_n(ptr, &oldval, newval, 0,
+                                       __ATOMIC_SEQ_CST, __ATOMIC_RELAXED)
+        ? DB_TRUE : DB_FALSE;
+}
+#endif
+
+#ifndef OS_HAVE_ATOMIC_ADD
+#   define OS_HAVE_ATOMIC_ADD           ATOMIC_IPC
+#   define os_atomic_native_add(ptr, addval) __atomic_add_fetch(ptr, addval, __ATOMIC_SEQ_CST)
+#endif
+
+#ifndef OS_HAVE_ATOMIC_INC
+#   define OS_HAVE_ATOMIC_INC           ATOMIC_IPC
+#   define os_atomic_native_inc(ptr)    __atomic_add_fetch(ptr, 1, __ATOMIC_SEQ_CST)
+#endif
+
+#ifndef OS_HAVE_ATOMIC_DEC
+#   define OS_HAVE_ATOMIC_DEC           ATOMIC_IPC
+#   define os_atomic_native_dec(ptr)    __atomic_sub_fetch(ptr, 1, __ATOMIC_SEQ_CST)
+#endif
+
+#ifndef OS_HAVE_ATOMIC_EXCH
+#   define OS_HAVE_ATOMIC_EXCH          ATOMIC_IPC
+#   define os_atomic_native_exch(ptr, newval) __atomic_exchange_n(ptr, newval, __ATOMIC_SEQ_CST)
+#endif
+
+#ifndef OS_HAVE_ATOMIC_TRYLOCK
+#   define OS_HAVE_ATOMIC_TRYLOCK       ATOMIC_IPC
+#   define os_atomic_native_trylock(ptr) (__atomic_exchange_n(ptr, 1, __ATOMIC_ACQUIRE) == 0)
+#   define os_atomic_native_unlock(ptr)  __atomic_store_n(ptr, 0, __ATOMIC_RELEASE)
+#   define os_atomic_native_unlock_lk(ptr) (*(ptr) = 0)
+#endif
+
+#ifndef OS_HAVE_ATOMIC_DMB
+#   define OS_HAVE_ATOMIC_DMB           ATOMIC_IPC
+#   define os_atomic_native_dmb()       __atomic_thread_fence(__ATOMIC_SEQ_CST)
+#endif
+
+#if !defined(OS_HAVE_ATOMIC_CAS_PTR) && (__GCC_ATOMIC_POINTER_LOCK_FREE == 2)
+#   define OS_HAVE_ATOMIC_CAS_PTR       ATOMIC_IPC
+
+C_INLINE_DECL db_bool_t
+os_atomic_native_cas_ptr( void ** ptr,
+                          void * oldval,
+                          void * newval )
+{
+    return __atomic_compare_exchange_n(ptr, &oldval, newval, 0,
+                                       __ATOMIC_SEQ_CST, __ATOMIC_RELAXED)
+        ? DB_TRUE : DB_FALSE;
+}
+#endif
+
+#endif /* gcc __atomic builtins */
+
+#endif /* ATOMIC_GCC_BUILTIN_H */
@@ -37,6 +37,8 @@
 #   include "ittia/os/vxworks/vxworks_cv.h"
 #elif defined(HAVE_POSIX_CONDVAR)
 #   include "ittia/os/posix/posix_cv.h"
+#elif defined(HAVE_THREADX_CONDVAR)
+#   include "ittia/os/threadx/threadx_cv.h"
 #elif defined(HAVE_GENERIC_CONDVAR)
 #   include "ittia/os/generic/generic_cv.h"
 #endif 
@@ -215,7 +215,17 @@
 #   define HAVE_GENERIC_TLS
 #   define HAVE_GENERIC_RWLOCK
 #   define HAVE_GENERIC_BARRIER
-#   define HAVE_GENERIC_CONDVAR
+/* The semaphore-based generic_cv is the default (OS_THREADX_GENERIC_CONDVAR).
+ * Define OS_THREADX_NATIVE_CONDVAR to use the waiter list of threadx_cv.c
+ * instead. */
+#   if !defined(OS_THREADX_NATIVE_CONDVAR) && !defined(OS_THREADX_GENERIC_CONDVAR)
+#       define OS_THREADX_GENERIC_CONDVAR
+#   endif
+#   ifdef OS_THREADX_GENERIC_CONDVAR
+#       define HAVE_GENERIC_CONDVAR
+#   else
+#       define HAVE_THREADX_CONDVAR
+#   endif
 #   define HAVE_GENERIC_FASTLOCK
 #ifdef OS_WIN32
 #   define HAVE_WIN32_ATOMIC
@@ -387,6 +397,23 @@
 #	error "threads misconfigured"
 #endif
 
+/* Atomic operations.
+ *
+ * With HAVE_GENERIC_ATOMIC, os_atomic_* are inlined to the native
+ * implementation whenever atomic/atomic.h reports the full set of
+ * OS_HAVE_ATOMIC_* capabilities (LDREX/STREX on ARMv6 and later, gcc
+ * __atomic builtins on hosts). Only when a capability is missing does
+ * generic_atomic.c emulate it with GENERIC_ATOMIC_LOCK_COUNT striped locks
+ * chosen by GENERIC_ATOMIC_USE_*.
+ *
+ * Define OS_DISABLE_NATIVE_ATOMIC to force the lock-striped fallback, e.g.
+ * to compare both implementations or on a core without exclusive access.
+ */
+#if defined(OS_DISABLE_NATIVE_ATOMIC) && !defined(HAVE_GENERIC_ATOMIC) \
+    && defined(HAVE_THREADS)
+#	error "OS_DISABLE_NATIVE_ATOMIC requires HAVE_GENERIC_ATOMIC"
+#endif
+
 /* Processor architecture settings */
 /* GHS defines __ARM. */
 #if defined(ARM) || defined(__ARM) || defined(__ARM__) || defined(__arm__) \
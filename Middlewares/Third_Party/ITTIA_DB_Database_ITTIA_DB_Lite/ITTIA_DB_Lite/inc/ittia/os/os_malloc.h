@@ -40,6 +40,14 @@ C_HEADER_BEGIN
 #   define DB_MEMTRACE
 #endif
 
+/* The allocation-site profiler keeps its bookkeeping in the DB_MEMTRACE
+ * block header. */
+#ifdef DB_MEMPROFILE
+#   ifndef DB_MEMTRACE
+#       define DB_MEMTRACE
+#   endif
+#endif
+
 #define DB_UNKNOWN_MEMBLOCK     0
 #define DB_FREE_MEMBLOCK        1
 #define DB_DELAYFREE_MEMBLOCK   2
@@ -149,6 +157,41 @@ long os_hmemory_used(void);
 
 #endif /* DB_MEMTRACE */
 
+#ifdef DB_MEMPROFILE
+
+/* Number of distinct allocation sites tracked; must be a power of two.
+ * Sites beyond this are accumulated in one overflow entry. */
+#ifndef DB_MEMPROFILE_SITES
+#   define DB_MEMPROFILE_SITES  128
+#endif
+
+/* Block kinds tracked separately: DB_UNKNOWN_MEMBLOCK..DB_NEWARR_MEMBLOCK. */
+#define DB_MEMPROFILE_KINDS     8
+
+typedef struct db_mem_site_t {
+    const char * file;        /**< Source file, or NULL if the caller did not pass one. */
+    const void * caller;      /**< Return address of the allocating call; resolve with addr2line when file is NULL. */
+    int          line;        /**< Source line, or 0. */
+    int          block_kind;  /**< DB_*_MEMBLOCK of the site; -1 for the overflow entry. */
+    os_atomic_t  live_bytes;  /**< Bytes currently allocated from this site. */
+    os_atomic_t  peak_bytes;  /**< Peak of live_bytes. */
+    os_atomic_t  live_blocks; /**< Blocks currently allocated from this site. */
+    os_atomic_t  calls;       /**< Number of successful allocations from this site. */
+} db_mem_site_t;
+
+/* Copy site @p index (0..DB_MEMPROFILE_SITES, the last one being the
+ * overflow entry). Returns 1 if the site is in use, 0 if it is empty and
+ * DB_EINVAL past the end of the table. */
+DBDLL_API int db_mem_profile_site(int index, db_mem_site_t * site);
+
+/* Copy the totals for one block kind. Returns DB_EINVAL for an unknown kind. */
+DBDLL_API int db_mem_profile_kind(int block_kind, db_mem_site_t * site);
+
+/* Restart call counts and peaks; live bytes and blocks are kept. */
+DBDLL_API void db_mem_profile_reset(void);
+
+#endif /* DB_MEMPROFILE */
+
 C_HEADER_END
 
 
@@ -0,0 +1,66 @@
+/**************************************************************************/
+/*                                                                        */
+/*      Copyright (c) 2005-2023 by ITTIA L.L.C. All rights reserved.      */
+/*                                                                        */
+/*  This software is copyrighted by and is the sole property of ITTIA     */
+/*  L.L.C.  All rights, title, ownership, or other interests in the       */
+/*  software remain the property of ITTIA L.L.C.  This software may only  */
+/*  be used in accordance with the corresponding license agreement.  Any  */
+/*  unauthorized use, duplication, transmission, distribution, or         */
+/*  disclosure of this software is expressly forbidden.                   */
+/*                                                                        */
+/*  This Copyright notice may not be removed or modified without prior    */
+/*  written consent of ITTIA L.L.C.                                       */
+/*                                                                        */
+/*  ITTIA L.L.C. reserves the right to modify this software without       */
+/*  notice.                                                               */
+/*                                                                        */
+/*  info@ittia.com                                                        */
+/*  https://www.ittia.com                                                 */
+/*                                                                        */
+/*                                                                        */
+/**************************************************************************/
+
+#ifndef THREADX_CV_H
+#define THREADX_CV_H
+
+#include "ittia/os/os_config.h"
+
+#if defined(HAVE_THREADS) && defined(HAVE_THREADX_CONDVAR)
+
+#include "ittia/os/os_mutex.h"
+#include "ittia/os/os_wait_time.h"
+#include "ittia/os/threadx/threadx_thread.h"
+
+C_HEADER_BEGIN
+
+/* Waiter record. Lives on the stack of the waiting thread for the duration
+ * of os_cond_wait() and is linked into the condition variable's FIFO. */
+typedef struct os_cond_waiter_t os_cond_waiter_t;
+
+struct os_cond_waiter_t
+{
+    os_cond_waiter_t * next;
+    TX_THREAD        * thread;
+    volatile UINT      signaled;
+    volatile UINT      sleeping;
+};
+
+/* The waiter list is only touched with interrupts disabled, so no kernel
+ * object is needed. The structure is smaller than the generic_cv.h
+ * layout, so storage reserved by code built against it remains large
+ * enough. */
+typedef struct os_cond_t os_cond_t;
+
+struct os_cond_t
+{
+    int                state;
+    os_cond_waiter_t * head;
+    os_cond_waiter_t * tail;
+};
+
+C_HEADER_END
+
+#endif /* HAVE_THREADX_CONDVAR */
+
+#endif /* THREADX_CV_H */
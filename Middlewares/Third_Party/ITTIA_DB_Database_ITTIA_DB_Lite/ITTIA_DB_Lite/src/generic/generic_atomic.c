@@ -252,4 +252,15 @@ os_atomic_cas_ptr(void ** p, void * old_value, void * new_value)
 
 #endif /* OS_HAVE_ATOMIC */
 
+#if defined(OS_HAVE_ATOMIC) && defined(OS_HAVE_ATOMIC_CAS_PTR)
+/* os_atomic_cas_ptr() is inlined by generic_atomic.h, but objects built
+ * without the native implementation (such as the prebuilt ITTIA DB
+ * library) still link against the out-of-line symbol. */
+DBDLL_API int
+(os_atomic_cas_ptr)(void ** p, void * old_value, void * new_value)
+{
+    return os_atomic_native_cas_ptr(p, old_value, new_value);
+}
+#endif
+
 #endif /* HAVE_GENERIC_ATOMIC */
@@ -50,6 +50,11 @@
 #   undef DB_MEMDEBUG
 #endif
 
+/* the profiler needs the DB_MEMTRACE block header */
+#if defined(DB_MEMDEBUG) && defined(DB_MEMPROFILE)
+#   undef DB_MEMDEBUG
+#endif
+
 #ifdef DB_MEMTRACE
 static db_mem_trace_t mem_trace = { 0, 0, 0, 0 };
 static os_atomic_t cur_memory_count = 0;
@@ -241,6 +246,23 @@ free_mem(void * ptr)
     memset(ptr, 0xce, size + OVERHEAD);
 }
 
+#elif defined(DB_MEMPROFILE)
+
+/* size first, so get_rptr_size() works as for plain DB_MEMTRACE */
+typedef struct mem_prof_hdr_t
+{
+    size_t   size;
+    uint16_t site;
+    uint16_t kind;
+} mem_prof_hdr_t;
+
+#   define OVERHEAD \
+        ((sizeof(mem_prof_hdr_t) + sizeof(db_AlignType) - 1) / sizeof(db_AlignType) * sizeof(db_AlignType))
+#   define uptr2rptr(ptr)             (void*)((char*)(ptr) - OVERHEAD)
+#   define rptr2uptr(ptr)             (void*)((char*)(ptr) + OVERHEAD)
+#   define set_rptr_size(rptr, size) (((mem_prof_hdr_t*)(rptr))->size = (size))
+#   define get_rptr_size(rptr)       (((mem_prof_hdr_t*)(rptr))->size)
+
 #elif defined(DB_MEMTRACE)
 
 #   define OVERHEAD sizeof(double)  /* just something restrictive */
@@ -257,6 +279,205 @@ free_mem(void * ptr)
 
 #endif
 
+#ifdef DB_MEMPROFILE
+
+/*
+ * Allocation-site profiler.
+ *
+ * Sites are keyed by (file, line, block kind) and, since release builds
+ * pass no file, by the return address of the allocating call. They live
+ * in a fixed open-addressing table so the profiler itself never
+ * allocates. A slot is claimed with a CAS on its state and never released,
+ * so lookups need no lock. Two threads hitting a new site at the same
+ * moment may rarely produce two entries for it.
+ *
+ * Each block header records its site and kind, which lets the free be
+ * charged to the site that made the allocation.
+ */
+
+#if (DB_MEMPROFILE_SITES & (DB_MEMPROFILE_SITES - 1)) != 0 || DB_MEMPROFILE_SITES >= 0xFFFF
+#   error "DB_MEMPROFILE_SITES must be a power of two below 65535"
+#endif
+
+#define MEM_PROF_SLOT_FREE      0
+#define MEM_PROF_SLOT_CLAIMED   1
+#define MEM_PROF_SLOT_READY     2
+
+#define MEM_PROF_OVERFLOW       DB_MEMPROFILE_SITES
+
+#if defined(__GNUC__)
+#   define MEM_PROF_CALLER()    __builtin_return_address(0)
+#else
+#   define MEM_PROF_CALLER()    NULL
+#endif
+
+typedef struct mem_prof_slot_t
+{
+    os_atomic_t   state;
+    db_mem_site_t site;
+} mem_prof_slot_t;
+
+/* the last slot collects sites that did not fit */
+static mem_prof_slot_t mem_prof_sites[DB_MEMPROFILE_SITES + 1];
+static db_mem_site_t mem_prof_kinds[DB_MEMPROFILE_KINDS];
+
+static C_INLINE_SPECIFIER int
+mem_prof_kind_index(int block_kind)
+{
+    return (unsigned)block_kind < DB_MEMPROFILE_KINDS ? block_kind : DB_UNKNOWN_MEMBLOCK;
+}
+
+static unsigned
+mem_prof_lookup(const char * file, int line, int block_kind, const void * caller)
+{
+    const void * key = file != NULL ? (const void *)file : caller;
+    uint32_t h;
+    unsigned probe = 0;
+
+    /* no file means no line either, so the key is the caller alone */
+    if (file == NULL)
+        line = 0;
+    else
+        caller = NULL;
+
+    h = (uint32_t)((uintptr_t)key >> 1);
+    h ^= (uint32_t)line * 2654435761u;
+    h ^= (uint32_t)block_kind * 40503u;
+    h ^= h >> 15;
+    h &= DB_MEMPROFILE_SITES - 1;
+
+    while (probe < DB_MEMPROFILE_SITES) {
+        mem_prof_slot_t * slot = &mem_prof_sites[h];
+        os_atomic_t state = os_atomic_fetch(&slot->state);
+
+        if (state == MEM_PROF_SLOT_FREE) {
+            if (os_atomic_cas(&slot->state, MEM_PROF_SLOT_FREE, MEM_PROF_SLOT_CLAIMED)) {
+                slot->site.file = file;
+                slot->site.caller = caller;
+                slot->site.line = line;
+                slot->site.block_kind = block_kind;
+                os_atomic_store(&slot->state, MEM_PROF_SLOT_READY);
+                return h;
+            }
+            /* lost the race; look at the same slot again */
+            continue;
+        }
+
+        if (state == MEM_PROF_SLOT_READY
+            && slot->site.file == file
+            && slot->site.caller == caller
+            && slot->site.line == line
+            && slot->site.block_kind == block_kind)
+            return h;
+
+        h = (h + 1) & (DB_MEMPROFILE_SITES - 1);
+        ++probe;
+    }
+
+    return MEM_PROF_OVERFLOW;
+}
+
+static void
+mem_prof_charge(db_mem_site_t * site, size_t size)
+{
+    /* note: peak_bytes is not calculated atomically because slight inaccuracy is permissible. */
+    os_atomic_t live = os_atomic_add(&site->live_bytes, (os_atomic_t)size);
+    if (live > os_atomic_fetch(&site->peak_bytes))
+        os_atomic_store(&site->peak_bytes, live);
+    os_atomic_inc(&site->live_blocks);
+    os_atomic_inc(&site->calls);
+}
+
+static void
+mem_prof_credit(db_mem_site_t * site, size_t size)
+{
+    os_atomic_add(&site->live_bytes, -(os_atomic_t)size);
+    os_atomic_dec(&site->live_blocks);
+}
+
+/* record a new block in its header and charge it to the site */
+static void
+mem_prof_attach(void * rptr, size_t size, const char * file, int line, int block_kind, const void * caller)
+{
+    mem_prof_hdr_t * hdr = (mem_prof_hdr_t *)rptr;
+    int kind = mem_prof_kind_index(block_kind);
+    unsigned site = mem_prof_lookup(file, line, block_kind, caller);
+
+    hdr->site = (uint16_t)site;
+    hdr->kind = (uint16_t)kind;
+
+    mem_prof_charge(&mem_prof_sites[site].site, size);
+    mem_prof_charge(&mem_prof_kinds[kind], size);
+}
+
+static void
+mem_prof_detach(unsigned site, unsigned kind, size_t size)
+{
+    mem_prof_credit(&mem_prof_sites[site].site, size);
+    mem_prof_credit(&mem_prof_kinds[kind], size);
+}
+
+static void
+mem_prof_copy(db_mem_site_t * dst, const db_mem_site_t * src)
+{
+    dst->file = src->file;
+    dst->caller = src->caller;
+    dst->line = src->line;
+    dst->block_kind = src->block_kind;
+    dst->live_bytes = os_atomic_fetch((os_atomic_t *)&src->live_bytes);
+    dst->peak_bytes = os_atomic_fetch((os_atomic_t *)&src->peak_bytes);
+    dst->live_blocks = os_atomic_fetch((os_atomic_t *)&src->live_blocks);
+    dst->calls = os_atomic_fetch((os_atomic_t *)&src->calls);
+}
+
+DBDLL_API int db_mem_profile_site(int index, db_mem_site_t * site)
+{
+    if (index < 0 || index > MEM_PROF_OVERFLOW)
+        return DB_EINVAL;
+
+    if (index == MEM_PROF_OVERFLOW) {
+        mem_prof_copy(site, &mem_prof_sites[index].site);
+        site->block_kind = -1;
+        return site->calls != 0 || site->live_blocks != 0;
+    }
+
+    if (os_atomic_fetch(&mem_prof_sites[index].state) != MEM_PROF_SLOT_READY)
+        return 0;
+
+    mem_prof_copy(site, &mem_prof_sites[index].site);
+    return 1;
+}
+
+DBDLL_API int db_mem_profile_kind(int block_kind, db_mem_site_t * site)
+{
+    if ((unsigned)block_kind >= DB_MEMPROFILE_KINDS)
+        return DB_EINVAL;
+
+    mem_prof_copy(site, &mem_prof_kinds[block_kind]);
+    site->block_kind = block_kind;
+    return DB_NOERROR;
+}
+
+DBDLL_API void db_mem_profile_reset(void)
+{
+    int i;
+
+    for (i = 0; i <= MEM_PROF_OVERFLOW; ++i) {
+        db_mem_site_t * site = &mem_prof_sites[i].site;
+        os_atomic_store(&site->calls, 0);
+        os_atomic_store(&site->peak_bytes, os_atomic_fetch(&site->live_bytes));
+    }
+    for (i = 0; i < DB_MEMPROFILE_KINDS; ++i) {
+        db_mem_site_t * site = &mem_prof_kinds[i];
+        os_atomic_store(&site->calls, 0);
+        os_atomic_store(&site->peak_bytes, os_atomic_fetch(&site->live_bytes));
+    }
+}
+
+#else
+#   define MEM_PROF_CALLER()    NULL
+#endif /* DB_MEMPROFILE */
+
 #if defined (_MSC_VER) && defined(_DEBUG)
 #   include <crtdbg.h>
 #   define std_malloc(size, file, line)         _malloc_dbg(size, _NORMAL_BLOCK, file, line)
@@ -457,7 +678,7 @@ void * mapusoft_realloc(VOID* ptr, UNSIGNED nBytes)
 }
 #endif
 
-void * _db_malloc(db_size_t size, const char * file, int line, int block_kind)
+static void * db_malloc_at(db_size_t size, const char * file, int line, int block_kind, const void * caller)
 {
     uint8_t * rptr;
 
@@ -502,6 +723,12 @@ void * _db_malloc(db_size_t size, const char * file, int line, int block_kind)
     os_memory_account(size, 0);
 #endif
 
+#ifdef DB_MEMPROFILE
+    mem_prof_attach( rptr, size, file, line, block_kind, caller );
+#else
+    DB_UNUSED(caller);
+#endif
+
     DB_ASSERT( (uintptr_t) rptr2uptr( rptr ) % sizeof(db_AlignType) == 0 );
 
     DB_TRACE_OUTPUT(( file, line, DB_TRACE_HEAP, "%lu: malloc(%d): %p", opno, size, rptr ));
@@ -509,6 +736,11 @@ void * _db_malloc(db_size_t size, const char * file, int line, int block_kind)
     return rptr2uptr( rptr );
 }
 
+void * _db_malloc(db_size_t size, const char * file, int line, int block_kind)
+{
+    return db_malloc_at(size, file, line, block_kind, MEM_PROF_CALLER());
+}
+
 void * _db_realloc(void * orig_ptr, db_size_t size, const char * file, int line, int block_kind)
 {
     void * rptr = orig_ptr ? uptr2rptr( orig_ptr ) : NULL;
@@ -517,6 +749,11 @@ void * _db_realloc(void * orig_ptr, db_size_t size, const char * file, int line,
 #ifdef DB_MEMTRACE
     size_t block_size = (rptr) ? get_rptr_size( rptr ) : 0;
 #endif
+#ifdef DB_MEMPROFILE
+    /* the header is gone once the block moves */
+    unsigned block_site = (rptr) ? ((mem_prof_hdr_t*)rptr)->site : 0;
+    unsigned block_kind_index = (rptr) ? ((mem_prof_hdr_t*)rptr)->kind : 0;
+#endif
 
     unsigned long opno = check_request();
 
@@ -562,6 +799,11 @@ void * _db_realloc(void * orig_ptr, db_size_t size, const char * file, int line,
         os_atomic_inc(&mem_trace.malloc_count);
 #endif
 
+#ifdef DB_MEMPROFILE
+    if (rptr != NULL)
+        mem_prof_detach(block_site, block_kind_index, block_size);
+#endif
+
     if (resptr == NULL)
         return NULL;
 
@@ -575,6 +817,10 @@ void * _db_realloc(void * orig_ptr, db_size_t size, const char * file, int line,
     os_memory_account(size, block_size);
 #endif
 
+#ifdef DB_MEMPROFILE
+    mem_prof_attach( resptr, size, file, line, block_kind, MEM_PROF_CALLER() );
+#endif
+
     DB_ASSERT( (uintptr_t) rptr2uptr( resptr ) % sizeof(db_AlignType) == 0 );
 
     DB_TRACE_OUTPUT(( file, line, DB_TRACE_HEAP, "%lu: remalloc(%p, %d): %p", opno, rptr, size, resptr ));
@@ -591,7 +837,7 @@ void * _db_calloc( db_size_t n, db_size_t size, const char * file, int line, int
         return NULL;
     }
 
-    void * ptr = _db_malloc(actual_size, file, line, block_kind);
+    void * ptr = db_malloc_at(actual_size, file, line, block_kind, MEM_PROF_CALLER());
     return NULL == ptr ? NULL : memset(ptr, 0, actual_size);
 }
 
@@ -616,6 +862,10 @@ void _db_free(void * ptr, const char * file, int line, int block_kind)
     os_memory_account(0, get_rptr_size( rptr ));
 #endif
 
+#ifdef DB_MEMPROFILE
+    mem_prof_detach( ((mem_prof_hdr_t*)rptr)->site, ((mem_prof_hdr_t*)rptr)->kind, get_rptr_size( rptr ) );
+#endif
+
 #ifdef DB_MEMDEBUG
     free_mem(rptr);
 #endif
@@ -664,12 +914,12 @@ void * _db_memdup(void * p, db_size_t size, const char * file, int line, int blo
 {
     void * ptr;
 
-    unsigned long opno = check_request();
-
     if (p == NULL)
         return NULL;
 
-    if ((ptr = real_malloc(size, file, line, block_kind, opno)) == NULL)
+    /* go through db_malloc_at() so the block carries the same header as
+     * any other block released with _db_free() */
+    if ((ptr = db_malloc_at(size, file, line, block_kind, MEM_PROF_CALLER())) == NULL)
         return NULL;
 
     memcpy(ptr, p, size);
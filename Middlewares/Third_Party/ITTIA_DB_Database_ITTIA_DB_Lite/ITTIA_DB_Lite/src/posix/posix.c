@@ -0,0 +1,120 @@
+/**************************************************************************/
+/*                                                                        */
+/*      Copyright (c) 2005-2023 by ITTIA L.L.C. All rights reserved.      */
+/*                                                                        */
+/*  This software is copyrighted by and is the sole property of ITTIA     */
+/*  L.L.C.  All rights, title, ownership, or other interests in the       */
+/*  software remain the property of ITTIA L.L.C.  This software may only  */
+/*  be used in accordance with the corresponding license agreement.  Any  */
+/*  unauthorized use, duplication, transmission, distribution, or         */
+/*  disclosure of this software is expressly forbidden.                   */
+/*                                                                        */
+/*  This Copyright notice may not be removed or modified without prior    */
+/*  written consent of ITTIA L.L.C.                                       */
+/*                                                                        */
+/*  ITTIA L.L.C. reserves the right to modify this software without       */
+/*  notice.                                                               */
+/*                                                                        */
+/*  info@ittia.com                                                        */
+/*  https://www.ittia.com                                                 */
+/*                                                                        */
+/*                                                                        */
+/**************************************************************************/
+
+#include "ittia/os/os_config.h"
+
+#if defined(OS_POSIX) || defined(HAVE_POSIX_ERROR)
+
+#include "ittia/os/os_error.h"
+#include "ittia/os/os_debug.h"
+#include "ittia/os/std/errno.h"
+#include "os/posix/posix.h"
+
+#include <time.h>
+
+#include "os/os_mockup.h"
+
+static int _os_errno_error(int err)
+{
+    switch(err) {
+    case 0:
+        return DB_NOERROR;
+    case EBUSY:
+    case EAGAIN:
+    case ETIMEDOUT:
+        return DB_ELOCKED;
+    case EDEADLK:
+        return DB_EDEADLOCK;
+    case EINVAL:
+        return DB_EINVAL;
+    case ENOMEM:
+        return DB_ENOMEM;
+    case ESRCH:
+        return DB_ENOTHREAD;
+    case ENOSYS:
+        return DB_ENOSYS;
+    case EPERM:
+    case EACCES:
+        return DB_EACCESS;
+    case ENOENT:
+        return DB_ENOENT;
+    case EEXIST:
+        return DB_EEXIST;
+    case EBADF:
+        return DB_EBADF;
+    case ENOSPC:
+        return DB_ENOSPACE;
+    case EIO:
+        return DB_EIO;
+    default:
+        return DB_EOSERROR;
+    }
+}
+
+/* Map errno after a failed system call. */
+C_LINKAGE int os_posix_error(void)
+{
+    return set_db_error(_os_errno_error(errno));
+}
+
+/* pthread functions return the error code instead of setting errno. */
+C_LINKAGE int os_pthread_error(int err)
+{
+    return set_db_error(_os_errno_error(err));
+}
+
+int os_posix_init(void)
+{
+    return DB_NOERROR;
+}
+
+int os_posix_done(void)
+{
+    return DB_NOERROR;
+}
+
+/* Absolute CLOCK_REALTIME deadline, as expected by sem_timedwait() and
+ * pthread_cond_timedwait() with default attributes. */
+void os_posix_abstime(os_wait_time_t timeout, struct timespec * abstime)
+{
+    clock_gettime(CLOCK_REALTIME, abstime);
+
+    abstime->tv_sec += timeout / OS_WAIT_TIME_PREC;
+    abstime->tv_nsec += (long)(timeout % OS_WAIT_TIME_PREC) * (1000000000L / OS_WAIT_TIME_PREC);
+    if (abstime->tv_nsec >= 1000000000L) {
+        abstime->tv_nsec -= 1000000000L;
+        ++abstime->tv_sec;
+    }
+}
+
+db_bool_t os_posix_timeleft(const struct timespec * endtime)
+{
+    struct timespec now;
+
+    clock_gettime(CLOCK_REALTIME, &now);
+
+    return now.tv_sec < endtime->tv_sec
+        || (now.tv_sec == endtime->tv_sec && now.tv_nsec < endtime->tv_nsec);
+}
+
+#endif /* OS_POSIX */
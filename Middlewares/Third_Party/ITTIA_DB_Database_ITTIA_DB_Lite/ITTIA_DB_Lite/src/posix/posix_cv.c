@@ -0,0 +1,87 @@
+/**************************************************************************/
+/*                                                                        */
+/*      Copyright (c) 2005-2023 by ITTIA L.L.C. All rights reserved.      */
+/*                                                                        */
+/*  This software is copyrighted by and is the sole property of ITTIA     */
+/*  L.L.C.  All rights, title, ownership, or other interests in the       */
+/*  software remain the property of ITTIA L.L.C.  This software may only  */
+/*  be used in accordance with the corresponding license agreement.  Any  */
+/*  unauthorized use, duplication, transmission, distribution, or         */
+/*  disclosure of this software is expressly forbidden.                   */
+/*                                                                        */
+/*  This Copyright notice may not be removed or modified without prior    */
+/*  written consent of ITTIA L.L.C.                                       */
+/*                                                                        */
+/*  ITTIA L.L.C. reserves the right to modify this software without       */
+/*  notice.                                                               */
+/*                                                                        */
+/*  info@ittia.com                                                        */
+/*  https://www.ittia.com                                                 */
+/*                                                                        */
+/*                                                                        */
+/**************************************************************************/
+
+#include "ittia/os/os_config.h"
+
+#if defined(HAVE_THREADS) && defined(HAVE_POSIX_CONDVAR)
+
+#include "ittia/os/os_condvar.h"
+#include "ittia/os/os_mutex.h"
+#include "ittia/os/os_error.h"
+#include "os/posix/posix.h"
+
+#include "os/os_mockup.h"
+
+DBDLL_API int os_cond_init(os_cond_t * cv)
+{
+    int rc;
+    if ((rc = pthread_cond_init(cv, NULL)) != 0)
+        return os_pthread_error(rc);
+    return DB_NOERROR;
+}
+
+DBDLL_API int os_cond_destroy(os_cond_t * cv)
+{
+    int rc;
+    if ((rc = pthread_cond_destroy(cv)) != 0)
+        return os_pthread_error(rc);
+    return DB_NOERROR;
+}
+
+DBDLL_API int os_cond_wait(os_cond_t * cv, os_mutex_t * mutex, os_wait_time_t timeout)
+{
+    int rc;
+
+    if (timeout == OS_WAIT_FOREVER) {
+        rc = pthread_cond_wait(cv, &mutex->mtx);
+    }
+    else {
+        struct timespec abstime;
+
+        os_posix_abstime(timeout, &abstime);
+        rc = pthread_cond_timedwait(cv, &mutex->mtx, &abstime);
+    }
+
+    /* ETIMEDOUT maps to DB_ELOCKED, as in the other backends */
+    if (rc != 0)
+        return os_pthread_error(rc);
+    return DB_NOERROR;
+}
+
+DBDLL_API int os_cond_signal(os_cond_t * cv)
+{
+    int rc;
+    if ((rc = pthread_cond_signal(cv)) != 0)
+        return os_pthread_error(rc);
+    return DB_NOERROR;
+}
+
+DBDLL_API int os_cond_broadcast(os_cond_t * cv)
+{
+    int rc;
+    if ((rc = pthread_cond_broadcast(cv)) != 0)
+        return os_pthread_error(rc);
+    return DB_NOERROR;
+}
+
+#endif /* HAVE_POSIX_CONDVAR */
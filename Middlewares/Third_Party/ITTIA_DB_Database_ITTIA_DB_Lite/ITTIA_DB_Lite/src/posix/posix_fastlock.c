@@ -0,0 +1,74 @@
+/**************************************************************************/
+/*                                                                        */
+/*      Copyright (c) 2005-2023 by ITTIA L.L.C. All rights reserved.      */
+/*                                                                        */
+/*  This software is copyrighted by and is the sole property of ITTIA     */
+/*  L.L.C.  All rights, title, ownership, or other interests in the       */
+/*  software remain the property of ITTIA L.L.C.  This software may only  */
+/*  be used in accordance with the corresponding license agreement.  Any  */
+/*  unauthorized use, duplication, transmission, distribution, or         */
+/*  disclosure of this software is expressly forbidden.                   */
+/*                                                                        */
+/*  This Copyright notice may not be removed or modified without prior    */
+/*  written consent of ITTIA L.L.C.                                       */
+/*                                                                        */
+/*  ITTIA L.L.C. reserves the right to modify this software without       */
+/*  notice.                                                               */
+/*                                                                        */
+/*  info@ittia.com                                                        */
+/*  https://www.ittia.com                                                 */
+/*                                                                        */
+/*                                                                        */
+/**************************************************************************/
+
+#include "ittia/os/os_config.h"
+
+#if defined(HAVE_THREADS) && defined(HAVE_POSIX_FASTLOCK)
+
+#include "ittia/os/os_fastlock.h"
+#include "ittia/os/os_error.h"
+#include "os/posix/posix.h"
+
+#include "os/os_mockup.h"
+
+DBDLL_API int os_fastlock_init(os_fastlock_t * lock)
+{
+    int rc;
+    if ((rc = pthread_spin_init(lock, PTHREAD_PROCESS_PRIVATE)) != 0)
+        return os_pthread_error(rc);
+    return DB_NOERROR;
+}
+
+DBDLL_API int os_fastlock_destroy(os_fastlock_t * lock)
+{
+    int rc;
+    if ((rc = pthread_spin_destroy(lock)) != 0)
+        return os_pthread_error(rc);
+    return DB_NOERROR;
+}
+
+DBDLL_API int os_fastlock_trylock(os_fastlock_t * lock)
+{
+    int rc;
+    if ((rc = pthread_spin_trylock(lock)) != 0)
+        return os_pthread_error(rc);
+    return DB_NOERROR;
+}
+
+DBDLL_API int os_fastlock_lock(os_fastlock_t * lock)
+{
+    int rc;
+    if ((rc = pthread_spin_lock(lock)) != 0)
+        return os_pthread_error(rc);
+    return DB_NOERROR;
+}
+
+DBDLL_API int os_fastlock_unlock(os_fastlock_t * lock)
+{
+    int rc;
+    if ((rc = pthread_spin_unlock(lock)) != 0)
+        return os_pthread_error(rc);
+    return DB_NOERROR;
+}
+
+#endif /* HAVE_POSIX_FASTLOCK */
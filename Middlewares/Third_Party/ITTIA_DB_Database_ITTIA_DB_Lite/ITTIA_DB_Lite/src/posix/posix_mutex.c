@@ -0,0 +1,83 @@
+/**************************************************************************/
+/*                                                                        */
+/*      Copyright (c) 2005-2023 by ITTIA L.L.C. All rights reserved.      */
+/*                                                                        */
+/*  This software is copyrighted by and is the sole property of ITTIA     */
+/*  L.L.C.  All rights, title, ownership, or other interests in the       */
+/*  software remain the property of ITTIA L.L.C.  This software may only  */
+/*  be used in accordance with the corresponding license agreement.  Any  */
+/*  unauthorized use, duplication, transmission, distribution, or         */
+/*  disclosure of this software is expressly forbidden.                   */
+/*                                                                        */
+/*  This Copyright notice may not be removed or modified without prior    */
+/*  written consent of ITTIA L.L.C.                                       */
+/*                                                                        */
+/*  ITTIA L.L.C. reserves the right to modify this software without       */
+/*  notice.                                                               */
+/*                                                                        */
+/*  info@ittia.com                                                        */
+/*  https://www.ittia.com                                                 */
+/*                                                                        */
+/*                                                                        */
+/**************************************************************************/
+
+#include "ittia/os/os_config.h"
+
+#if defined(HAVE_THREADS) && defined(HAVE_POSIX_MUTEX)
+
+#include "ittia/os/os_mutex.h"
+#include "ittia/os/os_error.h"
+#include "os/posix/posix.h"
+
+#include "os/os_mockup.h"
+
+DBDLL_API int os_mutex_init(os_mutex_t * mutex)
+{
+    int rc;
+    pthread_mutexattr_t attr;
+
+    /* generic_fastlock.h maps fast locks onto mutexes and relies on
+     * recursive locking, as ThreadX mutexes provide. */
+    pthread_mutexattr_init(&attr);
+    pthread_mutexattr_settype(&attr, PTHREAD_MUTEX_RECURSIVE);
+    rc = pthread_mutex_init(&mutex->mtx, &attr);
+    pthread_mutexattr_destroy(&attr);
+
+    if (rc != 0)
+        return os_pthread_error(rc);
+    return DB_NOERROR;
+}
+
+DBDLL_API int os_mutex_destroy(os_mutex_t * mutex)
+{
+    int rc;
+    if ((rc = pthread_mutex_destroy(&mutex->mtx)) != 0)
+        return os_pthread_error(rc);
+    return DB_NOERROR;
+}
+
+DBDLL_API int os_mutex_trylock(os_mutex_t * mutex)
+{
+    int rc;
+    if ((rc = pthread_mutex_trylock(&mutex->mtx)) != 0)
+        return os_pthread_error(rc);
+    return DB_NOERROR;
+}
+
+DBDLL_API int os_mutex_lock(os_mutex_t * mutex)
+{
+    int rc;
+    if ((rc = pthread_mutex_lock(&mutex->mtx)) != 0)
+        return os_pthread_error(rc);
+    return DB_NOERROR;
+}
+
+DBDLL_API int os_mutex_unlock(os_mutex_t * mutex)
+{
+    int rc;
+    if ((rc = pthread_mutex_unlock(&mutex->mtx)) != 0)
+        return os_pthread_error(rc);
+    return DB_NOERROR;
+}
+
+#endif /* HAVE_POSIX_MUTEX */
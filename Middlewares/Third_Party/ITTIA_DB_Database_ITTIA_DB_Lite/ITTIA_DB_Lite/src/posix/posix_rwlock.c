@@ -0,0 +1,123 @@
+/**************************************************************************/
+/*                                                                        */
+/*      Copyright (c) 2005-2023 by ITTIA L.L.C. All rights reserved.      */
+/*                                                                        */
+/*  This software is copyrighted by and is the sole property of ITTIA     */
+/*  L.L.C.  All rights, title, ownership, or other interests in the       */
+/*  software remain the property of ITTIA L.L.C.  This software may only  */
+/*  be used in accordance with the corresponding license agreement.  Any  */
+/*  unauthorized use, duplication, transmission, distribution, or         */
+/*  disclosure of this software is expressly forbidden.                   */
+/*                                                                        */
+/*  This Copyright notice may not be removed or modified without prior    */
+/*  written consent of ITTIA L.L.C.                                       */
+/*                                                                        */
+/*  ITTIA L.L.C. reserves the right to modify this software without       */
+/*  notice.                                                               */
+/*                                                                        */
+/*  info@ittia.com                                                        */
+/*  https://www.ittia.com                                                 */
+/*                                                                        */
+/*                                                                        */
+/**************************************************************************/
+
+#include "ittia/os/os_config.h"
+
+#if defined(HAVE_THREADS) && (defined(HAVE_POSIX_RWLOCK) || defined(HAVE_POSIX_BARRIER))
+
+#include "ittia/os/os_rwlock.h"
+#include "ittia/os/os_barrier.h"
+#include "ittia/os/os_error.h"
+#include "os/posix/posix.h"
+
+#include "os/os_mockup.h"
+
+#ifdef HAVE_POSIX_RWLOCK
+
+DBDLL_API int os_rwlock_init(os_rwlock_t * lock)
+{
+    int rc;
+    if ((rc = pthread_rwlock_init(lock, NULL)) != 0)
+        return os_pthread_error(rc);
+    return DB_NOERROR;
+}
+
+DBDLL_API int os_rwlock_destroy(os_rwlock_t * lock)
+{
+    int rc;
+    if ((rc = pthread_rwlock_destroy(lock)) != 0)
+        return os_pthread_error(rc);
+    return DB_NOERROR;
+}
+
+DBDLL_API int os_rwlock_rdlock(os_rwlock_t * lock)
+{
+    int rc;
+    if ((rc = pthread_rwlock_rdlock(lock)) != 0)
+        return os_pthread_error(rc);
+    return DB_NOERROR;
+}
+
+DBDLL_API int os_rwlock_tryrdlock(os_rwlock_t * lock)
+{
+    int rc;
+    if ((rc = pthread_rwlock_tryrdlock(lock)) != 0)
+        return os_pthread_error(rc);
+    return DB_NOERROR;
+}
+
+DBDLL_API int os_rwlock_wrlock(os_rwlock_t * lock)
+{
+    int rc;
+    if ((rc = pthread_rwlock_wrlock(lock)) != 0)
+        return os_pthread_error(rc);
+    return DB_NOERROR;
+}
+
+DBDLL_API int os_rwlock_trywrlock(os_rwlock_t * lock)
+{
+    int rc;
+    if ((rc = pthread_rwlock_trywrlock(lock)) != 0)
+        return os_pthread_error(rc);
+    return DB_NOERROR;
+}
+
+DBDLL_API int os_rwlock_unlock(os_rwlock_t * lock)
+{
+    int rc;
+    if ((rc = pthread_rwlock_unlock(lock)) != 0)
+        return os_pthread_error(rc);
+    return DB_NOERROR;
+}
+
+#endif /* HAVE_POSIX_RWLOCK */
+
+#ifdef HAVE_POSIX_BARRIER
+
+DBDLL_API int os_barrier_init(os_barrier_t * barrier, int max_threads)
+{
+    int rc;
+    if ((rc = pthread_barrier_init(barrier, NULL, (unsigned)max_threads)) != 0)
+        return os_pthread_error(rc);
+    return DB_NOERROR;
+}
+
+DBDLL_API int os_barrier_destroy(os_barrier_t * barrier)
+{
+    int rc;
+    if ((rc = pthread_barrier_destroy(barrier)) != 0)
+        return os_pthread_error(rc);
+    return DB_NOERROR;
+}
+
+DBDLL_API int os_barrier_wait(os_barrier_t * barrier)
+{
+    int rc = pthread_barrier_wait(barrier);
+    if (rc != 0 && rc != PTHREAD_BARRIER_SERIAL_THREAD)
+        return os_pthread_error(rc);
+    return DB_NOERROR;
+}
+
+#endif /* HAVE_POSIX_BARRIER */
+
+#endif /* HAVE_POSIX_RWLOCK || HAVE_POSIX_BARRIER */
@@ -0,0 +1,86 @@
+/**************************************************************************/
+/*                                                                        */
+/*      Copyright (c) 2005-2023 by ITTIA L.L.C. All rights reserved.      */
+/*                                                                        */
+/*  This software is copyrighted by and is the sole property of ITTIA     */
+/*  L.L.C.  All rights, title, ownership, or other interests in the       */
+/*  software remain the property of ITTIA L.L.C.  This software may only  */
+/*  be used in accordance with the corresponding license agreement.  Any  */
+/*  unauthorized use, duplication, transmission, distribution, or         */
+/*  disclosure of this software is expressly forbidden.                   */
+/*                                                                        */
+/*  This Copyright notice may not be removed or modified without prior    */
+/*  written consent of ITTIA L.L.C.                                       */
+/*                                                                        */
+/*  ITTIA L.L.C. reserves the right to modify this software without       */
+/*  notice.                                                               */
+/*                                                                        */
+/*  info@ittia.com                                                        */
+/*  https://www.ittia.com                                                 */
+/*                                                                        */
+/*                                                                        */
+/**************************************************************************/
+
+#include "ittia/os/os_config.h"
+
+#if defined(HAVE_THREADS) && defined(HAVE_POSIX_SEM)
+
+#include "ittia/os/os_sem.h"
+#include "ittia/os/os_error.h"
+#include "ittia/os/std/errno.h"
+#include "os/posix/posix.h"
+
+#include "os/os_mockup.h"
+
+DBDLL_API int os_sem_init(os_sem_t * sem, int navailable)
+{
+    if (sem_init(sem, 0, (unsigned)navailable) != 0)
+        return os_posix_error();
+    return DB_NOERROR;
+}
+
+DBDLL_API int os_sem_destroy(os_sem_t * sem)
+{
+    if (sem_destroy(sem) != 0)
+        return os_posix_error();
+    return DB_NOERROR;
+}
+
+DBDLL_API int os_sem_wait(os_sem_t * sem, os_wait_time_t time)
+{
+    int rc;
+
+    if (time == OS_WAIT_FOREVER) {
+        do {
+            rc = sem_wait(sem);
+        } while (rc != 0 && errno == EINTR);
+    }
+    else if (time == 0) {
+        rc = sem_trywait(sem);
+    }
+    else {
+        struct timespec abstime;
+
+        os_posix_abstime(time, &abstime);
+        do {
+            rc = sem_timedwait(sem, &abstime);
+        } while (rc != 0 && errno == EINTR);
+    }
+
+    /* EAGAIN and ETIMEDOUT both map to DB_ELOCKED, as a ThreadX timeout does */
+    if (rc != 0)
+        return os_posix_error();
+    return DB_NOERROR;
+}
+
+DBDLL_API int os_sem_post(os_sem_t * sem, int how_many)
+{
+    while( how_many-- > 0 ) {
+        if (sem_post(sem) != 0)
+            return os_posix_error();
+    }
+
+    return DB_NOERROR;
+}
+
+#endif /* HAVE_POSIX_SEM */
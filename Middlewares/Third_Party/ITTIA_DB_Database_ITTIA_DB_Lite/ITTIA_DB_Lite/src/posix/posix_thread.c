@@ -0,0 +1,269 @@
+/**************************************************************************/
+/*                                                                        */
+/*      Copyright (c) 2005-2023 by ITTIA L.L.C. All rights reserved.      */
+/*                                                                        */
+/*  This software is copyrighted by and is the sole property of ITTIA     */
+/*  L.L.C.  All rights, title, ownership, or other interests in the       */
+/*  software remain the property of ITTIA L.L.C.  This software may only  */
+/*  be used in accordance with the corresponding license agreement.  Any  */
+/*  unauthorized use, duplication, transmission, distribution, or         */
+/*  disclosure of this software is expressly forbidden.                   */
+/*                                                                        */
+/*  This Copyright notice may not be removed or modified without prior    */
+/*  written consent of ITTIA L.L.C.                                       */
+/*                                                                        */
+/*  ITTIA L.L.C. reserves the right to modify this software without       */
+/*  notice.                                                               */
+/*                                                                        */
+/*  info@ittia.com                                                        */
+/*  https://www.ittia.com                                                 */
+/*                                                                        */
+/*                                                                        */
+/**************************************************************************/
+
+#include "ittia/os/os_config.h"
+
+#if defined(HAVE_THREADS) && defined(HAVE_POSIX_THREADS)
+
+#include "ittia/os/os_error.h"
+#include "os/posix/posix.h"
+#include "os/os_lib.h"
+#include "ittia/os/os_thread.h"
+#include "ittia/os/os_atomic.h"
+#include "ittia/os/os_malloc.h"
+#include "ittia/os/os_tls.h"
+#include "ittia/os/os_debug.h"
+#include "ittia/os/std/memory.h"
+#include "ittia/os/std/limits.h"
+#include "ittia/os/std/string.h"
+
+#include "os/os_mockup.h"
+
+struct os_thread_t
+{
+    pthread_t thread;
+    /* Non-zero if the thread was started by os_thread_spawn. */
+    int is_spawned;
+    os_atomic_t ref_count;
+    int is_joinable;
+    os_thread_proc_t proc;
+    void * param;
+};
+
+static os_tls_key_t os_posix_self;
+
+static int _thread_close(os_thread_t * thread)
+{
+    if (os_atomic_dec(&thread->ref_count) == 0)
+        DB_FREE( thread );
+    return DB_NOERROR;
+}
+
+static void * thread_start(void * p)
+{
+    os_thread_t * arg = (os_thread_t *)p;
+
+    os_tls_set(os_posix_self, arg);
+    arg->proc(arg->param);
+
+    os_thread_call_finalizers();
+
+    os_tls_set(os_posix_self, NULL);
+    _thread_close(arg);
+    return NULL;
+}
+
+DBDLL_API int os_thread_spawn(os_thread_proc_t proc,
+                                       void * arg,
+                                       int stack_size,
+                                       int flags,
+                                       os_thread_t ** handle )
+{
+    int rc;
+    os_thread_t * h = NULL;
+    pthread_attr_t attr;
+
+    if ((flags & ~OS_THREAD_JOIN_MASK) != 0 || proc == NULL || stack_size < 0) {
+        return set_db_error( DB_EINVAL );
+    }
+
+    if ((h = DB_MALLOC( sizeof(struct os_thread_t) )) == NULL)
+        return set_db_error( DB_ENOMEM );
+
+    h->is_spawned = 1;
+    h->proc = proc;
+    h->param = arg;
+
+    if ((flags & OS_THREAD_JOIN_MASK) == OS_THREAD_JOINABLE) {
+        h->is_joinable = 1;
+        /* Joinable threads have an extra reference that is consumed
+         * by os_thread_join(). */
+        h->ref_count = 2;
+    } else {
+        h->is_joinable = 0;
+        h->ref_count = 1;
+    }
+
+    pthread_attr_init(&attr);
+    pthread_attr_setdetachstate(&attr, h->is_joinable ? PTHREAD_CREATE_JOINABLE : PTHREAD_CREATE_DETACHED);
+    if (stack_size != DEFAULT_STACK_SIZE) {
+        if (stack_size < PTHREAD_STACK_MIN)
+            stack_size = PTHREAD_STACK_MIN;
+        pthread_attr_setstacksize(&attr, (size_t)stack_size);
+    }
+
+    /* The handle must be valid before the thread can drop its reference. */
+    if (handle)
+        *handle = h;
+
+    rc = pthread_create(&h->thread, &attr, thread_start, h);
+    pthread_attr_destroy(&attr);
+
+    if (rc != 0) {
+        if (handle)
+            *handle = NULL;
+        DB_FREE( h );
+        return os_pthread_error(rc);
+    }
+
+    return DB_NOERROR;
+}
+
+DBDLL_API uintptr_t
+os_thread_id()
+{
+    return (uintptr_t)pthread_self();
+}
+
+DBDLL_API os_thread_t * os_thread_self(void)
+{
+    os_thread_t * p;
+    DB_VERIFY( DB_NOERROR == os_tls_get(os_posix_self, (void*)&p) );
+
+    if (p == NULL) {
+        if (os_thread_attach() < 0)
+            return NULL;
+        DB_VERIFY( DB_NOERROR == os_tls_get(os_posix_self, (void*)&p) );
+    }
+    DB_ASSERT( p != NULL );
+    return p;
+}
+
+DBDLL_API void os_thread_set_name(os_thread_t * h, const char * thread_name)
+{
+#if defined(OS_LINUX) && defined(_GNU_SOURCE)
+    char name[16];
+
+    if (h == NULL || thread_name == NULL)
+        return;
+
+    /* Linux limits thread names to 15 characters. */
+    strncpy(name, thread_name, sizeof name - 1);
+    name[sizeof name - 1] = '\0';
+    pthread_setname_np(h->thread, name);
+#else
+    DB_UNUSED(h);
+    DB_UNUSED(thread_name);
+#endif
+}
+
+DBDLL_API int os_thread_join(os_thread_t * h)
+{
+    int rc;
+
+    if (h == NULL)
+        return set_db_error(DB_EINVAL);
+
+    if (pthread_equal(pthread_self(), h->thread))
+        return set_db_error( DB_ESTATE );
+
+    if (!h->is_joinable)
+        return set_db_error( DB_ESTATE );
+
+    if ((rc = pthread_join(h->thread, NULL)) != 0)
+        return os_pthread_error(rc);
+
+    return _thread_close(h);
+}
+
+DBDLL_API int os_thread_dup(os_thread_t * h)
+{
+    if (h == NULL)
+        return set_db_error(DB_EINVAL);
+
+    os_atomic_inc(&h->ref_count);
+    return DB_NOERROR;
+}
+
+DBDLL_API int os_thread_close(os_thread_t * h)
+{
+    if (h == NULL)
+        return set_db_error(DB_EINVAL);
+
+    if (pthread_equal(pthread_self(), h->thread))
+        return set_db_error( DB_ESTATE );
+
+    return _thread_close(h);
+}
+
+DBDLL_API int os_thread_attach(void)
+{
+    os_thread_t * p;
+    int rc;
+
+    rc = os_tls_get(os_posix_self, (void*)&p);
+    DB_ASSERT( rc == DB_NOERROR);
+
+    /* A thread is only attached once. If it was started with os_spawn_thread
+     * then it is already attached. */
+    if (p == NULL) {
+        p = DB_MALLOC( sizeof(struct os_thread_t) );
+        if (p == NULL)
+            return DB_FAILURE;
+
+        /* Attach current thread. */
+        p->thread = pthread_self();
+        p->is_spawned = 0;
+        p->proc = NULL;
+        p->param = NULL;
+        p->ref_count = 1;
+        p->is_joinable = 0;
+        if ((rc = os_tls_set(os_posix_self, p)) != DB_NOERROR) {
+            DB_FREE( p );
+            return rc;
+        }
+    }
+    return DB_NOERROR;
+}
+
+DBDLL_API int os_thread_detach(void)
+{
+    os_thread_t * p;
+    int rc;
+
+    if (DB_FAILED( rc = os_tls_get(os_posix_self, (void*)&p) ))
+        return rc;
+
+    if (p != NULL) {
+        /* A spawned thread releases its own handle when it returns. */
+        if (p->is_spawned)
+            return set_db_error(DB_ESTATE);
+
+        os_tls_set(os_posix_self, NULL);
+        return _thread_close(p);
+    }
+
+    return DB_NOERROR;
+}
+
+int os_posix_threads_init(void)
+{
+    return os_tls_init(&os_posix_self);
+}
+
+int os_posix_threads_done(void)
+{
+    return os_tls_destroy(&os_posix_self);
+}
+
+#endif /* HAVE_POSIX_THREADS */
@@ -0,0 +1,85 @@
+/**************************************************************************/
+/*                                                                        */
+/*      Copyright (c) 2005-2023 by ITTIA L.L.C. All rights reserved.      */
+/*                                                                        */
+/*  This software is copyrighted by and is the sole property of ITTIA     */
+/*  L.L.C.  All rights, title, ownership, or other interests in the       */
+/*  software remain the property of ITTIA L.L.C.  This software may only  */
+/*  be used in accordance with the corresponding license agreement.  Any  */
+/*  unauthorized use, duplication, transmission, distribution, or         */
+/*  disclosure of this software is expressly forbidden.                   */
+/*                                                                        */
+/*  This Copyright notice may not be removed or modified without prior    */
+/*  written consent of ITTIA L.L.C.                                       */
+/*                                                                        */
+/*  ITTIA L.L.C. reserves the right to modify this software without       */
+/*  notice.                                                               */
+/*                                                                        */
+/*  info@ittia.com                                                        */
+/*  https://www.ittia.com                                                 */
+/*                                                                        */
+/*                                                                        */
+/**************************************************************************/
+
+#include "ittia/os/os_config.h"
+
+#if defined(HAVE_THREADS) && defined(HAVE_POSIX_THREADS)
+
+#include "ittia/os/os_wait_time.h"
+#include "ittia/os/std/errno.h"
+#include "os/posix/posix.h"
+
+#include <time.h>
+#include <sched.h>
+#include <unistd.h>
+
+#include "os/os_mockup.h"
+
+#undef os_current_time
+DBDLL_API os_wait_time_t
+os_current_time(void)
+{
+    struct timespec now;
+
+    /* monotonic, so that elapsed times survive wall clock adjustments */
+    clock_gettime(CLOCK_MONOTONIC, &now);
+    return (os_wait_time_t)((uint64_t)now.tv_sec * OS_WAIT_TIME_PREC
+                            + (uint64_t)now.tv_nsec / (1000000000L / OS_WAIT_TIME_PREC));
+}
+
+#undef os_sleep
+DBDLL_API void
+os_sleep(os_wait_time_t time)
+{
+    struct timespec req, rem;
+
+    if (time == OS_WAIT_FOREVER) {
+        for (;;)
+            pause();
+    }
+
+    req.tv_sec = time / OS_WAIT_TIME_PREC;
+    req.tv_nsec = (long)(time % OS_WAIT_TIME_PREC) * (1000000000L / OS_WAIT_TIME_PREC);
+
+    while (nanosleep(&req, &rem) != 0 && errno == EINTR)
+        req = rem;
+}
+
+#undef os_cpu_yield
+DBDLL_API void
+os_cpu_yield(void)
+{
+    sched_yield();
+}
+
+DBDLL_API void
+os_day_time(os_day_time_t * current_time)
+{
+    struct timespec now;
+
+    clock_gettime(CLOCK_REALTIME, &now);
+    *current_time = (os_day_time_t)now.tv_sec * OS_DAY_TIME_PREC
+                  + (os_day_time_t)now.tv_nsec / (1000000000L / OS_DAY_TIME_PREC);
+}
+
+#endif /* HAVE_POSIX_THREADS */
@@ -0,0 +1,66 @@
+/**************************************************************************/
+/*                                                                        */
+/*      Copyright (c) 2005-2023 by ITTIA L.L.C. All rights reserved.      */
+/*                                                                        */
+/*  This software is copyrighted by and is the sole property of ITTIA     */
+/*  L.L.C.  All rights, title, ownership, or other interests in the       */
+/*  software remain the property of ITTIA L.L.C.  This software may only  */
+/*  be used in accordance with the corresponding license agreement.  Any  */
+/*  unauthorized use, duplication, transmission, distribution, or         */
+/*  disclosure of this software is expressly forbidden.                   */
+/*                                                                        */
+/*  This Copyright notice may not be removed or modified without prior    */
+/*  written consent of ITTIA L.L.C.                                       */
+/*                                                                        */
+/*  ITTIA L.L.C. reserves the right to modify this software without       */
+/*  notice.                                                               */
+/*                                                                        */
+/*  info@ittia.com                                                        */
+/*  https://www.ittia.com                                                 */
+/*                                                                        */
+/*                                                                        */
+/**************************************************************************/
+
+#include "ittia/os/os_config.h"
+
+#if defined(HAVE_THREADS) && defined(HAVE_POSIX_TLS)
+
+#include "ittia/os/os_tls.h"
+#include "ittia/os/os_error.h"
+#include "ittia/os/std/errno.h"
+#include "os/posix/posix.h"
+
+#include "os/os_mockup.h"
+
+DBDLL_API int os_tls_init(os_tls_key_t * key)
+{
+    int rc;
+    if ((rc = pthread_key_create(key, NULL)) != 0)
+        return os_pthread_error(rc);
+    return DB_NOERROR;
+}
+
+DBDLL_API int os_tls_destroy(os_tls_key_t * key)
+{
+    int rc;
+    if ((rc = pthread_key_delete(*key)) != 0)
+        return os_pthread_error(rc);
+    return DB_NOERROR;
+}
+
+DBDLL_API int os_tls_set(os_tls_key_t key, os_tls_value_t value)
+{
+    int rc;
+    /* not os_pthread_error(): set_db_error() itself stores through TLS */
+    if ((rc = pthread_setspecific(key, value)) != 0)
+        return rc == ENOMEM ? DB_ENOMEM : DB_EINVAL;
+    return DB_NOERROR;
+}
+
+DBDLL_API int os_tls_get(os_tls_key_t key, os_tls_value_t * value)
+{
+    *value = pthread_getspecific(key);
+    return DB_NOERROR;
+}
+
+#endif /* HAVE_POSIX_TLS */
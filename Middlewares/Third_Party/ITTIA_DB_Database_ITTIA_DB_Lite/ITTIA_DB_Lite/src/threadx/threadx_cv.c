@@ -0,0 +1,218 @@
+/**************************************************************************/
+/*                                                                        */
+/*      Copyright (c) 2005-2023 by ITTIA L.L.C. All rights reserved.      */
+/*                                                                        */
+/*  This software is copyrighted by and is the sole property of ITTIA     */
+/*  L.L.C.  All rights, title, ownership, or other interests in the       */
+/*  software remain the property of ITTIA L.L.C.  This software may only  */
+/*  be used in accordance with the corresponding license agreement.  Any  */
+/*  unauthorized use, duplication, transmission, distribution, or         */
+/*  disclosure of this software is expressly forbidden.                   */
+/*                                                                        */
+/*  This Copyright notice may not be removed or modified without prior    */
+/*  written consent of ITTIA L.L.C.                                       */
+/*                                                                        */
+/*  ITTIA L.L.C. reserves the right to modify this software without       */
+/*  notice.                                                               */
+/*                                                                        */
+/*  info@ittia.com                                                        */
+/*  https://www.ittia.com                                                 */
+/*                                                                        */
+/*                                                                        */
+/**************************************************************************/
+
+#include "ittia/os/os_config.h"
+
+#if defined(HAVE_THREADS) && defined(HAVE_THREADX_CONDVAR)
+
+#include "ittia/os/os_condvar.h"
+#include "ittia/os/os_mutex.h"
+#include "ittia/os/os_error.h"
+#include "ittia/os/os_debug.h"
+#include "os/threadx/threadx.h"
+
+#ifdef DB_DEBUG
+#include "ittia/os/os_atomic.h"
+#endif
+
+#include "os/os_mockup.h"
+
+/*
+ * Condition variable built directly on the ThreadX scheduler.
+ *
+ * Each waiter links a record from its own stack into a FIFO and suspends
+ * itself with tx_thread_sleep(). Enqueue, dequeue and the decision to
+ * suspend are made with interrupts disabled, so a signal can never fall
+ * between the waiter's check and its suspension: tx_thread_sleep() called
+ * inside TX_DISABLE suspends atomically and restores the caller's
+ * interrupt posture when the thread is resumed.
+ *
+ * A signal pops the head record, marks it and, if the waiter is already
+ * suspended, resumes it with tx_thread_wait_abort(). That is the only
+ * kernel call per wakeup, and new waiters are never held back while a
+ * broadcast is being delivered.
+ */
+
+#ifdef DB_DEBUG
+
+static os_atomic_t cur_cond_count = 0;
+
+#define os_cond_use()       os_atomic_inc( &cur_cond_count )
+#define os_cond_release()   os_atomic_dec( &cur_cond_count )
+
+long os_cond_used(void)
+{
+    return os_atomic_fetch( &cur_cond_count );
+}
+
+#else
+#define os_cond_use()
+#define os_cond_release()
+
+#endif
+
+#define CV_INITIALIZED  50505
+
+/* Must be called with interrupts disabled. */
+static void cv_unlink(os_cond_t * cv, os_cond_waiter_t * waiter)
+{
+    os_cond_waiter_t * prev = NULL;
+    os_cond_waiter_t * cur;
+
+    for (cur = cv->head; cur != NULL; prev = cur, cur = cur->next) {
+        if (cur == waiter) {
+            if (prev == NULL)
+                cv->head = cur->next;
+            else
+                prev->next = cur->next;
+            if (cv->tail == cur)
+                cv->tail = prev;
+            break;
+        }
+    }
+}
+
+/* Wake the oldest waiter. Returns non-zero if there was one. */
+static int cv_wake_one(os_cond_t * cv)
+{
+    TX_INTERRUPT_SAVE_AREA
+    os_cond_waiter_t * waiter;
+
+    TX_DISABLE
+
+    waiter = cv->head;
+    if (waiter != NULL) {
+        cv->head = waiter->next;
+        if (cv->head == NULL)
+            cv->tail = NULL;
+
+        /* The record may go out of scope as soon as the waiter runs, so
+         * read everything needed before resuming it. */
+        waiter->signaled = 1;
+        if (waiter->sleeping)
+            tx_thread_wait_abort(waiter->thread);
+    }
+
+    TX_RESTORE
+
+    return waiter != NULL;
+}
+
+DBDLL_API int os_cond_init(os_cond_t * cv)
+{
+    cv->head = NULL;
+    cv->tail = NULL;
+    cv->state = CV_INITIALIZED;
+
+    os_cond_use();
+
+    return DB_NOERROR;
+}
+
+DBDLL_API int os_cond_destroy(os_cond_t * cv)
+{
+    if (cv->state == CV_INITIALIZED) {
+        DB_REQUIRE( cv->head == NULL, DB_ELOCKED );
+
+        os_cond_release();
+
+        cv->state = 0;
+    }
+
+    return DB_NOERROR;
+}
+
+DBDLL_API int os_cond_signal(os_cond_t * cv)
+{
+    DB_ASSERT( cv->state == CV_INITIALIZED );
+
+    cv_wake_one(cv);
+
+    return DB_NOERROR;
+}
+
+DBDLL_API int os_cond_broadcast(os_cond_t * cv)
+{
+    DB_ASSERT( cv->state == CV_INITIALIZED );
+
+    /* One waiter per critical section keeps interrupt latency bounded. */
+    while (cv_wake_one(cv))
+        ;
+
+    return DB_NOERROR;
+}
+
+DBDLL_API int os_cond_wait(os_cond_t * cv, os_mutex_t * mutex, os_wait_time_t timeout)
+{
+    TX_INTERRUPT_SAVE_AREA
+    os_cond_waiter_t waiter;
+    UINT status = TX_SUCCESS;
+    int result = DB_NOERROR;
+
+    DB_ASSERT( cv->state == CV_INITIALIZED );
+
+    waiter.next = NULL;
+    waiter.thread = tx_thread_identify();
+    waiter.signaled = 0;
+    waiter.sleeping = 0;
+
+    if (waiter.thread == NULL)
+        return DB_EINVAL;
+
+    TX_DISABLE
+    if (cv->tail == NULL)
+        cv->head = &waiter;
+    else
+        cv->tail->next = &waiter;
+    cv->tail = &waiter;
+    TX_RESTORE
+
+    os_mutex_unlock( mutex );
+
+    TX_DISABLE
+    while (!waiter.signaled) {
+        waiter.sleeping = 1;
+        status = tx_thread_sleep(timeout);
+        waiter.sleeping = 0;
+
+        /* tx_thread_sleep() cannot express an infinite wait; keep
+         * sleeping until a signal arrives. */
+        if (timeout != OS_WAIT_FOREVER)
+            break;
+    }
+
+    if (!waiter.signaled) {
+        cv_unlink(cv, &waiter);
+        /* An abort from outside the condition variable is reported as a
+         * spurious wakeup rather than a timeout. */
+        if (status != TX_WAIT_ABORTED)
+            result = DB_ELOCKED;
+    }
+    TX_RESTORE
+
+    os_mutex_lock( mutex );
+
+    return result;
+}
+
+#endif /* HAVE_THREADX_CONDVAR */
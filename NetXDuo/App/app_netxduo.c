@@ -24,7 +24,12 @@
 /* Private includes ----------------------------------------------------------*/
 #include "nxd_dhcp_client.h"
 /* USER CODE BEGIN Includes */
-
+#include <stdio.h>
+#include <string.h>
+#include "nx_tcp.h"       // NX_TCP_MAXIMUM_RETRIES, NX_TCP_RETRY_SHIFT defaults
+#include "meteo_trace.h"
+#include "meteo_journal.h"
+#include "meteo_export.h"
 /* USER CODE END Includes */
 
 /* Private typedef -----------------------------------------------------------*/
@@ -34,7 +39,26 @@
 
 /* Private define ------------------------------------------------------------*/
 /* USER CODE BEGIN PD */
-
+// 19.10.26 Trace dump server: connect to METEO_TRACE_TCP_PORT, read until closed
+#define TRACE_SERVER_STACK_SIZE     2048
+#define TRACE_SERVER_PRIORITY       NX_APP_THREAD_PRIORITY
+#define TRACE_SERVER_PACKET_BYTES   1024U
+
+// 19.10.26 Journal uplink: records from the acknowledged position, then live.
+// The client sends back 4-byte little endian "next seq" acknowledgements.
+#define JOURNAL_SERVER_STACK_SIZE   3072
+#define JOURNAL_SERVER_PRIORITY     NX_APP_THREAD_PRIORITY
+#define JOURNAL_SERVER_RECORDS      32U     /* Records per packet (1 KB) */
+#define JOURNAL_SERVER_QUEUE_DEPTH  4U      /* Packets in flight: the pool is shared with the IDC agent */
+#define JOURNAL_SERVER_POLL_TICKS   10U     /* Acks and disconnect checked this often when idle */
+
+// 19.10.26 Archive export: the client sends one request line (meteo_export_parse),
+// the board sends the export (CSV, JSON or MCOL) and closes. No line within the timeout: whole archive.
+// A "series " prefix exports the time series of each channel (METEO_SERIES_ENABLED).
+#define EXPORT_SERVER_STACK_SIZE    2048
+#define EXPORT_SERVER_PRIORITY      NX_APP_THREAD_PRIORITY
+#define EXPORT_SERVER_QUEUE_DEPTH   4U      /* Packets in flight, as the journal uplink */
+#define EXPORT_SERVER_REQUEST_TICKS (2 * NX_IP_PERIODIC_RATE)
 /* USER CODE END PD */
 
 /* Private macro -------------------------------------------------------------*/
@@ -49,14 +73,33 @@ NX_IP          NetXDuoEthIpInstance;
 TX_SEMAPHORE   DHCPSemaphore;
 NX_DHCP        DHCPClient;
 /* USER CODE BEGIN PV */
-
+#ifdef TX_ENABLE_EVENT_TRACE
+static TX_THREAD     TraceServerThread;
+static NX_TCP_SOCKET TraceServerSocket;
+#endif
+#if METEO_JOURNAL_ENABLED
+static TX_THREAD     JournalServerThread;
+static NX_TCP_SOCKET JournalServerSocket;
+#endif
+#if METEO_EXPORT_ENABLED
+static TX_THREAD     ExportServerThread;
+static NX_TCP_SOCKET ExportServerSocket;
+#endif
 /* USER CODE END PV */
 
 /* Private function prototypes -----------------------------------------------*/
 static VOID App_Main_Thread_Entry (ULONG thread_input);
 static VOID ip_address_change_notify_callback(NX_IP *ip_instance, VOID *ptr);
 /* USER CODE BEGIN PFP */
-
+#ifdef TX_ENABLE_EVENT_TRACE
+static VOID Trace_Server_Thread_Entry(ULONG thread_input);
+#endif
+#if METEO_JOURNAL_ENABLED
+static VOID Journal_Server_Thread_Entry(ULONG thread_input);
+#endif
+#if METEO_EXPORT_ENABLED
+static VOID Export_Server_Thread_Entry(ULONG thread_input);
+#endif
 /* USER CODE END PFP */
 
 /**
@@ -201,6 +244,50 @@ UINT MX_NetXDuo_Init(VOID *memory_ptr)
   tx_semaphore_create(&DHCPSemaphore, "DHCP Semaphore", 0);
 
   /* USER CODE BEGIN MX_NetXDuo_Init */
+#ifdef TX_ENABLE_EVENT_TRACE
+  // 19.10.26 Own thread: NxAppThread stays blocked on DHCPSemaphore
+  if (tx_byte_allocate(byte_pool, (VOID **) &pointer, TRACE_SERVER_STACK_SIZE, TX_NO_WAIT) != TX_SUCCESS)
+  {
+    return TX_POOL_ERROR;
+  }
+
+  ret = tx_thread_create(&TraceServerThread, "Trace Server thread", Trace_Server_Thread_Entry, 0, pointer, TRACE_SERVER_STACK_SIZE,
+                         TRACE_SERVER_PRIORITY, TRACE_SERVER_PRIORITY, TX_NO_TIME_SLICE, TX_AUTO_START);
+
+  if (ret != TX_SUCCESS)
+  {
+    return TX_THREAD_ERROR;
+  }
+#endif
+#if METEO_JOURNAL_ENABLED
+  if (tx_byte_allocate(byte_pool, (VOID **) &pointer, JOURNAL_SERVER_STACK_SIZE, TX_NO_WAIT) != TX_SUCCESS)
+  {
+    return TX_POOL_ERROR;
+  }
+
+  ret = tx_thread_create(&JournalServerThread, "Journal Server thread", Journal_Server_Thread_Entry, 0, pointer, JOURNAL_SERVER_STACK_SIZE,
+                         JOURNAL_SERVER_PRIORITY, JOURNAL_SERVER_PRIORITY, TX_NO_TIME_SLICE, TX_AUTO_START);
+
+  if (ret != TX_SUCCESS)
+  {
+    return TX_THREAD_ERROR;
+  }
+#endif
+#if METEO_EXPORT_ENABLED
+  // Stack only: the export state is static in meteo_export.c
+  if (tx_byte_allocate(byte_pool, (VOID **) &pointer, EXPORT_SERVER_STACK_SIZE, TX_NO_WAIT) != TX_SUCCESS)
+  {
+    return TX_POOL_ERROR;
+  }
+
+  ret = tx_thread_create(&ExportServerThread, "Export Server thread", Export_Server_Thread_Entry, 0, pointer, EXPORT_SERVER_STACK_SIZE,
+                         EXPORT_SERVER_PRIORITY, EXPORT_SERVER_PRIORITY, TX_NO_TIME_SLICE, TX_AUTO_START);
+
+  if (ret != TX_SUCCESS)
+  {
+    return TX_THREAD_ERROR;
+  }
+#endif
   /* USER CODE END MX_NetXDuo_Init */
 
   return ret;
@@ -268,5 +355,386 @@ static VOID App_Main_Thread_Entry (ULONG thread_input)
 
 }
 /* USER CODE BEGIN 1 */
+#ifdef TX_ENABLE_EVENT_TRACE
+/**
+* @brief  Send the stopped trace buffer on the connected socket.
+* @param buffer: trace buffer
+* @param size: bytes to send
+* @retval NX_SUCCESS or the first NetX error
+*/
+static UINT Trace_Server_Send(const UCHAR *buffer, ULONG size)
+{
+  NX_PACKET *packet;
+  ULONG offset;
+  ULONG length;
+  UINT ret;
+
+  for (offset = 0; offset < size; offset += length)
+  {
+    length = size - offset;
+    if (length > TRACE_SERVER_PACKET_BYTES)
+    {
+      length = TRACE_SERVER_PACKET_BYTES;
+    }
+
+    ret = nx_packet_allocate(&NxAppPool, &packet, NX_TCP_PACKET, NX_APP_DEFAULT_TIMEOUT);
+    if (ret != NX_SUCCESS)
+    {
+      return ret;
+    }
+
+    ret = nx_packet_data_append(packet, (VOID *)(buffer + offset), length, &NxAppPool, NX_APP_DEFAULT_TIMEOUT);
+    if (ret == NX_SUCCESS)
+    {
+      ret = nx_tcp_socket_send(&TraceServerSocket, packet, NX_APP_DEFAULT_TIMEOUT);
+    }
+    if (ret != NX_SUCCESS)
+    {
+      // Not queued: the packet is still ours
+      nx_packet_release(packet);
+      return ret;
+    }
+  }
+
+  return NX_SUCCESS;
+}
+
+/**
+* @brief  Trace server thread entry: one raw trace buffer per connection.
+*         The trace is stopped while the buffer is sent, then restarted.
+* @param thread_input: ULONG user argument used by the thread entry
+* @retval none
+*/
+static VOID Trace_Server_Thread_Entry(ULONG thread_input)
+{
+  const UCHAR *buffer;
+  ULONG size;
+  UINT ret;
+
+  (void)thread_input;
+
+  ret = nx_tcp_socket_create(&NetXDuoEthIpInstance, &TraceServerSocket, "Trace Server Socket",
+                             NX_IP_NORMAL, NX_FRAGMENT_OKAY, NX_IP_TIME_TO_LIVE, 4 * TRACE_SERVER_PACKET_BYTES,
+                             NX_NULL, NX_NULL);
+  if (ret == NX_SUCCESS)
+  {
+    ret = nx_tcp_server_socket_listen(&NetXDuoEthIpInstance, METEO_TRACE_TCP_PORT, &TraceServerSocket, 1, NX_NULL);
+  }
+  if (ret != NX_SUCCESS)
+  {
+    printf("[TRACE] Server start failed (0x%02X)\n", ret);
+    return;
+  }
+
+  while (1)
+  {
+    if (nx_tcp_server_socket_accept(&TraceServerSocket, NX_WAIT_FOREVER) == NX_SUCCESS)
+    {
+      if (meteo_trace_stop(&buffer, &size) == TX_SUCCESS)
+      {
+        ret = Trace_Server_Send(buffer, size);
+        meteo_trace_restart();
+        printf("[TRACE] Sent %lu bytes over TCP (0x%02X)\n", (unsigned long)size, ret);
+      }
+      nx_tcp_socket_disconnect(&TraceServerSocket, NX_APP_DEFAULT_TIMEOUT);
+    }
+
+    nx_tcp_server_socket_unaccept(&TraceServerSocket);
+    nx_tcp_server_socket_relisten(&NetXDuoEthIpInstance, METEO_TRACE_TCP_PORT, &TraceServerSocket);
+  }
+}
+#endif
+
+#if METEO_JOURNAL_ENABLED
+/**
+* @brief  Apply the acknowledgements received so far, without waiting.
+*         A word may be split across packets: it is kept in ack / ack_bytes.
+* @param ack: word being assembled
+* @param ack_bytes: bytes of it received
+* @retval NX_SUCCESS, or NX_NOT_CONNECTED when the client has gone
+*/
+static UINT Journal_Server_Acks(ULONG *ack, UINT *ack_bytes)
+{
+  NX_PACKET *packet;
+  UCHAR data[64];
+  ULONG offset;
+  ULONG length;
+  ULONG i;
+  UINT ret;
+
+  while ((ret = nx_tcp_socket_receive(&JournalServerSocket, &packet, NX_NO_WAIT)) == NX_SUCCESS)
+  {
+    for (offset = 0;
+         nx_packet_data_extract_offset(packet, offset, data, sizeof(data), &length) == NX_SUCCESS && length != 0U;
+         offset += length)
+    {
+      for (i = 0; i < length; i++)
+      {
+        *ack = (*ack >> 8) | ((ULONG)data[i] << 24);
+        if (++(*ack_bytes) == 4U)
+        {
+          *ack_bytes = 0;
+          if (meteo_journal_ack((uint32_t)*ack) != TX_SUCCESS)
+          {
+            printf("[JOURNAL] Ack %lu rejected\n", (unsigned long)*ack);
+          }
+        }
+      }
+    }
+    nx_packet_release(packet);
+  }
+
+  return (ret == NX_NO_PACKET) ? NX_SUCCESS : ret;
+}
+
+/**
+* @brief  Send records on the connected socket, one packet.
+* @param records: journal records
+* @param count: number of records
+* @retval NX_SUCCESS or the NetX error
+*/
+static UINT Journal_Server_Send(const meteo_journal_record_t *records, UINT count)
+{
+  NX_PACKET *packet;
+  UINT ret;
+
+  ret = nx_packet_allocate(&NxAppPool, &packet, NX_TCP_PACKET, NX_APP_DEFAULT_TIMEOUT);
+  if (ret != NX_SUCCESS)
+  {
+    return ret;
+  }
+
+  ret = nx_packet_data_append(packet, (VOID *)records, count * sizeof(meteo_journal_record_t), &NxAppPool, NX_APP_DEFAULT_TIMEOUT);
+  if (ret == NX_SUCCESS)
+  {
+    ret = nx_tcp_socket_send(&JournalServerSocket, packet, NX_APP_DEFAULT_TIMEOUT);
+  }
+  if (ret != NX_SUCCESS)
+  {
+    // Not queued: the packet is still ours
+    nx_packet_release(packet);
+  }
+
+  return ret;
+}
+
+/**
+* @brief  Journal server thread entry: one uplink client at a time. Sends
+*         the backlog as fast as TCP takes it, then new records as they are
+*         stored. Each connection starts again from the acknowledged
+*         position, so records in flight at a disconnect are sent again.
+* @param thread_input: ULONG user argument used by the thread entry
+* @retval none
+*/
+static VOID Journal_Server_Thread_Entry(ULONG thread_input)
+{
+  meteo_journal_record_t records[JOURNAL_SERVER_RECORDS];
+  meteo_journal_cursor_t cursor;
+  ULONG ack;
+  UINT ack_bytes;
+  UINT count;
+  ULONG sent;
+  UINT ret;
+
+  (void)thread_input;
+
+  ret = nx_tcp_socket_create(&NetXDuoEthIpInstance, &JournalServerSocket, "Journal Server Socket",
+                             NX_IP_NORMAL, NX_FRAGMENT_OKAY, NX_IP_TIME_TO_LIVE, 1024,
+                             NX_NULL, NX_NULL);
+  if (ret == NX_SUCCESS)
+  {
+    ret = nx_tcp_socket_transmit_configure(&JournalServerSocket, JOURNAL_SERVER_QUEUE_DEPTH,
+                                           NX_IP_PERIODIC_RATE, NX_TCP_MAXIMUM_RETRIES, NX_TCP_RETRY_SHIFT);
+  }
+  if (ret == NX_SUCCESS)
+  {
+    ret = nx_tcp_server_socket_listen(&NetXDuoEthIpInstance, METEO_JOURNAL_TCP_PORT, &JournalServerSocket, 1, NX_NULL);
+  }
+  if (ret != NX_SUCCESS)
+  {
+    printf("[JOURNAL] Server start failed (0x%02X)\n", ret);
+    return;
+  }
+
+  while (1)
+  {
+    if (nx_tcp_server_socket_accept(&JournalServerSocket, NX_WAIT_FOREVER) == NX_SUCCESS)
+    {
+      meteo_journal_cursor_init(&cursor);
+      printf("[JOURNAL] Uplink connected, from seq %lu\n", (unsigned long)cursor.next);
+      ack = 0;
+      ack_bytes = 0;
+      sent = 0;
+
+      while (Journal_Server_Acks(&ack, &ack_bytes) == NX_SUCCESS)
+      {
+        if (meteo_journal_read(&cursor, records, JOURNAL_SERVER_RECORDS, &count) != TX_SUCCESS)
+        {
+          // Flash busy or failing: try again later
+          tx_thread_sleep(JOURNAL_SERVER_POLL_TICKS);
+          continue;
+        }
+        if (count == 0U)
+        {
+          (void)meteo_journal_wait(&cursor, JOURNAL_SERVER_POLL_TICKS);
+          continue;
+        }
+        if (Journal_Server_Send(records, count) != NX_SUCCESS)
+        {
+          break;
+        }
+        sent += count;
+      }
+
+      printf("[JOURNAL] Uplink closed, %lu records sent\n", (unsigned long)sent);
+      nx_tcp_socket_disconnect(&JournalServerSocket, NX_APP_DEFAULT_TIMEOUT);
+    }
+
+    nx_tcp_server_socket_unaccept(&JournalServerSocket);
+    nx_tcp_server_socket_relisten(&NetXDuoEthIpInstance, METEO_JOURNAL_TCP_PORT, &JournalServerSocket);
+  }
+}
+#endif
+
+#if METEO_EXPORT_ENABLED
+/**
+* @brief  Read the request line, up to '\n', the timeout, the end of the
+*         client's data or a full line. A client that has gone is found
+*         by the first send.
+* @param line: METEO_EXPORT_REQUEST_MAX bytes, NUL terminated on return
+* @retval none
+*/
+static VOID Export_Server_Request(CHAR *line)
+{
+  NX_PACKET *packet;
+  ULONG length;
+  ULONG end;
+  ULONG used = 0;
+
+  while (used < METEO_EXPORT_REQUEST_MAX - 1U &&
+         nx_tcp_socket_receive(&ExportServerSocket, &packet, EXPORT_SERVER_REQUEST_TICKS) == NX_SUCCESS)
+  {
+    if (nx_packet_data_extract_offset(packet, 0, line + used, METEO_EXPORT_REQUEST_MAX - 1U - used,
+                                      &length) != NX_SUCCESS)
+    {
+      length = 0;
+    }
+    nx_packet_release(packet);
+
+    for (end = used + length; used < end && line[used] != '\n'; used++)
+    {
+    }
+    if (used < end)
+    {
+      break;
+    }
+  }
+  line[used] = '\0';
+}
+
+/**
+* @brief  Export sink: one packet per output buffer. nx_tcp_socket_send()
+*         waits while EXPORT_SERVER_QUEUE_DEPTH packets are unacknowledged,
+*         which paces the export to the link.
+* @retval 0, or -1 to stop the export
+*/
+static int Export_Server_Sink(void *context, const char *data, uint32_t length)
+{
+  NX_PACKET *packet;
+  UINT ret;
+
+  (void)context;
+
+  ret = nx_packet_allocate(&NxAppPool, &packet, NX_TCP_PACKET, NX_APP_DEFAULT_TIMEOUT);
+  if (ret != NX_SUCCESS)
+  {
+    return -1;
+  }
 
+  ret = nx_packet_data_append(packet, (VOID *)data, length, &NxAppPool, NX_APP_DEFAULT_TIMEOUT);
+  if (ret == NX_SUCCESS)
+  {
+    ret = nx_tcp_socket_send(&ExportServerSocket, packet, NX_APP_DEFAULT_TIMEOUT);
+  }
+  if (ret != NX_SUCCESS)
+  {
+    // Not queued: the packet is still ours
+    nx_packet_release(packet);
+    return -1;
+  }
+
+  return 0;
+}
+
+/**
+* @brief  Export server thread entry: one export per connection.
+* @param thread_input: ULONG user argument used by the thread entry
+* @retval none
+*/
+static VOID Export_Server_Thread_Entry(ULONG thread_input)
+{
+  CHAR line[METEO_EXPORT_REQUEST_MAX];
+  meteo_archive_query_t query;
+  meteo_export_format_t format;
+  meteo_export_stats_t stats;
+  UINT series;
+  UINT ret;
+
+  (void)thread_input;
+
+  ret = nx_tcp_socket_create(&NetXDuoEthIpInstance, &ExportServerSocket, "Export Server Socket",
+                             NX_IP_NORMAL, NX_FRAGMENT_OKAY, NX_IP_TIME_TO_LIVE, 1024,
+                             NX_NULL, NX_NULL);
+  if (ret == NX_SUCCESS)
+  {
+    ret = nx_tcp_socket_transmit_configure(&ExportServerSocket, EXPORT_SERVER_QUEUE_DEPTH,
+                                           NX_IP_PERIODIC_RATE, NX_TCP_MAXIMUM_RETRIES, NX_TCP_RETRY_SHIFT);
+  }
+  if (ret == NX_SUCCESS)
+  {
+    ret = nx_tcp_server_socket_listen(&NetXDuoEthIpInstance, METEO_EXPORT_TCP_PORT, &ExportServerSocket, 1, NX_NULL);
+  }
+  if (ret != NX_SUCCESS)
+  {
+    printf("[EXPORT] Server start failed (0x%02X)\n", ret);
+    return;
+  }
+
+  while (1)
+  {
+    if (nx_tcp_server_socket_accept(&ExportServerSocket, NX_WAIT_FOREVER) == NX_SUCCESS)
+    {
+      Export_Server_Request(line);
+#if METEO_SERIES_ENABLED
+      // 19.10.26 "series <request>": the rows of the time series instead of the archive
+      series = (strncmp(line, "series", 6) == 0) ? 6U : 0U;
+#else
+      series = 0U;
+#endif
+      if (meteo_export_parse(&line[series], &query, &format) != TX_SUCCESS)
+      {
+        printf("[EXPORT] Bad request \"%s\"\n", line);
+      }
+      else
+      {
+#if METEO_SERIES_ENABLED
+        if (series != 0U)
+        {
+          ret = meteo_export_series_run(&query, format, Export_Server_Sink, NX_NULL, &stats);
+        }
+        else
+#endif
+        ret = meteo_export_run(&query, format, Export_Server_Sink, NX_NULL, &stats);
+        printf("[EXPORT] %lu rows, %lu bytes over TCP in %lu ms (0x%02X)\n",
+               (unsigned long)stats.rows, (unsigned long)stats.bytes,
+               (unsigned long)(stats.ticks * 1000U / TX_TIMER_TICKS_PER_SECOND), ret);
+      }
+      nx_tcp_socket_disconnect(&ExportServerSocket, NX_APP_DEFAULT_TIMEOUT);
+    }
+
+    nx_tcp_server_socket_unaccept(&ExportServerSocket);
+    nx_tcp_server_socket_relisten(&NetXDuoEthIpInstance, METEO_EXPORT_TCP_PORT, &ExportServerSocket);
+  }
+}
+#endif
 /* USER CODE END 1 */